@@ -26,6 +26,7 @@
 #include <math.h>
 
 #include <algorithm>
+#include <limits>
 #include <vector>
 
 #include <boost/predef/other/endian.h>
@@ -34,6 +35,11 @@
 #define BOOST_POOL_NO_MT
 #include <boost/pool/object_pool.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/parallel_sort.h>
+
 #include "stl.h"
 
 struct HashEdge {
@@ -120,6 +126,41 @@ private:
 	}
 };
 
+// Connect edge_a with edge_b, update edge connection statistics.
+static void record_neighbors(stl_file *stl, int facet_a, int which_edge_a, int facet_b, int which_edge_b)
+{
+	// Facet a's neighbor is facet b
+	stl->neighbors_start[facet_a].neighbor[which_edge_a % 3] = facet_b;	/* sets the .neighbor part */
+	stl->neighbors_start[facet_a].which_vertex_not[which_edge_a % 3] = (which_edge_b + 2) % 3; /* sets the .which_vertex_not part */
+
+	// Facet b's neighbor is facet a
+	stl->neighbors_start[facet_b].neighbor[which_edge_b % 3] = facet_a;	/* sets the .neighbor part */
+	stl->neighbors_start[facet_b].which_vertex_not[which_edge_b % 3] = (which_edge_a + 2) % 3; /* sets the .which_vertex_not part */
+
+	if ((which_edge_a < 3 && which_edge_b < 3) || (which_edge_a > 2 && which_edge_b > 2)) {
+		// These facets are oriented in opposite directions, their normals are probably messed up.
+		stl->neighbors_start[facet_a].which_vertex_not[which_edge_a % 3] += 3;
+		stl->neighbors_start[facet_b].which_vertex_not[which_edge_b % 3] += 3;
+	}
+
+	// Count successful connects:
+	// Total connects:
+	stl->stats.connected_edges += 2;
+	// Count individual connects:
+	switch (stl->neighbors_start[facet_a].num_neighbors()) {
+	case 1:	++ stl->stats.connected_facets_1_edge; break;
+	case 2: ++ stl->stats.connected_facets_2_edge; break;
+	case 3: ++ stl->stats.connected_facets_3_edge; break;
+	default: assert(false);
+	}
+	switch (stl->neighbors_start[facet_b].num_neighbors()) {
+	case 1:	++ stl->stats.connected_facets_1_edge; break;
+	case 2: ++ stl->stats.connected_facets_2_edge; break;
+	case 3: ++ stl->stats.connected_facets_3_edge; break;
+	default: assert(false);
+	}
+}
+
 struct HashTableEdges {
 	HashTableEdges(size_t number_of_faces) {
 		this->M = (int)hash_size_from_nr_faces(number_of_faces);
@@ -140,7 +181,7 @@ struct HashTableEdges {
 
 	void insert_edge_exact(stl_file *stl, const HashEdge &edge)
 	{
-		this->insert_edge(stl, edge, [stl](const HashEdge& edge1, const HashEdge& edge2) { record_neighbors(stl, edge1, edge2); });
+		this->insert_edge(stl, edge, [stl](const HashEdge& edge1, const HashEdge& edge2) { record_neighbors(stl, edge1.facet_number, edge1.which_edge, edge2.facet_number, edge2.which_edge); });
 	}
 
 	void insert_edge_nearby(stl_file *stl, const HashEdge &edge)
@@ -239,44 +280,9 @@ private:
 	    return edge_a.facet_number != edge_b.facet_number && edge_a == edge_b;
 	}
 
-	// Connect edge_a with edge_b, update edge connection statistics.
-	static void record_neighbors(stl_file *stl, const HashEdge &edge_a, const HashEdge &edge_b)
-	{
-		// Facet a's neighbor is facet b
-		stl->neighbors_start[edge_a.facet_number].neighbor[edge_a.which_edge % 3] = edge_b.facet_number;	/* sets the .neighbor part */
-		stl->neighbors_start[edge_a.facet_number].which_vertex_not[edge_a.which_edge % 3] = (edge_b.which_edge + 2) % 3; /* sets the .which_vertex_not part */
-
-		// Facet b's neighbor is facet a
-		stl->neighbors_start[edge_b.facet_number].neighbor[edge_b.which_edge % 3] = edge_a.facet_number;	/* sets the .neighbor part */
-		stl->neighbors_start[edge_b.facet_number].which_vertex_not[edge_b.which_edge % 3] = (edge_a.which_edge + 2) % 3; /* sets the .which_vertex_not part */
-
-		if ((edge_a.which_edge < 3 && edge_b.which_edge < 3) || (edge_a.which_edge > 2 && edge_b.which_edge > 2)) {
-			// These facets are oriented in opposite directions, their normals are probably messed up.
-			stl->neighbors_start[edge_a.facet_number].which_vertex_not[edge_a.which_edge % 3] += 3;
-			stl->neighbors_start[edge_b.facet_number].which_vertex_not[edge_b.which_edge % 3] += 3;
-		}
-
-		// Count successful connects:
-		// Total connects:
-		stl->stats.connected_edges += 2;
-		// Count individual connects:
-		switch (stl->neighbors_start[edge_a.facet_number].num_neighbors()) {
-		case 1:	++ stl->stats.connected_facets_1_edge; break;
-		case 2: ++ stl->stats.connected_facets_2_edge; break;
-		case 3: ++ stl->stats.connected_facets_3_edge; break;
-		default: assert(false);
-		}
-		switch (stl->neighbors_start[edge_b.facet_number].num_neighbors()) {
-		case 1:	++ stl->stats.connected_facets_1_edge; break;
-		case 2: ++ stl->stats.connected_facets_2_edge; break;
-		case 3: ++ stl->stats.connected_facets_3_edge; break;
-		default: assert(false);
-		}
-	}
-
 	static void match_neighbors_nearby(stl_file *stl, const HashEdge &edge_a, const HashEdge &edge_b)
 	{
-		record_neighbors(stl, edge_a, edge_b);
+		record_neighbors(stl, edge_a.facet_number, edge_a.which_edge, edge_b.facet_number, edge_b.which_edge);
 
 		// Which vertices to change
 		int facet1 = -1;
@@ -454,23 +460,96 @@ void stl_check_facets_exact(stl_file *stl)
 		  	++ i;
   	}
 
-  	// Initialize hash table.
-  	HashTableEdges hash_table(stl->stats.number_of_facets);
 	for (auto &neighbor : stl->neighbors_start)
 		neighbor.reset();
 
-  	// Connect neighbor edges.
-	for (uint32_t i = 0; i < stl->stats.number_of_facets; ++ i) {
-		const stl_facet &facet = stl->facet_start[i];
-		for (int j = 0; j < 3; ++ j) {
-			HashEdge edge;
-			edge.facet_number = i;
-			edge.which_edge = j;
-			edge.load_exact(stl, &facet.vertex[j], &facet.vertex[(j + 1) % 3]);
-			hash_table.insert_edge_exact(stl, edge);
+	const uint32_t num_facets  = stl->stats.number_of_facets;
+	const uint32_t num_corners = num_facets * 3;
+
+	stl->stats.shortest_edge = std::min(stl->stats.shortest_edge, tbb::parallel_reduce(tbb::blocked_range<uint32_t>(0, num_facets), std::numeric_limits<float>::max(),
+		[stl](const tbb::blocked_range<uint32_t> &range, float shortest_edge) {
+			for (uint32_t i = range.begin(); i < range.end(); ++ i) {
+				const stl_facet &facet = stl->facet_start[i];
+				for (int j = 0; j < 3; ++ j) {
+					stl_vertex diff = (facet.vertex[j] - facet.vertex[(j + 1) % 3]).cwiseAbs();
+					shortest_edge = std::min(shortest_edge, std::max(diff(0), std::max(diff(1), diff(2))));
+				}
+			}
+			return shortest_edge;
+		},
+		[](float a, float b) { return std::min(a, b); }));
+
+	// Weld the vertices: Sort the facet corners by their coordinates, equal coordinates receive the same vertex index.
+	// The coordinates are compared bitwise with negative zeros switched to positive zeros, as HashEdge::load_exact() does.
+	std::vector<uint32_t> corner_vertex(num_corners);
+	{
+		struct Corner {
+			uint32_t key[3];
+			uint32_t corner;
+			bool operator<(const Corner &rhs) const {
+				return key[0] != rhs.key[0] ? key[0] < rhs.key[0] : key[1] != rhs.key[1] ? key[1] < rhs.key[1] : key[2] != rhs.key[2] ? key[2] < rhs.key[2] : corner < rhs.corner;
+			}
+			bool same_key(const Corner &rhs) const { return key[0] == rhs.key[0] && key[1] == rhs.key[1] && key[2] == rhs.key[2]; }
+		};
+		std::vector<Corner> corners(num_corners);
+		tbb::parallel_for(tbb::blocked_range<uint32_t>(0, num_corners), [stl, &corners](const tbb::blocked_range<uint32_t> &range) {
+			for (uint32_t i = range.begin(); i < range.end(); ++ i) {
+				Corner &c = corners[i];
+				memcpy(c.key, stl->facet_start[i / 3].vertex[i % 3].data(), sizeof(stl_vertex));
+				for (uint32_t &k : c.key)
+					if (k == 0x80000000u)
+						// Negative zero, switch to positive zero.
+						k = 0;
+				c.corner = i;
+			}
+		});
+		tbb::parallel_sort(corners.begin(), corners.end());
+		uint32_t vertex_idx = 0;
+		for (uint32_t i = 0; i < num_corners; ++ i) {
+			if (i > 0 && ! corners[i].same_key(corners[i - 1]))
+				++ vertex_idx;
+			corner_vertex[corners[i].corner] = vertex_idx;
 		}
 	}
 
+	// Connect neighbor edges: Sort the edges by their end vertices, the equal edges are then paired in the order of facets and their edges.
+	// This is the same pairing the hash table of edges produced when the edges were inserted one after another,
+	// thus the result matches the sequential algorithm.
+	{
+		struct Edge {
+			uint64_t key;
+			uint32_t edge;
+			bool operator<(const Edge &rhs) const { return key != rhs.key ? key < rhs.key : edge < rhs.edge; }
+		};
+		std::vector<Edge> edges(num_corners);
+		tbb::parallel_for(tbb::blocked_range<uint32_t>(0, num_corners), [&corner_vertex, &edges](const tbb::blocked_range<uint32_t> &range) {
+			for (uint32_t i = range.begin(); i < range.end(); ++ i) {
+				uint32_t a = corner_vertex[i];
+				uint32_t b = corner_vertex[i - i % 3 + (i % 3 + 1) % 3];
+				if (a > b)
+					std::swap(a, b);
+				edges[i] = { (uint64_t(a) << 32) | b, i };
+			}
+		});
+		corner_vertex = std::vector<uint32_t>();
+		tbb::parallel_sort(edges.begin(), edges.end());
+
+		// Ensure identical vertex ordering of equal edges, see HashEdge::load_exact(). If the edge is loaded backwards, which_edge is increased by 3.
+		auto which_edge = [stl](uint32_t edge) {
+			const stl_facet  &facet = stl->facet_start[edge / 3];
+			const stl_vertex &a     = facet.vertex[edge % 3];
+			const stl_vertex &b     = facet.vertex[(edge % 3 + 1) % 3];
+			bool lower = (a(0) != b(0)) ? (a(0) < b(0)) : ((a(1) != b(1)) ? (a(1) < b(1)) : (a(2) < b(2)));
+			return int(edge % 3) + (lower ? 0 : 3);
+		};
+		for (uint32_t i = 0; i + 1 < num_corners;)
+			if (edges[i].key == edges[i + 1].key && edges[i].edge / 3 != edges[i + 1].edge / 3) {
+				record_neighbors(stl, int(edges[i + 1].edge / 3), which_edge(edges[i + 1].edge), int(edges[i].edge / 3), which_edge(edges[i].edge));
+				i += 2;
+			} else
+				++ i;
+	}
+
 #if 0
 	printf("Number of faces: %d, number of manifold edges: %d, number of connected edges: %d, number of unconnected edges: %d\r\n", 
     	stl->stats.number_of_facets, stl->stats.number_of_facets * 3, 
@@ -26,6 +26,9 @@
 #include <math.h>
 #include <assert.h>
 
+#include <algorithm>
+#include <vector>
+
 #include <boost/log/trivial.hpp>
 #include <boost/nowide/cstdio.hpp>
 #include <boost/predef/other/endian.h>
@@ -152,14 +155,26 @@ static bool stl_read(stl_file *stl, FILE *fp, int first_facet, bool first)
   	else
     	rewind(fp);
 
+  	// Binary facets are read in blocks, a single fread() per facet is slow.
+  	static constexpr const uint32_t binary_block_facets = 65536;
+  	std::vector<char> binary_block;
+  	uint32_t          binary_block_begin = first_facet;
+  	uint32_t          binary_block_end   = first_facet;
+
   	char normal_buf[3][32];
   	for (uint32_t i = first_facet; i < stl->stats.number_of_facets; ++ i) {
   	  	stl_facet facet;
 
     	if (stl->stats.type == binary) {
-      		// Read a single facet from a binary .STL file. We assume little-endian architecture!
-      		if (fread(&facet, 1, SIZEOF_STL_FACET, fp) != SIZEOF_STL_FACET)
-      			return false;
+    		if (i == binary_block_end) {
+    			binary_block_begin = i;
+    			binary_block_end   = std::min(i + binary_block_facets, stl->stats.number_of_facets);
+    			binary_block.resize(size_t(binary_block_end - binary_block_begin) * SIZEOF_STL_FACET);
+    			if (fread(binary_block.data(), 1, binary_block.size(), fp) != binary_block.size())
+    				return false;
+    		}
+      		// Decode a single facet of a binary .STL file. We assume little-endian architecture!
+      		memcpy(&facet, binary_block.data() + size_t(i - binary_block_begin) * SIZEOF_STL_FACET, SIZEOF_STL_FACET);
 #if BOOST_ENDIAN_BIG_BYTE
       		// Convert the loaded little endian data to big endian.
       		stl_internal_reverse_quads((char*)&facet, 48);
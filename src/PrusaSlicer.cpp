@@ -22,9 +22,15 @@
 #endif /* WIN32 */
 
 #include <cstdio>
+#include <csignal>
 #include <string>
 #include <cstring>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <math.h>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/filesystem.hpp>
@@ -36,6 +42,8 @@
 #include <boost/nowide/iostream.hpp>
 #include <boost/nowide/fstream.hpp>
 #include <boost/dll/runtime_symbol_info.hpp>
+#include <boost/tokenizer.hpp>
+#include <boost/process.hpp>
 
 #include "unix/fhs.hpp"  // Generated by CMake from ../platform/unix/fhs.hpp.in
 
@@ -60,6 +68,11 @@
 #include "libslic3r/Format/SL1.hpp"
 #include "libslic3r/Utils.hpp"
 #include "libslic3r/Thread.hpp"
+#include "libslic3r/LayerSpill.hpp"
+#include "libslic3r/MemoryUsage.hpp"
+#include "libslic3r/Metrics.hpp"
+#include "libslic3r/SliceCache.hpp"
+#include "libslic3r/Trace.hpp"
 #include "libslic3r/BlacklistedLibraryCheck.hpp"
 #include "libslic3r/ProfilesSharingUtils.hpp"
 #include "libslic3r/Utils/DirectoriesUtils.hpp"
@@ -71,6 +84,16 @@
     #include "slic3r/Utils/ServiceConfig.hpp"
 #endif /* SLIC3R_GUI */
 
+#ifdef SLIC3R_ALLOCATOR_TBBMALLOC
+    // Makes the linker keep the proxy library, which replaces the system allocator by the TBB scalable allocator.
+    #include <oneapi/tbb/tbbmalloc_proxy.h>
+#endif /* SLIC3R_ALLOCATOR_TBBMALLOC */
+#if defined(SLIC3R_ALLOCATOR_MIMALLOC) && ! defined(SLIC3R_ALLOCATION_PROFILING)
+    // Replaces the global operator new / delete. With SLIC3R_ALLOCATION_PROFILING, they are replaced by the counting
+    // hooks in MemoryUsage.cpp, which allocate through malloc overridden by the mimalloc library.
+    #include <mimalloc-new-delete.h>
+#endif
+
 using namespace Slic3r;
 
 static PrinterTechnology get_printer_technology(const DynamicConfig &config)
@@ -327,7 +350,9 @@ int CLI::run(int argc, char **argv)
         }
     }
 
-    if (!start_gui) {
+    // The slicing server reads jobs from stdin, it cannot be interrupted by a confirmation prompt.
+    if (!start_gui && std::find(m_actions.begin(), m_actions.end(), "server") == m_actions.end() &&
+        std::find(m_actions.begin(), m_actions.end(), "coordinator") == m_actions.end()) {
         const auto* post_process = m_print_config.opt<ConfigOptionStrings>("post_process");
         if (post_process != nullptr && !post_process->values.empty()) {
             boost::nowide::cout << "\nA post-processing script has been detected in the config data:\n\n";
@@ -662,7 +687,8 @@ int CLI::run(int argc, char **argv)
                 }
                 if (print->empty())
                     boost::nowide::cout << "Nothing to print for " << outfile << " . Either the print is empty or no object is fully inside the print volume." << std::endl;
-                else
+                else {
+                    const uint64_t job_start = Trace::detail::now_microseconds();
                     try {
                         std::string outfile_final;
                         print->process();
@@ -683,13 +709,28 @@ int CLI::run(int argc, char **argv)
                             }
                             outfile = outfile_final;
                         }
+                        if (Trace::enabled() && Trace::save(outfile + ".trace.json"))
+                            boost::nowide::cout << "Trace of the slicing process exported to " << outfile << ".trace.json" << std::endl;
+                        if (printer_technology == ptFFF && MemoryAccounting::enabled() && MemoryAccounting::save(outfile + ".memory.json", fff_print.memory_usage_records()))
+                            boost::nowide::cout << "Memory usage report exported to " << outfile << ".memory.json" << std::endl;
                         // Run the post-processing scripts if defined.
                         run_post_process_scripts(outfile, fff_print.full_print_config());
                         boost::nowide::cout << "Slicing result exported to " << outfile << std::endl;
+                        if (Metrics::enabled()) {
+                            boost::system::error_code ec;
+                            const uintmax_t output_bytes = boost::filesystem::file_size(outfile, ec);
+                            Metrics::observe_job(Metrics::JobResult::Ok, Trace::detail::now_microseconds() - job_start, ec ? 0 : size_t(output_bytes));
+                            Metrics::save(m_config.opt_string("metrics"));
+                        }
                     } catch (const std::exception &ex) {
                         boost::nowide::cerr << ex.what() << std::endl;
+                        if (Metrics::enabled()) {
+                            Metrics::observe_job(Metrics::JobResult::Error, Trace::detail::now_microseconds() - job_start, 0);
+                            Metrics::save(m_config.opt_string("metrics"));
+                        }
                         return 1;
                     }
+                }
 /*
                 print.center = ! m_config.has("center")
                     && ! m_config.has("align_xy")
@@ -721,6 +762,12 @@ int CLI::run(int argc, char **argv)
                     << " (" << print.total_extruded_volume()/1000 << "cm3)" << std::endl;
 */
             }
+        } else if (opt_key == "server") {
+            if (! this->run_server())
+                return 1;
+        } else if (opt_key == "coordinator") {
+            if (! this->run_coordinator())
+                return 1;
         } else {
             boost::nowide::cerr << "error: option not supported yet: " << opt_key << std::endl;
             return 1;
@@ -862,6 +909,18 @@ bool CLI::setup(int argc, char **argv)
             set_logging_level(opt_loglevel->value);
     }
 
+    if (m_config.opt_bool("trace"))
+        Trace::enable(true);
+    if (m_config.opt_bool("memory_report"))
+        MemoryAccounting::enable(true);
+    if (! m_config.opt_string("metrics").empty())
+        Metrics::enable(true);
+
+    if (const std::string &slice_cache = m_config.opt_string("slice_cache"); ! slice_cache.empty())
+        SliceCache::set_directory(slice_cache);
+    if (const ConfigOptionInt *opt_memory_budget = m_config.opt<ConfigOptionInt>("memory_budget"); opt_memory_budget && opt_memory_budget->value > 0)
+        LayerSpill::set_memory_budget(size_t(opt_memory_budget->value) * 1024 * 1024);
+
     {
         const ConfigOptionInt *opt_threads = m_config.opt<ConfigOptionInt>("threads");
         if (opt_threads != nullptr)
@@ -1105,6 +1164,377 @@ bool CLI::check_and_load_input_profiles(PrinterTechnology& printer_technology)
     return true;
 }
 
+namespace {
+
+// Files loaded by the slicing server are kept in memory between the jobs and they are reloaded only if modified on disk.
+template<typename T>
+struct ServerCachedFile
+{
+    std::vector<std::time_t> timestamps;
+    T                        data;
+};
+
+struct ServerCache
+{
+    std::map<std::string, ServerCachedFile<DynamicPrintConfig>>            configs;
+    // Models are cached per list of input files, merged into a single Model. A job receives a copy of the cached Model
+    // including the object IDs, thus Print::apply() recognizes the objects sliced by the previous job
+    // and only the steps invalidated by a configuration change are recalculated.
+    std::map<std::vector<std::string>, ServerCachedFile<Model>>            models;
+};
+
+template<typename Key, typename T, typename Loader>
+const T& server_load_cached(std::map<Key, ServerCachedFile<T>> &cache, const Key &key, const std::vector<std::string> &paths, Loader loader)
+{
+    std::vector<std::time_t> timestamps;
+    timestamps.reserve(paths.size());
+    for (const std::string &path : paths) {
+        if (! boost::filesystem::exists(path))
+            throw Slic3r::RuntimeError(std::string("No such file: ") + path);
+        timestamps.emplace_back(boost::filesystem::last_write_time(path));
+    }
+    auto it = cache.find(key);
+    if (it == cache.end() || it->second.timestamps != timestamps) {
+        ServerCachedFile<T> entry;
+        entry.timestamps = std::move(timestamps);
+        loader(entry.data);
+        it = cache.insert_or_assign(key, std::move(entry)).first;
+    }
+    return it->second.data;
+}
+
+// Split a job line into arguments. Arguments containing spaces may be quoted by single or double quotes.
+std::vector<std::string> server_split_job(const std::string &line)
+{
+    std::vector<std::string> out;
+    boost::tokenizer<boost::escaped_list_separator<char>> tokens(line, boost::escaped_list_separator<char>("", " \t", "\"'"));
+    for (const std::string &token : tokens)
+        if (! token.empty())
+            out.emplace_back(token);
+    return out;
+}
+
+// Process a single job of the slicing server. Returns the path of the exported file or throws on error.
+std::string server_process_job(const std::vector<std::string> &args, const DynamicPrintConfig &base_config, ServerCache &cache, Print &fff_print, SLAPrint &sla_print)
+{
+    std::vector<const char*> argv { SLIC3R_APP_KEY };
+    for (const std::string &arg : args)
+        argv.emplace_back(arg.c_str());
+    DynamicPrintAndCLIConfig job_config;
+    std::vector<std::string> input_files;
+    t_config_option_keys     opt_order;
+    if (! job_config.read_cli(int(argv.size()), argv.data(), &input_files, &opt_order))
+        throw Slic3r::RuntimeError("Invalid job command line");
+
+    std::string action;
+    for (const t_config_option_key &opt_key : opt_order)
+        if (cli_actions_config_def.has(opt_key)) {
+            if (opt_key != "export_gcode" && opt_key != "export_sla" && opt_key != "slice")
+                throw Slic3r::RuntimeError(std::string("Action is not supported in the server mode: ") + opt_key);
+            if (! action.empty())
+                throw Slic3r::RuntimeError("A server job accepts a single action only");
+            action = opt_key;
+        } else if (cli_transform_config_def.has(opt_key) && opt_key != "dont_arrange" && opt_key != "center")
+            throw Slic3r::RuntimeError(std::string("Transform option is not supported in the server mode: ") + opt_key);
+    if (action.empty())
+        action = "slice";
+    if (input_files.empty())
+        throw Slic3r::RuntimeError("No input file");
+
+    // Compose the print configuration: the server base config, then the --load files of the job, then the job command line options.
+    const ForwardCompatibilitySubstitutionRule config_substitution_rule = job_config.option<ConfigOptionEnum<ForwardCompatibilitySubstitutionRule>>("config_compatibility", true)->value;
+    DynamicPrintConfig print_config = base_config;
+    for (const std::string &file : job_config.option<ConfigOptionStrings>("load", true)->values) {
+        const DynamicPrintConfig &config = server_load_cached(cache.configs, file, { file }, [&file, config_substitution_rule](DynamicPrintConfig &config) {
+            config.load(file, config_substitution_rule);
+            config.normalize_fdm();
+        });
+        print_config.apply(config);
+    }
+    {
+        DynamicPrintConfig extra_config;
+        extra_config.apply(job_config, true);
+        extra_config.normalize_fdm();
+        print_config.apply(extra_config, true);
+        print_config.normalize_fdm();
+    }
+
+    PrinterTechnology printer_technology = get_printer_technology(print_config);
+    if (printer_technology == ptUnknown)
+        printer_technology = action == "export_sla" ? ptSLA : ptFFF;
+    if (action == "export_gcode" && printer_technology == ptSLA)
+        throw Slic3r::RuntimeError("Cannot export G-code for an SLA configuration");
+    if (action == "export_sla" && printer_technology == ptFFF)
+        throw Slic3r::RuntimeError("Cannot export SLA slices for an FFF configuration");
+    print_config.option<ConfigOptionEnum<PrinterTechnology>>("printer_technology", true)->value = printer_technology;
+    if (printer_technology == ptFFF) {
+        FullPrintConfig fff_print_config;
+        fff_print_config.apply(print_config, true);
+        print_config.apply(fff_print_config, true);
+    } else {
+        SLAFullPrintConfig sla_print_config;
+        sla_print_config.output_filename_format.value = "[input_filename_base].sl1";
+        double w = sla_print_config.display_width.getFloat();
+        double h = sla_print_config.display_height.getFloat();
+        sla_print_config.bed_shape.values = { Vec2d(0, 0), Vec2d(w, 0), Vec2d(w, h), Vec2d(0, h) };
+        sla_print_config.apply(print_config, true);
+        print_config.apply(sla_print_config, true);
+    }
+    if (std::string validity = print_config.validate(); ! validity.empty())
+        throw Slic3r::RuntimeError("The composite configation is not valid: " + validity);
+
+    Model model = server_load_cached(cache.models, input_files, input_files, [&input_files](Model &model) {
+        for (const std::string &file : input_files) {
+            Model loaded = Model::read_from_file(file, nullptr, nullptr, Model::LoadAttribute::AddDefaultInstances);
+            if (input_files.size() == 1)
+                model = std::move(loaded);
+            else
+                for (const ModelObject *model_object : loaded.objects)
+                    model.add_object(*model_object);
+        }
+        for (ModelObject *model_object : model.objects)
+            model_object->ensure_on_bed();
+    });
+    if (model.objects.empty())
+        throw Slic3r::RuntimeError("Nothing to print, the input files are empty");
+
+    if (! job_config.opt_bool("dont_arrange")) {
+        arr2::ArrangeSettings arrange_cfg;
+        arrange_cfg.set_distance_from_objects(min_object_distance(print_config));
+        if (const ConfigOptionPoint *center = job_config.option<ConfigOptionPoint>("center"); center != nullptr)
+            arrange_objects(model, arr2::InfiniteBed{scaled(center->value)}, arrange_cfg);
+        else
+            arrange_objects(model, arr2::to_arrange_bed(get_bed_shape(print_config)), arrange_cfg);
+    }
+    if (printer_technology == ptFFF)
+        for (ModelObject *model_object : model.objects)
+            fff_print.auto_assign_extruders(model_object);
+
+    PrintBase *print = (printer_technology == ptFFF) ? static_cast<PrintBase*>(&fff_print) : static_cast<PrintBase*>(&sla_print);
+    print->apply(model, print_config);
+    if (std::string err = print->validate(); ! err.empty())
+        throw Slic3r::RuntimeError(err);
+    if (print->empty())
+        throw Slic3r::RuntimeError("Nothing to print. Either the print is empty or no object is fully inside the print volume.");
+    // The --threads option of a job limits the threads working on this job, the server command line sets the global limit.
+    const ConfigOptionInt *opt_threads = job_config.opt<ConfigOptionInt>("threads");
+    print->set_max_concurrency(opt_threads != nullptr ? size_t(std::max(1, opt_threads->value)) : 0);
+
+    std::string outfile = job_config.opt_string("output");
+    std::string outfile_final;
+    print->execute_in_arena([&]() {
+        print->process();
+        if (printer_technology == ptFFF) {
+            outfile = fff_print.export_gcode(outfile, nullptr, nullptr);
+            outfile_final = fff_print.print_statistics().finalize_output_path(outfile);
+        } else {
+            outfile = sla_print.output_filepath(outfile);
+            outfile_final = sla_print.print_statistics().finalize_output_path(outfile);
+            sla_print.export_print(outfile_final);
+        }
+    });
+    if (outfile != outfile_final) {
+        if (Slic3r::rename_file(outfile, outfile_final))
+            throw Slic3r::RuntimeError("Renaming file " + outfile + " to " + outfile_final + " failed");
+        outfile = outfile_final;
+    }
+    if (Trace::enabled())
+        Trace::save(outfile + ".trace.json");
+    if (printer_technology == ptFFF && MemoryAccounting::enabled())
+        MemoryAccounting::save(outfile + ".memory.json", fff_print.memory_usage_records());
+    if (printer_technology == ptFFF)
+        run_post_process_scripts(outfile, fff_print.full_print_config());
+    return outfile;
+}
+
+} // namespace
+
+bool CLI::run_server()
+{
+    ServerCache cache;
+    // The print objects are kept alive between the jobs, so that a repeated job on the same model
+    // only recalculates the steps invalidated by Print::apply().
+    Print       fff_print;
+    SLAPrint    sla_print;
+
+    boost::nowide::cout << "ready" << std::endl;
+    for (std::string line; std::getline(boost::nowide::cin, line);) {
+        if (! line.empty() && line.back() == '\r')
+            line.pop_back();
+        const std::vector<std::string> args = server_split_job(line);
+        if (args.empty())
+            continue;
+        if (args.size() == 1 && (args.front() == "quit" || args.front() == "exit"))
+            break;
+        const uint64_t job_start = Trace::detail::now_microseconds();
+        try {
+            std::string outfile = server_process_job(args, m_print_config, cache, fff_print, sla_print);
+            if (Metrics::enabled()) {
+                boost::system::error_code ec;
+                const uintmax_t output_bytes = boost::filesystem::file_size(outfile, ec);
+                Metrics::observe_job(Metrics::JobResult::Ok, Trace::detail::now_microseconds() - job_start, ec ? 0 : size_t(output_bytes));
+            }
+            boost::nowide::cout << "ok " << outfile << std::endl;
+        } catch (const std::exception &ex) {
+            if (Metrics::enabled())
+                Metrics::observe_job(dynamic_cast<const CanceledException*>(&ex) ? Metrics::JobResult::Canceled : Metrics::JobResult::Error,
+                    Trace::detail::now_microseconds() - job_start, 0);
+            std::string message = ex.what();
+            std::replace(message.begin(), message.end(), '\n', ' ');
+            boost::nowide::cout << "error " << message << std::endl;
+        }
+        if (Metrics::enabled())
+            Metrics::save(m_config.opt_string("metrics"));
+    }
+    return true;
+}
+
+namespace {
+
+// Jobs of the slicing coordinator shared by the threads feeding the worker processes.
+struct CoordinatorJobs
+{
+    std::mutex                              mutex;
+    std::condition_variable                 condition;
+    // Jobs not yet taken by a worker: index of the job, job line.
+    std::deque<std::pair<size_t, std::string>> queue;
+    // Answers of the jobs by their index, printed in the order of the jobs.
+    std::vector<std::optional<std::string>> answers;
+    size_t                                  next_answer { 0 };
+    // End of the input or "quit" was read.
+    bool                                    finished { false };
+
+    // To be called with the mutex locked.
+    void answer(size_t idx, std::string &&answer) {
+        answers[idx] = std::move(answer);
+        for (; next_answer < answers.size() && answers[next_answer]; ++ next_answer)
+            boost::nowide::cout << *answers[next_answer] << std::endl;
+    }
+};
+
+// Feed the jobs to a single worker process until there are no more jobs or the worker terminates.
+void coordinator_worker_loop(boost::process::child &child, boost::process::opstream &in, boost::process::ipstream &out, CoordinatorJobs &jobs)
+{
+    for (;;) {
+        std::pair<size_t, std::string> job;
+        {
+            std::unique_lock<std::mutex> lock(jobs.mutex);
+            jobs.condition.wait(lock, [&jobs]() { return jobs.finished || ! jobs.queue.empty(); });
+            if (jobs.queue.empty())
+                break;
+            job = std::move(jobs.queue.front());
+            jobs.queue.pop_front();
+        }
+        std::string answer;
+        if (! (in << job.second << std::endl) || ! std::getline(out, answer)) {
+            // The worker process terminated, the other workers will continue with the remaining jobs.
+            std::lock_guard<std::mutex> lock(jobs.mutex);
+            jobs.answer(job.first, "error The worker process terminated");
+            child.wait();
+            return;
+        }
+        if (! answer.empty() && answer.back() == '\r')
+            answer.pop_back();
+        std::lock_guard<std::mutex> lock(jobs.mutex);
+        jobs.answer(job.first, std::move(answer));
+    }
+    in << "quit" << std::endl;
+    in.pipe().close();
+    child.wait();
+}
+
+} // namespace
+
+bool CLI::run_coordinator()
+{
+    namespace bp = boost::process;
+    namespace fs = boost::filesystem;
+
+    struct Worker {
+        bp::opstream in;
+        bp::ipstream out;
+        bp::child    child;
+    };
+    std::vector<std::unique_ptr<Worker>> workers;
+#ifndef _WIN32
+    // A terminated worker is detected by a failed write into its standard input instead of being killed by SIGPIPE.
+    std::signal(SIGPIPE, SIG_IGN);
+#endif // _WIN32
+    // The local workers load the configuration of the coordinator command line from a temporary file.
+    fs::path config_path;
+    try {
+        std::vector<std::string> commands = m_config.option<ConfigOptionStrings>("worker", true)->values;
+        if (commands.empty()) {
+            const ConfigOptionInt *opt_workers = m_config.opt<ConfigOptionInt>("workers");
+            const size_t num_workers = opt_workers != nullptr ? size_t(std::max(1, opt_workers->value)) :
+                std::max<size_t>(1, std::thread::hardware_concurrency() / 4);
+            config_path = fs::temp_directory_path() / fs::unique_path("slic3r_coordinator_%%%%-%%%%-%%%%-%%%%.ini");
+            m_print_config.save(config_path.string());
+            const fs::path executable = boost::dll::program_location();
+            for (size_t i = 0; i < num_workers; ++ i) {
+                auto worker = std::make_unique<Worker>();
+                worker->child = bp::child(executable, "--load", config_path.string(), "--server", bp::std_in < worker->in, bp::std_out > worker->out);
+                workers.emplace_back(std::move(worker));
+            }
+        } else {
+            for (const std::string &command : commands) {
+                auto worker = std::make_unique<Worker>();
+                worker->child = bp::child(command, bp::std_in < worker->in, bp::std_out > worker->out);
+                workers.emplace_back(std::move(worker));
+            }
+        }
+    } catch (const std::exception &ex) {
+        boost::nowide::cerr << "Failed to start a worker process: " << ex.what() << std::endl;
+    }
+    // Each worker announces it is ready to accept jobs.
+    workers.erase(std::remove_if(workers.begin(), workers.end(), [](const std::unique_ptr<Worker> &worker) {
+        std::string line;
+        return ! std::getline(worker->out, line) || line.rfind("ready", 0) != 0;
+    }), workers.end());
+    if (workers.empty()) {
+        boost::nowide::cerr << "No worker process of the slicing coordinator started" << std::endl;
+        if (! config_path.empty())
+            fs::remove(config_path);
+        return false;
+    }
+
+    CoordinatorJobs jobs;
+    std::vector<std::thread> threads;
+    for (std::unique_ptr<Worker> &worker : workers)
+        threads.emplace_back([&worker = *worker, &jobs]() { coordinator_worker_loop(worker.child, worker.in, worker.out, jobs); });
+
+    boost::nowide::cout << "ready" << std::endl;
+    for (std::string line; std::getline(boost::nowide::cin, line);) {
+        if (! line.empty() && line.back() == '\r')
+            line.pop_back();
+        const std::vector<std::string> args = server_split_job(line);
+        if (args.empty())
+            continue;
+        if (args.size() == 1 && (args.front() == "quit" || args.front() == "exit"))
+            break;
+        std::lock_guard<std::mutex> lock(jobs.mutex);
+        jobs.queue.emplace_back(jobs.answers.size(), std::move(line));
+        jobs.answers.emplace_back();
+        jobs.condition.notify_one();
+    }
+    {
+        std::lock_guard<std::mutex> lock(jobs.mutex);
+        jobs.finished = true;
+    }
+    jobs.condition.notify_all();
+    for (std::thread &thread : threads)
+        thread.join();
+    // All the workers terminated before processing all the jobs.
+    for (auto &[idx, line] : jobs.queue)
+        jobs.answer(idx, "error No worker process available");
+
+    if (! config_path.empty()) {
+        boost::system::error_code ec;
+        fs::remove(config_path, ec);
+    }
+    return true;
+}
+
 // __has_feature() is used later for Clang, this is for compatibility with other compilers (such as GCC and MSVC)
 #ifndef __has_feature
 #   define __has_feature(x) 0
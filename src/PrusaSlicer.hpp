@@ -44,6 +44,15 @@ private:
     bool processed_profiles_sharing();
 
     bool check_and_load_input_profiles(PrinterTechnology& printer_technology);
+
+    /// Runs a persistent slicing server, which reads jobs from the standard input one per line
+    /// until "quit" or end of input. The Print / SLAPrint objects and the loaded files are kept
+    /// resident between the jobs.
+    bool run_server();
+
+    /// Distributes the slicing server jobs read from the standard input to worker processes running the slicing server
+    /// and answers them in the input order.
+    bool run_coordinator();
     
     std::string output_filepath(const Model &model, IO::ExportFormat format) const;
 };
@@ -766,13 +766,12 @@ bool ClipperBase::AddPath(const Path &pg, PolyType PolyTyp, bool Closed)
   if ((Closed && highI < 2) || (!Closed && highI < 1))
     return false;
 
-  // Allocate a new edge array.
-  Edges edges(highI + 1);
+  // Allocate a new edge array, possibly recycling one released by Clear().
+  Edges edges = AllocateEdges(highI + 1);
   // Fill in the edge array.
   bool result = AddPathInternal(pg, highI, PolyTyp, Closed, edges.data());
-  if (result)
-    // Success, remember the edge array.
-    m_edges.emplace_back(std::move(edges));
+  // Success, remember the edge array. Otherwise keep it for reuse.
+  (result ? m_edges : m_edgesFree).emplace_back(std::move(edges));
   return result;
 }
 
@@ -956,9 +955,32 @@ bool ClipperBase::AddPathInternal(const Path &pg, int highI, PolyType PolyTyp, b
 }
 //------------------------------------------------------------------------------
 
+ClipperBase::Edges ClipperBase::AllocateEdges(size_t num_edges)
+{
+  Edges edges;
+  if (! m_edgesFree.empty()) {
+    // Pick the most recently released edge vector large enough. If there is none, grow the last one,
+    // so that the number of retained vectors does not exceed the number of vectors in use at once.
+    auto it = std::find_if(m_edgesFree.rbegin(), m_edgesFree.rend(), [num_edges](const Edges &e){ return e.capacity() >= num_edges; });
+    if (it == m_edgesFree.rend())
+      it = m_edgesFree.rbegin();
+    std::swap(*it, m_edgesFree.back());
+    edges = std::move(m_edgesFree.back());
+    m_edgesFree.pop_back();
+  }
+  // The edges are value initialized as if the vector was freshly allocated.
+  edges.assign(num_edges, TEdge());
+  return edges;
+}
+//------------------------------------------------------------------------------
+
 void ClipperBase::Clear()
 {
   m_MinimaList.clear();
+  for (Edges &edges : m_edges) {
+    edges.clear();
+    m_edgesFree.emplace_back(std::move(edges));
+  }
   m_edges.clear();
 #ifndef CLIPPERLIB_INT32
   m_UseFullRange = false;
@@ -967,6 +989,17 @@ void ClipperBase::Clear()
 }
 //------------------------------------------------------------------------------
 
+size_t ClipperBase::RetainedCapacity() const
+{
+  size_t out = 0;
+  for (const Edges &edges : m_edges)
+    out += edges.capacity();
+  for (const Edges &edges : m_edgesFree)
+    out += edges.capacity();
+  return out;
+}
+//------------------------------------------------------------------------------
+
 // Initialize the Local Minima List:
 // Sort the LML entries, initialize the left / right bound edges of each Local Minima.
 void ClipperBase::Reset()
@@ -1041,6 +1074,8 @@ IntRect ClipperBase::GetBounds()
 
 Clipper::Clipper(int initOptions) : 
   ClipperBase(),
+  m_OutPtsChunksUsed(0),
+  m_OutPtsChunk(nullptr),
   m_OutPtsFree(nullptr),
   m_OutPtsChunkLast(m_OutPtsChunkSize),
   m_ActiveEdges(nullptr),
@@ -1059,7 +1094,7 @@ Clipper::Clipper(int initOptions) :
 void Clipper::Reset()
 {
   ClipperBase::Reset();
-  m_Scanbeam = std::priority_queue<cInt, cInts>{};
+  m_Scanbeam.clear();
   m_Maxima.clear();
   m_ActiveEdges = 0;
   m_SortedEdges = 0;
@@ -1173,20 +1208,23 @@ OutPt* Clipper::AllocateOutPt()
     pt = m_OutPtsFree;
     m_OutPtsFree = pt->Next;
   } else if (m_OutPtsChunkLast < m_OutPtsChunkSize) {
-    // Get a point from the last chunk.
-    pt = &m_OutPts.back()[m_OutPtsChunkLast ++];
+    // Get a point from the last chunk in use.
+    pt = &(*m_OutPtsChunk)[m_OutPtsChunkLast ++];
   } else {
-    // The last chunk is full. Allocate a new one.
-    m_OutPts.emplace_back();
+    // The last chunk is full. Reuse a chunk retained by DisposeAllOutRecs() or allocate a new one.
+    // All fields of OutPt are filled in by the callers, thus a reused chunk does not need to be cleared.
+    if (m_OutPtsChunksUsed == m_OutPts.size())
+      m_OutPts.emplace_back();
+    m_OutPtsChunk = &m_OutPts[m_OutPtsChunksUsed ++];
     m_OutPtsChunkLast = 1;
-    pt = &m_OutPts.back().front();
+    pt = &m_OutPtsChunk->front();
   }
   return pt;
 }
 
 void Clipper::DisposeAllOutRecs()
 {
-  m_OutPts.clear();
+  m_OutPtsChunksUsed = 0;
   m_OutPtsFree = nullptr;
   m_OutPtsChunkLast = m_OutPtsChunkSize;
   m_PolyOuts.clear();
@@ -3465,7 +3503,9 @@ void ClipperOffset::Execute(Paths& solution, double delta)
   DoOffset(delta);
   
   //now clean up 'corners' ...
-  Clipper clpr;
+  Clipper &clpr = m_clipper;
+  clpr.Clear();
+  clpr.ReverseSolution(false);
   clpr.AddPaths(m_destPolys, ptSubject, true);
   if (delta > 0)
   {
@@ -3496,7 +3536,9 @@ void ClipperOffset::Execute(PolyTree& solution, double delta)
   DoOffset(delta);
 
   //now clean up 'corners' ...
-  Clipper clpr;
+  Clipper &clpr = m_clipper;
+  clpr.Clear();
+  clpr.ReverseSolution(false);
   clpr.AddPaths(m_destPolys, ptSubject, true);
   if (delta > 0)
   {
@@ -84,6 +84,9 @@ enum PolyFillType { pftEvenOdd, pftNonZero, pftPositive, pftNegative };
 // consumption and to speed up exact orientation predicate calculation.
 // In that case, coordinates and their differences (vectors of the coordinates) have to fit int32_t.
 #define CLIPPERLIB_INT32
+// libslic3r compiles ClipperLib with Slic3r::Point as IntPoint, whose coord_t is int32_t, thus all the
+// ClipperUtils operations run on this 32bit kernel with 64bit exact cross products. The int64 kernel
+// is only kept for compatibility with the upstream ClipperLib, it is not used by libslic3r.
 
 // Point coordinate type
 #ifdef CLIPPERLIB_INT32
@@ -357,8 +360,8 @@ public:
     if (num_edges_total == 0)
       return false;
 
-    // Allocate a new edge array.
-    std::vector<TEdge, Allocator<TEdge>> edges(num_edges_total);
+    // Allocate a new edge array, possibly recycling one released by Clear().
+    Edges edges = AllocateEdges(num_edges_total);
     // Fill in the edge array.
     bool result = false;
     TEdge *p_edge = edges.data();
@@ -373,19 +376,24 @@ public:
       }
       ++ i;
     }
-    if (result)
-      // At least some edges were generated. Remember the edge array.
-      m_edges.emplace_back(std::move(edges));
+    // At least some edges were generated, remember the edge array. Otherwise keep it for reuse.
+    (result ? m_edges : m_edgesFree).emplace_back(std::move(edges));
     return result;
   }
 
+  // Clear() keeps the allocated buffers to be reused by the following AddPath() / AddPaths() / Execute() calls.
   void Clear();
+  // Number of edges and output points the buffers retained by Clear() can hold.
+  size_t RetainedCapacity() const;
   IntRect GetBounds();
   // By default, when three or more vertices are collinear in input polygons (subject or clip), the Clipper object removes the 'inner' vertices before clipping.
   // When enabled the PreserveCollinear property prevents this default behavior to allow these inner vertices to appear in the solution.
   bool PreserveCollinear() const {return m_PreserveCollinear;};
   void PreserveCollinear(bool value) {m_PreserveCollinear = value;};
 protected:
+  // A vector of edges per each input path.
+  using Edges = std::vector<TEdge, Allocator<TEdge>>;
+  Edges AllocateEdges(size_t num_edges);
   bool AddPathInternal(const Path &pg, int highI, PolyType PolyTyp, bool Closed, TEdge* edges);
   TEdge* AddBoundsToLML(TEdge *e, bool IsClosed);
   void Reset();
@@ -404,9 +412,9 @@ protected:
   bool              m_UseFullRange;
 #endif // CLIPPERLIB_INT32
 
-  // A vector of edges per each input path.
-  using Edges = std::vector<TEdge, Allocator<TEdge>>;
   std::vector<Edges, Allocator<Edges>> m_edges;
+  // Edge vectors released by Clear(), empty, but with their capacity retained.
+  std::vector<Edges, Allocator<Edges>> m_edgesFree;
   // Don't remove intermediate vertices of a collinear sequence of points.
   bool             m_PreserveCollinear;
   // Is any of the paths inserted by AddPath() or AddPaths() open?
@@ -420,6 +428,7 @@ public:
   Clipper(int initOptions = 0);
   ~Clipper() { Clear(); }
   void Clear() { ClipperBase::Clear(); DisposeAllOutRecs(); }
+  size_t RetainedCapacity() const { return ClipperBase::RetainedCapacity() + m_OutPts.size() * m_OutPtsChunkSize; }
   bool Execute(ClipType clipType,
       Paths &solution,
       PolyFillType fillType = pftEvenOdd) 
@@ -452,8 +461,12 @@ private:
   // Output polygons.
   std::deque<OutRec, Allocator<OutRec>>  m_PolyOuts;
   // Output points, allocated by a continuous sets of m_OutPtsChunkSize.
+  // The chunks are retained by DisposeAllOutRecs(), only the first m_OutPtsChunksUsed chunks are in use.
   static constexpr const size_t m_OutPtsChunkSize = 32;
   std::deque<std::array<OutPt, m_OutPtsChunkSize>, Allocator<std::array<OutPt, m_OutPtsChunkSize>>> m_OutPts;
+  size_t                m_OutPtsChunksUsed;
+  // Chunk m_OutPtsChunksUsed - 1, the points are taken from it up to m_OutPtsChunkLast.
+  std::array<OutPt, m_OutPtsChunkSize> *m_OutPtsChunk;
   // List of free output points, to be used before taking a point from m_OutPts or allocating a new chunk.
   OutPt                *m_OutPtsFree;
   size_t                m_OutPtsChunkLast;
@@ -464,7 +477,11 @@ private:
   ClipType              m_ClipType;
   // A priority queue (a binary heap) of Y coordinates.
   using cInts = std::vector<cInt, Allocator<cInt>>;
-  std::priority_queue<cInt, cInts> m_Scanbeam;
+  struct Scanbeam : public std::priority_queue<cInt, cInts> {
+    // Unlike assigning an empty queue, clear() keeps the capacity of the underlying vector.
+    void clear() { this->c.clear(); }
+  };
+  Scanbeam              m_Scanbeam;
   // Maxima are collected by ProcessEdgesAtTopOfScanbeam(), consumed by ProcessHorizontal().
   cInts                 m_Maxima;
   TEdge                *m_ActiveEdges;
@@ -550,6 +567,8 @@ public:
   void Execute(Paths& solution, double delta);
   void Execute(PolyTree& solution, double delta);
   void Clear();
+  // Number of edges and output points the buffers of the internal Clipper engine can hold.
+  size_t RetainedCapacity() const { return m_clipper.RetainedCapacity(); }
   double MiterLimit;
   double ArcTolerance;
   double ShortestEdgeLength;
@@ -565,6 +584,8 @@ private:
   // y: index of the lowest point in the lowest contour
   IntPoint m_lowest;
   PolyNode m_polyNodes;
+  // Cleans up the offset "corners", reused by the subsequent Execute() calls.
+  Clipper  m_clipper;
 
   void FixOrientations();
   void DoOffset(double delta);
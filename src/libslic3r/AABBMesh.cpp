@@ -24,6 +24,9 @@ private:
     double                   m_triangle_ray_epsilon;
 
 public:
+    // Number of rays traversing the tree together in intersect_rays().
+    static constexpr size_t RayPacketSize = 8;
+
     void init(const indexed_triangle_set &its, bool calculate_epsilon)
     {
         m_triangle_ray_epsilon = 0.000001;
@@ -55,6 +58,18 @@ public:
                                                  m_tree, s, dir, hits, m_triangle_ray_epsilon);
     }
 
+    void intersect_rays(const indexed_triangle_set &its,
+                        const Vec3d *               s,
+                        const Vec3d *               dirs,
+                        size_t                      count,
+                        igl::Hit *                  hits)
+    {
+        for (size_t i = 0; i < count; i += RayPacketSize)
+            AABBTreeIndirect::intersect_ray_packet_first_hit<RayPacketSize>(
+                its.vertices, its.indices, m_tree, s + i, dirs + i,
+                std::min(RayPacketSize, count - i), hits + i, m_triangle_ray_epsilon);
+    }
+
     double squared_distance(const indexed_triangle_set & its,
                             const Vec3d &                point,
                             int &                        i,
@@ -183,6 +198,39 @@ AABBMesh::query_ray_hit(const Vec3d &s, const Vec3d &dir) const
     return ret;
 }
 
+void AABBMesh::batch_query_ray_hit(tcb::span<const Vec3d> sources,
+                                   tcb::span<const Vec3d> dirs,
+                                   tcb::span<hit_result>  out) const
+{
+    assert(sources.size() == dirs.size() && sources.size() == out.size());
+
+#ifdef SLIC3R_HOLE_RAYCASTER
+    if (! m_holes.empty()) {
+        for (size_t i = 0; i < sources.size(); ++i)
+            out[i] = query_ray_hit(sources[i], dirs[i]);
+
+        return;
+    }
+#endif
+
+    std::vector<igl::Hit> hits(sources.size(), igl::Hit{-1, -1, 0.f, 0.f, std::numeric_limits<float>::infinity()});
+    m_aabb->intersect_rays(*m_tm, sources.data(), dirs.data(), sources.size(), hits.data());
+
+    for (size_t i = 0; i < sources.size(); ++i) {
+        assert(is_approx(dirs[i].norm(), 1.));
+        const igl::Hit &hit = hits[i];
+        hit_result      ret(*this);
+        ret.m_t      = double(hit.t);
+        ret.m_dir    = dirs[i];
+        ret.m_source = sources[i];
+        if (!std::isinf(hit.t) && !std::isnan(hit.t)) {
+            ret.m_normal  = this->normal_by_face_id(hit.id);
+            ret.m_face_id = hit.id;
+        }
+        out[i] = ret;
+    }
+}
+
 std::vector<AABBMesh::hit_result>
 AABBMesh::query_ray_hits(const Vec3d &s, const Vec3d &dir) const
 {
@@ -325,4 +373,12 @@ double AABBMesh::squared_distance(const Vec3d &p, int& i, Vec3d& c) const {
     return sqdst;
 }
 
+void AABBMesh::batch_squared_distance(tcb::span<const Vec3d> points,
+                                      tcb::span<double>      out) const
+{
+    assert(points.size() == out.size());
+    for (size_t i = 0; i < points.size(); ++i)
+        out[i] = squared_distance(points[i]);
+}
+
 } // namespace Slic3r
@@ -7,6 +7,8 @@
 
 #include <libslic3r/Point.hpp>
 #include <libslic3r/TriangleMesh.hpp>
+#include <libslic3r/Execution/Execution.hpp>
+#include <tcbspan/span.hpp>
 #include <assert.h>
 #include <stddef.h>
 #include <memory>
@@ -129,6 +131,14 @@ public:
     // Casts a ray on the mesh and returns all hits
     std::vector<hit_result> query_ray_hits(const Vec3d &s, const Vec3d &dir) const;
 
+    // Casting rays from sources[i] in directions dirs[i], the results are the
+    // same as of query_ray_hit() called for each ray. The rays are traced in
+    // packets traversing the AABB tree together, which is cheaper than casting
+    // them one by one if the rays are coherent, for example rays of a beam.
+    void batch_query_ray_hit(tcb::span<const Vec3d> sources,
+                             tcb::span<const Vec3d> dirs,
+                             tcb::span<hit_result>  out) const;
+
     double squared_distance(const Vec3d& p, int& i, Vec3d& c) const;
     inline double squared_distance(const Vec3d &p) const
     {
@@ -137,6 +147,10 @@ public:
         return squared_distance(p, i, c);
     }
 
+    // Squared distances of the points to the mesh.
+    void batch_squared_distance(tcb::span<const Vec3d> points,
+                                tcb::span<double>      out) const;
+
     Vec3d normal_by_face_id(int face_id) const;
 
     const indexed_triangle_set * get_triangle_mesh() const { return m_tm; }
@@ -145,6 +159,47 @@ public:
     const std::vector<Vec3i> &face_neighbor_index() const { return m_fnidx; }
 };
 
+// Batch queries split into chunks of grainsize rays or points, which are
+// processed by the execution policy.
+template<class Ex>
+std::vector<AABBMesh::hit_result> batch_query_ray_hit(Ex                     ex,
+                                                      const AABBMesh        &mesh,
+                                                      tcb::span<const Vec3d> sources,
+                                                      tcb::span<const Vec3d> dirs,
+                                                      size_t                 grainsize = 64)
+{
+    assert(sources.size() == dirs.size());
+    std::vector<AABBMesh::hit_result> ret(sources.size());
+    tcb::span<AABBMesh::hit_result>   out{ret};
+
+    execution::for_each(ex, size_t(0), (sources.size() + grainsize - 1) / grainsize,
+        [&mesh, sources, dirs, out, grainsize](size_t chunk) {
+            size_t from = chunk * grainsize;
+            size_t n    = std::min(grainsize, sources.size() - from);
+            mesh.batch_query_ray_hit(sources.subspan(from, n), dirs.subspan(from, n), out.subspan(from, n));
+        }, size_t(1));
+
+    return ret;
+}
+
+template<class Ex>
+std::vector<double> batch_squared_distance(Ex                     ex,
+                                           const AABBMesh        &mesh,
+                                           tcb::span<const Vec3d> points,
+                                           size_t                 grainsize = 64)
+{
+    std::vector<double> ret(points.size());
+    tcb::span<double>   out{ret};
+
+    execution::for_each(ex, size_t(0), (points.size() + grainsize - 1) / grainsize,
+        [&mesh, points, out, grainsize](size_t chunk) {
+            size_t from = chunk * grainsize;
+            size_t n    = std::min(grainsize, points.size() - from);
+            mesh.batch_squared_distance(points.subspan(from, n), out.subspan(from, n));
+        }, size_t(1));
+
+    return ret;
+}
 
 } // namespace Slic3r::sla
 
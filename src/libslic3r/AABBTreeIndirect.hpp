@@ -11,12 +11,16 @@
 #define slic3r_AABBTreeIndirect_hpp_
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <limits>
 #include <type_traits>
 #include <vector>
 
 #include <Eigen/Geometry>
 
+#include <oneapi/tbb/parallel_invoke.h>
+
 #include "BoundingBox.hpp"
 #include "Utils.hpp" // for next_highest_power_of_2()
 
@@ -123,6 +127,9 @@ public:
 	}
 
 private:
+	// Subtrees over fewer entities are built serially.
+	static constexpr size_t ParallelThreshold = 8192;
+
 	// Build a balanced tree by splitting the input sequence by an axis aligned plane at a dimension.
 	template<typename SourceNode>
 	void build_recursive(std::vector<SourceNode> &input, size_t node, const size_t left, const size_t right)
@@ -149,8 +156,15 @@ private:
 		// Insert an inner node into the tree. Inner node does not reference any input entity (triangle, line segment etc).
 		m_nodes[node].idx  = inner;
 		m_nodes[node].bbox = bbox;
-        build_recursive(input, node * 2 + 1, left, center);
-		build_recursive(input, node * 2 + 2, center + 1, right);
+		if (right - left > ParallelThreshold)
+			// The subtrees are built over disjoint ranges of the input into disjoint nodes.
+			tbb::parallel_invoke(
+				[this, &input, node, left, center]() { build_recursive(input, node * 2 + 1, left, center); },
+				[this, &input, node, center, right]() { build_recursive(input, node * 2 + 2, center + 1, right); });
+		else {
+	        build_recursive(input, node * 2 + 1, left, center);
+			build_recursive(input, node * 2 + 2, center + 1, right);
+		}
 	}
 
 	// Partition the input m_nodes <left, right> at "k" and "dimension" using the QuickSelect method:
@@ -264,6 +278,33 @@ namespace detail {
 		std::vector<igl::Hit>				 hits;
 	};
 
+	// Up to N rays traversing the AABB tree together, see intersect_ray_packet_first_hit().
+	template<size_t N, typename AVertexType, typename AIndexedFaceType, typename ATreeType, typename AVectorType>
+	struct RayPacketIntersector {
+		static_assert(N <= 32, "The active rays of a packet are stored in a 32 bit mask");
+
+		using VertexType 		= AVertexType;
+		using IndexedFaceType 	= AIndexedFaceType;
+		using TreeType			= ATreeType;
+		using VectorType 		= AVectorType;
+		using Scalar            = typename VectorType::Scalar;
+
+		const std::vector<VertexType> 		&vertices;
+		const std::vector<IndexedFaceType> 	&faces;
+		const TreeType 						&tree;
+
+		size_t                               count;
+		std::array<VectorType, N>            origins;
+		std::array<VectorType, N>            dirs;
+		std::array<VectorType, N>            invdirs;
+		// Parameter of the closest hit found so far for each ray.
+		std::array<Scalar, N>                min_t;
+		igl::Hit                            *hits;
+
+		// epsilon for ray-triangle intersection, see intersect_triangle1()
+		const double  						 eps;
+	};
+
 	//FIXME implement SSE for float AABB trees with float ray queries.
 	// SSE/SSE2 is supported by any Intel/AMD x64 processor.
 	// SSE support requires 16 byte alignment of the AABB nodes, representing the bounding boxes with 4+4 floats,
@@ -443,6 +484,51 @@ namespace detail {
 		}
 	}
 
+	// The same traversal as intersect_ray_recursive_first_hit(), a node is visited once for all rays of the packet
+	// still intersecting its bounding box.
+    template<typename RayPacketIntersectorType>
+	static inline void intersect_ray_packet_recursive_first_hit(
+        RayPacketIntersectorType &packet,
+        size_t 				      node_idx,
+        uint32_t                  mask)
+	{
+        using Scalar = typename RayPacketIntersectorType::Scalar;
+
+        const auto &node = packet.tree.node(node_idx);
+        assert(node.is_valid());
+
+        const auto bbox   = node.bbox.template cast<Scalar>();
+        uint32_t   active = 0;
+        for (size_t i = 0; i < packet.count; ++ i)
+            if ((mask & (uint32_t(1) << i)) &&
+                ray_box_intersect_invdir(packet.origins[i], packet.invdirs[i], bbox, Scalar(0), packet.min_t[i]))
+                active |= uint32_t(1) << i;
+        if (active == 0)
+            return;
+
+	  	if (node.is_leaf()) {
+            auto face = packet.faces[node.idx];
+            for (size_t i = 0; i < packet.count; ++ i)
+                if (active & (uint32_t(1) << i)) {
+                    double t, u, v;
+                    if (intersect_triangle(
+                            packet.origins[i], packet.dirs[i],
+                            packet.vertices[face(0)], packet.vertices[face(1)], packet.vertices[face(2)],
+                            t, u, v, packet.eps)
+                        && t > 0. && Scalar(float(t)) < packet.min_t[i]) {
+                        packet.hits[i]  = igl::Hit { int(node.idx), -1, float(u), float(v), float(t) };
+                        packet.min_t[i] = Scalar(float(t));
+                    }
+                }
+	  	} else {
+			// Left / right child node index.
+			size_t left  = node_idx * 2 + 1;
+			size_t right = left + 1;
+		  	intersect_ray_packet_recursive_first_hit(packet, left,  active);
+		  	intersect_ray_packet_recursive_first_hit(packet, right, active);
+		}
+	}
+
     template<typename RayIntersectorType>
 	static inline void intersect_ray_recursive_all_hits(RayIntersectorType &ray_intersector, size_t node_idx)
 	{
@@ -750,6 +836,55 @@ inline bool intersect_ray_first_hit(
         ray_intersector, size_t(0), std::numeric_limits<Scalar>::infinity(), hit);
 }
 
+// Find the first intersections of up to N rays with indexed triangle set. The rays traverse the AABB tree
+// together, thus the nodes hit by several rays are fetched and tested once for all of them, which pays off
+// for coherent rays. The hits are the same as if intersect_ray_first_hit() was called for each ray.
+// Returns a mask with the bits of the rays hitting the triangle set set.
+template<size_t N, typename VertexType, typename IndexedFaceType, typename TreeType, typename VectorType>
+inline uint32_t intersect_ray_packet_first_hit(
+	// Indexed triangle set - 3D vertices.
+	const std::vector<VertexType> 		&vertices,
+	// Indexed triangle set - triangular faces, references to vertices.
+	const std::vector<IndexedFaceType> 	&faces,
+	// AABBTreeIndirect::Tree over vertices & faces, bounding boxes built with the accuracy of vertices.
+	const TreeType 						&tree,
+	// Origins of the rays.
+	const VectorType					*origins,
+	// Directions of the rays.
+	const VectorType 					*dirs,
+	// Number of the rays, at most N.
+	size_t                               count,
+	// First intersections of the rays with the indexed triangle set, the hits of rays missing the triangle set are not modified.
+	igl::Hit 							*hits,
+	// Epsilon for the ray-triangle intersection, it should be proportional to an average triangle edge length.
+	const double 						 eps = 0.000001)
+{
+    using Scalar = typename VectorType::Scalar;
+    assert(count <= N);
+    if (tree.empty() || count == 0)
+        return 0;
+
+    auto packet = detail::RayPacketIntersector<N, VertexType, IndexedFaceType, TreeType, VectorType> {
+        vertices, faces, tree, count, {}, {}, {}, {}, hits, eps
+    };
+    for (size_t i = 0; i < count; ++ i) {
+        packet.origins[i] = origins[i];
+        packet.dirs[i]    = dirs[i];
+        packet.invdirs[i] = VectorType(dirs[i].cwiseInverse());
+        packet.min_t[i]   = std::numeric_limits<Scalar>::infinity();
+    }
+
+    uint32_t mask = count == 32 ? ~uint32_t(0) : ((uint32_t(1) << count) - 1);
+
+    detail::intersect_ray_packet_recursive_first_hit(packet, size_t(0), mask);
+
+    uint32_t ret = 0;
+    for (size_t i = 0; i < count; ++ i)
+        if (packet.min_t[i] < std::numeric_limits<Scalar>::infinity())
+            ret |= uint32_t(1) << i;
+    return ret;
+}
+
 // Find all intersections of a ray with indexed triangle set.
 // Intersection test is calculated with the accuracy of VectorType::Scalar
 // even if the triangle mesh and the AABB Tree are built with floats.
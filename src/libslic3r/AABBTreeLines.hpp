@@ -255,6 +255,21 @@ inline typename VectorType::Scalar squared_distance_to_indexed_lines(
                                                                                       hit_idx_out, hit_point_out);
 }
 
+// Appends all lines within the given radius limit to found_lines.
+template<typename LineType, typename TreeType, typename VectorType>
+inline void all_lines_in_radius(const std::vector<LineType> &lines,
+                                const TreeType              &tree,
+                                const VectorType            &point,
+                                typename VectorType::Scalar  max_distance_squared,
+                                std::vector<size_t>         &found_lines)
+{
+    auto distancer = detail::IndexedLinesDistancer<LineType, TreeType, VectorType>{lines, tree, point};
+
+    if (tree.empty()) { return; }
+
+    AABBTreeIndirect::detail::indexed_primitives_within_distance_squared_recurisve(distancer, size_t(0), max_distance_squared, found_lines);
+}
+
 // Returns all lines within the given radius limit
 template<typename LineType, typename TreeType, typename VectorType>
 inline std::vector<size_t> all_lines_in_radius(const std::vector<LineType> &lines,
@@ -262,12 +277,8 @@ inline std::vector<size_t> all_lines_in_radius(const std::vector<LineType> &line
                                                const VectorType            &point,
                                                typename VectorType::Scalar  max_distance_squared)
 {
-    auto distancer = detail::IndexedLinesDistancer<LineType, TreeType, VectorType>{lines, tree, point};
-
-    if (tree.empty()) { return {}; }
-
     std::vector<size_t> found_lines{};
-    AABBTreeIndirect::detail::indexed_primitives_within_distance_squared_recurisve(distancer, size_t(0), max_distance_squared, found_lines);
+    all_lines_in_radius(lines, tree, point, max_distance_squared, found_lines);
     return found_lines;
 }
 
@@ -345,7 +356,7 @@ public:
         tree = AABBTreeLines::build_aabb_tree_over_indexed_lines(this->lines);
     }
 
-    explicit LinesDistancer(std::vector<LineType> &&lines) : lines(lines)
+    explicit LinesDistancer(std::vector<LineType> &&lines) : lines(std::move(lines))
     {
         tree = AABBTreeLines::build_aabb_tree_over_indexed_lines(this->lines);
     }
@@ -367,13 +378,29 @@ public:
         if (distance < 0) {
             return {std::numeric_limits<Floating>::infinity(), nearest_line_index_out, nearest_point_out};
         }
-        distance = sqrt(distance);
+        return finish_distance<SIGNED_DISTANCE>(point, distance, nearest_line_index_out, nearest_point_out);
+    }
 
-        if (SIGNED_DISTANCE) {
-            distance *= outside(point);
-        }
+    // The same as distance_from_lines_extra(point). The distance to hint_line_idx, usually the nearest line of the previous
+    // point of a polyline, bounds the search, thus only the subtrees closer than the hint line are traversed.
+    // Ties are resolved in favor of the hint line.
+    template<bool SIGNED_DISTANCE>
+    std::tuple<Floating, size_t, Vec<2, Floating>> distance_from_lines_extra(const Vec<2, Scalar> &point, size_t hint_line_idx) const
+    {
+        if (hint_line_idx >= lines.size())
+            return distance_from_lines_extra<SIGNED_DISTANCE>(point);
 
-        return {distance, nearest_line_index_out, nearest_point_out};
+        Vec<2, Floating> p         = point.template cast<Floating>();
+        Floating         hint_distance;
+        Vec<2, Floating> hint_point = detail::IndexedLinesDistancer<LineType, decltype(tree), Vec<2, Floating>>{lines, tree, p}
+                                          .closest_point_to_origin(hint_line_idx, hint_distance);
+        size_t           nearest_line_index_out = size_t(-1);
+        Vec<2, Floating> nearest_point_out      = Vec<2, Floating>::Zero();
+        auto distance = AABBTreeLines::squared_distance_to_indexed_lines(lines, tree, p, nearest_line_index_out, nearest_point_out, hint_distance);
+        if (nearest_line_index_out == size_t(-1))
+            // No line closer than the hint line.
+            return finish_distance<SIGNED_DISTANCE>(point, hint_distance, hint_line_idx, hint_point);
+        return finish_distance<SIGNED_DISTANCE>(point, distance, nearest_line_index_out, nearest_point_out);
     }
 
     template<bool SIGNED_DISTANCE> Floating distance_from_lines(const Vec<2, Scalar> &point) const
@@ -387,6 +414,13 @@ public:
         return AABBTreeLines::all_lines_in_radius(this->lines, this->tree, point.template cast<Floating>(), radius * radius);
     }
 
+    // Fills found_lines, so that its memory is reused by repeated queries.
+    void all_lines_in_radius(const Vec<2, Scalar> &point, Floating radius, std::vector<size_t> &found_lines) const
+    {
+        found_lines.clear();
+        AABBTreeLines::all_lines_in_radius(this->lines, this->tree, point.template cast<Floating>(), radius * radius, found_lines);
+    }
+
     template<bool sorted> std::vector<std::pair<Vec<2, Scalar>, size_t>> intersections_with_line(const LineType &line) const
     {
         return get_intersections_with_line<sorted, Vec<2, Scalar>>(lines, tree, line);
@@ -395,6 +429,17 @@ public:
     const LineType &get_line(size_t line_idx) const { return lines[line_idx]; }
 
     const std::vector<LineType> &get_lines() const { return lines; }
+
+private:
+    template<bool SIGNED_DISTANCE>
+    std::tuple<Floating, size_t, Vec<2, Floating>> finish_distance(const Vec<2, Scalar> &point, Floating squared_distance, size_t nearest_line, const Vec<2, Floating> &nearest_point) const
+    {
+        Floating distance = sqrt(squared_distance);
+        if (SIGNED_DISTANCE) {
+            distance *= outside(point);
+        }
+        return {distance, nearest_line, nearest_point};
+    }
 };
 
 }} // namespace Slic3r::AABBTreeLines
@@ -0,0 +1,406 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef slic3r_AABBTreeWide_hpp_
+#define slic3r_AABBTreeWide_hpp_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <oneapi/tbb/parallel_for.h>
+
+#include "AABBTreeIndirect.hpp"
+
+namespace Slic3r {
+namespace AABBTreeIndirect {
+
+// Bounding volume hierarchy with up to four children per node, an alternative to the balanced binary Tree
+// for meshes queried by many rays.
+// The hierarchy is built top down using the binned surface area heuristic, the subtrees are built in parallel.
+// The heuristic adapts to the distribution of the triangles, thus less nodes are visited by a ray than with
+// the median split of the balanced Tree, at the cost of a slower build.
+// The nodes are stored in a depth first order in a single vector. All four bounding boxes of the children
+// are stored in the parent node by coordinates, so that a ray is tested against all of them at once
+// with a single node fetched from memory.
+// The leaves are not stored as nodes, a child references a range of up to MaxLeafSize source entities.
+template<typename ACoordType>
+class WideTree
+{
+public:
+    using CoordType   = ACoordType;
+    using VectorType  = Eigen::Matrix<CoordType, 3, 1, Eigen::DontAlign>;
+    using BoundingBox = Eigen::AlignedBox<CoordType, 3>;
+
+    static constexpr size_t   Width       = 4;
+    static constexpr size_t   MaxLeafSize = 4;
+    // Unused child slot.
+    static constexpr uint32_t EmptyChild  = uint32_t(-1);
+
+    struct Node {
+        // Bounding boxes of the children, indexed by coordinate and child.
+        CoordType bmin[3][Width];
+        CoordType bmax[3][Width];
+        // Index of a child node, a range of the source entities for leaves, EmptyChild for unused slots.
+        uint32_t  children[Width];
+    };
+
+    // Leaf encoding: the highest bit set, index of the first entity in the upper bits and the number of entities in the lowest 3 bits.
+    static bool     is_leaf(uint32_t child)    { return child != EmptyChild && (child & LeafFlag) != 0; }
+    static size_t   leaf_first(uint32_t child) { return (child & ~LeafFlag) >> 3; }
+    static size_t   leaf_size(uint32_t child)  { return child & 7; }
+
+    void clear() { m_nodes.clear(); m_indices.clear(); }
+
+    // SourceNode shall implement idx(), bbox() and centroid(), see Tree::build().
+    template<typename SourceNode>
+    void build(std::vector<SourceNode> &&input)
+    {
+        this->build_modify_input(input);
+        input.clear();
+    }
+
+    template<typename SourceNode>
+    void build_modify_input(std::vector<SourceNode> &input)
+    {
+        this->clear();
+        if (input.empty())
+            return;
+        assert(input.size() < (size_t(1) << 28));
+        // A node has at least two children, a leaf at least one entity, thus the number of nodes is lower than the number of entities.
+        std::vector<Node>     nodes(input.size());
+        std::atomic<uint32_t> num_nodes { 0 };
+        build_recursive(input, nodes, num_nodes, 0, input.size(), 0);
+        nodes.resize(num_nodes);
+        m_indices.reserve(input.size());
+        for (const SourceNode &in : input)
+            m_indices.emplace_back(in.idx());
+        // The nodes were allocated by the parallel tasks in an arbitrary order, store them depth first.
+        std::vector<uint32_t> new_idx(nodes.size());
+        std::vector<uint32_t> order;
+        order.reserve(nodes.size());
+        std::vector<uint32_t> stack { 0 };
+        while (! stack.empty()) {
+            uint32_t idx = stack.back();
+            stack.pop_back();
+            new_idx[idx] = uint32_t(order.size());
+            order.emplace_back(idx);
+            for (size_t i = Width; i > 0; -- i)
+                if (uint32_t child = nodes[idx].children[i - 1]; child != EmptyChild && ! is_leaf(child))
+                    stack.emplace_back(child);
+        }
+        m_nodes.reserve(order.size());
+        for (uint32_t idx : order) {
+            Node &node = m_nodes.emplace_back(nodes[idx]);
+            for (uint32_t &child : node.children)
+                if (child != EmptyChild && ! is_leaf(child))
+                    child = new_idx[child];
+        }
+    }
+
+    template<typename SourceNode>
+    void build(const std::vector<SourceNode> &input)
+    {
+        std::vector<SourceNode> copy(input);
+        this->build(std::move(copy));
+    }
+
+    const std::vector<Node>&   nodes() const { return m_nodes; }
+    const Node&                node(size_t idx) const { return m_nodes[idx]; }
+    // Indices of the source entities referenced by the leaves.
+    const std::vector<size_t>& indices() const { return m_indices; }
+    bool                       empty() const { return m_nodes.empty(); }
+
+private:
+    static constexpr uint32_t LeafFlag = uint32_t(1) << 31;
+    // Number of the bins of the surface area heuristic.
+    static constexpr size_t   NumBins  = 16;
+    // Subtrees over fewer entities are built serially.
+    static constexpr size_t   ParallelThreshold = 4096;
+    // Below this depth the input is split at the median to limit the height of the tree, see intersect_ray_first_hit().
+    static constexpr size_t   MaxSAHDepth = 32;
+
+    struct Range {
+        size_t      begin;
+        size_t      end;
+        BoundingBox bbox;
+        size_t      size() const { return end - begin; }
+    };
+
+    static double surface_area(const BoundingBox &bbox)
+    {
+        if (bbox.isEmpty())
+            return 0.;
+        const Vec3d d = bbox.diagonal().template cast<double>();
+        return d.x() * d.y() + d.y() * d.z() + d.z() * d.x();
+    }
+
+    template<typename SourceNode>
+    static BoundingBox range_bbox(const std::vector<SourceNode> &input, size_t begin, size_t end)
+    {
+        BoundingBox bbox;
+        for (size_t i = begin; i < end; ++ i)
+            bbox.extend(input[i].bbox());
+        return bbox;
+    }
+
+    // Split the range by the binned surface area heuristic along the longest axis of the centroids,
+    // or at the median below MaxSAHDepth. Returns the index of the first entity of the right part.
+    template<typename SourceNode>
+    static size_t split(std::vector<SourceNode> &input, size_t begin, size_t end, size_t depth)
+    {
+        assert(end - begin > 1);
+        BoundingBox centroids;
+        for (size_t i = begin; i < end; ++ i)
+            centroids.extend(input[i].centroid());
+        int axis = -1;
+        const CoordType extent = centroids.diagonal().maxCoeff(&axis);
+        if (extent <= 0)
+            // All the centroids are at the same point.
+            return (begin + end) / 2;
+        if (depth >= MaxSAHDepth) {
+            size_t center = (begin + end) / 2;
+            std::nth_element(input.begin() + begin, input.begin() + center, input.begin() + end,
+                [axis](const SourceNode &l, const SourceNode &r) { return l.centroid()(axis) < r.centroid()(axis); });
+            return center;
+        }
+
+        const double cmin  = double(centroids.min()(axis));
+        const double scale = double(NumBins) * (1. - 1e-6) / double(extent);
+        auto bin_of = [axis, cmin, scale](const SourceNode &in) {
+            return std::min(NumBins - 1, size_t(std::max(0., (double(in.centroid()(axis)) - cmin) * scale)));
+        };
+        std::array<BoundingBox, NumBins> bin_bbox;
+        std::array<size_t, NumBins>      bin_count {};
+        for (size_t i = begin; i < end; ++ i) {
+            size_t bin = bin_of(input[i]);
+            bin_bbox[bin].extend(input[i].bbox());
+            ++ bin_count[bin];
+        }
+        // Cost of the split in front of each bin, surface area of the children weighted by the number of their entities.
+        std::array<double, NumBins> right_cost {};
+        {
+            BoundingBox bbox;
+            size_t      count = 0;
+            for (size_t bin = NumBins - 1; bin > 0; -- bin) {
+                bbox.extend(bin_bbox[bin]);
+                count += bin_count[bin];
+                right_cost[bin] = surface_area(bbox) * double(count);
+            }
+        }
+        size_t best_bin  = 1;
+        double best_cost = std::numeric_limits<double>::max();
+        {
+            BoundingBox bbox;
+            size_t      count = 0;
+            for (size_t bin = 1; bin < NumBins; ++ bin) {
+                bbox.extend(bin_bbox[bin - 1]);
+                count += bin_count[bin - 1];
+                if (double cost = surface_area(bbox) * double(count) + right_cost[bin]; cost < best_cost) {
+                    best_cost = cost;
+                    best_bin  = bin;
+                }
+            }
+        }
+        // The first and the last bins are not empty, thus both parts are not empty.
+        auto it = std::partition(input.begin() + begin, input.begin() + end, [&bin_of, best_bin](const SourceNode &in) { return bin_of(in) < best_bin; });
+        return size_t(it - input.begin());
+    }
+
+    // Returns index of the node built over the range.
+    template<typename SourceNode>
+    static uint32_t build_recursive(std::vector<SourceNode> &input, std::vector<Node> &nodes, std::atomic<uint32_t> &num_nodes, size_t begin, size_t end, size_t depth)
+    {
+        // Split the largest child until there are Width children or until all of them fit into leaves.
+        std::array<Range, Width> children;
+        size_t                   num_children = 1;
+        children.front() = Range{ begin, end, range_bbox(input, begin, end) };
+        while (num_children < Width) {
+            size_t largest = 0;
+            for (size_t i = 1; i < num_children; ++ i)
+                if (children[i].size() > children[largest].size())
+                    largest = i;
+            if (children[largest].size() <= MaxLeafSize)
+                break;
+            Range &range  = children[largest];
+            size_t center = split(input, range.begin, range.end, depth);
+            children[num_children ++] = Range{ center, range.end, range_bbox(input, center, range.end) };
+            range = Range{ range.begin, center, range_bbox(input, range.begin, center) };
+        }
+        std::sort(children.begin(), children.begin() + num_children, [](const Range &l, const Range &r) { return l.begin < r.begin; });
+
+        const uint32_t node_idx = num_nodes ++;
+        Node          &node     = nodes[node_idx];
+        for (size_t i = 0; i < Width; ++ i) {
+            const bool valid = i < num_children;
+            for (int axis = 0; axis < 3; ++ axis) {
+                node.bmin[axis][i] = valid ? children[i].bbox.min()(axis) : std::numeric_limits<CoordType>::max();
+                node.bmax[axis][i] = valid ? children[i].bbox.max()(axis) : std::numeric_limits<CoordType>::lowest();
+            }
+            node.children[i] = ! valid ? EmptyChild : LeafFlag | uint32_t(children[i].begin << 3) | uint32_t(children[i].size());
+        }
+
+        // Children not fitting into leaves are built as subtrees, in parallel for large ranges.
+        auto build_child = [&](size_t i) {
+            if (children[i].size() > MaxLeafSize)
+                node.children[i] = build_recursive(input, nodes, num_nodes, children[i].begin, children[i].end, depth + 1);
+        };
+        if (end - begin > ParallelThreshold)
+            tbb::parallel_for(size_t(0), num_children, build_child);
+        else
+            for (size_t i = 0; i < num_children; ++ i)
+                build_child(i);
+        return node_idx;
+    }
+
+    std::vector<Node>   m_nodes;
+    std::vector<size_t> m_indices;
+};
+
+// Build a WideTree over an indexed triangle set, see build_aabb_tree_over_indexed_triangle_set().
+template<typename VertexType, typename IndexedFaceType>
+inline WideTree<typename VertexType::Scalar> build_wide_tree_over_indexed_triangle_set(
+	// Indexed triangle set - 3D vertices.
+	const std::vector<VertexType> 		&vertices,
+	// Indexed triangle set - triangular faces, references to vertices.
+    const std::vector<IndexedFaceType> 	&faces,
+    const typename VertexType::Scalar 	 eps = 0)
+{
+    using TreeType    = WideTree<typename VertexType::Scalar>;
+    using VectorType  = typename TreeType::VectorType;
+    using BoundingBox = typename TreeType::BoundingBox;
+
+	struct InputType {
+        size_t 				idx()       const { return m_idx; }
+        const BoundingBox& 	bbox()      const { return m_bbox; }
+        const VectorType& 	centroid()  const { return m_centroid; }
+
+		size_t 		m_idx;
+		BoundingBox m_bbox;
+        VectorType 	m_centroid;
+	};
+
+	std::vector<InputType> input(faces.size());
+    const VectorType veps(eps, eps, eps);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, faces.size()), [&vertices, &faces, &input, &veps](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            const IndexedFaceType &face = faces[i];
+            const VertexType &v1 = vertices[face(0)];
+            const VertexType &v2 = vertices[face(1)];
+            const VertexType &v3 = vertices[face(2)];
+            InputType &n = input[i];
+            n.m_idx      = i;
+            n.m_centroid = (1./3.) * (v1 + v2 + v3);
+            n.m_bbox     = BoundingBox(v1, v1);
+            n.m_bbox.extend(v2);
+            n.m_bbox.extend(v3);
+            n.m_bbox.min() -= veps;
+            n.m_bbox.max() += veps;
+        }
+    });
+	TreeType out;
+	out.build(std::move(input));
+	return out;
+}
+
+// Find the first intersection of a ray with indexed triangle set, the same as intersect_ray_first_hit() over
+// the balanced Tree. The children of a node are visited front to back, thus the farther subtrees are likely culled.
+template<typename VertexType, typename IndexedFaceType, typename CoordType, typename VectorType>
+inline bool intersect_ray_first_hit(
+	// Indexed triangle set - 3D vertices.
+	const std::vector<VertexType> 		&vertices,
+	// Indexed triangle set - triangular faces, references to vertices.
+	const std::vector<IndexedFaceType> 	&faces,
+	// WideTree over vertices & faces, bounding boxes built with the accuracy of vertices.
+	const WideTree<CoordType>			&tree,
+	// Origin of the ray.
+	const VectorType					&origin,
+	// Direction of the ray.
+	const VectorType 					&dir,
+	// First intersection of the ray with the indexed triangle set.
+	igl::Hit 							&hit,
+	// Epsilon for the ray-triangle intersection, it should be proportional to an average triangle edge length.
+	const double 						 eps = 0.000001)
+{
+    using Scalar   = typename VectorType::Scalar;
+    using TreeType = WideTree<CoordType>;
+    constexpr size_t Width = TreeType::Width;
+
+    if (tree.empty())
+        return false;
+
+    const VectorType invdir = dir.cwiseInverse();
+    // Bounding box coordinates entered and left by the ray first.
+    int near_side[3], far_side[3];
+    for (int axis = 0; axis < 3; ++ axis) {
+        near_side[axis] = invdir(axis) < 0;
+        far_side[axis]  = 1 - near_side[axis];
+    }
+
+    Scalar min_t = std::numeric_limits<Scalar>::infinity();
+    bool   found = false;
+    // The height of the tree is limited by WideTree::MaxSAHDepth, at most Width - 1 entries are pushed per level.
+    struct StackEntry { uint32_t node; Scalar t; };
+    std::array<StackEntry, 256> stack;
+    size_t stack_size = 0;
+    stack[stack_size ++] = { 0, Scalar(0) };
+    while (stack_size > 0) {
+        const StackEntry entry = stack[-- stack_size];
+        if (entry.t > min_t)
+            continue;
+        const auto &node = tree.node(entry.node);
+        // Slab test of all children at once, NaNs produced by axis parallel rays are ignored.
+        std::array<Scalar, Width> tnear, tfar;
+        tnear.fill(Scalar(0));
+        tfar.fill(min_t);
+        for (int axis = 0; axis < 3; ++ axis) {
+            const CoordType *bnear = near_side[axis] ? node.bmax[axis] : node.bmin[axis];
+            const CoordType *bfar  = far_side[axis]  ? node.bmax[axis] : node.bmin[axis];
+            for (size_t i = 0; i < Width; ++ i) {
+                Scalar t0 = (Scalar(bnear[i]) - origin(axis)) * invdir(axis);
+                Scalar t1 = (Scalar(bfar[i])  - origin(axis)) * invdir(axis);
+                tnear[i]  = t0 > tnear[i] ? t0 : tnear[i];
+                tfar[i]   = t1 < tfar[i]  ? t1 : tfar[i];
+            }
+        }
+        // Intersected child nodes sorted by the distance, the closest is at the top of the stack.
+        std::array<StackEntry, Width> hit_nodes;
+        size_t num_hit_nodes = 0;
+        for (size_t i = 0; i < Width; ++ i) {
+            const uint32_t child = node.children[i];
+            if (child == TreeType::EmptyChild || tnear[i] > tfar[i])
+                continue;
+            if (TreeType::is_leaf(child)) {
+                for (size_t j = TreeType::leaf_first(child), j_end = j + TreeType::leaf_size(child); j < j_end; ++ j) {
+                    const size_t face_idx = tree.indices()[j];
+                    const auto  &face     = faces[face_idx];
+                    double t, u, v;
+                    if (detail::intersect_triangle(origin, dir, vertices[face(0)], vertices[face(1)], vertices[face(2)], t, u, v, eps)
+                        && t > 0. && Scalar(float(t)) < min_t) {
+                        hit   = igl::Hit { int(face_idx), -1, float(u), float(v), float(t) };
+                        min_t = Scalar(float(t));
+                        found = true;
+                    }
+                }
+            } else {
+                size_t k = num_hit_nodes ++;
+                for (; k > 0 && hit_nodes[k - 1].t < tnear[i]; -- k)
+                    hit_nodes[k] = hit_nodes[k - 1];
+                hit_nodes[k] = { child, tnear[i] };
+            }
+        }
+        assert(stack_size + num_hit_nodes <= stack.size());
+        for (size_t i = 0; i < num_hit_nodes; ++ i)
+            stack[stack_size ++] = hit_nodes[i];
+    }
+    return found;
+}
+
+} // namespace AABBTreeIndirect
+} // namespace Slic3r
+
+#endif // slic3r_AABBTreeWide_hpp_
@@ -9,6 +9,8 @@
 #include <libslic3r/ClipperUtils.hpp>
 #include <libslic3r/Utils.hpp>
 #include <clipper/clipper_z.hpp>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <numeric>
 #include <cmath>
 #include <iterator>
@@ -378,6 +380,17 @@ static ClipperLib::Paths wavefront_step(ClipperLib::ClipperOffset &co, const Cli
     return out;
 }
 
+// Same as wavefront_step(), but all the polygons are offsetted by a single run of the offsetter.
+// The offsetter keeps the orientation of the holes and it merges the overlapping inflated polygons.
+static ClipperLib::Paths wavefront_step_batched(ClipperLib::ClipperOffset &co, const ClipperLib::Paths &polygons, float offset)
+{
+    ClipperLib::Paths out;
+    co.Clear();
+    co.AddPaths(polygons, jtRound, ClipperLib::etClosedPolygon);
+    co.Execute(out, offset);
+    return out;
+}
+
 static ClipperLib::Paths wavefront_clip(const ClipperLib::Paths &wavefront, const Polygons &clipping)
 {
     ClipperLib::Clipper clipper;
@@ -402,38 +415,53 @@ static Polygons propagate_wave_from_boundary(
     const size_t                 num_other_steps,
     // Maximum inflation of seed contours over the boundary. Used to trim boundary to speed up
     // clipping during wave propagation.
-    const float                  max_inflation)
+    const float                  max_inflation,
+    // Offset a wave front by a single offsetter run.
+    const bool                   batch_offsets)
 {
     assert(! seed.empty() && seed.front().size() >= 2);
     Polygons clipping = ClipperUtils::clip_clipper_polygons_with_subject_bbox(boundary, get_extents<true>(seed).inflated(max_inflation));
     ClipperLib::Paths polygons = wavefront_clip(wavefront_initial(co, seed, initial_step), clipping);
     // Now offset the remaining 
     for (size_t ioffset = 0; ioffset < num_other_steps; ++ ioffset)
-        polygons = wavefront_clip(wavefront_step(co, polygons, other_step), clipping);
+        polygons = wavefront_clip(batch_offsets ? wavefront_step_batched(co, polygons, other_step) : wavefront_step(co, polygons, other_step), clipping);
     return to_polygons(polygons);
 }
 
 // Resulting regions are sorted by boundary id and source id.
 std::vector<RegionExpansion> propagate_waves(const WaveSeeds &seeds, const ExPolygons &boundary, const RegionExpansionParameters &params)
 {
+    // Split the seeds into islands of the same source and boundary, the waves of the islands do not interact.
+    std::vector<size_t> islands;
+    for (size_t i = 0; i < seeds.size(); ++ i)
+        if (i == 0 || seeds[i].boundary != seeds[i - 1].boundary || seeds[i].src != seeds[i - 1].src)
+            islands.emplace_back(i);
+    islands.emplace_back(seeds.size());
+
+    std::vector<Polygons> expanded(islands.size() - 1);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, expanded.size()), [&seeds, &boundary, &params, &islands, &expanded](const tbb::blocked_range<size_t> &range) {
+        ClipperLib::Paths         paths;
+        ClipperLib::ClipperOffset co;
+        co.ArcTolerance       = params.arc_tolerance;
+        co.ShortestEdgeLength = params.shortest_edge_length;
+        for (size_t island = range.begin(); island < range.end(); ++ island) {
+            paths.clear();
+            for (size_t i = islands[island]; i < islands[island + 1]; ++ i)
+                paths.emplace_back(seeds[i].path);
+            // Propagate the wavefront while clipping it with the trimmed boundary.
+            expanded[island] = propagate_wave_from_boundary(co, paths, boundary[seeds[islands[island]].boundary],
+                params.initial_step, params.other_step, params.num_other_steps, params.max_inflation, params.batch_offsets);
+        }
+    });
+
+    // Collect the expanded polygons in the order of the seeds.
     std::vector<RegionExpansion> out;
-    ClipperLib::Paths            paths;
-    ClipperLib::ClipperOffset co;
-    co.ArcTolerance       = params.arc_tolerance;
-    co.ShortestEdgeLength = params.shortest_edge_length;
-    for (auto it_seed = seeds.begin(); it_seed != seeds.end();) {
-        auto it = it_seed;
-        paths.clear();
-        for (; it != seeds.end() && it->boundary == it_seed->boundary && it->src == it_seed->src; ++ it)
-            paths.emplace_back(it->path);
-        // Propagate the wavefront while clipping it with the trimmed boundary.
-        // Collect the expanded polygons, merge them with the source polygons.
-        RegionExpansion re;
-        for (Polygon &polygon : propagate_wave_from_boundary(co, paths, boundary[it_seed->boundary], params.initial_step, params.other_step, params.num_other_steps, params.max_inflation))
-            out.push_back({ std::move(polygon), it_seed->src, it_seed->boundary });
-        it_seed = it;
+    out.reserve(std::accumulate(expanded.begin(), expanded.end(), size_t(0), [](size_t acc, const Polygons &p) { return acc + p.size(); }));
+    for (size_t island = 0; island < expanded.size(); ++ island) {
+        const WaveSeed &seed = seeds[islands[island]];
+        for (Polygon &polygon : expanded[island])
+            out.push_back({ std::move(polygon), seed.src, seed.boundary });
     }
-
     return out;
 }
 
@@ -34,6 +34,9 @@ struct RegionExpansionParameters
     // Accuracy of the offsetter for wave propagation.
     double                 arc_tolerance;
     double                 shortest_edge_length;
+    // Offset all the polygons of a wave front by a single offsetter run instead of offsetting them one by one.
+    // The offsetter merges the overlapping inflated polygons, which is cheaper than leaving them to the clipping.
+    bool                   batch_offsets { true };
 
     static RegionExpansionParameters build(
         // Scaled expansion value
@@ -79,6 +82,7 @@ struct RegionExpansion
     uint32_t    boundary_id;
 };
 
+// The waves of each source x boundary island are propagated independently, the islands are processed in parallel.
 std::vector<RegionExpansion> propagate_waves(const WaveSeeds &seeds, const ExPolygons &boundary, const RegionExpansionParameters &params);
 std::vector<RegionExpansion> propagate_waves(const ExPolygons &src, const ExPolygons &boundary, const RegionExpansionParameters &params);
 
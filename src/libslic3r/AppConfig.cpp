@@ -69,6 +69,9 @@ void AppConfig::set_defaults()
         // Disable background processing by default as it is not stable.
         if (get("background_processing").empty())
             set("background_processing", "0");
+        // Calculation of the object steps ahead of "Slice now" is opt-in.
+        if (get("speculative_slicing").empty())
+            set("speculative_slicing", "0");
         // Enable support issues alerts by default
         if (get("alert_when_supports_needed").empty())
             set("alert_when_supports_needed", "1");
@@ -197,6 +200,9 @@ void AppConfig::set_defaults()
     if (get("show_splash_screen").empty())
         set("show_splash_screen", "1");
 
+    if (get("gcode_preview_cache").empty())
+        set("gcode_preview_cache", "0");
+
     if (get("restore_win_position").empty())
         set("restore_win_position", "1");       // allowed values - "1", "0", "crashed_at_..."
 
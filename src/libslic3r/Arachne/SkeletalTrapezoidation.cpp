@@ -343,6 +343,31 @@ SkeletalTrapezoidation::SkeletalTrapezoidation(const Polygons& polys, const Bead
     constructFromPolygons(polys);
 }
 
+// Storage of constructFromPolygons() kept alive between invocations on the same thread.
+struct ConstructionScratch
+{
+    std::vector<SkeletalTrapezoidation::Segment> segments;
+    VD                                           voronoi_diagram;
+
+    // Guards the thread local instance against reentrance, for example if a TBB task calling
+    // constructFromPolygons() got scheduled on this thread while another one is being processed.
+    class Lock
+    {
+    public:
+        Lock() : m_acquired(!in_use()) { if (m_acquired) in_use() = true; }
+        ~Lock() { if (m_acquired) in_use() = false; }
+        Lock(const Lock &) = delete;
+        Lock &operator=(const Lock &) = delete;
+
+        bool                 acquired() const { return m_acquired; }
+        ConstructionScratch &scratch() const { static thread_local ConstructionScratch instance; return instance; }
+
+    private:
+        static bool &in_use() { static thread_local bool flag = false; return flag; }
+        bool m_acquired;
+    };
+};
+
 void SkeletalTrapezoidation::constructFromPolygons(const Polygons& polys)
 {
 #ifdef ARACHNE_DEBUG
@@ -360,7 +385,21 @@ void SkeletalTrapezoidation::constructFromPolygons(const Polygons& polys)
     vd_edge_to_he_edge.clear();
     vd_node_to_he_node.clear();
 
-    std::vector<Segment> segments;
+    // Reuse the Voronoi diagram and the input segments of the previous invocation on this thread
+    // to not reallocate their storage for every island of every layer.
+    ConstructionScratch        local_scratch;
+    ConstructionScratch::Lock  scratch_lock;
+    ConstructionScratch       &scratch         = scratch_lock.acquired() ? scratch_lock.scratch() : local_scratch;
+    std::vector<Segment>      &segments        = scratch.segments;
+    VD                        &voronoi_diagram = scratch.voronoi_diagram;
+    segments.clear();
+    // The diagram has to be cleared, otherwise a diagram repaired during the previous invocation would be returned.
+    voronoi_diagram.clear();
+
+    size_t num_segments = 0;
+    for (const Polygon &poly : polys)
+        num_segments += poly.size();
+    segments.reserve(num_segments);
     for (size_t poly_idx = 0; poly_idx < polys.size(); poly_idx++)
         for (size_t point_idx = 0; point_idx < polys[poly_idx].size(); point_idx++)
             segments.emplace_back(&polys, poly_idx, point_idx);
@@ -374,8 +413,9 @@ void SkeletalTrapezoidation::constructFromPolygons(const Polygons& polys)
     }
 #endif
 
-    VD voronoi_diagram;
     voronoi_diagram.construct_voronoi(segments.cbegin(), segments.cend());
+    vd_edge_to_he_edge.reserve(voronoi_diagram.num_edges());
+    vd_node_to_he_node.reserve(voronoi_diagram.num_vertices());
 
 #ifdef ARACHNE_DEBUG_VORONOI
     {
@@ -493,21 +533,25 @@ void SkeletalTrapezoidation::separatePointyQuadEndNodes()
 // vvvvvvvvvvvvvvvvvvvvv
 //
 
-void SkeletalTrapezoidation::generateToolpaths(std::vector<VariableWidthLines> &generated_toolpaths, bool filter_outermost_central_edges)
+void SkeletalTrapezoidation::generateToolpaths(std::vector<VariableWidthLines> &generated_toolpaths, bool filter_outermost_central_edges,
+                                               const std::function<void()> &throw_on_cancel)
 {
 #ifdef ARACHNE_DEBUG
     static int iRun = 0;
 #endif
 
     p_generated_toolpaths = &generated_toolpaths;
+    throw_on_cancel();
 
     updateIsCentral();
+    throw_on_cancel();
 
 #ifdef ARACHNE_DEBUG
     export_graph_to_svg(debug_out_path("ST-updateIsCentral-final-%d.svg", iRun), this->graph, this->outline);
 #endif
 
     filterCentral(central_filter_dist);
+    throw_on_cancel();
 
 #ifdef ARACHNE_DEBUG
     export_graph_to_svg(debug_out_path("ST-filterCentral-final-%d.svg", iRun), this->graph, this->outline);
@@ -517,24 +561,28 @@ void SkeletalTrapezoidation::generateToolpaths(std::vector<VariableWidthLines> &
         filterOuterCentral();
 
     updateBeadCount();
+    throw_on_cancel();
 
 #ifdef ARACHNE_DEBUG
     export_graph_to_svg(debug_out_path("ST-updateBeadCount-final-%d.svg", iRun), this->graph, this->outline);
 #endif
 
     filterNoncentralRegions();
+    throw_on_cancel();
 
 #ifdef ARACHNE_DEBUG
     export_graph_to_svg(debug_out_path("ST-filterNoncentralRegions-final-%d.svg", iRun), this->graph, this->outline);
 #endif
 
     generateTransitioningRibs();
+    throw_on_cancel();
 
 #ifdef ARACHNE_DEBUG
     export_graph_to_svg(debug_out_path("ST-generateTransitioningRibs-final-%d.svg", iRun), this->graph, this->outline);
 #endif
 
     generateExtraRibs();
+    throw_on_cancel();
 
 #ifdef ARACHNE_DEBUG
     export_graph_to_svg(debug_out_path("ST-generateExtraRibs-final-%d.svg", iRun), this->graph, this->outline);
@@ -6,6 +6,7 @@
 
 #include <boost/polygon/voronoi.hpp>
 #include <ankerl/unordered_dense.h>
+#include <functional>
 #include <memory> // smart pointers
 #include <utility> // pair
 #include <list>
@@ -128,8 +129,10 @@ public:
      * touch the outside of the polygon. If enabled, don't treat these as
      * "central" but as if it's a obtuse corner. As a result, sharp corners will
      * no longer end in a single line but will just loop.
+     * \param throw_on_cancel Called between the stages of the generation, it may throw to abort the generation.
      */
-    void generateToolpaths(std::vector<VariableWidthLines> &generated_toolpaths, bool filter_outermost_central_edges = false);
+    void generateToolpaths(std::vector<VariableWidthLines> &generated_toolpaths, bool filter_outermost_central_edges = false,
+                           const std::function<void()> &throw_on_cancel = [](){});
 
 #ifdef ARACHNE_DEBUG
     Polygons outline;
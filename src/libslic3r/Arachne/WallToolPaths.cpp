@@ -32,7 +32,8 @@ namespace Slic3r::Arachne
 
 WallToolPaths::WallToolPaths(const Polygons& outline, const coord_t bead_width_0, const coord_t bead_width_x,
                              const size_t inset_count, const coord_t wall_0_inset, const coordf_t layer_height,
-                             const PrintObjectConfig &print_object_config, const PrintConfig &print_config)
+                             const PrintObjectConfig &print_object_config, const PrintConfig &print_config,
+                             std::function<void()> throw_on_cancel)
     : outline(outline)
     , bead_width_0(bead_width_0)
     , bead_width_x(bead_width_x)
@@ -47,6 +48,7 @@ WallToolPaths::WallToolPaths(const Polygons& outline, const coord_t bead_width_0
     , wall_transition_length(scaled<coord_t>(print_object_config.wall_transition_length.value))
     , toolpaths_generated(false)
     , print_object_config(print_object_config)
+    , throw_on_cancel(std::move(throw_on_cancel))
 {
     assert(!print_config.nozzle_diameter.empty());
     this->min_nozzle_diameter = float(*std::min_element(print_config.nozzle_diameter.values.begin(), print_config.nozzle_diameter.values.end()));
@@ -483,6 +485,7 @@ const std::vector<VariableWidthLines> &WallToolPaths::generate()
     // Clipper union also fixed an issue in Arachne that in post-processing Voronoi diagram, some edges
     // didn't have twin edges. (a non-planar Voronoi diagram probably caused this).
     prepared_outline = union_(prepared_outline);
+    throw_on_cancel();
 
     if (area(prepared_outline) <= 0) {
         assert(toolpaths.empty());
@@ -524,7 +527,9 @@ const std::vector<VariableWidthLines> &WallToolPaths::generate()
         allowed_filter_deviation,
         wall_transition_length
     );
-    wall_maker.generateToolpaths(toolpaths);
+    throw_on_cancel();
+    wall_maker.generateToolpaths(toolpaths, false, throw_on_cancel);
+    throw_on_cancel();
 
     stitchToolPaths(toolpaths, this->bead_width_x);
 
@@ -6,6 +6,7 @@
 
 #include <ankerl/unordered_dense.h>
 #include <stddef.h>
+#include <functional>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -40,8 +41,10 @@ public:
      * \param bead_width_x The bead width of the inner walls used in the generation of the toolpaths
      * \param inset_count The maximum number of parallel extrusion lines that make up the wall
      * \param wall_0_inset How far to inset the outer wall, to make it adhere better to other walls.
+     * \param throw_on_cancel Called between the stages of \p generate(), it may throw to abort the generation.
      */
-    WallToolPaths(const Polygons& outline, coord_t bead_width_0, coord_t bead_width_x, size_t inset_count, coord_t wall_0_inset, coordf_t layer_height, const PrintObjectConfig &print_object_config, const PrintConfig &print_config);
+    WallToolPaths(const Polygons& outline, coord_t bead_width_0, coord_t bead_width_x, size_t inset_count, coord_t wall_0_inset, coordf_t layer_height, const PrintObjectConfig &print_object_config, const PrintConfig &print_config,
+                  std::function<void()> throw_on_cancel = [](){});
 
     /*!
      * Generates the Toolpaths
@@ -124,6 +127,7 @@ private:
     std::vector<VariableWidthLines> toolpaths; //<! The generated toolpaths
     Polygons inner_contour;  //<! The inner contour of the generated toolpaths
     const PrintObjectConfig &print_object_config;
+    std::function<void()> throw_on_cancel; //<! Cancel point called between the stages of generate()
 };
 
 } // namespace Slic3r::Arachne
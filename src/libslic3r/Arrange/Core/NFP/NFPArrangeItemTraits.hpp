@@ -14,15 +14,19 @@
 
 namespace Slic3r { namespace arr2 {
 
+class NFPCache;
+
 // Additional methods that an ArrangeItem object has to implement in order
-// to be usable with PackStrategyNFP.
+// to be usable with PackStrategyNFP. The cache passed to calculate_nfp may be
+// null and an implementation is free to ignore it.
 template<class ArrItem, class En = void> struct NFPArrangeItemTraits_
 {
     template<class Context, class Bed, class StopCond = DefaultStopCondition>
     static ExPolygons calculate_nfp(const ArrItem &item,
                                     const Context &packing_context,
                                     const Bed &bed,
-                                    StopCond stop_condition = {})
+                                    StopCond stop_condition = {},
+                                    NFPCache *cache = nullptr)
     {
         static_assert(always_false<ArrItem>::value,
                       "NFP unimplemented for this item type.");
@@ -100,10 +104,12 @@ template<class ArrItem,
 ExPolygons calculate_nfp(const ArrItem &itm,
                          const Context &context,
                          const Bed &bed,
-                         StopCond stopcond = {})
+                         StopCond stopcond = {},
+                         NFPCache *cache = nullptr)
 {
     return NFPArrangeItemTraits<ArrItem>::calculate_nfp(itm, context, bed,
-                                                        std::move(stopcond));
+                                                        std::move(stopcond),
+                                                        cache);
 }
 
 template<class ArrItem> Vec2crd reference_vertex(const ArrItem &itm)
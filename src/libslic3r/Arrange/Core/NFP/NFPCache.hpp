@@ -0,0 +1,140 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef NFPCACHE_HPP
+#define NFPCACHE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+#include <boost/functional/hash.hpp>
+
+#include "libslic3r/Polygon.hpp"
+
+namespace Slic3r { namespace arr2 {
+
+// Cache of no-fit polygons of pairs of items. Arranging many copies of the same
+// object computes the NFPs of the very same pairs of shapes over and over
+// again, only their translations differ. A shape is identified by the hash of
+// its untransformed outline and by its rotation. The stored NFPs are
+// translated as if the fixed item was not translated, the caller has to move
+// them to the right place. The cache is thread safe.
+class NFPCache
+{
+public:
+    struct ShapeKey
+    {
+        uint64_t shape_hash = 0;
+        double   rotation   = 0.;
+
+        bool operator==(const ShapeKey &o) const
+        {
+            // Bitwise comparison of the rotation, the same rotation is always
+            // computed the same way for the copies of an object.
+            return shape_hash == o.shape_hash &&
+                   std::memcmp(&rotation, &o.rotation, sizeof(double)) == 0;
+        }
+    };
+
+    struct Key
+    {
+        ShapeKey fixed;
+        ShapeKey movable;
+
+        bool operator==(const Key &o) const
+        {
+            return fixed == o.fixed && movable == o.movable;
+        }
+    };
+
+    // Once the cache grows over this number of NFPs, it is flushed.
+    static constexpr size_t DefaultMaxEntries = 10000;
+
+    explicit NFPCache(size_t max_entries = DefaultMaxEntries)
+        : m_max_entries{max_entries}
+    {}
+
+    // Copies the cached NFP into out, returns false if not cached.
+    bool find(const Key &key, Polygons &out) const
+    {
+        std::lock_guard lk{m_mutex};
+        auto it = m_nfps.find(key);
+        if (it == m_nfps.end()) {
+            ++m_misses;
+            return false;
+        }
+
+        ++m_hits;
+        out = it->second;
+
+        return true;
+    }
+
+    void insert(const Key &key, Polygons nfp)
+    {
+        std::lock_guard lk{m_mutex};
+        if (m_nfps.size() >= m_max_entries)
+            m_nfps.clear();
+
+        m_nfps.emplace(key, std::move(nfp));
+    }
+
+    void clear()
+    {
+        std::lock_guard lk{m_mutex};
+        m_nfps.clear();
+        m_hits = 0;
+        m_misses = 0;
+    }
+
+    size_t size() const
+    {
+        std::lock_guard lk{m_mutex};
+        return m_nfps.size();
+    }
+
+    size_t hits() const
+    {
+        std::lock_guard lk{m_mutex};
+        return m_hits;
+    }
+
+    size_t misses() const
+    {
+        std::lock_guard lk{m_mutex};
+        return m_misses;
+    }
+
+private:
+    struct KeyHash
+    {
+        static void combine(size_t &seed, const ShapeKey &k)
+        {
+            boost::hash_combine(seed, k.shape_hash);
+            boost::hash_combine(seed, k.rotation);
+        }
+
+        size_t operator()(const Key &k) const
+        {
+            size_t seed = 0;
+            combine(seed, k.fixed);
+            combine(seed, k.movable);
+
+            return seed;
+        }
+    };
+
+    size_t m_max_entries;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<Key, Polygons, KeyHash> m_nfps;
+    mutable size_t m_hits = 0;
+    mutable size_t m_misses = 0;
+};
+
+}} // namespace Slic3r::arr2
+
+#endif // NFPCACHE_HPP
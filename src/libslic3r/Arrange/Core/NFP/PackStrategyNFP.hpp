@@ -11,10 +11,13 @@
 #include "Kernels/KernelTraits.hpp"
 
 #include "NFPArrangeItemTraits.hpp"
+#include "NFPCache.hpp"
 
 #include "libslic3r/Optimize/NLoptOptimizer.hpp"
 #include "libslic3r/Execution/ExecutionSeq.hpp"
 
+#include <memory>
+
 namespace Slic3r { namespace arr2 {
 
 struct NFPPackingTag{};
@@ -54,6 +57,10 @@ struct PackStrategyNFP {
     opt::Optimizer<OptMethod> solver;
     StopCond stop_condition;
 
+    // Shared by the copies of the strategy, so that all the beds and all the
+    // items of an arrangement reuse the NFPs of identical shapes.
+    std::shared_ptr<NFPCache> nfp_cache = std::make_shared<NFPCache>();
+
     PackStrategyNFP(opt::Optimizer<OptMethod> slv,
                     ArrangeKernel k = {},
                     ExecPolicy execpolicy = {},
@@ -253,7 +260,8 @@ bool pack(Strategy &strategy,
         set_translation(item, orig_tr);
 
         auto nfp = calculate_nfp(item, packing_context, bed,
-                                 strategy.stop_condition);
+                                 strategy.stop_condition,
+                                 strategy.nfp_cache.get());
         double score = NaNd;
         if (!nfp.empty()) {
             score = pick_best_spot_on_nfp(item, nfp, bed, strategy);
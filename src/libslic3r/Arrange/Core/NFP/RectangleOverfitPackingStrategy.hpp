@@ -128,6 +128,7 @@ bool pack(Strategy &strategy,
             base.solver,
             RectangleOverfitKernelWrapper{base.kernel, packing_context.limits},
             base.ep, base.accuracy};
+        modded_strategy.nfp_cache = base.nfp_cache;
 
         ret = pack(modded_strategy,
                    InfiniteBed{packing_context.limits.center()}, item,
@@ -116,6 +116,18 @@ Vec2crd DecomposedShape::centroid() const
     return m_centroid;
 }
 
+uint64_t DecomposedShape::hash_contours(const Polygons &contours)
+{
+    size_t seed = contours.size();
+    for (const Polygon &poly : contours) {
+        boost::hash_combine(seed, poly.size());
+        for (const Point &p : poly)
+            boost::hash_combine(seed, (uint64_t(uint32_t(p.x())) << 32) | uint32_t(p.y()));
+    }
+
+    return seed;
+}
+
 DecomposedShape decompose(const ExPolygons &shape)
 {
     return DecomposedShape{convex_decomposition_tess(shape)};
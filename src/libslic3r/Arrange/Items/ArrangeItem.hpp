@@ -19,6 +19,7 @@
 #include <vector>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 
 #include "libslic3r/ExPolygon.hpp"
 #include "libslic3r/BoundingBox.hpp"
@@ -26,6 +27,7 @@
 #include "libslic3r/Arrange/Core/PackingContext.hpp"
 #include "libslic3r/Arrange/Core/NFP/NFPArrangeItemTraits.hpp"
 #include "libslic3r/Arrange/Core/NFP/NFP.hpp"
+#include "libslic3r/Arrange/Core/NFP/NFPCache.hpp"
 #include "libslic3r/Arrange/Items/MutableItemTraits.hpp"
 #include "libslic3r/Arrange/Arrange.hpp"
 #include "libslic3r/Arrange/Tasks/ArrangeTask.hpp"
@@ -60,6 +62,7 @@ inline bool check_polygons_are_convex(const Polygons &pp) {
 class DecomposedShape
 {
     Polygons m_shape;
+    uint64_t m_hash = 0; // Hash of the untransformed shape, see NFPCache
 
     Vec2crd m_translation{0, 0}; // The translation of the poly
     double  m_rotation{0.0};     // The rotation of the poly in radians
@@ -85,6 +88,7 @@ public:
     explicit DecomposedShape(Polygon sh)
     {
         m_shape.emplace_back(std::move(sh));
+        m_hash = hash_contours(m_shape);
         assert(check_polygons_are_convex(m_shape));
     }
 
@@ -94,11 +98,16 @@ public:
 
     explicit DecomposedShape(Polygons sh) : m_shape{std::move(sh)}
     {
+        m_hash = hash_contours(m_shape);
         assert(check_polygons_are_convex(m_shape));
     }
 
     const Polygons &contours() const { return m_shape; }
 
+    // Identifies the untransformed shape, equal for the copies of an object.
+    uint64_t hash() const { return m_hash; }
+    static uint64_t hash_contours(const Polygons &contours);
+
     const Vec2crd &translation() const { return m_translation; }
     double         rotation() const { return m_rotation; }
 
@@ -294,53 +303,89 @@ template<> struct WritableDataStoreTraits_<ArrangeItem>
     }
 };
 
+// The NFPs of the pairs of items are looked up in the cache, if given.
 template<class FixedIt, class StopCond = DefaultStopCondition>
 static Polygons calculate_nfp_unnormalized(const ArrangeItem    &item,
                                            const Range<FixedIt> &fixed_items,
-                                           StopCond &&stop_cond = {})
+                                           StopCond &&stop_cond = {},
+                                           NFPCache *cache = nullptr)
 {
-    size_t cap = 0;
-
-    for (const ArrangeItem &fixitem : fixed_items) {
-        const Polygons &outlines = fixitem.shape().transformed_outline();
-        cap += outlines.size();
-    }
-
     const Polygons &item_outlines = item.envelope().transformed_outline();
 
-    auto nfps = reserve_polygons(cap * item_outlines.size());
+    Polygons nfps;
+    Polygons pair_nfps;
 
     Vec2crd ref_whole = item.envelope().reference_vertex();
     Polygon subnfp;
 
+    NFPCache::Key key;
+    key.movable = {item.envelope().hash(), item.envelope().rotation()};
+
+    // The union of the NFPs is done whenever their count doubles, which keeps
+    // the memory bounded without unifying the whole set over and over.
+    size_t union_threshold = 256;
+
     for (const ArrangeItem &fixed : fixed_items) {
-        // fixed_polys should already be a set of strictly convex polygons,
-        // as ArrangeItem stores convex-decomposed polygons
-        const Polygons & fixed_polys = fixed.shape().transformed_outline();
-
-        for (const Polygon &fixed_poly : fixed_polys) {
-            Point max_fixed = Slic3r::reference_vertex(fixed_poly);
-            for (size_t mi = 0; mi < item_outlines.size(); ++mi) {
-                const Polygon &movable = item_outlines[mi];
-                const Vec2crd &mref = item.envelope().reference_vertex(mi);
-                subnfp = nfp_convex_convex_legacy(fixed_poly, movable);
-
-                Vec2crd min_movable = item.envelope().min_vertex(mi);
-
-                Vec2crd dtouch = max_fixed - min_movable;
-                Vec2crd top_other = mref + dtouch;
-                Vec2crd max_nfp = Slic3r::reference_vertex(subnfp);
-                auto dnfp = top_other - max_nfp;
-
-                auto d = ref_whole - mref + dnfp;
-                subnfp.translate(d);
-                nfps.emplace_back(subnfp);
+        // The NFP of a pair of items does not depend on the translation of
+        // the movable item and it moves together with the fixed item.
+        const Vec2crd &fixed_tr = fixed.shape().translation();
+        key.fixed = {fixed.shape().hash(), fixed.shape().rotation()};
+
+        if (cache && cache->find(key, pair_nfps)) {
+            for (Polygon &p : pair_nfps)
+                p.translate(fixed_tr);
+        } else {
+            // fixed_polys should already be a set of strictly convex polygons,
+            // as ArrangeItem stores convex-decomposed polygons
+            const Polygons & fixed_polys = fixed.shape().transformed_outline();
+
+            pair_nfps.clear();
+            pair_nfps.reserve(fixed_polys.size() * item_outlines.size());
+
+            for (const Polygon &fixed_poly : fixed_polys) {
+                Point max_fixed = Slic3r::reference_vertex(fixed_poly);
+                for (size_t mi = 0; mi < item_outlines.size(); ++mi) {
+                    const Polygon &movable = item_outlines[mi];
+                    const Vec2crd &mref = item.envelope().reference_vertex(mi);
+                    subnfp = nfp_convex_convex_legacy(fixed_poly, movable);
+
+                    Vec2crd min_movable = item.envelope().min_vertex(mi);
+
+                    Vec2crd dtouch = max_fixed - min_movable;
+                    Vec2crd top_other = mref + dtouch;
+                    Vec2crd max_nfp = Slic3r::reference_vertex(subnfp);
+                    auto dnfp = top_other - max_nfp;
+
+                    auto d = ref_whole - mref + dnfp;
+                    subnfp.translate(d);
+                    pair_nfps.emplace_back(subnfp);
+                }
+
+                if (stop_cond())
+                    break;
             }
 
-            if (stop_cond())
+            if (stop_cond()) {
+                nfps.clear();
                 break;
+            }
 
+            pair_nfps = union_(pair_nfps);
+
+            if (cache) {
+                Polygons normalized = pair_nfps;
+                for (Polygon &p : normalized)
+                    p.translate(-fixed_tr);
+
+                cache->insert(key, std::move(normalized));
+            }
+        }
+
+        append(nfps, std::move(pair_nfps));
+
+        if (nfps.size() >= union_threshold) {
             nfps = union_(nfps);
+            union_threshold = std::max(union_threshold, 2 * nfps.size());
         }
 
         if (stop_cond()) {
@@ -349,6 +394,9 @@ static Polygons calculate_nfp_unnormalized(const ArrangeItem    &item,
         }
     }
 
+    if (!nfps.empty())
+        nfps = union_(nfps);
+
     return nfps;
 }
 
@@ -357,10 +405,11 @@ template<> struct NFPArrangeItemTraits_<ArrangeItem> {
     static ExPolygons calculate_nfp(const ArrangeItem &item,
                                     const Context &packing_context,
                                     const Bed &bed,
-                                    StopCond &&stopcond)
+                                    StopCond &&stopcond,
+                                    NFPCache *cache = nullptr)
     {
         auto static_items = all_items_range(packing_context);
-        Polygons nfps = arr2::calculate_nfp_unnormalized(item, static_items, stopcond);
+        Polygons nfps = arr2::calculate_nfp_unnormalized(item, static_items, stopcond, cache);
 
         ExPolygons nfp_ex;
 
@@ -79,7 +79,8 @@ template<> struct NFPArrangeItemTraits_<SimpleArrangeItem>
     static ExPolygons calculate_nfp(const SimpleArrangeItem &item,
                                     const Context &packing_context,
                                     const Bed &bed,
-                                    StopCond &&stop_cond)
+                                    StopCond &&stop_cond,
+                                    NFPCache * /*cache*/ = nullptr)
     {
         auto fixed_items = all_items_range(packing_context);
         auto nfps = reserve_polygons(fixed_items.size());
@@ -0,0 +1,330 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef FILLBEDLATTICE_HPP
+#define FILLBEDLATTICE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "libslic3r/Arrange/Core/NFP/NFPArrangeItemTraits.hpp"
+#include "libslic3r/Arrange/Core/PackingContext.hpp"
+#include "libslic3r/Arrange/Core/Beds.hpp"
+
+#include "libslic3r/ExPolygon.hpp"
+#include "libslic3r/BoundingBox.hpp"
+
+namespace Slic3r { namespace arr2 {
+
+// Conservative raster of the area occupied by polygons. A cell is marked if
+// it is touched by any of the polygons and a polygon is reported to be free,
+// if none of the cells touched by it is marked. Concave polygons are treated
+// as if the concavities between the leftmost and rightmost points of a cell
+// row were filled.
+class OccupancyGrid
+{
+    BoundingBox          m_bb;
+    coord_t              m_cell_size;
+    size_t               m_cols = 0, m_rows = 0;
+    std::vector<uint8_t> m_cells;
+
+    // Calls fn(row, first_col, last_col) for the cells of the grid touched by
+    // poly, returns false if the polygon reaches out of the grid.
+    template<class Fn> bool foreach_row(const Polygon &poly, Fn &&fn) const
+    {
+        if (poly.empty())
+            return true;
+
+        BoundingBox bb = get_extents(poly);
+        bool inside = m_bb.contains(bb.min) && m_bb.contains(bb.max);
+
+        auto cell = [this](double v, coord_t origin, size_t count) {
+            return size_t(std::clamp<int64_t>(int64_t(std::floor((v - origin) / m_cell_size)), 0, int64_t(count) - 1));
+        };
+
+        if (bb.max.y() < m_bb.min.y() || bb.min.y() > m_bb.max.y())
+            return inside;
+
+        size_t row_min = cell(bb.min.y(), m_bb.min.y(), m_rows);
+        size_t row_max = cell(bb.max.y(), m_bb.min.y(), m_rows);
+
+        for (size_t row = row_min; row <= row_max; ++row) {
+            double y0 = m_bb.min.y() + double(row) * m_cell_size;
+            double y1 = y0 + m_cell_size;
+
+            // Extent of the polygon clipped by the slab of the row
+            double xmin = std::numeric_limits<double>::max();
+            double xmax = std::numeric_limits<double>::lowest();
+            for (size_t i = 0; i < poly.size(); ++i) {
+                Vec2d p = poly[i].cast<double>();
+                Vec2d q = poly[(i + 1) % poly.size()].cast<double>();
+                if (p.y() > q.y())
+                    std::swap(p, q);
+
+                double lo = std::max(p.y(), y0), hi = std::min(q.y(), y1);
+                if (lo > hi)
+                    continue;
+
+                auto x_at = [&p, &q](double y) {
+                    return q.y() == p.y() ? p.x() : p.x() + (y - p.y()) * (q.x() - p.x()) / (q.y() - p.y());
+                };
+
+                double xa = q.y() == p.y() ? std::min(p.x(), q.x()) : x_at(lo);
+                double xb = q.y() == p.y() ? std::max(p.x(), q.x()) : x_at(hi);
+                xmin = std::min({xmin, xa, xb});
+                xmax = std::max({xmax, xa, xb});
+            }
+
+            if (xmin > xmax || xmax < m_bb.min.x() || xmin > m_bb.max.x())
+                continue;
+
+            if (!fn(row, cell(xmin, m_bb.min.x(), m_cols), cell(xmax, m_bb.min.x(), m_cols)))
+                break;
+        }
+
+        return inside;
+    }
+
+public:
+    OccupancyGrid(const BoundingBox &bb, coord_t cell_size)
+        : m_bb{bb}, m_cell_size{std::max(coord_t(1), cell_size)}
+    {
+        m_cols = size_t(m_bb.size().x() / m_cell_size) + 1;
+        m_rows = size_t(m_bb.size().y() / m_cell_size) + 1;
+        m_cells.assign(m_cols * m_rows, 0);
+    }
+
+    const BoundingBox &bounding_box() const { return m_bb; }
+    coord_t cell_size() const { return m_cell_size; }
+
+    // Marks the cells touched by the polygon, the parts out of the grid
+    // are ignored.
+    void mark(const Polygon &poly)
+    {
+        foreach_row(poly, [this](size_t row, size_t c0, size_t c1) {
+            std::fill(m_cells.begin() + row * m_cols + c0,
+                      m_cells.begin() + row * m_cols + c1 + 1, 1);
+            return true;
+        });
+    }
+
+    bool is_free(const Polygon &poly) const
+    {
+        bool ret = true;
+        bool inside = foreach_row(poly, [this, &ret](size_t row, size_t c0, size_t c1) {
+            auto from = m_cells.begin() + row * m_cols;
+            ret = std::none_of(from + c0, from + c1 + 1, [](uint8_t c) { return c != 0; });
+            return ret;
+        });
+
+        return inside && ret;
+    }
+};
+
+// Two vectors generating a lattice of non-overlapping copies of an item.
+// The first one is always horizontal.
+struct ItemLattice
+{
+    Vec2crd a, b;
+};
+
+namespace detail_lattice {
+
+inline bool is_strictly_inside(const ExPolygons &region, const Point &p)
+{
+    return std::any_of(region.begin(), region.end(),
+                       [&p](const ExPolygon &ep) { return ep.contains(p, false); });
+}
+
+// Collects the coordinates along the axis 'dim' where the line of the other
+// axis at 'at' crosses the boundary of the region.
+inline void line_crossings(const ExPolygons &region, int dim, double at, std::vector<coord_t> &out)
+{
+    int other = 1 - dim;
+    auto process = [&](const Polygon &poly) {
+        for (size_t i = 0; i < poly.size(); ++i) {
+            const Point &p = poly[i];
+            const Point &q = poly[(i + 1) % poly.size()];
+            double lo = std::min(p[other], q[other]), hi = std::max(p[other], q[other]);
+            if (at < lo || at > hi)
+                continue;
+
+            if (p[other] == q[other]) {
+                out.emplace_back(p[dim]);
+                out.emplace_back(q[dim]);
+            } else {
+                double t = (at - p[other]) / double(q[other] - p[other]);
+                double c = p[dim] + t * (q[dim] - p[dim]);
+                out.emplace_back(coord_t(std::floor(c)));
+                out.emplace_back(coord_t(std::ceil(c)));
+            }
+        }
+    };
+
+    for (const ExPolygon &ep : region) {
+        process(ep.contour);
+        for (const Polygon &h : ep.holes)
+            process(h);
+    }
+}
+
+} // namespace detail_lattice
+
+// Finds the densest lattice of the copies of an item with a horizontal first
+// vector. The copies are allowed to touch but not to overlap, which is decided
+// by the no-fit polygon of the item with itself.
+template<class ArrItem> std::optional<ItemLattice> find_item_lattice(const ArrItem &itm)
+{
+    using namespace detail_lattice;
+
+    std::vector<ArrItem> fixed{itm};
+    ExPolygons nfp = calculate_nfp(itm, default_context(fixed), InfiniteBed{});
+
+    if (nfp.empty())
+        return {};
+
+    // The copy is at the same place as the fixed item if its reference vertex
+    // is at r0, moving the copy by v is valid if r0 + v is not inside the nfp.
+    // The same applies to -v for the copy being the fixed one.
+    Vec2crd r0 = reference_vertex(itm);
+    BoundingBox nfpbb = get_extents(nfp);
+    Vec2crd ext = (nfpbb.max - r0).cwiseMax(r0 - nfpbb.min) + Vec2crd::Ones();
+
+    auto is_valid = [&nfp, &r0](const Vec2crd &v) {
+        return !is_strictly_inside(nfp, r0 + v) && !is_strictly_inside(nfp, r0 - v);
+    };
+
+    auto is_valid_row = [&ext, &is_valid](const Vec2crd &a, const Vec2crd &offs) {
+        auto i0 = coord_t(std::floor(double(-ext.x() - offs.x()) / a.x()));
+        auto i1 = coord_t(std::ceil(double(ext.x() - offs.x()) / a.x()));
+        for (coord_t i = i0; i <= i1; ++i) {
+            Vec2crd v = offs + i * a;
+            if (v != Vec2crd::Zero() && !is_valid(v))
+                return false;
+        }
+        return true;
+    };
+
+    std::vector<coord_t> crossings;
+    auto candidates = [&crossings](coord_t from, coord_t ext) {
+        std::vector<coord_t> ret;
+        for (coord_t c : crossings)
+            if (c - from > 0)
+                ret.emplace_back(c - from);
+
+        ret.emplace_back(ext);
+        std::sort(ret.begin(), ret.end());
+        ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+
+        return ret;
+    };
+
+    // The shortest horizontal vector, for which the row of copies is valid
+    ItemLattice ret;
+    line_crossings(nfp, 0, r0.y(), crossings);
+    for (coord_t dx : candidates(r0.x(), ext.x())) {
+        ret.a = Vec2crd{dx, 0};
+        if (is_valid_row(ret.a, Vec2crd::Zero()))
+            break;
+    }
+
+    // For a set of horizontal shifts of the next row, the lowest valid row
+    // height. The rows reaching over the extents of the nfp are always valid.
+    constexpr int Samples = 32;
+    ret.b = Vec2crd{0, ext.y()};
+    for (int s = 0; s < Samples; ++s) {
+        coord_t sx = coord_t(int64_t(ret.a.x()) * s / Samples);
+
+        crossings.clear();
+        for (coord_t k = -ext.x() / ret.a.x() - 1; k <= ext.x() / ret.a.x() + 1; ++k)
+            line_crossings(nfp, 1, r0.x() + sx + k * ret.a.x(), crossings);
+
+        for (coord_t dy : candidates(r0.y(), ret.b.y())) {
+            if (dy >= ret.b.y())
+                break;
+
+            Vec2crd b{sx, dy};
+            bool valid = true;
+            for (coord_t j = 1; valid && j * dy < ext.y(); ++j)
+                valid = is_valid_row(ret.a, j * b);
+
+            if (valid) {
+                ret.b = b;
+                break;
+            }
+        }
+    }
+
+    return ret;
+}
+
+// Returns the translations of the copies of an item to fill the rectangular
+// bed with, relative to the current translation of the item. The copies
+// of the lattice are centered on the bed, those colliding with the obstacles
+// in the occupancy grid are left out.
+template<class ArrItem>
+std::vector<Vec2crd> lattice_positions(const ArrItem           &itm,
+                                       const ItemLattice       &lattice,
+                                       const RectangleBed      &bed,
+                                       const OccupancyGrid     &grid)
+{
+    std::vector<Vec2crd> ret;
+
+    BoundingBox itmbb = fixed_bounding_box(itm);
+    itmbb.merge(envelope_bounding_box(itm));
+
+    const BoundingBox &bedbb = bed.bb;
+    Vec2crd isz = itmbb.size(), bsz = bedbb.size();
+    if (isz.x() > bsz.x() || isz.y() > bsz.y())
+        return ret;
+
+    // Translations, which put the minimum corner of the item into the
+    // minimum corner of the bed, up to the extents of the lattice.
+    Vec2crd v0 = bedbb.min - itmbb.min;
+    Vec2crd vmax = bedbb.max - itmbb.max;
+    const Vec2crd &a = lattice.a, &b = lattice.b;
+
+    BoundingBox pile;
+    for (coord_t j = 0; v0.y() + j * b.y() <= vmax.y(); ++j) {
+        Vec2crd offs = v0 + j * b;
+        coord_t i0 = coord_t(std::ceil(double(v0.x() - offs.x()) / a.x()));
+        for (coord_t i = i0; offs.x() + i * a.x() <= vmax.x(); ++i) {
+            Vec2crd v = offs + i * a;
+            ret.emplace_back(v);
+            pile.merge(v);
+        }
+    }
+
+    if (ret.empty())
+        return ret;
+
+    Vec2crd center = (vmax - v0 - pile.size()) / 2 - (pile.min - v0);
+
+    auto outlines = reserve_polygons(fixed_outline(itm).size() + envelope_outline(itm).size());
+    for (const Polygon &p : fixed_outline(itm))
+        outlines.emplace_back(p);
+    for (const Polygon &p : envelope_outline(itm))
+        outlines.emplace_back(p);
+
+    Polygon moved;
+    auto it = std::remove_if(ret.begin(), ret.end(), [&](Vec2crd &v) {
+        v += center;
+        return std::any_of(outlines.begin(), outlines.end(), [&](const Polygon &p) {
+            moved = p;
+            moved.translate(v);
+            return !grid.is_free(moved);
+        });
+    });
+    ret.erase(it, ret.end());
+
+    return ret;
+}
+
+}} // namespace Slic3r::arr2
+
+#endif // FILLBEDLATTICE_HPP
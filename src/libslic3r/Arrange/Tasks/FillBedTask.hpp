@@ -28,6 +28,12 @@ struct FillBedTask: public ArrangeTaskBase
     ExtendedBed bed;
     size_t selected_existing_count = 0;
 
+    // If at least this many copies are to be added, a rectangular bed is
+    // filled by tiling the copies, which is much faster than packing them
+    // one by one. Only the free border region, where the tiling does not
+    // fit, is filled by the packing.
+    size_t lattice_fill_min_count = 100;
+
     std::unique_ptr<FillBedTaskResult> process_native(Ctl &ctl);
     std::unique_ptr<FillBedTaskResult> process_native(Ctl &&ctl)
     {
@@ -7,6 +7,8 @@
 
 #include "FillBedTask.hpp"
 
+#include "FillBedLattice.hpp"
+
 #include "libslic3r/Arrange/Core/NFP/NFPArrangeItemTraits.hpp"
 
 #include <boost/log/trivial.hpp>
@@ -122,6 +124,86 @@ void extract(FillBedTask<ArrItem> &task,
 }
 
 
+// Returns true if the outline of b is the outline of a translated by d.
+template<class ArrItem>
+bool is_translated_copy(const ArrItem &a, const ArrItem &b, Vec2crd &d)
+{
+    d = reference_vertex(b) - reference_vertex(a);
+
+    auto is_translated = [&d](const Polygons &pa, const Polygons &pb) {
+        if (pa.size() != pb.size())
+            return false;
+
+        for (size_t i = 0; i < pa.size(); ++i)
+            if (pa[i].size() != pb[i].size() ||
+                !std::equal(pa[i].begin(), pa[i].end(), pb[i].begin(),
+                            [&d](const Point &p, const Point &q) { return q - p == d; }))
+                return false;
+
+        return true;
+    };
+
+    return is_translated(fixed_outline(a), fixed_outline(b)) &&
+           is_translated(envelope_outline(a), envelope_outline(b));
+}
+
+// Moves the selected items into a lattice of the copies of the prototype
+// item. Returns the number of items placed, the first ones of the selected
+// items. Zero is returned if the lattice is not applicable, e.g. the bed is
+// not rectangular or the existing copies differ from the prototype.
+template<class ArrItem>
+size_t fill_bed_with_lattice(FillBedTask<ArrItem> &task)
+{
+    const ArrItem &prototype = *task.prototype_item;
+
+    std::optional<RectangleBed> rectbed;
+    visit_bed([&rectbed](const auto &rawbed) {
+        if constexpr (std::is_same_v<StripCVRef<decltype(rawbed)>, RectangleBed>)
+            rectbed = rawbed;
+    }, task.bed);
+
+    if (!rectbed)
+        return 0;
+
+    auto offsets = reserve_vector<Vec2crd>(task.selected.size());
+    for (const ArrItem &itm : task.selected)
+        if (!is_translated_copy(prototype, itm, offsets.emplace_back()))
+            return 0;
+
+    std::optional<ItemLattice> lattice = find_item_lattice(prototype);
+    if (!lattice)
+        return 0;
+
+    // The grid is precise enough to capture the gaps between the objects
+    // already on the bed, the remaining space is filled by the packing.
+    const BoundingBox &bedbb = rectbed->bb;
+    coord_t cell_size = std::max(scaled(.25), bedbb.size().maxCoeff() / 1024);
+    OccupancyGrid grid{bedbb, cell_size};
+    for (const ArrItem &itm : task.unselected)
+        if (get_bed_index(itm) == PhysicalBedId)
+            for (const Polygon &p : fixed_outline(itm))
+                grid.mark(p);
+
+    std::vector<Vec2crd> positions = lattice_positions(prototype, *lattice,
+                                                       *rectbed, grid);
+
+    // All the existing copies should fit into the lattice
+    if (positions.size() < task.selected_existing_count)
+        return 0;
+
+    size_t count = std::min(positions.size(), task.selected.size());
+    for (size_t i = 0; i < count; ++i) {
+        ArrItem &itm = task.selected[i];
+        set_translation(itm, get_translation(itm) + positions[i] - offsets[i]);
+        set_bed_index(itm, PhysicalBedId);
+    }
+
+    for (size_t i = count; i < task.selected.size(); ++i)
+        set_bed_index(task.selected[i], Unarranged);
+
+    return count;
+}
+
 template<class ArrItem>
 std::unique_ptr<FillBedTask<ArrItem>> FillBedTask<ArrItem>::create(
     const Scene &sc, const ArrangeableToItemConverter<ArrItem> &converter)
@@ -177,14 +259,37 @@ std::unique_ptr<FillBedTaskResult> FillBedTask<ArrItem>::process_native(
 
     auto arranger = Arranger<ArrItem>::create(settings);
 
-    arranger->arrange(selected, unselected, bed, subctl);
+    size_t lattice_count = 0;
+    if (selected.size() - selected_existing_count >= lattice_fill_min_count)
+        lattice_count = fill_bed_with_lattice(*this);
 
-    auto unsel_cpy = unselected;
-    for (const auto &itm : selected) {
-        unsel_cpy.emplace_back(itm);
-    }
+    if (lattice_count > 0) {
+        // Pack the copies, which did not fit into the lattice, into the
+        // gaps along the border and around the other objects.
+        std::vector<ArrItem> rest{selected.begin() + lattice_count, selected.end()};
 
-    arranger->arrange(selected_fillers, unsel_cpy, bed, FillBedCtl{ctl, *this});
+        std::vector<ArrItem> fixed = unselected;
+        fixed.reserve(unselected.size() + lattice_count);
+        std::copy(selected.begin(), selected.begin() + lattice_count,
+                  std::back_inserter(fixed));
+
+        if (!rest.empty() && !ctl.was_canceled())
+            arranger->arrange(rest, fixed, bed, subctl);
+
+        std::move(rest.begin(), rest.end(), selected.begin() + lattice_count);
+
+        // The lattice leaves no holes to be filled
+        selected_fillers.clear();
+    } else {
+        arranger->arrange(selected, unselected, bed, subctl);
+
+        auto unsel_cpy = unselected;
+        for (const auto &itm : selected) {
+            unsel_cpy.emplace_back(itm);
+        }
+
+        arranger->arrange(selected_fillers, unsel_cpy, bed, FillBedCtl{ctl, *this});
+    }
 
     auto arranged_range = Range{selected.begin(),
                                 selected.begin() + selected_existing_count};
@@ -6,7 +6,9 @@
 
 #include <optional>
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <numeric>
 
 #include "PointCloud.hpp"
 #include "libslic3r/TriangleMesh.hpp"
@@ -185,6 +187,92 @@ void build_tree(const indexed_triangle_set &its,
     build_tree(nodes, builder);
 }
 
+std::vector<LeafCluster> cluster_leafs(const std::vector<Node> &leafs,
+                                       const Properties        &properties)
+{
+    std::vector<LeafCluster> ret;
+    if (leafs.empty())
+        return ret;
+
+    const double reach = 2. * properties.max_branch_length();
+    if (reach <= 0.) {
+        ret.emplace_back();
+        ret.front().leafs.resize(leafs.size());
+        std::iota(ret.front().leafs.begin(), ret.front().leafs.end(), size_t(0));
+        for (const Node &n : leafs)
+            ret.front().region.merge(to_2d(n.pos).cast<double>());
+        return ret;
+    }
+
+    // Union the leafs closer than twice the reach in both X and Y. Such leafs
+    // may end up in neighboring cells of a grid with the cell size of twice
+    // the reach.
+    std::vector<size_t> parent(leafs.size());
+    std::iota(parent.begin(), parent.end(), size_t(0));
+    auto find_root = [&parent](size_t i) {
+        while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
+
+    using Cell = std::pair<long, long>;
+    auto cell_of = [reach](const Node &n) {
+        return Cell{long(std::floor(n.pos.x() / (2. * reach))),
+                    long(std::floor(n.pos.y() / (2. * reach)))};
+    };
+
+    auto cells = reserve_vector<std::pair<Cell, size_t>>(leafs.size());
+    for (size_t i = 0; i < leafs.size(); ++i)
+        cells.emplace_back(cell_of(leafs[i]), i);
+    std::sort(cells.begin(), cells.end());
+
+    for (const auto &[cell, i] : cells)
+        for (long dx = -1; dx <= 1; ++dx)
+            for (long dy = -1; dy <= 1; ++dy) {
+                Cell nb{cell.first + dx, cell.second + dy};
+                auto it = std::lower_bound(cells.begin(), cells.end(), std::make_pair(nb, size_t(0)));
+                for (; it != cells.end() && it->first == nb; ++it) {
+                    Vec3f d = leafs[it->second].pos - leafs[i].pos;
+                    if (std::abs(d.x()) < 2. * reach && std::abs(d.y()) < 2. * reach)
+                        parent[find_root(it->second)] = find_root(i);
+                }
+            }
+
+    std::vector<size_t> cluster_idx(leafs.size(), size_t(-1));
+    for (size_t i = 0; i < leafs.size(); ++i) {
+        size_t root = find_root(i);
+        if (cluster_idx[root] == size_t(-1)) {
+            cluster_idx[root] = ret.size();
+            ret.emplace_back();
+        }
+
+        LeafCluster &cluster = ret[cluster_idx[root]];
+        Vec2d        p       = to_2d(leafs[i].pos).cast<double>();
+        cluster.leafs.emplace_back(i);
+        cluster.region.merge(BoundingBoxf{p - Vec2d{reach, reach}, p + Vec2d{reach, reach}});
+    }
+
+    // The bounding boxes of clusters may overlap even if their leafs are far
+    // from each other, merge such clusters.
+    for (bool merged = true; merged;) {
+        merged = false;
+        for (size_t i = 0; i < ret.size(); ++i)
+            for (size_t j = i + 1; j < ret.size();)
+                if (ret[i].region.overlap(ret[j].region)) {
+                    ret[i].region.merge(ret[j].region);
+                    ret[i].leafs.insert(ret[i].leafs.end(), ret[j].leafs.begin(), ret[j].leafs.end());
+                    ret.erase(ret.begin() + j);
+                    merged = true;
+                } else
+                    ++j;
+    }
+
+    for (LeafCluster &cluster : ret)
+        std::sort(cluster.leafs.begin(), cluster.leafs.end());
+
+    return ret;
+}
+
 ExPolygon make_bed_poly(const indexed_triangle_set &its)
 {
     auto bb = bounding_box(its);
@@ -11,6 +11,7 @@
 #include <utility>
 #include <vector>
 
+#include "libslic3r/BoundingBox.hpp"
 #include "libslic3r/ExPolygon.hpp"
 #include "libslic3r/Point.hpp"
 #include "libslic3r/libslic3r.h"
@@ -157,6 +158,23 @@ inline void build_tree(const indexed_triangle_set &its,
     build_tree(its, support_leafs, builder, properties);
 }
 
+// A group of support leafs which can be routed independently of the other
+// groups. The nearest neighbor search of build_tree() reaches twice the max
+// branch length in XY from a node and the nodes of a tree stay inside the XY
+// bounding box of its leafs, therefore the region of a group is the bounding
+// box of its leafs expanded by the reach. The regions of two groups never
+// overlap, a group only needs the mesh and bed points inside its region.
+struct LeafCluster
+{
+    // Indices of the leafs in ascending order.
+    std::vector<size_t> leafs;
+    BoundingBoxf        region;
+};
+
+// Split the support leafs into clusters, which can be routed in parallel.
+std::vector<LeafCluster> cluster_leafs(const std::vector<Node> &leafs,
+                                       const Properties        &properties);
+
 // Helper function to derive a bed polygon only from the model bounding box.
 ExPolygon make_bed_poly(const indexed_triangle_set &its);
 
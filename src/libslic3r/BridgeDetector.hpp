@@ -6,6 +6,8 @@
 #ifndef slic3r_BridgeDetector_hpp_
 #define slic3r_BridgeDetector_hpp_
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <cmath>
 #include <string>
 #include <unordered_map>
@@ -110,13 +112,19 @@ inline std::tuple<Vec2d, double> detect_bridging_direction(const Lines &floating
         direction_costs.emplace_back(d.second, 0.0);
     }
 
-    for (const Line &l : floating_edges) {
-        Vec2d line = (l.b - l.a).cast<double>();
-        for (auto &dir_cost : direction_costs) {
-            // the dot product already contains the length of the line. dir_cost.first is normalized.
-            dir_cost.second += std::abs(line.dot(dir_cost.first));
-        }
-    }
+    // The number of directions grows with the number of floating edges, sum the costs of the directions in parallel.
+    // The edges are summed in the same order for each direction, thus the result does not depend on the scheduling.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, direction_costs.size(), std::max<size_t>(1, 4096 / floating_edges.size())),
+        [&floating_edges, &direction_costs](const tbb::blocked_range<size_t> &range) {
+            for (size_t dir_idx = range.begin(); dir_idx < range.end(); ++ dir_idx) {
+                auto &dir_cost = direction_costs[dir_idx];
+                for (const Line &l : floating_edges) {
+                    Vec2d line = (l.b - l.a).cast<double>();
+                    // the dot product already contains the length of the line. dir_cost.first is normalized.
+                    dir_cost.second += std::abs(line.dot(dir_cost.first));
+                }
+            }
+        });
 
     Vec2d  result_dir = Vec2d::Ones();
     double min_cost   = std::numeric_limits<double>::max();
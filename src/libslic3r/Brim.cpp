@@ -81,10 +81,10 @@ static ExPolygons get_print_object_bottom_layer_expolygons(const PrintObject &pr
 // Returns ExPolygons of bottom layer for every print object in Print after elephant foot compensation.
 static std::vector<ExPolygons> get_print_bottom_layers_expolygons(const Print &print)
 {
-    std::vector<ExPolygons> bottom_layers_expolygons;
-    bottom_layers_expolygons.reserve(print.objects().size());
-    for (const PrintObject *object : print.objects())
-        bottom_layers_expolygons.emplace_back(get_print_object_bottom_layer_expolygons(*object));
+    std::vector<ExPolygons> bottom_layers_expolygons(print.objects().size());
+    clipper_batch(print.objects().size(), [&print, &bottom_layers_expolygons](size_t print_object_idx) {
+        bottom_layers_expolygons[print_object_idx] = get_print_object_bottom_layer_expolygons(*print.objects()[print_object_idx]);
+    });
 
     return bottom_layers_expolygons;
 }
@@ -150,27 +150,39 @@ static ConstPrintObjectPtrs get_top_level_objects_with_brim(const Print &print,
     return top_level_objects_with_brim;
 }
 
-static Polygons top_level_outer_brim_islands(const ConstPrintObjectPtrs &top_level_objects_with_brim, const double scaled_resolution)
+static Polygons top_level_outer_brim_islands(const Print                   &print,
+                                             const ConstPrintObjectPtrs    &top_level_objects_with_brim,
+                                             const std::vector<ExPolygons> &bottom_layers_expolygons,
+                                             const double                   scaled_resolution)
 {
-    Polygons islands;
-    for (const PrintObject *object : top_level_objects_with_brim) {
+    assert(print.objects().size() == bottom_layers_expolygons.size());
+    // The objects are independent, process them in parallel. The results are merged in the order of the objects.
+    std::vector<Polygons> islands_objects(top_level_objects_with_brim.size());
+    clipper_batch(top_level_objects_with_brim.size(), [&](size_t top_level_idx) {
+        const PrintObject *object = top_level_objects_with_brim[top_level_idx];
         if (!object->has_brim())
-            continue;
+            return;
+
+        // Reuse the bottom layer of the object calculated by get_print_bottom_layers_expolygons().
+        const size_t print_object_idx = std::find(print.objects().begin(), print.objects().end(), object) - print.objects().begin();
+        assert(print_object_idx < print.objects().size());
 
         //FIXME how about the brim type?
-        auto     brim_separation = float(scale_(object->config().brim_separation.value));
-        Polygons islands_object;
-        for (const ExPolygon &ex_poly : get_print_object_bottom_layer_expolygons(*object)) {
+        auto      brim_separation = float(scale_(object->config().brim_separation.value));
+        Polygons &islands_object  = islands_objects[top_level_idx];
+        for (const ExPolygon &ex_poly : bottom_layers_expolygons[print_object_idx]) {
             Polygons contour_offset = offset(ex_poly.contour, brim_separation, ClipperLib::jtSquare);
             for (Polygon &poly : contour_offset)
                 poly.douglas_peucker(scaled_resolution);
 
             polygons_append(islands_object, std::move(contour_offset));
         }
+    });
 
-        for (const PrintInstance &instance : object->instances())
-            append_and_translate(islands, islands_object, instance);
-    }
+    Polygons islands;
+    for (size_t top_level_idx = 0; top_level_idx < top_level_objects_with_brim.size(); ++ top_level_idx)
+        for (const PrintInstance &instance : top_level_objects_with_brim[top_level_idx]->instances())
+            append_and_translate(islands, islands_objects[top_level_idx], instance);
     return islands;
 }
 
@@ -194,25 +206,37 @@ static ExPolygons top_level_outer_brim_area(const Print                   &print
         const float        brim_width        = scale_(object->config().brim_width.value);
         const bool         is_top_outer_brim = top_level_objects_idx.find(object->id().id) != top_level_objects_idx.end();
 
-        ExPolygons brim_area_object;
-        ExPolygons no_brim_area_object;
-        for (const ExPolygon &ex_poly : bottom_layers_expolygons[print_object_idx]) {
+        // The islands are independent, process them in parallel. The results are merged in the order of the islands.
+        const ExPolygons       &islands = bottom_layers_expolygons[print_object_idx];
+        std::vector<ExPolygons> brim_area_islands(islands.size());
+        std::vector<ExPolygons> no_brim_area_islands(islands.size());
+        clipper_batch(islands.size(), [&](size_t island_idx) {
+            const ExPolygon &ex_poly             = islands[island_idx];
+            ExPolygons      &brim_area_island    = brim_area_islands[island_idx];
+            ExPolygons      &no_brim_area_island = no_brim_area_islands[island_idx];
             if ((brim_type == BrimType::btOuterOnly || brim_type == BrimType::btOuterAndInner) && is_top_outer_brim)
-                append(brim_area_object, diff_ex(offset(ex_poly.contour, brim_width + brim_separation, ClipperLib::jtSquare), offset(ex_poly.contour, brim_separation, ClipperLib::jtSquare)));
+                brim_area_island = diff_ex(offset(ex_poly.contour, brim_width + brim_separation, ClipperLib::jtSquare), offset(ex_poly.contour, brim_separation, ClipperLib::jtSquare));
 
             // After 7ff76d07684858fd937ef2f5d863f105a10f798e offset and shrink don't work with CW polygons (holes), so let's make it CCW.
             Polygons ex_poly_holes_reversed = ex_poly.holes;
             polygons_reverse(ex_poly_holes_reversed);
             if (brim_type == BrimType::btOuterOnly || brim_type == BrimType::btNoBrim)
-                append(no_brim_area_object, shrink_ex(ex_poly_holes_reversed, no_brim_offset, ClipperLib::jtSquare));
+                append(no_brim_area_island, shrink_ex(ex_poly_holes_reversed, no_brim_offset, ClipperLib::jtSquare));
 
             if (brim_type == BrimType::btInnerOnly || brim_type == BrimType::btNoBrim)
-                append(no_brim_area_object, diff_ex(offset(ex_poly.contour, no_brim_offset, ClipperLib::jtSquare), ex_poly_holes_reversed));
+                append(no_brim_area_island, diff_ex(offset(ex_poly.contour, no_brim_offset, ClipperLib::jtSquare), ex_poly_holes_reversed));
 
             if (brim_type != BrimType::btNoBrim)
-                append(no_brim_area_object, offset_ex(ExPolygon(ex_poly.contour), brim_separation, ClipperLib::jtSquare));
+                append(no_brim_area_island, offset_ex(ExPolygon(ex_poly.contour), brim_separation, ClipperLib::jtSquare));
+
+            no_brim_area_island.emplace_back(ex_poly.contour);
+        });
 
-            no_brim_area_object.emplace_back(ex_poly.contour);
+        ExPolygons brim_area_object;
+        ExPolygons no_brim_area_object;
+        for (size_t island_idx = 0; island_idx < islands.size(); ++ island_idx) {
+            append(brim_area_object, std::move(brim_area_islands[island_idx]));
+            append(no_brim_area_object, std::move(no_brim_area_islands[island_idx]));
         }
 
         for (const PrintInstance &instance : object->instances()) {
@@ -319,45 +343,71 @@ static std::vector<InnerBrimExPolygons> inner_brim_area(const Print
         const float        brim_width      = scale_(object->config().brim_width.value);
         const bool         top_outer_brim  = top_level_objects_idx.find(object->id().id) != top_level_objects_idx.end();
 
-        ExPolygons brim_area_innermost_object;
-        ExPolygons brim_area_object;
-        ExPolygons no_brim_area_object;
-        Polygons   holes_reversed_object;
-        for (const ExPolygon &ex_poly : bottom_layers_expolygons[print_object_idx]) {
+        const ExPolygons &islands = bottom_layers_expolygons[print_object_idx];
+        // Index of the contour of the first instance of each island in has_nothing_inside.
+        std::vector<size_t> islands_polygon_idx(islands.size());
+        for (size_t island_idx = 0; island_idx < islands.size(); ++ island_idx) {
+            islands_polygon_idx[island_idx] = polygon_idx;
+            polygon_idx += object->instances().size() * (islands[island_idx].holes.size() + 1);
+        }
+
+        // The islands are independent, process them in parallel. The results are merged in the order of the islands.
+        struct IslandAreas {
+            ExPolygons brim_area_innermost;
+            ExPolygons brim_area;
+            ExPolygons no_brim_area;
+            Polygons   holes_reversed;
+        };
+        std::vector<IslandAreas> islands_areas(islands.size());
+        clipper_batch(islands.size(), [&](size_t island_idx) {
+            const ExPolygon &ex_poly            = islands[island_idx];
+            IslandAreas     &areas              = islands_areas[island_idx];
+            size_t           island_polygon_idx = islands_polygon_idx[island_idx];
             if (brim_type == BrimType::btOuterOnly || brim_type == BrimType::btOuterAndInner) {
                 if (top_outer_brim)
-                    no_brim_area_object.emplace_back(ex_poly);
+                    areas.no_brim_area.emplace_back(ex_poly);
                 else
-                    append(brim_area_object, diff_ex(offset(ex_poly.contour, brim_width + brim_separation, ClipperLib::jtSquare), offset(ex_poly.contour, brim_separation, ClipperLib::jtSquare)));
+                    append(areas.brim_area, diff_ex(offset(ex_poly.contour, brim_width + brim_separation, ClipperLib::jtSquare), offset(ex_poly.contour, brim_separation, ClipperLib::jtSquare)));
             }
 
             // After 7ff76d07684858fd937ef2f5d863f105a10f798e offset and shrink don't work with CW polygons (holes), so let's make it CCW.
             Polygons ex_poly_holes_reversed = ex_poly.holes;
             polygons_reverse(ex_poly_holes_reversed);
             for ([[maybe_unused]] const PrintInstance &instance : object->instances()) {
-                ++polygon_idx; // Increase idx because of the contour of the ExPolygon.
+                ++island_polygon_idx; // Increase idx because of the contour of the ExPolygon.
 
                 if (brim_type == BrimType::btInnerOnly || brim_type == BrimType::btOuterAndInner)
                     for(const Polygon &hole : ex_poly_holes_reversed) {
                         size_t hole_idx = &hole - &ex_poly_holes_reversed.front();
-                        if (has_nothing_inside[polygon_idx + hole_idx])
-                            append(brim_area_innermost_object, shrink_ex({hole}, brim_separation, ClipperLib::jtSquare));
+                        if (has_nothing_inside[island_polygon_idx + hole_idx])
+                            append(areas.brim_area_innermost, shrink_ex({hole}, brim_separation, ClipperLib::jtSquare));
                         else
-                            append(brim_area_object, diff_ex(shrink_ex({hole}, brim_separation, ClipperLib::jtSquare), shrink_ex({hole}, brim_width + brim_separation, ClipperLib::jtSquare)));
+                            append(areas.brim_area, diff_ex(shrink_ex({hole}, brim_separation, ClipperLib::jtSquare), shrink_ex({hole}, brim_width + brim_separation, ClipperLib::jtSquare)));
                     }
 
-                polygon_idx += ex_poly.holes.size(); // Increase idx for every hole of the ExPolygon.
+                island_polygon_idx += ex_poly.holes.size(); // Increase idx for every hole of the ExPolygon.
             }
 
             if (brim_type == BrimType::btInnerOnly || brim_type == BrimType::btNoBrim)
-                append(no_brim_area_object, diff_ex(offset(ex_poly.contour, no_brim_offset, ClipperLib::jtSquare), ex_poly_holes_reversed));
+                append(areas.no_brim_area, diff_ex(offset(ex_poly.contour, no_brim_offset, ClipperLib::jtSquare), ex_poly_holes_reversed));
 
             if (brim_type == BrimType::btOuterOnly || brim_type == BrimType::btNoBrim)
-                append(no_brim_area_object, diff_ex(ex_poly.contour, shrink_ex(ex_poly_holes_reversed, no_brim_offset, ClipperLib::jtSquare)));
+                append(areas.no_brim_area, diff_ex(ex_poly.contour, shrink_ex(ex_poly_holes_reversed, no_brim_offset, ClipperLib::jtSquare)));
 
-            append(holes_reversed_object, ex_poly_holes_reversed);
+            areas.holes_reversed = std::move(ex_poly_holes_reversed);
+        });
+
+        ExPolygons brim_area_innermost_object;
+        ExPolygons brim_area_object;
+        ExPolygons no_brim_area_object;
+        Polygons   holes_reversed_object;
+        for (IslandAreas &areas : islands_areas) {
+            append(brim_area_innermost_object, std::move(areas.brim_area_innermost));
+            append(brim_area_object, std::move(areas.brim_area));
+            append(no_brim_area_object, std::move(areas.no_brim_area));
+            append(holes_reversed_object, std::move(areas.holes_reversed));
         }
-        append(no_brim_area_object, offset_ex(bottom_layers_expolygons[print_object_idx], brim_separation, ClipperLib::jtSquare));
+        append(no_brim_area_object, offset_ex(islands, brim_separation, ClipperLib::jtSquare));
 
         for (const PrintInstance &instance : object->instances()) {
             append_and_translate(brim_area_innermost[print_object_idx], brim_area_innermost_object, instance);
@@ -525,7 +575,7 @@ ExtrusionEntityCollection make_brim(const Print &print, PrintTryCancel try_cance
     Flow                    flow                        = print.brim_flow();
     std::vector<ExPolygons> bottom_layers_expolygons    = get_print_bottom_layers_expolygons(print);
     ConstPrintObjectPtrs    top_level_objects_with_brim = get_top_level_objects_with_brim(print, bottom_layers_expolygons);
-    Polygons                islands                     = top_level_outer_brim_islands(top_level_objects_with_brim, scaled_resolution);
+    Polygons                islands                     = top_level_outer_brim_islands(print, top_level_objects_with_brim, bottom_layers_expolygons, scaled_resolution);
     ExPolygons              islands_area_ex             = top_level_outer_brim_area(print, top_level_objects_with_brim, bottom_layers_expolygons, float(flow.scaled_spacing()));
     islands_area                                        = to_polygons(islands_area_ex);
 
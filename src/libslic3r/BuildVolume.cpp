@@ -201,6 +201,30 @@ static inline BuildVolume::ObjectState rectangle_test(const indexed_triangle_set
 
 // Trim the input transformed triangle mesh with print bed and test the remaining vertices with is_inside callback.
 // Return inside / colliding / outside state.
+// Transforms the vertices in blocks, so that the matrix products are vectorized by Eigen, and calls fn(transformed vertex)
+// for each of them until fn returns false.
+template<typename Fn>
+static void for_each_transformed_vertex(const std::vector<stl_vertex> &vertices, const Transform3f &trafo, Fn &&fn)
+{
+    if (vertices.empty())
+        return;
+    static constexpr int block_size = 64;
+    const Eigen::Map<const Eigen::Matrix<float, 3, Eigen::Dynamic>> src(vertices.front().data(), 3, vertices.size());
+    const Matrix3f                                                  linear      = trafo.linear();
+    const Vec3f                                                     translation = trafo.translation();
+    Eigen::Matrix<float, 3, block_size>                             block;
+    for (size_t begin = 0; begin < vertices.size(); begin += block_size) {
+        const int num_vertices = int(std::min<size_t>(block_size, vertices.size() - begin));
+        if (num_vertices == block_size)
+            block.noalias() = (linear * src.middleCols<block_size>(begin)).colwise() + translation;
+        else
+            block.leftCols(num_vertices).noalias() = (linear * src.middleCols(begin, num_vertices)).colwise() + translation;
+        for (int i = 0; i < num_vertices; ++ i)
+            if (! fn(stl_vertex(block.col(i))))
+                return;
+    }
+}
+
 template<typename InsideFn>
 BuildVolume::ObjectState object_state_templ(const indexed_triangle_set &its, const Transform3f &trafo, bool may_be_below_bed, InsideFn is_inside)
 {
@@ -219,9 +243,8 @@ BuildVolume::ObjectState object_state_templ(const indexed_triangle_set &its, con
 
         const auto sign = [](const stl_vertex& pt) { return pt.z() > world_min_z ? 1 : pt.z() < world_min_z ? -1 : 0; };
 
-        for (const stl_vertex &v : its.vertices) {
-            const stl_vertex pt = trafo * v;
-            const int        s = sign(pt);
+        for_each_transformed_vertex(its.vertices, trafo, [&](const stl_vertex &pt) {
+            const int s = sign(pt);
             sides.emplace_back(s);
             if (s >= 0) {
                 // Vertex above or on print bed surface. Test whether it is inside the build volume.
@@ -229,7 +252,11 @@ BuildVolume::ObjectState object_state_templ(const indexed_triangle_set &its, con
                 if (is_inside(pt))
                     ++ num_inside;
             }
-        }
+            // Stop as soon as there is a vertex above the print bed both inside and outside, the object is colliding then.
+            return num_inside == 0 || num_inside == num_above;
+        });
+        if (num_inside > 0 && num_inside < num_above)
+            return BuildVolume::ObjectState::Colliding;
 
         if (num_above == 0)
             // Special case, the object is completely below the print bed, thus it is outside,
@@ -270,13 +297,14 @@ BuildVolume::ObjectState object_state_templ(const indexed_triangle_set &its, con
     {
         // Much simpler and faster code, not clipping the object with the print bed.
         assert(! may_be_below_bed);
-        num_above = its.vertices.size();
-        for (const stl_vertex &v : its.vertices) {
-            const stl_vertex pt = trafo * v;
+        for_each_transformed_vertex(its.vertices, trafo, [&](const stl_vertex &pt) {
             assert(pt.z() >= world_min_z);
+            ++ num_above;
             if (is_inside(pt))
                 ++ num_inside;
-        }
+            // Stop at the first vertex which decides that the object is colliding.
+            return num_inside == 0 || num_inside == num_above;
+        });
         inside  = num_inside > 0;
         outside = num_inside < num_above;
     }
@@ -337,6 +365,15 @@ bool BuildVolume::all_paths_inside(const GCodeProcessorResult& paths, const Boun
     auto move_valid = [](const GCodeProcessorResult::MoveVertex &move) {
         return move.type == EMoveType::Extrude && move.extrusion_role != GCodeExtrusionRole::Custom && move.width != 0.f && move.height != 0.f;
     };
+    // The moves are stored either in the vector of moves or in the compact storage.
+    auto all_moves = [&paths](auto fn) {
+        if (paths.compacted_moves.empty())
+            return std::all_of(paths.moves.begin(), paths.moves.end(), fn);
+        for (size_t i = 0; i < paths.compacted_moves.size(); ++ i)
+            if (! fn(paths.compacted_moves[i]))
+                return false;
+        return true;
+    };
     static constexpr const double epsilon = BedEpsilon;
 
     switch (m_type) {
@@ -355,18 +392,18 @@ bool BuildVolume::all_paths_inside(const GCodeProcessorResult& paths, const Boun
         const float r = unscaled<double>(m_circle.radius) + epsilon;
         const float r2 = sqr(r);
         return m_max_print_height == 0.0 ?
-            std::all_of(paths.moves.begin(), paths.moves.end(), [move_valid, c, r2](const GCodeProcessorResult::MoveVertex &move)
+            all_moves([move_valid, c, r2](const GCodeProcessorResult::MoveVertex &move)
                 { return ! move_valid(move) || (to_2d(move.position) - c).squaredNorm() <= r2; }) :
-            std::all_of(paths.moves.begin(), paths.moves.end(), [move_valid, c, r2, z = m_max_print_height + epsilon](const GCodeProcessorResult::MoveVertex& move)
+            all_moves([move_valid, c, r2, z = m_max_print_height + epsilon](const GCodeProcessorResult::MoveVertex& move)
                 { return ! move_valid(move) || ((to_2d(move.position) - c).squaredNorm() <= r2 && move.position.z() <= z); });
     }
     case Type::Convex:
     //FIXME doing test on convex hull until we learn to do test on non-convex polygons efficiently.
     case Type::Custom:
         return m_max_print_height == 0.0 ?
-            std::all_of(paths.moves.begin(), paths.moves.end(), [move_valid, this](const GCodeProcessorResult::MoveVertex &move) 
+            all_moves([move_valid, this](const GCodeProcessorResult::MoveVertex &move) 
                 { return ! move_valid(move) || Geometry::inside_convex_polygon(m_top_bottom_convex_hull_decomposition_bed, to_2d(move.position).cast<double>()); }) :
-            std::all_of(paths.moves.begin(), paths.moves.end(), [move_valid, this, z = m_max_print_height + epsilon](const GCodeProcessorResult::MoveVertex &move)
+            all_moves([move_valid, this, z = m_max_print_height + epsilon](const GCodeProcessorResult::MoveVertex &move)
                 { return ! move_valid(move) || (Geometry::inside_convex_polygon(m_top_bottom_convex_hull_decomposition_bed, to_2d(move.position).cast<double>()) && move.position.z() <= z); });
     default:
         return true;
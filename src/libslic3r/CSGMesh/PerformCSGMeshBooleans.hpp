@@ -5,9 +5,14 @@
 #ifndef PERFORMCSGMESHBOOLEANS_HPP
 #define PERFORMCSGMESHBOOLEANS_HPP
 
+#include <array>
+#include <mutex>
 #include <stack>
+#include <unordered_map>
 #include <vector>
 
+#include <boost/functional/hash.hpp>
+
 #include "CSGMesh.hpp"
 
 #include "libslic3r/Execution/ExecutionTBB.hpp"
@@ -84,6 +89,82 @@ std::vector<CGALMeshPtr> get_cgalptrs(Ex policy, const Range<It> &csgrange)
     return ret;
 }
 
+// Check a single part of the input of check_csgmesh_booleans(). The CGAL mesh
+// is retrieved by cgalmeshfn only if the part is not a bare stack operation.
+template<class CSGPartT, class CGALMeshFn>
+bool is_part_suitable_for_booleans(const CSGPartT &csgpart, CGALMeshFn &&cgalmeshfn)
+{
+    // mesh can be nullptr if this is a stack push or pull
+    if (!get_mesh(csgpart) && get_stack_operation(csgpart) != CSGStackOp::Continue)
+        return true;
+
+    try {
+        auto m = cgalmeshfn();
+
+        if (!m || MeshBoolean::cgal::empty(*m))
+            return false;
+
+        if (MeshBoolean::cgal::does_self_intersect(*m))
+            return false;
+
+        if (!MeshBoolean::cgal::does_bound_a_volume(*m))
+            return false;
+    }
+    catch (...) { return false; }
+
+    return true;
+}
+
+struct Frame {
+    CSGType op; CGALMeshPtr cgalptr;
+    explicit Frame(CSGType csgop = CSGType::Union)
+        : op{csgop}
+        , cgalptr{MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{})}
+    {}
+    Frame(CSGType csgop, CGALMeshPtr &&m) : op{csgop}, cgalptr{std::move(m)} {}
+};
+
+using FrameStack = std::stack<Frame, std::vector<Frame>>;
+
+// Call vfn on each part not marked in part_ok, return the first one or csgrange.end()
+template<class It, class Visitor>
+It visit_bad_parts(const Range<It> &csgrange, const std::vector<char> &part_ok, Visitor &&vfn)
+{
+    It ret = csgrange.end();
+    for (size_t i = 0; i < csgrange.size(); ++i) {
+        if (!part_ok[i]) {
+            auto it = csgrange.begin();
+            std::advance(it, i);
+            vfn(it);
+
+            if (ret == csgrange.end())
+                ret = it;
+        }
+    }
+
+    return ret;
+}
+
+// Apply a single CSG part with its CGAL mesh to the stack of partial results
+template<class CSGPartT>
+void perform_csg_step(FrameStack &opstack, const CSGPartT &csgpart, CGALMeshPtr &cgalptr)
+{
+    if (get_stack_operation(csgpart) == CSGStackOp::Push)
+        opstack.push(Frame{get_operation(csgpart)});
+
+    Frame *top = &opstack.top();
+
+    perform_csg(get_operation(csgpart), top->cgalptr, cgalptr);
+
+    if (get_stack_operation(csgpart) == CSGStackOp::Pop) {
+        CGALMeshPtr src = std::move(top->cgalptr);
+        auto popop = opstack.top().op;
+        opstack.pop();
+        CGALMeshPtr &dst = opstack.top().cgalptr;
+        perform_csg(popop, dst, src);
+    }
+}
+
 } // namespace detail
 
 // Process the sequence of CSG parts with CGAL.
@@ -91,47 +172,18 @@ template<class It>
 void perform_csgmesh_booleans(MeshBoolean::cgal::CGALMeshPtr &cgalm,
                               const Range<It>                &csgrange)
 {
-    using MeshBoolean::cgal::CGALMesh;
     using MeshBoolean::cgal::CGALMeshPtr;
     using namespace detail_cgal;
 
-    struct Frame {
-        CSGType op; CGALMeshPtr cgalptr;
-        explicit Frame(CSGType csgop = CSGType::Union)
-            : op{csgop}
-            , cgalptr{MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{})}
-        {}
-    };
-
-    std::stack opstack{std::vector<Frame>{}};
+    FrameStack opstack;
 
     opstack.push(Frame{});
 
     std::vector<CGALMeshPtr> cgalmeshes = get_cgalptrs(ex_tbb, csgrange);
 
     size_t csgidx = 0;
-    for (auto &csgpart : csgrange) {
-
-        auto op = get_operation(csgpart);
-        CGALMeshPtr &cgalptr = cgalmeshes[csgidx++];
-
-        if (get_stack_operation(csgpart) == CSGStackOp::Push) {
-            opstack.push(Frame{op});
-            op = CSGType::Union;
-        }
-
-        Frame *top = &opstack.top();
-
-        perform_csg(get_operation(csgpart), top->cgalptr, cgalptr);
-
-        if (get_stack_operation(csgpart) == CSGStackOp::Pop) {
-            CGALMeshPtr src = std::move(top->cgalptr);
-            auto popop = opstack.top().op;
-            opstack.pop();
-            CGALMeshPtr &dst = opstack.top().cgalptr;
-            perform_csg(popop, dst, src);
-        }
-    }
+    for (auto &csgpart : csgrange)
+        perform_csg_step(opstack, csgpart, cgalmeshes[csgidx++]);
 
     cgalm = std::move(opstack.top().cgalptr);
 }
@@ -144,66 +196,255 @@ It check_csgmesh_booleans(const Range<It> &csgrange, Visitor &&vfn)
 {
     using namespace detail_cgal;
 
-    std::vector<CGALMeshPtr> cgalmeshes(csgrange.size());
-    auto check_part = [&csgrange, &cgalmeshes](size_t i)
+    std::vector<char> part_ok(csgrange.size(), false);
+    auto check_part = [&csgrange, &part_ok](size_t i)
     {
         auto it = csgrange.begin();
         std::advance(it, i);
-        auto &csgpart = *it;
-        auto m = get_cgalmesh(csgpart);
+        part_ok[i] = is_part_suitable_for_booleans(*it, [&it] { return get_cgalmesh(*it); });
+    };
+    execution::for_each(ex_tbb, size_t(0), csgrange.size(), check_part);
 
-        // mesh can be nullptr if this is a stack push or pull
-        if (!get_mesh(csgpart) && get_stack_operation(csgpart) != CSGStackOp::Continue) {
-            cgalmeshes[i] = MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{});
-            return;
-        }
+    return visit_bad_parts(csgrange, part_ok, vfn);
+}
 
-        try {
-            if (!m || MeshBoolean::cgal::empty(*m))
-                return;
+// Overload of the previous check_csgmesh_booleans without the visitor argument
+template<class It>
+It check_csgmesh_booleans(const Range<It> &csgrange)
+{
+    return check_csgmesh_booleans(csgrange, [](auto &) {});
+}
 
-            if (MeshBoolean::cgal::does_self_intersect(*m))
-                return;
+template<class It>
+MeshBoolean::cgal::CGALMeshPtr perform_csgmesh_booleans(const Range<It> &csgparts)
+{
+    auto ret = MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{});
+    if (ret)
+        perform_csgmesh_booleans(ret, csgparts);
 
-            if (!MeshBoolean::cgal::does_bound_a_volume(*m))
-                return;
+    return ret;
+}
+
+// Cache for the repeated CGAL evaluation of a slowly changing sequence of CSG
+// parts, e.g. while a negative volume of an SLA object is being dragged.
+// The CGAL mesh of a part is converted and checked only once for the same mesh
+// and transformation. The partial results of the last evaluated sequence are
+// kept, thus only the suffix following the first changed part is recomputed.
+// Meshes are identified by a hash of their content, as the parts are created
+// anew (e.g. by splitting) each time the model changes.
+// The cache is not thread safe, it can only be used by one evaluation at a time.
+class CGALBooleanCache
+{
+    using CGALMeshPtr = MeshBoolean::cgal::CGALMeshPtr;
+
+    struct PartKey
+    {
+        size_t                mesh_hash    = 0;
+        size_t                num_vertices = 0;
+        size_t                num_faces    = 0;
+        std::array<float, 16> trafo{};
+        CSGType               operation       = CSGType::Union;
+        CSGStackOp            stack_operation = CSGStackOp::Continue;
+
+        bool operator==(const PartKey &o) const
+        {
+            return mesh_hash == o.mesh_hash && num_vertices == o.num_vertices &&
+                   num_faces == o.num_faces && trafo == o.trafo &&
+                   operation == o.operation && stack_operation == o.stack_operation;
         }
-        catch (...) { return; }
+    };
 
-        cgalmeshes[i] = std::move(m);
+    struct PartKeyHash
+    {
+        size_t operator()(const PartKey &k) const
+        {
+            size_t seed = k.mesh_hash;
+            boost::hash_combine(seed, boost::hash_range(k.trafo.begin(), k.trafo.end()));
+            boost::hash_combine(seed, int(k.operation));
+            boost::hash_combine(seed, int(k.stack_operation));
+            return seed;
+        }
     };
-    execution::for_each(ex_tbb, size_t(0), csgrange.size(), check_part);
 
-    It ret = csgrange.end();
-    for (size_t i = 0; i < csgrange.size(); ++i) {
-        if (!cgalmeshes[i]) {
+    struct PartEntry
+    {
+        std::once_flag converted, checked;
+        CGALMeshPtr    cgalmesh;
+        bool           suitable = false;
+    };
+
+    std::mutex                                         m_mutex;
+    std::unordered_map<PartKey, PartEntry, PartKeyHash> m_parts;
+
+    // Keys of the last evaluated sequence and the results after each of its
+    // parts. A result is only stored where the stack of partial results has
+    // a single level, nullptr otherwise.
+    std::vector<PartKey>     m_sequence;
+    std::vector<CGALMeshPtr> m_results;
+    size_t                   m_last_evaluated = 0;
+
+    template<class CSGPartT> static PartKey part_key(const CSGPartT &csgpart)
+    {
+        PartKey key;
+        if (const indexed_triangle_set *its = get_mesh(csgpart)) {
+            key.num_vertices = its->vertices.size();
+            key.num_faces    = its->indices.size();
+            if (key.num_vertices > 0)
+                key.mesh_hash = boost::hash_range(its->vertices.front().data(),
+                                                  its->vertices.front().data() + 3 * key.num_vertices);
+            if (key.num_faces > 0)
+                boost::hash_combine(key.mesh_hash,
+                                    boost::hash_range(its->indices.front().data(),
+                                                      its->indices.front().data() + 3 * key.num_faces));
+            Transform3f tr = get_transform(csgpart);
+            std::copy(tr.data(), tr.data() + 16, key.trafo.begin());
+        }
+        key.operation       = get_operation(csgpart);
+        key.stack_operation = get_stack_operation(csgpart);
+
+        return key;
+    }
+
+    template<class It> std::vector<PartKey> part_keys(const Range<It> &csgrange)
+    {
+        std::vector<PartKey> keys(csgrange.size());
+        execution::for_each(ex_tbb, size_t(0), csgrange.size(),
+                            [&csgrange, &keys](size_t i) {
             auto it = csgrange.begin();
             std::advance(it, i);
-            vfn(it);
+            keys[i] = part_key(*it);
+        });
 
-            if (ret == csgrange.end())
-                ret = it;
+        return keys;
+    }
+
+    PartEntry &entry(const PartKey &key)
+    {
+        std::lock_guard lk{m_mutex};
+        // References to the elements of unordered_map survive rehashing
+        return m_parts[key];
+    }
+
+    template<class CSGPartT>
+    const CGALMeshPtr &cached_cgalmesh(PartEntry &e, const CSGPartT &csgpart)
+    {
+        std::call_once(e.converted, [&e, &csgpart] { e.cgalmesh = get_cgalmesh(csgpart); });
+        return e.cgalmesh;
+    }
+
+public:
+    // Cached equivalent of check_csgmesh_booleans()
+    template<class It, class Visitor>
+    It check_csgmesh_booleans(const Range<It> &csgrange, Visitor &&vfn)
+    {
+        std::vector<PartKey> keys = part_keys(csgrange);
+        std::vector<char> part_ok(csgrange.size(), false);
+        execution::for_each(ex_tbb, size_t(0), csgrange.size(),
+                            [this, &csgrange, &keys, &part_ok](size_t i) {
+            auto it = csgrange.begin();
+            std::advance(it, i);
+            PartEntry &e = entry(keys[i]);
+            std::call_once(e.checked, [this, &e, &it] {
+                e.suitable = detail_cgal::is_part_suitable_for_booleans(
+                    *it, [this, &e, &it] { return cached_cgalmesh(e, *it).get(); });
+            });
+            part_ok[i] = e.suitable;
+        });
+
+        return detail_cgal::visit_bad_parts(csgrange, part_ok, vfn);
+    }
+
+    // Cached equivalent of perform_csgmesh_booleans(). Parts not present in
+    // csgrange are evicted from the cache afterwards.
+    template<class It>
+    CGALMeshPtr perform_csgmesh_booleans(const Range<It> &csgrange)
+    {
+        using namespace detail_cgal;
+
+        std::vector<PartKey> keys = part_keys(csgrange);
+
+        size_t prefix = 0;
+        while (prefix < keys.size() && prefix < m_sequence.size() &&
+               keys[prefix] == m_sequence[prefix])
+            ++prefix;
+
+        // Resume from the last stored result preceding the first changed part
+        size_t start = prefix;
+        while (start > 0 && !m_results[start - 1])
+            --start;
+
+        std::vector<CGALMeshPtr> cgalmeshes(keys.size());
+        execution::for_each(ex_tbb, start, keys.size(),
+                            [this, &csgrange, &keys, &cgalmeshes](size_t i) {
+            auto it = csgrange.begin();
+            std::advance(it, i);
+            const CGALMeshPtr &m = cached_cgalmesh(entry(keys[i]), *it);
+            // The booleans modify their arguments, thus the copy
+            if (m)
+                cgalmeshes[i] = MeshBoolean::cgal::clone(*m);
+        });
+
+        FrameStack opstack;
+        if (start > 0)
+            opstack.push(Frame{CSGType::Union, MeshBoolean::cgal::clone(*m_results[start - 1])});
+        else
+            opstack.push(Frame{});
+
+        std::vector<CGALMeshPtr> results(keys.size());
+        auto it = csgrange.begin();
+        std::advance(it, start);
+        for (size_t i = start; i < keys.size(); ++i, ++it) {
+            perform_csg_step(opstack, *it, cgalmeshes[i]);
+            if (opstack.size() == 1 && opstack.top().cgalptr)
+                results[i] = MeshBoolean::cgal::clone(*opstack.top().cgalptr);
         }
+
+        // Nothing has thrown, the new sequence can replace the previous one
+        for (size_t i = 0; i < start; ++i)
+            results[i] = std::move(m_results[i]);
+
+        m_sequence       = std::move(keys);
+        m_results        = std::move(results);
+        m_last_evaluated = m_sequence.size() - start;
+
+        std::unordered_map<PartKey, PartEntry, PartKeyHash> parts;
+        for (const PartKey &key : m_sequence)
+            if (auto found = m_parts.find(key); found != m_parts.end())
+                parts.insert(m_parts.extract(found));
+        m_parts = std::move(parts);
+
+        return std::move(opstack.top().cgalptr);
     }
 
-    return ret;
+    // Number of parts the last perform_csgmesh_booleans() had to evaluate
+    size_t last_evaluated_parts() const { return m_last_evaluated; }
+
+    void clear()
+    {
+        m_parts.clear();
+        m_sequence.clear();
+        m_results.clear();
+        m_last_evaluated = 0;
+    }
+};
+
+template<class It, class Visitor>
+It check_csgmesh_booleans(const Range<It> &csgrange, CGALBooleanCache &cache, Visitor &&vfn)
+{
+    return cache.check_csgmesh_booleans(csgrange, vfn);
 }
 
-// Overload of the previous check_csgmesh_booleans without the visitor argument
 template<class It>
-It check_csgmesh_booleans(const Range<It> &csgrange)
+It check_csgmesh_booleans(const Range<It> &csgrange, CGALBooleanCache &cache)
 {
-    return check_csgmesh_booleans(csgrange, [](auto &) {});
+    return cache.check_csgmesh_booleans(csgrange, [](auto &) {});
 }
 
 template<class It>
-MeshBoolean::cgal::CGALMeshPtr perform_csgmesh_booleans(const Range<It> &csgparts)
+MeshBoolean::cgal::CGALMeshPtr perform_csgmesh_booleans(const Range<It> &csgparts,
+                                                        CGALBooleanCache &cache)
 {
-    auto ret = MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{});
-    if (ret)
-        perform_csgmesh_booleans(ret, csgparts);
-
-    return ret;
+    return cache.perform_csgmesh_booleans(csgparts);
 }
 
 } // namespace csg
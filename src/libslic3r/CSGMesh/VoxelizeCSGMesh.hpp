@@ -5,6 +5,8 @@
 #ifndef VOXELIZECSGMESH_HPP
 #define VOXELIZECSGMESH_HPP
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 #include <stack>
 
@@ -116,6 +118,46 @@ VoxelGridPtr voxelize_csgmesh(const Range<It>      &csgrange,
     return ret;
 }
 
+// Voxel scale not greater than params.voxel_scale() for voxelizing csgrange
+// with about max_voxels active voxels at most. The surface of the narrow band
+// is estimated by the surfaces of the bounding boxes of the parts.
+template<class It>
+float adaptive_voxel_scale(const Range<It>      &csgrange,
+                           const VoxelizeParams &params,
+                           double                max_voxels)
+{
+    double area = 0.;
+    for (auto &csgpart : csgrange) {
+        const indexed_triangle_set *its = csg::get_mesh(csgpart);
+        if (its && !its->empty()) {
+            Vec3d sz = bounding_box(*its, params.trafo() * csg::get_transform(csgpart)).size();
+            area += 2. * (sz.x() * sz.y() + sz.y() * sz.z() + sz.z() * sz.x());
+        }
+    }
+
+    double bandwidth = std::max(1., double(params.exterior_bandwidth() + params.interior_bandwidth()));
+    if (area <= 0.)
+        return params.voxel_scale();
+
+    return std::min(params.voxel_scale(), float(std::sqrt(max_voxels / (area * bandwidth))));
+}
+
+// Approximate alternative to the CGAL booleans of csg::perform_csgmesh_booleans().
+// Much faster for large meshes, e.g. 3D scans, but the result is only as
+// accurate as the voxel size. Returns an empty mesh if cancelled by the
+// status function of params.
+template<class It>
+indexed_triangle_set voxel_csgmesh_booleans(const Range<It>      &csgrange,
+                                            const VoxelizeParams &params,
+                                            double                adaptivity = 0.01)
+{
+    VoxelGridPtr grid = voxelize_csgmesh(csgrange, params);
+    if (!grid || (params.statusfn() && params.statusfn()(-1)))
+        return {};
+
+    return grid_to_mesh(*grid, 0., adaptivity);
+}
+
 }} // namespace Slic3r::csg
 
 #endif // VOXELIZECSGMESH_HPP
@@ -11,7 +11,9 @@
 ///|/
 #include "ClipperUtils.hpp"
 
+#include <array>
 #include <cmath>
+#include <memory>
 
 #include "ShortestPath.hpp"
 #include "libslic3r/BoundingBox.hpp"
@@ -20,6 +22,9 @@
 #include "libslic3r/Surface.hpp"
 #include "libslic3r/libslic3r.h"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 // #define CLIPPER_UTILS_TIMING
 
 #ifdef CLIPPER_UTILS_TIMING
@@ -77,6 +82,66 @@ err:
 }
 #endif /* CLIPPER_UTILS_DEBUG */
 
+namespace {
+
+// Constructing a Clipper / ClipperOffset engine for each boolean operation allocates its edge lists, the scanbeam
+// and the output records again and again. An engine returned to a thread local pool keeps these buffers,
+// therefore the following operations on the same thread mostly reuse memory instead of calling malloc.
+// The pool is a stack, thus nested operations get distinct engines.
+template<typename Engine>
+class PooledEngine
+{
+public:
+    PooledEngine() {
+        Pool &pool = thread_pool();
+        m_engine = pool.size == 0 ? std::make_unique<Engine>() : std::move(pool.engines[-- pool.size]);
+    }
+    ~PooledEngine() {
+        // Don't let a single huge operation pin its memory for the lifetime of the thread.
+        if (Pool &pool = thread_pool(); pool.size < pool.engines.size() && m_engine->RetainedCapacity() <= max_retained_capacity) {
+            reset(*m_engine);
+            pool.engines[pool.size ++] = std::move(m_engine);
+        }
+    }
+    PooledEngine(const PooledEngine&) = delete;
+    PooledEngine& operator=(const PooledEngine&) = delete;
+
+    Engine& operator*()  { return *m_engine; }
+    Engine* operator->() { return m_engine.get(); }
+
+private:
+    // Number of edges plus output points an engine may retain to be returned to the pool.
+    static constexpr const size_t max_retained_capacity = 16384;
+
+    struct Pool {
+        std::array<std::unique_ptr<Engine>, 4> engines;
+        size_t                                 size { 0 };
+    };
+    static Pool& thread_pool() { static thread_local Pool pool; return pool; }
+
+    // Return the engine to the state of a freshly constructed one.
+    static void reset(ClipperLib::Clipper &clipper) {
+        clipper.Clear();
+        clipper.ReverseSolution(false);
+        clipper.StrictlySimple(false);
+        clipper.PreserveCollinear(false);
+    }
+    static void reset(ClipperLib::ClipperOffset &co) {
+        co.Clear();
+        // Defaults of the ClipperOffset constructor.
+        co.MiterLimit         = 2.;
+        co.ArcTolerance       = 0.25;
+        co.ShortestEdgeLength = 0.;
+    }
+
+    std::unique_ptr<Engine> m_engine;
+};
+
+using PooledClipper       = PooledEngine<ClipperLib::Clipper>;
+using PooledClipperOffset = PooledEngine<ClipperLib::ClipperOffset>;
+
+} // namespace
+
 namespace ClipperUtils {
     Points EmptyPathsProvider::s_empty_points;
     Points SinglePathProvider::s_end;
@@ -307,23 +372,23 @@ static ClipperLib::Paths raw_offset(PathsProvider &&paths, float offset, Clipper
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::ClipperOffset co;
+    PooledClipperOffset co;
     ClipperLib::Paths out;
     out.reserve(paths.size());
     ClipperLib::Paths out_this;
     if (joinType == jtRound)
-        co.ArcTolerance = miterLimit;
+        co->ArcTolerance = miterLimit;
     else
-        co.MiterLimit = miterLimit;
-    co.ShortestEdgeLength = std::abs(offset * ClipperOffsetShortestEdgeFactor);
+        co->MiterLimit = miterLimit;
+    co->ShortestEdgeLength = std::abs(offset * ClipperOffsetShortestEdgeFactor);
     for (const ClipperLib::Path &path : paths) {
-        co.Clear();
+        co->Clear();
         // Execute reorients the contours so that the outer most contour has a positive area. Thus the output
         // contours will be CCW oriented even though the input paths are CW oriented.
         // Offset is applied after contour reorientation, thus the signum of the offset value is reversed.
-        co.AddPath(path, joinType, endType);
+        co->AddPath(path, joinType, endType);
         bool ccw = endType == ClipperLib::etClosedPolygon ? ClipperLib::Orientation(path) : true;
-        co.Execute(out_this, ccw ? offset : - offset);
+        co->Execute(out_this, ccw ? offset : - offset);
         if (! ccw) {
             // Reverse the resulting contours.
             for (ClipperLib::Path &path : out_this)
@@ -350,11 +415,11 @@ TResult clipper_do(
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
-    clipper.AddPaths(std::forward<TClip>(clip),    ClipperLib::ptClip,    true);
+    PooledClipper clipper;
+    clipper->AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
+    clipper->AddPaths(std::forward<TClip>(clip),    ClipperLib::ptClip,    true);
     TResult retval;
-    clipper.Execute(clipType, retval, fillType, fillType);
+    clipper->Execute(clipType, retval, fillType, fillType);
     return retval;
 }
 
@@ -381,10 +446,10 @@ TResult clipper_union(
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
+    PooledClipper clipper;
+    clipper->AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
     TResult retval;
-    clipper.Execute(ClipperLib::ctUnion, retval, fillType, fillType);
+    clipper->Execute(ClipperLib::ctUnion, retval, fillType, fillType);
     return retval;
 }
 
@@ -424,12 +489,12 @@ static TResult shrink_paths(PathsProvider &&paths, float offset, ClipperLib::Joi
     assert(offset > 0);
     TResult out;
     if (auto raw = raw_offset(std::forward<PathsProvider>(paths), - offset, joinType, miterLimit); ! raw.empty()) {
-        ClipperLib::Clipper clipper;
-        clipper.AddPaths(raw, ClipperLib::ptSubject, true);
-        ClipperLib::IntRect r = clipper.GetBounds();
-        clipper.AddPath({ { r.left - 10, r.bottom + 10 }, { r.right + 10, r.bottom + 10 }, { r.right + 10, r.top - 10 }, { r.left - 10, r.top - 10 } }, ClipperLib::ptSubject, true);
-        clipper.ReverseSolution(true);
-        clipper.Execute(ClipperLib::ctUnion, out, ClipperLib::pftNegative, ClipperLib::pftNegative);
+        PooledClipper clipper;
+        clipper->AddPaths(raw, ClipperLib::ptSubject, true);
+        ClipperLib::IntRect r = clipper->GetBounds();
+        clipper->AddPath({ { r.left - 10, r.bottom + 10 }, { r.right + 10, r.bottom + 10 }, { r.right + 10, r.top - 10 }, { r.left - 10, r.top - 10 } }, ClipperLib::ptSubject, true);
+        clipper->ReverseSolution(true);
+        clipper->Execute(ClipperLib::ctUnion, out, ClipperLib::pftNegative, ClipperLib::pftNegative);
         remove_outermost_polygon(out);
     }
     return out;
@@ -472,14 +537,14 @@ static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const float d
     // 1) Offset the outer contour.
     ClipperLib::Paths contours;
     {
-        ClipperLib::ClipperOffset co;
+        PooledClipperOffset co;
         if (joinType == jtRound)
-            co.ArcTolerance = miterLimit;
+            co->ArcTolerance = miterLimit;
         else
-            co.MiterLimit = miterLimit;
-        co.ShortestEdgeLength = std::abs(delta * ClipperOffsetShortestEdgeFactor);
-        co.AddPath(expoly.contour.points, joinType, ClipperLib::etClosedPolygon);
-        co.Execute(contours, delta);
+            co->MiterLimit = miterLimit;
+        co->ShortestEdgeLength = std::abs(delta * ClipperOffsetShortestEdgeFactor);
+        co->AddPath(expoly.contour.points, joinType, ClipperLib::etClosedPolygon);
+        co->Execute(contours, delta);
     }
     if (contours.empty())
         // No need to try to offset the holes.
@@ -493,18 +558,18 @@ static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const float d
         ClipperLib::Paths holes;
         {
             for (const Polygon &hole : expoly.holes) {
-                ClipperLib::ClipperOffset co;
+                PooledClipperOffset co;
                 if (joinType == jtRound)
-                    co.ArcTolerance = miterLimit;
+                    co->ArcTolerance = miterLimit;
                 else
-                    co.MiterLimit = miterLimit;
-                co.ShortestEdgeLength = std::abs(delta * ClipperOffsetShortestEdgeFactor);
-                co.AddPath(hole.points, joinType, ClipperLib::etClosedPolygon);
+                    co->MiterLimit = miterLimit;
+                co->ShortestEdgeLength = std::abs(delta * ClipperOffsetShortestEdgeFactor);
+                co->AddPath(hole.points, joinType, ClipperLib::etClosedPolygon);
                 ClipperLib::Paths out2;
                 // Execute reorients the contours so that the outer most contour has a positive area. Thus the output
                 // contours will be CCW oriented even though the input paths are CW oriented.
                 // Offset is applied after contour reorientation, thus the signum of the offset value is reversed.
-                co.Execute(out2, - delta);
+                co->Execute(out2, - delta);
                 append(holes, std::move(out2));
             }
         }
@@ -829,11 +894,11 @@ Polylines _clipper_pl_open(ClipperLib::ClipType clipType, PathsProvider1 &&subje
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<PathsProvider1>(subject), ClipperLib::ptSubject, false);
-    clipper.AddPaths(std::forward<PathsProvider2>(clip), ClipperLib::ptClip, true);
+    PooledClipper clipper;
+    clipper->AddPaths(std::forward<PathsProvider1>(subject), ClipperLib::ptSubject, false);
+    clipper->AddPaths(std::forward<PathsProvider2>(clip), ClipperLib::ptClip, true);
     ClipperLib::PolyTree retval;
-    clipper.Execute(clipType, retval, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+    clipper->Execute(clipType, retval, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
     return PolyTreeToPolylines(std::move(retval));
 }
 
@@ -1012,17 +1077,81 @@ Polygons union_pt_chained_outside_in(const Polygons &subject)
     return retval;
 }
 
+void clipper_batch(size_t count, const std::function<void(size_t)> &fn)
+{
+    if (count < 2) {
+        for (size_t i = 0; i < count; ++ i)
+            fn(i);
+        return;
+    }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, count), [&fn](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+            fn(i);
+    });
+}
+
+std::vector<ExPolygons> offset_ex_batch(tcb::span<const ExPolygon> inputs, const float delta, ClipperLib::JoinType joinType, double miterLimit)
+{
+    std::vector<ExPolygons> out(inputs.size());
+    clipper_batch(inputs.size(), [&](size_t i) { out[i] = offset_ex(inputs[i], delta, joinType, miterLimit); });
+    return out;
+}
+
+std::vector<ExPolygons> offset_ex_batch(tcb::span<const ExPolygons> inputs, const float delta, ClipperLib::JoinType joinType, double miterLimit)
+{
+    std::vector<ExPolygons> out(inputs.size());
+    clipper_batch(inputs.size(), [&](size_t i) { out[i] = offset_ex(inputs[i], delta, joinType, miterLimit); });
+    return out;
+}
+
+std::vector<ExPolygons> union_ex_batch(tcb::span<const ExPolygons> inputs)
+{
+    std::vector<ExPolygons> out(inputs.size());
+    clipper_batch(inputs.size(), [&](size_t i) { out[i] = union_ex(inputs[i]); });
+    return out;
+}
+
+std::vector<ExPolygons> diff_ex_batch(tcb::span<const ExPolygons> subjects, const Polygons &clip, ApplySafetyOffset do_safety_offset)
+{
+    std::vector<ExPolygons> out(subjects.size());
+    clipper_batch(subjects.size(), [&](size_t i) { out[i] = diff_ex(subjects[i], clip, do_safety_offset); });
+    return out;
+}
+
+std::vector<ExPolygons> intersection_ex_batch(tcb::span<const ExPolygons> subjects, const Polygons &clip, ApplySafetyOffset do_safety_offset)
+{
+    std::vector<ExPolygons> out(subjects.size());
+    clipper_batch(subjects.size(), [&](size_t i) { out[i] = intersection_ex(subjects[i], clip, do_safety_offset); });
+    return out;
+}
+
+std::vector<ExPolygons> diff_ex_batch(tcb::span<const ExPolygons> subjects, tcb::span<const ExPolygons> clips, ApplySafetyOffset do_safety_offset)
+{
+    assert(subjects.size() == clips.size());
+    std::vector<ExPolygons> out(subjects.size());
+    clipper_batch(subjects.size(), [&](size_t i) { out[i] = diff_ex(subjects[i], clips[i], do_safety_offset); });
+    return out;
+}
+
+std::vector<ExPolygons> intersection_ex_batch(tcb::span<const ExPolygons> subjects, tcb::span<const ExPolygons> clips, ApplySafetyOffset do_safety_offset)
+{
+    assert(subjects.size() == clips.size());
+    std::vector<ExPolygons> out(subjects.size());
+    clipper_batch(subjects.size(), [&](size_t i) { out[i] = intersection_ex(subjects[i], clips[i], do_safety_offset); });
+    return out;
+}
+
 Polygons simplify_polygons(const Polygons &subject)
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
     ClipperLib::Paths output;
-    ClipperLib::Clipper c;
+    PooledClipper c;
 //    c.PreserveCollinear(true);
     //FIXME StrictlySimple is very expensive! Is it needed?
-    c.StrictlySimple(true);
-    c.AddPaths(ClipperUtils::PolygonsProvider(subject), ClipperLib::ptSubject, true);
-    c.Execute(ClipperLib::ctUnion, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+    c->StrictlySimple(true);
+    c->AddPaths(ClipperUtils::PolygonsProvider(subject), ClipperLib::ptSubject, true);
+    c->Execute(ClipperLib::ctUnion, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
 
     // convert into Slic3r polygons
     return to_polygons(std::move(output));
@@ -1033,12 +1162,12 @@ ExPolygons simplify_polygons_ex(const Polygons &subject, bool preserve_collinear
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
     ClipperLib::PolyTree polytree;
-    ClipperLib::Clipper c;
+    PooledClipper c;
 //    c.PreserveCollinear(true);
     //FIXME StrictlySimple is very expensive! Is it needed?
-    c.StrictlySimple(true);
-    c.AddPaths(ClipperUtils::PolygonsProvider(subject), ClipperLib::ptSubject, true);
-    c.Execute(ClipperLib::ctUnion, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+    c->StrictlySimple(true);
+    c->AddPaths(ClipperUtils::PolygonsProvider(subject), ClipperLib::ptSubject, true);
+    c->Execute(ClipperLib::ctUnion, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
     
     // convert into ExPolygons
     return PolyTreeToExPolygons(std::move(polytree));
@@ -1049,12 +1178,12 @@ Polygons top_level_islands(const Slic3r::Polygons &polygons)
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
     // init Clipper
-    ClipperLib::Clipper clipper;
-    clipper.Clear();
+    PooledClipper clipper;
+    clipper->Clear();
     // perform union
-    clipper.AddPaths(ClipperUtils::PolygonsProvider(polygons), ClipperLib::ptSubject, true);
+    clipper->AddPaths(ClipperUtils::PolygonsProvider(polygons), ClipperLib::ptSubject, true);
     ClipperLib::PolyTree polytree;
-    clipper.Execute(ClipperLib::ctUnion, polytree, ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd); 
+    clipper->Execute(ClipperLib::ctUnion, polytree, ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd); 
     // Convert only the top level islands to the output.
     Polygons out;
     out.reserve(polytree.ChildCount());
@@ -1075,10 +1204,10 @@ ClipperLib::Paths fix_after_outer_offset(
 
   	ClipperLib::Paths solution;
   	if (! input.empty()) {
-		ClipperLib::Clipper clipper;
-	  	clipper.AddPath(input, ClipperLib::ptSubject, true);
-		clipper.ReverseSolution(reverse_result);
-		clipper.Execute(ClipperLib::ctUnion, solution, filltype, filltype);
+		PooledClipper clipper;
+	  	clipper->AddPath(input, ClipperLib::ptSubject, true);
+		clipper->ReverseSolution(reverse_result);
+		clipper->Execute(ClipperLib::ctUnion, solution, filltype, filltype);
 	}
     return solution;
 }
@@ -1095,16 +1224,16 @@ ClipperLib::Paths fix_after_inner_offset(
 
   	ClipperLib::Paths solution;
   	if (! input.empty()) {
-		ClipperLib::Clipper clipper;
-		clipper.AddPath(input, ClipperLib::ptSubject, true);
-		ClipperLib::IntRect r = clipper.GetBounds();
+		PooledClipper clipper;
+		clipper->AddPath(input, ClipperLib::ptSubject, true);
+		ClipperLib::IntRect r = clipper->GetBounds();
 		r.left -= 10; r.top -= 10; r.right += 10; r.bottom += 10;
 		if (filltype == ClipperLib::pftPositive)
-			clipper.AddPath({ ClipperLib::IntPoint(r.left, r.bottom), ClipperLib::IntPoint(r.left, r.top), ClipperLib::IntPoint(r.right, r.top), ClipperLib::IntPoint(r.right, r.bottom) }, ClipperLib::ptSubject, true);
+			clipper->AddPath({ ClipperLib::IntPoint(r.left, r.bottom), ClipperLib::IntPoint(r.left, r.top), ClipperLib::IntPoint(r.right, r.top), ClipperLib::IntPoint(r.right, r.bottom) }, ClipperLib::ptSubject, true);
 		else
-			clipper.AddPath({ ClipperLib::IntPoint(r.left, r.bottom), ClipperLib::IntPoint(r.right, r.bottom), ClipperLib::IntPoint(r.right, r.top), ClipperLib::IntPoint(r.left, r.top) }, ClipperLib::ptSubject, true);
-		clipper.ReverseSolution(reverse_result);
-		clipper.Execute(ClipperLib::ctUnion, solution, filltype, filltype);
+			clipper->AddPath({ ClipperLib::IntPoint(r.left, r.bottom), ClipperLib::IntPoint(r.right, r.bottom), ClipperLib::IntPoint(r.right, r.top), ClipperLib::IntPoint(r.left, r.top) }, ClipperLib::ptSubject, true);
+		clipper->ReverseSolution(reverse_result);
+		clipper->Execute(ClipperLib::ctUnion, solution, filltype, filltype);
 		if (! solution.empty())
 			solution.erase(solution.begin());
 	}
@@ -1294,13 +1423,13 @@ Polygons variable_offset_inner(const ExPolygon &expoly, const std::vector<std::v
 	if (holes.empty())
 		output = std::move(contours);
 	else {
-		ClipperLib::Clipper clipper;
-		clipper.Clear();
-		clipper.AddPaths(contours, ClipperLib::ptSubject, true);
+		PooledClipper clipper;
+		clipper->Clear();
+		clipper->AddPaths(contours, ClipperLib::ptSubject, true);
         // Holes may contain holes in holes produced by expanding a C hole shape.
         // The situation is processed correctly by Clipper diff operation.
-		clipper.AddPaths(holes, ClipperLib::ptClip, true);
-		clipper.Execute(ClipperLib::ctDifference, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+		clipper->AddPaths(holes, ClipperLib::ptClip, true);
+		clipper->Execute(ClipperLib::ctDifference, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
 	}
 
 	return to_polygons(std::move(output));
@@ -1321,13 +1450,13 @@ ExPolygons variable_offset_inner_ex(const ExPolygon &expoly, const std::vector<s
         for (ClipperLib::Path &path : contours) 
             output.emplace_back(std::move(path));
     } else {
-        ClipperLib::Clipper clipper;
-        clipper.AddPaths(contours, ClipperLib::ptSubject, true);
+        PooledClipper clipper;
+        clipper->AddPaths(contours, ClipperLib::ptSubject, true);
         // Holes may contain holes in holes produced by expanding a C hole shape.
         // The situation is processed correctly by Clipper diff operation, producing concentric expolygons.
-        clipper.AddPaths(holes, ClipperLib::ptClip, true);
+        clipper->AddPaths(holes, ClipperLib::ptClip, true);
         ClipperLib::PolyTree polytree;
-        clipper.Execute(ClipperLib::ctDifference, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+        clipper->Execute(ClipperLib::ctDifference, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
         output = PolyTreeToExPolygons(std::move(polytree));
     }
 
@@ -1378,11 +1507,11 @@ Polygons variable_offset_outer(const ExPolygon &expoly, const std::vector<std::v
         output = std::move(contours);
     else {
         //FIXME the difference is not needed as the holes may never intersect with other holes.
-        ClipperLib::Clipper clipper;
-        clipper.Clear();
-        clipper.AddPaths(contours, ClipperLib::ptSubject, true);
-        clipper.AddPaths(holes, ClipperLib::ptClip, true);
-        clipper.Execute(ClipperLib::ctDifference, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+        PooledClipper clipper;
+        clipper->Clear();
+        clipper->AddPaths(contours, ClipperLib::ptSubject, true);
+        clipper->AddPaths(holes, ClipperLib::ptClip, true);
+        clipper->Execute(ClipperLib::ctDifference, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
     }
 
     return to_polygons(std::move(output));
@@ -1420,12 +1549,12 @@ ExPolygons variable_offset_outer_ex(const ExPolygon &expoly, const std::vector<s
         }
 	} else {
         //FIXME the difference is not needed as the holes may never intersect with other holes.
-		ClipperLib::Clipper clipper;
+		PooledClipper clipper;
         // Contours may have holes if they were created by closing a C shape.
-		clipper.AddPaths(contours, ClipperLib::ptSubject, true);
-		clipper.AddPaths(holes, ClipperLib::ptClip, true);
+		clipper->AddPaths(contours, ClipperLib::ptSubject, true);
+		clipper->AddPaths(holes, ClipperLib::ptClip, true);
 	    ClipperLib::PolyTree polytree;
-		clipper.Execute(ClipperLib::ctDifference, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+		clipper->Execute(ClipperLib::ctDifference, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
 	    output = PolyTreeToExPolygons(std::move(polytree));
 	}
 
@@ -10,6 +10,7 @@
 
 #include <assert.h>
 #include <cstddef>
+#include <functional>
 #include <iterator>
 #include <utility>
 #include <vector>
@@ -25,6 +26,8 @@
 #include "libslic3r/Polyline.hpp"
 #include "libslic3r/BoundingBox.hpp"
 
+#include <tcbspan/span.hpp>
+
 #ifdef SLIC3R_USE_CLIPPER2
 
 #include <clipper2.clipper.h>
@@ -628,6 +631,24 @@ void traverse_pt(const ClipperLib::PolyNodes &nodes, ExOrJustPolygons *retval)
 }
 
 
+/* BATCH */
+// Many independent polygon sets (islands, layers, objects) processed in parallel on the TBB worker pool.
+// fn(idx) is called for each idx in [0, count), possibly concurrently, thus fn shall only write to its own slot of the output.
+// Small batches are processed on the calling thread.
+void clipper_batch(size_t count, const std::function<void(size_t)> &fn);
+
+// out[i] is the result of the respective non-batched function applied to inputs[i].
+// The inputs are accessed through spans, they are not copied.
+std::vector<Slic3r::ExPolygons> offset_ex_batch(tcb::span<const Slic3r::ExPolygon> inputs, const float delta, ClipperLib::JoinType joinType = DefaultJoinType, double miterLimit = DefaultMiterLimit);
+std::vector<Slic3r::ExPolygons> offset_ex_batch(tcb::span<const Slic3r::ExPolygons> inputs, const float delta, ClipperLib::JoinType joinType = DefaultJoinType, double miterLimit = DefaultMiterLimit);
+std::vector<Slic3r::ExPolygons> union_ex_batch(tcb::span<const Slic3r::ExPolygons> inputs);
+// The same clipping polygons applied to all subjects.
+std::vector<Slic3r::ExPolygons> diff_ex_batch(tcb::span<const Slic3r::ExPolygons> subjects, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+std::vector<Slic3r::ExPolygons> intersection_ex_batch(tcb::span<const Slic3r::ExPolygons> subjects, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+// Pairwise, subjects[i] clipped by clips[i].
+std::vector<Slic3r::ExPolygons> diff_ex_batch(tcb::span<const Slic3r::ExPolygons> subjects, tcb::span<const Slic3r::ExPolygons> clips, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+std::vector<Slic3r::ExPolygons> intersection_ex_batch(tcb::span<const Slic3r::ExPolygons> subjects, tcb::span<const Slic3r::ExPolygons> clips, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+
 /* OTHER */
 Slic3r::Polygons simplify_polygons(const Slic3r::Polygons &subject);
 Slic3r::ExPolygons simplify_polygons_ex(const Slic3r::Polygons &subject);
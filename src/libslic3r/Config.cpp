@@ -40,6 +40,10 @@
 #include <set>
 #include <cstdlib>
 #include <cstring>
+#include <atomic>
+#include <mutex>
+#include <typeinfo>
+#include <unordered_set>
 
 #include "format.hpp"
 #include "Utils.hpp"
@@ -319,7 +323,8 @@ ConfigOptionDef* ConfigDef::add(const t_config_option_key &opt_key, ConfigOption
     opt->opt_key = opt_key;
     opt->type = type;
     opt->serialization_key_ordinal = ++ serialization_key_ordinal_last;
-    this->by_serialization_key_ordinal[opt->serialization_key_ordinal] = opt;
+    // Ordinals grow monotonically, thus the new entry always goes to the end of the map.
+    this->by_serialization_key_ordinal.emplace_hint(this->by_serialization_key_ordinal.end(), opt->serialization_key_ordinal, opt);
     return opt;
 }
 
@@ -1159,10 +1164,93 @@ void ConfigBase::null_nullables()
     }
 }
 
+const t_config_option_key* intern_config_option_key(const t_config_option_key &opt_key)
+{
+    // Nodes of std::unordered_set are not moved on rehashing.
+    static std::unordered_set<t_config_option_key> keys;
+    static std::mutex                              mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    return &*keys.insert(opt_key).first;
+}
+
+ConfigOption* DynamicConfig::Entry::mutable_option()
+{
+    if (m_opt.use_count() > 1)
+        m_opt.reset(m_opt->clone());
+    else
+        // Synchronize with the release of the value by another config in another thread.
+        std::atomic_thread_fence(std::memory_order_acquire);
+    m_shareable = false;
+    return m_opt.get();
+}
+
 DynamicConfig::DynamicConfig(const ConfigBase& rhs, const t_config_option_keys& keys)
 {
-	for (const t_config_option_key& opt_key : keys)
-		this->options[opt_key] = std::unique_ptr<ConfigOption>(rhs.option(opt_key)->clone());
+	for (const t_config_option_key& opt_key : keys) {
+        auto it = this->lower_bound(opt_key);
+        std::shared_ptr<ConfigOption> opt(rhs.option(opt_key)->clone());
+        if (it != this->options.end() && it->key() == opt_key)
+            it->m_opt = std::move(opt);
+        else
+            this->options.insert(it, Entry(intern_config_option_key(opt_key), std::move(opt), true));
+    }
+}
+
+// Merge the sorted options of rhs into the options of this config, calling
+// assign(Entry &dst, Entry &src) for the keys present in both.
+template<typename SrcEntry, typename Assign>
+static void merge_dynamic_options(std::vector<DynamicConfig::Entry> &dst, std::vector<SrcEntry> &&src, Assign assign)
+{
+    std::vector<DynamicConfig::Entry> out;
+    out.reserve(dst.size() + src.size());
+    auto i = dst.begin();
+    auto j = src.begin();
+    while (i != dst.end() && j != src.end())
+        if (i->key() < j->key())
+            out.emplace_back(std::move(*i ++));
+        else if (j->key() < i->key())
+            out.emplace_back(std::move(*j ++));
+        else {
+            assign(*i, *j);
+            out.emplace_back(std::move(*i ++));
+            ++ j;
+        }
+    std::move(i, dst.end(), std::back_inserter(out));
+    std::move(j, src.end(), std::back_inserter(out));
+    dst = std::move(out);
+}
+
+DynamicConfig& DynamicConfig::operator+=(const DynamicConfig &rhs)
+{
+    assert(this->def() == nullptr || this->def() == rhs.def());
+    if (this == &rhs)
+        return *this;
+    std::vector<Entry> src;
+    src.reserve(rhs.options.size());
+    for (const Entry &entry : rhs.options)
+        src.emplace_back(entry.copy());
+    merge_dynamic_options(this->options, std::move(src), [](Entry &dst, Entry &src) {
+        assert(dst.option()->type() == src.option()->type());
+        if (dst.m_opt.use_count() == 1 && dst.option()->type() == src.option()->type())
+            // A pointer to the value may be held by the user of this config, update the value in place.
+            dst.m_opt->set(src.option());
+        else
+            dst = std::move(src);
+    });
+    return *this;
+}
+
+DynamicConfig& DynamicConfig::operator+=(DynamicConfig &&rhs)
+{
+    assert(this->def() == nullptr || this->def() == rhs.def());
+    if (this == &rhs)
+        return *this;
+    merge_dynamic_options(this->options, std::move(rhs.options), [](Entry &dst, Entry &src) {
+        assert(dst.option()->type() == src.option()->type());
+        dst = std::move(src);
+    });
+    rhs.options.clear();
+    return *this;
 }
 
 bool DynamicConfig::operator==(const DynamicConfig &rhs) const
@@ -1172,7 +1260,7 @@ bool DynamicConfig::operator==(const DynamicConfig &rhs) const
     auto it2     = rhs.options.begin();
     auto it2_end = rhs.options.end();
     for (; it1 != it1_end && it2 != it2_end; ++ it1, ++ it2)
-		if (it1->first != it2->first || *it1->second != *it2->second)
+		if (it1->m_key != it2->m_key || (it1->m_opt != it2->m_opt && *it1->m_opt != *it2->m_opt))
 			// key or value differ
 			return false;
     return it1 == it1_end && it2 == it2_end;
@@ -1181,22 +1269,17 @@ bool DynamicConfig::operator==(const DynamicConfig &rhs) const
 // Remove options with all nil values, those are optional and it does not help to hold them.
 size_t DynamicConfig::remove_nil_options()
 {
-	size_t cnt_removed = 0;
-	for (auto it = options.begin(); it != options.end();)
-		if (it->second->is_nil()) {
-			it = options.erase(it);
-			++ cnt_removed;
-		} else
-			++ it;
-	return cnt_removed;
+	size_t cnt_old = options.size();
+	options.erase(std::remove_if(options.begin(), options.end(), [](const Entry &e) { return e.option()->is_nil(); }), options.end());
+	return cnt_old - options.size();
 }
 
 ConfigOption* DynamicConfig::optptr(const t_config_option_key &opt_key, bool create)
 {
-    auto it = options.find(opt_key);
-    if (it != options.end())
+    auto it = this->lower_bound(opt_key);
+    if (it != options.end() && it->key() == opt_key)
         // Option was found.
-        return it->second.get();
+        return it->mutable_option();
     if (! create)
         // Option was not found and a new option shall not be created.
         return nullptr;
@@ -1210,14 +1293,14 @@ ConfigOption* DynamicConfig::optptr(const t_config_option_key &opt_key, bool cre
         // Let the parent decide what to do if the opt_key is not defined by this->def().
         return nullptr;
     ConfigOption *opt = optdef->create_default_option();
-    this->options.emplace_hint(it, opt_key, std::unique_ptr<ConfigOption>(opt));
+    this->options.insert(it, Entry(intern_config_option_key(opt_key), std::shared_ptr<ConfigOption>(opt), false));
     return opt;
 }
 
 const ConfigOption* DynamicConfig::optptr(const t_config_option_key &opt_key) const
 {
-    auto it = options.find(opt_key);
-    return (it == options.end()) ? nullptr : it->second.get();
+    auto it = this->find(opt_key);
+    return (it == options.end()) ? nullptr : it->option();
 }
 
 bool DynamicConfig::read_cli(int argc, const char* const argv[], t_config_option_keys* extra, t_config_option_keys* keys)
@@ -1345,8 +1428,8 @@ t_config_option_keys DynamicConfig::keys() const
 {
     t_config_option_keys keys;
     keys.reserve(this->options.size());
-    for (const auto &opt : this->options)
-        keys.emplace_back(opt.first);
+    for (const Entry &entry : this->options)
+        keys.emplace_back(entry.key());
     return keys;
 }
 
@@ -1375,20 +1458,21 @@ t_config_option_keys StaticConfig::keys() const
 }
 
 // Iterate over the pairs of options with equal keys, call the fn.
+// The values shared by the two configs are passed to fn() as the same pointers.
 // Returns true on early exit by fn().
 template<typename Fn>
 static inline bool dynamic_config_iterate(const DynamicConfig &lhs, const DynamicConfig &rhs, Fn fn)
 {
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>>::const_iterator i = lhs.cbegin();
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>>::const_iterator j = rhs.cbegin();
+    DynamicConfig::const_iterator i = lhs.cbegin();
+    DynamicConfig::const_iterator j = rhs.cbegin();
     while (i != lhs.cend() && j != rhs.cend())
-        if (i->first < j->first)
+        if (i->key() < j->key())
             ++ i;
-        else if (i->first > j->first)
+        else if (i->key() > j->key())
             ++ j;
         else {
-            assert(i->first == j->first);
-            if (fn(i->first, i->second.get(), j->second.get()))
+            assert(i->key() == j->key());
+            if (fn(i->key(), i->option(), j->option()))
                 // Early exit by fn.
                 return true;
             ++ i;
@@ -1402,7 +1486,7 @@ static inline bool dynamic_config_iterate(const DynamicConfig &lhs, const Dynami
 bool DynamicConfig::equals(const DynamicConfig &other) const
 { 
     return ! dynamic_config_iterate(*this, other, 
-        [](const t_config_option_key & /* key */, const ConfigOption *l, const ConfigOption *r) { return *l != *r; });
+        [](const t_config_option_key & /* key */, const ConfigOption *l, const ConfigOption *r) { return l != r && *l != *r; });
 }
 
 // Returns options differing in the two configs, ignoring options not present in both configs.
@@ -1411,7 +1495,7 @@ t_config_option_keys DynamicConfig::diff(const DynamicConfig &other) const
     t_config_option_keys diff;
     dynamic_config_iterate(*this, other, 
         [&diff](const t_config_option_key &key, const ConfigOption *l, const ConfigOption *r) {
-            if (*l != *r)
+            if (l != r && *l != *r)
                 diff.emplace_back(key);
             // Continue iterating.
             return false; 
@@ -1425,7 +1509,7 @@ t_config_option_keys DynamicConfig::equal(const DynamicConfig &other) const
     t_config_option_keys equal;
     dynamic_config_iterate(*this, other, 
         [&equal](const t_config_option_key &key, const ConfigOption *l, const ConfigOption *r) {
-            if (*l == *r)
+            if (l == r || *l == *r)
                 equal.emplace_back(key);
             // Continue iterating.
             return false;
@@ -1433,6 +1517,28 @@ t_config_option_keys DynamicConfig::equal(const DynamicConfig &other) const
     return equal;
 }
 
+size_t DynamicConfig::share_equal_values(const DynamicConfig &other)
+{
+    size_t shared = 0;
+    auto   i      = this->options.begin();
+    auto   j      = other.options.cbegin();
+    while (i != this->options.end() && j != other.options.cend())
+        if (i->key() < j->key())
+            ++ i;
+        else if (j->key() < i->key())
+            ++ j;
+        else {
+            // Compare the dynamic types, as ConfigOptionEnum<T> and ConfigOptionEnumGeneric compare equal.
+            if (i->m_opt != j->m_opt && i->m_shareable && j->m_shareable && typeid(*i->m_opt) == typeid(*j->m_opt) && *i->m_opt == *j->m_opt) {
+                i->m_opt = j->m_opt;
+                ++ shared;
+            }
+            ++ i;
+            ++ j;
+        }
+    return shared;
+}
+
 }
 
 #include <cereal/types/polymorphic.hpp> // IWYU pragma: keep
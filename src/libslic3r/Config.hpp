@@ -2764,11 +2764,50 @@ private:
     bool set_deserialize_raw(const t_config_option_key& opt_key_src, const std::string& value, ConfigSubstitutionContext& substitutions, bool append);
 };
 
+// Returns a unique instance of the option key. The instances are never released,
+// thus two interned keys are equal if and only if their addresses are equal.
+// Thread safe.
+const t_config_option_key* intern_config_option_key(const t_config_option_key &opt_key);
+
 // Configuration store with dynamic number of configuration values.
 // In Slic3r, the dynamic config is mostly used at the user interface layer.
+//
+// The options are stored in a vector sorted by their keys. The keys are interned and the values
+// are shared between copies of a config until they are modified (copy-on-write), thus copying
+// a config does not allocate the options again. A value is only shared if no pointer for modification
+// of the value was handed out by the config, see DynamicConfig::Entry.
 class DynamicConfig : public virtual ConfigBase
 {
 public:
+    class Entry
+    {
+    public:
+        const t_config_option_key&  key()    const { return *m_key; }
+        const ConfigOption*         option() const { return m_opt.get(); }
+
+    private:
+        friend class DynamicConfig;
+
+        Entry() = default;
+        Entry(const t_config_option_key *key, std::shared_ptr<ConfigOption> opt, bool shareable) :
+            m_key(key), m_opt(std::move(opt)), m_shareable(shareable) {}
+
+        // Entry of a copy of the config owning this entry.
+        Entry copy() const { return m_shareable ? *this : Entry(m_key, std::shared_ptr<ConfigOption>(m_opt->clone()), true); }
+
+        // Makes sure m_opt is not shared with another config before it is modified.
+        ConfigOption* mutable_option();
+
+        const t_config_option_key      *m_key { nullptr };
+        std::shared_ptr<ConfigOption>   m_opt;
+        // False if a pointer to a modifiable m_opt was handed out to the user of the config. Such a value
+        // could be modified at any time, therefore it is cloned when the config is copied.
+        // If m_shareable is false, m_opt is not shared.
+        bool                            m_shareable { true };
+    };
+
+    using const_iterator = std::vector<Entry>::const_iterator;
+
     DynamicConfig() = default;
     DynamicConfig(const DynamicConfig &rhs) { *this = rhs; }
     DynamicConfig(DynamicConfig &&rhs) noexcept : options(std::move(rhs.options)) { rhs.options.clear(); }
@@ -2781,9 +2820,12 @@ public:
     DynamicConfig& operator=(const DynamicConfig &rhs) 
     {
         assert(this->def() == nullptr || this->def() == rhs.def());
-        this->clear();
-        for (const auto &kvp : rhs.options)
-            this->options[kvp.first].reset(kvp.second->clone());
+        if (this != &rhs) {
+            this->clear();
+            this->options.reserve(rhs.options.size());
+            for (const Entry &entry : rhs.options)
+                this->options.emplace_back(entry.copy());
+        }
         return *this;
     }
 
@@ -2800,41 +2842,11 @@ public:
 
     // Add a content of one DynamicConfig to another DynamicConfig.
     // If rhs.def() is not null, then it has to be equal to this->def().
-    DynamicConfig& operator+=(const DynamicConfig &rhs)
-    {
-        assert(this->def() == nullptr || this->def() == rhs.def());
-        for (const auto &kvp : rhs.options) {
-            auto it = this->options.find(kvp.first);
-            if (it == this->options.end())
-                this->options[kvp.first].reset(kvp.second->clone());
-            else {
-                assert(it->second->type() == kvp.second->type());
-                if (it->second->type() == kvp.second->type())
-                    *it->second = *kvp.second;
-                else
-                    it->second.reset(kvp.second->clone());
-            }
-        }
-        return *this;
-    }
+    DynamicConfig& operator+=(const DynamicConfig &rhs);
 
     // Move a content of one DynamicConfig to another DynamicConfig.
     // If rhs.def() is not null, then it has to be equal to this->def().
-    DynamicConfig& operator+=(DynamicConfig &&rhs) 
-    {
-        assert(this->def() == nullptr || this->def() == rhs.def());
-        for (auto &kvp : rhs.options) {
-            auto it = this->options.find(kvp.first);
-            if (it == this->options.end()) {
-                this->options.insert(std::make_pair(kvp.first, std::move(kvp.second)));
-            } else {
-                assert(it->second->type() == kvp.second->type());
-                it->second = std::move(kvp.second);
-            }
-        }
-        rhs.options.clear();
-        return *this;
-    }
+    DynamicConfig& operator+=(DynamicConfig &&rhs);
 
     bool           operator==(const DynamicConfig &rhs) const;
     bool           operator!=(const DynamicConfig &rhs) const { return ! (*this == rhs); }
@@ -2851,7 +2863,7 @@ public:
 
     bool erase(const t_config_option_key &opt_key)
     { 
-        auto it = this->options.find(opt_key);
+        auto it = this->find(opt_key);
         if (it == this->options.end())
             return false;
         this->options.erase(it);
@@ -2877,12 +2889,13 @@ public:
     // Be careful, as this method does not test the existence of opt_key in this->def().
     bool                    set_key_value(const std::string &opt_key, ConfigOption *opt)
     {
-        auto it = this->options.find(opt_key);
-        if (it == this->options.end()) {
-            this->options[opt_key].reset(opt);
+        auto it = this->lower_bound(opt_key);
+        if (it == this->options.end() || it->key() != opt_key) {
+            this->options.insert(it, Entry(intern_config_option_key(opt_key), std::shared_ptr<ConfigOption>(opt), false));
             return true;
         } else {
-            it->second.reset(opt);
+            it->m_opt.reset(opt);
+            it->m_shareable = false;
             return false;
         }
     }
@@ -2893,19 +2906,50 @@ public:
     t_config_option_keys diff(const DynamicConfig &other) const;
     // Returns options being equal in the two configs, ignoring options not present in both configs.
     t_config_option_keys equal(const DynamicConfig &other) const;
+    // Make the values of this config equal to the values of other share the storage with other.
+    // Values handed out for modification by either of the two configs are left untouched.
+    // Returns the number of values shared.
+    size_t               share_equal_values(const DynamicConfig &other);
 
     // Command line processing
     bool                read_cli(int argc, const char* const argv[], t_config_option_keys* extra, t_config_option_keys* keys = nullptr);
 
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>>::const_iterator cbegin() const { return options.cbegin(); }
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>>::const_iterator cend()   const { return options.cend(); }
-    size_t                        												 size()   const { return options.size(); }
+    // Iteration over the options sorted by their keys.
+    const_iterator      cbegin() const { return options.cbegin(); }
+    const_iterator      cend()   const { return options.cend(); }
+    size_t              size()   const { return options.size(); }
 
 private:
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>> options;
+    std::vector<Entry>::iterator lower_bound(const t_config_option_key &opt_key)
+        { return std::lower_bound(options.begin(), options.end(), opt_key, [](const Entry &e, const t_config_option_key &k) { return e.key() < k; }); }
+    std::vector<Entry>::const_iterator lower_bound(const t_config_option_key &opt_key) const
+        { return const_cast<DynamicConfig*>(this)->lower_bound(opt_key); }
+    std::vector<Entry>::iterator find(const t_config_option_key &opt_key)
+        { auto it = this->lower_bound(opt_key); return it != options.end() && it->key() == opt_key ? it : options.end(); }
+    std::vector<Entry>::const_iterator find(const t_config_option_key &opt_key) const
+        { return const_cast<DynamicConfig*>(this)->find(opt_key); }
+
+    std::vector<Entry> options;
 
 	friend class cereal::access;
-	template<class Archive> void serialize(Archive &ar) { ar(options); }
+	template<class Archive> void serialize(Archive &ar) {
+        size_t cnt = options.size();
+        ar(cnt);
+        if constexpr (Archive::is_loading::value) {
+            this->clear();
+            this->options.reserve(cnt);
+            for (size_t i = 0; i < cnt; ++ i) {
+                t_config_option_key           opt_key;
+                std::shared_ptr<ConfigOption> opt;
+                ar(opt_key, opt);
+                assert(this->options.empty() || this->options.back().key() < opt_key);
+                this->options.emplace_back(Entry(intern_config_option_key(opt_key), std::move(opt), true));
+            }
+        } else {
+            for (const Entry &entry : options)
+                ar(entry.key(), entry.m_opt);
+        }
+    }
 };
 
 // Configuration store with a static definition of configuration values.
@@ -573,21 +573,25 @@ SurfaceCut Slic3r::cut_surface(const ExPolygons &shapes,
 
     // for filttrate opposite triangles and a little more
     const float max_angle = 89.9f;
-    priv::CutMeshes cgal_models; // source for patch
-    priv::CutMeshes cgal_neg_models; // model used for differenciate patches
-    cgal_models.reserve(models.size());
-    for (const indexed_triangle_set &its : models) {
-        std::vector<bool> skip_indicies(its.indices.size(), {false});
-        priv::set_skip_for_out_of_aoi(skip_indicies, its, projection, shapes_bb);
-
-        // create model for differenciate cutted patches
-        bool flip = true;
-        cgal_neg_models.push_back(priv::to_cgal(its, skip_indicies, flip));
-        
-        // cut out more than only opposit triangles 
-        priv::set_skip_by_angle(skip_indicies, its, projection, max_angle);
-        cgal_models.push_back(priv::to_cgal(its, skip_indicies));
-    }
+    priv::CutMeshes cgal_models(models.size()); // source for patch
+    priv::CutMeshes cgal_neg_models(models.size()); // model used for differenciate patches
+    // models are converted independently
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, models.size()),
+    [&models, &projection, &shapes_bb, &max_angle, &cgal_models, &cgal_neg_models](const tbb::blocked_range<size_t> &range) {
+        for (size_t model_index = range.begin(); model_index < range.end(); ++model_index) {
+            const indexed_triangle_set &its = models[model_index];
+            std::vector<bool> skip_indicies(its.indices.size(), {false});
+            priv::set_skip_for_out_of_aoi(skip_indicies, its, projection, shapes_bb);
+
+            // create model for differenciate cutted patches
+            bool flip = true;
+            cgal_neg_models[model_index] = priv::to_cgal(its, skip_indicies, flip);
+
+            // cut out more than only opposit triangles 
+            priv::set_skip_by_angle(skip_indicies, its, projection, max_angle);
+            cgal_models[model_index] = priv::to_cgal(its, skip_indicies);
+        }
+    }); // END parallel for
 #ifdef DEBUG_OUTPUT_DIR
     priv::store(cgal_models, DEBUG_OUTPUT_DIR + "model/");// model[0-N].off
     priv::store(cgal_neg_models, DEBUG_OUTPUT_DIR + "model_neg/"); // model[0-N].off
@@ -600,17 +604,22 @@ SurfaceCut Slic3r::cut_surface(const ExPolygons &shapes,
 
     // create tool for convert index to shape Point adress and vice versa
     ExPolygonsIndices s2i(shapes);
-    priv::VCutAOIs model_cuts;
+    priv::VCutAOIs model_cuts(cgal_models.size());
+    // Corefine is not allowed to share shape mesh between threads, so each other model is cut by its own copy.
+    // NOTE: Copies have to live till the end, cutted models point into theirs property maps (vert_shape_map)
+    priv::CutMeshes cgal_shape_copies(cgal_models.size() - 1, cgal_shape);
     // cut shape from each cgal model
-    for (priv::CutMesh &cgal_model : cgal_models) { 
-        priv::CutAOIs cutAOIs = priv::cut_from_model(
-            cgal_model, shapes, cgal_shape, projection_ratio, s2i);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, cgal_models.size()),
+    [&cgal_models, &cgal_shape, &cgal_shape_copies, &shapes, &projection_ratio, &s2i, &model_cuts](const tbb::blocked_range<size_t> &range) {
+        for (size_t model_index = range.begin(); model_index < range.end(); ++model_index) {
+            priv::CutMesh &cgal_model = cgal_models[model_index];
+            priv::CutMesh &shape_mesh = (model_index == 0) ? cgal_shape : cgal_shape_copies[model_index - 1];
+            model_cuts[model_index] = priv::cut_from_model(cgal_model, shapes, shape_mesh, projection_ratio, s2i);
 #ifdef DEBUG_OUTPUT_DIR
-        size_t index = &cgal_model - &cgal_models.front();
-        priv::store(cutAOIs, cgal_model, DEBUG_OUTPUT_DIR + "model_AOIs/" + std::to_string(index) + "/"); // only debug
+            priv::store(model_cuts[model_index], cgal_model, DEBUG_OUTPUT_DIR + "model_AOIs/" + std::to_string(model_index) + "/"); // only debug
 #endif // DEBUG_OUTPUT_DIR
-        model_cuts.push_back(std::move(cutAOIs));
-    }
+        }
+    }); // END parallel for
 
     priv::SurfacePatches patches = priv::diff_models(model_cuts, cgal_models, cgal_neg_models, projection);
 #ifdef DEBUG_OUTPUT_DIR
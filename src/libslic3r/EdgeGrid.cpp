@@ -19,6 +19,10 @@
 #include "libslic3r/ExPolygon.hpp"
 #include "libslic3r/Point.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
 // #define EDGE_GRID_DEBUG_OUTPUT
 
 #if 0
@@ -163,177 +167,143 @@ void EdgeGrid::Grid::create_from_m_contours(coord_t resolution)
 	m_resolution = resolution;
 	m_cols = (m_bbox.max(0) - m_bbox.min(0) + m_resolution - 1) / m_resolution;
 	m_rows = (m_bbox.max(1) - m_bbox.min(1) + m_resolution - 1) / m_resolution;
-	m_cells.assign(m_rows * m_cols, Cell());
-
-	// 3) First round of contour rasterization, count the edges per grid cell.
-	for (size_t i = 0; i < m_contours.size(); ++ i) {
-		const Contour &contour = m_contours[i];
-		for (size_t j = 0; j < contour.num_segments(); ++ j) {
-			// End points of the line segment.
-			Slic3r::Point p1(contour.segment_start(j));
-			Slic3r::Point p2(contour.segment_end(j));
-			p1(0) -= m_bbox.min(0);
-			p1(1) -= m_bbox.min(1);
-			p2(0) -= m_bbox.min(0);
-			p2(1) -= m_bbox.min(1);
-		   	// Get the cells of the end points.
-		    coord_t ix    = p1(0) / m_resolution;
-		    coord_t iy    = p1(1) / m_resolution;
-		    coord_t ixb   = p2(0) / m_resolution;
-		    coord_t iyb   = p2(1) / m_resolution;
-			assert(ix >= 0 && size_t(ix) < m_cols);
-			assert(iy >= 0 && size_t(iy) < m_rows);
-			assert(ixb >= 0 && size_t(ixb) < m_cols);
-			assert(iyb >= 0 && size_t(iyb) < m_rows);
-			// Account for the end points.
-			++ m_cells[iy*m_cols+ix].end;
-			if (ix == ixb && iy == iyb)
-				// Both ends fall into the same cell.
-				continue;
-		    // Raster the centeral part of the line.
-			coord_t dx = std::abs(p2(0) - p1(0));
-			coord_t dy = std::abs(p2(1) - p1(1));
-			if (p1(0) < p2(0)) {
-				int64_t ex = int64_t((ix + 1)*m_resolution - p1(0)) * int64_t(dy);
-				if (p1(1) < p2(1)) {
-					// x positive, y positive
-					int64_t ey = int64_t((iy + 1)*m_resolution - p1(1)) * int64_t(dx);
-					do {
-						assert(ix <= ixb && iy <= iyb);
-						if (ex < ey) {
-							ey -= ex;
-							ex = int64_t(dy) * m_resolution;
-							ix += 1;
-						}
-						else if (ex == ey) {
-							ex = int64_t(dy) * m_resolution;
-							ey = int64_t(dx) * m_resolution;
-							ix += 1;
-							iy += 1;
-						}
-						else {
-							assert(ex > ey);
-							ex -= ey;
-							ey = int64_t(dx) * m_resolution;
-							iy += 1;
-						}
-						++m_cells[iy*m_cols + ix].end;
-					} while (ix != ixb || iy != iyb);
-				}
-				else {
-					// x positive, y non positive
-					int64_t ey = int64_t(p1(1) - iy*m_resolution) * int64_t(dx);
-					do {
-						assert(ix <= ixb && iy >= iyb);
-						if (ex <= ey) {
-							ey -= ex;
-							ex = int64_t(dy) * m_resolution;
-							ix += 1;
-						}
-						else {
-							ex -= ey;
-							ey = int64_t(dx) * m_resolution;
-							iy -= 1;
-						}
-						++m_cells[iy*m_cols + ix].end;
-					} while (ix != ixb || iy != iyb);
+
+	const size_t num_cells = m_rows * m_cols;
+	// The sparse storage is used if the dense grid would have many more cells than the cells crossed by the contours.
+	// The dense grid cells are cheap to look up, thus the sparse storage is only chosen for large, mostly empty grids.
+	static constexpr const size_t sparse_min_cells = 1 << 16;
+	static constexpr const size_t sparse_min_ratio = 16;
+	// The segments are rasterized in chunks in parallel.
+	static constexpr const size_t segments_per_chunk = 4096;
+
+	size_t num_segments = 0;
+	for (const Contour &contour : m_contours)
+		num_segments += contour.num_segments();
+
+	// Prefix sum the numbers of hits per cells to get an index into m_cell_data, allocate m_cell_data.
+	auto allocate_cell_data = [this]() {
+		size_t cnt = m_cells.front().end;
+		for (size_t i = 1; i < m_cells.size(); ++ i) {
+			m_cells[i].begin = cnt;
+			cnt += m_cells[i].end;
+			m_cells[i].end = cnt;
+		}
+		m_cell_data.assign(cnt, std::pair<size_t, size_t>(size_t(-1), size_t(-1)));
+		for (size_t i = 0; i < m_cells.size(); ++i)
+			m_cells[i].end = m_cells[i].begin;
+	};
+
+	m_sparse_cols.clear();
+	m_sparse_rows.clear();
+
+	if (num_segments <= segments_per_chunk && 
+		(m_cell_storage == CellStorage::Dense || (m_cell_storage == CellStorage::Automatic && num_cells <= sparse_min_cells))) {
+		// 3) A small dense grid: Rasterize the contours twice, first count the edges per grid cell, then fill in m_cell_data,
+		// which is cheaper than storing the cells crossed by the segments.
+		m_sparse = false;
+		m_cells.assign(num_cells, Cell());
+		auto rasterize = [this](auto &&fn) {
+			for (size_t i = 0; i < m_contours.size(); ++ i) {
+				const Contour &contour = m_contours[i];
+				for (size_t j = 0; j < contour.num_segments(); ++ j) {
+					auto visitor = [this, &fn, i, j](coord_t iy, coord_t ix) {
+						fn(m_cells[iy * m_cols + ix], std::pair<size_t, size_t>(i, j));
+						// Continue traversing the grid along the edge.
+						return true;
+					};
+					this->visit_cells_intersecting_line(contour.segment_start(j), contour.segment_end(j), visitor);
 				}
 			}
-			else {
-				int64_t ex = int64_t(p1(0) - ix*m_resolution) * int64_t(dy);
-				if (p1(1) < p2(1)) {
-					// x non positive, y positive
-					int64_t ey = int64_t((iy + 1)*m_resolution - p1(1)) * int64_t(dx);
-					do {
-						assert(ix >= ixb && iy <= iyb);
-						if (ex < ey) {
-							ey -= ex;
-							ex = int64_t(dy) * m_resolution;
-							ix -= 1;
-						}
-						else {
-							assert(ex >= ey);
-							ex -= ey;
-							ey = int64_t(dx) * m_resolution;
-							iy += 1;
-						}
-						++m_cells[iy*m_cols + ix].end;
-					} while (ix != ixb || iy != iyb);
-				}
-				else {
-					// x non positive, y non positive
-					int64_t ey = int64_t(p1(1) - iy*m_resolution) * int64_t(dx);
-					do {
-						assert(ix >= ixb && iy >= iyb);
-						if (ex < ey) {
-							ey -= ex;
-							ex = int64_t(dy) * m_resolution;
-							ix -= 1;
-						}
-						else if (ex == ey) {
-							// The lower edge of a grid cell belongs to the cell.
-							// Handle the case where the ray may cross the lower left corner of a cell in a general case,
-							// or a left or lower edge in a degenerate case (horizontal or vertical line).
-							if (dx > 0) {
-								ex = int64_t(dy) * m_resolution;
-								ix -= 1;
-							}
-							if (dy > 0) {
-								ey = int64_t(dx) * m_resolution;
-								iy -= 1;
-							}
-						}
-						else {
-							assert(ex > ey);
-							ex -= ey;
-							ey = int64_t(dx) * m_resolution;
-							iy -= 1;
-						}
-						++m_cells[iy*m_cols + ix].end;
-					} while (ix != ixb || iy != iyb);
+		};
+		rasterize([](Cell &cell, const std::pair<size_t, size_t> &) { ++ cell.end; });
+		allocate_cell_data();
+		rasterize([this](Cell &cell, const std::pair<size_t, size_t> &contour_and_segment) { m_cell_data[cell.end ++] = contour_and_segment; });
+		return;
+	}
+
+	// 3) Rasterize the contours, collect the cells crossed by the segments.
+	// The segments are split into chunks rasterized in parallel, the chunks are then merged in their order,
+	// thus the order of the segments in a cell is the same as if rasterized sequentially.
+	struct Hit {
+		// Index of the cell (row * m_cols + col), replaced by an index into m_cells once the cells are allocated.
+		size_t 					 cell;
+		std::pair<size_t, size_t> contour_and_segment;
+	};
+	// Index of the first segment of a contour, all the segments are indexed continuously over all the contours.
+	std::vector<size_t> contour_first_segment;
+	contour_first_segment.reserve(m_contours.size() + 1);
+	contour_first_segment.emplace_back(0);
+	for (const Contour &contour : m_contours)
+		contour_first_segment.emplace_back(contour_first_segment.back() + contour.num_segments());
+	std::vector<std::vector<Hit>> chunks((num_segments + segments_per_chunk - 1) / segments_per_chunk);
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size(), 1), [this, &contour_first_segment, &chunks, num_segments](const tbb::blocked_range<size_t> &range) {
+		for (size_t ichunk = range.begin(); ichunk < range.end(); ++ ichunk) {
+			const size_t      first = ichunk * segments_per_chunk;
+			const size_t      last  = std::min(first + segments_per_chunk, num_segments);
+			std::vector<Hit> &hits  = chunks[ichunk];
+			hits.reserve(2 * (last - first));
+			// Find the contour of the first segment of this chunk.
+			size_t icontour = std::upper_bound(contour_first_segment.begin(), contour_first_segment.end(), first) - contour_first_segment.begin() - 1;
+			for (size_t iseg = first; iseg < last; ++ icontour) {
+				const Contour &contour = m_contours[icontour];
+				for (size_t j = iseg - contour_first_segment[icontour]; j < contour.num_segments() && iseg < last; ++ j, ++ iseg) {
+					auto visitor = [this, &hits, icontour, j](coord_t iy, coord_t ix) {
+						hits.push_back({ size_t(iy) * m_cols + size_t(ix), { icontour, j } });
+						// Continue traversing the grid along the edge.
+						return true;
+					};
+					this->visit_cells_intersecting_line(contour.segment_start(j), contour.segment_end(j), visitor);
 				}
 			}
 		}
-	}
-
-	// 4) Prefix sum the numbers of hits per cells to get an index into m_cell_data.
-	size_t cnt = m_cells.front().end;
-	for (size_t i = 1; i < m_cells.size(); ++ i) {
-		m_cells[i].begin = cnt;
-		cnt += m_cells[i].end;
-		m_cells[i].end = cnt;
-	}
-
-	// 5) Allocate the cell data.
-	m_cell_data.assign(cnt, std::pair<size_t, size_t>(size_t(-1), size_t(-1)));
-
-	// 6) Finally fill in m_cell_data by rasterizing the lines once again.
-	for (size_t i = 0; i < m_cells.size(); ++i)
-		m_cells[i].end = m_cells[i].begin;
-
-	struct Visitor {
-		Visitor(std::vector<std::pair<size_t, size_t>> &cell_data, std::vector<Cell> &cells, size_t cols) :
-			cell_data(cell_data), cells(cells), cols(cols), i(0), j(0) {}
-
-		inline bool operator()(coord_t iy, coord_t ix) {
-			cell_data[cells[iy*cols + ix].end++] = std::pair<size_t, size_t>(i, j);
-			// Continue traversing the grid along the edge.
-			return true;
+	});
+
+	size_t num_hits = 0;
+	for (const std::vector<Hit> &hits : chunks)
+		num_hits += hits.size();
+
+	// 4) Allocate the cells and count the edges per grid cell.
+	m_sparse = m_cell_storage == CellStorage::Sparse ||
+		(m_cell_storage == CellStorage::Automatic && num_cells > sparse_min_cells && num_cells > sparse_min_ratio * num_hits);
+	if (m_sparse) {
+		// Sorted indices of the cells crossed by the contours.
+		std::vector<size_t> occupied;
+		occupied.reserve(num_hits);
+		for (const std::vector<Hit> &hits : chunks)
+			for (const Hit &hit : hits)
+				occupied.emplace_back(hit.cell);
+		tbb::parallel_sort(occupied.begin(), occupied.end());
+		occupied.erase(std::unique(occupied.begin(), occupied.end()), occupied.end());
+		m_sparse_cols.reserve(occupied.size());
+		m_sparse_rows.assign(m_rows + 1, 0);
+		for (size_t cell_idx : occupied) {
+			m_sparse_cols.emplace_back(coord_t(cell_idx % m_cols));
+			++ m_sparse_rows[cell_idx / m_cols + 1];
 		}
-
-		std::vector<std::pair<size_t, size_t>> &cell_data;
-		std::vector<Cell> 					   &cells;
-		size_t									cols;
-		size_t 									i;
-		size_t 									j;
-	} visitor(m_cell_data, m_cells, m_cols);
-
-	assert(visitor.i == 0);
-	for (; visitor.i < m_contours.size(); ++ visitor.i) {
-		const Contour &contour = m_contours[visitor.i];
-		for (visitor.j = 0; visitor.j < contour.num_segments(); ++ visitor.j)
-			this->visit_cells_intersecting_line(contour.segment_start(visitor.j), contour.segment_end(visitor.j), visitor);
-	}
+		for (size_t r = 0; r < m_rows; ++ r)
+			m_sparse_rows[r + 1] += m_sparse_rows[r];
+		// Replace the cell indices of the hits with indices into m_cells.
+		// The first cell is the empty cell of all the cells not crossed by the contours.
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size(), 1), [&chunks, &occupied](const tbb::blocked_range<size_t> &range) {
+			for (size_t ichunk = range.begin(); ichunk < range.end(); ++ ichunk)
+				for (Hit &hit : chunks[ichunk])
+					hit.cell = std::lower_bound(occupied.begin(), occupied.end(), hit.cell) - occupied.begin() + 1;
+		});
+		m_cells.assign(occupied.size() + 1, Cell());
+	} else
+		m_cells.assign(num_cells, Cell());
+	for (const std::vector<Hit> &hits : chunks)
+		for (const Hit &hit : hits)
+			++ m_cells[hit.cell].end;
+
+	// 5) Prefix sum the numbers of hits per cells, allocate the cell data.
+	allocate_cell_data();
+	assert(m_cell_data.size() == num_hits);
+
+	// 6) Finally fill in m_cell_data from the rasterized segments.
+	for (const std::vector<Hit> &hits : chunks)
+		for (const Hit &hit : hits)
+			m_cell_data[m_cells[hit.cell].end ++] = hit.contour_and_segment;
 }
 
 #if 0
@@ -694,8 +664,9 @@ void EdgeGrid::Grid::calculate_sdf()
 	m_signed_distance_field.assign(nrows * ncols, search_radius);
 	// For each cell:
 	for (int r = 0; r < (int)m_rows; ++ r) {
-		for (int c = 0; c < (int)m_cols; ++ c) {
-			const Cell &cell = m_cells[r * m_cols + c];
+		for (RowCells row = this->row_cells(r, 0, coord_t(m_cols) - 1); row.next();) {
+			const int   c    = row.col;
+			const Cell &cell = *row.cell;
 			// For each segment in the cell:
 			for (size_t i = cell.begin; i != cell.end; ++ i) {
 				const Contour &contour = m_contours[m_cell_data[i].first];
@@ -1083,8 +1054,8 @@ EdgeGrid::Grid::ClosestPointResult EdgeGrid::Grid::closest_point_signed_distance
 	int sign_min = 0;
 	double l2_seg_min = 1.;
 	for (int r = bbox.min(1); r <= bbox.max(1); ++ r) {
-		for (int c = bbox.min(0); c <= bbox.max(0); ++ c) {
-			const Cell &cell = m_cells[r * m_cols + c];
+		for (RowCells row = this->row_cells(r, bbox.min(0), bbox.max(0)); row.next();) {
+			const Cell &cell = *row.cell;
 			for (size_t i = cell.begin; i < cell.end; ++ i) {
 				const size_t   contour_idx = m_cell_data[i].first;
 				const Contour &contour     = m_contours[contour_idx];
@@ -1213,8 +1184,8 @@ bool EdgeGrid::Grid::signed_distance_edges(const Point &pt, coord_t search_radiu
 	int sign_min = 0;
 	bool on_segment = false;
 	for (int r = bbox.min(1); r <= bbox.max(1); ++ r) {
-		for (int c = bbox.min(0); c <= bbox.max(0); ++ c) {
-			const Cell &cell = m_cells[r * m_cols + c];
+		for (RowCells row = this->row_cells(r, bbox.min(0), bbox.max(0)); row.next();) {
+			const Cell &cell = *row.cell;
 			for (size_t i = cell.begin; i < cell.end; ++ i) {
 				const Contour &contour = m_contours[m_cell_data[i].first];
 				assert(contour.closed());
@@ -1417,33 +1388,30 @@ Polygons EdgeGrid::Grid::contours_simplified(coord_t offset, bool fill_holes) co
 std::vector<std::pair<EdgeGrid::Grid::ContourEdge, EdgeGrid::Grid::ContourEdge>> EdgeGrid::Grid::intersecting_edges() const
 {
 	std::vector<std::pair<ContourEdge, ContourEdge>> out;
-	// For each cell:
-	for (int r = 0; r < (int)m_rows; ++ r) {
-		for (int c = 0; c < (int)m_cols; ++ c) {
-			const Cell &cell = m_cells[r * m_cols + c];
-			// For each pair of segments in the cell:
-			for (size_t i = cell.begin; i != cell.end; ++ i) {
-				const Contour &icontour = m_contours[m_cell_data[i].first];
-				size_t ipt = m_cell_data[i].second;
+	// For each stored cell, the sparse storage omits the empty cells:
+	for (const Cell &cell : m_cells) {
+		// For each pair of segments in the cell:
+		for (size_t i = cell.begin; i != cell.end; ++ i) {
+			const Contour &icontour = m_contours[m_cell_data[i].first];
+			size_t ipt = m_cell_data[i].second;
+			// End points of the line segment and their vector.
+			const Slic3r::Point &ip1 = icontour.segment_start(ipt);
+			const Slic3r::Point &ip2 = icontour.segment_end(ipt);
+			for (size_t j = i + 1; j != cell.end; ++ j) {
+				const Contour   &jcontour = m_contours[m_cell_data[j].first];
+				size_t 				  jpt = m_cell_data[j].second;
 				// End points of the line segment and their vector.
-				const Slic3r::Point &ip1 = icontour.segment_start(ipt);
-				const Slic3r::Point &ip2 = icontour.segment_end(ipt);
-				for (size_t j = i + 1; j != cell.end; ++ j) {
-					const Contour   &jcontour = m_contours[m_cell_data[j].first];
-					size_t 				  jpt = m_cell_data[j].second;
-					// End points of the line segment and their vector.
-					const Slic3r::Point  &jp1 = jcontour.segment_start(jpt);
-					const Slic3r::Point  &jp2 = jcontour.segment_end(jpt);
-					if (&icontour == &jcontour && (&ip1 == &jp2 || &jp1 == &ip2))
-						// Segments of the same contour share a common vertex.
-						continue;
-					if (Geometry::segments_intersect(ip1, ip2, jp1, jp2)) {
-						// The two segments intersect. Add them to the output.
-						int jfirst = (&jcontour < &icontour) || (&jcontour == &icontour && jpt < ipt);
-						out.emplace_back(jfirst ? 
-							std::make_pair(std::make_pair(&icontour, ipt), std::make_pair(&jcontour, jpt)) : 
-							std::make_pair(std::make_pair(&icontour, ipt), std::make_pair(&jcontour, jpt)));
-					}
+				const Slic3r::Point  &jp1 = jcontour.segment_start(jpt);
+				const Slic3r::Point  &jp2 = jcontour.segment_end(jpt);
+				if (&icontour == &jcontour && (&ip1 == &jp2 || &jp1 == &ip2))
+					// Segments of the same contour share a common vertex.
+					continue;
+				if (Geometry::segments_intersect(ip1, ip2, jp1, jp2)) {
+					// The two segments intersect. Add them to the output.
+					int jfirst = (&jcontour < &icontour) || (&jcontour == &icontour && jpt < ipt);
+					out.emplace_back(jfirst ? 
+						std::make_pair(std::make_pair(&icontour, ipt), std::make_pair(&jcontour, jpt)) : 
+						std::make_pair(std::make_pair(&icontour, ipt), std::make_pair(&jcontour, jpt)));
 				}
 			}
 		}
@@ -1454,27 +1422,24 @@ std::vector<std::pair<EdgeGrid::Grid::ContourEdge, EdgeGrid::Grid::ContourEdge>>
 
 bool EdgeGrid::Grid::has_intersecting_edges() const
 {
-	// For each cell:
-	for (int r = 0; r < (int)m_rows; ++ r) {
-		for (int c = 0; c < (int)m_cols; ++ c) {
-			const Cell &cell = m_cells[r * m_cols + c];
-			// For each pair of segments in the cell:
-			for (size_t i = cell.begin; i != cell.end; ++ i) {
-				const Contour &icontour = m_contours[m_cell_data[i].first];
-				size_t ipt = m_cell_data[i].second;
+	// For each stored cell, the sparse storage omits the empty cells:
+	for (const Cell &cell : m_cells) {
+		// For each pair of segments in the cell:
+		for (size_t i = cell.begin; i != cell.end; ++ i) {
+			const Contour &icontour = m_contours[m_cell_data[i].first];
+			size_t ipt = m_cell_data[i].second;
+			// End points of the line segment and their vector.
+			const Slic3r::Point &ip1 = icontour.segment_start(ipt);
+			const Slic3r::Point &ip2 = icontour.segment_end(ipt);
+			for (size_t j = i + 1; j != cell.end; ++ j) {
+				const Contour    &jcontour = m_contours[m_cell_data[j].first];
+				size_t 				  jpt  = m_cell_data[j].second;
 				// End points of the line segment and their vector.
-				const Slic3r::Point &ip1 = icontour.segment_start(ipt);
-				const Slic3r::Point &ip2 = icontour.segment_end(ipt);
-				for (size_t j = i + 1; j != cell.end; ++ j) {
-					const Contour    &jcontour = m_contours[m_cell_data[j].first];
-					size_t 				  jpt  = m_cell_data[j].second;
-					// End points of the line segment and their vector.
-					const Slic3r::Point  &jp1  = jcontour.segment_start(jpt);
-					const Slic3r::Point  &jp2  = jcontour.segment_end(jpt);
-					if (! (&icontour == &jcontour && (&ip1 == &jp2 || &jp1 == &ip2)) && 
-						Geometry::segments_intersect(ip1, ip2, jp1, jp2))
-						return true;
-				}
+				const Slic3r::Point  &jp1  = jcontour.segment_start(jpt);
+				const Slic3r::Point  &jp2  = jcontour.segment_end(jpt);
+				if (! (&icontour == &jcontour && (&ip1 == &jp2 || &jp1 == &ip2)) && 
+					Geometry::segments_intersect(ip1, ip2, jp1, jp2))
+					return true;
 			}
 		}
 	}
@@ -115,6 +115,19 @@ public:
 
 	void set_bbox(const BoundingBox &bbox) { m_bbox = bbox; }
 
+	// Storage of the grid cells. The dense storage allocates all the cells of the bounding box,
+	// its memory grows with the bounding box area. The sparse storage only allocates the cells
+	// crossed by the contours, its memory grows with the contour length, though the cell lookup is slower.
+	enum class CellStorage {
+		// Sparse if the dense grid would be mostly empty, dense otherwise.
+		Automatic,
+		Dense,
+		Sparse,
+	};
+	// To be called before create().
+	void set_cell_storage(CellStorage cell_storage) { m_cell_storage = cell_storage; }
+	bool sparse() const { return m_sparse; }
+
 	// Fill in the grid with open polylines or closed contours.
 	// If open flag is indicated, then polylines_or_polygons are considered to be open by default.
 	// Only if the first point of a polyline is equal to the last point of a polyline, 
@@ -356,7 +369,7 @@ public:
 	{
         assert(row >= 0 && size_t(row) < m_rows);
         assert(col >= 0 && size_t(col) < m_cols);
-		const EdgeGrid::Grid::Cell &cell = m_cells[row * m_cols + col];
+		const EdgeGrid::Grid::Cell &cell = this->cell(row, col);
 		return std::make_pair(m_cell_data.begin() + cell.begin, m_cell_data.begin() + cell.end);
 	}
 
@@ -382,6 +395,63 @@ protected:
 	};
 
 	void create_from_m_contours(coord_t resolution);
+
+	const Cell& cell(size_t row, size_t col) const {
+		assert(row < m_rows && col < m_cols);
+		if (! m_sparse)
+			return m_cells[row * m_cols + col];
+		// The first cell of the sparse storage is an empty cell returned for all the cells not crossed by the contours.
+		auto begin = m_sparse_cols.begin() + m_sparse_rows[row];
+		auto end   = m_sparse_cols.begin() + m_sparse_rows[row + 1];
+		auto it    = std::lower_bound(begin, end, coord_t(col));
+		return m_cells[it != end && *it == coord_t(col) ? it - m_sparse_cols.begin() + 1 : 0];
+	}
+
+	// Cursor over the cells of a row with columns <col_min, col_max>, skipping the empty cells of the sparse storage.
+	// Iterating over the cells of a row with a cursor is cheaper than looking up the cells one by one.
+	struct RowCells {
+		// Advance to the next cell of the row, return false at the end.
+		bool next() {
+			if (sparse) {
+				if (++ idx == end || cols[idx] > col_max)
+					return false;
+				col  = cols[idx];
+				cell = &cells[idx + 1];
+			} else {
+				if (++ col > col_max)
+					return false;
+				cell = &cells[col];
+			}
+			return true;
+		}
+
+		bool 			sparse;
+		// Dense storage: Cells of the row. Sparse storage: All the cells.
+		const Cell     *cells;
+		// Sparse storage only: Columns of the cells and the current index into the columns.
+		const coord_t  *cols    { nullptr };
+		size_t 			idx     { 0 };
+		size_t 			end     { 0 };
+		coord_t 		col_max;
+		// Column of the current cell, valid after next() returned true.
+		coord_t 		col;
+		const Cell     *cell    { nullptr };
+	};
+	RowCells row_cells(size_t row, coord_t col_min, coord_t col_max) const {
+		assert(row < m_rows);
+		RowCells out { m_sparse, m_cells.data() };
+		out.col_max = col_max;
+		if (m_sparse) {
+			out.cols = m_sparse_cols.data();
+			out.end  = m_sparse_rows[row + 1];
+			// Index of the first cell with col >= col_min, decremented, to be incremented by the first call to next().
+			out.idx  = std::lower_bound(m_sparse_cols.begin() + m_sparse_rows[row], m_sparse_cols.begin() + out.end, col_min) - m_sparse_cols.begin() - 1;
+		} else {
+			out.cells += row * m_cols;
+			out.col    = col_min - 1;
+		}
+		return out;
+	}
 #if 0
 	bool line_cell_intersect(const Point &p1, const Point &p2, const Cell &cell);
 #endif
@@ -392,7 +462,7 @@ protected:
 			// The cell is outside the domain. Hoping that the contours were correctly oriented, so
 			// there is a CCW outmost contour so the out of domain cells are outside.
 			return false;
-		const Cell &cell = m_cells[r * m_cols + c];
+		const Cell &cell = this->cell(r, c);
 		return 
 			(cell.begin < cell.end) || 
 			(! m_signed_distance_field.empty() && m_signed_distance_field[r * (m_cols + 1) + c] <= 0.f);
@@ -413,8 +483,16 @@ protected:
 	// Referencing a contour and a line segment of m_contours.
 	std::vector<std::pair<size_t, size_t> >		m_cell_data;
 
-	// Full grid of cells.
+	CellStorage									m_cell_storage = CellStorage::Automatic;
+	bool										m_sparse = false;
+	// Full grid of cells in the dense storage, indexed by row * m_cols + col.
+	// In the sparse storage, an empty cell followed by the cells crossed by the contours in the row major order.
 	std::vector<Cell> 							m_cells;
+	// Sparse storage only: Columns of the cells crossed by the contours, sorted by rows and columns.
+	// m_cells[i + 1] is the cell of m_sparse_cols[i].
+	std::vector<coord_t>						m_sparse_cols;
+	// Sparse storage only: m_sparse_cols of a row r start at m_sparse_rows[r], m_sparse_rows has m_rows + 1 items.
+	std::vector<size_t>							m_sparse_rows;
 
 	// Distance field derived from the edge grid, seed filled by the Danielsson chamfer metric.
 	// May be empty.
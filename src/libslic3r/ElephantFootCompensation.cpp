@@ -10,6 +10,9 @@
 #include <vector>
 #include <cstddef>
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+
 #include "libslic3r.h"
 #include "ClipperUtils.hpp"
 #include "EdgeGrid.hpp"
@@ -471,67 +474,64 @@ static inline void smooth_compensation(std::vector<float> &compensation, float s
 }
 #endif
 
+// Compensation value sampled at a given distance along the contour from a contour point,
+// linearly interpolated between two contour points.
+struct BandSample {
+	int		idx_a;
+	int		idx_b;
+	float	t;
+
+	float value(const std::vector<float> &compensation) const { return lerp(compensation[idx_a], compensation[idx_b], t); }
+};
+
+// Walk from the i-th contour point in the direction given by step (previous or next point) until the distance "band"
+// is traveled along the contour and return the sample at that distance. If the first neighbor is farther than "band",
+// the first neighbor is returned, if the whole contour is shorter than "band", the last point visited is returned.
+template<typename StepFn>
+static inline BandSample band_sample(const Points &contour, int i, float band, StepFn step)
+{
+	const Vec2f	pthis = contour[i].cast<float>();
+	int			j     = step(i);
+	Vec2f		pprev = contour[j].cast<float>();
+	BandSample	out { j, j, 0.f };
+	float		l2    = (pthis - pprev).squaredNorm();
+	if (l2 < band * band) {
+		float l = sqrt(l2);
+		int jprev = std::exchange(j, step(j));
+		while (j != i) {
+			const Vec2f pp = contour[j].cast<float>();
+			const float lthis = (pp - pprev).norm();
+			const float lnext = l + lthis;
+			if (lnext > band)
+				// Interpolate the compensation value.
+				return { jprev, j, (band - l) / lthis };
+			out   = { j, j, 0.f };
+			pprev = pp;
+			l     = lnext;
+			jprev = std::exchange(j, step(j));
+		}
+	}
+	return out;
+}
+
 static inline void smooth_compensation_banded(const Points &contour, float band, std::vector<float> &compensation, float strength, size_t num_iterations)
 {
 	assert(contour.size() == compensation.size());
 	assert(contour.size() > 2);
+	// The band samples depend on the contour geometry only, thus they are calculated once for all the smoothing iterations.
+	// The iterations then reduce to a simple stencil over the compensation values.
+	std::vector<BandSample> samples_prev, samples_next;
+	samples_prev.reserve(contour.size());
+	samples_next.reserve(contour.size());
+	for (int i = 0; i < int(contour.size()); ++ i) {
+		samples_prev.emplace_back(band_sample(contour, i, band, [&contour](int j) { return int(prev_idx_modulo(j, contour)); }));
+		samples_next.emplace_back(band_sample(contour, i, band, [&contour](int j) { return int(next_idx_modulo(j, contour)); }));
+	}
 	std::vector<float> out(compensation);
-	float dist_min2 = band * band;
-	static constexpr bool use_min = false;
 	for (size_t iter = 0; iter < num_iterations; ++ iter) {
-		for (int i = 0; i < int(compensation.size()); ++ i) {
-			const Vec2f  pthis = contour[i].cast<float>();
-			
-			int		j     = prev_idx_modulo(i, contour);
-			Vec2f	pprev = contour[j].cast<float>();
-			float	prev  = compensation[j];
-			float	l2    = (pthis - pprev).squaredNorm();
-			if (l2 < dist_min2) {
-				float l = sqrt(l2);
-				int jprev = std::exchange(j, prev_idx_modulo(j, contour));
-				while (j != i) {
-					const Vec2f pp = contour[j].cast<float>();
-					const float lthis = (pp - pprev).norm();
-					const float lnext = l + lthis;
-					if (lnext > band) {
-						// Interpolate the compensation value.
-						prev = use_min ?
-							std::min(prev, lerp(compensation[jprev], compensation[j], (band - l) / lthis)) :
-							lerp(compensation[jprev], compensation[j], (band - l) / lthis);
-						break;
-					}
-					prev  = use_min ? std::min(prev, compensation[j]) : compensation[j];
-					pprev = pp;
-					l     = lnext;
-					jprev = std::exchange(j, prev_idx_modulo(j, contour));
-				}
-			}
-
-			j = next_idx_modulo(i, contour);
-			pprev = contour[j].cast<float>();
-			float next = compensation[j];
-			l2 = (pprev - pthis).squaredNorm();
-			if (l2 < dist_min2) {
-				float l = sqrt(l2);
-				int jprev = std::exchange(j, next_idx_modulo(j, contour));
-				while (j != i) {
-					const Vec2f pp = contour[j].cast<float>();
-					const float lthis = (pp - pprev).norm();
-					const float lnext = l + lthis;
-					if (lnext > band) {
-						// Interpolate the compensation value.
-						next = use_min ?
-							std::min(next, lerp(compensation[jprev], compensation[j], (band - l) / lthis)) :
-							lerp(compensation[jprev], compensation[j], (band - l) / lthis);
-						break;
-					}
-					next  = use_min ? std::min(next, compensation[j]) : compensation[j];
-					pprev = pp;
-					l     = lnext;
-					jprev = std::exchange(j, next_idx_modulo(j, contour));
-				}
-			}
-
+		for (size_t i = 0; i < compensation.size(); ++ i) {
+			float prev = samples_prev[i].value(compensation);
+			float next = samples_next[i].value(compensation);
 			float laplacian = compensation[i] * (1.f - strength) + 0.5f * strength * (prev + next);
 			// Compensations are negative. Only apply the laplacian if it leads to lower compensation.
 			out[i] = std::max(laplacian, compensation[i]);
@@ -638,19 +638,18 @@ ExPolygon  elephant_foot_compensation(const ExPolygon  &input, const Flow &exter
 
 ExPolygons elephant_foot_compensation(const ExPolygons &input, const Flow &external_perimeter_flow, const double compensation)
 {
-	ExPolygons out;
-	out.reserve(input.size());
-	for (const ExPolygon &expoly : input)
-		out.emplace_back(elephant_foot_compensation(expoly, external_perimeter_flow, compensation));
-	return out;
+    double min_contour_width = double(external_perimeter_flow.width() + external_perimeter_flow.spacing());
+    return elephant_foot_compensation(input, min_contour_width, compensation);
 }
 
 ExPolygons elephant_foot_compensation(const ExPolygons &input, double min_contour_width, const double compensation)
 {
-	ExPolygons out;
-	out.reserve(input.size());
-	for (const ExPolygon &expoly : input)
-		out.emplace_back(elephant_foot_compensation(expoly, min_contour_width, compensation));
+	// The islands are compensated independently, each one with its own EdgeGrid sized to the island.
+	ExPolygons out(input.size());
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, input.size()), [&input, &out, min_contour_width, compensation](const tbb::blocked_range<size_t> &range) {
+		for (size_t i = range.begin(); i < range.end(); ++ i)
+			out[i] = elephant_foot_compensation(input[i], min_contour_width, compensation);
+	});
 	return out;
 }
 
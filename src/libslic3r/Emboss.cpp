@@ -1517,13 +1517,37 @@ void add_quad(uint32_t              i1,
     result.indices.emplace_back(i1_, i1, i2_);
 };
 
+/// <summary>
+/// Triangulate expolygons one by one with use of cache
+/// NOTE: Triangulation of separate expolygon does not depend on the others,
+/// because other points are not visible through constrained edges.
+/// </summary>
+/// <param name="shape2d">Shapes to triangulate</param>
+/// <param name="cache">Already triangulated expolygons</param>
+/// <returns>CW triangles with indices into points of all expolygons</returns>
+std::vector<Vec3i> triangulate(const ExPolygons &shape2d, TriangulationCache &cache)
+{
+    std::vector<Vec3i> result;
+    int offset = 0;
+    for (const ExPolygon &expolygon : shape2d) {
+        Vec3i offset_vec(offset, offset, offset);
+        for (const Vec3i &t : cache.triangulate(expolygon))
+            result.emplace_back(t + offset_vec);
+        offset += static_cast<int>(count_points(expolygon));
+    }
+    return result;
+}
+
 indexed_triangle_set polygons2model_unique(
     const ExPolygons          &shape2d,
     const IProjection &projection,
-    const Points              &points)
+    const Points              &points,
+    TriangulationCache        *cache)
 {
     // CW order of triangle indices
-    std::vector<Vec3i> shape_triangles=Triangulation::triangulate(shape2d, points);
+    std::vector<Vec3i> shape_triangles = (cache != nullptr) ? 
+        triangulate(shape2d, *cache) : 
+        Triangulation::triangulate(shape2d, points);
     uint32_t           count_point     = points.size();
 
     indexed_triangle_set result;
@@ -1579,11 +1603,21 @@ indexed_triangle_set polygons2model_duplicit(
     const ExPolygons          &shape2d,
     const IProjection &projection,
     const Points              &points,
-    const Points              &duplicits)
+    const Points              &duplicits,
+    TriangulationCache        *cache)
 {
     // CW order of triangle indices
     std::vector<uint32_t> changes = Triangulation::create_changes(points, duplicits);
-    std::vector<Vec3i> shape_triangles = Triangulation::triangulate(shape2d, points, changes);
+    std::vector<Vec3i> shape_triangles;
+    if (cache != nullptr) {
+        shape_triangles = triangulate(shape2d, *cache);
+        // merge duplicit points
+        for (Vec3i &t : shape_triangles)
+            for (int i = 0; i < 3; ++i)
+                t[i] = changes[t[i]];
+    } else {
+        shape_triangles = Triangulation::triangulate(shape2d, points, changes);
+    }
     uint32_t count_point = *std::max_element(changes.begin(), changes.end()) + 1;
 
     indexed_triangle_set result;
@@ -1647,13 +1681,69 @@ indexed_triangle_set polygons2model_duplicit(
 } // namespace
 
 indexed_triangle_set Emboss::polygons2model(const ExPolygons &shape2d,
-                                            const IProjection &projection)
+                                            const IProjection &projection,
+                                            TriangulationCache *cache)
 {
     Points points = to_points(shape2d);    
     Points duplicits = collect_duplicates(points);
     return (duplicits.empty()) ?
-        polygons2model_unique(shape2d, projection, points) :
-        polygons2model_duplicit(shape2d, projection, points, duplicits);
+        polygons2model_unique(shape2d, projection, points, cache) :
+        polygons2model_duplicit(shape2d, projection, points, duplicits, cache);
+}
+
+namespace {
+size_t hash_shape(const ExPolygon &shape)
+{
+    size_t hash = shape.holes.size();
+    auto hash_combine = [&hash](size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+    auto hash_polygon = [&hash_combine](const Polygon &polygon) {
+        hash_combine(polygon.size());
+        for (const Point &p : polygon.points) {
+            hash_combine(static_cast<size_t>(p.x()));
+            hash_combine(static_cast<size_t>(p.y()));
+        }
+    };
+    hash_polygon(shape.contour);
+    for (const Polygon &hole : shape.holes)
+        hash_polygon(hole);
+    return hash;
+}
+} // namespace
+
+const std::vector<Vec3i> &TriangulationCache::triangulate(const ExPolygon &expolygon)
+{
+    // Triangulation does not change by translation, so compare shapes moved to zero
+    ExPolygon shape = expolygon; // copy
+    if (!shape.contour.empty())
+        shape.translate(-shape.contour.front());
+    size_t hash = hash_shape(shape);
+
+    auto [begin, end] = m_map.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        Items::iterator item = it->second;
+        if (item->shape.contour.points == shape.contour.points && item->shape.holes == shape.holes) {
+            // mark as the most recently used
+            m_items.splice(m_items.begin(), m_items, item);
+            return item->triangles;
+        }
+    }
+
+    std::vector<Vec3i> triangles = Triangulation::triangulate(shape);
+    m_items.push_front({std::move(shape), std::move(triangles)});
+    m_map.emplace(hash, m_items.begin());
+
+    // remove the least recently used
+    while (m_items.size() > m_max_count && m_items.size() > 1) {
+        Items::iterator last = std::prev(m_items.end());
+        auto [lbegin, lend] = m_map.equal_range(hash_shape(last->shape));
+        for (auto it = lbegin; it != lend; ++it)
+            if (it->second == last) {
+                m_map.erase(it);
+                break;
+            }
+        m_items.erase(last);
+    }
+    return m_items.front().triangles;
 }
 
 std::pair<Vec3d, Vec3d> Emboss::ProjectZ::create_front_back(const Point &p) const
@@ -15,8 +15,10 @@
 #include <memory>
 #include <Eigen/Geometry>
 #include <functional>
+#include <list>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <cassert>
 #include <cinttypes>
@@ -70,6 +72,42 @@ namespace Emboss
     };
     // cache for glyph by unicode
     using Glyphs = std::map<int, Glyph>;
+
+    /// <summary>
+    /// Cache of triangulated shapes (e.g. glyphs of text) for polygons2model.
+    /// Shapes are compared independently of their position,
+    /// so the same glyph is triangulated only once for the whole text and it is reused on next change of text.
+    /// Keeps only limited count of the least recently used shapes.
+    /// </summary>
+    class TriangulationCache
+    {
+    public:
+        explicit TriangulationCache(size_t max_count = 4096) : m_max_count(max_count) {}
+
+        /// <summary>
+        /// Get triangulation of expolygon, triangulate it when it is not cached yet
+        /// </summary>
+        /// <param name="expolygon">Shape to triangulate</param>
+        /// <returns>CW triangles with indices into points of expolygon (contour followed by holes)</returns>
+        const std::vector<Vec3i> &triangulate(const ExPolygon &expolygon);
+
+        size_t size() const { return m_items.size(); }
+        void clear() { m_items.clear(); m_map.clear(); }
+
+    private:
+        struct Item
+        {
+            // shape moved to start in zero
+            ExPolygon          shape;
+            std::vector<Vec3i> triangles;
+        };
+        // front is the most recently used
+        using Items = std::list<Item>;
+        Items m_items;
+        // hash of shape to item
+        std::unordered_multimap<size_t, Items::iterator> m_map;
+        size_t m_max_count;
+    };
         
     /// <summary>
     /// keep information from file about font 
@@ -129,10 +167,15 @@ namespace Emboss
         // main thread only clear cache by set to another shared_ptr
         std::shared_ptr<Emboss::Glyphs> cache;
 
+        // Cache for triangulation of glyph shapes
+        // Same access rules as for cache of glyph shapes
+        std::shared_ptr<Emboss::TriangulationCache> triangulations;
+
         FontFileWithCache() : font_file(nullptr), cache(nullptr) {}
         explicit FontFileWithCache(std::unique_ptr<FontFile> font_file)
             : font_file(std::move(font_file))
             , cache(std::make_shared<Emboss::Glyphs>())
+            , triangulations(std::make_shared<Emboss::TriangulationCache>())
         {}
         bool has_value() const { return font_file != nullptr && cache != nullptr; }
     };
@@ -319,8 +362,9 @@ namespace Emboss
     /// </summary>
     /// <param name="shape2d">text or image</param>
     /// <param name="projection">Define transformation from 2d to 3d(orientation, position, scale, ...)</param>
+    /// <param name="cache">[optional] Reuse triangulation of already triangulated expolygons, only side walls are created again</param>
     /// <returns>Projected shape into space</returns>
-    indexed_triangle_set polygons2model(const ExPolygons &shape2d, const IProjection& projection);
+    indexed_triangle_set polygons2model(const ExPolygons &shape2d, const IProjection& projection, TriangulationCache *cache = nullptr);
     
     /// <summary>
     /// Suggest wanted up vector of embossed text by emboss direction
@@ -28,6 +28,9 @@
 #include "libslic3r/Polyline.hpp"
 #include "libslic3r/libslic3r.h"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 namespace Slic3r {
 
 void ExPolygon::scale(double factor)
@@ -224,18 +227,16 @@ void ExPolygon::simplify(double tolerance, ExPolygons* expolygons) const
     append(*expolygons, this->simplify(tolerance));
 }
 
-void ExPolygon::medial_axis(double min_width, double max_width, ThickPolylines* polylines) const
+// Medial axis of the expolygon with the polylines extended to the boundary and the short polylines removed.
+static void medial_axis(const ExPolygon &expolygon, Geometry::MedialAxis &ma, double max_width, ThickPolylines* polylines)
 {
-    // init helper object
-    Slic3r::Geometry::MedialAxis ma(min_width, max_width, *this);
-    
     // compute the Voronoi diagram and extract medial axis polylines
     ThickPolylines pp;
-    ma.build(&pp);
+    ma.build(expolygon, &pp);
     
     /*
     SVG svg("medial_axis.svg");
-    svg.draw(*this);
+    svg.draw(expolygon);
     svg.draw(pp);
     svg.Close();
     */
@@ -258,7 +259,7 @@ void ExPolygon::medial_axis(double min_width, double max_width, ThickPolylines*
            call, so we keep the inner point until we perform the second intersection() as well */
         Point new_front = polyline.points.front();
         Point new_back  = polyline.points.back();
-        if (polyline.endpoints.first && !this->on_boundary(new_front, SCALED_EPSILON)) {
+        if (polyline.endpoints.first && !expolygon.on_boundary(new_front, SCALED_EPSILON)) {
             Vec2d p1 = polyline.points.front().cast<double>();
             Vec2d p2 = polyline.points[1].cast<double>();
             // prevent the line from touching on the other side, otherwise intersection() might return that solution
@@ -266,9 +267,9 @@ void ExPolygon::medial_axis(double min_width, double max_width, ThickPolylines*
                 p2 = (p1 + p2) * 0.5;
             // Extend the start of the segment.
             p1 -= (p2 - p1).normalized() * max_width;
-            this->contour.intersection(Line(p1.cast<coord_t>(), p2.cast<coord_t>()), &new_front);
+            expolygon.contour.intersection(Line(p1.cast<coord_t>(), p2.cast<coord_t>()), &new_front);
         }
-        if (polyline.endpoints.second && !this->on_boundary(new_back, SCALED_EPSILON)) {
+        if (polyline.endpoints.second && !expolygon.on_boundary(new_back, SCALED_EPSILON)) {
             Vec2d p1 = (polyline.points.end() - 2)->cast<double>();
             Vec2d p2 = polyline.points.back().cast<double>();
             // prevent the line from touching on the other side, otherwise intersection() might return that solution
@@ -276,7 +277,7 @@ void ExPolygon::medial_axis(double min_width, double max_width, ThickPolylines*
                 p1 = (p1 + p2) * 0.5;
             // Extend the start of the segment.
             p2 += (p2 - p1).normalized() * max_width;
-            this->contour.intersection(Line(p1.cast<coord_t>(), p2.cast<coord_t>()), &new_back);
+            expolygon.contour.intersection(Line(p1.cast<coord_t>(), p2.cast<coord_t>()), &new_back);
         }
         polyline.points.front() = new_front;
         polyline.points.back()  = new_back;
@@ -334,6 +335,12 @@ void ExPolygon::medial_axis(double min_width, double max_width, ThickPolylines*
     polylines->insert(polylines->end(), pp.begin(), pp.end());
 }
 
+void ExPolygon::medial_axis(double min_width, double max_width, ThickPolylines* polylines) const
+{
+    Geometry::MedialAxis ma(min_width, max_width);
+    Slic3r::medial_axis(*this, ma, max_width, polylines);
+}
+
 void ExPolygon::medial_axis(double min_width, double max_width, Polylines* polylines) const
 {
     ThickPolylines tp;
@@ -343,6 +350,38 @@ void ExPolygon::medial_axis(double min_width, double max_width, Polylines* polyl
         polylines->emplace_back(pl.points);
 }
 
+void medial_axis(const ExPolygons &expolygons, double min_width, double max_width, ThickPolylines *polylines)
+{
+    if (expolygons.size() <= 1) {
+        for (const ExPolygon &expolygon : expolygons)
+            expolygon.medial_axis(min_width, max_width, polylines);
+        return;
+    }
+    // Medial axes of the islands are collected separately to be merged in the order of expolygons.
+    std::vector<ThickPolylines> per_island(expolygons.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, expolygons.size()), [&expolygons, &per_island, min_width, max_width](const tbb::blocked_range<size_t> &range) {
+        // Reuse the Voronoi diagram for all the islands of the range.
+        Geometry::MedialAxis ma(min_width, max_width);
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+            medial_axis(expolygons[i], ma, max_width, &per_island[i]);
+    });
+    size_t cnt = 0;
+    for (const ThickPolylines &pp : per_island)
+        cnt += pp.size();
+    polylines->reserve(polylines->size() + cnt);
+    for (ThickPolylines &pp : per_island)
+        polylines->insert(polylines->end(), std::make_move_iterator(pp.begin()), std::make_move_iterator(pp.end()));
+}
+
+void medial_axis(const ExPolygons &expolygons, double min_width, double max_width, Polylines *polylines)
+{
+    ThickPolylines tp;
+    medial_axis(expolygons, min_width, max_width, &tp);
+    polylines->reserve(polylines->size() + tp.size());
+    for (ThickPolyline &pl : tp)
+        polylines->emplace_back(std::move(pl.points));
+}
+
 Lines ExPolygon::lines() const
 {
     Lines lines = this->contour.lines();
@@ -503,6 +503,11 @@ inline double      area(const ExPolygons &polys) { double s = 0.; for (auto &p :
 // Removes all expolygons smaller than min_area and also removes all holes smaller than min_area
 bool        remove_small_and_small_holes(ExPolygons &expolygons, double min_area);
 
+// Medial axes of multiple expolygons appended to polylines in the order of the expolygons,
+// same as calling ExPolygon::medial_axis() for each expolygon, though the expolygons are processed in parallel.
+void        medial_axis(const ExPolygons &expolygons, double min_width, double max_width, ThickPolylines *polylines);
+void        medial_axis(const ExPolygons &expolygons, double min_width, double max_width, Polylines *polylines);
+
 } // namespace Slic3r
 
 // start Boost
@@ -0,0 +1,341 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#include "ExtrusionArena.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "Exception.hpp"
+#include "ExtrusionEntityCollection.hpp"
+
+namespace Slic3r {
+
+double ExtrusionArena::PathView::length() const
+{
+    double len = 0;
+    for (const Point *p = this->begin() + 1; p < this->end(); ++ p)
+        len += (*p - *(p - 1)).cast<double>().norm();
+    return len;
+}
+
+void ExtrusionArena::clear()
+{
+    m_points.clear();
+    m_paths.clear();
+    m_attributes.clear();
+    m_nodes.clear();
+    m_children.clear();
+    m_roots.clear();
+}
+
+ExtrusionArena::NodeIdx ExtrusionArena::append(const ExtrusionEntity &entity)
+{
+    NodeIdx idx = this->append_node(entity);
+    m_roots.emplace_back(idx);
+    return idx;
+}
+
+void ExtrusionArena::append(const ExtrusionArena &other)
+{
+    const auto points_offset     = uint32_t(m_points.size());
+    const auto paths_offset      = uint32_t(m_paths.size());
+    const auto attributes_offset = uint32_t(m_attributes.size());
+    const auto nodes_offset      = NodeIdx(m_nodes.size());
+    const auto children_offset   = uint32_t(m_children.size());
+    m_points.insert(m_points.end(), other.m_points.begin(), other.m_points.end());
+    m_attributes.insert(m_attributes.end(), other.m_attributes.begin(), other.m_attributes.end());
+    m_paths.reserve(m_paths.size() + other.m_paths.size());
+    for (PathData path : other.m_paths) {
+        path.first_point    += points_offset;
+        path.attributes_idx += attributes_offset;
+        m_paths.emplace_back(path);
+    }
+    m_nodes.reserve(m_nodes.size() + other.m_nodes.size());
+    for (Node node : other.m_nodes) {
+        node.first += node.type == NodeType::Collection ? children_offset : paths_offset;
+        m_nodes.emplace_back(node);
+    }
+    m_children.reserve(m_children.size() + other.m_children.size());
+    for (NodeIdx child : other.m_children)
+        m_children.emplace_back(child + nodes_offset);
+    m_roots.reserve(m_roots.size() + other.m_roots.size());
+    for (NodeIdx root : other.m_roots)
+        m_roots.emplace_back(root + nodes_offset);
+}
+
+uint32_t ExtrusionArena::attributes_idx(const ExtrusionAttributes &attributes)
+{
+    // Consecutive paths mostly share their attributes, store them once per run.
+    if (m_attributes.empty() || ! (m_attributes.back() == attributes))
+        m_attributes.emplace_back(attributes);
+    return uint32_t(m_attributes.size() - 1);
+}
+
+uint32_t ExtrusionArena::append_path(const ExtrusionPath &path)
+{
+    if (m_points.size() + path.polyline.size() > std::numeric_limits<uint32_t>::max())
+        throw Slic3r::RuntimeError("ExtrusionArena: Too many points");
+    m_paths.push_back({ uint32_t(m_points.size()), uint32_t(path.polyline.size()), this->attributes_idx(path.attributes()) });
+    m_points.insert(m_points.end(), path.polyline.points.begin(), path.polyline.points.end());
+    return uint32_t(m_paths.size() - 1);
+}
+
+ExtrusionArena::NodeIdx ExtrusionArena::append_node(const ExtrusionEntity &entity)
+{
+    const auto idx = NodeIdx(m_nodes.size());
+    if (entity.is_collection()) {
+        const auto &collection = static_cast<const ExtrusionEntityCollection&>(entity);
+        // Reserve a continuous range of children before the children append their own children.
+        const auto first_child = uint32_t(m_children.size());
+        m_nodes.push_back({ NodeType::Collection, elrDefault, collection.no_sort, first_child, uint32_t(collection.entities.size()) });
+        m_children.resize(m_children.size() + collection.entities.size());
+        for (size_t i = 0; i < collection.entities.size(); ++ i) {
+            NodeIdx child = this->append_node(*collection.entities[i]);
+            m_children[first_child + i] = child;
+        }
+    } else if (const auto *path = dynamic_cast<const ExtrusionPath*>(&entity); path != nullptr) {
+        m_nodes.push_back({ path->can_reverse() ? NodeType::Path : NodeType::PathOriented, elrDefault, false, this->append_path(*path), 1 });
+    } else if (const auto *multi_path = dynamic_cast<const ExtrusionMultiPath*>(&entity); multi_path != nullptr) {
+        m_nodes.push_back({ NodeType::MultiPath, elrDefault, false, uint32_t(m_paths.size()), uint32_t(multi_path->paths.size()) });
+        for (const ExtrusionPath &p : multi_path->paths)
+            this->append_path(p);
+    } else if (const auto *loop = dynamic_cast<const ExtrusionLoop*>(&entity); loop != nullptr) {
+        m_nodes.push_back({ NodeType::Loop, loop->loop_role(), false, uint32_t(m_paths.size()), uint32_t(loop->paths.size()) });
+        for (const ExtrusionPath &p : loop->paths)
+            this->append_path(p);
+    } else
+        throw Slic3r::LogicError("ExtrusionArena: Unknown extrusion entity type");
+    return idx;
+}
+
+ExtrusionArena::PathView ExtrusionArena::path(NodeIdx idx, size_t path_idx) const
+{
+    const Node &node = m_nodes[idx];
+    assert(node.type != NodeType::Collection);
+    assert(path_idx < node.count);
+    return PathView(*this, m_paths[node.first + path_idx]);
+}
+
+ExtrusionRole ExtrusionArena::role(NodeIdx idx) const
+{
+    const Node &node = m_nodes[idx];
+    if (node.type != NodeType::Collection)
+        return node.count == 0 ? ExtrusionRole::None : m_attributes[m_paths[node.first].attributes_idx].role;
+    ExtrusionRole out{ ExtrusionRole::None };
+    for (const NodeIdx *child = this->children_begin(idx); child != this->children_end(idx); ++ child) {
+        ExtrusionRole er = this->role(*child);
+        out = (out == ExtrusionRole::None || out == er) ? er : ExtrusionRole::Mixed;
+    }
+    return out;
+}
+
+bool ExtrusionArena::can_reverse(NodeIdx idx) const
+{
+    switch (m_nodes[idx].type) {
+    case NodeType::Path:
+    case NodeType::MultiPath:    return true;
+    case NodeType::Collection:   return ! m_nodes[idx].no_sort;
+    default:                     return false;
+    }
+}
+
+const Point& ExtrusionArena::first_point(NodeIdx idx) const
+{
+    const Node &node = m_nodes[idx];
+    return node.type == NodeType::Collection ?
+        this->first_point(*this->children_begin(idx)) :
+        m_points[m_paths[node.first].first_point];
+}
+
+const Point& ExtrusionArena::last_point(NodeIdx idx) const
+{
+    const Node &node = m_nodes[idx];
+    if (node.type == NodeType::Collection)
+        return this->last_point(*(this->children_end(idx) - 1));
+    if (node.type == NodeType::Loop)
+        return this->first_point(idx);
+    const PathData &path = m_paths[node.first + node.count - 1];
+    return m_points[path.first_point + path.num_points - 1];
+}
+
+double ExtrusionArena::min_mm3_per_mm(NodeIdx idx) const
+{
+    const Node &node = m_nodes[idx];
+    double      out  = std::numeric_limits<double>::max();
+    if (node.type == NodeType::Collection) {
+        for (const NodeIdx *child = this->children_begin(idx); child != this->children_end(idx); ++ child)
+            out = std::min(out, this->min_mm3_per_mm(*child));
+    } else {
+        for (uint32_t i = node.first; i < node.first + node.count; ++ i)
+            out = std::min(out, m_attributes[m_paths[i].attributes_idx].mm3_per_mm);
+    }
+    return out;
+}
+
+double ExtrusionArena::total_volume(NodeIdx idx) const
+{
+    const Node &node   = m_nodes[idx];
+    double      volume = 0.;
+    if (node.type == NodeType::Collection) {
+        for (const NodeIdx *child = this->children_begin(idx); child != this->children_end(idx); ++ child)
+            volume += this->total_volume(*child);
+    } else {
+        for (uint32_t i = node.first; i < node.first + node.count; ++ i)
+            volume += m_attributes[m_paths[i].attributes_idx].mm3_per_mm * unscale<double>(PathView(*this, m_paths[i]).length());
+    }
+    return volume;
+}
+
+void ExtrusionArena::collect_polylines(NodeIdx idx, Polylines &dst) const
+{
+    const Node &node = m_nodes[idx];
+    switch (node.type) {
+    case NodeType::Collection:
+        for (const NodeIdx *child = this->children_begin(idx); child != this->children_end(idx); ++ child)
+            this->collect_polylines(*child, dst);
+        break;
+    case NodeType::Path:
+    case NodeType::PathOriented:
+        if (const PathData &path = m_paths[node.first]; path.num_points > 0)
+            dst.emplace_back(PathView(*this, path).as_polyline());
+        break;
+    case NodeType::MultiPath:
+    case NodeType::Loop:
+    {
+        // Same as ExtrusionMultiPath::as_polyline() and ExtrusionLoop::as_polyline():
+        // the paths are chained, the shared end points are emitted once.
+        Polyline pl;
+        for (uint32_t i = node.first; i < node.first + node.count; ++ i) {
+            const PathData &path  = m_paths[i];
+            const Point    *begin = m_points.data() + path.first_point;
+            const Point    *end   = begin + path.num_points;
+            if (node.type == NodeType::Loop) {
+                // ExtrusionLoop::polygon() skips the last point of each path.
+                if (begin != end)
+                    pl.points.insert(pl.points.end(), begin, end - 1);
+            } else {
+                if (! pl.points.empty() && begin != end)
+                    ++ begin;
+                pl.points.insert(pl.points.end(), begin, end);
+            }
+        }
+        if (node.type == NodeType::Loop && ! pl.points.empty())
+            pl.points.emplace_back(pl.points.front());
+        if (! pl.empty())
+            dst.emplace_back(std::move(pl));
+        break;
+    }
+    }
+}
+
+void ExtrusionArena::collect_points(NodeIdx idx, Points &dst) const
+{
+    const Node &node = m_nodes[idx];
+    if (node.type == NodeType::Collection) {
+        for (const NodeIdx *child = this->children_begin(idx); child != this->children_end(idx); ++ child)
+            this->collect_points(*child, dst);
+    } else {
+        for (uint32_t i = node.first; i < node.first + node.count; ++ i) {
+            const PathData &path = m_paths[i];
+            dst.insert(dst.end(), m_points.begin() + path.first_point, m_points.begin() + path.first_point + path.num_points);
+        }
+    }
+}
+
+size_t ExtrusionArena::items_count(NodeIdx idx) const
+{
+    if (m_nodes[idx].type != NodeType::Collection)
+        return 1;
+    size_t count = 0;
+    for (const NodeIdx *child = this->children_begin(idx); child != this->children_end(idx); ++ child)
+        count += this->items_count(*child);
+    return count;
+}
+
+void ExtrusionArena::reverse_paths(const Node &node)
+{
+    for (uint32_t i = node.first; i < node.first + node.count; ++ i) {
+        const PathData &path = m_paths[i];
+        std::reverse(m_points.begin() + path.first_point, m_points.begin() + path.first_point + path.num_points);
+    }
+    std::reverse(m_paths.begin() + node.first, m_paths.begin() + node.first + node.count);
+}
+
+void ExtrusionArena::reverse(NodeIdx idx)
+{
+    const Node &node = m_nodes[idx];
+    switch (node.type) {
+    case NodeType::Collection:
+        for (uint32_t i = node.first; i < node.first + node.count; ++ i)
+            // Don't reverse loops, see ExtrusionEntityCollection::reverse().
+            if (m_nodes[m_children[i]].type != NodeType::Loop)
+                this->reverse(m_children[i]);
+        std::reverse(m_children.begin() + node.first, m_children.begin() + node.first + node.count);
+        break;
+    case NodeType::Loop:
+        throw Slic3r::LogicError("ExtrusionArena::reverse() must NOT be called on a loop");
+    default:
+        // ExtrusionPathOriented::reverse() reverses the path unconditionally, too.
+        this->reverse_paths(node);
+    }
+}
+
+ExtrusionPath ExtrusionArena::to_path(const PathData &path) const
+{
+    PathView view(*this, path);
+    return ExtrusionPath(view.as_polyline(), view.attributes());
+}
+
+ExtrusionEntity* ExtrusionArena::to_entity(NodeIdx idx) const
+{
+    const Node &node = m_nodes[idx];
+    switch (node.type) {
+    case NodeType::Path:
+        return new ExtrusionPath(this->to_path(m_paths[node.first]));
+    case NodeType::PathOriented:
+    {
+        PathView view(*this, m_paths[node.first]);
+        return new ExtrusionPathOriented(view.as_polyline(), view.attributes());
+    }
+    case NodeType::MultiPath:
+    case NodeType::Loop:
+    {
+        ExtrusionPaths paths;
+        paths.reserve(node.count);
+        for (uint32_t i = node.first; i < node.first + node.count; ++ i)
+            paths.emplace_back(this->to_path(m_paths[i]));
+        if (node.type == NodeType::Loop)
+            return new ExtrusionLoop(std::move(paths), node.loop_role);
+        return new ExtrusionMultiPath(paths);
+    }
+    case NodeType::Collection:
+    default:
+    {
+        auto *out = new ExtrusionEntityCollection();
+        out->no_sort = node.no_sort;
+        out->entities.reserve(node.count);
+        for (const NodeIdx *child = this->children_begin(idx); child != this->children_end(idx); ++ child)
+            out->entities.emplace_back(this->to_entity(*child));
+        return out;
+    }
+    }
+}
+
+ExtrusionEntityCollection ExtrusionArena::to_collection() const
+{
+    ExtrusionEntityCollection out;
+    out.entities.reserve(m_roots.size());
+    for (NodeIdx root : m_roots)
+        out.entities.emplace_back(this->to_entity(root));
+    return out;
+}
+
+size_t ExtrusionArena::memory_used() const
+{
+    return m_points.capacity() * sizeof(Point) + m_paths.capacity() * sizeof(PathData) + m_attributes.capacity() * sizeof(ExtrusionAttributes) +
+        m_nodes.capacity() * sizeof(Node) + (m_children.capacity() + m_roots.capacity()) * sizeof(NodeIdx);
+}
+
+} // namespace Slic3r
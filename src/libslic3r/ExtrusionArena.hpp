@@ -0,0 +1,144 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef slic3r_ExtrusionArena_hpp_
+#define slic3r_ExtrusionArena_hpp_
+
+#include <cstdint>
+#include <vector>
+
+#include "ExtrusionEntity.hpp"
+#include "libslic3r/Point.hpp"
+#include "libslic3r/Polyline.hpp"
+
+namespace Slic3r {
+
+class ExtrusionEntityCollection;
+
+// Compact representation of the extrusions of a layer, an alternative to the tree of ExtrusionEntity objects.
+// The points of all paths are stored in a single contiguous buffer, a path references a range of points,
+// a multi-path or a loop references a range of paths and a collection references a range of child nodes.
+// Extrusion attributes are stored once for a run of paths sharing them. There is no virtual dispatch
+// and no allocation per entity, thus an arena is cheap to build, to copy and to release, and clear() keeps
+// the buffers to be reused by the next layer.
+//
+// append() and to_entity() / to_collection() convert from and to the ExtrusionEntity tree,
+// so that the producers and consumers of extrusions may be migrated one by one.
+class ExtrusionArena
+{
+public:
+    using NodeIdx = uint32_t;
+
+    enum class NodeType : uint8_t {
+        Path,
+        // Path, which shall not be reversed, see ExtrusionPathOriented.
+        PathOriented,
+        MultiPath,
+        Loop,
+        Collection,
+    };
+
+    struct PathData {
+        // Range of m_points.
+        uint32_t first_point;
+        uint32_t num_points;
+        // Index to m_attributes.
+        uint32_t attributes_idx;
+    };
+
+    struct Node {
+        NodeType          type;
+        // Valid for loops only.
+        ExtrusionLoopRole loop_role { elrDefault };
+        // Valid for collections only.
+        bool              no_sort { false };
+        // Range of m_paths for paths (a single one), multi-paths and loops, range of m_children for collections.
+        uint32_t          first;
+        uint32_t          count;
+    };
+
+    // View of a single path stored in the arena, it is invalidated by modifying the arena.
+    class PathView {
+    public:
+        PathView(const ExtrusionArena &arena, const PathData &path) : m_arena(&arena), m_path(&path) {}
+        const Point*               begin()       const { return m_arena->m_points.data() + m_path->first_point; }
+        const Point*               end()         const { return this->begin() + m_path->num_points; }
+        size_t                     size()        const { return m_path->num_points; }
+        const Point&               first_point() const { return *this->begin(); }
+        const Point&               last_point()  const { return *(this->end() - 1); }
+        const ExtrusionAttributes& attributes()  const { return m_arena->m_attributes[m_path->attributes_idx]; }
+        ExtrusionRole              role()        const { return this->attributes().role; }
+        double                     length()      const;
+        Polyline                   as_polyline() const { Polyline out; out.points.assign(this->begin(), this->end()); return out; }
+    private:
+        const ExtrusionArena *m_arena;
+        const PathData       *m_path;
+    };
+
+    ExtrusionArena() = default;
+
+    // Clears the arena, keeps the allocated buffers.
+    void clear();
+    bool empty() const { return m_roots.empty(); }
+
+    // Append a copy of an ExtrusionEntity tree as a new root, returns the index of its node.
+    NodeIdx append(const ExtrusionEntity &entity);
+    // Append roots of another arena.
+    void    append(const ExtrusionArena &other);
+
+    // Top level nodes in the order they were appended.
+    const std::vector<NodeIdx>& roots() const { return m_roots; }
+    const Node&     node(NodeIdx idx) const { return m_nodes[idx]; }
+    size_t          num_nodes() const { return m_nodes.size(); }
+    size_t          num_paths() const { return m_paths.size(); }
+    size_t          num_points() const { return m_points.size(); }
+    // Paths of a path, multi-path or a loop node.
+    size_t          num_paths(NodeIdx idx) const { assert(m_nodes[idx].type != NodeType::Collection); return m_nodes[idx].count; }
+    PathView        path(NodeIdx idx, size_t path_idx = 0) const;
+    // Children of a collection node.
+    const NodeIdx*  children_begin(NodeIdx idx) const { assert(m_nodes[idx].type == NodeType::Collection); return m_children.data() + m_nodes[idx].first; }
+    const NodeIdx*  children_end(NodeIdx idx) const { return this->children_begin(idx) + m_nodes[idx].count; }
+
+    // Queries equivalent to the virtual methods of ExtrusionEntity.
+    ExtrusionRole   role(NodeIdx idx) const;
+    bool            is_collection(NodeIdx idx) const { return m_nodes[idx].type == NodeType::Collection; }
+    bool            is_loop(NodeIdx idx) const { return m_nodes[idx].type == NodeType::Loop; }
+    bool            can_reverse(NodeIdx idx) const;
+    const Point&    first_point(NodeIdx idx) const;
+    const Point&    last_point(NodeIdx idx) const;
+    double          min_mm3_per_mm(NodeIdx idx) const;
+    double          total_volume(NodeIdx idx) const;
+    void            collect_polylines(NodeIdx idx, Polylines &dst) const;
+    void            collect_points(NodeIdx idx, Points &dst) const;
+    // Number of paths, multi-paths and loops reachable from idx, see ExtrusionEntityCollection::items_count().
+    size_t          items_count(NodeIdx idx) const;
+    // Reverse in place with the semantics of ExtrusionEntity::reverse(), loops are not reversed.
+    void            reverse(NodeIdx idx);
+
+    // Convert back to the ExtrusionEntity tree. The caller owns the returned object.
+    ExtrusionEntity*          to_entity(NodeIdx idx) const;
+    // All roots converted into a single collection.
+    ExtrusionEntityCollection to_collection() const;
+
+    // Memory allocated by the arena in bytes.
+    size_t          memory_used() const;
+
+private:
+    NodeIdx         append_node(const ExtrusionEntity &entity);
+    uint32_t        append_path(const ExtrusionPath &path);
+    uint32_t        attributes_idx(const ExtrusionAttributes &attributes);
+    void            reverse_paths(const Node &node);
+    ExtrusionPath   to_path(const PathData &path) const;
+
+    Points                           m_points;
+    std::vector<PathData>            m_paths;
+    std::vector<ExtrusionAttributes> m_attributes;
+    std::vector<Node>                m_nodes;
+    std::vector<NodeIdx>             m_children;
+    std::vector<NodeIdx>             m_roots;
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_ExtrusionArena_hpp_
@@ -72,6 +72,8 @@ public:
     virtual Polylines as_polylines() const { Polylines dst; this->collect_polylines(dst); return dst; }
     virtual double length() const = 0;
     virtual double total_volume() const = 0;
+    // Estimated memory occupied by this entity in bytes including the entity object itself, see MemoryUsage.
+    virtual size_t memory_used() const = 0;
 };
 
 using ExtrusionEntitiesPtr = std::vector<ExtrusionEntity*>;
@@ -221,6 +223,7 @@ public:
     void        collect_polylines(Polylines &dst) const override { if (! this->polyline.empty()) dst.emplace_back(this->polyline); }
     void        collect_points(Points &dst) const override { append(dst, this->polyline.points); }
     double      total_volume() const override { return m_attributes.mm3_per_mm * unscale<double>(length()); }
+    size_t      memory_used() const override { return sizeof(*this) + this->polyline.points.capacity() * sizeof(Point); }
 
 private:
     void        _inflate_collection(const Polylines &polylines, ExtrusionEntityCollection* collection) const;
@@ -293,6 +296,12 @@ public:
             append(dst, p.polyline.points);
     }
     double total_volume() const override { double volume =0.; for (const auto& path : paths) volume += path.total_volume(); return volume; }
+    size_t memory_used() const override {
+        size_t out = sizeof(*this) + this->paths.capacity() * sizeof(ExtrusionPath);
+        for (const ExtrusionPath &path : this->paths)
+            out += path.memory_used() - sizeof(ExtrusionPath);
+        return out;
+    }
 };
 
 // Single continuous extrusion loop, possibly with varying extrusion thickness, extrusion height or bridging / non bridging.
@@ -363,6 +372,12 @@ public:
             append(dst, p.polyline.points);
     }
     double total_volume() const override { double volume =0.; for (const auto& path : paths) volume += path.total_volume(); return volume; }
+    size_t memory_used() const override {
+        size_t out = sizeof(*this) + this->paths.capacity() * sizeof(ExtrusionPath);
+        for (const ExtrusionPath &path : this->paths)
+            out += path.memory_used() - sizeof(ExtrusionPath);
+        return out;
+    }
 
 #ifndef NDEBUG
 	bool validate() const {
@@ -139,6 +139,7 @@ public:
     ExtrusionEntityCollection flatten(bool preserve_ordering = false) const;
     double min_mm3_per_mm() const override;
     double total_volume() const override { double volume=0.; for (const auto& ent : entities) volume+=ent->total_volume(); return volume; }
+    size_t memory_used() const override { size_t out = sizeof(*this) + entities.capacity() * sizeof(ExtrusionEntity*); for (const auto& ent : entities) out += ent->memory_used(); return out; }
 
     // Following methods shall never be called on an ExtrusionEntityCollection.
     Polyline as_polyline() const override {
@@ -32,9 +32,8 @@
 #include "libslic3r/PrintConfig.hpp"
 #include "tcbspan/span.hpp"
 
-// Boost pool: Don't use mutexes to synchronize memory allocation.
-#define BOOST_POOL_NO_MT
-#include <boost/pool/object_pool.hpp>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometries/segment.hpp>
 
@@ -248,13 +247,20 @@ static constexpr std::array<std::array<int, 8>, 3> child_traversal_order {
     std::array<int, 8>{ 1, 5, 0, 4, 3, 7, 2, 6 },
 };
 
+// Cubes are stored in a single vector and address their children by indices into that vector.
+// Compared to heap allocated cubes linked by pointers, the cube is smaller, the octree is released at once
+// and subtrees built in parallel are merged by offsetting the indices.
+using CubeIdx = uint32_t;
+// Index of the root cube, it is never a child thus it marks a missing child.
+static constexpr CubeIdx no_cube = 0;
+
 struct Cube
 {
     Vec3d center;
 #ifndef NDEBUG
     Vec3d center_octree;
 #endif // NDEBUG
-    std::array<Cube*, 8> children {}; // initialized to nullptrs
+    std::array<CubeIdx, 8> children {}; // initialized to no_cube
     Cube(const Vec3d &center) : center(center) {}
 };
 
@@ -269,17 +275,15 @@ struct CubeProperties
 
 struct Octree
 {
-    // Octree will allocate its Cubes from the pool. The pool only supports deletion of the complete pool,
-    // perfect for building up our octree.
-    boost::object_pool<Cube>    pool;
-    Cube*                       root_cube { nullptr };
+    // All cubes of the octree, the root cube is the first one.
+    std::vector<Cube>           cubes;
     Vec3d                       origin;
     std::vector<CubeProperties> cubes_properties;
 
     Octree(const Vec3d &origin, const std::vector<CubeProperties> &cubes_properties)
-        : root_cube(pool.construct(origin)), origin(origin), cubes_properties(cubes_properties) {}
+        : cubes{ Cube(origin) }, origin(origin), cubes_properties(cubes_properties) {}
 
-    void insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cube *current_cube, const BoundingBoxf3 &current_bbox, int depth);
+    const Cube& root_cube() const { return cubes.front(); }
 };
 
 void OctreeDeleter::operator()(Octree *p) {
@@ -381,6 +385,7 @@ struct FillContext
     };
 
     FillContext(const Octree &octree, double z_position, int direction_idx) :
+        cubes(octree.cubes),
         cubes_properties(octree.cubes_properties),
         z_position(z_position),
         traversal_order(child_traversal_order[direction_idx]),
@@ -394,6 +399,7 @@ struct FillContext
     // Rotate the point, uses the same convention as Point::rotate().
     Vec2d rotate(const Vec2d& v) { return Vec2d(this->cos_a * v.x() - this->sin_a * v.y(), this->sin_a * v.x() + this->cos_a * v.y()); }
 
+    const std::vector<Cube>            &cubes;
     const std::vector<CubeProperties>  &cubes_properties;
     // Top of the current layer.
     const double                        z_position;
@@ -437,7 +443,7 @@ static bool verify_traversal_order(
     for (int i = 0; i < 8; ++i) {
         int j = context.traversal_order[i];
         Vec3d cntr = to_world * (cube->center_octree + (child_centers[j] * (context.cubes_properties[depth].edge_length / 4.)));
-        assert(!cube->children[j] || cube->children[j]->center.isApprox(cntr));
+        assert(cube->children[j] == no_cube || context.cubes[cube->children[j]].center.isApprox(cntr));
         c[i] = cntr;
     }
     std::array<Vec3d, 10> dirs = {
@@ -508,9 +514,9 @@ static void generate_infill_lines_recursive(
     -- depth;
     size_t i = 0;
     for (const int child_idx : context.traversal_order) {
-        const Cube *child = cube->children[child_idx];
-        if (child != nullptr)
-            generate_infill_lines_recursive(context, child, address, depth);
+        const CubeIdx child = cube->children[child_idx];
+        if (child != no_cube)
+            generate_infill_lines_recursive(context, &context.cubes[child], address, depth);
         if (++ i == 4)
             // right child index
             ++ address;
@@ -1346,7 +1352,7 @@ void Filler::_fill_surface_single(
         // Generate the infill lines along the octree cells, merge touching lines of the same direction.
         size_t num_lines = 0;
         for (auto &context : contexts) {
-            generate_infill_lines_recursive(context, adapt_fill_octree->root_cube, 0, int(adapt_fill_octree->cubes_properties.size()) - 1);
+            generate_infill_lines_recursive(context, &adapt_fill_octree->root_cube(), 0, int(adapt_fill_octree->cubes_properties.size()) - 1);
             num_lines += context.output_lines.size() + context.temp_lines.size();
         }
 
@@ -1460,15 +1466,52 @@ static inline bool is_overhang_triangle(const Vec3d &a, const Vec3d &b, const Ve
     return n.dot(up) > 0.707 * n.norm();
 }
 
-static void transform_center(Cube *current_cube, const Eigen::Matrix3d &rot)
+// Bounding box of a child cube, slightly expanded to cope with triangles touching a cube wall and other numeric errors.
+// We will rather densify the octree a bit more than necessary instead of missing a triangle.
+static inline BoundingBoxf3 child_bbox(const BoundingBoxf3 &current_bbox, const Vec3d &current_center, size_t child_idx)
 {
-#ifndef NDEBUG
-    current_cube->center_octree = current_cube->center;
-#endif // NDEBUG
-    current_cube->center = rot * current_cube->center;
-    for (auto *child : current_cube->children)
-        if (child)
-            transform_center(child, rot);
+    const Vec3d &child_center_dir = child_centers[child_idx];
+    BoundingBoxf3 bbox;
+    for (int k = 0; k < 3; ++ k) {
+        if (child_center_dir[k] == -1.) {
+            bbox.min[k] = current_bbox.min[k];
+            bbox.max[k] = current_center[k] + EPSILON;
+        } else {
+            bbox.min[k] = current_center[k] - EPSILON;
+            bbox.max[k] = current_bbox.max[k];
+        }
+    }
+    return bbox;
+}
+
+// Insert a triangle into the subtree of cubes[current_cube] of the given depth, children are appended to cubes.
+static void insert_triangle(
+    std::vector<Cube> &cubes, const std::vector<CubeProperties> &cubes_properties,
+    const Vec3d &a, const Vec3d &b, const Vec3d &c, CubeIdx current_cube, const BoundingBoxf3 &current_bbox, int depth)
+{
+    assert(depth > 0);
+
+    --depth;
+
+    // Squared radius of a sphere around the child cube.
+    // const double r2_cube = Slic3r::sqr(0.5 * cubes_properties[depth].height + EPSILON);
+
+    for (size_t i = 0; i < 8; ++ i) {
+        const Vec3d        current_center = cubes[current_cube].center;
+        const BoundingBoxf3 bbox          = child_bbox(current_bbox, current_center, i);
+        //if (dist2_to_triangle(a, b, c, child_center) < r2_cube) {
+        // dist2_to_triangle and r2_cube are commented out too.
+        if (triangle_AABB_intersects(a, b, c, bbox)) {
+            if (cubes[current_cube].children[i] == no_cube) {
+                // Don't hold a reference to cubes[current_cube] while emplacing, it may reallocate.
+                const auto child = CubeIdx(cubes.size());
+                cubes.emplace_back(current_center + (child_centers[i] * (cubes_properties[depth].edge_length / 2.)));
+                cubes[current_cube].children[i] = child;
+            }
+            if (depth > 0)
+                insert_triangle(cubes, cubes_properties, a, b, c, cubes[current_cube].children[i], bbox, depth);
+        }
+    }
 }
 
 OctreePtr build_octree(
@@ -1489,31 +1532,71 @@ OctreePtr build_octree(
     auto                        octree           = OctreePtr(new Octree(cube_center, cubes_properties));
 
     if (cubes_properties.size() > 1) {
-        Octree *octree_ptr = octree.get();
-        double edge_length_half = 0.5 * cubes_properties.back().edge_length;
-        Vec3d  diag_half(edge_length_half, edge_length_half, edge_length_half);
-        int    max_depth = int(cubes_properties.size()) - 1;
-        auto process_triangle = [octree_ptr, max_depth, diag_half](const Vec3d &a, const Vec3d &b, const Vec3d &c) {
-            octree_ptr->insert_triangle(
-                a, b, c,
-                octree_ptr->root_cube,
-                BoundingBoxf3(octree_ptr->root_cube->center - diag_half, octree_ptr->root_cube->center + diag_half),
-                max_depth);
-        };
         auto up_vector = support_overhangs_only ? Vec3d(transform_to_octree() * Vec3d(0., 0., 1.)) : Vec3d();
+        std::vector<std::array<Vec3d, 3>> triangles;
+        triangles.reserve(triangle_mesh.indices.size() + overhang_triangles.size() / 3);
         for (auto &tri : triangle_mesh.indices) {
             auto a = triangle_mesh.vertices[tri[0]].cast<double>();
             auto b = triangle_mesh.vertices[tri[1]].cast<double>();
             auto c = triangle_mesh.vertices[tri[2]].cast<double>();
             if (! support_overhangs_only || is_overhang_triangle(a, b, c, up_vector))
-                process_triangle(a, b, c);
+                triangles.push_back({ a, b, c });
         }
         for (size_t i = 0; i < overhang_triangles.size(); i += 3)
-            process_triangle(overhang_triangles[i], overhang_triangles[i + 1], overhang_triangles[i + 2]);
+            triangles.push_back({ overhang_triangles[i], overhang_triangles[i + 1], overhang_triangles[i + 2] });
+
+        // The eight subtrees of the root cube are independent, build them in parallel, each into its own vector of cubes.
+        // The triangles are inserted into each subtree in the same order as if the octree was built sequentially,
+        // the shape of the octree does not depend on the order anyway.
+        const double              edge_length_half = 0.5 * cubes_properties.back().edge_length;
+        const Vec3d               diag_half(edge_length_half, edge_length_half, edge_length_half);
+        const int                 max_depth = int(cubes_properties.size()) - 1;
+        const BoundingBoxf3       root_bbox(cube_center - diag_half, cube_center + diag_half);
+        std::array<std::vector<Cube>, 8> subtrees;
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, 8, 1), [&](const tbb::blocked_range<size_t> &range) {
+            for (size_t child_idx = range.begin(); child_idx < range.end(); ++ child_idx) {
+                std::vector<Cube>  &subtree = subtrees[child_idx];
+                const BoundingBoxf3 bbox    = child_bbox(root_bbox, cube_center, child_idx);
+                for (const std::array<Vec3d, 3> &tri : triangles)
+                    if (triangle_AABB_intersects(tri[0], tri[1], tri[2], bbox)) {
+                        if (subtree.empty())
+                            subtree.emplace_back(cube_center + (child_centers[child_idx] * (cubes_properties[max_depth - 1].edge_length / 2.)));
+                        if (max_depth > 1)
+                            insert_triangle(subtree, cubes_properties, tri[0], tri[1], tri[2], 0, bbox, max_depth - 1);
+                    }
+            }
+        });
+
+        // Merge the subtrees after the root cube, index zero of a subtree is its root and no_cube at the same time, both are offset.
+        std::vector<Cube> &cubes = octree->cubes;
+        size_t num_cubes = 1;
+        for (const std::vector<Cube> &subtree : subtrees)
+            num_cubes += subtree.size();
+        if (num_cubes > size_t(std::numeric_limits<CubeIdx>::max()))
+            throw Slic3r::RuntimeError("Adaptive infill octree is too large");
+        cubes.reserve(num_cubes);
+        for (size_t child_idx = 0; child_idx < 8; ++ child_idx)
+            if (std::vector<Cube> &subtree = subtrees[child_idx]; ! subtree.empty()) {
+                const auto offset = CubeIdx(cubes.size());
+                cubes.front().children[child_idx] = offset;
+                for (Cube &cube : subtree) {
+                    for (CubeIdx &child : cube.children)
+                        if (child != no_cube)
+                            child += offset;
+                    cubes.emplace_back(cube);
+                }
+                subtree = {};
+            }
+
         {
             // Transform the octree to world coordinates to reduce computation when extracting infill lines.
             auto rot = transform_to_world().toRotationMatrix();
-            transform_center(octree->root_cube, rot);
+            for (Cube &cube : cubes) {
+#ifndef NDEBUG
+                cube.center_octree = cube.center;
+#endif // NDEBUG
+                cube.center = rot * cube.center;
+            }
             octree->origin = rot * octree->origin;
         }
     }
@@ -1521,41 +1604,5 @@ OctreePtr build_octree(
     return octree;
 }
 
-void Octree::insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cube *current_cube, const BoundingBoxf3 &current_bbox, int depth)
-{
-    assert(current_cube);
-    assert(depth > 0);
-
-    --depth;
-
-    // Squared radius of a sphere around the child cube.
-    // const double r2_cube = Slic3r::sqr(0.5 * this->cubes_properties[depth].height + EPSILON);
-
-    for (size_t i = 0; i < 8; ++ i) {
-        const Vec3d &child_center_dir = child_centers[i];
-        // Calculate a slightly expanded bounding box of a child cube to cope with triangles touching a cube wall and other numeric errors.
-        // We will rather densify the octree a bit more than necessary instead of missing a triangle.
-        BoundingBoxf3 bbox;
-        for (int k = 0; k < 3; ++ k) {
-            if (child_center_dir[k] == -1.) {
-                bbox.min[k] = current_bbox.min[k];
-                bbox.max[k] = current_cube->center[k] + EPSILON;
-            } else {
-                bbox.min[k] = current_cube->center[k] - EPSILON;
-                bbox.max[k] = current_bbox.max[k];
-            }
-        }
-        Vec3d child_center = current_cube->center + (child_center_dir * (this->cubes_properties[depth].edge_length / 2.));
-        //if (dist2_to_triangle(a, b, c, child_center) < r2_cube) {
-        // dist2_to_triangle and r2_cube are commented out too.
-        if (triangle_AABB_intersects(a, b, c, bbox)) {
-            if (! current_cube->children[i])
-                current_cube->children[i] = this->pool.construct(child_center);
-            if (depth > 0)
-                this->insert_triangle(a, b, c, current_cube->children[i], bbox, depth);
-        }
-    }
-}
-
 } // namespace FillAdaptive
 } // namespace Slic3r
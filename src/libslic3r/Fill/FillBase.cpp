@@ -899,12 +899,32 @@ void mark_boundary_segments_touching_infill(
 	// Inflate the bounding box by a thick line width.
 	grid.create(boundary, coord_t(std::max(clip_distance, distance_colliding) + scale_(10.)));
 
+    // Index of the boundary segments: Start of each contour in a flat array of the segments of all the contours.
+    std::vector<size_t> contour_segments_offset(boundary.size() + 1, 0);
+    for (size_t i = 0; i < boundary.size(); ++ i)
+        contour_segments_offset[i + 1] = contour_segments_offset[i] + boundary[i].size();
+    // For each contour point, index of the first intersection with its parameter at or after the parameter of the point.
+    // As the intersection points are points of the contour, the sought intersection of any parameter inside
+    // a contour segment is found by a table lookup instead of a binary search.
+    std::vector<uint32_t> first_intersection_at_point(contour_segments_offset.back() + boundary.size(), 0);
+    for (size_t i = 0; i < boundary.size(); ++ i) {
+        const std::vector<double>                    &contour_parameters = boundary_parameters[i];
+        const std::vector<ContourIntersectionPoint*> &intersections      = boundary_intersections[i];
+        if (intersections.size() > 1)
+            for (size_t j = 0; j < contour_parameters.size(); ++ j)
+                first_intersection_at_point[contour_segments_offset[i] + i + j] = uint32_t(Slic3r::lower_bound_by_predicate(intersections.begin(), intersections.end(),
+                    [param = contour_parameters[j]](const ContourIntersectionPoint *l) { return l->param < param; }) - intersections.begin());
+    }
+
     // Visitor for the EdgeGrid to trim boundary_intersections with existing infill lines.
 	struct Visitor {
 		Visitor(const EdgeGrid::Grid &grid,
                 const std::vector<Points> &boundary, const std::vector<std::vector<double>> &boundary_parameters, std::vector<std::vector<ContourIntersectionPoint*>> &boundary_intersections,
+                const std::vector<size_t> &contour_segments_offset, const std::vector<uint32_t> &first_intersection_at_point,
                 const double radius) :
-			grid(grid), boundary(boundary), boundary_parameters(boundary_parameters), boundary_intersections(boundary_intersections), radius(radius), trim_l_threshold(0.5 * radius) {}
+			grid(grid), boundary(boundary), boundary_parameters(boundary_parameters), boundary_intersections(boundary_intersections),
+            contour_segments_offset(contour_segments_offset), first_intersection_at_point(first_intersection_at_point),
+            segment_visited(contour_segments_offset.back(), 0), radius(radius), trim_l_threshold(0.5 * radius) {}
 
         // Init with a segment of an infill line.
 		void init(const Vec2d &infill_pt1, const Vec2d &infill_pt2) {
@@ -914,18 +934,38 @@ void mark_boundary_segments_touching_infill(
             this->infill_bbox.merge(infill_pt1);
             this->infill_bbox.merge(infill_pt2);
             this->infill_bbox.offset(this->radius + SCALED_EPSILON);
+            if (++ this->infill_segment_stamp == 0) {
+                // Wrapped around, reset the stamps.
+                std::fill(this->segment_visited.begin(), this->segment_visited.end(), 0);
+                this->infill_segment_stamp = 1;
+            }
+        }
+
+        // Index of the first intersection of a contour with parameter >= param, where param is inside the segment starting with point_idx.
+        size_t first_intersection_at_or_after(size_t contour_idx, size_t point_idx, double param) const {
+            const std::vector<double> &contour_parameters = this->boundary_parameters[contour_idx];
+            const size_t               idx                = this->contour_segments_offset[contour_idx] + contour_idx + point_idx;
+            assert(param >= contour_parameters[point_idx] && param <= contour_parameters[point_idx + 1]);
+            return this->first_intersection_at_point[param <= contour_parameters[point_idx] ? idx : idx + 1];
         }
 
 		bool operator()(coord_t iy, coord_t ix) {
 			// Called with a row and colum of the grid cell, which is intersected by a line.
 			auto cell_data_range = this->grid.cell_data_range(iy, ix);
 			for (auto it_contour_and_segment = cell_data_range.first; it_contour_and_segment != cell_data_range.second; ++ it_contour_and_segment) {
-				// End points of the line segment and their vector.
-				auto segment = this->grid.segment(*it_contour_and_segment);
                 std::vector<ContourIntersectionPoint*> &intersections = boundary_intersections[it_contour_and_segment->first];
                 if (intersections.empty())
                     // There is no infil line touching this contour, thus effort will be saved to calculate overlap with other infill lines.
                     continue;
+                // A boundary segment is usually registered in multiple cells visited by the thick infill segment.
+                // The trimming is idempotent, thus each boundary segment is only tested once against the infill segment.
+                if (uint32_t &visited = this->segment_visited[this->contour_segments_offset[it_contour_and_segment->first] + it_contour_and_segment->second];
+                    visited == this->infill_segment_stamp)
+                    continue;
+                else
+                    visited = this->infill_segment_stamp;
+				// End points of the line segment and their vector.
+				auto segment = this->grid.segment(*it_contour_and_segment);
 				const Vec2d seg_pt1 = segment.first.cast<double>();
 				const Vec2d seg_pt2 = segment.second.cast<double>();
                 std::pair<double, double> interval;
@@ -957,10 +997,10 @@ void mark_boundary_segments_touching_infill(
                         ip_low = ip_high = intersections.front();
                     } else {
                         assert(intersections.size() > 1);
-                        auto it_low  = Slic3r::lower_bound_by_predicate(intersections.begin(), intersections.end(), [param_overlap1](const ContourIntersectionPoint *l) { return l->param < param_overlap1; });
-                        auto it_high = Slic3r::lower_bound_by_predicate(intersections.begin(), intersections.end(), [param_overlap2](const ContourIntersectionPoint *l) { return l->param < param_overlap2; });
-                        ip_low  = it_low  == intersections.end() ? intersections.front() : *it_low;
-                        ip_high = it_high == intersections.end() ? intersections.front() : *it_high;
+                        const size_t idx_low  = this->first_intersection_at_or_after(it_contour_and_segment->first, it_contour_and_segment->second, param_overlap1);
+                        const size_t idx_high = this->first_intersection_at_or_after(it_contour_and_segment->first, it_contour_and_segment->second, param_overlap2);
+                        ip_low  = idx_low  == intersections.size() ? intersections.front() : intersections[idx_low];
+                        ip_high = idx_high == intersections.size() ? intersections.front() : intersections[idx_high];
                         if (ip_low->param != param_overlap1)
                             ip_low = ip_low->prev_on_contour;
                         assert(ip_low != ip_high);
@@ -1009,6 +1049,11 @@ void mark_boundary_segments_touching_infill(
 		const std::vector<Points> 					        &boundary;
         const std::vector<std::vector<double>>              &boundary_parameters;
         std::vector<std::vector<ContourIntersectionPoint*>> &boundary_intersections;
+        const std::vector<size_t>                           &contour_segments_offset;
+        const std::vector<uint32_t>                         &first_intersection_at_point;
+        // Stamp of the last infill segment tested against a boundary segment, indexed by contour_segments_offset.
+        std::vector<uint32_t>                                segment_visited;
+        uint32_t                                             infill_segment_stamp { 0 };
 		// Maximum distance between the boundary and the infill line allowed to consider the boundary not touching the infill line.
 		const double								         radius;
         // Region around the contour / infill line intersection point, where the intersections are ignored.
@@ -1021,7 +1066,7 @@ void mark_boundary_segments_touching_infill(
 #ifdef INFILL_DEBUG_OUTPUT
         Polylines                                            perimeter_overlaps;
 #endif // INFILL_DEBUG_OUTPUT
-	} visitor(grid, boundary, boundary_parameters, boundary_intersections, distance_colliding);
+	} visitor(grid, boundary, boundary_parameters, boundary_intersections, contour_segments_offset, first_intersection_at_point, distance_colliding);
 
 	for (const Polyline &polyline : infill) {
 #ifdef INFILL_DEBUG_OUTPUT
@@ -21,19 +21,25 @@ namespace Slic3r {
 
 static inline double f(double x, double z_sin, double z_cos, bool vertical, bool flip)
 {
+    // sin() and cos() of the same argument, the compiler evaluates them with a single sincos() call.
+    // Shift of the argument by PI is applied by negating the result.
     if (vertical) {
         double phase_offset = (z_cos < 0 ? M_PI : 0) + M_PI;
-        double a   = sin(x + phase_offset);
+        double s   = sin(x + phase_offset);
+        double c   = cos(x + phase_offset);
+        double a   = s;
         double b   = - z_cos;
-        double res = z_sin * cos(x + phase_offset + (flip ? M_PI : 0.));
+        double res = z_sin * (flip ? - c : c);
         double r   = sqrt(sqr(a) + sqr(b));
         return asin(a/r) + asin(res/r) + M_PI;
     }
     else {
         double phase_offset = z_sin < 0 ? M_PI : 0.;
-        double a   = cos(x + phase_offset);
+        double s   = sin(x + phase_offset);
+        double c   = cos(x + phase_offset);
+        double a   = c;
         double b   = - z_sin;
-        double res = z_cos * sin(x + phase_offset + (flip ? 0 : M_PI));
+        double res = z_cos * (flip ? s : - s);
         double r   = sqrt(sqr(a) + sqr(b));
         return (asin(a/r) + asin(res/r) + 0.5 * M_PI);
     }
@@ -74,45 +80,44 @@ static inline Polyline make_wave(
 
 static std::vector<Vec2d> make_one_period(double width, double scaleFactor, double z_cos, double z_sin, bool vertical, bool flip, double tolerance)
 {
-    std::vector<Vec2d> points;
+    std::vector<Vec2d> coarse;
     double dx = M_PI_2; // exact coordinates on main inflexion lobes
     double limit = std::min(2*M_PI, width);
-    points.reserve(coord_t(ceil(limit / tolerance / 3)));
 
     for (double x = 0.; x < limit - EPSILON; x += dx) {
-        points.emplace_back(Vec2d(x, f(x, z_sin, z_cos, vertical, flip)));
+        coarse.emplace_back(Vec2d(x, f(x, z_sin, z_cos, vertical, flip)));
     }
-    points.emplace_back(Vec2d(limit, f(limit, z_sin, z_cos, vertical, flip)));
-
-    // piecewise increase in resolution up to requested tolerance
-    for(;;)
-    {
-        size_t size = points.size();
-        for (unsigned int i = 1;i < size; ++i) {
-            auto& lp = points[i-1]; // left point
-            auto& rp = points[i];   // right point
-            double x = lp(0) + (rp(0) - lp(0)) / 2;
-            double y = f(x, z_sin, z_cos, vertical, flip);
-            Vec2d ip = {x, y};
-            if (std::abs(cross2(Vec2d(ip - lp), Vec2d(ip - rp))) > sqr(tolerance)) {
-                points.emplace_back(std::move(ip));
-            }
-        }
+    coarse.emplace_back(Vec2d(limit, f(limit, z_sin, z_cos, vertical, flip)));
 
-        if (size == points.size())
-            break;
-        else
-        {
-            // insert new points in order
-            std::sort(points.begin(), points.end(),
-                      [](const Vec2d &lhs, const Vec2d &rhs) { return lhs(0) < rhs(0); });
+    // Piecewise increase in resolution up to requested tolerance.
+    // Each interval is bisected until its midpoint is within tolerance. Intervals which already satisfy
+    // the tolerance are not evaluated again and the points are emitted in order, thus they don't need to be sorted.
+    std::vector<Vec2d> points;
+    points.reserve(coord_t(ceil(limit / tolerance / 3)));
+    points.emplace_back(coarse.front());
+    // Stack of right end points of the intervals to be processed, the left end point is points.back().
+    std::vector<Vec2d> stack;
+    for (size_t i = coarse.size() - 1; i > 0; -- i)
+        stack.emplace_back(coarse[i]);
+    while (! stack.empty()) {
+        const Vec2d lp = points.back(); // left point
+        const Vec2d rp = stack.back();  // right point
+        double x = lp(0) + (rp(0) - lp(0)) / 2;
+        double y = f(x, z_sin, z_cos, vertical, flip);
+        Vec2d ip = {x, y};
+        if (std::abs(cross2(Vec2d(ip - lp), Vec2d(ip - rp))) > sqr(tolerance)) {
+            // Refine the left half first.
+            stack.emplace_back(ip);
+        } else {
+            points.emplace_back(rp);
+            stack.pop_back();
         }
     }
 
     return points;
 }
 
-static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double line_spacing, double width, double height)
+static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double line_spacing, double width, double height, FillGyroid::WavePeriods &cache)
 {
     const double scaleFactor = scale_(line_spacing) / density_adjusted;
 
@@ -137,9 +142,21 @@ static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double
         std::swap(width,height);
     }
 
-    std::vector<Vec2d> one_period_odd = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance); // creates one period of the waves, so it doesn't have to be recalculated all the time
-    flip = !flip;                                                                   // even polylines are a bit shifted
-    std::vector<Vec2d> one_period_even = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance);
+    // Creates one period of the waves, so it doesn't have to be recalculated all the time.
+    // The period only depends on the Z coordinate and on the spacing, it is shared by all the surfaces of a layer
+    // filled by the same filler, unless the surface is narrower than a single period.
+    const double period_width = std::min(2*M_PI, width);
+    if (cache.odd.empty() || cache.z != gridZ || cache.scale_factor != scaleFactor || cache.tolerance != tolerance || cache.width != period_width) {
+        cache.z            = gridZ;
+        cache.scale_factor = scaleFactor;
+        cache.tolerance    = tolerance;
+        cache.width        = period_width;
+        cache.odd          = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance);
+        cache.even         = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, ! flip, tolerance); // even polylines are a bit shifted
+    }
+    const std::vector<Vec2d> &one_period_odd  = cache.odd;
+    const std::vector<Vec2d> &one_period_even = cache.even;
+    flip = !flip;
     Polylines result;
 
     for (double y0 = lower_bound; y0 < upper_bound + EPSILON; y0 += M_PI) {
@@ -184,7 +201,8 @@ void FillGyroid::_fill_surface_single(
         density_adjusted,
         this->spacing,
         ceil(bb.size()(0) / distance) + 1.,
-        ceil(bb.size()(1) / distance) + 1.);
+        ceil(bb.size()(1) / distance) + 1.,
+        m_wave_periods);
 
 	// shift the polyline to the grid origin
 	for (Polyline &pl : polylines)
@@ -7,14 +7,15 @@
 #define slic3r_FillGyroid_hpp_
 
 #include <utility>
+#include <vector>
 
 #include "libslic3r/libslic3r.h"
 #include "FillBase.hpp"
 #include "libslic3r/ExPolygon.hpp"
+#include "libslic3r/Point.hpp"
 #include "libslic3r/Polyline.hpp"
 
 namespace Slic3r {
-class Point;
 
 class FillGyroid : public Fill
 {
@@ -36,6 +37,15 @@ public:
     // Gyroid upper resolution tolerance (mm^-2)
     static constexpr double PatternTolerance = 0.2;
 
+    // Single period of the odd and even waves in normalized coordinates, cached between the surfaces filled by this filler.
+    struct WavePeriods {
+        double             z            { 0. };
+        double             scale_factor { 0. };
+        double             tolerance    { 0. };
+        double             width        { 0. };
+        std::vector<Vec2d> odd;
+        std::vector<Vec2d> even;
+    };
 
 protected:
     void _fill_surface_single(
@@ -44,6 +54,9 @@ protected:
         const std::pair<float, Point>   &direction, 
         ExPolygon                        expolygon,
         Polylines                       &polylines_out) override;
+
+private:
+    WavePeriods m_wave_periods;
 };
 
 } // namespace Slic3r
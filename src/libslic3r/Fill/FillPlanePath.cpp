@@ -8,6 +8,9 @@
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
 #include <cmath>
+#include <memory>
+#include <mutex>
+#include <typeinfo>
 
 #include "../ClipperUtils.hpp"
 #include "../ShortestPath.hpp"
@@ -21,7 +24,8 @@ class InfillPolylineClipper : public FillPlanePath::InfillPolylineOutput {
 public:
     InfillPolylineClipper(const BoundingBox bbox, const double scale_out) : FillPlanePath::InfillPolylineOutput(scale_out), m_bbox(bbox) {}
 
-    void            add_point(const Vec2d &pt);
+    void            add_point(const Vec2d &pt) { this->add_scaled_point(this->scaled(pt)); }
+    void            add_scaled_point(const Point &pt);
     Points&&        result() { return std::move(m_out); }
     bool            clips() const override { return true; }
 
@@ -48,10 +52,8 @@ private:
     int         m_sides_this;
 };
 
-void InfillPolylineClipper::add_point(const Vec2d &fpt)
+void InfillPolylineClipper::add_scaled_point(const Point &pt)
 {
-    const Point pt{ this->scaled(fpt) };
-
     if (m_out.size() < 2) {
         // Collect the two first points and their status.
         (m_out.empty() ? m_sides_prev : m_sides_this) = sides(pt);
@@ -77,6 +79,99 @@ void InfillPolylineClipper::add_point(const Vec2d &fpt)
     }
 }
 
+namespace {
+
+// A curve generated over the whole object for sparse infill, which is aligned across layers.
+// The curve is the same for all the layers of an object, thus it is generated once and clipped per surface.
+struct PlanePathCurve
+{
+    // Key of the curve: Pattern and the parameters passed to FillPlanePath::generate().
+    struct Key {
+        const std::type_info *pattern;
+        coord_t               min_x, min_y, max_x, max_y;
+        double                resolution;
+        double                scale_out;
+
+        bool operator==(const Key &rhs) const {
+            return *pattern == *rhs.pattern && min_x == rhs.min_x && min_y == rhs.min_y && max_x == rhs.max_x && max_y == rhs.max_y &&
+                   resolution == rhs.resolution && scale_out == rhs.scale_out;
+        }
+    };
+
+    static constexpr size_t ChunkSize = 256;
+
+    PlanePathCurve(Points &&points) : points(std::move(points)) {
+        // Neighbor chunks share their end points, so that the segments connecting the chunks are indexed as well.
+        for (size_t begin = 0; begin + 1 < this->points.size(); begin += ChunkSize) {
+            BoundingBox &bbox = this->chunk_bboxes.emplace_back();
+            for (size_t i = begin; i < std::min(begin + ChunkSize + 1, this->points.size()); ++ i)
+                bbox.merge(this->points[i]);
+        }
+    }
+
+    // Clip the curve with bbox. The chunks not overlapping bbox are skipped, thus the result is split
+    // into multiple polylines where the curve leaves bbox for a while.
+    Polylines clip(const BoundingBox &bbox, double scale_out) const {
+        Polylines                            out;
+        std::unique_ptr<InfillPolylineClipper> clipper;
+        for (size_t ichunk = 0; ichunk < this->chunk_bboxes.size(); ++ ichunk)
+            if (this->chunk_bboxes[ichunk].overlap(bbox)) {
+                const size_t begin = ichunk * ChunkSize;
+                const size_t end   = std::min(begin + ChunkSize + 1, this->points.size());
+                size_t       i     = begin;
+                if (clipper)
+                    // The first point of this chunk was already added with the previous chunk.
+                    ++ i;
+                else
+                    clipper = std::make_unique<InfillPolylineClipper>(bbox, scale_out);
+                for (; i < end; ++ i)
+                    clipper->add_scaled_point(this->points[i]);
+            } else if (clipper) {
+                out.emplace_back(clipper->result());
+                clipper.reset();
+            }
+        if (clipper)
+            out.emplace_back(clipper->result());
+        return out;
+    }
+
+    Points                   points;
+    // Bounding boxes of the chunks of points [i * ChunkSize, (i + 1) * ChunkSize].
+    std::vector<BoundingBox> chunk_bboxes;
+};
+
+// Most recently used curves, a couple of objects with a couple of sparse infill patterns.
+constexpr size_t                                                                         s_curve_cache_size = 8;
+std::mutex                                                                               s_curve_cache_mutex;
+std::vector<std::pair<PlanePathCurve::Key, std::shared_ptr<const PlanePathCurve>>>       s_curve_cache;
+
+std::shared_ptr<const PlanePathCurve> find_cached_curve(const PlanePathCurve::Key &key)
+{
+    std::lock_guard<std::mutex> lock(s_curve_cache_mutex);
+    auto it = std::find_if(s_curve_cache.begin(), s_curve_cache.end(), [&key](const auto &v) { return v.first == key; });
+    if (it == s_curve_cache.end())
+        return {};
+    // Move to the back, the least recently used curve is at the front.
+    std::rotate(it, it + 1, s_curve_cache.end());
+    return s_curve_cache.back().second;
+}
+
+std::shared_ptr<const PlanePathCurve> cache_curve(const PlanePathCurve::Key &key, Points &&points)
+{
+    auto curve = std::make_shared<const PlanePathCurve>(std::move(points));
+    std::lock_guard<std::mutex> lock(s_curve_cache_mutex);
+    // The same curve may have been generated by another thread in the meantime, keep just one.
+    auto it = std::find_if(s_curve_cache.begin(), s_curve_cache.end(), [&key](const auto &v) { return v.first == key; });
+    if (it != s_curve_cache.end())
+        return it->second;
+    if (s_curve_cache.size() == s_curve_cache_size)
+        s_curve_cache.erase(s_curve_cache.begin());
+    s_curve_cache.emplace_back(key, curve);
+    return curve;
+}
+
+} // namespace
+
 void FillPlanePath::_fill_surface_single(
     const FillParams                &params, 
     unsigned int                     thickness_layers,
@@ -106,7 +201,7 @@ void FillPlanePath::_fill_surface_single(
     expolygon.translate(-shift.x(), -shift.y());
     bounding_box.translate(-shift.x(), -shift.y());
 
-    Polyline polyline;
+    Polylines polylines;
     {
         auto distance_between_lines = scaled<double>(this->spacing) / params.density;
         auto min_x = coord_t(ceil(coordf_t(bounding_box.min.x()) / distance_between_lines));
@@ -116,20 +211,28 @@ void FillPlanePath::_fill_surface_single(
         auto resolution = scaled<double>(params.resolution) / distance_between_lines;
         if (align) {
             // Filling in a bounding box over the whole object, clip generated polyline against the snug bounding box.
+            // The polyline over the whole object is generated once for all layers and surfaces, then only its parts
+            // close to the snug bounding box are clipped.
             snug_bounding_box.translate(-shift.x(), -shift.y());
-            InfillPolylineClipper output(snug_bounding_box, distance_between_lines);
-            this->generate(min_x, min_y, max_x, max_y, resolution, output);
-            polyline.points = std::move(output.result());
+            const PlanePathCurve::Key key{ &typeid(*this), min_x, min_y, max_x, max_y, resolution, distance_between_lines };
+            std::shared_ptr<const PlanePathCurve> curve = find_cached_curve(key);
+            if (! curve) {
+                InfillPolylineOutput output(distance_between_lines);
+                this->generate(min_x, min_y, max_x, max_y, resolution, output);
+                curve = cache_curve(key, output.result());
+            }
+            polylines = curve->clip(snug_bounding_box, distance_between_lines);
         } else {
             // Filling in a snug bounding box, no need to clip.
             InfillPolylineOutput output(distance_between_lines);
             this->generate(min_x, min_y, max_x, max_y, resolution, output);
-            polyline.points = std::move(output.result());
+            polylines.emplace_back(output.result());
         }
+        polylines.erase(std::remove_if(polylines.begin(), polylines.end(), [](const Polyline &pl) { return pl.size() < 2; }), polylines.end());
     }
 
-    if (polyline.size() >= 2) {
-        Polylines polylines = intersection_pl(polyline, expolygon);
+    if (! polylines.empty()) {
+        polylines = intersection_pl(polylines, expolygon);
         Polylines chained;
         if (params.dont_connect() || params.density > 0.5 || polylines.size() <= 1)
             chained = chain_polylines(std::move(polylines));
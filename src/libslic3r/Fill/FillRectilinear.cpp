@@ -1399,10 +1399,13 @@ static void traverse_graph_generate_polylines(const ExPolygonWithOffset
     Polyline* polyline_current = nullptr;
     if (! polylines_out.empty())
         pointLast = polylines_out.back().points.back();
+    // Consumed intersections are never released, therefore all the vertical lines left of the last starting point
+    // stay consumed and the search for the next starting point continues from the last one.
+    int       i_vline_search_start = 0;
     for (;;) {
         if (i_intersection == -1) {
             // The path has been interrupted. Find a next starting point.
-            for (int i_vline2 = 0; i_vline2 < int(segs.size()); ++i_vline2) {
+            for (int i_vline2 = i_vline_search_start; i_vline2 < int(segs.size()); ++i_vline2) {
                 const SegmentedIntersectionLine &vline = segs[i_vline2];
                 if (!vline.intersections.empty()) {
                     assert(vline.intersections.size() > 1);
@@ -1420,8 +1423,9 @@ static void traverse_graph_generate_polylines(const ExPolygonWithOffset
                             assert(intrsctn.is_low() || intrsctn_idx > 0);
                             const bool consumed = intrsctn.is_low() ? intrsctn.consumed_vertical_up : vline.intersections[intrsctn_idx - 1].consumed_vertical_up;
                             if (!consumed) {
-                                i_vline        = i_vline2;
-                                i_intersection = intrsctn_idx;
+                                i_vline              = i_vline2;
+                                i_intersection       = intrsctn_idx;
+                                i_vline_search_start = i_vline2;
                                 goto found;
                             }
                         }
@@ -2817,6 +2821,21 @@ bool FillRectilinear::fill_surface_by_lines(const Surface *surface, const FillPa
 	coord_t x0 = bounding_box.min(0);
 	if (params.full_infill())
 		x0 += (line_spacing + coord_t(SCALED_EPSILON)) / 2;
+    if (this->has_consistent_pattern()) {
+        // The vertical lines are aligned with the object bounding box to be consistent between layers,
+        // however only the lines crossing this surface are to be intersected with it. An even number of lines is skipped
+        // at the start, as the direction of the zig-zag passes is given by the parity of the line index.
+        const BoundingBox bbox_outer = poly_with_offset.bounding_box_outer();
+        if (bbox_outer.min.x() > x0) {
+            size_t skip = std::min(size_t((bbox_outer.min.x() - x0) / line_spacing) & ~size_t(1), n_vlines);
+            x0       += coord_t(skip) * line_spacing;
+            n_vlines -= skip;
+        }
+        if (x0 > bbox_outer.max.x())
+            n_vlines = 0;
+        else
+            n_vlines = std::min(n_vlines, size_t((bbox_outer.max.x() - x0) / line_spacing) + 1);
+    }
 
 #ifdef SLIC3R_DEBUG
     static int iRun = 0;
@@ -45,12 +45,19 @@ void export_distance_field_to_svg(const std::string &path, const Polygons &outli
 }
 #endif
 
-DistanceField::DistanceField(const coord_t& radius, const Polygons& current_outline, const BoundingBox& current_outlines_bbox, const Polygons& current_overhang) :
-    m_cell_size(radius / radius_per_cell_size),
-    m_supporting_radius(radius),
-    m_unsupported_points_bbox(current_outlines_bbox)
+DistanceField::DistanceField(const coord_t& radius, const Polygons& current_outline, const BoundingBox& current_outlines_bbox, const Polygons& current_overhang)
 {
-    m_supporting_radius2 = Slic3r::sqr(int64_t(radius));
+    this->initialize(radius, current_outline, current_outlines_bbox, current_overhang);
+}
+
+void DistanceField::initialize(const coord_t& radius, const Polygons& current_outline, const BoundingBox& current_outlines_bbox, const Polygons& current_overhang)
+{
+    m_cell_size               = radius / radius_per_cell_size;
+    m_supporting_radius       = radius;
+    m_supporting_radius2      = Slic3r::sqr(int64_t(radius));
+    m_unsupported_points_bbox = current_outlines_bbox;
+    // Keep the memory allocated by the previous initialization.
+    m_unsupported_points.clear();
     // Sample source polygons with a regular grid sampling pattern.
     const BoundingBox overhang_bbox = get_extents(current_overhang);
     for (const ExPolygon &expoly : union_ex(current_overhang)) {
@@ -85,8 +92,7 @@ DistanceField::DistanceField(const coord_t& radius, const Polygons& current_outl
                (PointHash{}(a.loc) % prime_for_hash) < (PointHash{}(b.loc) % prime_for_hash);
         });
 
-    m_unsupported_points_erased.resize(m_unsupported_points.size());
-    std::fill(m_unsupported_points_erased.begin(), m_unsupported_points_erased.end(), false);
+    m_unsupported_points_erased.assign(m_unsupported_points.size(), false);
 
     m_unsupported_points_grid.initialize(m_unsupported_points, [&self = std::as_const(*this)](const Point &p) -> Point { return self.to_grid_point(p); });
 
@@ -102,6 +108,50 @@ DistanceField::DistanceField(const coord_t& radius, const Polygons& current_outl
 #endif
 }
 
+void DistanceField::UnsupportedPointsGrid::initialize(const std::vector<UnsupportedCell> &unsupported_points, const std::function<Point(const Point &)> &map_cell_to_grid)
+{
+    m_size = unsupported_points.size();
+    if (unsupported_points.empty()) {
+        m_grid_range = BoundingBox();
+        m_grid_size  = Point::Zero();
+        m_row_words  = 0;
+        m_data.clear();
+        m_occupied.clear();
+        return;
+    }
+
+    BoundingBox unsupported_points_bbox;
+    for (const UnsupportedCell &cell : unsupported_points)
+        unsupported_points_bbox.merge(cell.loc);
+
+    m_grid_range = BoundingBox(map_cell_to_grid(unsupported_points_bbox.min), map_cell_to_grid(unsupported_points_bbox.max));
+    m_grid_size  = m_grid_range.size() + Point::Ones();
+    m_row_words  = (size_t(m_grid_size.x()) + 63) / 64;
+
+    m_data.assign(m_grid_size.y() * m_grid_size.x(), std::numeric_limits<size_t>::max());
+    m_occupied.assign(m_row_words * m_grid_size.y(), 0);
+
+    // Each grid cell contains at most a single point, thus the points may be scattered into the grid in parallel.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, unsupported_points.size()), [this, &unsupported_points, &map_cell_to_grid](const tbb::blocked_range<size_t> &range) {
+        for (size_t cell_idx = range.begin(); cell_idx < range.end(); ++cell_idx) {
+            const size_t flat_idx = map_to_flat_array(map_cell_to_grid(unsupported_points[cell_idx].loc));
+            assert(m_data[flat_idx] == std::numeric_limits<size_t>::max());
+            m_data[flat_idx] = cell_idx;
+        }
+    });
+
+    // Rows of the occupancy bitmap do not share words, thus they are filled in parallel.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, size_t(m_grid_size.y())), [this](const tbb::blocked_range<size_t> &range) {
+        for (size_t row = range.begin(); row < range.end(); ++row) {
+            const size_t *data     = m_data.data() + row * size_t(m_grid_size.x());
+            uint64_t     *occupied = m_occupied.data() + row * m_row_words;
+            for (size_t col = 0; col < size_t(m_grid_size.x()); ++col)
+                if (data[col] != std::numeric_limits<size_t>::max())
+                    occupied[col >> 6] |= uint64_t(1) << (col & 63);
+        }
+    });
+}
+
 void DistanceField::update(const Point& to_node, const Point& added_leaf)
 {
     Vec2d       v  = (added_leaf - to_node).cast<double>();
@@ -45,6 +45,18 @@ public:
      * layer.
      */
     DistanceField(const coord_t& radius, const Polygons& current_outline, const BoundingBox& current_outlines_bbox, const Polygons& current_overhang);
+
+    /*!
+     * Construct an empty field to be initialized later with initialize().
+     */
+    DistanceField() = default;
+
+    /*!
+     * (Re)initialize the field with the same parameters as the constructor.
+     * The memory allocated by a previous initialization is reused, thus a single
+     * field may be reused for all the layers of an object.
+     */
+    void initialize(const coord_t& radius, const Polygons& current_outline, const BoundingBox& current_outlines_bbox, const Polygons& current_overhang);
     
     /*!
      * Gets the next unsupported location to be supported by a new branch.
@@ -112,7 +124,7 @@ protected:
     /*!
      * BoundingBox of all points in m_unsupported_points. Used for mapping of sign integer numbers to positive integer numbers.
      */
-    const BoundingBox          m_unsupported_points_bbox;
+    BoundingBox                m_unsupported_points_bbox;
 
     /*!
      * Links the unsupported points to a grid point, so that we can quickly look
@@ -123,29 +135,8 @@ protected:
     {
     public:
         UnsupportedPointsGrid() = default;
-        void initialize(const std::vector<UnsupportedCell> &unsupported_points, const std::function<Point(const Point &)> &map_cell_to_grid)
-        {
-            if (unsupported_points.empty())
-                return;
-
-            BoundingBox unsupported_points_bbox;
-            for (const UnsupportedCell &cell : unsupported_points)
-                unsupported_points_bbox.merge(cell.loc);
-
-            m_size        = unsupported_points.size();
-            m_grid_range  = BoundingBox(map_cell_to_grid(unsupported_points_bbox.min), map_cell_to_grid(unsupported_points_bbox.max));
-            m_grid_size   = m_grid_range.size() + Point::Ones();
-
-            m_data.assign(m_grid_size.y() * m_grid_size.x(), std::numeric_limits<size_t>::max());
-            m_data_erased.assign(m_grid_size.y() * m_grid_size.x(), true);
-
-            for (size_t cell_idx = 0; cell_idx < unsupported_points.size(); ++cell_idx) {
-                const size_t flat_idx   = map_to_flat_array(map_cell_to_grid(unsupported_points[cell_idx].loc));
-                assert(m_data[flat_idx] == std::numeric_limits<size_t>::max());
-                m_data[flat_idx]        = cell_idx;
-                m_data_erased[flat_idx] = false;
-            }
-        }
+        // Grid cells are filled in parallel, the occupancy bitmap is built in parallel over the grid rows.
+        void initialize(const std::vector<UnsupportedCell> &unsupported_points, const std::function<Point(const Point &)> &map_cell_to_grid);
 
         size_t size() const { return m_size; }
 
@@ -154,9 +145,10 @@ protected:
             if (!m_grid_range.contains(grid_addr))
                 return std::numeric_limits<size_t>::max();
 
-            if (const size_t flat_idx = map_to_flat_array(grid_addr); !m_data_erased[flat_idx]) {
-                assert(m_data[flat_idx] != std::numeric_limits<size_t>::max());
-                return m_data[flat_idx];
+            if (this->occupied(grid_addr)) {
+                const size_t cell_idx = m_data[map_to_flat_array(grid_addr)];
+                assert(cell_idx != std::numeric_limits<size_t>::max());
+                return cell_idx;
             }
 
             return std::numeric_limits<size_t>::max();
@@ -168,11 +160,11 @@ protected:
             if (!m_grid_range.contains(grid_addr))
                 return;
 
-            const size_t flat_idx = map_to_flat_array(grid_addr);
-            assert(!m_data_erased[flat_idx] && m_data[flat_idx] != std::numeric_limits<size_t>::max());
+            assert(this->occupied(grid_addr) && m_data[map_to_flat_array(grid_addr)] != std::numeric_limits<size_t>::max());
             assert(m_size != 0);
 
-            m_data_erased[flat_idx] = true;
+            const Point offset_loc = grid_addr - m_grid_range.min;
+            m_occupied[m_row_words * offset_loc.y() + (offset_loc.x() >> 6)] &= ~(uint64_t(1) << (offset_loc.x() & 63));
             --m_size;
         }
 
@@ -182,8 +174,17 @@ protected:
         BoundingBox m_grid_range;
         Point       m_grid_size;
 
-        std::vector<size_t> m_data;
-        std::vector<bool>   m_data_erased;
+        std::vector<size_t>   m_data;
+        // Bitmap of grid cells containing a not yet erased point, each row is padded to a whole number of 64-bit words,
+        // so that the rows may be written in parallel.
+        std::vector<uint64_t> m_occupied;
+        size_t                m_row_words = 0;
+
+        inline bool occupied(const Point &loc) const
+        {
+            const Point offset_loc = loc - m_grid_range.min;
+            return (m_occupied[m_row_words * offset_loc.y() + (offset_loc.x() >> 6)] >> (offset_loc.x() & 63)) & 1;
+        }
 
         inline size_t map_to_flat_array(const Point &loc) const
         {
@@ -7,7 +7,13 @@
 #include <cmath>
 #include <utility>
 #include <cassert>
+#include <memory>
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_group.h>
+
+#include "DistanceField.hpp"
 #include "TreeNode.hpp"
 #include "../../ClipperUtils.hpp"
 #include "../../Layer.hpp"
@@ -62,33 +68,38 @@ Generator::Generator(const PrintObject &print_object, const coordf_t fill_densit
     m_prune_length                                    = coord_t(layer_thickness * std::tan(lightning_infill_prune_angle));
     m_straightening_max_distance                      = coord_t(layer_thickness * std::tan(lightning_infill_straightening_angle));
 
-    generateInitialInternalOverhangs(print_object, throw_on_cancel_callback);
-    generateTrees(print_object, throw_on_cancel_callback);
+    // Infill areas of all layers, shared by the overhang and the tree generation.
+    std::vector<Polygons> infill_outlines(print_object.layers().size(), Polygons());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, print_object.layers().size()), [&print_object, &infill_outlines, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id) {
+            throw_on_cancel_callback();
+            for (const LayerRegion *layerm : print_object.get_layer(int(layer_id))->regions())
+                for (const Surface &surface : layerm->fill_surfaces())
+                    if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
+                        append(infill_outlines[layer_id], to_polygons(surface.expolygon));
+            infill_outlines[layer_id] = union_(infill_outlines[layer_id]);
+        }
+    });
+
+    generateInitialInternalOverhangs(infill_outlines, throw_on_cancel_callback);
+    generateTrees(infill_outlines, throw_on_cancel_callback);
 }
 
-void Generator::generateInitialInternalOverhangs(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
+void Generator::generateInitialInternalOverhangs(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback)
 {
-    m_overhang_per_layer.resize(print_object.layers().size());
-
-    Polygons infill_area_above;
-    // Iterate from top to bottom, to subtract the overhang areas above from the overhang areas on the layer below, to get only overhang in the top layer where it is overhanging.
-    for (int layer_nr = int(print_object.layers().size()) - 1; layer_nr >= 0; --layer_nr) {
-        throw_on_cancel_callback();
-        Polygons infill_area_here;
-        for (const LayerRegion* layerm : print_object.get_layer(layer_nr)->regions())
-            for (const Surface& surface : layerm->fill_surfaces())
-                if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
-                    append(infill_area_here, to_polygons(surface.expolygon));
-
-        infill_area_here = union_(infill_area_here);
-        // Remove the part of the infill area that is already supported by the walls.
-        Polygons overhang = diff(offset(infill_area_here, -float(m_wall_supporting_radius)), infill_area_above);
-        // Filter out unprintable polygons and near degenerated polygons (three almost collinear points and so).
-        overhang = opening(overhang, float(SCALED_EPSILON), float(SCALED_EPSILON));
-
-        m_overhang_per_layer[layer_nr] = overhang;
-        infill_area_above = std::move(infill_area_here);
-    }
+    m_overhang_per_layer.assign(infill_outlines.size(), Polygons());
+
+    // Subtract the infill area above from the overhang areas on the layer below, to get only overhang in the top layer where it is overhanging.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, infill_outlines.size()), [this, &infill_outlines, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_nr = range.begin(); layer_nr < range.end(); ++ layer_nr) {
+            throw_on_cancel_callback();
+            // Remove the part of the infill area that is already supported by the walls.
+            Polygons overhang = diff(offset(infill_outlines[layer_nr], -float(m_wall_supporting_radius)),
+                layer_nr + 1 < infill_outlines.size() ? infill_outlines[layer_nr + 1] : Polygons());
+            // Filter out unprintable polygons and near degenerated polygons (three almost collinear points and so).
+            m_overhang_per_layer[layer_nr] = opening(overhang, float(SCALED_EPSILON), float(SCALED_EPSILON));
+        }
+    });
 }
 
 const Layer& Generator::getTreesForLayer(const size_t& layer_id) const
@@ -97,28 +108,27 @@ const Layer& Generator::getTreesForLayer(const size_t& layer_id) const
     return m_lightning_layers[layer_id];
 }
 
-void Generator::generateTrees(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
+void Generator::generateTrees(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback)
 {
-    m_lightning_layers.resize(print_object.layers().size());
-
-    std::vector<Polygons> infill_outlines(print_object.layers().size(), Polygons());
-
-    // For-each layer from top to bottom:
-    for (int layer_id = int(print_object.layers().size()) - 1; layer_id >= 0; layer_id--) {
-        throw_on_cancel_callback();
-        for (const LayerRegion *layerm : print_object.get_layer(layer_id)->regions())
-            for (const Surface &surface : layerm->fill_surfaces())
-                if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
-                    append(infill_outlines[layer_id], to_polygons(surface.expolygon));
-
-        infill_outlines[layer_id] = union_(infill_outlines[layer_id]);
-    }
+    m_lightning_layers.resize(infill_outlines.size());
+    if (infill_outlines.empty())
+        return;
 
     // For various operations its beneficial to quickly locate nearby features on the polygon:
-    const size_t top_layer_id = print_object.layers().size() - 1;
+    const size_t top_layer_id = infill_outlines.size() - 1;
     EdgeGrid::Grid outlines_locator(get_extents(infill_outlines[top_layer_id]).inflated(SCALED_EPSILON));
     outlines_locator.create(infill_outlines[top_layer_id], locator_cell_size);
 
+    // The initial distance field of a layer only depends on the infill area and on the overhangs of that layer,
+    // thus the distance field of the layer below is computed while the trees of the current layer are being grown.
+    // The two distance fields are swapped after each layer and reinitialized, reusing their memory.
+    auto init_distance_field = [this, &infill_outlines](DistanceField &distance_field, size_t layer_id) {
+        distance_field.initialize(m_supporting_radius, infill_outlines[layer_id], get_extents(infill_outlines[layer_id]), m_overhang_per_layer[layer_id]);
+    };
+    DistanceField distance_field;
+    DistanceField distance_field_below;
+    init_distance_field(distance_field, top_layer_id);
+
     // For-each layer from top to bottom:
     for (int layer_id = int(top_layer_id); layer_id >= 0; layer_id--) {
         throw_on_cancel_callback();
@@ -126,16 +136,25 @@ void Generator::generateTrees(const PrintObject &print_object, const std::functi
         const Polygons    &current_outlines        = infill_outlines[layer_id];
         const BoundingBox &current_outlines_bbox   = get_extents(current_outlines);
 
+        // If an exception is thrown, the task group waits for the background task when being destroyed.
+        tbb::task_group task_group;
+        if (layer_id > 0)
+            task_group.run([&init_distance_field, &distance_field_below, layer_id]() { init_distance_field(distance_field_below, size_t(layer_id - 1)); });
+
         // register all trees propagated from the previous layer as to-be-reconnected
         std::vector<NodeSPtr> to_be_reconnected_tree_roots = current_lightning_layer.tree_roots;
 
-        current_lightning_layer.generateNewTrees(m_overhang_per_layer[layer_id], current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius, throw_on_cancel_callback);
+        current_lightning_layer.generateNewTrees(distance_field, current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius, throw_on_cancel_callback);
         current_lightning_layer.reconnectRoots(to_be_reconnected_tree_roots, current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius);
 
+        task_group.wait();
+
         // Initialize trees for next lower layer from the current one.
         if (layer_id == 0)
             return;
 
+        std::swap(distance_field, distance_field_below);
+
         const Polygons &below_outlines      = infill_outlines[layer_id - 1];
         BoundingBox     below_outlines_bbox = get_extents(below_outlines).inflated(SCALED_EPSILON);
         if (const BoundingBox &outlines_locator_bbox = outlines_locator.bbox(); outlines_locator_bbox.defined)
@@ -21,6 +21,7 @@
 namespace Slic3r::FillLightning
 {
 
+class DistanceField;
 class Node;
 
 using NodeSPtr = std::shared_ptr<Node>;
@@ -43,9 +44,12 @@ class Layer
 public:
     std::vector<NodeSPtr> tree_roots;
 
+    /*!
+     * \param distance_field Distance field initialized with the overhangs of this layer, it is updated with the new trees.
+     */
     void generateNewTrees
     (
-        const Polygons& current_overhang,
+        DistanceField& distance_field,
         const Polygons& current_outlines,
         const BoundingBox& current_outlines_bbox,
         const EdgeGrid::Grid& outline_locator,
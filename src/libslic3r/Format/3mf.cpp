@@ -12,11 +12,13 @@
 #include "libslic3r/GCode/ThumbnailData.hpp"
 #include "libslic3r/Semver.hpp"
 #include "libslic3r/Time.hpp"
+#include "libslic3r/Thread.hpp"
 
 #include "libslic3r/I18N.hpp"
 
 #include "3mf.hpp"
 
+#include <atomic>
 #include <limits>
 #include <stdexcept>
 #include <optional>
@@ -49,6 +51,11 @@ namespace pt = boost::property_tree;
 
 #include <fast_float.h>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_pipeline.h>
+#include <tbb/task_arena.h>
+
 // Slightly faster than sprintf("%.9g"), but there is an issue with the karma floating point formatter,
 // https://github.com/boostorg/spirit/pull/586
 // where the exported string is one digit shorter than it should be to guarantee lossless round trip.
@@ -504,6 +511,10 @@ namespace Slic3r {
         Model* m_model;
         float m_unit_factor;
         CurrentObject m_curr_object;
+        // Geometries of the <mesh> elements of the model file being parsed, parsed in parallel ahead of the rest of the model file.
+        // The coordinates are not scaled by m_unit_factor yet.
+        std::vector<Geometry> m_parsed_meshes;
+        size_t m_next_parsed_mesh { 0 };
         IdToModelObjectMap m_objects;
         IdToAliasesMap m_objects_aliases;
         InstancesList m_instances;
@@ -546,6 +557,10 @@ namespace Slic3r {
         bool _load_model_from_file(const std::string& filename, Model& model, DynamicPrintConfig& config, ConfigSubstitutionContext& config_substitutions);
         bool _extract_relationships_from_archive(mz_zip_archive &archive, const mz_zip_archive_file_stat &stat);
         bool _extract_model_from_archive(mz_zip_archive &archive, const mz_zip_archive_file_stat &stat);
+        // Parses the content of a single <mesh> element. Returns an error message on failure.
+        static std::string _parse_mesh(std::string_view content, Geometry &geometry);
+        static void _add_vertex(Geometry &geometry, const char **attributes, unsigned int num_attributes, float unit_factor);
+        static void _add_triangle(Geometry &geometry, const char **attributes, unsigned int num_attributes);
         bool _is_svg_shape_file(const std::string &filename) const;
         void _extract_cut_information_from_archive(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat, ConfigSubstitutionContext& config_substitutions);
         void _extract_layer_heights_profile_config_from_archive(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat);
@@ -1077,31 +1092,92 @@ namespace Slic3r {
         XML_SetElementHandler(m_xml_parser, _3MF_Importer::_handle_start_model_xml_element, _3MF_Importer::_handle_end_model_xml_element);
         XML_SetCharacterDataHandler(m_xml_parser, _3MF_Importer::_handle_model_xml_characters);
 
-        struct CallbackData
-        {
-            XML_Parser& parser;
-            _3MF_Importer& importer;
-            const mz_zip_archive_file_stat& stat;
-
-            CallbackData(XML_Parser& parser, _3MF_Importer& importer, const mz_zip_archive_file_stat& stat) : parser(parser), importer(importer), stat(stat) {}
-        };
-
-        CallbackData data(m_xml_parser, *this, stat);
+        // Decompress the whole model file at once, the meshes are then parsed in parallel directly from the decompressed buffer.
+        std::string buffer((size_t)stat.m_uncomp_size, 0);
+        if (mz_zip_reader_extract_to_mem(&archive, stat.m_file_index, (void*)buffer.data(), (size_t)stat.m_uncomp_size, 0) == 0) {
+            add_error("Error while extracting model data from ZIP archive");
+            return false;
+        }
 
-        mz_bool res = 0;
+        // Content ranges of the <mesh> elements. Meshes are by far the largest part of the model file and their content
+        // does not depend on the rest of the file, thus they are parsed independently in parallel.
+        // XML comments and CDATA sections are skipped, the rest of the malformed cases is left to be reported by expat.
+        std::vector<std::pair<size_t, size_t>> mesh_ranges;
+        {
+            const std::string_view xml(buffer);
+            const std::string_view mesh_start = "<mesh";
+            const std::string_view mesh_end   = "</mesh";
+            size_t pos = 0;
+            while ((pos = xml.find('<', pos)) != std::string_view::npos) {
+                const std::string_view tag = xml.substr(pos);
+                auto starts_with = [tag](std::string_view prefix) { return tag.substr(0, prefix.size()) == prefix; };
+                if (starts_with("<!--")) {
+                    pos = xml.find("-->", pos + 4);
+                } else if (starts_with("<![CDATA[")) {
+                    pos = xml.find("]]>", pos + 9);
+                } else if (starts_with(mesh_start) && tag.size() > mesh_start.size() &&
+                           (tag[mesh_start.size()] == '>' || tag[mesh_start.size()] == '/' || ::isspace((unsigned char)tag[mesh_start.size()]))) {
+                    const size_t tag_end = xml.find('>', pos);
+                    if (tag_end == std::string_view::npos)
+                        break;
+                    if (xml[tag_end - 1] == '/') {
+                        // <mesh/>
+                        pos = tag_end;
+                    } else {
+                        pos = xml.find(mesh_end, tag_end);
+                        if (pos == std::string_view::npos)
+                            break;
+                        mesh_ranges.emplace_back(tag_end + 1, pos);
+                    }
+                }
+                if (pos == std::string_view::npos)
+                    break;
+                ++ pos;
+            }
+        }
 
-        try
+        m_parsed_meshes.assign(mesh_ranges.size(), Geometry());
+        m_next_parsed_mesh = 0;
         {
-            res = mz_zip_reader_extract_to_callback(&archive, stat.m_file_index, [](void* pOpaque, mz_uint64 file_ofs, const void* pBuf, size_t n)->size_t {
-                CallbackData* data = (CallbackData*)pOpaque;
-                if (!XML_Parse(data->parser, (const char*)pBuf, (int)n, (file_ofs + n == data->stat.m_uncomp_size) ? 1 : 0) || data->importer.parse_error()) {
-                    char error_buf[1024];
-                    ::sprintf(error_buf, "Error (%s) while parsing '%s' at line %d", data->importer.parse_error_message(), data->stat.m_filename, (int)XML_GetCurrentLineNumber(data->parser));
-                    throw Slic3r::FileIOError(error_buf);
+            std::vector<std::string> errors(mesh_ranges.size());
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, mesh_ranges.size(), 1), [this, &buffer, &mesh_ranges, &errors](const tbb::blocked_range<size_t> &range) {
+                for (size_t mesh_idx = range.begin(); mesh_idx < range.end(); ++ mesh_idx) {
+                    const auto [begin, end] = mesh_ranges[mesh_idx];
+                    errors[mesh_idx] = _parse_mesh(std::string_view(buffer).substr(begin, end - begin), m_parsed_meshes[mesh_idx]);
+                }
+            });
+            for (size_t mesh_idx = 0; mesh_idx < errors.size(); ++ mesh_idx)
+                if (! errors[mesh_idx].empty()) {
+                    add_error("Error (" + errors[mesh_idx] + ") while parsing mesh " + std::to_string(mesh_idx + 1) + " of '" + stat.m_filename + "'");
+                    m_parsed_meshes.clear();
+                    return false;
                 }
+        }
 
-                return n;
-                }, &data, 0);
+        // Parse the rest of the model file, the content of the meshes is skipped. _handle_start_mesh() picks up the parsed meshes in order.
+        try
+        {
+            auto parse = [this, &stat](const char *begin, const char *end, bool final) {
+                // Feed expat in limited chunks, XML_Parse() length is an int.
+                static constexpr const size_t max_chunk = 1 << 26;
+                do {
+                    const size_t len  = std::min(size_t(end - begin), max_chunk);
+                    const bool   last = final && begin + len == end;
+                    if (! XML_Parse(m_xml_parser, begin, (int)len, last ? 1 : 0) || parse_error()) {
+                        char error_buf[1024];
+                        ::sprintf(error_buf, "Error (%s) while parsing '%s' at line %d", parse_error_message(), stat.m_filename, (int)XML_GetCurrentLineNumber(m_xml_parser));
+                        throw Slic3r::FileIOError(error_buf);
+                    }
+                    begin += len;
+                } while (begin != end);
+            };
+            const char *data = buffer.data();
+            size_t      pos  = 0;
+            for (const auto &[begin, end] : mesh_ranges) {
+                parse(data + pos, data + begin, false);
+                pos = end;
+            }
+            parse(data + pos, data + buffer.size(), true);
         }
         catch (const version_error& e)
         {
@@ -1111,17 +1187,65 @@ namespace Slic3r {
         catch (std::exception& e)
         {
             add_error(e.what());
+            m_parsed_meshes.clear();
             return false;
         }
 
-        if (res == 0) {
-            add_error("Error while extracting model data from ZIP archive");
-            return false;
-        }
-
+        m_parsed_meshes.clear();
         return true;
     }
 
+    std::string _3MF_Importer::_parse_mesh(std::string_view content, Geometry &geometry)
+    {
+        // Pre-size the buffers, counting the elements is much cheaper than parsing them.
+        auto count_elements = [content](std::string_view tag, char plural) {
+            size_t cnt = 0;
+            for (size_t pos = content.find(tag); pos != std::string_view::npos; pos = content.find(tag, pos + tag.size()))
+                if (pos + tag.size() < content.size() && content[pos + tag.size()] != plural)
+                    ++ cnt;
+            return cnt;
+        };
+        const size_t num_triangles = count_elements("<triangle", 's');
+        geometry.vertices.reserve(count_elements("<vertex", 'i'));
+        geometry.triangles.reserve(num_triangles);
+        geometry.custom_supports.reserve(num_triangles);
+        geometry.custom_seam.reserve(num_triangles);
+        geometry.mm_segmentation.reserve(num_triangles);
+
+        struct ParserData
+        {
+            XML_Parser parser;
+            Geometry&  geometry;
+        };
+
+        XML_Parser parser = XML_ParserCreate(nullptr);
+        if (parser == nullptr)
+            return "Unable to create parser";
+        ParserData data{ parser, geometry };
+        XML_SetUserData(parser, (void*)&data);
+        XML_SetStartElementHandler(parser, [](void *user_data, const char *name, const char **attributes) {
+            ParserData &data = *(ParserData*)user_data;
+            const unsigned int num_attributes = (unsigned int)XML_GetSpecifiedAttributeCount(data.parser);
+            if (::strcmp(VERTEX_TAG, name) == 0)
+                _add_vertex(data.geometry, attributes, num_attributes, 1.f);
+            else if (::strcmp(TRIANGLE_TAG, name) == 0)
+                _add_triangle(data.geometry, attributes, num_attributes);
+            else if (::strcmp(VERTICES_TAG, name) == 0)
+                data.geometry.vertices.clear();
+            else if (::strcmp(TRIANGLES_TAG, name) == 0)
+                data.geometry.triangles.clear();
+        });
+
+        // The content of the mesh element is not a well formed XML document by itself, wrap it.
+        std::string error;
+        if (! XML_Parse(parser, "<mesh>", 6, 0) ||
+            ! XML_Parse(parser, content.data(), (int)content.size(), 0) ||
+            ! XML_Parse(parser, "</mesh>", 7, 1))
+            error = std::string(XML_ErrorString(XML_GetErrorCode(parser))) + " at line " + std::to_string(XML_GetCurrentLineNumber(parser));
+        XML_ParserFree(parser);
+        return error;
+    }
+
     void _3MF_Importer::_extract_cut_information_from_archive(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat, ConfigSubstitutionContext& config_substitutions)
     {
         if (stat.m_uncomp_size > 0) {
@@ -1902,6 +2026,13 @@ namespace Slic3r {
     {
         // reset current geometry
         m_curr_object.geometry.reset();
+        // take over the mesh parsed ahead, see _extract_model_from_archive()
+        if (m_next_parsed_mesh < m_parsed_meshes.size()) {
+            m_curr_object.geometry = std::move(m_parsed_meshes[m_next_parsed_mesh ++]);
+            if (m_unit_factor != 1.0f)
+                for (Vec3f &v : m_curr_object.geometry.vertices)
+                    v *= m_unit_factor;
+        }
         return true;
     }
 
@@ -1925,14 +2056,19 @@ namespace Slic3r {
     }
 
     bool _3MF_Importer::_handle_start_vertex(const char** attributes, unsigned int num_attributes)
+    {
+        _add_vertex(m_curr_object.geometry, attributes, num_attributes, m_unit_factor);
+        return true;
+    }
+
+    void _3MF_Importer::_add_vertex(Geometry &geometry, const char **attributes, unsigned int num_attributes, float unit_factor)
     {
         // appends the vertex coordinates
         // missing values are set equal to ZERO
-        m_curr_object.geometry.vertices.emplace_back(
-            m_unit_factor * get_attribute_value_float(attributes, num_attributes, X_ATTR),
-            m_unit_factor * get_attribute_value_float(attributes, num_attributes, Y_ATTR),
-            m_unit_factor * get_attribute_value_float(attributes, num_attributes, Z_ATTR));
-        return true;
+        geometry.vertices.emplace_back(
+            unit_factor * get_attribute_value_float(attributes, num_attributes, X_ATTR),
+            unit_factor * get_attribute_value_float(attributes, num_attributes, Y_ATTR),
+            unit_factor * get_attribute_value_float(attributes, num_attributes, Z_ATTR));
     }
 
     bool _3MF_Importer::_handle_end_vertex()
@@ -1955,6 +2091,12 @@ namespace Slic3r {
     }
 
     bool _3MF_Importer::_handle_start_triangle(const char** attributes, unsigned int num_attributes)
+    {
+        _add_triangle(m_curr_object.geometry, attributes, num_attributes);
+        return true;
+    }
+
+    void _3MF_Importer::_add_triangle(Geometry &geometry, const char **attributes, unsigned int num_attributes)
     {
         // we are ignoring the following attributes:
         // p1
@@ -1965,13 +2107,13 @@ namespace Slic3r {
 
         // appends the triangle's vertices indices
         // missing values are set equal to ZERO
-        m_curr_object.geometry.triangles.emplace_back(
+        geometry.triangles.emplace_back(
             get_attribute_value_int(attributes, num_attributes, V1_ATTR),
             get_attribute_value_int(attributes, num_attributes, V2_ATTR),
             get_attribute_value_int(attributes, num_attributes, V3_ATTR));
 
-        m_curr_object.geometry.custom_supports.push_back(get_attribute_value_string(attributes, num_attributes, CUSTOM_SUPPORTS_ATTR));
-        m_curr_object.geometry.custom_seam.push_back(get_attribute_value_string(attributes, num_attributes, CUSTOM_SEAM_ATTR));
+        geometry.custom_supports.push_back(get_attribute_value_string(attributes, num_attributes, CUSTOM_SUPPORTS_ATTR));
+        geometry.custom_seam.push_back(get_attribute_value_string(attributes, num_attributes, CUSTOM_SEAM_ATTR));
 
         // Now load MM segmentation data. Unfortunately, BambuStudio has changed the attribute name after they forked us,
         // leading to https://github.com/prusa3d/PrusaSlicer/issues/12502. Let's try to load both keys if the usual
@@ -1979,9 +2121,7 @@ namespace Slic3r {
         std::string mm_segmentation_serialized = get_attribute_value_string(attributes, num_attributes, MM_SEGMENTATION_ATTR);
         if (mm_segmentation_serialized.empty())
             mm_segmentation_serialized = get_attribute_value_string(attributes, num_attributes, "paint_color");
-        m_curr_object.geometry.mm_segmentation.push_back(mm_segmentation_serialized);
-
-        return true;
+        geometry.mm_segmentation.push_back(mm_segmentation_serialized);
     }
 
     bool _3MF_Importer::_handle_end_triangle()
@@ -2626,9 +2766,10 @@ namespace Slic3r {
 
         bool m_fullpath_sources{ true };
         bool m_zip64 { true };
+        mz_uint m_compression_level { MZ_DEFAULT_LEVEL };
 
     public:
-        bool save_model_to_file(const std::string& filename, Model& model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data, bool zip64);
+        bool save_model_to_file(const std::string& filename, Model& model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data, bool zip64, Zipper::e_compression compression);
         static void add_transformation(std::stringstream &stream, const Transform3d &tr);
     private:
         void _publish(Model &model);
@@ -2650,11 +2791,12 @@ namespace Slic3r {
         bool _add_custom_gcode_per_print_z_file_to_archive(mz_zip_archive& archive, Model& model, const DynamicPrintConfig* config);
     };
 
-    bool _3MF_Exporter::save_model_to_file(const std::string& filename, Model& model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data, bool zip64)
+    bool _3MF_Exporter::save_model_to_file(const std::string& filename, Model& model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data, bool zip64, Zipper::e_compression compression)
     {
         clear_errors();
         m_fullpath_sources = fullpath_sources;
         m_zip64 = zip64;
+        m_compression_level = mz_uint(Zipper::compression_level(compression));
         return _save_model_to_file(filename, model, config, thumbnail_data);
     }
 
@@ -2798,7 +2940,7 @@ namespace Slic3r {
 
         std::string out = stream.str();
 
-        if (!mz_zip_writer_add_mem(&archive, CONTENT_TYPES_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+        if (!mz_zip_writer_add_mem(&archive, CONTENT_TYPES_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
             add_error("Unable to add content types file to archive");
             return false;
         }
@@ -2813,7 +2955,7 @@ namespace Slic3r {
         size_t png_size = 0;
         void* png_data = tdefl_write_image_to_png_file_in_memory_ex((const void*)thumbnail_data.pixels.data(), thumbnail_data.width, thumbnail_data.height, 4, &png_size, MZ_DEFAULT_LEVEL, 1);
         if (png_data != nullptr) {
-            res = mz_zip_writer_add_mem(&archive, THUMBNAIL_FILE.c_str(), (const void*)png_data, png_size, MZ_DEFAULT_COMPRESSION);
+            res = mz_zip_writer_add_mem(&archive, THUMBNAIL_FILE.c_str(), (const void*)png_data, png_size, m_compression_level);
             mz_free(png_data);
         }
 
@@ -2834,7 +2976,7 @@ namespace Slic3r {
 
         std::string out = stream.str();
 
-        if (!mz_zip_writer_add_mem(&archive, RELATIONSHIPS_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+        if (!mz_zip_writer_add_mem(&archive, RELATIONSHIPS_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
             add_error("Unable to add relationships file to archive");
             return false;
         }
@@ -2864,7 +3006,7 @@ namespace Slic3r {
                 // Maximum expected 3MF file size is 4GB-1. This is a workaround for interoperability with Windows 10 3D model fixing API, see
                 // GH issue #6193.
                 (uint64_t(1) << 32) - 1,
-            nullptr, nullptr, 0, MZ_DEFAULT_COMPRESSION, nullptr, 0, nullptr, 0)) {
+            nullptr, nullptr, 0, m_compression_level, nullptr, 0, nullptr, 0)) {
             add_error("Unable to add model file to archive");
             return false;
         }
@@ -3021,24 +3163,76 @@ namespace Slic3r {
 
     bool _3MF_Exporter::_add_mesh_to_object_stream(mz_zip_writer_staged_context &context, ModelObject& object, VolumeToOffsetsMap& volumes_offsets)
     {
-        std::string output_buffer;
-        output_buffer += "   <";
-        output_buffer += MESH_TAG;
-        output_buffer += ">\n    <";
-        output_buffer += VERTICES_TAG;
-        output_buffer += ">\n";
-
-        auto flush = [this, &output_buffer, &context](bool force = false) {
-            if ((force && ! output_buffer.empty()) || output_buffer.size() >= 65536 * 16) {
-                if (! mz_zip_writer_add_staged_data(&context, output_buffer.data(), output_buffer.size())) {
-                    add_error("Error during writing or compression");
-                    return false;
-                }
-                output_buffer.clear();
+        // The mesh is serialized in chunks of vertices or triangles of a single volume. The chunks are formatted in parallel and passed
+        // to the compressor in order by a parallel pipeline, thus only a bounded number of formatted chunks is held in memory at once.
+        struct Chunk
+        {
+            // nullptr for a chunk of literal text.
+            const ModelVolume *volume { nullptr };
+            bool               triangles { false };
+            int                begin { 0 };
+            int                end { 0 };
+            unsigned int       first_vertex_id { 0 };
+            std::string        text;
+        };
+        static constexpr const int chunk_size = 16384;
+
+        std::vector<Chunk> chunks;
+        auto add_text = [&chunks](std::string text) {
+            Chunk chunk;
+            chunk.text = std::move(text);
+            chunks.emplace_back(std::move(chunk));
+        };
+        auto add_chunks = [&chunks](const ModelVolume *volume, bool triangles, int count, unsigned int first_vertex_id) {
+            for (int begin = 0; begin < count; begin += chunk_size) {
+                Chunk chunk;
+                chunk.volume          = volume;
+                chunk.triangles       = triangles;
+                chunk.begin           = begin;
+                chunk.end             = std::min(begin + chunk_size, count);
+                chunk.first_vertex_id = first_vertex_id;
+                chunks.emplace_back(std::move(chunk));
             }
-            return true;
         };
 
+        add_text(std::string("   <") + MESH_TAG + ">\n    <" + VERTICES_TAG + ">\n");
+        unsigned int vertices_count = 0;
+        for (ModelVolume* volume : object.volumes) {
+            if (volume == nullptr)
+                continue;
+
+            volumes_offsets.insert({ volume, Offsets(vertices_count) });
+
+            const indexed_triangle_set &its = volume->mesh().its;
+            if (its.vertices.empty()) {
+                add_error("Found invalid mesh");
+                return false;
+            }
+
+            add_chunks(volume, false, int(its.vertices.size()), vertices_count);
+            vertices_count += (int)its.vertices.size();
+        }
+
+        add_text(std::string("    </") + VERTICES_TAG + ">\n    <" + TRIANGLES_TAG + ">\n");
+        unsigned int triangles_count = 0;
+        for (ModelVolume* volume : object.volumes) {
+            if (volume == nullptr)
+                continue;
+
+            VolumeToOffsetsMap::iterator volume_it = volumes_offsets.find(volume);
+            assert(volume_it != volumes_offsets.end());
+
+            const indexed_triangle_set &its = volume->mesh().its;
+
+            // updates triangle offsets
+            volume_it->second.first_triangle_id = triangles_count;
+            triangles_count += (int)its.indices.size();
+            volume_it->second.last_triangle_id = triangles_count - 1;
+
+            add_chunks(volume, true, int(its.indices.size()), volume_it->second.first_vertex_id);
+        }
+        add_text(std::string("    </") + TRIANGLES_TAG + ">\n   </" + MESH_TAG + ">\n");
+
         auto format_coordinate = [](float f, char *buf) -> char* {
             assert(is_decimal_separator_point());
 #if EXPORT_3MF_USE_SPIRIT_KARMA_FP
@@ -3069,25 +3263,12 @@ namespace Slic3r {
 #endif
         };
 
-        char buf[256];
-        unsigned int vertices_count = 0;
-        for (ModelVolume* volume : object.volumes) {
-            if (volume == nullptr)
-                continue;
-
-            volumes_offsets.insert({ volume, Offsets(vertices_count) });
-
-            const indexed_triangle_set &its = volume->mesh().its;
-            if (its.vertices.empty()) {
-                add_error("Found invalid mesh");
-                return false;
-            }
-
-            vertices_count += (int)its.vertices.size();
-
-            const Transform3d& matrix = volume->get_matrix();
-            for (const auto& vertex: its.vertices) {
-                Vec3f v = (matrix * vertex.cast<double>()).cast<float>();
+        auto format_vertices = [&format_coordinate](const Chunk &chunk, std::string &out) {
+            char buf[256];
+            const indexed_triangle_set &its    = chunk.volume->mesh().its;
+            const Transform3d          &matrix = chunk.volume->get_matrix();
+            for (int i = chunk.begin; i < chunk.end; ++ i) {
+                Vec3f v = (matrix * its.vertices[i].cast<double>()).cast<float>();
                 char *ptr = buf;
                 boost::spirit::karma::generate(ptr, boost::spirit::lit("     <") << VERTEX_TAG << " x=\"");
                 ptr = format_coordinate(v.x(), ptr);
@@ -3096,92 +3277,80 @@ namespace Slic3r {
                 boost::spirit::karma::generate(ptr, "\" z=\"");
                 ptr = format_coordinate(v.z(), ptr);
                 boost::spirit::karma::generate(ptr, "\"/>\n");
-                *ptr = '\0';
-                output_buffer += buf;
-                if (! flush())
-                    return false;
+                out.append(buf, ptr);
             }
-        }
-
-        output_buffer += "    </";
-        output_buffer += VERTICES_TAG;
-        output_buffer += ">\n    <";
-        output_buffer += TRIANGLES_TAG;
-        output_buffer += ">\n";
-
-        unsigned int triangles_count = 0;
-        for (ModelVolume* volume : object.volumes) {
-            if (volume == nullptr)
-                continue;
-
-            bool is_left_handed = volume->is_left_handed();
-            VolumeToOffsetsMap::iterator volume_it = volumes_offsets.find(volume);
-            assert(volume_it != volumes_offsets.end());
-
-            const indexed_triangle_set &its = volume->mesh().its;
-
-            // updates triangle offsets
-            volume_it->second.first_triangle_id = triangles_count;
-            triangles_count += (int)its.indices.size();
-            volume_it->second.last_triangle_id = triangles_count - 1;
-
-            for (int i = 0; i < int(its.indices.size()); ++ i) {
-                {
-                    const Vec3i &idx = its.indices[i];
-                    char *ptr = buf;
-                    boost::spirit::karma::generate(ptr, boost::spirit::lit("     <") << TRIANGLE_TAG <<
-                        " v1=\"" << boost::spirit::int_ <<
-                        "\" v2=\"" << boost::spirit::int_ <<
-                        "\" v3=\"" << boost::spirit::int_ << "\"",
-                        idx[is_left_handed ? 2 : 0] + volume_it->second.first_vertex_id,
-                        idx[1] + volume_it->second.first_vertex_id,
-                        idx[is_left_handed ? 0 : 2] + volume_it->second.first_vertex_id);
-                    *ptr = '\0';
-                    output_buffer += buf;
-                }
+        };
 
-                std::string custom_supports_data_string = volume->supported_facets.get_triangle_as_string(i);
-                if (! custom_supports_data_string.empty()) {
-                    output_buffer += " ";
-                    output_buffer += CUSTOM_SUPPORTS_ATTR;
-                    output_buffer += "=\"";
-                    output_buffer += custom_supports_data_string;
-                    output_buffer += "\"";
+        auto format_triangles = [](const Chunk &chunk, std::string &out) {
+            char buf[256];
+            const ModelVolume          &volume         = *chunk.volume;
+            const indexed_triangle_set &its            = volume.mesh().its;
+            const bool                  is_left_handed = volume.is_left_handed();
+            auto append_attribute = [&out](const char *name, const std::string &value) {
+                if (! value.empty()) {
+                    out += " ";
+                    out += name;
+                    out += "=\"";
+                    out += value;
+                    out += "\"";
                 }
+            };
+            for (int i = chunk.begin; i < chunk.end; ++ i) {
+                const Vec3i &idx = its.indices[i];
+                char *ptr = buf;
+                boost::spirit::karma::generate(ptr, boost::spirit::lit("     <") << TRIANGLE_TAG <<
+                    " v1=\"" << boost::spirit::int_ <<
+                    "\" v2=\"" << boost::spirit::int_ <<
+                    "\" v3=\"" << boost::spirit::int_ << "\"",
+                    idx[is_left_handed ? 2 : 0] + chunk.first_vertex_id,
+                    idx[1] + chunk.first_vertex_id,
+                    idx[is_left_handed ? 0 : 2] + chunk.first_vertex_id);
+                out.append(buf, ptr);
+
+                append_attribute(CUSTOM_SUPPORTS_ATTR, volume.supported_facets.get_triangle_as_string(i));
+                append_attribute(CUSTOM_SEAM_ATTR, volume.seam_facets.get_triangle_as_string(i));
+                append_attribute(MM_SEGMENTATION_ATTR, volume.mm_segmentation_facets.get_triangle_as_string(i));
+
+                out += "/>\n";
+            }
+        };
 
-                std::string custom_seam_data_string = volume->seam_facets.get_triangle_as_string(i);
-                if (! custom_seam_data_string.empty()) {
-                    output_buffer += " ";
-                    output_buffer += CUSTOM_SEAM_ATTR;
-                    output_buffer += "=\"";
-                    output_buffer += custom_seam_data_string;
-                    output_buffer += "\"";
+        // Formatting the coordinates requires "C" locales in the TBB worker threads.
+        TBBLocalesSetter  locales_setter;
+        size_t            next_chunk = 0;
+        std::atomic<bool> failed     = false;
+        tbb::parallel_pipeline(size_t(2 * tbb::this_task_arena::max_concurrency()),
+            tbb::make_filter<void, size_t>(tbb::filter_mode::serial_in_order, [&chunks, &next_chunk, &failed](tbb::flow_control &fc) -> size_t {
+                if (failed || next_chunk == chunks.size()) {
+                    fc.stop();
+                    return 0;
                 }
-
-                std::string mm_painting_data_string = volume->mm_segmentation_facets.get_triangle_as_string(i);
-                if (! mm_painting_data_string.empty()) {
-                    output_buffer += " ";
-                    output_buffer += MM_SEGMENTATION_ATTR;
-                    output_buffer += "=\"";
-                    output_buffer += mm_painting_data_string;
-                    output_buffer += "\"";
+                return next_chunk ++;
+            }) &
+            tbb::make_filter<size_t, size_t>(tbb::filter_mode::parallel, [&chunks, &format_vertices, &format_triangles](size_t chunk_idx) {
+                Chunk &chunk = chunks[chunk_idx];
+                if (chunk.volume != nullptr) {
+                    chunk.text.reserve(size_t(chunk.end - chunk.begin) * 64);
+                    if (chunk.triangles)
+                        format_triangles(chunk, chunk.text);
+                    else
+                        format_vertices(chunk, chunk.text);
                 }
-
-                output_buffer += "/>\n";
-
-                if (! flush())
-                    return false;
-            }
+                return chunk_idx;
+            }) &
+            tbb::make_filter<size_t, void>(tbb::filter_mode::serial_in_order, [&chunks, &context, &failed](size_t chunk_idx) {
+                Chunk &chunk = chunks[chunk_idx];
+                if (! failed && ! chunk.text.empty() && ! mz_zip_writer_add_staged_data(&context, chunk.text.data(), chunk.text.size()))
+                    failed = true;
+                // Release the formatted text early.
+                std::string().swap(chunk.text);
+            }));
+
+        if (failed) {
+            add_error("Error during writing or compression");
+            return false;
         }
-
-        output_buffer += "    </";
-        output_buffer += TRIANGLES_TAG;
-        output_buffer += ">\n   </";
-        output_buffer += MESH_TAG;
-        output_buffer += ">\n";
-
-        // Force flush.
-        return flush(true);
+        return true;
     }
 
     void _3MF_Exporter::add_transformation(std::stringstream &stream, const Transform3d &tr)
@@ -3269,7 +3438,7 @@ namespace Slic3r {
         }
 
         if (!out.empty()) {
-            if (!mz_zip_writer_add_mem(&archive, CUT_INFORMATION_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+            if (!mz_zip_writer_add_mem(&archive, CUT_INFORMATION_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
                 add_error("Unable to add cut information file to archive");
                 return false;
             }
@@ -3303,7 +3472,7 @@ namespace Slic3r {
         }
 
         if (!out.empty()) {
-            if (!mz_zip_writer_add_mem(&archive, LAYER_HEIGHTS_PROFILE_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+            if (!mz_zip_writer_add_mem(&archive, LAYER_HEIGHTS_PROFILE_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
                 add_error("Unable to add layer heights profile file to archive");
                 return false;
             }
@@ -3361,7 +3530,7 @@ namespace Slic3r {
         }
 
         if (!out.empty()) {
-            if (!mz_zip_writer_add_mem(&archive, LAYER_CONFIG_RANGES_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+            if (!mz_zip_writer_add_mem(&archive, LAYER_CONFIG_RANGES_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
                 add_error("Unable to add layer heights profile file to archive");
                 return false;
             }
@@ -3397,7 +3566,7 @@ namespace Slic3r {
             // Adds version header at the beginning:
             out = std::string("support_points_format_version=") + std::to_string(support_points_format_version) + std::string("\n") + out;
 
-            if (!mz_zip_writer_add_mem(&archive, SLA_SUPPORT_POINTS_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+            if (!mz_zip_writer_add_mem(&archive, SLA_SUPPORT_POINTS_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
                 add_error("Unable to add sla support points file to archive");
                 return false;
             }
@@ -3448,7 +3617,7 @@ namespace Slic3r {
             // Adds version header at the beginning:
             out = std::string("drain_holes_format_version=") + std::to_string(drain_holes_format_version) + std::string("\n") + out;
             
-            if (!mz_zip_writer_add_mem(&archive, SLA_DRAIN_HOLES_FILE.c_str(), static_cast<const void*>(out.data()), out.length(), mz_uint(MZ_DEFAULT_COMPRESSION))) {
+            if (!mz_zip_writer_add_mem(&archive, SLA_DRAIN_HOLES_FILE.c_str(), static_cast<const void*>(out.data()), out.length(), m_compression_level)) {
                 add_error("Unable to add sla support points file to archive");
                 return false;
             }
@@ -3468,7 +3637,7 @@ namespace Slic3r {
                 out += "; " + key + " = " + config.opt_serialize(key) + "\n";
 
         if (!out.empty()) {
-            if (!mz_zip_writer_add_mem(&archive, PRINT_CONFIG_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+            if (!mz_zip_writer_add_mem(&archive, PRINT_CONFIG_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
                 add_error("Unable to add print config file to archive");
                 return false;
             }
@@ -3603,7 +3772,7 @@ namespace Slic3r {
 
         std::string out = stream.str();
 
-        if (!mz_zip_writer_add_mem(&archive, MODEL_CONFIG_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+        if (!mz_zip_writer_add_mem(&archive, MODEL_CONFIG_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
             add_error("Unable to add model config file to archive");
             return false;
         }
@@ -3654,7 +3823,7 @@ bool _3MF_Exporter::_add_custom_gcode_per_print_z_file_to_archive( mz_zip_archiv
     } 
 
     if (!out.empty()) {
-        if (!mz_zip_writer_add_mem(&archive, CUSTOM_GCODE_PER_PRINT_Z_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+        if (!mz_zip_writer_add_mem(&archive, CUSTOM_GCODE_PER_PRINT_Z_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
             add_error("Unable to add custom Gcodes per print_z file to archive");
             return false;
         }
@@ -3737,7 +3906,7 @@ bool load_3mf(const char* path, DynamicPrintConfig& config, ConfigSubstitutionCo
     return res;
 }
 
-bool store_3mf(const char* path, Model* model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data, bool zip64)
+bool store_3mf(const char* path, Model* model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data, bool zip64, Zipper::e_compression compression)
 {
     // All export should use "C" locales for number formatting.
     CNumericLocalesSetter locales_setter;
@@ -3746,7 +3915,7 @@ bool store_3mf(const char* path, Model* model, const DynamicPrintConfig* config,
         return false;
 
     _3MF_Exporter exporter;
-    bool res = exporter.save_model_to_file(path, *model, config, fullpath_sources, thumbnail_data, zip64);
+    bool res = exporter.save_model_to_file(path, *model, config, fullpath_sources, thumbnail_data, zip64, compression);
     if (!res)
         exporter.log_errors();
 
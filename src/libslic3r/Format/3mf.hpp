@@ -5,6 +5,8 @@
 #ifndef slic3r_Format_3mf_hpp_
 #define slic3r_Format_3mf_hpp_
 
+#include "libslic3r/Zipper.hpp"
+
 namespace Slic3r {
 
     /* The format for saving the SLA points was changing in the past. This enum holds the latest version that is being currently used.
@@ -41,7 +43,9 @@ namespace Slic3r {
 
     // Save the given model and the config data contained in the given Print into a 3mf file.
     // The model could be modified during the export process if meshes are not repaired or have no shared vertices
-    extern bool store_3mf(const char* path, Model* model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data = nullptr, bool zip64 = true);
+    // Temporary or frequently saved files may be stored with Zipper::FAST_COMPRESSION, trading the file size for speed.
+    extern bool store_3mf(const char* path, Model* model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data = nullptr, bool zip64 = true,
+        Zipper::e_compression compression = Zipper::DEFAULT_COMPRESSION);
 
 } // namespace Slic3r
 
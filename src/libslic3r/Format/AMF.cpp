@@ -7,13 +7,16 @@
 ///|/
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
+#include <charconv>
 #include <limits>
 #include <string.h>
 #include <map>
 #include <string>
+#include <type_traits>
 #include <expat.h>
 
 #include <boost/nowide/cstdio.hpp>
+#include <fast_float.h>
 
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/Exception.hpp"
@@ -66,6 +69,28 @@ const char* SLIC3R_CONFIG_TYPE = "slic3rpe_config";
 namespace Slic3r
 {
 
+// Parse a number from the XML character data collected for a vertex coordinate or a triangle index.
+// Unlike atof() / atoi(), it does not depend on the current locale and it does not need a null terminated copy.
+// Leading white space is skipped, malformed input is parsed as zero, matching atof() / atoi().
+template<typename T>
+static inline T parse_amf_number(const std::string &str)
+{
+    const char *begin = str.data();
+    const char *end   = begin + str.size();
+    while (begin != end && (*begin == ' ' || *begin == '\t' || *begin == '\n' || *begin == '\r'))
+        ++ begin;
+    if (begin != end && *begin == '+')
+        ++ begin;
+    T value = 0;
+    if constexpr (std::is_floating_point_v<T>) {
+        if (fast_float::from_chars(begin, end, value).ec != std::errc())
+            value = 0;
+    } else {
+        if (std::from_chars(begin, end, value).ec != std::errc())
+            value = 0;
+    }
+    return value;
+}
 
 struct AMFParserContext
 {
@@ -608,7 +633,7 @@ void AMFParserContext::endElement(const char * /* name */)
     case NODE_TYPE_VERTEX:
         assert(m_object);
         // Parse the vertex data
-        m_object_vertices.emplace_back(float(atof(m_value[0].c_str())), float(atof(m_value[1].c_str())), float(atof(m_value[2].c_str())));
+        m_object_vertices.emplace_back(parse_amf_number<float>(m_value[0]), parse_amf_number<float>(m_value[1]), parse_amf_number<float>(m_value[2]));
         m_value[0].clear();
         m_value[1].clear();
         m_value[2].clear();
@@ -617,7 +642,7 @@ void AMFParserContext::endElement(const char * /* name */)
     // Faces of the current volume:
     case NODE_TYPE_TRIANGLE:
         assert(m_object && m_volume);
-        m_volume_facets.emplace_back(atoi(m_value[0].c_str()), atoi(m_value[1].c_str()), atoi(m_value[2].c_str()));
+        m_volume_facets.emplace_back(parse_amf_number<int>(m_value[0]), parse_amf_number<int>(m_value[1]), parse_amf_number<int>(m_value[2]));
         m_value[0].clear();
         m_value[1].clear();
         m_value[2].clear();
@@ -647,12 +672,25 @@ void AMFParserContext::endElement(const char * /* name */)
                 }
             }
 
-            // rebase indices to the current vertices list
+            // Copy just the vertices referenced by this volume out of the shared object vertex list, keeping their order,
+            // and remap the face indices in place. This avoids copying the whole vertex span first and compactifying it later.
+            std::vector<int> vertex_map(size_t(max_id - min_id + 1), -1);
+            for (const Vec3i &face : m_volume_facets)
+                for (const int tri_id : face)
+                    vertex_map[tri_id - min_id] = 0;
+            indexed_triangle_set its;
+            int num_vertices = 0;
+            for (int &new_id : vertex_map)
+                if (new_id == 0)
+                    new_id = num_vertices ++;
+            its.vertices.reserve(num_vertices);
+            for (int i = 0; i < int(vertex_map.size()); ++ i)
+                if (vertex_map[i] != -1)
+                    its.vertices.emplace_back(m_object_vertices[min_id + i]);
             for (Vec3i &face : m_volume_facets)
-                face -= Vec3i(min_id, min_id, min_id);
-
-            indexed_triangle_set its { std::move(m_volume_facets), { m_object_vertices.begin() + min_id, m_object_vertices.begin() + max_id + 1 } };
-            its_compactify_vertices(its);
+                for (int &tri_id : face)
+                    tri_id = vertex_map[tri_id - min_id];
+            its.indices = std::move(m_volume_facets);
             if (its_volume(its) < 0)
                 its_flip_triangles(its);
             m_volume->set_mesh(std::move(its));
@@ -892,16 +930,22 @@ bool load_amf_file(const char *path, DynamicPrintConfig *config, ConfigSubstitut
     XML_SetElementHandler(parser, AMFParserContext::startElement, AMFParserContext::endElement);
     XML_SetCharacterDataHandler(parser, AMFParserContext::characters);
 
-    char buff[8192];
+    // Read directly into the parser's own buffer to avoid an extra copy of each chunk.
+    static constexpr int buffer_size = 65536;
     bool result = false;
     for (;;) {
-        int len = (int)fread(buff, 1, 8192, pFile);
+        void *buff = XML_GetBuffer(parser, buffer_size);
+        if (buff == nullptr) {
+            BOOST_LOG_TRIVIAL(error) << "Couldn't allocate memory for parser buffer";
+            break;
+        }
+        int len = (int)fread(buff, 1, buffer_size, pFile);
         if (ferror(pFile)) {
             BOOST_LOG_TRIVIAL(error) << "AMF parser: Read error";
             break;
         }
         int done = feof(pFile);
-        if (XML_Parse(parser, buff, len, done) == XML_STATUS_ERROR || ctx.error()) {
+        if (XML_ParseBuffer(parser, len, done) == XML_STATUS_ERROR || ctx.error()) {
             BOOST_LOG_TRIVIAL(error) << "AMF parser: Parse error at line " << int(XML_GetCurrentLineNumber(parser)) << ": " << ctx.error_message();
             break;
         }
@@ -76,7 +76,8 @@ struct AnycubicSLARasterEncoder
         size_t               span_len;
         std::uint8_t         pixel;
         auto                 size = w * h * num_components;
-        dst.reserve(size);
+        // Don't reserve the size of the raw raster, the encoded layers are held
+        // until the archive is written and the capacity would be never released.
 
         const std::uint8_t *src = reinterpret_cast<const std::uint8_t *>(ptr);
         const std::uint8_t *src_end = src + size;
@@ -97,6 +98,7 @@ struct AnycubicSLARasterEncoder
             }
         }
 
+        dst.shrink_to_fit();
         return sla::EncodedRaster(std::move(dst), "pwimg");
     }
 };
@@ -412,6 +414,10 @@ std::unique_ptr<sla::RasterBase> AnycubicSLAArchive::create_raster() const
 
     double gamma = m_cfg.gamma_correction.getFloat();
 
+    // Without anti-aliasing the pixels are either black or white, the faster scanline fill is sufficient.
+    if (gamma <= 0.)
+        return sla::create_raster_grayscale_binary(res, pxdim, tr);
+
     return sla::create_raster_grayscale_aa(res, pxdim, gamma, tr);
 }
 
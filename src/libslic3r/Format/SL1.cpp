@@ -274,12 +274,16 @@ std::unique_ptr<sla::RasterBase> SL1Archive::create_raster() const
 
     double gamma = m_cfg.gamma_correction.getFloat();
 
+    // Without anti-aliasing the pixels are either black or white, the faster scanline fill is sufficient.
+    if (gamma <= 0.)
+        return sla::create_raster_grayscale_binary(res, pxdim, tr);
+
     return sla::create_raster_grayscale_aa(res, pxdim, gamma, tr);
 }
 
 sla::RasterEncoder SL1Archive::get_encoder() const
 {
-    return sla::PNGRasterEncoder{};
+    return sla::PNGRasterEncoder{ m_cfg.sla_archive_compression_level.value };
 }
 
 static void write_thumbnail(Zipper &zipper, const ThumbnailData &data)
@@ -294,7 +298,7 @@ static void write_thumbnail(Zipper &zipper, const ThumbnailData &data)
         zipper.add_entry("thumbnail/thumbnail" + std::to_string(data.width) +
                              "x" + std::to_string(data.height) + ".png",
                          static_cast<const std::uint8_t *>(png_data),
-                         png_size);
+                         png_size, Zipper::NO_COMPRESSION);
 
         mz_free(png_data);
     }
@@ -332,7 +336,8 @@ void SL1Archive::export_print(Zipper               &zipper,
             std::string imgname = project + string_printf("%.5d", i++) + "." +
                                   rst.extension();
 
-            zipper.add_entry(imgname.c_str(), rst.data(), rst.size());
+            // The PNG images are deflated already, compressing them again would only cost time.
+            zipper.add_entry(imgname, rst.data(), rst.size(), Zipper::NO_COMPRESSION);
         }
 
         for (const ThumbnailData& data : thumbnails)
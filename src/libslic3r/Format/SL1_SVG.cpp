@@ -15,6 +15,7 @@
 #include "libslic3r/Polygon.hpp"
 #include "libslic3r/PrintConfig.hpp"
 #include "libslic3r/Zipper.hpp"
+#include "libslic3r/Execution/ExecutionTBB.hpp"
 #include "libslic3r/libslic3r.h"
 
 #define NANOSVG_IMPLEMENTATION
@@ -286,45 +287,60 @@ ConfigSubstitutions SL1_SVGReader::read(std::vector<ExPolygons> &slices,
     {
         double                                 incr, val, prev;
         bool                                   stop  = false;
+        execution::SpinningMutex<ExecutionTBB> mutex = {};
     } st{100. / arch.entries.size(), 0., 0.};
 
-    for (const EntryBuffer &entry : arch.entries) {
-        if (st.stop) break;
-
-        st.val += st.incr;
-        double curr = std::round(st.val);
-        if (curr > st.prev) {
-            st.prev = curr;
-            st.stop = !m_progr(int(curr));
-        }
+    slices.assign(arch.entries.size(), ExPolygons{});
+
+    // The layers are parsed and unioned independently of each other, see also extract_slices_from_sla_archive() in SL1.cpp
+    execution::for_each(
+        ex_tbb, size_t(0), arch.entries.size(),
+        [this, &arch, &slices, &st, &rstp](size_t idx) {
+            // Status indication guarded with the spinlock
+            {
+                std::lock_guard lck(st.mutex);
+                if (st.stop) return;
+
+                st.val += st.incr;
+                double curr = std::round(st.val);
+                if (curr > st.prev) {
+                    st.prev = curr;
+                    st.stop = !m_progr(int(curr));
+                }
+            }
 
-        // Don't want to use dirty casts for the buffer to be usable in
-        // the NanoSVGParser until performance is not a bottleneck here.
-        auto svgtxt = reserve_vector<char>(entry.buf.size() + 1);
-        std::copy(entry.buf.begin(), entry.buf.end(), std::back_inserter(svgtxt));
-        svgtxt.emplace_back('\0');
-        NanoSVGParser svgp(svgtxt.data());
-
-        Polygons polys;
-        for (NSVGshape *shape = svgp.image->shapes; shape != nullptr; shape = shape->next) {
-            for (NSVGpath *path = shape->paths; path != nullptr; path = path->next) {
-                Polygon p;
-                for (int i = 0; i < path->npts; ++i) {
-                    size_t c = 2 * i;
-                    p.points.emplace_back(scaled(Vec2f(path->pts[c], path->pts[c + 1])));
+            const EntryBuffer &entry = arch.entries[idx];
+
+            // Don't want to use dirty casts for the buffer to be usable in
+            // the NanoSVGParser until performance is not a bottleneck here.
+            auto svgtxt = reserve_vector<char>(entry.buf.size() + 1);
+            std::copy(entry.buf.begin(), entry.buf.end(), std::back_inserter(svgtxt));
+            svgtxt.emplace_back('\0');
+            NanoSVGParser svgp(svgtxt.data());
+
+            Polygons polys;
+            for (NSVGshape *shape = svgp.image->shapes; shape != nullptr; shape = shape->next) {
+                for (NSVGpath *path = shape->paths; path != nullptr; path = path->next) {
+                    Polygon p;
+                    for (int i = 0; i < path->npts; ++i) {
+                        size_t c = 2 * i;
+                        p.points.emplace_back(scaled(Vec2f(path->pts[c], path->pts[c + 1])));
+                    }
+                    polys.emplace_back(p);
                 }
-                polys.emplace_back(p);
             }
-        }
 
-        // Create the slice from the read polygons. Here, the fill rule has to
-        // be the same as stated in the svg file which is `nonzero` when exported
-        // using SL1_SVGArchive. Would be better to parse it from the svg file,
-        // but if it's different, the file is probably corrupted anyways.
-        ExPolygons expolys = union_ex(polys, ClipperLib::pftNonZero);
-        invert_raster_trafo(expolys, rstp.trafo, rstp.width, rstp.height);
-        slices.emplace_back(expolys);
-    }
+            // Create the slice from the read polygons. Here, the fill rule has to
+            // be the same as stated in the svg file which is `nonzero` when exported
+            // using SL1_SVGArchive. Would be better to parse it from the svg file,
+            // but if it's different, the file is probably corrupted anyways.
+            ExPolygons expolys = union_ex(polys, ClipperLib::pftNonZero);
+            invert_raster_trafo(expolys, rstp.trafo, rstp.width, rstp.height);
+            slices[idx] = std::move(expolys);
+        },
+        execution::max_concurrency(ex_tbb));
+
+    if (st.stop) slices = {};
 
     // Compile error without the move
     return std::move(config_substitutions);
@@ -27,7 +27,7 @@
 namespace Slic3r {
 
 #if __APPLE__
-extern "C" bool load_step_internal(const char *path, OCCTResult* res);
+extern "C" bool load_step_internal(const char *path, OCCTResult* res, double linear_deflection, double angular_deflection);
 #endif
 
 LoadStepFn get_load_step_fn()
@@ -80,7 +80,16 @@ LoadStepFn get_load_step_fn()
     return load_step_fn;
 }
 
-bool load_step(const char *path, Model *model /*BBS:, ImportStepProgressFn proFn*/)
+STEPMeshParams STEPMeshParams::preset(Preset preset)
+{
+    switch (preset) {
+    case Preset::Draft: return { 0.02, 1. };
+    case Preset::Fine:  return { 0.001, 0.25 };
+    default:            return {};
+    }
+}
+
+bool load_step(const char *path, Model *model, const STEPMeshParams &mesh_params /*BBS:, ImportStepProgressFn proFn*/)
 {
     OCCTResult occt_object;
 
@@ -89,7 +98,7 @@ bool load_step(const char *path, Model *model /*BBS:, ImportStepProgressFn proFn
     if (!load_step_fn)
         return false;
 
-    load_step_fn(path, &occt_object);
+    load_step_fn(path, &occt_object, mesh_params.linear_deflection, mesh_params.angular_deflection);
 
     assert(! occt_object.volumes.empty());
     
@@ -13,10 +13,30 @@ namespace Slic3r {
 
 class Model;
 
+// Parameters of the tessellation of the STEP solids.
+struct STEPMeshParams
+{
+    enum class Preset {
+        // Coarse mesh, fast to generate.
+        Draft,
+        // Default.
+        Normal,
+        // Fine mesh of curved surfaces, slow to generate for large assemblies.
+        Fine,
+    };
+
+    // Maximum distance of the mesh from the surface, in mm.
+    double linear_deflection  { 0.005 };
+    // Maximum angle between the normals of adjacent facets, in radians.
+    double angular_deflection { 1. };
+
+    static STEPMeshParams preset(Preset preset);
+};
+
 //typedef std::function<void(int load_stage, int current, int total, bool& cancel)> ImportStepProgressFn;
 
 // Load a step file into a provided model.
-extern bool load_step(const char *path_str, Model *model /*LMBBS:, ImportStepProgressFn proFn = nullptr*/);
+extern bool load_step(const char *path_str, Model *model, const STEPMeshParams &mesh_params = {} /*LMBBS:, ImportStepProgressFn proFn = nullptr*/);
 
 }; // namespace Slic3r
 
@@ -6,6 +6,10 @@
 #include <boost/nowide/cstdio.hpp>
 #include <LocalesUtils.hpp>
 #include <fast_float.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include <algorithm>
 #include <new>
 #include <system_error>
 #include <utility>
@@ -15,6 +19,7 @@
 #include <cstring>
 
 #include "objparser.hpp"
+#include "libslic3r/Thread.hpp"
 
 namespace ObjParser {
 
@@ -32,7 +37,17 @@ static double strtod_clocale(const char* str, char const** str_end)
 	return val;
 }
 
-static bool obj_parseline(const char *line, ObjData &data)
+// Face vertex referencing a coordinate, a texture coordinate or a normal by a negative (relative) index.
+// If a file is parsed in chunks, the relative indices are resolved against the chunk and shifted when the chunks are merged.
+struct ObjRelativeVertex
+{
+	size_t	vertexIdx;
+	bool	coord;
+	bool	textureCoord;
+	bool	normal;
+};
+
+static bool obj_parseline(const char *line, ObjData &data, std::vector<ObjRelativeVertex> *relative_vertices = nullptr)
 {
 #define EATWS() while (*line == ' ' || *line == '\t') ++ line
 
@@ -239,6 +254,8 @@ static bool obj_parseline(const char *line, ObjData &data)
 					line = endptr;
 				}
 			}
+			if (relative_vertices != nullptr && (vertex.coordIdx < 0 || vertex.normalIdx < 0 || vertex.textureCoordIdx < 0))
+				relative_vertices->push_back({ data.vertices.size(), vertex.coordIdx < 0, vertex.textureCoordIdx < 0, vertex.normalIdx < 0 });
 			if (vertex.coordIdx < 0)
                 vertex.coordIdx += (int)data.coordinates.size() / 4;
             else
@@ -346,54 +363,136 @@ static bool obj_parseline(const char *line, ObjData &data)
 	return true;
 }
 
+// Append data parsed from a chunk of a file to data parsed from the preceding chunks.
+static void obj_append_chunk(ObjData &data, ObjData &&chunk, const std::vector<ObjRelativeVertex> &relative_vertices)
+{
+	const int coordIdxOffset        = (int)data.coordinates.size() / 4;
+	const int textureCoordIdxOffset = (int)data.textureCoordinates.size() / 3;
+	const int normalIdxOffset       = (int)data.normals.size() / 3;
+	const int vertexIdxOffset       = (int)data.vertices.size();
+	for (const ObjRelativeVertex &rv : relative_vertices) {
+		ObjVertex &vertex = chunk.vertices[rv.vertexIdx];
+		if (rv.coord)
+			vertex.coordIdx += coordIdxOffset;
+		if (rv.textureCoord)
+			vertex.textureCoordIdx += textureCoordIdxOffset;
+		if (rv.normal)
+			vertex.normalIdx += normalIdxOffset;
+	}
+	auto append = [](auto &dst, auto &src) {
+		if (dst.empty())
+			dst = std::move(src);
+		else
+			dst.insert(dst.end(), std::make_move_iterator(src.begin()), std::make_move_iterator(src.end()));
+	};
+	auto append_shifted = [&append, vertexIdxOffset](auto &dst, auto &src) {
+		for (auto &item : src)
+			item.vertexIdxFirst += vertexIdxOffset;
+		append(dst, src);
+	};
+	append(data.coordinates, chunk.coordinates);
+	append(data.textureCoordinates, chunk.textureCoordinates);
+	append(data.normals, chunk.normals);
+	append(data.parameters, chunk.parameters);
+	append(data.mtllibs, chunk.mtllibs);
+	append_shifted(data.usemtls, chunk.usemtls);
+	append_shifted(data.objects, chunk.objects);
+	append_shifted(data.groups, chunk.groups);
+	append_shifted(data.smoothingGroups, chunk.smoothingGroups);
+	append(data.vertices, chunk.vertices);
+}
+
 bool objparse(const char *path, ObjData &data)
 {
     Slic3r::CNumericLocalesSetter locales_setter;
 
-	FILE *pFile = boost::nowide::fopen(path, "rt");
+	FILE *pFile = boost::nowide::fopen(path, "rb");
 	if (pFile == 0)
 		return false;
 
-	constexpr size_t half_buf = 65536;
+	// Lines longer than that are considered an error.
+	constexpr size_t max_line_length = 65536;
+	// Chunks of the file smaller than that are not worth parsing in parallel.
+	constexpr size_t min_chunk_size  = 1 << 20;
+
 	try {
-        char buf[half_buf * 2];
-		size_t len = 0;
-		size_t lenPrev = 0;
-        while ((len = ::fread(buf + lenPrev, 1, half_buf-1, pFile)) != 0) {
-            if (std::feof(pFile)) {
-                // Fix issue with missing last trinagle in obj file:
-                // https://github.com/prusa3d/PrusaSlicer/issues/12157
-                // algorithm expect line endings after last face
-                // but file format support it
-                buf[len+lenPrev] = '\n';
-                ++len;
-            }
-			len += lenPrev;
-			size_t lastLine = 0;
-			for (size_t i = 0; i < len; ++ i)
-				if (buf[i] == '\r' || buf[i] == '\n') {
-					buf[i] = 0;
-					char *c = buf + lastLine;
-					while (*c == ' ' || *c == '\t')
-						++ c;
-					//FIXME check the return value and exit on error?
-					// Will it break parsing of some obj files?
-					obj_parseline(c, data);
-					lastLine = i + 1;
-				}
-			lenPrev = len - lastLine;
-            if (lenPrev > half_buf) {
-		    	BOOST_LOG_TRIVIAL(error) << "ObjParser: Excessive line length";
+		// Read the whole file, terminated by a new line even if the last line of the file is not:
+		// https://github.com/prusa3d/PrusaSlicer/issues/12157
+		std::vector<char> buf;
+		{
+			std::fseek(pFile, 0, SEEK_END);
+			long size = std::ftell(pFile);
+			std::fseek(pFile, 0, SEEK_SET);
+			if (size < 0) {
 				::fclose(pFile);
 				return false;
 			}
-			memmove(buf, buf + lastLine, lenPrev);
+			buf.assign(size_t(size) + 1, '\n');
+			if (::fread(buf.data(), 1, size_t(size), pFile) != size_t(size)) {
+				BOOST_LOG_TRIVIAL(error) << "ObjParser: Error reading file " << path;
+				::fclose(pFile);
+				return false;
+			}
+		}
+		::fclose(pFile);
+		pFile = nullptr;
+
+		// Split the file into chunks at line boundaries, the chunks are parsed in parallel independently
+		// and then merged into data in order.
+		std::vector<size_t> chunk_ends;
+		{
+			const size_t num_chunks = std::clamp<size_t>(buf.size() / min_chunk_size, 1, 4 * size_t(tbb::this_task_arena::max_concurrency()));
+			for (size_t i = 1; i < num_chunks; ++ i) {
+				size_t begin = std::max(i * (buf.size() / num_chunks), chunk_ends.empty() ? 0 : chunk_ends.back());
+				auto   it    = std::find_if(buf.begin() + begin, buf.end(), [](char c){ return c == '\r' || c == '\n'; });
+				if (it == buf.end() || it + 1 == buf.end())
+					break;
+				chunk_ends.emplace_back(it + 1 - buf.begin());
+			}
+			chunk_ends.emplace_back(buf.size());
+		}
+
+		std::vector<ObjData>                        chunks(chunk_ends.size());
+		std::vector<std::vector<ObjRelativeVertex>> chunks_relative_vertices(chunk_ends.size());
+		std::vector<char>                           chunks_failed(chunk_ends.size(), false);
+		// obj_parseline() expects "C" locales, set them for the TBB worker threads.
+		Slic3r::TBBLocalesSetter tbb_locales_setter;
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, chunk_ends.size(), 1), [&](const tbb::blocked_range<size_t> &range) {
+			for (size_t chunk_idx = range.begin(); chunk_idx < range.end(); ++ chunk_idx) {
+				size_t lastLine = chunk_idx == 0 ? 0 : chunk_ends[chunk_idx - 1];
+				for (size_t i = lastLine; i < chunk_ends[chunk_idx]; ++ i)
+					if (buf[i] == '\r' || buf[i] == '\n') {
+						if (i - lastLine > max_line_length) {
+							chunks_failed[chunk_idx] = true;
+							return;
+						}
+						buf[i] = 0;
+						char *c = buf.data() + lastLine;
+						while (*c == ' ' || *c == '\t')
+							++ c;
+						//FIXME check the return value and exit on error?
+						// Will it break parsing of some obj files?
+						obj_parseline(c, chunks[chunk_idx], &chunks_relative_vertices[chunk_idx]);
+						lastLine = i + 1;
+					}
+			}
+		});
+		if (std::find(chunks_failed.begin(), chunks_failed.end(), true) != chunks_failed.end()) {
+			BOOST_LOG_TRIVIAL(error) << "ObjParser: Excessive line length";
+			return false;
+		}
+		buf = std::vector<char>();
+
+		for (size_t chunk_idx = 0; chunk_idx < chunks.size(); ++ chunk_idx) {
+			obj_append_chunk(data, std::move(chunks[chunk_idx]), chunks_relative_vertices[chunk_idx]);
+			chunks[chunk_idx] = ObjData();
 		}
     }
     catch (std::bad_alloc&) {
     	BOOST_LOG_TRIVIAL(error) << "ObjParser: Out of memory";
 	}
-	::fclose(pFile);
+	if (pFile != nullptr)
+		::fclose(pFile);
 
 	// printf("vertices: %d\r\n", data.vertices.size() / 4);
 	// printf("coords: %d\r\n", data.coordinates.size());
@@ -67,7 +67,10 @@
 
 #include "SVG.hpp"
 
+#include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
 
 // Intel redesigned some TBB interface considerably when merging TBB with their oneAPI set of libraries, see GH #7332.
 // We are using quite an old TBB 2017 U7. Before we update our build servers, let's use the old API, which is deprecated in up to date TBB.
@@ -576,7 +579,8 @@ GCodeGenerator::GCodeGenerator(const Print* print) :
     m_print(print)
     {}
 
-void GCodeGenerator::do_export(Print* print, const char* path, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb)
+void GCodeGenerator::do_export(Print* print, const char* path, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb,
+    GCodeProcessor::PartialResultCallback partial_result_cb)
 {
     CNumericLocalesSetter locales_setter;
 
@@ -614,6 +618,8 @@ void GCodeGenerator::do_export(Print* print, const char* path, GCodeProcessorRes
 
     m_processor.initialize(path_tmp);
     m_processor.set_print(print);
+    if (partial_result_cb != nullptr)
+        m_processor.set_partial_result_callback(std::move(partial_result_cb));
     m_processor.get_binary_data() = bgcode::binarize::BinaryData();
     GCodeOutputStream file(boost::nowide::fopen(path_tmp.c_str(), "wb"), m_processor);
     if (! file.is_open())
@@ -1250,6 +1256,16 @@ void GCodeGenerator::_do_export(Print& print, GCodeOutputStream &file, Thumbnail
     if (print.config().complete_objects.value) {
         size_t finished_objects = 0;
         const PrintObject *prev_object = (*print_object_instance_sequential_active)->print_object;
+        // While process_layers() exports one object instance, the layers of the next instance are collected and its first layers
+        // are preprocessed in the background, so that the pipeline does not start empty at each object boundary.
+        // The G-code generator itself is not run ahead, as it depends on the state (position, extruder, temperatures)
+        // left over by the previous instance.
+        struct PrefetchedInstance {
+            const PrintInstance         *instance { nullptr };
+            ObjectsLayerToPrint          layers_to_print;
+            std::vector<LayerToProcess>  layers_to_process;
+        } prefetched;
+        tbb::task_group prefetch_task;
         for (; print_object_instance_sequential_active != print_object_instances_ordering.end(); ++ print_object_instance_sequential_active) {
             const PrintObject &object = *(*print_object_instance_sequential_active)->print_object;
             if (&object != prev_object || tool_ordering.first_extruder() != final_extruder_id) {
@@ -1290,10 +1306,28 @@ void GCodeGenerator::_do_export(Print& print, GCodeOutputStream &file, Thumbnail
             // Reset the cooling buffer internal state (the current position, feed rate, accelerations).
             m_cooling_buffer->reset(this->writer().get_position());
             m_cooling_buffer->set_current_extruder(initial_extruder_id);
+            prefetch_task.wait();
+            PrefetchedInstance current;
+            if (prefetched.instance == *print_object_instance_sequential_active)
+                current = std::move(prefetched);
+            else
+                current.layers_to_print = collect_layers_to_print(object);
+            prefetched = {};
+            if (auto it_next = std::next(print_object_instance_sequential_active); it_next != print_object_instances_ordering.end())
+                prefetch_task.run([&print, &prefetched, next_instance = *it_next]() {
+                    try {
+                        prefetched.layers_to_print   = collect_layers_to_print(*next_instance->print_object);
+                        prefetched.layers_to_process = precompute_layers_to_process(print, prefetched.layers_to_print);
+                        prefetched.instance          = next_instance;
+                    } catch (...) {
+                        // The next instance will be processed from scratch, reporting the error when it is being exported.
+                        prefetched = {};
+                    }
+                });
             // Process all layers of a single object instance (sequential mode) with a parallel pipeline:
             // Generate G-code, run the filters (vase mode, cooling buffer), run the G-code analyser
             // and export G-code into file.
-            this->process_layers(print, tool_ordering, collect_layers_to_print(object),
+            this->process_layers(print, tool_ordering, std::move(current.layers_to_print), std::move(current.layers_to_process),
                 *print_object_instance_sequential_active - object.instances().data(), 
                 smooth_path_cache_global, file);
             ++ finished_objects;
@@ -1302,6 +1336,7 @@ void GCodeGenerator::_do_export(Print& print, GCodeOutputStream &file, Thumbnail
             m_second_layer_things_done = false;
             prev_object = &object;
         }
+        prefetch_task.wait();
 
         file.write(m_label_objects.maybe_stop_instance());
     } else {
@@ -1483,6 +1518,48 @@ void GCodeGenerator::smooth_path_interpolate(
         out.interpolate_add(layer->support_fills, params);
 }
 
+// Maximum number of layers in flight in the process_layers() pipeline. Each token holds the G-code of a single layer,
+// thus the count scales with the number of threads to keep them busy, but it never drops below the former fixed count.
+static size_t process_layers_max_tokens()
+{
+    return size_t(std::max(12, 2 * tbb::this_task_arena::max_concurrency()));
+}
+
+// The boundaries used by AvoidCrossingPerimeters::travel_to() only depend on the layer, thus they are computed
+// by a parallel stage of the process_layers() pipeline instead of lazily by the serial G-code generator.
+static LayerToProcess precompute_travel_boundaries(
+    const Print &print, size_t layer_to_print_idx, GCode::SmoothPathCache &&smooth_path_cache,
+    // Range of layers to be printed, empty for the NOP layer.
+    const GCode::ObjectLayerToPrint *layers_begin, const GCode::ObjectLayerToPrint *layers_end)
+{
+    LayerToProcess out { layer_to_print_idx, std::move(smooth_path_cache), {} };
+    if (layers_begin != layers_end && print.config().avoid_crossing_perimeters) {
+        // Travels around the objects are only planned when moving between object instances.
+        size_t num_instances = 0;
+        for (const PrintObject *object : print.objects())
+            num_instances += object->instances().size();
+        for (const GCode::ObjectLayerToPrint *layer_to_print = layers_begin; layer_to_print != layers_end; ++ layer_to_print)
+            if (const Layer *layer = layer_to_print->layer(); layer != nullptr)
+                out.travel_boundaries.emplace_back(layer, AvoidCrossingPerimeters::make_layer_boundaries(*layer, true, num_instances > 1));
+    }
+    return out;
+}
+
+std::vector<LayerToProcess> GCodeGenerator::precompute_layers_to_process(const Print &print, const ObjectsLayerToPrint &layers_to_print)
+{
+    const GCode::SmoothPathCache::InterpolationParameters interpolation_params = interpolation_parameters(print.config());
+    std::vector<LayerToProcess> out(std::min(layers_to_print.size(), process_layers_max_tokens()));
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, out.size()), [&print, &layers_to_print, &interpolation_params, &out](const tbb::blocked_range<size_t> &range) {
+        for (size_t idx = range.begin(); idx < range.end(); ++ idx) {
+            GCode::SmoothPathCache smooth_path_cache;
+            GCodeGenerator::smooth_path_interpolate(layers_to_print[idx], interpolation_params, smooth_path_cache);
+            const ObjectLayerToPrint *layer = &layers_to_print[idx];
+            out[idx] = precompute_travel_boundaries(print, idx, std::move(smooth_path_cache), layer, layer + 1);
+        }
+    });
+    return out;
+}
+
 // Process all layers of all objects (non-sequential mode) with a parallel pipeline:
 // Generate G-code, run the filters (vase mode, cooling buffer), run the G-code analyser
 // and export G-code into file.
@@ -1496,8 +1573,8 @@ void GCodeGenerator::process_layers(
 {
     size_t layer_to_print_idx = 0;
     const GCode::SmoothPathCache::InterpolationParameters interpolation_params = interpolation_parameters(print.config());
-    const auto smooth_path_interpolator = tbb::make_filter<void, std::pair<size_t, GCode::SmoothPathCache>>(slic3r_tbb_filtermode::serial_in_order,
-        [this, &print, &layers_to_print, &layer_to_print_idx, &interpolation_params](tbb::flow_control &fc) -> std::pair<size_t, GCode::SmoothPathCache> {
+    const auto layer_index = tbb::make_filter<void, size_t>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &print, &layers_to_print, &layer_to_print_idx](tbb::flow_control &fc) -> size_t {
             if (layer_to_print_idx >= layers_to_print.size()) {
                 if (layer_to_print_idx == layers_to_print.size() + (m_pressure_equalizer ? 1 : 0)) {
                     fc.stop();
@@ -1505,21 +1582,33 @@ void GCodeGenerator::process_layers(
                 } else {
                     // Pressure equalizer need insert empty input. Because it returns one layer back.
                     // Insert NOP (no operation) layer;
-                    return { layer_to_print_idx ++, {} };
+                    return layer_to_print_idx ++;
                 }
             } else {
                 print.throw_if_canceled();
-                size_t idx = layer_to_print_idx ++;
-                GCode::SmoothPathCache smooth_path_cache;
+                return layer_to_print_idx ++;
+            }
+        });
+    // Arc fitting is expensive, the layers are interpolated in parallel.
+    const auto smooth_path_interpolator = tbb::make_filter<size_t, std::pair<size_t, GCode::SmoothPathCache>>(slic3r_tbb_filtermode::parallel,
+        [&layers_to_print, &interpolation_params](size_t idx) -> std::pair<size_t, GCode::SmoothPathCache> {
+            GCode::SmoothPathCache smooth_path_cache;
+            if (idx < layers_to_print.size())
                 for (const ObjectLayerToPrint &l : layers_to_print[idx].second)
                     GCodeGenerator::smooth_path_interpolate(l, interpolation_params, smooth_path_cache);
-                return { idx, std::move(smooth_path_cache) };
-            }
+            return { idx, std::move(smooth_path_cache) };
         });
-    const auto generator = tbb::make_filter<std::pair<size_t, GCode::SmoothPathCache>, LayerResult>(slic3r_tbb_filtermode::serial_in_order,
+    const auto travel_boundaries = tbb::make_filter<std::pair<size_t, GCode::SmoothPathCache>, LayerToProcess>(slic3r_tbb_filtermode::parallel,
+        [&print, &layers_to_print](std::pair<size_t, GCode::SmoothPathCache> in) -> LayerToProcess {
+            const ObjectsLayerToPrint *layers = in.first < layers_to_print.size() ? &layers_to_print[in.first].second : nullptr;
+            return layers ?
+                precompute_travel_boundaries(print, in.first, std::move(in.second), layers->data(), layers->data() + layers->size()) :
+                precompute_travel_boundaries(print, in.first, std::move(in.second), nullptr, nullptr);
+        });
+    const auto generator = tbb::make_filter<LayerToProcess, LayerResult>(slic3r_tbb_filtermode::serial_in_order,
         [this, &print, &tool_ordering, &print_object_instances_ordering, &layers_to_print, &smooth_path_cache_global](
-            std::pair<size_t, GCode::SmoothPathCache> in) -> LayerResult {
-            size_t layer_to_print_idx = in.first;
+            LayerToProcess in) -> LayerResult {
+            size_t layer_to_print_idx = in.layer_to_print_idx;
             if (layer_to_print_idx == layers_to_print.size()) {
                 // Pressure equalizer need insert empty input. Because it returns one layer back.
                 // Insert NOP (no operation) layer;
@@ -1530,8 +1619,9 @@ void GCodeGenerator::process_layers(
                 if (m_wipe_tower && layer_tools.has_wipe_tower)
                     m_wipe_tower->next_layer();
                 print.throw_if_canceled();
+                m_avoid_crossing_perimeters.set_precomputed_layer_boundaries(std::move(in.travel_boundaries));
                 return this->process_layer(print, layer.second, layer_tools, 
-                    GCode::SmoothPathCaches{ smooth_path_cache_global, in.second }, 
+                    GCode::SmoothPathCaches{ smooth_path_cache_global, in.smooth_path_cache }, 
                     &layer == &layers_to_print.back(), &print_object_instances_ordering, size_t(-1));
             }
         });
@@ -1559,11 +1649,15 @@ void GCodeGenerator::process_layers(
         [find_replace = this->m_find_replace.get()](std::string s) -> std::string {
             return find_replace->process_layer(std::move(s));
         });
-    const auto output = tbb::make_filter<std::string, void>(slic3r_tbb_filtermode::serial_in_order,
-        [&output_stream](std::string s) { output_stream.write(s); }
+    // Writing into the file and feeding the GCodeProcessor are separate serial stages, thus the G-code of a layer may be
+    // processed while the next layer is being written.
+    const auto output = tbb::make_filter<std::string, std::string>(slic3r_tbb_filtermode::serial_in_order,
+        [&output_stream](std::string s) -> std::string { output_stream.write_to_file(s); return s; }
+    ) & tbb::make_filter<std::string, void>(slic3r_tbb_filtermode::serial_in_order,
+        [&output_stream](std::string s) { output_stream.process(s); }
     );
 
-    tbb::filter<void, LayerResult> pipeline_to_layerresult = smooth_path_interpolator & generator;
+    tbb::filter<void, LayerResult> pipeline_to_layerresult = layer_index & smooth_path_interpolator & travel_boundaries & generator;
     if (m_spiral_vase)
         pipeline_to_layerresult = pipeline_to_layerresult & spiral_vase;
     if (m_pressure_equalizer)
@@ -1578,7 +1672,7 @@ void GCodeGenerator::process_layers(
     TBBLocalesSetter locales_setter;
     // The pipeline elements are joined using const references, thus no copying is performed.
     output_stream.find_replace_supress();
-    tbb::parallel_pipeline(12, pipeline_to_layerresult & pipeline_to_string & output);
+    tbb::parallel_pipeline(process_layers_max_tokens(), pipeline_to_layerresult & pipeline_to_string & output);
     output_stream.find_replace_enable();
 }
 
@@ -1589,14 +1683,16 @@ void GCodeGenerator::process_layers(
     const Print                             &print,
     const ToolOrdering                      &tool_ordering,
     ObjectsLayerToPrint                      layers_to_print,
+    std::vector<LayerToProcess>              layers_prefetched,
     const size_t                             single_object_idx,
     const GCode::SmoothPathCache            &smooth_path_cache_global,
     GCodeOutputStream                       &output_stream)
 {
+    assert(layers_prefetched.size() <= layers_to_print.size());
     size_t layer_to_print_idx = 0;
     const GCode::SmoothPathCache::InterpolationParameters interpolation_params = interpolation_parameters(print.config());
-    const auto smooth_path_interpolator = tbb::make_filter<void, std::pair<size_t, GCode::SmoothPathCache>> (slic3r_tbb_filtermode::serial_in_order,
-        [this, &print, &layers_to_print, &layer_to_print_idx, interpolation_params](tbb::flow_control &fc) -> std::pair<size_t, GCode::SmoothPathCache> {
+    const auto layer_index = tbb::make_filter<void, size_t>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &print, &layers_to_print, &layer_to_print_idx](tbb::flow_control &fc) -> size_t {
             if (layer_to_print_idx >= layers_to_print.size()) {
                 if (layer_to_print_idx == layers_to_print.size() + (m_pressure_equalizer ? 1 : 0)) {
                     fc.stop();
@@ -1604,19 +1700,31 @@ void GCodeGenerator::process_layers(
                 } else {
                     // Pressure equalizer need insert empty input. Because it returns one layer back.
                     // Insert NOP (no operation) layer;
-                    return { layer_to_print_idx ++, {} };
+                    return layer_to_print_idx ++;
                 }
             } else {
                 print.throw_if_canceled();
-                size_t idx = layer_to_print_idx ++;
-                GCode::SmoothPathCache smooth_path_cache;
-                GCodeGenerator::smooth_path_interpolate(layers_to_print[idx], interpolation_params, smooth_path_cache);
-                return { idx, std::move(smooth_path_cache) };
+                return layer_to_print_idx ++;
             }
         });
-    const auto generator = tbb::make_filter<std::pair<size_t, GCode::SmoothPathCache>, LayerResult>(slic3r_tbb_filtermode::serial_in_order,
-        [this, &print, &tool_ordering, &layers_to_print, &smooth_path_cache_global, single_object_idx](std::pair<size_t, GCode::SmoothPathCache> in) -> LayerResult {
-            size_t layer_to_print_idx = in.first;
+    // Arc fitting is expensive, the layers are interpolated in parallel.
+    const auto smooth_path_interpolator = tbb::make_filter<size_t, std::pair<size_t, GCode::SmoothPathCache>>(slic3r_tbb_filtermode::parallel,
+        [&layers_to_print, &layers_prefetched, &interpolation_params](size_t idx) -> std::pair<size_t, GCode::SmoothPathCache> {
+            GCode::SmoothPathCache smooth_path_cache;
+            if (idx >= layers_prefetched.size() && idx < layers_to_print.size())
+                GCodeGenerator::smooth_path_interpolate(layers_to_print[idx], interpolation_params, smooth_path_cache);
+            return { idx, std::move(smooth_path_cache) };
+        });
+    const auto travel_boundaries = tbb::make_filter<std::pair<size_t, GCode::SmoothPathCache>, LayerToProcess>(slic3r_tbb_filtermode::parallel,
+        [&print, &layers_to_print, &layers_prefetched](std::pair<size_t, GCode::SmoothPathCache> in) -> LayerToProcess {
+            if (in.first < layers_prefetched.size())
+                return std::move(layers_prefetched[in.first]);
+            const ObjectLayerToPrint *layer = in.first < layers_to_print.size() ? &layers_to_print[in.first] : nullptr;
+            return precompute_travel_boundaries(print, in.first, std::move(in.second), layer, layer ? layer + 1 : nullptr);
+        });
+    const auto generator = tbb::make_filter<LayerToProcess, LayerResult>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &print, &tool_ordering, &layers_to_print, &smooth_path_cache_global, single_object_idx](LayerToProcess in) -> LayerResult {
+            size_t layer_to_print_idx = in.layer_to_print_idx;
             if (layer_to_print_idx == layers_to_print.size()) {
                 // Pressure equalizer need insert empty input. Because it returns one layer back.
                 // Insert NOP (no operation) layer;
@@ -1624,8 +1732,9 @@ void GCodeGenerator::process_layers(
             } else {
                 ObjectLayerToPrint &layer = layers_to_print[layer_to_print_idx];
                 print.throw_if_canceled();
+                m_avoid_crossing_perimeters.set_precomputed_layer_boundaries(std::move(in.travel_boundaries));
                 return this->process_layer(print, { std::move(layer) }, tool_ordering.tools_for_layer(layer.print_z()), 
-                    GCode::SmoothPathCaches{ smooth_path_cache_global, in.second }, 
+                    GCode::SmoothPathCaches{ smooth_path_cache_global, in.smooth_path_cache }, 
                     &layer == &layers_to_print.back(), nullptr, single_object_idx);
             }
         });
@@ -1652,11 +1761,15 @@ void GCodeGenerator::process_layers(
         [find_replace = this->m_find_replace.get()](std::string s) -> std::string {
             return find_replace->process_layer(std::move(s));
         });
-    const auto output = tbb::make_filter<std::string, void>(slic3r_tbb_filtermode::serial_in_order,
-        [&output_stream](std::string s) { output_stream.write(s); }
+    // Writing into the file and feeding the GCodeProcessor are separate serial stages, thus the G-code of a layer may be
+    // processed while the next layer is being written.
+    const auto output = tbb::make_filter<std::string, std::string>(slic3r_tbb_filtermode::serial_in_order,
+        [&output_stream](std::string s) -> std::string { output_stream.write_to_file(s); return s; }
+    ) & tbb::make_filter<std::string, void>(slic3r_tbb_filtermode::serial_in_order,
+        [&output_stream](std::string s) { output_stream.process(s); }
     );
 
-    tbb::filter<void, LayerResult> pipeline_to_layerresult = smooth_path_interpolator & generator;
+    tbb::filter<void, LayerResult> pipeline_to_layerresult = layer_index & smooth_path_interpolator & travel_boundaries & generator;
     if (m_spiral_vase)
         pipeline_to_layerresult = pipeline_to_layerresult & spiral_vase;
     if (m_pressure_equalizer)
@@ -1671,7 +1784,7 @@ void GCodeGenerator::process_layers(
     TBBLocalesSetter locales_setter;
     // The pipeline elements are joined using const references, thus no copying is performed.
     output_stream.find_replace_supress();
-    tbb::parallel_pipeline(12, pipeline_to_layerresult & pipeline_to_string & output);
+    tbb::parallel_pipeline(process_layers_max_tokens(), pipeline_to_layerresult & pipeline_to_string & output);
     output_stream.find_replace_enable();
 }
 
@@ -2318,11 +2431,12 @@ struct SmoothPathGenerator {
 
             assert(validate_smooth_path(smooth_path, !enable_loop_clipping));
 
-            result = smooth_path;
+            result = std::move(smooth_path);
         } else if (auto multipath = dynamic_cast<const ExtrusionMultiPath *>(extrusion_entity)) {
             result = smooth_path_caches.layer_local().resolve_or_fit(*multipath, extrusion_reference.flipped(), scaled_resolution);
         } else if (auto path = dynamic_cast<const ExtrusionPath *>(extrusion_entity)) {
-            result = GCode::SmoothPath{GCode::SmoothPathElement{path->attributes(), smooth_path_caches.layer_local().resolve_or_fit(*path, extrusion_reference.flipped(), scaled_resolution)}};
+            // Don't construct from an initializer list, it would copy the fitted path.
+            result.push_back(GCode::SmoothPathElement{path->attributes(), smooth_path_caches.layer_local().resolve_or_fit(*path, extrusion_reference.flipped(), scaled_resolution)});
         }
         for (auto it{result.rbegin()}; it != result.rend(); ++it) {
             if (!it->path.empty()) {
@@ -3327,7 +3441,7 @@ std::string GCodeGenerator::_extrude(
     }
 
     // F is mm per minute.
-    gcode += m_writer.set_speed(F, "", cooling_marker_setspeed_comments);
+    m_writer.set_speed(gcode, F, "", cooling_marker_setspeed_comments);
 
     if (dynamic_print_and_fan_speeds.fan_speed >= 0) {
         const int fan_speed = int(dynamic_print_and_fan_speeds.fan_speed);
@@ -3345,6 +3459,8 @@ std::string GCodeGenerator::_extrude(
         comment = description;
         comment += description_bridge;
     }
+    // Roughly "G1 X123.456 Y123.456 E1.23456" per segment, reserve to not grow the string while emitting the segments.
+    gcode.reserve(gcode.size() + path.size() * (32 + comment.size()));
     Vec2d prev_exact = this->point_to_gcode(path.front().point);
     Vec2d prev = GCodeFormatter::quantize(prev_exact);
     auto  it   = path.begin();
@@ -3374,14 +3490,14 @@ std::string GCodeGenerator::_extrude(
             if (radius == 0) {
                 // Extrude line segment.
                 if (const double line_length = (p - prev).norm(); line_length > 0)
-                    gcode += m_writer.extrude_to_xy(p, e_per_mm * line_length, comment);
+                    m_writer.extrude_to_xy(gcode, p, e_per_mm * line_length, comment);
             } else {
                 double angle = Geometry::ArcWelder::arc_angle(prev.cast<double>(), p.cast<double>(), double(radius));
                 assert(angle > 0);
                 const double line_length = angle * std::abs(radius);
                 const double dE          = e_per_mm * line_length;
                 assert(dE > 0);
-                gcode += m_writer.extrude_to_xy_G2G3IJ(p, ij, it->ccw(), dE, comment);
+                m_writer.extrude_to_xy_G2G3IJ(gcode, p, ij, it->ccw(), dE, comment);
             }
             prev = p;
             prev_exact = p_exact;
@@ -92,6 +92,15 @@ struct LayerResult {
     static LayerResult make_nop_layer_result() { return {"", std::numeric_limits<coord_t>::max(), false, false, true}; }
 };
 
+// Layer passed from the parallel preprocessing stages of the process_layers() pipeline to the serial G-code generator.
+struct LayerToProcess
+{
+    size_t                                                                            layer_to_print_idx;
+    GCode::SmoothPathCache                                                            smooth_path_cache;
+    // Travel boundaries of the layers to be printed, precomputed if avoid_crossing_perimeters is enabled.
+    std::vector<std::pair<const Layer*, AvoidCrossingPerimeters::LayerBoundariesPtr>> travel_boundaries;
+};
+
 namespace GCode {
 struct PrintObjectInstance
 {
@@ -112,7 +121,8 @@ public:
 
     // throws std::runtime_exception on error,
     // throws CanceledException through print->throw_if_canceled().
-    void            do_export(Print* print, const char* path, GCodeProcessorResult* result = nullptr, ThumbnailsGeneratorCallback thumbnail_cb = nullptr);
+    void            do_export(Print* print, const char* path, GCodeProcessorResult* result = nullptr, ThumbnailsGeneratorCallback thumbnail_cb = nullptr,
+                              GCodeProcessor::PartialResultCallback partial_result_cb = nullptr);
 
     // Exported for the helper classes (OozePrevention, Wipe) and for the Perl binding for unit tests.
     const Vec2d&    origin() const { return m_origin; }
@@ -207,6 +217,11 @@ private:
         // Formats and write into a file the given data. 
         void write_format(const char* format, ...);
 
+        // Write a string into a file, neither passing it to the find-replace post-processor nor to the GCodeProcessor.
+        // Used by process_layers(), which runs the GCodeProcessor in a separate pipeline stage calling process().
+        void write_to_file(const std::string &what) { ::fwrite(what.data(), 1, what.size(), this->f); }
+        void process(const std::string &what) { m_processor.process_buffer(what); }
+
     private:
         FILE             *f { nullptr };
         // Find-replace post-processor to be called before GCodePostProcessor.
@@ -266,10 +281,12 @@ private:
     // Process all layers of a single object instance (sequential mode) with a parallel pipeline:
     // Generate G-code, run the filters (vase mode, cooling buffer), run the G-code analyser
     // and export G-code into file.
+    // The first layers may have been already preprocessed by precompute_layers_to_process(), see layers_prefetched.
     void process_layers(
         const Print                             &print,
         const ToolOrdering                      &tool_ordering,
         ObjectsLayerToPrint                      layers_to_print,
+        std::vector<LayerToProcess>              layers_prefetched,
         const size_t                             single_object_idx,
         const GCode::SmoothPathCache            &smooth_path_cache_global,
         GCodeOutputStream                       &output_stream);
@@ -490,6 +507,9 @@ private:
     // Fill in cache of smooth paths for perimeters, fills and supports of the given object layers.
     // Based on params, the paths are either decimated to sparser polylines, or interpolated with circular arches.
     static void                         smooth_path_interpolate(const ObjectLayerToPrint &layers, const GCode::SmoothPathCache::InterpolationParameters &params, GCode::SmoothPathCache &out);
+    // Run the parallel preprocessing stages of process_layers() (smooth path interpolation, travel boundaries)
+    // over the first layers of a single object instance (sequential mode), as many as fill the pipeline at its start.
+    static std::vector<LayerToProcess>  precompute_layers_to_process(const Print &print, const ObjectsLayerToPrint &layers_to_print);
 
     friend class GCode::Wipe;
     friend class GCode::WipeTowerIntegration;
@@ -1201,26 +1201,32 @@ Polyline AvoidCrossingPerimeters::travel_to(const GCodeGenerator &gcodegen, cons
     Vec2d startf = start.cast<double>();
     Vec2d endf   = end  .cast<double>();
 
+    if (! m_layer_boundaries)
+        // Not initialized by init_layer() yet, behave as if the layer had no slices.
+        m_layer_boundaries = std::make_shared<LayerBoundaries>();
+    LayerBoundaries &layer_boundaries = *m_layer_boundaries;
     bool is_support_layer = dynamic_cast<const SupportLayer *>(gcodegen.layer()) != nullptr;
-    if (!use_external && (is_support_layer || (!m_lslices_offset.empty() && !any_expolygon_contains(m_lslices_offset, m_lslices_offset_bboxes, m_grid_lslices_offset, travel)))) {
-        // Initialize m_internal only when it is necessary.
-        if (m_internal.boundaries.empty())
-            init_boundary(&m_internal, to_polygons(get_boundary(*gcodegen.layer())));
+    if (!use_external && (is_support_layer || (!layer_boundaries.lslices_offset.empty() && !any_expolygon_contains(layer_boundaries.lslices_offset, layer_boundaries.lslices_offset_bboxes, layer_boundaries.grid_lslices_offset, travel)))) {
+        // Initialize the internal boundary only when it is necessary.
+        if (! layer_boundaries.internal)
+            init_boundary(&layer_boundaries.internal.emplace(), to_polygons(get_boundary(*gcodegen.layer())));
+        const Boundary &internal = *layer_boundaries.internal;
 
         // Trim the travel line by the bounding box.
-        if (!m_internal.boundaries.empty() && Geometry::liang_barsky_line_clipping(startf, endf, m_internal.bbox)) {
-            travel_intersection_count = avoid_perimeters(m_internal, startf.cast<coord_t>(), endf.cast<coord_t>(), *gcodegen.layer(), result_pl);
+        if (!internal.boundaries.empty() && Geometry::liang_barsky_line_clipping(startf, endf, internal.bbox)) {
+            travel_intersection_count = avoid_perimeters(internal, startf.cast<coord_t>(), endf.cast<coord_t>(), *gcodegen.layer(), result_pl);
             result_pl.points.front()  = start;
             result_pl.points.back()   = end;
         }
     } else if(use_external) {
-        // Initialize m_external only when exist any external travel for the current layer.
-        if (m_external.boundaries.empty())
-            init_boundary(&m_external, get_boundary_external(*gcodegen.layer()));
+        // Initialize the external boundary only when exist any external travel for the current layer.
+        if (! layer_boundaries.external)
+            init_boundary(&layer_boundaries.external.emplace(), get_boundary_external(*gcodegen.layer()));
+        const Boundary &external = *layer_boundaries.external;
 
         // Trim the travel line by the bounding box.
-        if (!m_external.boundaries.empty() && Geometry::liang_barsky_line_clipping(startf, endf, m_external.bbox)) {
-            travel_intersection_count = avoid_perimeters(m_external, startf.cast<coord_t>(), endf.cast<coord_t>(), *gcodegen.layer(), result_pl);
+        if (!external.boundaries.empty() && Geometry::liang_barsky_line_clipping(startf, endf, external.bbox)) {
+            travel_intersection_count = avoid_perimeters(external, startf.cast<coord_t>(), endf.cast<coord_t>(), *gcodegen.layer(), result_pl);
             result_pl.points.front()  = start;
             result_pl.points.back()   = end;
         }
@@ -1252,32 +1258,47 @@ Polyline AvoidCrossingPerimeters::travel_to(const GCodeGenerator &gcodegen, cons
     } else if (max_detour_length_exceeded) {
         *could_be_wipe_disabled = false;
     } else
-        *could_be_wipe_disabled = !need_wipe(gcodegen, m_lslices_offset, m_lslices_offset_bboxes, m_grid_lslices_offset, travel, result_pl, travel_intersection_count);
+        *could_be_wipe_disabled = !need_wipe(gcodegen, layer_boundaries.lslices_offset, layer_boundaries.lslices_offset_bboxes, layer_boundaries.grid_lslices_offset, travel, result_pl, travel_intersection_count);
 
     return result_pl;
 }
 
 // ************************************* AvoidCrossingPerimeters::init_layer() *****************************************
 
-void AvoidCrossingPerimeters::init_layer(const Layer &layer)
+AvoidCrossingPerimeters::LayerBoundariesPtr AvoidCrossingPerimeters::make_layer_boundaries(const Layer &layer, bool with_internal, bool with_external)
 {
-    m_internal.clear();
-    m_external.clear();
-    m_lslices_offset.clear();
-    m_lslices_offset_bboxes.clear();
+    auto out = std::make_shared<LayerBoundaries>();
 
     float perimeter_offset = -get_external_perimeter_width(layer) / float(2.);
-    m_lslices_offset        = offset_ex(layer.lslices, perimeter_offset);
+    out->lslices_offset    = offset_ex(layer.lslices, perimeter_offset);
 
-    m_lslices_offset_bboxes.reserve(m_lslices_offset.size());
-    for (const ExPolygon &ex_poly : m_lslices_offset)
-        m_lslices_offset_bboxes.emplace_back(get_extents(ex_poly));
+    out->lslices_offset_bboxes.reserve(out->lslices_offset.size());
+    for (const ExPolygon &ex_poly : out->lslices_offset)
+        out->lslices_offset_bboxes.emplace_back(get_extents(ex_poly));
 
     BoundingBox bbox_slice(get_extents(layer.lslices));
     bbox_slice.offset(SCALED_EPSILON);
 
-    m_grid_lslices_offset.set_bbox(bbox_slice);
-    m_grid_lslices_offset.create(m_lslices_offset, coord_t(scale_(1.)));
+    out->grid_lslices_offset.set_bbox(bbox_slice);
+    out->grid_lslices_offset.create(out->lslices_offset, coord_t(scale_(1.)));
+
+    if (with_internal)
+        init_boundary(&out->internal.emplace(), to_polygons(get_boundary(layer)));
+    if (with_external)
+        init_boundary(&out->external.emplace(), get_boundary_external(layer));
+    return out;
+}
+
+void AvoidCrossingPerimeters::init_layer(const Layer &layer)
+{
+    // The same layer is initialized once for each of its instances, the boundaries of all instances are the same,
+    // which is also the case for the lazily initialized ones.
+    if (m_layer_boundaries && m_layer_boundaries_layer == &layer)
+        return;
+    m_layer_boundaries_layer = &layer;
+    auto it = std::find_if(m_precomputed_layer_boundaries.begin(), m_precomputed_layer_boundaries.end(),
+        [&layer](const std::pair<const Layer*, LayerBoundariesPtr> &l) { return l.first == &layer; });
+    m_layer_boundaries = it == m_precomputed_layer_boundaries.end() ? make_layer_boundaries(layer, false, false) : it->second;
 }
 
 #if 0
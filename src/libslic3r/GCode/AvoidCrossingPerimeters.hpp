@@ -5,6 +5,9 @@
 #ifndef slic3r_AvoidCrossingPerimeters_hpp_
 #define slic3r_AvoidCrossingPerimeters_hpp_
 
+#include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "libslic3r/libslic3r.h"
@@ -33,6 +36,7 @@ public:
     bool        disabled_once() const   { return m_disabled_once; }
     void        reset_once_modifiers()  { use_external_mp_once = false; m_disabled_once = false; }
 
+    // Uses the boundaries precomputed by set_precomputed_layer_boundaries() if available for this layer.
     void        init_layer(const Layer &layer);
 
     Polyline    travel_to(const GCodeGenerator &gcodegen, const Point& point)
@@ -60,6 +64,27 @@ public:
         }
     };
 
+    // Boundaries of a single layer needed for the travel planning. They only depend on the layer (and on the layers
+    // of the other objects at the same print_z), thus they may be computed ahead of G-code generation in parallel.
+    struct LayerBoundaries {
+        // Lslices offseted by half an external perimeter width. Used for detection if line or polyline is inside of any polygon.
+        ExPolygons               lslices_offset;
+        std::vector<BoundingBox> lslices_offset_bboxes;
+        // Used for detection of line or polyline is inside of any polygon.
+        EdgeGrid::Grid           grid_lslices_offset;
+        // Store all needed data for travels inside object, initialized by travel_to() when needed unless precomputed.
+        std::optional<Boundary>  internal;
+        // Store all needed data for travels outside object, initialized by travel_to() when needed unless precomputed.
+        std::optional<Boundary>  external;
+    };
+    using LayerBoundariesPtr = std::shared_ptr<LayerBoundaries>;
+
+    // Thread safe, may be called for multiple layers in parallel.
+    static LayerBoundariesPtr make_layer_boundaries(const Layer &layer, bool with_internal, bool with_external);
+    // Boundaries of the layers to be processed next, replaces the previously precomputed boundaries.
+    void        set_precomputed_layer_boundaries(std::vector<std::pair<const Layer*, LayerBoundariesPtr>> &&boundaries)
+        { m_precomputed_layer_boundaries = std::move(boundaries); }
+
     // just for the next travel move
     bool           use_external_mp_once { false };
 private:
@@ -68,15 +93,10 @@ private:
     // we enable it by default for the first travel move in print
     bool           m_disabled_once { true };
 
-    // Lslices offseted by half an external perimeter width. Used for detection if line or polyline is inside of any polygon.
-    ExPolygons               m_lslices_offset;
-    std::vector<BoundingBox> m_lslices_offset_bboxes;
-    // Used for detection of line or polyline is inside of any polygon.
-    EdgeGrid::Grid           m_grid_lslices_offset;
-    // Store all needed data for travels inside object
-    Boundary m_internal;
-    // Store all needed data for travels outside object
-    Boundary m_external;
+    // Boundaries of the current layer.
+    LayerBoundariesPtr       m_layer_boundaries;
+    const Layer             *m_layer_boundaries_layer { nullptr };
+    std::vector<std::pair<const Layer*, LayerBoundariesPtr>> m_precomputed_layer_boundaries;
 };
 
 } // namespace Slic3r
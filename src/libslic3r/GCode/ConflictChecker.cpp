@@ -6,9 +6,10 @@
 #include "ConflictChecker.hpp"
 
 #include <oneapi/tbb/blocked_range.h>
-#include <oneapi/tbb/concurrent_vector.h>
 #include <oneapi/tbb/parallel_for.h>
+#include <atomic>
 #include <map>
+#include <unordered_map>
 #include <functional>
 #include <cmath>
 #include <cstdint>
@@ -41,6 +42,11 @@ inline IndexPair point_map_grid_index(const Point &pt, int64_t xdist, int64_t yd
 
 inline bool nearly_equal(const Point &p1, const Point &p2) { return std::abs(p1.x() - p2.x()) < SCALED_EPSILON && std::abs(p1.y() - p2.y()) < SCALED_EPSILON; }
 
+struct IndexPairHash
+{
+    size_t operator()(const IndexPair &idx) const { return std::hash<int64_t>()(idx.first * 73856093 ^ idx.second * 19349663); }
+};
+
 inline Grids line_rasterization(const Line &line, int64_t xdist = RasteXDistance, int64_t ydist = RasteYDistance)
 {
     Grids     res;
@@ -227,13 +233,27 @@ double LinesBucketQueue::removeLowests()
 
 LineWithIDs LinesBucketQueue::getCurLines() const
 {
+    return this->getLines(this->getCurPiles());
+}
+
+std::vector<unsigned> LinesBucketQueue::getCurPiles() const
+{
+    std::vector<unsigned> piles;
+    piles.reserve(_buckets.size());
+    for (const LinesBucket &bucket : _buckets)
+        piles.emplace_back(bucket.valid() ? bucket.curPileIdx() : invalid_pile);
+    return piles;
+}
+
+LineWithIDs LinesBucketQueue::getLines(const std::vector<unsigned> &piles) const
+{
+    assert(piles.size() == _buckets.size());
     LineWithIDs lines;
-    for (const LinesBucket &bucket : _buckets) {
-        if (bucket.valid()) {
-            LineWithIDs tmpLines = bucket.curLines();
+    for (size_t i = 0; i < _buckets.size(); ++ i)
+        if (piles[i] != invalid_pile) {
+            LineWithIDs tmpLines = _buckets[i].lines(piles[i]);
             lines.insert(lines.end(), tmpLines.begin(), tmpLines.end());
         }
-    }
     return lines;
 }
 
@@ -286,7 +306,14 @@ std::pair<std::vector<ExtrusionPaths>, std::vector<ExtrusionPaths>> getAllLayers
 ConflictComputeOpt ConflictChecker::find_inter_of_lines(const LineWithIDs &lines)
 {
     using namespace RasterizationImpl;
-    std::map<IndexPair, std::vector<int>> indexToLine;
+
+    // Lines of a single instance never conflict, don't rasterize a layer printed by a single instance.
+    if (std::all_of(lines.begin(), lines.end(), [&lines](const LineWithID &l) { return l._obj_id == lines.front()._obj_id && l._inst_id == lines.front()._inst_id; }))
+        return {};
+
+    // Uniform spatial hash of grid cells to the lines crossing them.
+    std::unordered_map<IndexPair, std::vector<int>, IndexPairHash> indexToLine;
+    indexToLine.reserve(lines.size());
 
     for (int i = 0; i < (int)lines.size(); ++i) {
         const LineWithID &l1      = lines[i];
@@ -331,37 +358,34 @@ ConflictResultOpt ConflictChecker::find_inter_of_lines_in_diff_objs(SpanOfConstP
     }
     conflictQueue.build_queue();
 
-    std::vector<LineWithIDs> layersLines;
-    std::vector<double>      heights;
+    // The sweep only records the piles of each layer, the lines are generated and checked in parallel.
+    std::vector<std::vector<unsigned>> layersPiles;
+    std::vector<double>                heights;
     while (conflictQueue.valid()) {
-        LineWithIDs lines     = conflictQueue.getCurLines();
-        double      curHeight = conflictQueue.removeLowests();
-        heights.push_back(curHeight);
-        layersLines.push_back(std::move(lines));
+        layersPiles.push_back(conflictQueue.getCurPiles());
+        heights.push_back(conflictQueue.removeLowests());
     }
 
-    bool                                   find = false;
-    tbb::concurrent_vector<std::pair<ConflictComputeResult,double>> conflict;
+    // Only the lowest conflict is reported, layers above the lowest conflict found so far are skipped.
+    std::atomic<size_t>                              firstConflictLayer(layersPiles.size());
+    std::vector<std::optional<ConflictComputeResult>> conflicts(layersPiles.size());
 
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, layersLines.size()), [&](tbb::blocked_range<size_t> range) {
-        for (size_t i = range.begin(); i < range.end(); i++) {
-            auto interRes = find_inter_of_lines(layersLines[i]);
-            if (interRes.has_value()) {
-                find = true;
-                conflict.emplace_back(*interRes, heights[i]);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, layersPiles.size()), [&](tbb::blocked_range<size_t> range) {
+        for (size_t i = range.begin(); i < range.end() && i < firstConflictLayer.load(std::memory_order_relaxed); ++ i) {
+            if (ConflictComputeOpt interRes = find_inter_of_lines(conflictQueue.getLines(layersPiles[i])); interRes.has_value()) {
+                conflicts[i] = interRes;
+                for (size_t first = firstConflictLayer.load(std::memory_order_relaxed);
+                     i < first && ! firstConflictLayer.compare_exchange_weak(first, i, std::memory_order_relaxed););
                 break;
             }
         }
     });
 
-    if (find) {
-        std::sort(conflict.begin(), conflict.end(), [](const std::pair<ConflictComputeResult, double>& i1, const std::pair<ConflictComputeResult, double>& i2) {
-            return i1.second < i2.second;
-        });
-
-        const void *ptr1           = conflictQueue.idToObjsPtr(conflict[0].first._obj1);
-        const void *ptr2           = conflictQueue.idToObjsPtr(conflict[0].first._obj2);
-        double      conflictHeight = conflict[0].second;
+    if (size_t first = firstConflictLayer.load(); first < layersPiles.size()) {
+        assert(conflicts[first].has_value());
+        const void *ptr1           = conflictQueue.idToObjsPtr(conflicts[first]->_obj1);
+        const void *ptr2           = conflictQueue.idToObjsPtr(conflicts[first]->_obj2);
+        double      conflictHeight = heights[first];
         if (ptr1 == &wtptr || ptr2 == &wtptr) {
             assert(! wipe_tower_data.z_and_depth_pairs.empty());
             if (ptr2 == &wtptr) { std::swap(ptr1, ptr2); }
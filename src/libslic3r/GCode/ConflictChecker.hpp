@@ -61,10 +61,12 @@ public:
         }
     }
     double      curHeight() const { return _curHeight; }
-    LineWithIDs curLines() const
+    unsigned    curPileIdx() const { return _curPileIdx; }
+    LineWithIDs curLines() const { return lines(_curPileIdx); }
+    LineWithIDs lines(unsigned pile_idx) const
     {
         LineWithIDs lines;
-        for (const ExtrusionPath &path : _piles[_curPileIdx]) {
+        for (const ExtrusionPath &path : _piles[pile_idx]) {
             Polyline check_polyline;
             for (int i = 0; i < (int)_offsets.size(); ++i) {
                 check_polyline = path.polyline;
@@ -107,6 +109,11 @@ public:
     }
     double      removeLowests();
     LineWithIDs getCurLines() const;
+    // Current pile of each bucket, invalid_pile for buckets already exhausted.
+    // Recording the piles is cheap, the lines are generated later by getLines(), possibly in parallel.
+    static constexpr const unsigned invalid_pile = unsigned(-1);
+    std::vector<unsigned> getCurPiles() const;
+    LineWithIDs getLines(const std::vector<unsigned> &piles) const;
 };
 
 void getExtrusionPathsFromEntity(const ExtrusionEntityCollection *entity, ExtrusionPaths &paths);
@@ -380,6 +380,7 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
     PerExtruderAdjustments *adjustment  = &per_extruder_adjustments[map_extruder_to_per_extruder_adjustment[current_extruder]];
     const char       *line_start = gcode.c_str();
     const char       *line_end   = line_start;
+    const char       *gcode_end  = gcode.c_str() + gcode.size();
     const char        extrusion_axis = get_extrusion_axis(m_config)[0];
     // Index of an existing CoolingLine of the current adjustment, which holds the feedrate setting command
     // for a sequence of extrusion moves.
@@ -388,10 +389,15 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
     std::array<float, AxisIdx::Count> new_pos;
     for (; *line_start != 0; line_start = line_end) 
     {
-        while (*line_end != '\n' && *line_end != 0)
-            ++ line_end;
+        line_end = static_cast<const char*>(memchr(line_start, '\n', gcode_end - line_start));
+        if (line_end == nullptr)
+            line_end = gcode_end;
         // sline will not contain the trailing '\n'.
         std::string_view sline(line_start, line_end - line_start);
+        // All the markers emitted by GCodeGenerator are comments, thus search for them just once
+        // in the comment part of the line instead of scanning the complete line for each marker.
+        const size_t           comment_pos = sline.find(';');
+        const std::string_view comment     = comment_pos == std::string_view::npos ? std::string_view() : sline.substr(comment_pos);
         // CoolingLine will contain the trailing '\n'.
         if (*line_end == '\n')
             ++ line_end;
@@ -447,13 +453,13 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
                 (line.type & (CoolingLine::TYPE_G2G3_IJ | CoolingLine::TYPE_G2G3_R)));
             // Arc is defined either by IJ or by R, not by both.
             assert(! ((line.type & CoolingLine::TYPE_G2G3_IJ) && (line.type & CoolingLine::TYPE_G2G3_R)));
-            bool external_perimeter = boost::contains(sline, ";_EXTERNAL_PERIMETER");
-            bool wipe               = boost::contains(sline, ";_WIPE");
+            bool external_perimeter = boost::contains(comment, ";_EXTERNAL_PERIMETER");
+            bool wipe               = boost::contains(comment, ";_WIPE");
             if (external_perimeter)
                 line.type |= CoolingLine::TYPE_EXTERNAL_PERIMETER;
             if (wipe)
                 line.type |= CoolingLine::TYPE_WIPE;
-            if (boost::contains(sline, ";_EXTRUDE_SET_SPEED") && ! wipe) {
+            if (boost::contains(comment, ";_EXTRUDE_SET_SPEED") && ! wipe) {
                 line.type |= CoolingLine::TYPE_ADJUSTABLE;
                 active_speed_modifier = adjustment->lines.size();
             }
@@ -522,7 +528,7 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
                 }
             }
             std::copy(std::begin(new_pos), std::begin(new_pos) + 5, std::begin(current_pos));
-        } else if (boost::starts_with(sline, ";_EXTRUDE_END")) {
+        } else if (comment_pos == 0 && boost::starts_with(sline, ";_EXTRUDE_END")) {
             // Closing a block of non-zero length extrusion moves.
             line.type = CoolingLine::TYPE_EXTRUDE_END;
             if (active_speed_modifier != size_t(-1)) {
@@ -560,9 +566,9 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
                         BOOST_LOG_TRIVIAL(error) << "CoolingBuffer encountered an invalid toolchange, maybe from a custom gcode: " << sline;
                 }
             }
-        } else if (boost::starts_with(sline, ";_BRIDGE_FAN_START")) {
+        } else if (comment_pos == 0 && boost::starts_with(sline, ";_BRIDGE_FAN_START")) {
             line.type = CoolingLine::TYPE_BRIDGE_FAN_START;
-        } else if (boost::starts_with(sline, ";_BRIDGE_FAN_END")) {
+        } else if (comment_pos == 0 && boost::starts_with(sline, ";_BRIDGE_FAN_END")) {
             line.type = CoolingLine::TYPE_BRIDGE_FAN_END;
         } else if (boost::starts_with(sline, "G4 ")) {
             // Parse the wait time.
@@ -581,7 +587,7 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
             }
 
             line.time_max = line.time;
-        } else if (boost::contains(sline, ";_SET_FAN_SPEED")) {
+        } else if (boost::contains(comment, ";_SET_FAN_SPEED")) {
             auto speed_start = sline.find_last_of('D');
             int  speed       = 0;
             for (char num : sline.substr(speed_start + 1)) {
@@ -590,7 +596,7 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
 
             line.fan_speed = speed;
             line.type |= CoolingLine::TYPE_SET_FAN_SPEED;
-        } else if (boost::contains(sline, ";_RESET_FAN_SPEED")) {
+        } else if (boost::contains(comment, ";_RESET_FAN_SPEED")) {
             line.type |= CoolingLine::TYPE_RESET_FAN_SPEED;
         }
 
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cinttypes>
+#include <iterator>
 
 #include "libslic3r/GCode/SmoothPath.hpp"
 #include "libslic3r/ShortestPath.hpp"
@@ -268,11 +269,11 @@ std::vector<InfillRange> extract_ironing_extrusions(
             return should_pick_extrusion(eec, region) && eec.role() == ExtrusionRole::Ironing;
         };
 
-        const std::vector<InfillRange> ironing_ranges{extract_infill_ranges(
+        std::vector<InfillRange> ironing_ranges{extract_infill_ranges(
             print, layer, island, offset, previous_position, should_pick_ironing, smooth_path, extruder_id
         )};
         result.insert(
-            result.end(), ironing_ranges.begin(), ironing_ranges.end()
+            result.end(), std::make_move_iterator(ironing_ranges.begin()), std::make_move_iterator(ironing_ranges.end())
         );
     }
     return result;
@@ -111,18 +111,23 @@ std::vector<ExtendedPoint> estimate_points_properties(
     std::vector<ExtendedPoint> points;
     points.reserve(input_points.size() * 1.5);
 
+    // The nearest line of the previous query bounds the search for the next point, see LinesDistancer::distance_from_lines_extra().
+    size_t nearest_line_hint = size_t(-1);
+    auto distance_from_prev_layer = [&unscaled_prev_layer, &nearest_line_hint](const Vec2d &position) {
+        auto [distance, nearest_line, x] = unscaled_prev_layer.template distance_from_lines_extra<SIGNED_DISTANCE>(
+            position.cast<AABBScalar>(), nearest_line_hint);
+        nearest_line_hint = nearest_line;
+        return distance;
+    };
+
     {
         ExtendedPoint start_point{unscaled(input_points.front())};
-        auto [distance, nearest_line,
-              x] = unscaled_prev_layer.template distance_from_lines_extra<SIGNED_DISTANCE>(start_point.position.cast<AABBScalar>());
-        start_point.distance = distance + boundary_offset;
+        start_point.distance = distance_from_prev_layer(start_point.position) + boundary_offset;
         points.push_back(start_point);
     }
     for (size_t i = 1; i < input_points.size(); i++) {
         ExtendedPoint next_point{unscaled(input_points[i])};
-        auto [distance, nearest_line,
-              x] = unscaled_prev_layer.template distance_from_lines_extra<SIGNED_DISTANCE>(next_point.position.cast<AABBScalar>());
-        next_point.distance = distance + boundary_offset;
+        next_point.distance = distance_from_prev_layer(next_point.position) + boundary_offset;
 
         if (((points.back().distance > boundary_offset + EPSILON) != (next_point.distance > boundary_offset + EPSILON))) {
             const ExtendedPoint &prev_point    = points.back();
@@ -157,20 +162,16 @@ std::vector<ExtendedPoint> estimate_points_properties(
 
                     if (t0 < 1.0) {
                         auto p0     = curr.position + t0 * (next.position - curr.position);
-                        auto [p0_dist, p0_near_l,
-                              p0_x] = unscaled_prev_layer.template distance_from_lines_extra<SIGNED_DISTANCE>(p0.cast<AABBScalar>());
                         ExtendedPoint new_p{};
                         new_p.position = p0;
-                        new_p.distance = float(p0_dist + boundary_offset);
+                        new_p.distance = float(distance_from_prev_layer(p0) + boundary_offset);
                         new_points.push_back(new_p);
                     }
                     if (t1 > 0.0) {
                         auto p1     = curr.position + t1 * (next.position - curr.position);
-                        auto [p1_dist, p1_near_l,
-                              p1_x] = unscaled_prev_layer.template distance_from_lines_extra<SIGNED_DISTANCE>(p1.cast<AABBScalar>());
                         ExtendedPoint new_p{};
                         new_p.position = p1;
-                        new_p.distance = float(p1_dist + boundary_offset);
+                        new_p.distance = float(distance_from_prev_layer(p1) + boundary_offset);
                         new_points.push_back(new_p);
                     }
                 }
@@ -193,11 +194,9 @@ std::vector<ExtendedPoint> estimate_points_properties(
                 size_t new_point_count = 1.0 / t;
                 for (size_t j = 1; j < new_point_count + 1; j++) {
                     Vec2d pos  = curr.position * (1.0 - j * t) + next.position * (j * t);
-                    auto [p_dist, p_near_l,
-                          p_x] = unscaled_prev_layer.template distance_from_lines_extra<SIGNED_DISTANCE>(pos.cast<AABBScalar>());
                     ExtendedPoint new_p{};
                     new_p.position = pos;
-                    new_p.distance = float(p_dist + boundary_offset);
+                    new_p.distance = float(distance_from_prev_layer(pos) + boundary_offset);
                     new_points.push_back(new_p);
                 }
             }
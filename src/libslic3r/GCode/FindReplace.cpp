@@ -120,20 +120,25 @@ static void find_and_replace_whole_word(std::string &inout, const std::string &m
 
 std::string GCodeFindReplace::process_layer(const std::string &ain)
 {
+    // Most of the substitutions don't match most of the layers. The layer is only copied by the first substitution,
+    // which modifies it, until then the substitutions are matched against the input G-code.
     std::string out;
     const std::string *in = &ain;
     std::string temp;
-    temp.reserve(in->size());
 
     for (const Substitution &substitution : m_substitutions) {
         if (substitution.regexp) {
+            const boost::match_flag_type flags = substitution.single_line ? boost::match_single_line | boost::match_default : boost::match_not_dot_newline | boost::match_default;
+            if (! boost::regex_search(in->begin(), in->end(), substitution.regexp_pattern, flags))
+                continue;
             temp.clear();
             temp.reserve(in->size());
-            boost::regex_replace(ToStringIterator(temp), in->begin(), in->end(),
-                substitution.regexp_pattern, substitution.format, 
-                (substitution.single_line ? boost::match_single_line | boost::match_default : boost::match_not_dot_newline | boost::match_default) | boost::format_all);
+            boost::regex_replace(ToStringIterator(temp), in->begin(), in->end(), substitution.regexp_pattern, substitution.format, flags | boost::format_all);
             std::swap(out, temp);
         } else {
+            if (substitution.plain_pattern.empty() ||
+                (substitution.case_insensitive ? boost::ifind_first(*in, substitution.plain_pattern).empty() : in->find(substitution.plain_pattern) == std::string::npos))
+                continue;
             if (in == &ain)
                 out = ain;
             // Plain substitution
@@ -163,7 +168,7 @@ std::string GCodeFindReplace::process_layer(const std::string &ain)
         in = &out;
     }
 
-    return out;
+    return in == &ain ? ain : out;
 }
 
 }
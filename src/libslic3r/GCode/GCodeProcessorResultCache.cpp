@@ -0,0 +1,463 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#include "libslic3r/GCode/GCodeProcessor.hpp"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include <cstring>
+#include <exception>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+// The preview cache is a flat binary file: a header identifying the cache layout and the G-code file it was made
+// for, followed by the fields of GCodeProcessorResult. Arrays of plain values, which make the bulk of the cache
+// (the compacted moves and the ends of lines), are stored as their size followed by their raw content, thus they are
+// loaded by a single read each.
+
+namespace Slic3r {
+
+namespace {
+
+// Increase whenever the layout of the cache or of the cached data changes.
+constexpr const uint32_t ResultCacheVersion = 1;
+constexpr const char     ResultCacheMagic[8] = { 'P', 'S', 'G', 'C', 'P', 'R', 'V', 0 };
+
+class CacheWriter
+{
+public:
+    explicit CacheWriter(std::ostream &out) : m_out(out) {}
+
+    template<typename T>
+    void value(const T &v) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        m_out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+
+    template<typename T, typename Alloc>
+    void array(const std::vector<T, Alloc> &v) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        this->value(uint64_t(v.size()));
+        if (! v.empty())
+            m_out.write(reinterpret_cast<const char*>(v.data()), std::streamsize(v.size() * sizeof(T)));
+    }
+
+    void string(const std::string &s) {
+        this->value(uint64_t(s.size()));
+        m_out.write(s.data(), std::streamsize(s.size()));
+    }
+
+    void strings(const std::vector<std::string> &v) {
+        this->value(uint64_t(v.size()));
+        for (const std::string &s : v)
+            this->string(s);
+    }
+
+private:
+    std::ostream &m_out;
+};
+
+class CacheReader
+{
+public:
+    // Sizes of arrays read are checked against size_limit (size of the cache file) before allocating memory for them,
+    // so that a corrupted cache file does not lead to a huge allocation.
+    CacheReader(std::istream &in, uint64_t size_limit) : m_in(in), m_size_limit(size_limit) {}
+
+    template<typename T>
+    bool value(T &v) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return this->read(&v, sizeof(T));
+    }
+
+    template<typename T, typename Alloc>
+    bool array(std::vector<T, Alloc> &v) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        uint64_t size = 0;
+        if (! this->size(size, sizeof(T)))
+            return false;
+        v.resize(size_t(size));
+        return size == 0 || this->read(v.data(), size * sizeof(T));
+    }
+
+    bool string(std::string &s) {
+        uint64_t size = 0;
+        if (! this->size(size, 1))
+            return false;
+        s.resize(size_t(size));
+        return size == 0 || this->read(s.data(), size);
+    }
+
+    bool strings(std::vector<std::string> &v) {
+        uint64_t size = 0;
+        if (! this->size(size, sizeof(uint64_t)))
+            return false;
+        v.resize(size_t(size));
+        for (std::string &s : v)
+            if (! this->string(s))
+                return false;
+        return true;
+    }
+
+    // Read a count of items of item_size bytes each.
+    bool size(uint64_t &size, size_t item_size) {
+        if (this->value(size) && size > m_size_limit / item_size)
+            m_ok = false;
+        return m_ok;
+    }
+
+    bool good() const { return m_ok; }
+
+private:
+    bool read(void *data, uint64_t size) {
+        if (m_ok && ! m_in.read(static_cast<char*>(data), std::streamsize(size)))
+            m_ok = false;
+        return m_ok;
+    }
+
+    std::istream &m_in;
+    uint64_t      m_size_limit;
+    bool          m_ok { true };
+};
+
+// Identification of the content of a G-code file the cache was saved for.
+struct GCodeFileStamp
+{
+    uint64_t size  { 0 };
+    int64_t  mtime { 0 };
+
+    bool operator==(const GCodeFileStamp &rhs) const { return size == rhs.size && mtime == rhs.mtime; }
+};
+
+std::optional<GCodeFileStamp> gcode_file_stamp(const std::string &filename)
+{
+    boost::system::error_code ec;
+    GCodeFileStamp            stamp;
+    stamp.size = uint64_t(boost::filesystem::file_size(filename, ec));
+    if (ec)
+        return std::nullopt;
+    stamp.mtime = int64_t(boost::filesystem::last_write_time(filename, ec));
+    if (ec)
+        return std::nullopt;
+    return stamp;
+}
+
+// 64 bit FNV-1a hash of the content of a file.
+std::optional<uint64_t> gcode_file_hash(const std::string &filename)
+{
+    boost::nowide::ifstream in(filename, std::ios::binary);
+    if (! in)
+        return std::nullopt;
+    uint64_t          hash = 0xcbf29ce484222325ull;
+    std::vector<char> buffer(1 << 20);
+    while (in) {
+        in.read(buffer.data(), std::streamsize(buffer.size()));
+        const std::streamsize read = in.gcount();
+        for (std::streamsize i = 0; i < read; ++ i) {
+            hash ^= uint64_t(static_cast<unsigned char>(buffer[i]));
+            hash *= 0x100000001b3ull;
+        }
+    }
+    if (in.bad())
+        return std::nullopt;
+    return hash;
+}
+
+void save_statistics(CacheWriter &w, const PrintEstimatedStatistics &stats)
+{
+    w.array(stats.volumes_per_color_change);
+    for (const std::map<size_t, double> *map : { &stats.volumes_per_extruder, &stats.cost_per_extruder }) {
+        w.value(uint64_t(map->size()));
+        for (const auto &[extruder_id, value] : *map) {
+            w.value(uint64_t(extruder_id));
+            w.value(value);
+        }
+    }
+    w.value(uint64_t(stats.used_filaments_per_role.size()));
+    for (const auto &[role, used] : stats.used_filaments_per_role) {
+        w.value(role);
+        w.value(used.first);
+        w.value(used.second);
+    }
+    for (const PrintEstimatedStatistics::Mode &mode : stats.modes) {
+        w.value(mode.time);
+        w.value(uint64_t(mode.custom_gcode_times.size()));
+        for (const auto &[type, times] : mode.custom_gcode_times) {
+            w.value(type);
+            w.value(times.first);
+            w.value(times.second);
+        }
+    }
+}
+
+bool load_statistics(CacheReader &r, PrintEstimatedStatistics &stats)
+{
+    uint64_t size = 0;
+    r.array(stats.volumes_per_color_change);
+    for (std::map<size_t, double> *map : { &stats.volumes_per_extruder, &stats.cost_per_extruder }) {
+        r.size(size, 2 * sizeof(uint64_t));
+        for (uint64_t i = 0; i < size && r.good(); ++ i) {
+            uint64_t extruder_id = 0;
+            double   value       = 0.;
+            r.value(extruder_id);
+            r.value(value);
+            (*map)[size_t(extruder_id)] = value;
+        }
+    }
+    r.size(size, sizeof(GCodeExtrusionRole) + 2 * sizeof(double));
+    for (uint64_t i = 0; i < size && r.good(); ++ i) {
+        GCodeExtrusionRole        role;
+        std::pair<double, double> used;
+        r.value(role);
+        r.value(used.first);
+        r.value(used.second);
+        stats.used_filaments_per_role[role] = used;
+    }
+    for (PrintEstimatedStatistics::Mode &mode : stats.modes) {
+        r.value(mode.time);
+        r.size(size, sizeof(CustomGCode::Type) + 2 * sizeof(float));
+        mode.custom_gcode_times.resize(r.good() ? size_t(size) : 0);
+        for (auto &[type, times] : mode.custom_gcode_times) {
+            r.value(type);
+            r.value(times.first);
+            r.value(times.second);
+        }
+    }
+    return r.good();
+}
+
+} // namespace
+
+void GCodeProcessorResult::CompactMoves::save(std::ostream &out) const
+{
+    CacheWriter w(out);
+    w.array(m_gcode_ids);
+    w.array(m_packed);
+    w.array(m_x);
+    w.array(m_y);
+    w.array(m_dz);
+    w.array(m_delta_extruder);
+    w.array(m_feedrate);
+    w.array(m_actual_feedrate);
+    w.array(m_width);
+    w.array(m_height);
+    w.array(m_mm3_per_mm);
+    w.array(m_fan_speed);
+    w.array(m_temperature);
+    for (const std::vector<float> &time : m_time)
+        w.array(time);
+    w.array(m_layer_runs);
+    w.value(uint64_t(m_z_exceptions.size()));
+    for (const auto &[move_id, z] : m_z_exceptions) {
+        w.value(uint64_t(move_id));
+        w.value(z);
+    }
+}
+
+bool GCodeProcessorResult::CompactMoves::load(std::istream &in, uint64_t size_limit)
+{
+    this->clear();
+    CacheReader r(in, size_limit);
+    r.array(m_gcode_ids);
+    r.array(m_packed);
+    r.array(m_x);
+    r.array(m_y);
+    r.array(m_dz);
+    r.array(m_delta_extruder);
+    r.array(m_feedrate);
+    r.array(m_actual_feedrate);
+    r.array(m_width);
+    r.array(m_height);
+    r.array(m_mm3_per_mm);
+    r.array(m_fan_speed);
+    r.array(m_temperature);
+    for (std::vector<float> &time : m_time)
+        r.array(time);
+    r.array(m_layer_runs);
+    uint64_t num_z_exceptions = 0;
+    r.size(num_z_exceptions, sizeof(uint64_t) + sizeof(float));
+    m_z_exceptions.resize(r.good() ? size_t(num_z_exceptions) : 0);
+    for (auto &[move_id, z] : m_z_exceptions) {
+        uint64_t id = 0;
+        r.value(id);
+        r.value(z);
+        move_id = size_t(id);
+    }
+
+    // All the per move arrays have to be of the same size, the moves are accessed by index.
+    const size_t num_moves = m_gcode_ids.size();
+    bool         valid     = r.good() &&
+        m_packed.size() == num_moves && m_x.size() == num_moves && m_y.size() == num_moves && m_dz.size() == num_moves &&
+        m_delta_extruder.size() == num_moves && m_feedrate.size() == num_moves && m_actual_feedrate.size() == num_moves &&
+        m_width.size() == num_moves && m_height.size() == num_moves && m_mm3_per_mm.size() == num_moves &&
+        m_fan_speed.size() == num_moves && m_temperature.size() == num_moves &&
+        (num_moves == 0 || (! m_layer_runs.empty() && m_layer_runs.front().first_move == 0));
+    for (const std::vector<float> &time : m_time)
+        valid &= time.size() == num_moves;
+    if (! valid)
+        this->clear();
+    return valid;
+}
+
+std::string GCodeProcessor::result_cache_filename(const std::string &gcode_filename)
+{
+    return gcode_filename + ".preview_cache";
+}
+
+bool GCodeProcessor::save_result_cache(const GCodeProcessorResult &result, const std::string &gcode_filename)
+{
+    const std::optional<GCodeFileStamp> stamp = gcode_file_stamp(gcode_filename);
+    const std::optional<uint64_t>       hash  = gcode_file_hash(gcode_filename);
+    if (! stamp || ! hash)
+        return false;
+
+    const std::string cache_filename = result_cache_filename(gcode_filename);
+    // Write into a temporary file first, so that a partially written cache is never picked up.
+    const std::string tmp_filename   = cache_filename + ".tmp";
+    try {
+        boost::nowide::ofstream out(tmp_filename, std::ios::binary);
+        if (! out)
+            return false;
+        CacheWriter w(out);
+        out.write(ResultCacheMagic, sizeof(ResultCacheMagic));
+        w.value(ResultCacheVersion);
+        w.value(uint32_t(sizeof(size_t)));
+        w.value(stamp->size);
+        w.value(stamp->mtime);
+        w.value(*hash);
+
+        w.value(result.is_binary_file);
+        w.value(uint64_t(result.lines_ends.size()));
+        for (const std::vector<size_t> &lines_ends : result.lines_ends)
+            w.array(lines_ends);
+        w.value(uint64_t(result.bed_shape.size()));
+        for (const Vec2d &pt : result.bed_shape) {
+            w.value(pt.x());
+            w.value(pt.y());
+        }
+        w.value(result.max_print_height);
+        w.value(result.z_offset);
+        w.string(result.settings_ids.print);
+        w.strings(result.settings_ids.filament);
+        w.string(result.settings_ids.printer);
+        w.value(uint64_t(result.extruders_count));
+        w.value(result.backtrace_enabled);
+        w.strings(result.extruder_colors);
+        w.array(result.filament_diameters);
+        w.array(result.filament_densities);
+        w.array(result.filament_cost);
+        save_statistics(w, result.print_statistics);
+        w.value(uint64_t(result.custom_gcode_per_print_z.size()));
+        for (const CustomGCode::Item &item : result.custom_gcode_per_print_z) {
+            w.value(item.print_z);
+            w.value(item.type);
+            w.value(item.extruder);
+            w.string(item.color);
+            w.string(item.extra);
+        }
+        w.value(result.spiral_vase_mode);
+        if (result.compacted_moves.empty() && ! result.moves.empty())
+            GCodeProcessorResult::CompactMoves(result.moves).save(out);
+        else
+            result.compacted_moves.save(out);
+
+        out.close();
+        if (! out)
+            throw Slic3r::RuntimeError("Failed writing " + tmp_filename);
+        boost::filesystem::rename(tmp_filename, cache_filename);
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(warning) << "Failed to save the G-code preview cache " << cache_filename << ": " << ex.what();
+        boost::system::error_code ec;
+        boost::filesystem::remove(tmp_filename, ec);
+        return false;
+    }
+    return true;
+}
+
+bool GCodeProcessor::load_result_cache(const std::string &gcode_filename)
+{
+    const std::string cache_filename = result_cache_filename(gcode_filename);
+    boost::system::error_code ec;
+    const uint64_t cache_size = uint64_t(boost::filesystem::file_size(cache_filename, ec));
+    if (ec)
+        return false;
+    const std::optional<GCodeFileStamp> stamp = gcode_file_stamp(gcode_filename);
+    if (! stamp)
+        return false;
+
+    try {
+        boost::nowide::ifstream in(cache_filename, std::ios::binary);
+        if (! in)
+            return false;
+        CacheReader r(in, cache_size);
+
+        char           magic[sizeof(ResultCacheMagic)];
+        uint32_t       version     = 0;
+        uint32_t       size_t_size = 0;
+        GCodeFileStamp cached_stamp;
+        uint64_t       cached_hash = 0;
+        if (! in.read(magic, sizeof(magic)) || memcmp(magic, ResultCacheMagic, sizeof(magic)) != 0 ||
+            ! r.value(version) || version != ResultCacheVersion || ! r.value(size_t_size) || size_t_size != sizeof(size_t) ||
+            ! r.value(cached_stamp.size) || ! r.value(cached_stamp.mtime) || ! r.value(cached_hash) ||
+            ! (cached_stamp == *stamp))
+            return false;
+        // Only hash the G-code if the cheap checks pass.
+        if (const std::optional<uint64_t> hash = gcode_file_hash(gcode_filename); ! hash || *hash != cached_hash)
+            return false;
+
+        GCodeProcessorResult result;
+        result.reset();
+        uint64_t size = 0;
+        r.value(result.is_binary_file);
+        r.size(size, sizeof(uint64_t));
+        result.lines_ends.resize(r.good() ? size_t(size) : 0);
+        for (std::vector<size_t> &lines_ends : result.lines_ends)
+            r.array(lines_ends);
+        r.size(size, 2 * sizeof(double));
+        result.bed_shape.resize(r.good() ? size_t(size) : 0);
+        for (Vec2d &pt : result.bed_shape) {
+            r.value(pt.x());
+            r.value(pt.y());
+        }
+        r.value(result.max_print_height);
+        r.value(result.z_offset);
+        r.string(result.settings_ids.print);
+        r.strings(result.settings_ids.filament);
+        r.string(result.settings_ids.printer);
+        uint64_t extruders_count = 0;
+        r.value(extruders_count);
+        result.extruders_count = size_t(extruders_count);
+        r.value(result.backtrace_enabled);
+        r.strings(result.extruder_colors);
+        r.array(result.filament_diameters);
+        r.array(result.filament_densities);
+        r.array(result.filament_cost);
+        load_statistics(r, result.print_statistics);
+        r.size(size, sizeof(double));
+        result.custom_gcode_per_print_z.resize(r.good() ? size_t(size) : 0);
+        for (CustomGCode::Item &item : result.custom_gcode_per_print_z) {
+            r.value(item.print_z);
+            r.value(item.type);
+            r.value(item.extruder);
+            r.string(item.color);
+            r.string(item.extra);
+        }
+        r.value(result.spiral_vase_mode);
+        if (! r.good() || ! result.compacted_moves.load(in, cache_size))
+            return false;
+
+        result.filename = gcode_filename;
+        result.id       = ++s_result_id;
+        m_result        = std::move(result);
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(warning) << "Failed to load the G-code preview cache " << cache_filename << ": " << ex.what();
+        return false;
+    }
+    return true;
+}
+
+} // namespace Slic3r
@@ -284,6 +284,13 @@ std::string GCodeWriter::toolchange(unsigned int extruder_id)
 }
 
 std::string GCodeWriter::set_speed(double F, const std::string_view comment, const std::string_view cooling_marker) const
+{
+    std::string out;
+    this->set_speed(out, F, comment, cooling_marker);
+    return out;
+}
+
+void GCodeWriter::set_speed(std::string &out, double F, const std::string_view comment, const std::string_view cooling_marker) const
 {
     assert(F > 0.);
     assert(F < 100000.);
@@ -292,7 +299,7 @@ std::string GCodeWriter::set_speed(double F, const std::string_view comment, con
     w.emit_f(F);
     w.emit_comment(this->config.gcode_comments, comment);
     w.emit_string(cooling_marker);
-    return w.string();
+    w.append_to(out);
 }
 
 std::string GCodeWriter::get_travel_to_xy_gcode(const Vec2d &point, const std::string_view comment) const
@@ -386,6 +393,13 @@ std::string GCodeWriter::get_travel_to_z_gcode(double z, const std::string_view
 }
 
 std::string GCodeWriter::extrude_to_xy(const Vec2d &point, double dE, const std::string_view comment)
+{
+    std::string out;
+    this->extrude_to_xy(out, point, dE, comment);
+    return out;
+}
+
+void GCodeWriter::extrude_to_xy(std::string &out, const Vec2d &point, double dE, const std::string_view comment)
 {
     assert(dE != 0);
     assert(std::abs(dE) < 1000.0);
@@ -396,10 +410,17 @@ std::string GCodeWriter::extrude_to_xy(const Vec2d &point, double dE, const std:
     w.emit_xy(point);
     w.emit_e(m_extrusion_axis, m_extruder->extrude(dE).second);
     w.emit_comment(this->config.gcode_comments, comment);
-    return w.string();
+    w.append_to(out);
 }
 
 std::string GCodeWriter::extrude_to_xy_G2G3IJ(const Vec2d &point, const Vec2d &ij, const bool ccw, double dE, const std::string_view comment)
+{
+    std::string out;
+    this->extrude_to_xy_G2G3IJ(out, point, ij, ccw, dE, comment);
+    return out;
+}
+
+void GCodeWriter::extrude_to_xy_G2G3IJ(std::string &out, const Vec2d &point, const Vec2d &ij, const bool ccw, double dE, const std::string_view comment)
 {
     assert(std::abs(dE) < 1000.0);
     assert(dE != 0);
@@ -416,7 +437,7 @@ std::string GCodeWriter::extrude_to_xy_G2G3IJ(const Vec2d &point, const Vec2d &i
     w.emit_ij(ij);
     w.emit_e(m_extrusion_axis, m_extruder->extrude(dE).second);
     w.emit_comment(this->config.gcode_comments, comment);
-    return w.string();
+    w.append_to(out);
 }
 
 #if 0
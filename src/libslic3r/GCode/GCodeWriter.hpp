@@ -73,6 +73,8 @@ public:
     std::string toolchange_prefix() const;
     std::string toolchange(unsigned int extruder_id);
     std::string set_speed(double F, const std::string_view comment = {}, const std::string_view cooling_marker = {}) const;
+    // Variant appending the G-code line to out, saving a temporary string. Used by the extrusion hot loop.
+    void        set_speed(std::string &out, double F, const std::string_view comment = {}, const std::string_view cooling_marker = {}) const;
 
     std::string get_travel_to_xy_gcode(const Vec2d &point, const std::string_view comment) const;
     std::string travel_to_xy(const Vec2d &point, const std::string_view comment = {});
@@ -93,6 +95,9 @@ public:
     std::string travel_to_z(double z, const std::string_view comment = {});
     std::string extrude_to_xy(const Vec2d &point, double dE, const std::string_view comment = {});
     std::string extrude_to_xy_G2G3IJ(const Vec2d &point, const Vec2d &ij, const bool ccw, double dE, const std::string_view comment);
+    // Variants appending the G-code line to out, saving a temporary string per extrusion segment.
+    void        extrude_to_xy(std::string &out, const Vec2d &point, double dE, const std::string_view comment = {});
+    void        extrude_to_xy_G2G3IJ(std::string &out, const Vec2d &point, const Vec2d &ij, const bool ccw, double dE, const std::string_view comment);
 //    std::string extrude_to_xyz(const Vec3d &point, double dE, const std::string_view comment = {});
     std::string retract(bool before_wipe = false);
     std::string retract_for_toolchange(bool before_wipe = false);
@@ -239,6 +244,12 @@ public:
         return std::string(this->buf, ptr_err.ptr - buf);
     }
 
+    // Terminate the line and append it to out.
+    void append_to(std::string &out) {
+        *ptr_err.ptr ++ = '\n';
+        out.append(this->buf, ptr_err.ptr - buf);
+    }
+
 protected:
     static constexpr const size_t   buflen = 256;
     char                            buf[buflen];
@@ -94,6 +94,12 @@ Vec3f sample_power_cosine_hemisphere(const Vec2f &samples, float power) {
     return Vec3f(cos(term1) * term3, sin(term1) * term3, term2);
 }
 
+// Only model parts and negative volumes occlude the seams, they are the inputs of the visibility.
+bool is_visibility_source(const ModelVolume &model_volume)
+{
+    return model_volume.type() == ModelVolumeType::MODEL_PART || model_volume.type() == ModelVolumeType::NEGATIVE_VOLUME;
+}
+
 std::vector<float> raycast_visibility(
     const AABBTreeIndirect::Tree<3, float> &raycasting_tree,
     const indexed_triangle_set &triangles,
@@ -199,15 +205,18 @@ Visibility::Visibility(
     const Params &params,
     const std::function<void(void)> &throw_if_canceled
 ) {
+    m_obj_transform = obj_transform;
+    m_params        = params;
+
     BOOST_LOG_TRIVIAL(debug)
     << "SeamPlacer: gather occlusion meshes: start";
     indexed_triangle_set triangle_set;
     indexed_triangle_set negative_volumes_set;
     //add all parts
     for (const ModelVolume *model_volume : volumes) {
-        if (model_volume->type() == ModelVolumeType::MODEL_PART
-                || model_volume->type() == ModelVolumeType::NEGATIVE_VOLUME) {
+        if (Impl::is_visibility_source(*model_volume)) {
             auto model_transformation = model_volume->get_matrix();
+            m_sources.push_back({ model_volume->mesh_ptr(), model_transformation, model_volume->type() });
             indexed_triangle_set model_its = model_volume->mesh().its;
             its_transform(model_its, model_transformation);
             if (model_volume->type() == ModelVolumeType::MODEL_PART) {
@@ -276,6 +285,25 @@ Visibility::Visibility(
     throw_if_canceled();
 }
 
+bool Visibility::is_valid_for(const Transform3d &obj_transform, const ModelVolumePtrs &volumes, const Params &params) const
+{
+    if (m_obj_transform.matrix() != obj_transform.matrix() ||
+        m_params.raycasting_visibility_samples_count != params.raycasting_visibility_samples_count ||
+        m_params.fast_decimation_triangle_count_target != params.fast_decimation_triangle_count_target ||
+        m_params.sqr_rays_per_sample_point != params.sqr_rays_per_sample_point)
+        return false;
+
+    auto it_source = m_sources.begin();
+    for (const ModelVolume *model_volume : volumes)
+        if (Impl::is_visibility_source(*model_volume)) {
+            if (it_source == m_sources.end() || it_source->mesh != model_volume->mesh_ptr() ||
+                it_source->matrix.matrix() != model_volume->get_matrix().matrix() || it_source->type != model_volume->type())
+                return false;
+            ++ it_source;
+        }
+    return it_source == m_sources.end();
+}
+
 float Visibility::calculate_point_visibility(const Vec3f &position) const {
     std::vector<size_t> points = find_nearby_points(mesh_samples_tree, position, mesh_samples_radius);
     if (points.empty()) {
@@ -3,6 +3,7 @@
 
 #include <stddef.h>
 #include <functional>
+#include <memory>
 #include <vector>
 #include <cstddef>
 
@@ -50,6 +51,23 @@ struct Visibility
     float mesh_samples_radius;
 
     float calculate_point_visibility(const Vec3f &position) const;
+
+    // Was this visibility calculated from the same geometry and parameters?
+    // Allows to reuse the visibility between G-code exports of an unchanged object.
+    bool is_valid_for(const Transform3d &obj_transform, const ModelVolumePtrs &volumes, const Params &params) const;
+
+private:
+    struct Source
+    {
+        // Holding the mesh prevents it from being modified in place while shared, see ModelVolume::set_mesh().
+        std::shared_ptr<const TriangleMesh> mesh;
+        Transform3d                         matrix;
+        ModelVolumeType                     type;
+    };
+
+    Transform3d         m_obj_transform;
+    std::vector<Source> m_sources;
+    Params              m_params;
 };
 
 } // namespace Slic3r::ModelInfo
@@ -147,10 +147,41 @@ static int run_script(const std::string &script, const std::string &gcode, std::
     return (int)execute_process_winapi(command_line);
 }
 
+// Run a chain of filters, see the POSIX implementation below.
+// The command line interpreter connects the filters into a pipeline. It only reports the exit code of the last filter,
+// thus a failure of any of the filters is reported as a failure of the last one.
+static size_t run_filters(const std::vector<std::string> &scripts, const std::string &gcode, int &exit_code, std::string &/*std_err*/)
+{
+    const std::string path_out = gcode + ".filtered";
+    std::wstring command_line = L"cmd.exe /S /C \"";
+    for (size_t i = 0; i < scripts.size(); ++ i) {
+        if (i > 0)
+            command_line += L" | ";
+        command_line += boost::nowide::widen(scripts[i]);
+        if (i == 0) {
+            command_line += L" < ";
+            quote_argv_winapi(boost::nowide::widen(gcode), command_line);
+        }
+    }
+    command_line += L" > ";
+    quote_argv_winapi(boost::nowide::widen(path_out), command_line);
+    command_line += L"\"";
+    exit_code = (int)execute_process_winapi(command_line);
+    if (exit_code != 0) {
+        boost::system::error_code ec;
+        boost::filesystem::remove(path_out, ec);
+        return scripts.size() - 1;
+    }
+    boost::filesystem::rename(path_out, gcode);
+    return scripts.size();
+}
+
 #else
     // POSIX
 
 #include <cstdlib>   // getenv()
+#include <iterator>
+#include <optional>
 #include <sstream>
 #include <boost/process.hpp>
 
@@ -188,6 +219,86 @@ static int run_script(const std::string &script, const std::string &gcode, std::
     return child.exit_code();
 }
 
+// Run a chain of filters like a shell pipeline. The first filter reads the G-code file on its standard input, each filter
+// writes the processed G-code to its standard output, which is read by the next filter. The filters run concurrently,
+// thus processing of the G-code by a filter overlaps with processing by the filters following it.
+// The output of the last filter replaces the G-code file.
+// Returns the index of the failing filter, its exit code and its standard error output are stored into exit_code and std_err.
+// Returns scripts.size() if all the filters succeeded.
+static size_t run_filters(const std::vector<std::string> &scripts, const std::string &gcode, int &exit_code, std::string &std_err)
+{
+    namespace fs = boost::filesystem;
+
+    const char *shell = ::getenv("SHELL");
+    if (shell == nullptr) { shell = "/bin/sh"; }
+
+    const fs::path path_in(gcode);
+    const fs::path path_out(gcode + ".filtered");
+    // The standard error outputs are captured into temporary files, reading multiple pipes by a single thread could block the filters.
+    std::vector<fs::path> paths_err;
+    auto remove_temp_files = [&path_out, &paths_err]() {
+        boost::system::error_code ec;
+        fs::remove(path_out, ec);
+        for (const fs::path &path : paths_err)
+            fs::remove(path, ec);
+    };
+
+    std::vector<process::child> children;
+    children.reserve(scripts.size());
+    try {
+        // A pipe is only created right before starting the filter writing into it, so that the filters started
+        // before don't inherit its file descriptors and the end of the G-code stream is reported to the reading filter.
+        std::optional<process::pipe> pipe_in, pipe_out;
+        for (size_t i = 0; i < scripts.size(); ++ i) {
+            BOOST_LOG_TRIVIAL(debug) << boost::format("Executing filter, shell: %1%, command: %2%") % shell % scripts[i];
+            paths_err.emplace_back(fs::temp_directory_path() / fs::unique_path("slic3r_pp_%%%%-%%%%-%%%%-%%%%.stderr"));
+            const fs::path &path_err = paths_err.back();
+            const bool      first    = i == 0;
+            const bool      last     = i + 1 == scripts.size();
+            if (! last)
+                pipe_out.emplace();
+            if (first && last)
+                children.emplace_back(shell, "-c", scripts[i], process::std_in < path_in, process::std_out > path_out, process::std_err > path_err);
+            else if (first)
+                children.emplace_back(shell, "-c", scripts[i], process::std_in < path_in, process::std_out > *pipe_out, process::std_err > path_err);
+            else if (last)
+                children.emplace_back(shell, "-c", scripts[i], process::std_in < *pipe_in, process::std_out > path_out, process::std_err > path_err);
+            else
+                children.emplace_back(shell, "-c", scripts[i], process::std_in < *pipe_in, process::std_out > *pipe_out, process::std_err > path_err);
+            pipe_in.reset();
+            std::swap(pipe_in, pipe_out);
+        }
+    } catch (...) {
+        // Destructors of the children terminate the filters already started.
+        children.clear();
+        remove_temp_files();
+        throw;
+    }
+
+    // A filter failing makes the filters before it fail with a broken pipe, report the last failing filter.
+    size_t failed = scripts.size();
+    for (size_t i = 0; i < children.size(); ++ i) {
+        children[i].wait();
+        if (children[i].exit_code() != 0)
+            failed = i;
+    }
+    if (failed < scripts.size()) {
+        exit_code = children[failed].exit_code();
+        boost::nowide::ifstream f(paths_err[failed].string());
+        std_err.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    }
+    if (failed == scripts.size()) {
+        try {
+            fs::rename(path_out, path_in);
+        } catch (...) {
+            remove_temp_files();
+            throw;
+        }
+    }
+    remove_temp_files();
+    return failed;
+}
+
 #endif
 
 namespace Slic3r {
@@ -268,33 +379,56 @@ bool run_post_process_scripts(std::string &src_path, bool make_copy, const std::
     remove_output_name_file();
 
     try {
-        for (const std::string &scripts : post_process->values) {
+        std::vector<std::string> scripts;
+        for (const std::string &script_lines : post_process->values) {
     		std::vector<std::string> lines;
-    		boost::split(lines, scripts, boost::is_any_of("\r\n"));
+    		boost::split(lines, script_lines, boost::is_any_of("\r\n"));
             for (std::string script : lines) {
                 // Ignore empty post processing script lines.
                 boost::trim(script);
-                if (script.empty())
+                if (! script.empty())
+                    scripts.emplace_back(std::move(script));
+            }
+        }
+        // A script starting with '|' is a filter, reading G-code on its standard input and writing it to its standard output.
+        auto is_filter = [](const std::string &script) { return script.front() == '|'; };
+        auto script_failed = [&path, &delete_copy](const std::string &script, int result, const std::string &std_err) {
+            const std::string msg = std_err.empty() ? (boost::format("Post-processing script %1% on file %2% failed.\nError code: %3%") % script % path % result).str()
+                : (boost::format("Post-processing script %1% on file %2% failed.\nError code: %3%\nOutput:\n%4%") % script % path % result % std_err).str();
+            BOOST_LOG_TRIVIAL(error) << msg;
+            delete_copy();
+            throw Slic3r::RuntimeError(msg);
+        };
+        for (size_t i = 0; i < scripts.size();) {
+            if (is_filter(scripts[i])) {
+                // Consecutive filters are chained into a single pipeline.
+                std::vector<std::string> filters;
+                for (; i < scripts.size() && is_filter(scripts[i]); ++ i)
+                    if (std::string filter = boost::trim_copy(scripts[i].substr(1)); ! filter.empty())
+                        filters.emplace_back(std::move(filter));
+                if (filters.empty())
                     continue;
-                BOOST_LOG_TRIVIAL(info) << "Executing script " << script << " on file " << path;
+                BOOST_LOG_TRIVIAL(info) << "Executing filters " << boost::join(filters, " | ") << " on file " << path;
+                int         result = 0;
                 std::string std_err;
-                const int result = run_script(script, gcode_file.string(), std_err);
-                if (result != 0) {
-                    const std::string msg = std_err.empty() ? (boost::format("Post-processing script %1% on file %2% failed.\nError code: %3%") % script % path % result).str()
-                        : (boost::format("Post-processing script %1% on file %2% failed.\nError code: %3%\nOutput:\n%4%") % script % path % result % std_err).str();
-                    BOOST_LOG_TRIVIAL(error) << msg;
-                    delete_copy();
-                    throw Slic3r::RuntimeError(msg);
-                }
-                if (! boost::filesystem::exists(gcode_file)) {
-                    const std::string msg = (boost::format(_u8L(
-                        "Post-processing script %1% failed.\n\n"
-                        "The post-processing script is expected to change the G-code file %2% in place, but the G-code file was deleted and likely saved under a new name.\n"
-                        "Please adjust the post-processing script to change the G-code in place and consult the manual on how to optionally rename the post-processed G-code file.\n"))
-                        % script % path).str();
-                    BOOST_LOG_TRIVIAL(error) << msg;
-                    throw Slic3r::RuntimeError(msg);
-                }
+                if (size_t failed = run_filters(filters, gcode_file.string(), result, std_err); failed < filters.size())
+                    script_failed(filters[failed], result, std_err);
+                continue;
+            }
+            const std::string &script = scripts[i ++];
+            BOOST_LOG_TRIVIAL(info) << "Executing script " << script << " on file " << path;
+            std::string std_err;
+            const int result = run_script(script, gcode_file.string(), std_err);
+            if (result != 0)
+                script_failed(script, result, std_err);
+            if (! boost::filesystem::exists(gcode_file)) {
+                const std::string msg = (boost::format(_u8L(
+                    "Post-processing script %1% failed.\n\n"
+                    "The post-processing script is expected to change the G-code file %2% in place, but the G-code file was deleted and likely saved under a new name.\n"
+                    "Please adjust the post-processing script to change the G-code in place and consult the manual on how to optionally rename the post-processed G-code file.\n"))
+                    % script % path).str();
+                BOOST_LOG_TRIVIAL(error) << msg;
+                throw Slic3r::RuntimeError(msg);
             }
         }
         if (boost::filesystem::exists(path_output_name)) {
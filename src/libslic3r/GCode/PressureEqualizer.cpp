@@ -12,6 +12,9 @@
 #include <limits>
 #include <cctype>
 #include <cstdlib>
+#include <string_view>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 
 #include "libslic3r/PrintConfig.hpp"
 #include "libslic3r/GCode.hpp"
@@ -94,11 +97,13 @@ void PressureEqualizer::process_layer(const std::string &gcode)
 {
     if (!gcode.empty()) {
         const char *gcode_begin = gcode.c_str();
+        const char *gcode_last  = gcode.c_str() + gcode.size();
         while (*gcode_begin != 0) {
             // Find end of the line.
-            const char *gcode_end = gcode_begin;
             // Slic3r always generates end of lines in a Unix style.
-            for (; *gcode_end != 0 && *gcode_end != '\n'; ++gcode_end);
+            const char *gcode_end = static_cast<const char*>(memchr(gcode_begin, '\n', gcode_last - gcode_begin));
+            if (gcode_end == nullptr)
+                gcode_end = gcode_last;
 
             m_gcode_lines.emplace_back();
             if (!this->process_line(gcode_begin, gcode_end, m_gcode_lines.back())) {
@@ -115,6 +120,8 @@ void PressureEqualizer::process_layer(const std::string &gcode)
     // At this point, we have an entire layer of gcode lines loaded into m_gcode_lines.
     // Now, we will split the mix of travels and extrusions into segments of continuous extrusions and process them.
     // We skip over large travels, and pretend that small ones are part of a continuous extrusion segment.
+    // Pairs of indices of the first line and one past the last processed line of each extrusion segment.
+    std::vector<std::pair<size_t, size_t>> extrusion_segments;
     for (auto current_extrusion_end_it = m_gcode_lines.cbegin(); current_extrusion_end_it != m_gcode_lines.cend();) {
         // Find beginning of next extrusion segment from current position.
         const auto current_extrusion_begin_it = std::find_if(current_extrusion_end_it, m_gcode_lines.cend(), [](const GCodeLine &line) {
@@ -143,21 +150,29 @@ void PressureEqualizer::process_layer(const std::string &gcode)
             }
         }
 
-        // Now, run the pressure equalizer across the segment like a streamroller.
-        // It operates on a sliding window that moves forward across gcode line by line.
-        const std::ptrdiff_t current_extrusion_begin_idx = std::distance(m_gcode_lines.cbegin(), current_extrusion_begin_it);
-        for (auto current_line_it = current_extrusion_begin_it; current_line_it != current_extrusion_end_it; ++current_line_it) {
-            const std::ptrdiff_t current_line_idx = std::distance(m_gcode_lines.cbegin(), current_line_it);
-
-            // Feed pressure equalizer past lines, going back to max_look_back_limit (or start of segment).
-            const size_t start_idx = size_t(std::max<std::ptrdiff_t>(current_extrusion_begin_idx, current_line_idx - max_look_back_limit));
-            adjust_volumetric_rate(start_idx, size_t(current_line_idx));
-        }
+        if (current_extrusion_begin_it != current_extrusion_end_it)
+            extrusion_segments.emplace_back(size_t(std::distance(m_gcode_lines.cbegin(), current_extrusion_begin_it)),
+                                            size_t(std::distance(m_gcode_lines.cbegin(), current_extrusion_end_it)));
 
         // Current extrusion is all done processing so advance beyond it for the next loop.
         if (current_extrusion_end_it != m_gcode_lines.cend())
             ++current_extrusion_end_it;
     }
+
+    // Now, run the pressure equalizer across each segment like a streamroller.
+    // It operates on a sliding window that moves forward across gcode line by line.
+    // adjust_volumetric_rate() only touches the lines of a single segment and segments don't overlap,
+    // thus the segments are processed in parallel.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, extrusion_segments.size()), [this, &extrusion_segments](const tbb::blocked_range<size_t> &range) {
+        for (size_t segment_idx = range.begin(); segment_idx < range.end(); ++segment_idx) {
+            const auto [current_extrusion_begin_idx, current_extrusion_end_idx] = extrusion_segments[segment_idx];
+            for (size_t current_line_idx = current_extrusion_begin_idx; current_line_idx < current_extrusion_end_idx; ++current_line_idx) {
+                // Feed pressure equalizer past lines, going back to max_look_back_limit (or start of segment).
+                const size_t start_idx = std::max(current_extrusion_begin_idx, current_line_idx - std::min<size_t>(current_line_idx, max_look_back_limit));
+                adjust_volumetric_rate(start_idx, current_line_idx);
+            }
+        }
+    });
 }
 
 PressureEqualizer::GCodeLinesConstIt PressureEqualizer::advance_segment_beyond_small_gap(const GCodeLinesConstIt &last_extruding_line_it) const {
@@ -205,7 +220,7 @@ LayerResult PressureEqualizer::process_layer(LayerResult &&input)
     m_gcode_lines.erase(m_gcode_lines.begin(), m_gcode_lines.begin() + int(next_layer_first_idx));
 
     if (output_buffer_length > 0)
-        prev_layer_result->gcode = std::string(output_buffer.data());
+        prev_layer_result->gcode = std::string(output_buffer.data(), output_buffer_length);
 
     assert(!input.nop_layer_result || m_layer_results.empty());
     LayerResult out = *prev_layer_result;
@@ -294,9 +309,11 @@ bool PressureEqualizer::process_line(const char *line, const char *line_end, GCo
     buf.max_volumetric_extrusion_rate_slope_negative = 0.f;
     buf.extrusion_role = m_current_extrusion_role;
 
-    std::string str_line(line, line_end);
-    const bool found_extrude_set_speed_tag = boost::contains(str_line, EXTRUDE_SET_SPEED_TAG);
-    const bool found_extrude_end_tag = boost::contains(str_line, EXTRUDE_END_TAG);
+    // Tags are comments, thus search for them in the comment part of the line only.
+    const char            *comment_begin = static_cast<const char*>(memchr(line, ';', len));
+    const std::string_view comment       = comment_begin == nullptr ? std::string_view() : std::string_view(comment_begin, line_end - comment_begin);
+    const bool found_extrude_set_speed_tag = boost::contains(comment, EXTRUDE_SET_SPEED_TAG);
+    const bool found_extrude_end_tag = boost::contains(comment, EXTRUDE_END_TAG);
     assert(!found_extrude_set_speed_tag || !found_extrude_end_tag);
 
     if (found_extrude_set_speed_tag)
@@ -757,7 +774,7 @@ inline void PressureEqualizer::push_to_output(const char *text, const size_t len
     output_buffer[output_buffer_length] = 0;
 }
 
-inline bool is_just_line_with_extrude_set_speed_tag(const std::string &line)
+inline bool is_just_line_with_extrude_set_speed_tag(const std::string_view line)
 {
     if (line.empty() && !boost::starts_with(line, "G1 ") && !boost::ends_with(line, EXTRUDE_SET_SPEED_TAG))
         return false;
@@ -782,8 +799,8 @@ void PressureEqualizer::push_line_to_output(const size_t line_idx, float new_fee
 
     const GCodeLine &line = m_gcode_lines[line_idx];
     if (line_idx > 0 && output_buffer_length > 0) {
-        const std::string prev_line_str = std::string(output_buffer.begin() + int(this->output_buffer_prev_length),
-                                                      output_buffer.begin() + int(this->output_buffer_length) + 1);
+        const std::string_view prev_line_str(output_buffer.data() + this->output_buffer_prev_length,
+                                             this->output_buffer_length + 1 - this->output_buffer_prev_length);
         if (is_just_line_with_extrude_set_speed_tag(prev_line_str))
             this->output_buffer_length = this->output_buffer_prev_length; // Remove the last line because it only sets the speed for an empty block of g-code lines, so it is useless.
         else
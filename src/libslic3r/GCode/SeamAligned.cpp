@@ -269,6 +269,8 @@ struct LeastVisiblePoint
 struct SeamCandidate {
     std::vector<SeamChoice> choices;
     std::vector<double> visibilities;
+    // Sum of the visibilities, summed up when the candidate is created in parallel with the other candidates.
+    double total_visibility{};
 };
 
 std::vector<SeamChoice> get_shell_seam(
@@ -336,7 +338,11 @@ SeamCandidate get_seam_candidate(
             previous_position = candidate.position;
             return candidate;
         })};
-    return {std::move(choices), std::move(choice_visibilities)};
+    double total_visibility{0.0};
+    for (const double visibility : choice_visibilities) {
+        total_visibility += visibility;
+    }
+    return {std::move(choices), std::move(choice_visibilities), total_visibility};
 }
 
 using ShellVertexVisibility = std::vector<std::vector<double>>;
@@ -440,18 +446,16 @@ std::vector<ShellSeamCandidates> get_shells_seam_candidates(
 }
 
 std::vector<SeamChoice> get_shell_seam(
-    const Shells::Shell<> &shell,
-    std::vector<SeamCandidate> seam_candidates,
+    std::vector<SeamCandidate> &&seam_candidates,
     const Perimeters::Perimeter::OptionalPointTree &previous_points,
     const Params &params
 ) {
-    std::vector<SeamChoice> seam;
+    // Only the continuity with the seams of the previous layer depends on the shells solved before,
+    // the visibility of all the candidates is already summed up.
+    SeamCandidate *best_candidate{nullptr};
     double visibility{std::numeric_limits<double>::infinity()};
 
-    for (std::size_t i{0}; i < seam_candidates.size(); ++i) {
-        using Perimeters::Perimeter, Perimeters::AngleType;
-
-        SeamCandidate seam_candidate{seam_candidates[i]};
+    for (SeamCandidate &seam_candidate : seam_candidates) {
         const Vec2d first_point{seam_candidate.choices.front().position};
 
         std::optional<Vec2d> closest_point;
@@ -469,21 +473,19 @@ std::vector<SeamChoice> get_shell_seam(
         }
         const bool is_near_previous{closest_point && *previous_distance < params.max_detour};
 
-        double seam_candidate_visibility{
-            is_near_previous ? -params.continuity_modifier *
+        const double seam_candidate_visibility{
+            seam_candidate.total_visibility +
+            (is_near_previous ? -params.continuity_modifier *
                     (params.max_detour - *previous_distance) / params.max_detour :
-                               0.0};
-        for (std::size_t slice_index{}; slice_index < shell.size(); ++slice_index) {
-            seam_candidate_visibility += seam_candidate.visibilities[slice_index];
-        }
+                               0.0)};
 
         if (seam_candidate_visibility < visibility) {
-            seam = std::move(seam_candidate.choices);
+            best_candidate = &seam_candidate;
             visibility = seam_candidate_visibility;
         }
     }
 
-    return seam;
+    return best_candidate == nullptr ? std::vector<SeamChoice>{} : std::move(best_candidate->choices);
 }
 
 std::vector<std::vector<SeamPerimeterChoice>> get_object_seams(
@@ -502,7 +504,7 @@ std::vector<std::vector<SeamPerimeterChoice>> get_object_seams(
         get_shells_starting_positions(shells)
     };
 
-    const std::vector<ShellSeamCandidates> seam_candidates{
+    std::vector<ShellSeamCandidates> seam_candidates{
         get_shells_seam_candidates(
             shells,
             starting_positions,
@@ -540,7 +542,7 @@ std::vector<std::vector<SeamPerimeterChoice>> get_object_seams(
         }
 
         std::vector<SeamChoice> seam{
-            Aligned::get_shell_seam(shell, seam_candidates[shell_index], previous_seams_positions_tree, params)};
+            Aligned::get_shell_seam(std::move(seam_candidates[shell_index]), previous_seams_positions_tree, params)};
 
         for (std::size_t perimeter_id{}; perimeter_id < shell.size(); ++perimeter_id) {
             const SeamChoice &choice{seam[perimeter_id]};
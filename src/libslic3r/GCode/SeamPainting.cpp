@@ -3,22 +3,31 @@
 #include "libslic3r/TriangleMesh.hpp"
 #include "libslic3r/TriangleSelector.hpp"
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+
 namespace Slic3r::Seams::ModelInfo {
 Painting::Painting(const Transform3d &obj_transform, const ModelVolumePtrs &volumes) {
-    for (const ModelVolume *mv : volumes) {
-        if (mv->is_seam_painted()) {
-            auto model_transformation = obj_transform * mv->get_matrix();
-
-            indexed_triangle_set enforcers = mv->seam_facets
-                                                 .get_facets(*mv, TriangleStateType::ENFORCER);
-            its_transform(enforcers, model_transformation);
-            its_merge(this->enforcers, enforcers);
-
-            indexed_triangle_set blockers = mv->seam_facets
-                                                .get_facets(*mv, TriangleStateType::BLOCKER);
-            its_transform(blockers, model_transformation);
-            its_merge(this->blockers, blockers);
+    // Reconstruct the painted triangles of the volumes in parallel, merge them in the order of volumes.
+    std::vector<indexed_triangle_set> volume_enforcers(volumes.size());
+    std::vector<indexed_triangle_set> volume_blockers(volumes.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, volumes.size()), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t volume_idx = range.begin(); volume_idx < range.end(); ++volume_idx) {
+            const ModelVolume *mv = volumes[volume_idx];
+            if (mv->is_seam_painted()) {
+                auto model_transformation = obj_transform * mv->get_matrix();
+
+                volume_enforcers[volume_idx] = mv->seam_facets.get_facets(*mv, TriangleStateType::ENFORCER);
+                its_transform(volume_enforcers[volume_idx], model_transformation);
+
+                volume_blockers[volume_idx] = mv->seam_facets.get_facets(*mv, TriangleStateType::BLOCKER);
+                its_transform(volume_blockers[volume_idx], model_transformation);
+            }
         }
+    });
+    for (size_t volume_idx = 0; volume_idx < volumes.size(); ++volume_idx) {
+        its_merge(this->enforcers, std::move(volume_enforcers[volume_idx]));
+        its_merge(this->blockers, std::move(volume_blockers[volume_idx]));
     }
 
     this->enforcers_tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(
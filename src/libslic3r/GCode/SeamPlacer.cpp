@@ -79,11 +79,17 @@ ObjectSeams precalculate_seams(
             const Transform3d transformation{print_object->trafo_centered()};
             const ModelVolumePtrs &volumes{print_object->model_object()->volumes};
 
-            Slic3r::ModelInfo::Visibility
-                points_visibility{transformation, volumes, params.visibility, throw_if_canceled};
+            // Raycasting the visibility is expensive, reuse the one of the previous export if the geometry did not change.
+            std::shared_ptr<const Slic3r::ModelInfo::Visibility> points_visibility{print_object->seam_visibility()};
+            if (!points_visibility || !points_visibility->is_valid_for(transformation, volumes, params.visibility)) {
+                // Release the old visibility before calculating the new one.
+                print_object->set_seam_visibility(nullptr);
+                points_visibility = std::make_shared<const Slic3r::ModelInfo::Visibility>(transformation, volumes, params.visibility, throw_if_canceled);
+                print_object->set_seam_visibility(points_visibility);
+            }
             throw_if_canceled();
             const Aligned::VisibilityCalculator visibility_calculator{
-                points_visibility, params.convex_visibility_modifier,
+                *points_visibility, params.convex_visibility_modifier,
                 params.concave_visibility_modifier};
 
             Shells::Shells<> shells{Shells::create_shells(std::move(layer_perimeters), params.max_distance)};
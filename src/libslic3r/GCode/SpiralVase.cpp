@@ -44,30 +44,37 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
         return gcode;
     }
 
+    // Parse the layer once. The XY length and the extrusion flag of a line depend on the position of the reader
+    // before the line is processed, they are remembered for the second pass over the parsed lines.
+    struct ParsedLine {
+        GCodeReader::GCodeLine line;
+        float                  dist_XY;
+        bool                   extruding;
+    };
+    std::vector<ParsedLine> lines;
+
     // Get total XY length for this layer by summing all extrusion moves.
     float total_layer_length = 0.f;
     float layer_height       = 0.f;
     float z                  = 0.f;
-
-    {
-        //FIXME Performance warning: This copies the GCodeConfig of the reader.
-        GCodeReader r = m_reader;  // clone
-        bool set_z = false;
-        r.parse_buffer(gcode, [&total_layer_length, &layer_height, &z, &set_z]
-            (GCodeReader &reader, const GCodeReader::GCodeLine &line) {
-            if (line.cmd_is("G1")) {
-                if (line.extruding(reader)) {
-                    total_layer_length += line.dist_XY(reader);
-                } else if (line.has(Z)) {
-                    layer_height += line.dist_Z(reader);
-                    if (!set_z) {
-                        z = line.new_Z(reader);
-                        set_z = true;
-                    }
+    bool  set_z              = false;
+    m_reader.parse_buffer(gcode, [&lines, &total_layer_length, &layer_height, &z, &set_z]
+        (GCodeReader &reader, const GCodeReader::GCodeLine &line) {
+        const float dist_XY   = line.dist_XY(reader);
+        const bool  extruding = line.extruding(reader);
+        if (line.cmd_is("G1")) {
+            if (extruding) {
+                total_layer_length += dist_XY;
+            } else if (line.has(Z)) {
+                layer_height += line.dist_Z(reader);
+                if (!set_z) {
+                    z = line.new_Z(reader);
+                    set_z = true;
                 }
             }
-        });
-    }
+        }
+        lines.push_back({ line, dist_XY, extruding });
+    });
 
     // Remove layer height from initial Z.
     z -= layer_height;
@@ -86,34 +93,33 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
 
     std::string        new_gcode, transition_gcode;
     std::vector<Vec2f> current_layer;
-    m_reader.parse_buffer(gcode, [z, total_layer_length, layer_height, transition_in, transition_out, smooth_spiral, max_xy_smoothing = m_max_xy_smoothing,
-                                  &len, &last_point, &new_gcode, &transition_gcode, &current_layer, &previous_layer_distancer]
-        (GCodeReader &reader, GCodeReader::GCodeLine line) {
+    for (ParsedLine &parsed : lines) {
+        GCodeReader::GCodeLine &line = parsed.line;
         if (line.cmd_is("G1")) {
             if (line.has_z()) {
                 // If this is the initial Z move of the layer, replace it with a
                 // (redundant) move to the last Z of previous layer.
-                line.set(reader, Z, z);
+                line.set(m_reader, Z, z);
                 new_gcode += line.raw() + '\n';
-                return;
+                continue;
             } else if (line.has_x() || line.has_y()) { // Sometimes lines have X/Y but the move is to the last position.
-                if (const float dist_XY = line.dist_XY(reader); dist_XY > 0 && line.extruding(reader)) { // Exclude wipe and retract
+                if (const float dist_XY = parsed.dist_XY; dist_XY > 0 && parsed.extruding) { // Exclude wipe and retract
                     len += dist_XY;
                     const float factor = len / total_layer_length;
                     if (transition_in)
                         // Transition layer, interpolate the amount of extrusion from zero to the final value.
-                        line.set(reader, E, line.e() * factor, 5);
+                        line.set(m_reader, E, line.e() * factor, 5);
                     else if (transition_out) {
                         // We want the last layer to ramp down extrusion, but without changing z height!
                         // So clone the line before we mess with its Z and duplicate it into a new layer that ramps down E
                         // We add this new layer at the very end
                         GCodeReader::GCodeLine transition_line(line);
-                        transition_line.set(reader, E, line.e() * (1.f - factor), 5);
+                        transition_line.set(m_reader, E, line.e() * (1.f - factor), 5);
                         transition_gcode += transition_line.raw() + '\n';
                     }
 
                     // This line is the core of Spiral Vase mode, ramp up the Z smoothly
-                    line.set(reader, Z, z + factor * layer_height);
+                    line.set(m_reader, Z, z + factor * layer_height);
 
                     bool emit_gcode_line = true;
                     if (smooth_spiral) {
@@ -122,19 +128,19 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
                         current_layer.emplace_back(p); // Store that point for later use on the next layer
 
                         auto [nearest_distance, idx, nearest_pt] = previous_layer_distancer.distance_from_lines_extra<false>(p.cast<double>());
-                        if (nearest_distance < max_xy_smoothing) {
+                        if (nearest_distance < m_max_xy_smoothing) {
                             // Interpolate between the point on this layer and the point on the previous layer
                             Vec2f target = nearest_pt.cast<float>() * (1.f - factor) + p * factor;
 
                             // We will emit a new g-code line only when XYZ positions differ from the previous g-code line.
                             emit_gcode_line = GCodeFormatter::quantize(last_point) != GCodeFormatter::quantize(target);
 
-                            line.set(reader, X, target.x());
-                            line.set(reader, Y, target.y());
+                            line.set(m_reader, X, target.x());
+                            line.set(m_reader, Y, target.y());
                             // We need to figure out the distance of this new line!
                             float modified_dist_XY = (last_point - target).norm();
                             // Scale the extrusion amount according to change in length
-                            line.set(reader, E, line.e() * modified_dist_XY / dist_XY, 5);
+                            line.set(m_reader, E, line.e() * modified_dist_XY / dist_XY, 5);
                             last_point = target;
                         } else {
                             last_point = p;
@@ -144,7 +150,7 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
                     if (emit_gcode_line)
                         new_gcode += line.raw() + '\n';
                 }
-                return;
+                continue;
                 /*  Skip travel moves: the move to first perimeter point will
                     cause a visible seam when loops are not aligned in XY; by skipping
                     it we blend the first loop move in the XY plane (although the smoothness
@@ -158,7 +164,7 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
         new_gcode += line.raw() + '\n';
         if (transition_out)
             transition_gcode += line.raw() + '\n';
-    });
+    }
 
     m_previous_layer = std::move(current_layer);
     return new_gcode + transition_gcode;
@@ -13,6 +13,9 @@
 #include <string>
 #include <cstdint>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include "libslic3r/miniz_extension.hpp" // IWYU pragma: keep
 #include "../format.hpp"
 #include "libslic3r/Config.hpp"
@@ -132,6 +135,34 @@ std::unique_ptr<CompressedImageBuffer> compress_thumbnail(const ThumbnailData &d
     }
 }
 
+std::vector<CompressedThumbnail> render_and_compress_thumbnails(const ThumbnailsGeneratorCallback &thumbnail_cb, const std::vector<std::pair<GCodeThumbnailsFormat, Vec2d>> &thumbnails_list)
+{
+    // The same size may be requested in multiple formats, render it just once.
+    Vec2ds sizes;
+    for (const auto &[format, size] : thumbnails_list)
+        if (std::find(sizes.begin(), sizes.end(), size) == sizes.end())
+            sizes.emplace_back(size);
+    // Thumbnails failing to render are dropped from the list, thus they are matched with the requests by their dimensions.
+    const ThumbnailsList thumbnails = thumbnail_cb(ThumbnailsParams{ sizes, true, true, true, true });
+
+    std::vector<CompressedThumbnail> out(thumbnails_list.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, thumbnails_list.size(), 1), [&thumbnails_list, &thumbnails, &out](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            const auto &[format, size] = thumbnails_list[i];
+            const Point isize(size); // round to ints, see Plater::priv::generate_thumbnails()
+            auto it = std::find_if(thumbnails.begin(), thumbnails.end(), [&isize](const ThumbnailData &data)
+                { return data.is_valid() && int(data.width) == isize.x() && int(data.height) == isize.y(); });
+            if (it != thumbnails.end()) {
+                out[i] = { format, it->width, it->height, compress_thumbnail(*it, format) };
+                if (out[i].image->data == nullptr || out[i].image->size == 0)
+                    out[i].image.reset();
+            }
+        }
+    });
+    out.erase(std::remove_if(out.begin(), out.end(), [](const CompressedThumbnail &thumbnail) { return ! thumbnail.image; }), out.end());
+    return out;
+}
+
 std::pair<GCodeThumbnailDefinitionsList, ThumbnailErrors> make_and_check_thumbnail_list(const std::string& thumbnails_string, const std::string_view def_ext /*= "PNG"sv*/)
 {
     if (thumbnails_string.empty())
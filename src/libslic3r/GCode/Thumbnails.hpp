@@ -45,6 +45,19 @@ struct CompressedImageBuffer
 
 std::unique_ptr<CompressedImageBuffer> compress_thumbnail(const ThumbnailData &data, GCodeThumbnailsFormat format);
 
+struct CompressedThumbnail
+{
+    GCodeThumbnailsFormat                  format;
+    unsigned int                           width;
+    unsigned int                           height;
+    std::unique_ptr<CompressedImageBuffer> image;
+};
+
+// Renders thumbnails of all the distinct sizes of thumbnails_list by a single call of thumbnail_cb, that is by a single round trip
+// to the UI thread, then compresses them in parallel. The result is ordered as thumbnails_list, thumbnails which failed to render
+// or to compress are left out.
+std::vector<CompressedThumbnail> render_and_compress_thumbnails(const ThumbnailsGeneratorCallback &thumbnail_cb, const std::vector<std::pair<GCodeThumbnailsFormat, Vec2d>> &thumbnails_list);
+
 typedef std::vector<std::pair<GCodeThumbnailsFormat, Vec2d>> GCodeThumbnailDefinitionsList;
 
 using namespace std::literals;
@@ -58,31 +71,25 @@ inline void export_thumbnails_to_file(ThumbnailsGeneratorCallback &thumbnail_cb,
 {
     // Write thumbnails using base64 encoding
     if (thumbnail_cb != nullptr) {
-        for (const auto& [format, size] : thumbnails_list) {
-            static constexpr const size_t max_row_length = 78;
-            ThumbnailsList thumbnails = thumbnail_cb(ThumbnailsParams{ {size}, true, true, true, true });
-            for (const ThumbnailData& data : thumbnails)
-                if (data.is_valid()) {
-                    auto compressed = compress_thumbnail(data, format);
-                    if (compressed->data && compressed->size) {
-                        std::string encoded;
-                        encoded.resize(boost::beast::detail::base64::encoded_size(compressed->size));
-                        encoded.resize(boost::beast::detail::base64::encode((void*)encoded.data(), (const void*)compressed->data, compressed->size));
-
-                        output((boost::format("\n;\n; %s begin %dx%d %d\n") % compressed->tag() % data.width % data.height % encoded.size()).str().c_str());
-
-                        while (encoded.size() > max_row_length) {
-                            output((boost::format("; %s\n") % encoded.substr(0, max_row_length)).str().c_str());
-                            encoded = encoded.substr(max_row_length);
-                        }
-
-                        if (encoded.size() > 0)
-                            output((boost::format("; %s\n") % encoded).str().c_str());
-
-                        output((boost::format("; %s end\n;\n") % compressed->tag()).str().c_str());
-                    }
-                    throw_if_canceled();
-                }
+        static constexpr const size_t max_row_length = 78;
+        for (const CompressedThumbnail &thumbnail : render_and_compress_thumbnails(thumbnail_cb, thumbnails_list)) {
+            const CompressedImageBuffer &compressed = *thumbnail.image;
+            std::string encoded;
+            encoded.resize(boost::beast::detail::base64::encoded_size(compressed.size));
+            encoded.resize(boost::beast::detail::base64::encode((void*)encoded.data(), (const void*)compressed.data, compressed.size));
+
+            output((boost::format("\n;\n; %s begin %dx%d %d\n") % compressed.tag() % thumbnail.width % thumbnail.height % encoded.size()).str().c_str());
+
+            while (encoded.size() > max_row_length) {
+                output((boost::format("; %s\n") % encoded.substr(0, max_row_length)).str().c_str());
+                encoded = encoded.substr(max_row_length);
+            }
+
+            if (encoded.size() > 0)
+                output((boost::format("; %s\n") % encoded).str().c_str());
+
+            output((boost::format("; %s end\n;\n") % compressed.tag()).str().c_str());
+            throw_if_canceled();
         }
     }
 }
@@ -96,25 +103,19 @@ inline void generate_binary_thumbnails(ThumbnailsGeneratorCallback& thumbnail_cb
     out_thumbnails.clear();
     assert(thumbnail_cb != nullptr);
     if (thumbnail_cb != nullptr) {
-        for (const auto& [format, size] : thumbnails_list) {
-            ThumbnailsList thumbnails = thumbnail_cb(ThumbnailsParams{ {size}, true, true, true, true });
-            for (const ThumbnailData &data : thumbnails)
-                if (data.is_valid()) {
-                    auto compressed = compress_thumbnail(data, format);
-                    if (compressed->data != nullptr && compressed->size > 0) {
-                        ThumbnailBlock& block = out_thumbnails.emplace_back(ThumbnailBlock());
-                        block.params.width = (uint16_t)data.width;
-                        block.params.height = (uint16_t)data.height;
-                        switch (format) {
-                        case GCodeThumbnailsFormat::PNG: { block.params.format = (uint16_t)EThumbnailFormat::PNG; break; }
-                        case GCodeThumbnailsFormat::JPG: { block.params.format = (uint16_t)EThumbnailFormat::JPG; break; }
-                        case GCodeThumbnailsFormat::QOI: { block.params.format = (uint16_t)EThumbnailFormat::QOI; break; }
-                        }
-                        block.data.resize(compressed->size);
-                        memcpy(block.data.data(), compressed->data, compressed->size);
-                    }
-                }
+        for (const CompressedThumbnail &thumbnail : render_and_compress_thumbnails(thumbnail_cb, thumbnails_list)) {
+            ThumbnailBlock& block = out_thumbnails.emplace_back(ThumbnailBlock());
+            block.params.width = (uint16_t)thumbnail.width;
+            block.params.height = (uint16_t)thumbnail.height;
+            switch (thumbnail.format) {
+            case GCodeThumbnailsFormat::PNG: { block.params.format = (uint16_t)EThumbnailFormat::PNG; break; }
+            case GCodeThumbnailsFormat::JPG: { block.params.format = (uint16_t)EThumbnailFormat::JPG; break; }
+            case GCodeThumbnailsFormat::QOI: { block.params.format = (uint16_t)EThumbnailFormat::QOI; break; }
+            }
+            block.data.resize(thumbnail.image->size);
+            memcpy(block.data.data(), thumbnail.image->data, thumbnail.image->size);
         }
+        throw_if_canceled();
     }
 }
 
@@ -1,6 +1,7 @@
 #include "Travels.hpp"
 
 #include <boost/math/special_functions/pow.hpp>
+#include <oneapi/tbb/parallel_invoke.h>
 #include <algorithm>
 #include <cmath>
 #include <limits>
@@ -44,15 +45,18 @@ static Lines extrusion_entity_to_lines(const ExtrusionEntity &e_entity)
 AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef> get_previous_layer_distancer(
     const GCodeGenerator::ObjectsLayerToPrint &objects_to_print, const ExPolygons &slices
 ) {
+    // The slices are the same for all the instances, convert them to lines just once.
+    const Lines slices_lines = to_lines(slices);
+
     std::vector<ObjectOrExtrusionLinef> lines;
     for (const GCodeGenerator::ObjectLayerToPrint &object_to_print : objects_to_print) {
         if (const PrintObject *object = object_to_print.object(); object) {
             const size_t object_layer_idx = &object_to_print - &objects_to_print.front();
+            lines.reserve(lines.size() + object->instances().size() * slices_lines.size());
             for (const PrintInstance &instance : object->instances()) {
                 const size_t instance_idx = &instance - &object->instances().front();
-                for (const ExPolygon &polygon : slices)
-                    for (const Line &line : polygon.lines())
-                        lines.emplace_back(unscaled(Point{line.a + instance.shift}), unscaled(Point{line.b + instance.shift}), object_layer_idx, instance_idx);
+                for (const Line &line : slices_lines)
+                    lines.emplace_back(unscaled(Point{line.a + instance.shift}), unscaled(Point{line.b + instance.shift}), object_layer_idx, instance_idx);
             }
         }
     }
@@ -99,9 +103,11 @@ void TravelObstacleTracker::init_layer(const Layer &layer, const ObjectsLayerToP
     m_extruded_extrusion.clear();
 
     m_objects_to_print         = objects_to_print;
-    m_previous_layer_distancer = get_previous_layer_distancer(m_objects_to_print, layer.lower_layer->lslices);
+    // Both AABB trees are independent of each other, build them concurrently.
+    tbb::parallel_invoke(
+        [this, &layer]() { m_previous_layer_distancer = get_previous_layer_distancer(m_objects_to_print, layer.lower_layer->lslices); },
+        [this, &extrusion_entity_cnt]() { std::tie(m_current_layer_distancer, extrusion_entity_cnt) = get_current_layer_distancer(m_objects_to_print); });
 
-    std::tie(m_current_layer_distancer, extrusion_entity_cnt) = get_current_layer_distancer(m_objects_to_print);
     m_extruded_extrusion.reserve(extrusion_entity_cnt);
 }
 
@@ -246,7 +252,8 @@ double get_first_crossed_line_distance(
     const AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef> &distancer,
     const ObjectsLayerToPrint &objects_to_print,
     const std::function<bool(const ObjectOrExtrusionLinef &)> &predicate,
-    const bool ignore_starting_object_intersection
+    const bool ignore_starting_object_intersection,
+    const double max_distance
 ) {
     assert(!xy_path.empty());
     if (xy_path.empty())
@@ -258,6 +265,10 @@ double get_first_crossed_line_distance(
     Intersection first_intersection;
 
     for (const Line &line : xy_path) {
+        if (traversed_distance >= max_distance)
+            // Any intersection found from now on would be further than max_distance.
+            break;
+
         const ObjectOrExtrusionLinef                    unscaled_line = {unscaled(line.a), unscaled(line.b)};
         const std::vector<std::pair<Vec2d, size_t>>     intersections = distancer.intersections_with_line<true>(unscaled_line);
 
@@ -298,13 +309,16 @@ double get_first_crossed_line_distance(
     return std::numeric_limits<double>::max();
 }
 
-double get_obstacle_adjusted_slope_end(const Lines &xy_path, const GCode::TravelObstacleTracker &obstacle_tracker) {
+// Only obstacles closer than slope_end may shorten the slope, thus the rest of the travel is not searched.
+double get_obstacle_adjusted_slope_end(const Lines &xy_path, const GCode::TravelObstacleTracker &obstacle_tracker, const double slope_end) {
+    const auto any_line = [](const ObjectOrExtrusionLinef &) { return true; };
     const double previous_layer_crossed_line = get_first_crossed_line_distance(
-        xy_path, obstacle_tracker.previous_layer_distancer(), obstacle_tracker.objects_to_print()
+        xy_path, obstacle_tracker.previous_layer_distancer(), obstacle_tracker.objects_to_print(), any_line, true, slope_end
     );
     const double current_layer_crossed_line = get_first_crossed_line_distance(
         xy_path, obstacle_tracker.current_layer_distancer(), obstacle_tracker.objects_to_print(),
-        [&obstacle_tracker](const ObjectOrExtrusionLinef &line) { return obstacle_tracker.is_extruded(line); }
+        [&obstacle_tracker](const ObjectOrExtrusionLinef &line) { return obstacle_tracker.is_extruded(line); },
+        true, std::min(slope_end, previous_layer_crossed_line)
     );
 
     return std::min(previous_layer_crossed_line, current_layer_crossed_line);
@@ -390,9 +404,11 @@ ElevatedTravelParams get_elevated_traval_params(
         elevation_params.slope_end = elevation_params.lift_height / std::tan(slope_rad);
     }
 
-    const double obstacle_adjusted_slope_end = get_obstacle_adjusted_slope_end(xy_path.lines(), obstacle_tracker);
-    if (obstacle_adjusted_slope_end < elevation_params.slope_end)
-        elevation_params.slope_end = obstacle_adjusted_slope_end;
+    if (elevation_params.slope_end > 0) {
+        const double obstacle_adjusted_slope_end = get_obstacle_adjusted_slope_end(xy_path.lines(), obstacle_tracker, elevation_params.slope_end);
+        if (obstacle_adjusted_slope_end < elevation_params.slope_end)
+            elevation_params.slope_end = obstacle_adjusted_slope_end;
+    }
 
     SmoothingParams smoothing_params{get_smoothing_params(
         elevation_params.lift_height, elevation_params.slope_end, extruder_id,
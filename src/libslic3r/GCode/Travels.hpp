@@ -12,6 +12,7 @@
 #include <boost/container_hash/hash.hpp>
 #include <vector>
 #include <functional>
+#include <limits>
 #include <optional>
 #include <cstddef>
 #include <unordered_set>
@@ -218,7 +219,9 @@ Points3 generate_elevated_travel(
  * @param objects_to_print Objects to print are used to determine in which object xy_path starts.
 
  * @param ignore_starting_object_intersection When it is true, then the first intersection during traveling from the object out is ignored.
+ * @param max_distance Intersections further than this distance are not searched for.
  * @return Distance to the first intersection if there is one.
+ * If there is no intersection closer than max_distance, a value not lower than max_distance is returned.
  *
  * **Ignores intersection with xy_path starting point.**
  */
@@ -227,7 +230,8 @@ double get_first_crossed_line_distance(
     const AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef> &distancer,
     const ObjectsLayerToPrint &objects_to_print = {},
     const std::function<bool(const ObjectOrExtrusionLinef &)> &predicate = [](const ObjectOrExtrusionLinef &) { return true; },
-    bool ignore_starting_object_intersection = true);
+    bool ignore_starting_object_intersection = true,
+    double max_distance = std::numeric_limits<double>::max());
 
 /**
  * @brief Extract parameters and decide wheather the travel can be elevated.
@@ -4,8 +4,15 @@
 ///|/
 #include "GCodeReader.hpp"
 
-#include <boost/nowide/cstdio.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/log/trivial.hpp>
 #include <fast_float.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <cassert>
@@ -41,7 +48,20 @@ void GCodeReader::apply_config(const DynamicPrintConfig &config)
 const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command)
 {
     assert(is_decimal_separator_point());
-    
+
+    const char *c = this->tokenize_line(ptr, end, gline, command);
+
+    if (gline.has(E) && m_config.use_relative_e_distances)
+        m_position[E] = 0;
+
+    if (m_verbose)
+        std::cout << gline.raw_view() << std::endl;
+
+    return c;
+}
+
+const char* GCodeReader::tokenize_line(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command) const
+{
     // command and args
     const char *c = ptr;
     {
@@ -90,16 +110,14 @@ const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, G
                 c = skip_word(c);
         }
     }
-    
-    if (gline.has(E) && m_config.use_relative_e_distances)
-        m_position[E] = 0;
 
     // Skip the rest of the line.
     for (; ! is_end_of_line(*c); ++ c);
 
-    // Copy the raw string including the comment, without the trailing newlines.
-    if (c > ptr)
-        gline.m_raw.assign(ptr, c);
+    // Reference the raw string including the comment, without the trailing newlines.
+    // It is only copied if the callback asks for GCodeLine::raw().
+    gline.m_raw_view  = std::string_view(ptr, c - ptr);
+    gline.m_raw_owned = false;
 
     // Skip the trailing newlines.
 	if (*c == '\r')
@@ -107,9 +125,6 @@ const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, G
 	if (*c == '\n')
 		++ c;
 
-    if (m_verbose)
-        std::cout << gline.m_raw << std::endl;
-
     return c;
 }
 
@@ -129,62 +144,165 @@ void GCodeReader::update_coordinates(GCodeLine &gline, std::pair<const char*, co
 template<typename ParseLineCallback, typename LineEndCallback>
 bool GCodeReader::parse_file_raw_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
 {
-    FilePtr in{ boost::nowide::fopen(filename.c_str(), "rb") };
-
-    fseek(in.f, 0, SEEK_END);
-    const long file_size = ftell(in.f);
-    rewind(in.f);
+    // Map the whole file into memory and hand the lines to the callback in place, without copying them.
+    // parse_line_internal() expects each line to be terminated by an end of line character, which is true
+    // for all but the last line of a file not ending with a newline. That one is copied into a std::string.
+    boost::iostreams::mapped_file_source file;
+    try {
+        const boost::filesystem::path path(filename);
+        if (boost::filesystem::file_size(path) == 0)
+            // Empty file cannot be memory mapped.
+            return true;
+        file.open(path);
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(error) << "GCodeReader: Failed to map file " << filename << ": " << ex.what();
+        return false;
+    }
 
-    // Read the input stream 64kB at a time, extract lines and process them.
-    std::vector<char> buffer(65536 * 10, 0);
-    // Line buffer.
-    std::string gcode_line;
-    size_t file_pos = 0;
+    const char  *begin     = file.data();
+    const char  *end       = begin + file.size();
+    // Report progress after each 640kB block, like when reading the file through a buffer.
+    const size_t progress_step = 65536 * 10;
+    const char  *next_progress = begin + std::min(progress_step, file.size());
     m_parsing = true;
-    for (;;) {
-        size_t cnt_read = ::fread(buffer.data(), 1, buffer.size(), in.f);
-        if (::ferror(in.f))
-            return false;
-
-        bool eof       = cnt_read == 0;
-        auto it        = buffer.begin();
-        auto it_bufend = buffer.begin() + cnt_read;
-        while (it != it_bufend || (eof && ! gcode_line.empty())) {
-            // Find end of line.
-            bool eol    = false;
-            auto it_end = it;
-            for (; it_end != it_bufend && ! (eol = *it_end == '\r' || *it_end == '\n'); ++ it_end)
-                if (*it_end == '\n')
-                    line_end_callback(file_pos + (it_end - buffer.begin()) + 1);
-            // End of line is indicated also if end of file was reached.
-            eol |= eof && it_end == it_bufend;
-            if (eol) {
-                if (gcode_line.empty())
-                    parse_line_callback(&(*it), &(*it_end));
-                else {
-                    gcode_line.insert(gcode_line.end(), it, it_end);
-                    parse_line_callback(gcode_line.c_str(), gcode_line.c_str() + gcode_line.size());
-                    gcode_line.clear();
-                }
-                if (! m_parsing)
-                    // The callback wishes to exit.
-                    return true;
-            } else
-                gcode_line.insert(gcode_line.end(), it, it_end);
-            // Skip EOL.
-            it = it_end; 
-            if (it != it_bufend && *it == '\r')
+    for (const char *it = begin; it != end;) {
+        // Find end of line.
+        const char *it_end = it;
+        for (; it_end != end && *it_end != '\r' && *it_end != '\n'; ++ it_end) ;
+        if (it_end == end) {
+            const std::string gcode_line(it, it_end);
+            parse_line_callback(gcode_line.c_str(), gcode_line.c_str() + gcode_line.size());
+        } else
+            parse_line_callback(it, it_end);
+        if (! m_parsing)
+            // The callback wishes to exit.
+            return true;
+        // Skip EOL.
+        it = it_end;
+        if (it != end && *it == '\r')
+            ++ it;
+        if (it != end && *it == '\n') {
+            ++ it;
+            line_end_callback(size_t(it - begin));
+        }
+        if (m_progress_callback != nullptr && it >= next_progress) {
+            m_progress_callback(static_cast<float>(it - begin) / static_cast<float>(file.size()));
+            next_progress = it + std::min(progress_step, size_t(end - it));
+        }
+    }
+    return true;
+}
+
+// Parsing of large files is split into chunks of lines, which are tokenized in parallel, while the callback
+// is called for the lines of the previously tokenized chunks in order, from the calling thread.
+// The callback of GCodeProcessor updates the machine state and the print time estimate, which depend on the complete
+// history of the G-code, thus only the tokenization is parallelized, which is independent of the preceding lines.
+template<typename ParseLineCallback, typename LineEndCallback>
+bool GCodeReader::parse_file_parallel_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
+{
+    boost::iostreams::mapped_file_source file;
+    try {
+        file.open(boost::filesystem::path(filename));
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(error) << "GCodeReader: Failed to map file " << filename << ": " << ex.what();
+        return false;
+    }
+
+    const char *begin = file.data();
+    const char *end   = begin + file.size();
+    // The last line not terminated by a newline is copied and parsed separately, as tokenize_line() expects
+    // the line to be followed by an end of line character.
+    const char *tail  = end;
+    for (; tail != begin && tail[-1] != '\r' && tail[-1] != '\n'; -- tail) ;
+
+    // Split the file at line ends.
+    constexpr const size_t   chunk_size = 65536 * 4;
+    std::vector<const char*> chunks;
+    for (const char *it = begin; it != tail;) {
+        chunks.emplace_back(it);
+        it += std::min(chunk_size, size_t(tail - it));
+        if (it != tail) {
+            const char *eol = static_cast<const char*>(memchr(it, '\n', tail - it));
+            it = eol == nullptr ? tail : eol + 1;
+        }
+    }
+    const size_t num_chunks = chunks.size();
+    chunks.emplace_back(tail);
+
+    struct TokenizedLine {
+        GCodeLine                           gline;
+        std::pair<const char*, const char*> command;
+        // Start of the next line.
+        const char                         *next;
+    };
+    auto tokenize_chunk = [this](const char *chunk_begin, const char *chunk_end, std::vector<TokenizedLine> &lines) {
+        lines.clear();
+        for (const char *it = chunk_begin; it != chunk_end;) {
+            // Find end of line, skip EOL the same way parse_file_raw_internal() does.
+            const char    *line_end = it;
+            for (; line_end != chunk_end && *line_end != '\r' && *line_end != '\n'; ++ line_end) ;
+            TokenizedLine &line     = lines.emplace_back();
+            this->tokenize_line(it, line_end, line.gline, line.command);
+            it = line_end;
+            if (it != chunk_end && *it == '\r')
                 ++ it;
-            if (it != it_bufend && *it == '\n') {
-                line_end_callback(file_pos + (it - buffer.begin()) + 1);
+            if (it != chunk_end && *it == '\n')
                 ++ it;
-            }
+            line.next = it;
         }
-        if (eof)
-            break;
-        file_pos += cnt_read;
-        if (m_progress_callback != nullptr)
-            m_progress_callback(static_cast<float>(file_pos) / static_cast<float>(file_size));
+    };
+
+    // Two batches of chunks: one being tokenized in parallel, the other one being processed by the callback.
+    const size_t batch_size = size_t(tbb::this_task_arena::max_concurrency());
+    std::vector<std::vector<TokenizedLine>> batches[2] = { std::vector<std::vector<TokenizedLine>>(batch_size), std::vector<std::vector<TokenizedLine>>(batch_size) };
+    auto tokenize_batch = [&chunks, num_chunks, batch_size, &tokenize_chunk](size_t first_chunk, std::vector<std::vector<TokenizedLine>> &batch) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, std::min(batch_size, num_chunks - first_chunk), 1),
+            [&chunks, first_chunk, &batch, &tokenize_chunk](const tbb::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i < range.end(); ++ i)
+                    tokenize_chunk(chunks[first_chunk + i], chunks[first_chunk + i + 1], batch[i]);
+            });
+    };
+
+    m_parsing = true;
+    tbb::task_group tokenizer;
+    try {
+        tokenize_batch(0, batches[0]);
+        for (size_t first_chunk = 0, ibatch = 0; first_chunk < num_chunks; first_chunk += batch_size, ibatch ^= 1) {
+            const size_t next_chunk = first_chunk + batch_size;
+            if (next_chunk < num_chunks)
+                tokenizer.run([&tokenize_batch, next_chunk, &batch = batches[ibatch ^ 1]]() { tokenize_batch(next_chunk, batch); });
+            for (size_t i = 0; i < std::min(batch_size, num_chunks - first_chunk); ++ i)
+                for (TokenizedLine &line : batches[ibatch][i]) {
+                    // The rest of parse_line_internal() and parse_line().
+                    if (line.gline.has(E) && m_config.use_relative_e_distances)
+                        m_position[E] = 0;
+                    if (m_verbose)
+                        std::cout << line.gline.raw_view() << std::endl;
+                    parse_line_callback(*this, line.gline);
+                    update_coordinates(line.gline, line.command);
+                    if (! m_parsing) {
+                        // The callback wishes to exit.
+                        tokenizer.wait();
+                        return true;
+                    }
+                    if (line.next[-1] == '\n')
+                        line_end_callback(size_t(line.next - begin));
+                }
+            tokenizer.wait();
+            if (m_progress_callback != nullptr)
+                m_progress_callback(static_cast<float>(chunks[std::min(next_chunk, num_chunks)] - begin) / static_cast<float>(file.size()));
+        }
+    } catch (...) {
+        // The callback may throw, for example when canceled. Don't leave the tokenizer running over the data being released.
+        tokenizer.cancel();
+        tokenizer.wait();
+        throw;
+    }
+
+    if (tail != end) {
+        const std::string gcode_line(tail, end);
+        GCodeLine         gline;
+        this->parse_line(gcode_line.c_str(), gcode_line.c_str() + gcode_line.size(), gline, parse_line_callback);
     }
     return true;
 }
@@ -192,6 +310,12 @@ bool GCodeReader::parse_file_raw_internal(const std::string &filename, ParseLine
 template<typename ParseLineCallback, typename LineEndCallback>
 bool GCodeReader::parse_file_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
 {
+    // Parse large files in parallel, if there are threads to do so. Small files are not worth the overhead.
+    boost::system::error_code ec;
+    const uintmax_t file_size = boost::filesystem::file_size(boost::filesystem::path(filename), ec);
+    if (! ec && file_size >= 65536 * 16 && tbb::this_task_arena::max_concurrency() > 1)
+        return this->parse_file_parallel_internal(filename, parse_line_callback, line_end_callback);
+
     GCodeLine gline;    
     return this->parse_file_raw_internal(filename, 
         [this, &gline, parse_line_callback](const char *begin, const char *end) {
@@ -244,13 +368,13 @@ const char* GCodeReader::axis_pos(const char *raw_str, char axis)
 
 bool GCodeReader::GCodeLine::has(char axis) const
 {
-    return GCodeReader::axis_pos(this->raw().c_str(), axis);
+    return GCodeReader::axis_pos(this->raw_view().data(), axis);
 }
 
 std::string_view GCodeReader::GCodeLine::axis_pos(char axis) const
 { 
-    const std::string &s = this->raw();
-    const char *c = GCodeReader::axis_pos(this->raw().c_str(), axis);
+    const std::string_view s = this->raw_view();
+    const char *c = GCodeReader::axis_pos(s.data(), axis);
     return c ? std::string_view{ c, s.size() - (c - s.data()) } : std::string_view();
 }
 
@@ -313,6 +437,8 @@ void GCodeReader::GCodeLine::set(const GCodeReader &reader, const Axis axis, con
         match[1] = reader.extrusion_axis();
     }
 
+    // Make a private copy of the line to be modified.
+    this->raw();
     if (this->has(axis)) {
         size_t pos = m_raw.find(match)+2;
         size_t end = m_raw.find(' ', pos+1);
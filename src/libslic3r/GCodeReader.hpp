@@ -30,15 +30,25 @@ public:
     class GCodeLine {
     public:
         GCodeLine() { reset(); }
-        void reset() { m_mask = 0; memset(m_axis, 0, sizeof(m_axis)); m_raw.clear(); }
-
-        const std::string&      raw() const { return m_raw; }
+        void reset() { m_mask = 0; memset(m_axis, 0, sizeof(m_axis)); m_raw.clear(); m_raw_owned = true; }
+
+        // The raw line is only copied into a std::string when asked for, the parser
+        // references the source buffer (for example a memory mapped file) otherwise.
+        const std::string&      raw() const {
+            if (! m_raw_owned) {
+                m_raw.assign(m_raw_view.data(), m_raw_view.size());
+                m_raw_owned = true;
+            }
+            return m_raw;
+        }
+        // Not zero terminated, though the character following the view is always an end of line character.
+        std::string_view        raw_view() const { return m_raw_owned ? std::string_view(m_raw) : m_raw_view; }
         const std::string_view  cmd() const { 
-            const char *cmd = GCodeReader::skip_whitespaces(m_raw.c_str());
+            const char *cmd = GCodeReader::skip_whitespaces(this->raw_view().data());
             return std::string_view(cmd, GCodeReader::skip_word(cmd) - cmd);
         }
         const std::string_view  comment() const
-            { size_t pos = m_raw.find(';'); return (pos == std::string::npos) ? std::string_view() : std::string_view(m_raw).substr(pos + 1); }
+            { std::string_view raw = this->raw_view(); size_t pos = raw.find(';'); return (pos == std::string_view::npos) ? std::string_view() : raw.substr(pos + 1); }
 
         // Return position in this->raw() string starting with the "axis" character.
         std::string_view axis_pos(char axis) const;
@@ -66,7 +76,7 @@ public:
             float y = this->has(Y) ? (this->y() - reader.y()) : 0;
             return sqrt(x*x + y*y);
         }
-        bool cmd_is(const char *cmd_test)          const { return cmd_is(m_raw, cmd_test); }
+        bool cmd_is(const char *cmd_test)          const { return cmd_is(this->raw_view().data(), cmd_test); }
         bool extruding(const GCodeReader &reader)  const { return this->cmd_is("G1") && this->dist_E(reader) > 0; }
         bool retracting(const GCodeReader &reader) const { return this->cmd_is("G1") && this->dist_E(reader) < 0; }
         bool travel()     const { return this->cmd_is("G1") && ! this->has(E); }
@@ -84,8 +94,9 @@ public:
         float e() const { return m_axis[E]; }
         float f() const { return m_axis[F]; }
 
-        static bool cmd_is(const std::string &gcode_line, const char *cmd_test) {
-            const char *cmd = GCodeReader::skip_whitespaces(gcode_line.c_str());
+        static bool cmd_is(const std::string &gcode_line, const char *cmd_test) { return cmd_is(gcode_line.c_str(), cmd_test); }
+        static bool cmd_is(const char *gcode_line, const char *cmd_test) {
+            const char *cmd = GCodeReader::skip_whitespaces(gcode_line);
             size_t len = strlen(cmd_test); 
             return strncmp(cmd, cmd_test, len) == 0 && GCodeReader::is_end_of_word(cmd[len]);
         }
@@ -102,9 +113,13 @@ public:
         }
 
     private:
-        std::string      m_raw;
-        float            m_axis[NUM_AXES];
-        uint32_t         m_mask;
+        // Valid if m_raw_owned.
+        mutable std::string m_raw;
+        mutable bool        m_raw_owned;
+        // Valid if ! m_raw_owned, references the buffer being parsed.
+        std::string_view    m_raw_view;
+        float               m_axis[NUM_AXES];
+        uint32_t            m_mask;
         friend class GCodeReader;
     };
 
@@ -182,7 +197,12 @@ private:
     template<typename ParseLineCallback, typename LineEndCallback>
     bool        parse_file_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
 
+    template<typename ParseLineCallback, typename LineEndCallback>
+    bool        parse_file_parallel_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
+
     const char* parse_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command);
+    // Part of parse_line_internal() not modifying the state of the reader, thus it may be called from multiple threads.
+    const char* tokenize_line(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command) const;
     void        update_coordinates(GCodeLine &gline, std::pair<const char*, const char*> &command);
 
     static bool         is_whitespace(char c)           { return c == ' ' || c == '\t'; }
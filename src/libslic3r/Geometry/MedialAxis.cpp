@@ -454,14 +454,27 @@ private:
     const Lines &lines;
 };
 
-MedialAxis::MedialAxis(double min_width, double max_width, const ExPolygon &expolygon) :
-    m_expolygon(expolygon), m_lines(expolygon.lines()), m_min_width(min_width), m_max_width(max_width)
-{
-    (void)m_expolygon; // supress unused variable warning
-}
+MedialAxis::MedialAxis(double min_width, double max_width) :
+    m_min_width(min_width), m_max_width(max_width)
+{}
 
-void MedialAxis::build(ThickPolylines* polylines)
+void MedialAxis::build(const ExPolygon &expolygon, ThickPolylines* polylines)
 {
+    // The width of the medial axis is twice the distance of a Voronoi vertex to the boundary,
+    // which is not larger than the smaller size of the bounding box. A region narrower than min_width
+    // everywhere produces no medial axis, skip the Voronoi diagram construction.
+    if (const Point size = get_extents(expolygon.contour).size(); double(std::min(size.x(), size.y())) + SCALED_EPSILON < m_min_width)
+        return;
+
+    m_lines.clear();
+    m_lines.reserve(count_points(expolygon));
+    for (size_t i = 0; i <= expolygon.holes.size(); ++ i) {
+        const Points &pts = (i == 0 ? expolygon.contour : expolygon.holes[i - 1]).points;
+        for (size_t j = 0; j + 1 < pts.size(); ++ j)
+            m_lines.emplace_back(pts[j], pts[j + 1]);
+        m_lines.emplace_back(pts.back(), pts.front());
+    }
+
 #ifndef NDEBUG
     // Verify the scaling of the coordinates of input line segments.
     for (const Line& l : m_lines) {
@@ -475,6 +488,9 @@ void MedialAxis::build(ThickPolylines* polylines)
         test(l.b.y());
     }
 #endif // NDEBUG
+    // The Voronoi diagram does not clear itself when constructed, it accumulates the cells, edges and vertices
+    // of all the constructions. Clearing it keeps the memory allocated for the next expolygon.
+    m_vd.clear();
     m_vd.construct_voronoi(m_lines.begin(), m_lines.end());
 
     // For several ExPolygons in SPE-1729, an invalid Voronoi diagram was produced that wasn't fixable by rotating input data.
@@ -482,7 +498,8 @@ void MedialAxis::build(ThickPolylines* polylines)
     // Those thin lines and holes are both unprintable and cause the Voronoi diagram to be invalid.
     // So we filter out such thin lines and holes and try to compute the Voronoi diagram again.
     if (!m_vd.is_valid()) {
-        m_lines = to_lines(closing_ex({m_expolygon}, float(2. * SCALED_EPSILON)));
+        m_lines = to_lines(closing_ex({expolygon}, float(2. * SCALED_EPSILON)));
+        m_vd.clear();
         m_vd.construct_voronoi(m_lines.begin(), m_lines.end());
 
         if (!m_vd.is_valid())
@@ -571,10 +588,10 @@ void MedialAxis::build(ThickPolylines* polylines)
     #endif /* SLIC3R_DEBUG */
 }
 
-void MedialAxis::build(Polylines* polylines)
+void MedialAxis::build(const ExPolygon &expolygon, Polylines* polylines)
 {
     ThickPolylines tp;
-    this->build(&tp);
+    this->build(expolygon, &tp);
     polylines->reserve(polylines->size() + tp.size());
     for (auto &pl : tp)
         polylines->emplace_back(pl.points);
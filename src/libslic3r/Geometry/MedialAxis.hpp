@@ -19,13 +19,14 @@ namespace Slic3r::Geometry {
 
 class MedialAxis {
 public:
-    MedialAxis(double min_width, double max_width, const ExPolygon &expolygon);
-    void build(ThickPolylines* polylines);
-    void build(Polylines* polylines);
+    MedialAxis(double min_width, double max_width);
+    // A single MedialAxis instance may be used for multiple expolygons, reusing the memory of the Voronoi diagram
+    // and of its annotations, which is significant when processing many small islands.
+    void build(const ExPolygon &expolygon, ThickPolylines* polylines);
+    void build(const ExPolygon &expolygon, Polylines* polylines);
     
 private:
     // Input
-    const ExPolygon     &m_expolygon;
     Lines                m_lines;
     // for filtering of the skeleton edges
     double               m_min_width;
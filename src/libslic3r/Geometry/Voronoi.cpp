@@ -79,10 +79,12 @@ void VoronoiDiagram::clear()
         m_edges.clear();
         m_cells.clear();
         m_is_modified = false;
-    } else {
-        m_voronoi_diagram.clear();
     }
 
+    // The Boost diagram also holds the original (unrepaired) diagram when m_is_modified is set,
+    // and construct_voronoi() appends to it, so it has to be cleared for the diagram to be reused.
+    m_voronoi_diagram.clear();
+
     m_state      = State::UNKNOWN;
     m_issue_type = IssueType::UNKNOWN;
 }
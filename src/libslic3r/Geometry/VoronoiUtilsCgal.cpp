@@ -6,6 +6,7 @@
 #include <CGAL/Arr_segment_traits_2.h>
 #include <CGAL/Surface_sweep_2_algorithms.h>
 #include <boost/variant/get.hpp>
+#include <optional>
 #include <vector>
 #include <cassert>
 
@@ -221,20 +222,25 @@ get_parabolic_segment(const VD::edge_type &edge, const SegmentIterator segment_b
     return {focus_pt, Line(directrix_from, directrix_to), make_linef(edge), focus_side};
 }
 
-template<typename SegmentIterator>
-inline static typename boost::polygon::enable_if<
-    typename boost::polygon::gtl_if<typename boost::polygon::is_segment_concept<
-        typename boost::polygon::geometry_concept<typename std::iterator_traits<SegmentIterator>::value_type>::type>::type>::type,
-    CGAL::Orientation>::type
-orientation_of_two_edges(const VD::edge_type &edge_a, const VD::edge_type &edge_b, const SegmentIterator segment_begin, const SegmentIterator segment_end)
+// Finite Voronoi edge incident to a tested vertex. The parabolic segment of a curved edge is extracted
+// just once per vertex, not for every pair of edges whose orientation is evaluated.
+struct VertexIncidentEdge
+{
+    const VD::edge_type             *edge;
+    std::optional<ParabolicSegment> parabolic;
+};
+
+static CGAL::Orientation orientation_of_two_edges(const VertexIncidentEdge &incident_a, const VertexIncidentEdge &incident_b)
 {
+    const VD::edge_type &edge_a = *incident_a.edge;
+    const VD::edge_type &edge_b = *incident_b.edge;
     assert(is_equal(*edge_a.vertex0(), *edge_b.vertex0()));
     CGAL::Orientation orientation;
     if (edge_a.is_linear() && edge_b.is_linear()) {
         orientation = CGAL::orientation(to_cgal_point(edge_a.vertex0()), to_cgal_point(edge_a.vertex1()), to_cgal_point(edge_b.vertex1()));
     } else if (edge_a.is_curved() && edge_b.is_curved()) {
-        const ParabolicSegment parabolic_a = get_parabolic_segment(edge_a, segment_begin, segment_end);
-        const ParabolicSegment parabolic_b = get_parabolic_segment(edge_b, segment_begin, segment_end);
+        const ParabolicSegment &parabolic_a = *incident_a.parabolic;
+        const ParabolicSegment &parabolic_b = *incident_b.parabolic;
         orientation = ParabolicTangentToParabolicTangentOrientation{}(to_cgal_point(parabolic_a.segment.a),
                                                                       to_cgal_point(parabolic_a.focus),
                                                                       to_cgal_point(parabolic_a.directrix.a),
@@ -248,9 +254,8 @@ orientation_of_two_edges(const VD::edge_type &edge_a, const VD::edge_type &edge_
     } else {
         assert(edge_a.is_curved() != edge_b.is_curved());
 
-        const VD::edge_type   &linear_edge    = edge_a.is_curved() ? edge_b : edge_a;
-        const VD::edge_type   &parabolic_edge = edge_a.is_curved() ? edge_a : edge_b;
-        const ParabolicSegment parabolic      = get_parabolic_segment(parabolic_edge, segment_begin, segment_end);
+        const VD::edge_type    &linear_edge = edge_a.is_curved() ? edge_b : edge_a;
+        const ParabolicSegment &parabolic   = edge_a.is_curved() ? *incident_a.parabolic : *incident_b.parabolic;
         orientation = ParabolicTangentToSegmentOrientation{}(to_cgal_point(parabolic.segment.a), to_cgal_point(linear_edge.vertex1()),
                                                              to_cgal_point(parabolic.focus),
                                                              to_cgal_point(parabolic.directrix.a),
@@ -264,35 +269,26 @@ orientation_of_two_edges(const VD::edge_type &edge_a, const VD::edge_type &edge_
     return orientation;
 }
 
-template<typename SegmentIterator>
-static typename boost::polygon::enable_if<
-    typename boost::polygon::gtl_if<typename boost::polygon::is_segment_concept<
-        typename boost::polygon::geometry_concept<typename std::iterator_traits<SegmentIterator>::value_type>::type>::type>::type,
-    bool>::type
-check_if_three_edges_are_ccw(const VD::edge_type  &edge_first,
-                             const VD::edge_type  &edge_second,
-                             const VD::edge_type  &edge_third,
-                             const SegmentIterator segment_begin,
-                             const SegmentIterator segment_end)
+static bool check_if_three_edges_are_ccw(const VertexIncidentEdge &edge_first, const VertexIncidentEdge &edge_second, const VertexIncidentEdge &edge_third)
 {
-    assert(is_equal(*edge_first.vertex0(), *edge_second.vertex0()) && is_equal(*edge_second.vertex0(), *edge_third.vertex0()));
+    assert(is_equal(*edge_first.edge->vertex0(), *edge_second.edge->vertex0()) && is_equal(*edge_second.edge->vertex0(), *edge_third.edge->vertex0()));
 
-    CGAL::Orientation orientation = orientation_of_two_edges(edge_first, edge_second, segment_begin, segment_end);
+    CGAL::Orientation orientation = orientation_of_two_edges(edge_first, edge_second);
     if (orientation == CGAL::Orientation::COLLINEAR) {
         // The first two edges are collinear, so the third edge must be on the right side on the first of them.
-        return orientation_of_two_edges(edge_first, edge_third, segment_begin, segment_end) == CGAL::Orientation::RIGHT_TURN;
+        return orientation_of_two_edges(edge_first, edge_third) == CGAL::Orientation::RIGHT_TURN;
     } else if (orientation == CGAL::Orientation::LEFT_TURN) {
         // CCW oriented angle between vectors (common_pt, pt1) and (common_pt, pt2) is bellow PI.
         // So we need to check if test_pt isn't between them.
-        CGAL::Orientation orientation1 = orientation_of_two_edges(edge_first, edge_third, segment_begin, segment_end);
-        CGAL::Orientation orientation2 = orientation_of_two_edges(edge_second, edge_third, segment_begin, segment_end);
+        CGAL::Orientation orientation1 = orientation_of_two_edges(edge_first, edge_third);
+        CGAL::Orientation orientation2 = orientation_of_two_edges(edge_second, edge_third);
         return (orientation1 != CGAL::Orientation::LEFT_TURN || orientation2 != CGAL::Orientation::RIGHT_TURN);
     } else {
         assert(orientation == CGAL::Orientation::RIGHT_TURN);
         // CCW oriented angle between vectors (common_pt, pt1) and (common_pt, pt2) is upper PI.
         // So we need to check if test_pt is between them.
-        CGAL::Orientation orientation1 = orientation_of_two_edges(edge_first, edge_third, segment_begin, segment_end);
-        CGAL::Orientation orientation2 = orientation_of_two_edges(edge_second, edge_third, segment_begin, segment_end);
+        CGAL::Orientation orientation1 = orientation_of_two_edges(edge_first, edge_third);
+        CGAL::Orientation orientation2 = orientation_of_two_edges(edge_second, edge_third);
         return (orientation1 == CGAL::Orientation::RIGHT_TURN || orientation2 == CGAL::Orientation::LEFT_TURN);
     }
 }
@@ -306,25 +302,31 @@ VoronoiUtilsCgal::is_voronoi_diagram_planar_angle(const VD             &voronoi_
                                                   const SegmentIterator segment_begin,
                                                   const SegmentIterator segment_end)
 {
+    // Reused for all vertices, most of them have just three incident edges.
+    std::vector<VertexIncidentEdge> edges;
     for (const VD::vertex_type &vertex : voronoi_diagram.vertices()) {
-        std::vector<const VD::edge_type *> edges;
-        const VD::edge_type               *edge = vertex.incident_edge();
+        edges.clear();
+        const VD::edge_type *edge = vertex.incident_edge();
 
         do {
             if (edge->is_finite() && edge->vertex0() != nullptr && edge->vertex1() != nullptr && VoronoiUtils::is_finite(*edge->vertex0()) && VoronoiUtils::is_finite(*edge->vertex1()))
-                edges.emplace_back(edge);
+                edges.push_back({ edge, std::nullopt });
 
             edge = edge->rot_next();
         } while (edge != vertex.incident_edge());
 
         // Checking for CCW make sense for three and more edges.
         if (edges.size() > 2) {
+            for (VertexIncidentEdge &incident_edge : edges)
+                if (incident_edge.edge->is_curved())
+                    incident_edge.parabolic.emplace(get_parabolic_segment(*incident_edge.edge, segment_begin, segment_end));
+
             for (auto edge_it = edges.begin() ; edge_it != edges.end(); ++edge_it) {
-                const VD::edge_type *prev_edge = edge_it == edges.begin() ? edges.back() : *std::prev(edge_it);
-                const VD::edge_type *curr_edge = *edge_it;
-                const VD::edge_type *next_edge = std::next(edge_it) == edges.end() ? edges.front() : *std::next(edge_it);
+                const VertexIncidentEdge &prev_edge = edge_it == edges.begin() ? edges.back() : *std::prev(edge_it);
+                const VertexIncidentEdge &curr_edge = *edge_it;
+                const VertexIncidentEdge &next_edge = std::next(edge_it) == edges.end() ? edges.front() : *std::next(edge_it);
 
-                if (!check_if_three_edges_are_ccw(*prev_edge, *curr_edge, *next_edge, segment_begin, segment_end))
+                if (!check_if_three_edges_are_ccw(prev_edge, curr_edge, next_edge))
                     return false;
             }
         }
@@ -332,5 +334,3 @@ VoronoiUtilsCgal::is_voronoi_diagram_planar_angle(const VD             &voronoi_
 
     return true;
 }
-
-} // namespace Slic3r::Geometry
\ No newline at end of file
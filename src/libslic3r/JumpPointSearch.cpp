@@ -5,6 +5,7 @@
 #include "JumpPointSearch.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
@@ -128,43 +129,51 @@ private:
 public:
     template<class Fn> void foreach_reachable(const Node &from, Fn &&fn) const
     {
-        const CellPositionType       &pos         = from.position;
-        const CellPositionType       &forward_dir = from.incoming_dir;
-        std::vector<CellPositionType> dirs_to_check{};
+        const CellPositionType &pos         = from.position;
+        const CellPositionType &forward_dir = from.incoming_dir;
+        // At most all the 8 directions are checked, don't allocate for each visited node.
+        std::array<CellPositionType, 8> dirs_to_check;
+        size_t                          num_dirs_to_check = 0;
+        auto                            add_dir_to_check  = [&dirs_to_check, &num_dirs_to_check](const CellPositionType &dir) {
+            assert(num_dirs_to_check < dirs_to_check.size());
+            dirs_to_check[num_dirs_to_check ++] = dir;
+        };
 
         if (abs(forward_dir.x()) + abs(forward_dir.y()) == 0) { // special case for starting point
-            dirs_to_check = all_directions;
+            for (const CellPositionType &dir : all_directions)
+                add_dir_to_check(dir);
         } else if (abs(forward_dir.x()) + abs(forward_dir.y()) == 2) {
             // diagonal
             CellPositionType horizontal_check_dir = CellPositionType{forward_dir.x(), 0};
             CellPositionType vertical_check_dir   = CellPositionType{0, forward_dir.y()};
 
             if (!is_passable(pos - horizontal_check_dir) && is_passable(pos + forward_dir - 2 * horizontal_check_dir)) {
-                dirs_to_check.push_back(forward_dir - 2 * horizontal_check_dir);
+                add_dir_to_check(forward_dir - 2 * horizontal_check_dir);
             }
 
             if (!is_passable(pos - vertical_check_dir) && is_passable(pos + forward_dir - 2 * vertical_check_dir)) {
-                dirs_to_check.push_back(forward_dir - 2 * vertical_check_dir);
+                add_dir_to_check(forward_dir - 2 * vertical_check_dir);
             }
 
-            dirs_to_check.push_back(horizontal_check_dir);
-            dirs_to_check.push_back(vertical_check_dir);
-            dirs_to_check.push_back(forward_dir);
+            add_dir_to_check(horizontal_check_dir);
+            add_dir_to_check(vertical_check_dir);
+            add_dir_to_check(forward_dir);
 
         } else { // horizontal or vertical
             CellPositionType side_dir = CellPositionType(forward_dir.y(), forward_dir.x());
 
             if (!is_passable(pos + side_dir) && is_passable(pos + forward_dir + side_dir)) {
-                dirs_to_check.push_back(forward_dir + side_dir);
+                add_dir_to_check(forward_dir + side_dir);
             }
 
             if (!is_passable(pos - side_dir) && is_passable(pos + forward_dir - side_dir)) {
-                dirs_to_check.push_back(forward_dir - side_dir);
+                add_dir_to_check(forward_dir - side_dir);
             }
-            dirs_to_check.push_back(forward_dir);
+            add_dir_to_check(forward_dir);
         }
 
-        for (const CellPositionType &dir : dirs_to_check) {
+        for (size_t i = 0; i < num_dirs_to_check; ++ i) {
+            const CellPositionType &dir = dirs_to_check[i];
             CellPositionType jp = find_jump_point(pos, dir);
             if (jp != pos) fn(Node{jp, dir});
         }
@@ -179,9 +188,37 @@ public:
         return (static_cast<size_t>(uint16_t(n.position.x())) << 16) + static_cast<size_t>(uint16_t(n.position.y()));
     }
 
-    const std::vector<CellPositionType> all_directions{{1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
+    const std::array<CellPositionType, 8> all_directions{{{1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}}};
 };
 
+// Is a pixel inside the search box and not blocked by an obstacle? The start and the end pixels are always passable.
+struct JPSCellQuery
+{
+    const BoundingBox                          &search_box;
+    const Point                                &start;
+    const Point                                &end;
+    const std::unordered_set<Point, PointHash> &inpassable;
+
+    bool operator()(const Point &pixel) const {
+        return search_box.contains(pixel) && (pixel == start || pixel == end || inpassable.find(pixel) == inpassable.end());
+    }
+};
+
+using JPSCellTracer = JPSTracer<Point, JPSCellQuery>;
+
+struct JPSPathFinder::SearchCache
+{
+    // Visited nodes of the last search. Cleared but not deallocated between the searches.
+    std::unordered_map<size_t, astar::QNode<JPSCellTracer>> astar_cache;
+    std::vector<JPSCellTracer::Node>                        out_nodes;
+    std::vector<Pixel, PointsAllocator<Pixel>>              out_path;
+    std::vector<Pixel, PointsAllocator<Pixel>>              tmp_path;
+};
+
+JPSPathFinder::JPSPathFinder() : search_cache(std::make_unique<SearchCache>()) {}
+
+JPSPathFinder::~JPSPathFinder() = default;
+
 void JPSPathFinder::clear()
 {
     inpassable.clear();
@@ -262,16 +299,14 @@ Polyline JPSPathFinder::find_path(const Point &p0, const Point &p1)
     search_box.max = search_box.max.cwiseMin(bounding_square.max);
     search_box.min = search_box.min.cwiseMax(bounding_square.min);
 
-    auto cell_query = [&](Pixel pixel) {
-        return search_box.contains(pixel) && (pixel == start || pixel == end || inpassable.find(pixel) == inpassable.end());
-    };
+    JPSCellTracer tracer(end, JPSCellQuery{search_box, start, end, inpassable});
 
-    JPSTracer<Pixel, decltype(cell_query)> tracer(end, cell_query);
-    using QNode = astar::QNode<JPSTracer<Pixel, decltype(cell_query)>>;
-
-    std::unordered_map<size_t, QNode>   astar_cache{};
-    std::vector<Pixel, PointsAllocator<Pixel>> out_path;
-    std::vector<decltype(tracer)::Node> out_nodes;
+    auto &astar_cache = search_cache->astar_cache;
+    auto &out_path    = search_cache->out_path;
+    auto &out_nodes   = search_cache->out_nodes;
+    astar_cache.clear();
+    out_path.clear();
+    out_nodes.clear();
 
     if (!astar::search_route(tracer, {start, {0, 0}}, std::back_inserter(out_nodes), astar_cache)) {
         // path not found - just reconstruct the best path from astar cache.
@@ -309,7 +344,8 @@ Polyline JPSPathFinder::find_path(const Point &p0, const Point &p1)
     svg.draw(scaled_point(start), "green", scale_(0.4));
 #endif
 
-    std::vector<Pixel, PointsAllocator<Pixel>> tmp_path;
+    auto &tmp_path = search_cache->tmp_path;
+    tmp_path.clear();
     tmp_path.reserve(out_path.size());
     // Some path found, reverse and remove points that do not change direction
     std::reverse(out_path.begin(), out_path.end());
@@ -321,7 +357,7 @@ Polyline JPSPathFinder::find_path(const Point &p0, const Point &p1)
             }
         }
         tmp_path.push_back(out_path.back()); // last_point
-        out_path = tmp_path;
+        out_path.swap(tmp_path);
     }
 
 #ifdef DEBUG_FILES
@@ -352,7 +388,7 @@ Polyline JPSPathFinder::find_path(const Point &p0, const Point &p1)
             }
         }
         tmp_path.push_back(out_path.back()); // last_point
-        out_path = tmp_path;
+        out_path.swap(tmp_path);
     }
 
 #ifdef DEBUG_FILES
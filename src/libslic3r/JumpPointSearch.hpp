@@ -5,6 +5,7 @@
 #ifndef SRC_LIBSLIC3R_JUMPPOINTSEARCH_HPP_
 #define SRC_LIBSLIC3R_JUMPPOINTSEARCH_HPP_
 
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -31,8 +32,13 @@ class JPSPathFinder
     Pixel         pixelize(const Point &p) { return p / resolution; }
     Point         unpixelize(const Pixel &p) { return p * resolution; }
 
+    // Search state of find_path(), kept between the queries so that its memory is reused.
+    struct SearchCache;
+    std::unique_ptr<SearchCache> search_cache;
+
 public:
-    JPSPathFinder() = default;
+    JPSPathFinder();
+    ~JPSPathFinder();
     void     init_bed_shape(const Points &bed_shape) { this->bed_shape = (to_lines(Polygon{bed_shape})); };
     void     clear();
     void     add_obstacles(const Lines &obstacles);
@@ -8,10 +8,14 @@
 #define slic3r_KDTreeIndirect_hpp_
 
 #include <algorithm>
+#include <array>
 #include <limits>
 #include <vector>
 
+#include <oneapi/tbb/parallel_invoke.h>
+
 #include "Utils.hpp" // for next_highest_power_of_2()
+#include "Execution/Execution.hpp"
 
 namespace Slic3r {
 
@@ -83,7 +87,12 @@ public:
     CoordinateFn coordinate;
 
 private:
+    // Subtrees over fewer points are built serially.
+    static constexpr size_t ParallelThreshold = 8192;
+
     // Build a balanced tree by splitting the input sequence by an axis aligned plane at a dimension.
+    // The subtrees of large ranges are built in parallel, they are built over disjoint ranges of the input
+    // into disjoint nodes, thus the tree is the same as if built serially. The coordinate functor is called concurrently.
     void build_recursive(std::vector<size_t> &input, size_t node, const size_t dimension, const size_t left, const size_t right)
     {
         if (left > right)
@@ -106,9 +115,15 @@ private:
         size_t next_dimension = dimension;
         if (++ next_dimension == NumDimensions)
             next_dimension = 0;
-        if (center > left)
-            build_recursive(input, node * 2 + 1, next_dimension, left, center - 1);
-        build_recursive(input, node * 2 + 2, next_dimension, center + 1, right);
+        if (right - left > ParallelThreshold)
+            tbb::parallel_invoke(
+                [this, &input, node, next_dimension, left, center]() { build_recursive(input, node * 2 + 1, next_dimension, left, center - 1); },
+                [this, &input, node, next_dimension, center, right]() { build_recursive(input, node * 2 + 2, next_dimension, center + 1, right); });
+        else {
+            if (center > left)
+                build_recursive(input, node * 2 + 1, next_dimension, left, center - 1);
+            build_recursive(input, node * 2 + 2, next_dimension, center + 1, right);
+        }
     }
 
        // Partition the input m_nodes <left, right> at "k" and "dimension" using the QuickSelect method:
@@ -373,6 +388,64 @@ std::vector<size_t> find_nearby_points(const KDTreeIndirectType &kdtree,
     return visitor.result;
 }
 
+// Batch queries of points of a random access range (std::vector, span), processed by the execution policy
+// in chunks of grainsize points. The results are the same as if the single point queries were called
+// for each point, the filter is called concurrently.
+
+// Closest point to each of the points, npos for points without a point passing the filter.
+template<typename ExecutionPolicy, typename KDTreeIndirectType, typename PointRange, typename FilterFn>
+std::vector<size_t> batch_find_closest_point(ExecutionPolicy &&ex, const KDTreeIndirectType &kdtree, const PointRange &points,
+                                             FilterFn filter, size_t grainsize = 64)
+{
+    std::vector<size_t> out(points.size());
+    execution::for_each(ex, size_t(0), points.size(),
+        [&kdtree, &points, &filter, &out](size_t i) { out[i] = find_closest_point(kdtree, points[i], filter); }, grainsize);
+    return out;
+}
+
+template<typename ExecutionPolicy, typename KDTreeIndirectType, typename PointRange>
+std::vector<size_t> batch_find_closest_point(ExecutionPolicy &&ex, const KDTreeIndirectType &kdtree, const PointRange &points)
+{
+    return batch_find_closest_point(ex, kdtree, points, [](size_t) { return true; });
+}
+
+// K closest points to each of the points sorted by distance, see find_closest_points().
+template<size_t K, typename ExecutionPolicy, typename KDTreeIndirectType, typename PointRange, typename FilterFn>
+std::vector<std::array<size_t, K>> batch_find_closest_points(ExecutionPolicy &&ex, const KDTreeIndirectType &kdtree, const PointRange &points,
+                                                             FilterFn filter, size_t grainsize = 64)
+{
+    std::vector<std::array<size_t, K>> out(points.size());
+    execution::for_each(ex, size_t(0), points.size(),
+        [&kdtree, &points, &filter, &out](size_t i) { out[i] = find_closest_points<K>(kdtree, points[i], filter); }, grainsize);
+    return out;
+}
+
+template<size_t K, typename ExecutionPolicy, typename KDTreeIndirectType, typename PointRange>
+std::vector<std::array<size_t, K>> batch_find_closest_points(ExecutionPolicy &&ex, const KDTreeIndirectType &kdtree, const PointRange &points)
+{
+    return batch_find_closest_points<K>(ex, kdtree, points, [](size_t) { return true; });
+}
+
+// Points in the spherical neighbourhood of each of the centers.
+template<typename ExecutionPolicy, typename KDTreeIndirectType, typename PointRange, typename FilterFn>
+std::vector<std::vector<size_t>> batch_find_nearby_points(ExecutionPolicy &&ex, const KDTreeIndirectType &kdtree, const PointRange &centers,
+                                                          const typename KDTreeIndirectType::CoordType &max_distance,
+                                                          FilterFn filter, size_t grainsize = 64)
+{
+    std::vector<std::vector<size_t>> out(centers.size());
+    execution::for_each(ex, size_t(0), centers.size(),
+        [&kdtree, &centers, &max_distance, &filter, &out](size_t i) { out[i] = find_nearby_points(kdtree, centers[i], max_distance, filter); },
+        grainsize);
+    return out;
+}
+
+template<typename ExecutionPolicy, typename KDTreeIndirectType, typename PointRange>
+std::vector<std::vector<size_t>> batch_find_nearby_points(ExecutionPolicy &&ex, const KDTreeIndirectType &kdtree, const PointRange &centers,
+                                                          const typename KDTreeIndirectType::CoordType &max_distance)
+{
+    return batch_find_nearby_points(ex, kdtree, centers, max_distance, [](size_t) { return true; });
+}
+
 } // namespace Slic3r
 
 #endif /* slic3r_KDTreeIndirect_hpp_ */
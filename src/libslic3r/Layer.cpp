@@ -10,6 +10,7 @@
 ///|/
 #include "Layer.hpp"
 
+#include <boost/functional/hash.hpp>
 #include <boost/log/trivial.hpp>
 #include <clipper/clipper_z.hpp>
 #include <cstdint>
@@ -29,6 +30,7 @@
 #include "libslic3r/ExtrusionEntity.hpp"
 #include "libslic3r/ExtrusionEntityCollection.hpp"
 #include "libslic3r/LayerRegion.hpp"
+#include "libslic3r/MemoryUsage.hpp"
 #include "libslic3r/PrintConfig.hpp"
 #include "libslic3r/Surface.hpp"
 #include "libslic3r/SurfaceCollection.hpp"
@@ -757,6 +759,86 @@ void Layer::make_perimeters()
     BOOST_LOG_TRIVIAL(trace) << "Generating perimeters for layer " << this->id() << " - Done";
 }
 
+size_t Layer::perimeter_inputs_hash() const
+{
+    size_t seed = std::hash<double>{}(this->height);
+    for (const LayerRegion *layerm : m_regions) {
+        boost::hash_combine(seed, &layerm->region());
+        boost::hash_combine(seed, layerm->slices().size());
+        // Contours are enough to tell the layers apart, holes are compared by perimeter_inputs_equal().
+        for (const Surface &surface : layerm->slices()) {
+            boost::hash_combine(seed, surface.expolygon.contour.size());
+            for (const Point &pt : surface.expolygon.contour.points) {
+                boost::hash_combine(seed, pt.x());
+                boost::hash_combine(seed, pt.y());
+            }
+        }
+    }
+    return seed;
+}
+
+static bool region_slices_equal(const Layer &layer1, const Layer &layer2)
+{
+    if (layer1.region_count() != layer2.region_count())
+        return false;
+    for (size_t region_id = 0; region_id < layer1.region_count(); ++ region_id) {
+        const LayerRegion &layerm1 = *layer1.get_region(region_id);
+        const LayerRegion &layerm2 = *layer2.get_region(region_id);
+        if (&layerm1.region() != &layerm2.region() || layerm1.slices().size() != layerm2.slices().size())
+            return false;
+        for (size_t i = 0; i < layerm1.slices().size(); ++ i) {
+            const Surface &surface1 = layerm1.slices().surfaces[i];
+            const Surface &surface2 = layerm2.slices().surfaces[i];
+            if (surface1.surface_type != surface2.surface_type || surface1.extra_perimeters != surface2.extra_perimeters ||
+                ! (surface1.expolygon == surface2.expolygon))
+                return false;
+        }
+    }
+    return true;
+}
+
+bool Layer::perimeter_inputs_equal(const Layer &other) const
+{
+    // The perimeter generator treats the first layer and the raft layers differently.
+    const size_t raft_layers = size_t(m_object->config().raft_layers.value);
+    if (this->height != other.height || (m_id == 0) != (other.m_id == 0) || (m_id > raft_layers) != (other.m_id > raft_layers))
+        return false;
+    if (this->lslices != other.lslices || ! region_slices_equal(*this, other))
+        return false;
+    // Overhangs are detected against the layer below.
+    if ((this->lower_layer == nullptr) != (other.lower_layer == nullptr) ||
+        (this->lower_layer != nullptr && this->lower_layer->lslices != other.lower_layer->lslices))
+        return false;
+    // Top perimeters and the extra perimeters depend on the layer above.
+    if ((this->upper_layer == nullptr) != (other.upper_layer == nullptr) ||
+        (this->upper_layer != nullptr && (this->upper_layer->lslices != other.upper_layer->lslices || ! region_slices_equal(*this->upper_layer, *other.upper_layer))))
+        return false;
+    return true;
+}
+
+void Layer::copy_perimeters(const Layer &src)
+{
+    assert(m_regions.size() == src.m_regions.size());
+    assert(this->lslices_ex.size() == src.lslices_ex.size());
+    for (size_t region_id = 0; region_id < m_regions.size(); ++ region_id) {
+        LayerRegion       &layerm     = *m_regions[region_id];
+        const LayerRegion &src_layerm = *src.m_regions[region_id];
+        layerm.m_perimeters                       = src_layerm.m_perimeters;
+        layerm.m_thin_fills                       = src_layerm.m_thin_fills;
+        layerm.m_fills.clear();
+        layerm.m_fill_expolygons                  = src_layerm.m_fill_expolygons;
+        layerm.m_fill_expolygons_bboxes           = src_layerm.m_fill_expolygons_bboxes;
+        layerm.m_fill_expolygons_composite        = src_layerm.m_fill_expolygons_composite;
+        layerm.m_fill_expolygons_composite_bboxes = src_layerm.m_fill_expolygons_composite_bboxes;
+        assert(layerm.m_slices.size() == src_layerm.m_slices.size());
+        for (size_t i = 0; i < layerm.m_slices.size(); ++ i)
+            layerm.m_slices.surfaces[i].extra_perimeters = src_layerm.m_slices.surfaces[i].extra_perimeters;
+    }
+    // The islands reference the perimeters and the fill expolygons by indices, which are the same.
+    for (size_t lslice_idx = 0; lslice_idx < this->lslices_ex.size(); ++ lslice_idx)
+        this->lslices_ex[lslice_idx].islands = src.lslices_ex[lslice_idx].islands;
+}
+
 void Layer::sort_perimeters_into_islands(
     // Slices for which perimeters and fill_expolygons were just created.
     // The slices may have been created by merging multiple source slices with the same perimeter parameters.
@@ -1154,4 +1236,26 @@ BoundingBox get_extents(const LayerRegionPtrs &layer_regions)
     return bbox;
 }
 
+MemoryUsage Layer::memory_usage() const
+{
+    MemoryUsage out;
+    out.slices = memory_used(this->lslices) + this->lslices_ex.capacity() * sizeof(LayerSlice);
+    for (const LayerSlice &lslice : this->lslices_ex) {
+        if (lslice.islands.capacity() > LayerIslandsStaticSize)
+            out.slices += lslice.islands.capacity() * sizeof(LayerIsland);
+        for (const LayerIsland &island : lslice.islands)
+            out.slices += memory_used(island.boundary);
+    }
+    for (const LayerRegion *layerm : m_regions)
+        out += layerm->memory_usage();
+    return out;
+}
+
+MemoryUsage SupportLayer::memory_usage() const
+{
+    MemoryUsage out = Layer::memory_usage();
+    out.support += memory_used(this->support_islands) + memory_used(this->support_islands_bboxes) + this->support_fills.memory_used();
+    return out;
+}
+
 }
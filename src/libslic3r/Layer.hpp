@@ -221,6 +221,12 @@ public:
         return false;
     }
     void                    make_perimeters();
+    // Layers with equal inputs of make_perimeters() produce equal perimeters, which is common for prismatic objects.
+    // The hash covers the region slices of this layer only, perimeter_inputs_equal() also compares the layers below and above.
+    size_t                  perimeter_inputs_hash() const;
+    bool                    perimeter_inputs_equal(const Layer &other) const;
+    // Copy the result of make_perimeters() from a layer with equal perimeter inputs, including the extra perimeters.
+    void                    copy_perimeters(const Layer &src);
     void                    make_fills(FillAdaptive::Octree     *adaptive_fill_octree,
                                        FillAdaptive::Octree     *support_fill_octree,
                                        FillLightning::Generator *lightning_generator);
@@ -237,6 +243,8 @@ public:
 
     // Is there any valid extrusion assigned to this LayerRegion?
     virtual bool            has_extrusions() const { for (auto layerm : m_regions) if (layerm->has_extrusions()) return true; return false; }
+    // Estimated memory of the data of this Layer including its regions.
+    virtual MemoryUsage     memory_usage() const;
 //    virtual bool            has_extrusions() const { for (const LayerSlice &lslice : lslices_ex) if (lslice.has_extrusions()) return true; return false; }
 
 protected:
@@ -290,6 +298,7 @@ public:
 
     // Is there any valid extrusion assigned to this LayerRegion?
     virtual bool                has_extrusions() const { return ! support_fills.empty(); }
+    MemoryUsage                 memory_usage() const override;
 
     // Zero based index of an interface layer, used for alternating direction of interface / contact layers.
     size_t                      interface_id() const { return m_interface_id; }
@@ -4,6 +4,8 @@
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
 #include <boost/log/trivial.hpp>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <algorithm>
 #include <string>
 #include <map>
@@ -29,6 +31,7 @@
 #include "Algorithm/RegionExpansion.hpp"
 #include "libslic3r/ExtrusionEntity.hpp"
 #include "libslic3r/Line.hpp"
+#include "libslic3r/MemoryUsage.hpp"
 #include "libslic3r/MultiMaterialSegmentation.hpp"
 #include "libslic3r/Point.hpp"
 #include "libslic3r/Polygon.hpp"
@@ -123,43 +126,68 @@ void LayerRegion::make_perimeters(
         region_config,
         this->layer()->object()->config(),
         print_config,
-        spiral_vase
+        spiral_vase,
+        [print = this->layer()->object()->print()]() { if (print->canceled()) throw CanceledException(); }
     );
 
     // Cummulative sum of polygons over all the regions.
     const ExPolygons *lower_slices = this->layer()->lower_layer ? &this->layer()->lower_layer->lslices : nullptr;
     const ExPolygons *upper_slices = this->layer()->upper_layer ? &this->layer()->upper_layer->lslices : nullptr;
-    // Cache for offsetted lower_slices
-    Polygons          lower_layer_polygons_cache;
+    // Cache for offsetted lower_slices, filled before the islands are processed, so that it is only read by them.
+    PerimeterGenerator::LowerSlicesCache lower_layer_polygons_cache;
+    PerimeterGenerator::prepare_lower_slices_cache(params, lower_slices, lower_layer_polygons_cache);
+    const bool arachne = this->layer()->object()->config().perimeter_generator.value == PerimeterGeneratorType::Arachne && !spiral_vase;
+
+    // A layer may consist of many islands, each taking a while to process with Arachne (large first layers, lattices).
+    // Islands are processed in parallel into their own containers, which are then merged in the order of the islands.
+    struct IslandPerimeters {
+        ExtrusionEntityCollection perimeters;
+        ExtrusionEntityCollection gap_fills;
+        ExPolygons                fill_expolygons;
+    };
+    std::vector<IslandPerimeters> islands(slices.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, slices.size()), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t island_idx = range.begin(); island_idx < range.end(); ++ island_idx) {
+            const Surface    &surface = slices.surfaces[island_idx];
+            IslandPerimeters &island  = islands[island_idx];
+            // Lower slices are not grown if there are none. Give each island its own empty cache then, it is never shared for writing.
+            PerimeterGenerator::LowerSlicesCache  empty_lower_layer_polygons_cache;
+            PerimeterGenerator::LowerSlicesCache &lower_slices_cache = lower_layer_polygons_cache.empty() ? empty_lower_layer_polygons_cache : lower_layer_polygons_cache;
+            if (arachne)
+                PerimeterGenerator::process_arachne(
+                    // input:
+                    params,
+                    surface,
+                    lower_slices,
+                    upper_slices,
+                    lower_slices_cache,
+                    // output:
+                    island.perimeters,
+                    island.gap_fills,
+                    island.fill_expolygons);
+            else
+                PerimeterGenerator::process_classic(
+                    // input:
+                    params,
+                    surface,
+                    lower_slices,
+                    upper_slices,
+                    lower_slices_cache,
+                    // output:
+                    island.perimeters,
+                    island.gap_fills,
+                    island.fill_expolygons);
+            params.throw_on_cancel();
+        }
+    });
 
-    for (const Surface &surface : slices) {
+    for (IslandPerimeters &island : islands) {
         auto perimeters_begin      = uint32_t(m_perimeters.size());
         auto gap_fills_begin       = uint32_t(m_thin_fills.size());
         auto fill_expolygons_begin = uint32_t(fill_expolygons.size());
-        if (this->layer()->object()->config().perimeter_generator.value == PerimeterGeneratorType::Arachne && !spiral_vase)
-            PerimeterGenerator::process_arachne(
-                // input:
-                params,
-                surface,
-                lower_slices,
-                upper_slices,
-                lower_layer_polygons_cache,
-                // output:
-                m_perimeters,
-                m_thin_fills,
-                fill_expolygons);
-        else
-            PerimeterGenerator::process_classic(
-                // input:
-                params,
-                surface,
-                lower_slices,
-                upper_slices,
-                lower_layer_polygons_cache,
-                // output:
-                m_perimeters,
-                m_thin_fills,
-                fill_expolygons);
+        m_perimeters.append(std::move(island.perimeters.entities));
+        m_thin_fills.append(std::move(island.gap_fills.entities));
+        append(fill_expolygons, std::move(island.fill_expolygons));
         perimeter_and_gapfill_ranges.emplace_back(
             ExtrusionRange{ perimeters_begin, uint32_t(m_perimeters.size()) }, 
             ExtrusionRange{ gap_fills_begin,  uint32_t(m_thin_fills.size()) });
@@ -980,5 +1008,16 @@ void LayerRegion::export_region_fill_surfaces_to_svg_debug(const char *name) con
     this->export_region_fill_surfaces_to_svg(debug_out_path("LayerRegion-fill_surfaces-%s-%d.svg", name, idx ++).c_str());
 }
 
+MemoryUsage LayerRegion::memory_usage() const
+{
+    MemoryUsage out;
+    out.slices        = memory_used(m_slices);
+    out.fill_surfaces = memory_used(m_fill_surfaces);
+    out.intermediate  = memory_used(m_raw_slices) + memory_used(m_fill_expolygons) + memory_used(m_fill_expolygons_bboxes) +
+        memory_used(m_fill_expolygons_composite) + memory_used(m_fill_expolygons_composite_bboxes) + memory_used(m_unsupported_bridge_edges);
+    out.perimeters    = m_perimeters.memory_used() + m_thin_fills.memory_used();
+    out.fills         = m_fills.memory_used();
+    return out;
+}
+
 }
- 
@@ -25,6 +25,7 @@ namespace Slic3r {
 
 class Layer;
 class PrintObject;
+struct MemoryUsage;
 
 using LayerPtrs = std::vector<Layer*>;
 class PrintRegion;
@@ -142,9 +143,12 @@ public:
 
     // Is there any valid extrusion assigned to this LayerRegion?
     bool    has_extrusions() const { return ! this->perimeters().empty() || ! this->fills().empty(); }
+    // Estimated memory of the data of this LayerRegion.
+    MemoryUsage memory_usage() const;
 
 protected:
     friend class Layer;
+    friend class LayerSpill;
     friend class PrintObject;
 
     LayerRegion(Layer *layer, const PrintRegion *region) : m_layer(layer), m_region(region) {}
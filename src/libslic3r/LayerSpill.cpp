@@ -0,0 +1,297 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#include "LayerSpill.hpp"
+#include "Exception.hpp"
+#include "Layer.hpp"
+#include "MemoryUsage.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/cstdlib.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include <tbb/parallel_for.h>
+
+namespace Slic3r {
+
+namespace {
+
+constexpr const char     s_magic[8] = { 'P', 'S', 'S', 'P', 'I', 'L', 'L', '1' };
+constexpr const uint32_t s_version  = 1;
+
+size_t& memory_budget_storage()
+{
+    static size_t s_budget = []() -> size_t {
+        const char *env = boost::nowide::getenv("SLIC3R_MEMORY_BUDGET");
+        return env == nullptr ? 0 : size_t(std::max(0ll, atoll(env))) * 1024 * 1024;
+    }();
+    return s_budget;
+}
+
+template<typename T> void write_pod(std::vector<char> &out, const T &value)
+{
+    const char *begin = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), begin, begin + sizeof(T));
+}
+
+void write(std::vector<char> &out, const Points &points)
+{
+    write_pod(out, uint32_t(points.size()));
+    const char *begin = reinterpret_cast<const char*>(points.data());
+    out.insert(out.end(), begin, begin + points.size() * sizeof(Point));
+}
+
+void write(std::vector<char> &out, const ExPolygons &expolygons)
+{
+    write_pod(out, uint32_t(expolygons.size()));
+    for (const ExPolygon &expolygon : expolygons) {
+        write(out, expolygon.contour.points);
+        write_pod(out, uint32_t(expolygon.holes.size()));
+        for (const Polygon &hole : expolygon.holes)
+            write(out, hole.points);
+    }
+}
+
+void write(std::vector<char> &out, const BoundingBoxes &bboxes)
+{
+    write_pod(out, uint32_t(bboxes.size()));
+    for (const BoundingBox &bbox : bboxes) {
+        write_pod(out, bbox.min);
+        write_pod(out, bbox.max);
+        write_pod(out, uint8_t(bbox.defined));
+    }
+}
+
+void write(std::vector<char> &out, const Polylines &polylines)
+{
+    write_pod(out, uint32_t(polylines.size()));
+    for (const Polyline &polyline : polylines)
+        write(out, polyline.points);
+}
+
+// Sequential reader over a memory mapped spill file, throws on a truncated file.
+class Reader
+{
+public:
+    Reader(const char *data, size_t size) : m_ptr(data), m_end(data + size) {}
+
+    template<typename T> void read_pod(T &value) {
+        if (size_t(m_end - m_ptr) < sizeof(T))
+            throw Slic3r::RuntimeError("Truncated file");
+        memcpy(&value, m_ptr, sizeof(T));
+        m_ptr += sizeof(T);
+    }
+
+    // Read a count of items, each of them occupying at least min_item_size bytes.
+    uint32_t read_count(size_t min_item_size) {
+        uint32_t count;
+        this->read_pod(count);
+        if (count > size_t(m_end - m_ptr) / min_item_size)
+            throw Slic3r::RuntimeError("Truncated file");
+        return count;
+    }
+
+    void read(Points &points) {
+        points.resize(this->read_count(sizeof(Point)));
+        memcpy(points.data(), m_ptr, points.size() * sizeof(Point));
+        m_ptr += points.size() * sizeof(Point);
+    }
+
+    void read(ExPolygons &expolygons) {
+        expolygons.assign(this->read_count(8), ExPolygon());
+        for (ExPolygon &expolygon : expolygons) {
+            this->read(expolygon.contour.points);
+            expolygon.holes.assign(this->read_count(4), Polygon());
+            for (Polygon &hole : expolygon.holes)
+                this->read(hole.points);
+        }
+    }
+
+    void read(BoundingBoxes &bboxes) {
+        bboxes.assign(this->read_count(2 * sizeof(Point) + 1), BoundingBox());
+        for (BoundingBox &bbox : bboxes) {
+            uint8_t defined;
+            this->read_pod(bbox.min);
+            this->read_pod(bbox.max);
+            this->read_pod(defined);
+            bbox.defined = defined != 0;
+        }
+    }
+
+    void read(Polylines &polylines) {
+        polylines.assign(this->read_count(4), Polyline());
+        for (Polyline &polyline : polylines)
+            this->read(polyline.points);
+    }
+
+    bool at_end() const { return m_ptr == m_end; }
+
+private:
+    const char *m_ptr;
+    const char *m_end;
+};
+
+template<typename T> void release(T &data) { T().swap(data); }
+
+} // namespace
+
+void LayerSpill::set_memory_budget(size_t bytes)
+{
+    memory_budget_storage() = bytes;
+}
+
+size_t LayerSpill::memory_budget()
+{
+    return memory_budget_storage();
+}
+
+size_t LayerSpill::layers_memory(const PrintObject &print_object)
+{
+    size_t out = 0;
+    for (const Layer *layer : print_object.layers()) {
+        MemoryUsage usage = layer->memory_usage();
+        out += usage.slices + usage.fill_surfaces + usage.intermediate;
+    }
+    return out;
+}
+
+size_t LayerSpill::spillable_memory(const PrintObject &print_object)
+{
+    size_t out = 0;
+    for (const Layer *layer : print_object.layers())
+        for (const LayerRegion *layerm : layer->regions())
+            out += layerm->memory_usage().intermediate;
+    return out;
+}
+
+void LayerSpill::spill_over_budget(const PrintObjectPtrs &print_objects)
+{
+    if (! enabled())
+        return;
+
+    size_t total = 0;
+    std::vector<std::pair<size_t, PrintObject*>> candidates;
+    for (PrintObject *print_object : print_objects) {
+        total += layers_memory(*print_object);
+        if (print_object->m_layer_spill_path.empty())
+            if (size_t spillable = spillable_memory(*print_object); spillable > 0)
+                candidates.emplace_back(spillable, print_object);
+    }
+    if (total <= memory_budget())
+        return;
+
+    std::sort(candidates.begin(), candidates.end(), [](const auto &l, const auto &r) { return l.first > r.first; });
+    size_t num_spilled = 0;
+    for (size_t spilled = 0; num_spilled < candidates.size() && total - spilled > memory_budget(); ++ num_spilled)
+        spilled += candidates[num_spilled].first;
+    BOOST_LOG_TRIVIAL(info) << "Layer spill: Estimated layer data memory " << total / (1024 * 1024) << "MB exceeds the budget of " <<
+        memory_budget() / (1024 * 1024) << "MB, spilling " << num_spilled << " objects";
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_spilled, 1), [&candidates](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+            candidates[i].second->m_layer_spill_path = spill(*candidates[i].second);
+    });
+}
+
+std::string LayerSpill::spill(PrintObject &print_object)
+{
+    boost::system::error_code     ec;
+    const boost::filesystem::path path = boost::filesystem::temp_directory_path(ec) / boost::filesystem::unique_path("prusaslicer-%%%%-%%%%-%%%%-%%%%.spill");
+    if (ec) {
+        BOOST_LOG_TRIVIAL(error) << "Layer spill: Failed to get the temporary directory: " << ec.message();
+        return {};
+    }
+
+    // Write layer by layer to keep the serialization buffer small.
+    {
+        boost::nowide::ofstream file(path.string(), std::ios::binary | std::ios::trunc);
+        std::vector<char>       data;
+        write_pod(data, s_magic);
+        write_pod(data, s_version);
+        write_pod(data, uint32_t(print_object.layers().size()));
+        for (const Layer *layer : print_object.layers()) {
+            write_pod(data, uint32_t(layer->regions().size()));
+            for (const LayerRegion *layerm : layer->regions()) {
+                write(data, layerm->m_raw_slices);
+                write(data, layerm->m_fill_expolygons);
+                write(data, layerm->m_fill_expolygons_bboxes);
+                write(data, layerm->m_fill_expolygons_composite);
+                write(data, layerm->m_fill_expolygons_composite_bboxes);
+                write(data, layerm->m_unsupported_bridge_edges);
+            }
+            file.write(data.data(), std::streamsize(data.size()));
+            data.clear();
+        }
+        if (! file.good()) {
+            BOOST_LOG_TRIVIAL(error) << "Layer spill: Failed to write " << path.string();
+            file.close();
+            boost::filesystem::remove(path, ec);
+            return {};
+        }
+    }
+
+    for (Layer *layer : print_object.layers())
+        for (LayerRegion *layerm : layer->regions()) {
+            release(layerm->m_raw_slices);
+            release(layerm->m_fill_expolygons);
+            release(layerm->m_fill_expolygons_bboxes);
+            release(layerm->m_fill_expolygons_composite);
+            release(layerm->m_fill_expolygons_composite_bboxes);
+            release(layerm->m_unsupported_bridge_edges);
+        }
+    BOOST_LOG_TRIVIAL(debug) << "Layer spill: Spilled " << print_object.model_object()->name << " to " << path.string();
+    return path.string();
+}
+
+void LayerSpill::restore(PrintObject &print_object, const std::string &path)
+{
+    try {
+        {
+            boost::iostreams::mapped_file_source file(path);
+            Reader   reader(file.data(), file.size());
+            char     magic[sizeof(s_magic)];
+            uint32_t version;
+            reader.read_pod(magic);
+            reader.read_pod(version);
+            if (memcmp(magic, s_magic, sizeof(s_magic)) != 0 || version != s_version)
+                throw Slic3r::RuntimeError("Invalid header");
+            if (reader.read_count(4) != print_object.layers().size())
+                throw Slic3r::RuntimeError("Layers do not match");
+            for (Layer *layer : print_object.layers()) {
+                if (reader.read_count(4) != layer->regions().size())
+                    throw Slic3r::RuntimeError("Layer regions do not match");
+                for (LayerRegion *layerm : layer->regions()) {
+                    reader.read(layerm->m_raw_slices);
+                    reader.read(layerm->m_fill_expolygons);
+                    reader.read(layerm->m_fill_expolygons_bboxes);
+                    reader.read(layerm->m_fill_expolygons_composite);
+                    reader.read(layerm->m_fill_expolygons_composite_bboxes);
+                    reader.read(layerm->m_unsupported_bridge_edges);
+                }
+            }
+            if (! reader.at_end())
+                throw Slic3r::RuntimeError("Trailing data");
+        }
+        discard(path);
+    } catch (const std::exception &ex) {
+        discard(path);
+        throw Slic3r::RuntimeError(std::string("Failed to reload the spilled layer data from ") + path + ": " + ex.what());
+    }
+    BOOST_LOG_TRIVIAL(debug) << "Layer spill: Restored " << print_object.model_object()->name << " from " << path;
+}
+
+void LayerSpill::discard(const std::string &path)
+{
+    boost::system::error_code ec;
+    boost::filesystem::remove(path, ec);
+}
+
+} // namespace Slic3r
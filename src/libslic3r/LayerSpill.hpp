@@ -0,0 +1,53 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef libslic3r_LayerSpill_hpp_
+#define libslic3r_LayerSpill_hpp_
+
+#include <cstddef>
+#include <string>
+
+#include "Print.hpp"
+
+namespace Slic3r {
+
+// Memory budget of the layer data of the PrintObjects with spilling of the intermediate layer data to disk.
+// Once all PrintObject steps are finished, the data produced by the PrintObject steps for the consumption
+// by the following PrintObject steps only (the raw slices, the fill expolygons and the unsupported bridge edges
+// of the LayerRegions) is not needed by the G-code export. If the estimated memory of the layer data exceeds
+// the budget, this intermediate data is written into a temporary file and released. It is reloaded from
+// the memory mapped file only if some of the PrintObject steps are invalidated and executed again
+// on the same layers, see PrintObject::restore_spilled_layers().
+//
+// The budget is disabled by default. It is enabled by the --memory-budget command line option
+// or by the SLIC3R_MEMORY_BUDGET environment variable, both in megabytes.
+class LayerSpill
+{
+public:
+    // Zero disables spilling. Not thread safe, to be called before slicing is started.
+    static void        set_memory_budget(size_t bytes);
+    static size_t      memory_budget();
+    static bool        enabled() { return memory_budget() > 0; }
+
+    // Estimated memory of the geometry of the layers and layer regions of a PrintObject, extrusions excluded.
+    static size_t      layers_memory(const PrintObject &print_object);
+    // Estimated memory of the layer data, which may be spilled.
+    static size_t      spillable_memory(const PrintObject &print_object);
+
+    // Spill the objects with the most spillable memory first until the estimated memory of all objects fits the budget.
+    static void        spill_over_budget(const PrintObjectPtrs &print_objects);
+
+    // Write the intermediate layer data of print_object into a temporary file and release it.
+    // Returns the path of the file, an empty string if the file could not be written. The data is kept in that case.
+    static std::string spill(PrintObject &print_object);
+    // Reload the data written by spill() from path into print_object and delete the file.
+    // The layers and their regions must not have been changed since spill(), throws Slic3r::RuntimeError otherwise.
+    static void        restore(PrintObject &print_object, const std::string &path);
+    // Delete the file written by spill() if the layers were released.
+    static void        discard(const std::string &path);
+};
+
+} // namespace Slic3r
+
+#endif // libslic3r_LayerSpill_hpp_
@@ -345,12 +345,49 @@ public:
     // Go through the cells and mark them with the appropriate tag.
     template<class ExecutionPolicy>
     void tag_grid(ExecutionPolicy &&policy, TRasterValue<Rst> isoval)
-    {        
-        // parallel for r
+    {
+        if (m_window.r != m_res_1.r || m_window.c != m_res_1.c) {
+            // The squares of neighbor cells don't share their vertices.
+            // parallel for r
+            for_each (std::forward<ExecutionPolicy>(policy),
+                     m_tags.begin(), m_tags.end(),
+                     [this, isoval](uint8_t& tag, size_t idx) {
+                tag = get_tag_for_cell(coord(idx), isoval);
+            });
+            return;
+        }
+
+        // With an overlap of one pixel, the squares of neighbor cells share
+        // their vertices, which form a lattice with the spacing of m_window.
+        // Sample each vertex of the lattice once instead of once per each of
+        // the four cells touching it. Vertex (i, j) is the top left vertex
+        // of cell (i, j), vertices outside of the raster are not inside.
+        const long R = rows(*m_rst), C = cols(*m_rst);
+        const long vcols = m_gridsize.c + 1;
+        std::vector<uint8_t> vertices((m_gridsize.r + 1) * vcols, 0);
+        std::vector<long>    lattice_rows(m_gridsize.r + 1);
+        for (long i = 0; i <= m_gridsize.r; ++i) lattice_rows[i] = i;
+
+        for_each (std::forward<ExecutionPolicy>(policy),
+                 lattice_rows.begin(), lattice_rows.end(),
+                 [this, isoval, R, C, vcols, &vertices](long i, size_t) {
+            const long r = (i - 1) * m_window.r;
+            if (r < 0 || r >= R) return;
+            uint8_t *row = vertices.data() + i * vcols;
+            for (long j = 1, c = 0; j < vcols && c < C; ++j, c += m_window.c)
+                row[j] = RasterTraits<Rst>::get(*m_rst, r, c) >= isoval;
+        });
+
+        lattice_rows.pop_back();
         for_each (std::forward<ExecutionPolicy>(policy),
-                 m_tags.begin(), m_tags.end(),
-                 [this, isoval](uint8_t& tag, size_t idx) {
-            tag = get_tag_for_cell(coord(idx), isoval);
+                 lattice_rows.begin(), lattice_rows.end(),
+                 [this, vcols, &vertices](long r, size_t) {
+            const uint8_t *top    = vertices.data() + r * vcols;
+            const uint8_t *bottom = top + vcols;
+            uint8_t       *tags   = m_tags.data() + r * m_gridsize.c;
+            // Same bit order as get_tag_for_cell(): bl, br, tr, tl
+            for (long c = 0; c < m_gridsize.c; ++c)
+                tags[c] = uint8_t(bottom[c] | (bottom[c + 1] << 1) | (top[c + 1] << 2) | (top[c] << 3));
         });
     }
     
@@ -14,6 +14,7 @@
 
 #include "libslic3r/libslic3r.h"
 #include "Measure.hpp"
+#include "AABBTreeIndirect.hpp"
 #include "MeasureUtils.hpp"
 #include "libslic3r/Geometry/Circle.hpp"
 #include "libslic3r/SurfaceMesh.hpp"
@@ -76,6 +77,8 @@ public:
         std::vector<int> facets;
         std::vector<std::vector<Vec3d>> borders; // FIXME: should be in fact local in update_planes()
         std::vector<SurfaceFeature> surface_features;
+        // Bounding boxes of surface_features (without the plane itself) inflated by feature_hover_limit.
+        AABBTreeIndirect::Tree<3, double> features_tree;
         Vec3d normal;
         float area;
         bool features_extracted = false;
@@ -514,6 +517,39 @@ void MeasuringImpl::extract_features(int plane_idx)
     plane.borders.clear();
     plane.borders.shrink_to_fit();
 
+    // Build a tree over the features to quickly find the ones close to the mouse cursor.
+    using TreeType = AABBTreeIndirect::Tree<3, double>;
+    struct FeatureNode {
+        size_t                       idx()      const { return m_idx; }
+        const TreeType::BoundingBox& bbox()     const { return m_bbox; }
+        const Vec3d&                 centroid() const { return m_centroid; }
+
+        size_t                m_idx;
+        TreeType::BoundingBox m_bbox;
+        Vec3d                 m_centroid;
+    };
+    std::vector<FeatureNode> nodes;
+    nodes.reserve(plane.surface_features.size() - 1);
+    const Vec3d limit = Vec3d(feature_hover_limit, feature_hover_limit, feature_hover_limit);
+    for (size_t i = 0; i + 1 < plane.surface_features.size(); ++i) {
+        const SurfaceFeature& f = plane.surface_features[i];
+        TreeType::BoundingBox bbox;
+        if (f.get_type() == SurfaceFeatureType::Edge) {
+            const auto& [sp, ep] = f.get_edge();
+            bbox = TreeType::BoundingBox(sp, sp);
+            bbox.extend(ep);
+        } else {
+            assert(f.get_type() == SurfaceFeatureType::Circle);
+            const auto& [center, radius, n] = f.get_circle();
+            const Vec3d r = Vec3d(radius, radius, radius);
+            bbox = TreeType::BoundingBox(center - r, center + r);
+        }
+        bbox.min() -= limit;
+        bbox.max() += limit;
+        nodes.push_back({ i, bbox, bbox.center() });
+    }
+    plane.features_tree.build(std::move(nodes));
+
     plane.features_extracted = true;
 }
 
@@ -542,9 +578,14 @@ std::optional<SurfaceFeature> MeasuringImpl::get_feature(size_t face_idx, const
 
     assert(plane.surface_features.empty() || plane.surface_features.back().get_type() == SurfaceFeatureType::Plane);
 
-    for (size_t i=0; i<plane.surface_features.size() - 1; ++i) {
-        // The -1 is there to prevent measuring distance to the plane itself,
-        // which is needless and relatively expensive.
+    // Only features with the inflated bounding box containing the point may be closer than feature_hover_limit.
+    // The plane itself is not in the tree, measuring distance to it is needless and relatively expensive.
+    std::vector<size_t> candidates;
+    AABBTreeIndirect::get_candidate_idxs(plane.features_tree, point, candidates);
+    // Keep the order of features, so that the first one of equally distant features is picked.
+    std::sort(candidates.begin(), candidates.end());
+
+    for (size_t i : candidates) {
         res = get_measurement(plane.surface_features[i], point_sf);
         if (res.distance_strict) { // TODO: this should become an assert after all combinations are implemented.
             double dist = res.distance_strict->dist;
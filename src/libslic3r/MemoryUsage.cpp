@@ -0,0 +1,161 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#include "MemoryUsage.hpp"
+#include "Utils/JsonUtils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/cstdlib.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+namespace Slic3r {
+
+#ifdef SLIC3R_ALLOCATION_PROFILING
+namespace {
+// Relaxed atomics are good enough for counting, the counters are only sampled at the PrintObject step boundaries.
+std::atomic<size_t> g_allocation_count { 0 };
+std::atomic<size_t> g_allocation_bytes { 0 };
+
+inline void count_allocation(std::size_t size)
+{
+    g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    g_allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+} // namespace
+#endif // SLIC3R_ALLOCATION_PROFILING
+
+AllocationCounters AllocationCounters::now()
+{
+#ifdef SLIC3R_ALLOCATION_PROFILING
+    return { g_allocation_count.load(std::memory_order_relaxed), g_allocation_bytes.load(std::memory_order_relaxed) };
+#else
+    return {};
+#endif
+}
+
+MemoryUsage& MemoryUsage::operator+=(const MemoryUsage &rhs)
+{
+    slices        += rhs.slices;
+    fill_surfaces += rhs.fill_surfaces;
+    intermediate  += rhs.intermediate;
+    perimeters    += rhs.perimeters;
+    fills         += rhs.fills;
+    support       += rhs.support;
+    return *this;
+}
+
+namespace MemoryAccounting {
+
+namespace {
+
+bool& enabled_storage()
+{
+    static bool s_enabled = []() {
+        const char *env = boost::nowide::getenv("SLIC3R_MEMORY_REPORT");
+        return env != nullptr && atoi(env) != 0;
+    }();
+    return s_enabled;
+}
+
+} // namespace
+
+bool enabled()
+{
+    return enabled_storage();
+}
+
+void enable(bool enable)
+{
+    enabled_storage() = enable;
+}
+
+std::string to_json(const std::vector<MemoryUsageRecord> &records)
+{
+    namespace pt = boost::property_tree;
+    pt::ptree array;
+    for (const MemoryUsageRecord &record : records) {
+        pt::ptree node;
+        node.put("object", record.object_name);
+        node.put("object_id", record.object_id);
+        node.put("step", record.step_name);
+        node.put("slices", record.usage.slices);
+        node.put("fill_surfaces", record.usage.fill_surfaces);
+        node.put("intermediate", record.usage.intermediate);
+        node.put("perimeters", record.usage.perimeters);
+        node.put("fills", record.usage.fills);
+        node.put("support", record.usage.support);
+        node.put("total", record.usage.total());
+        if (AllocationCounters::enabled()) {
+            node.put("allocations", record.allocations.count);
+            node.put("allocated_bytes", record.allocations.bytes);
+        }
+        array.push_back(std::make_pair(std::string(), std::move(node)));
+    }
+    pt::ptree root;
+    root.add_child("memory_usage", array);
+    return write_json_with_post_process(root);
+}
+
+bool save(const std::string &path, const std::vector<MemoryUsageRecord> &records)
+{
+    boost::nowide::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << to_json(records);
+    if (! file.good()) {
+        BOOST_LOG_TRIVIAL(error) << "Failed to write the memory report " << path;
+        return false;
+    }
+    return true;
+}
+
+} // namespace MemoryAccounting
+
+} // namespace Slic3r
+
+#ifdef SLIC3R_ALLOCATION_PROFILING
+// Replacements of the global operator new / delete counting the allocations. The array, nothrow and sized variants
+// of the standard library forward to these. The memory is allocated by malloc(), which may be overridden by the allocator
+// selected with SLIC3R_ALLOCATOR.
+void* operator new(std::size_t size)
+{
+    Slic3r::count_allocation(size);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size); ptr != nullptr)
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    Slic3r::count_allocation(size);
+    const auto align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+#ifdef _WIN32
+    void *ptr = _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    // aligned_alloc() requires the size to be a multiple of the alignment.
+    void *ptr = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align);
+#endif
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+#endif // SLIC3R_ALLOCATION_PROFILING
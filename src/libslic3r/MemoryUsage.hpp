@@ -0,0 +1,129 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef libslic3r_MemoryUsage_hpp_
+#define libslic3r_MemoryUsage_hpp_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "ExPolygon.hpp"
+#include "Polyline.hpp"
+#include "SurfaceCollection.hpp"
+
+namespace Slic3r {
+
+// Heap memory owned by a geometry container in bytes, the container object itself excluded.
+// Allocator overhead is not accounted for, the values are estimates.
+template<typename T>
+inline size_t memory_used(const std::vector<T> &pods) { return pods.capacity() * sizeof(T); }
+inline size_t memory_used(const MultiPoint &mp) { return mp.points.capacity() * sizeof(Point); }
+inline size_t memory_used(const ExPolygon &expolygon)
+{
+    size_t out = memory_used(expolygon.contour) + expolygon.holes.capacity() * sizeof(Polygon);
+    for (const Polygon &hole : expolygon.holes)
+        out += memory_used(hole);
+    return out;
+}
+inline size_t memory_used(const Polygons &polygons)
+{
+    size_t out = polygons.capacity() * sizeof(Polygon);
+    for (const Polygon &polygon : polygons)
+        out += memory_used(polygon);
+    return out;
+}
+inline size_t memory_used(const Polylines &polylines)
+{
+    size_t out = polylines.capacity() * sizeof(Polyline);
+    for (const Polyline &polyline : polylines)
+        out += memory_used(polyline);
+    return out;
+}
+inline size_t memory_used(const ExPolygons &expolygons)
+{
+    size_t out = expolygons.capacity() * sizeof(ExPolygon);
+    for (const ExPolygon &expolygon : expolygons)
+        out += memory_used(expolygon);
+    return out;
+}
+inline size_t memory_used(const SurfaceCollection &surfaces)
+{
+    size_t out = surfaces.surfaces.capacity() * sizeof(Surface);
+    for (const Surface &surface : surfaces)
+        out += memory_used(surface.expolygon);
+    return out;
+}
+
+// Estimated memory of the layer data of a PrintObject in bytes, broken down by the kind of the data.
+// Filled in by LayerRegion::memory_usage(), Layer::memory_usage(), SupportLayer::memory_usage() and PrintObject::memory_usage().
+struct MemoryUsage
+{
+    // LayerRegion::slices(), Layer::lslices and Layer::lslices_ex.
+    size_t slices        { 0 };
+    // LayerRegion::fill_surfaces().
+    size_t fill_surfaces { 0 };
+    // Data passed between the PrintObject steps only: the raw slices, the fill expolygons
+    // and the unsupported bridge edges of the LayerRegions, see LayerSpill.
+    size_t intermediate  { 0 };
+    // LayerRegion::perimeters() and LayerRegion::thin_fills().
+    size_t perimeters    { 0 };
+    // LayerRegion::fills().
+    size_t fills         { 0 };
+    // Support layers: support islands and support extrusions.
+    size_t support       { 0 };
+
+    size_t       total() const { return slices + fill_surfaces + intermediate + perimeters + fills + support; }
+    MemoryUsage& operator+=(const MemoryUsage &rhs);
+};
+
+// Number and total size of the heap allocations done through the global operator new by all the threads.
+// The allocations are only counted if compiled with SLIC3R_ALLOCATION_PROFILING, otherwise the counters stay zero.
+struct AllocationCounters
+{
+    size_t count { 0 };
+    size_t bytes { 0 };
+
+    // Counters since the start of the process.
+    static AllocationCounters now();
+    static constexpr bool     enabled() {
+#ifdef SLIC3R_ALLOCATION_PROFILING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    AllocationCounters operator-(const AllocationCounters &rhs) const { return { count - rhs.count, bytes - rhs.bytes }; }
+};
+
+// Memory usage of a single PrintObject sampled once a PrintObject step finished.
+struct MemoryUsageRecord
+{
+    // ObjectID of the PrintObject.
+    size_t      object_id;
+    std::string object_name;
+    std::string step_name;
+    MemoryUsage usage;
+    // Allocations done by the step. The PrintObject steps of a Print are not executed concurrently,
+    // thus the allocations over the duration of a step are attributed to that step.
+    AllocationCounters allocations;
+};
+
+// Sampling of the memory usage after each PrintObject step traverses all the layer data, thus it is disabled by default.
+// It is enabled by the --memory-report command line option or by the SLIC3R_MEMORY_REPORT environment variable
+// set to a non-zero value (also for the GUI).
+namespace MemoryAccounting {
+    bool        enabled();
+    // Not thread safe, to be called before slicing is started.
+    void        enable(bool enable);
+    // JSON array of the records with the individual counters and their total in bytes.
+    std::string to_json(const std::vector<MemoryUsageRecord> &records);
+    // Save the records into a JSON file, returns false if the file could not be written.
+    bool        save(const std::string &path, const std::vector<MemoryUsageRecord> &records);
+} // namespace MemoryAccounting
+
+} // namespace Slic3r
+
+#endif // libslic3r_MemoryUsage_hpp_
@@ -7,6 +7,9 @@
 
 #include "TriangleMesh.hpp"
 #include "Execution/ExecutionTBB.hpp"
+#include "Execution/ExecutionSeq.hpp"
+
+#include <atomic>
 
 namespace Slic3r {
 
@@ -92,6 +95,112 @@ private:
     size_t                       m_seed { 0 };
 };
 
+// Lock free union-find (disjoint set) of mesh faces, two faces belong to the same patch if they share an edge.
+// A higher root is always linked below a lower root, thus the representative of each patch is its lowest face index
+// and the patches are enumerated in the order of their first face, which is the order NeighborVisitor discovers them in.
+class FacePatchUnionFind {
+public:
+    template<class ExPolicy, class NeighborIndex>
+    FacePatchUnionFind(ExPolicy &&ex, const NeighborIndex &neighbor_index, size_t num_faces) : m_parent(num_faces)
+    {
+        execution::for_each(ex, size_t(0), num_faces,
+            [this](size_t face_idx) { m_parent[face_idx].store(int(face_idx), std::memory_order_relaxed); },
+            granularity);
+        execution::for_each(ex, size_t(0), num_faces,
+            [this, &neighbor_index](size_t face_idx) {
+                for (auto neighbor_idx : neighbor_index[face_idx]) {
+                    assert(neighbor_idx < int(m_parent.size()));
+                    // Each shared edge is seen from both of its faces, unite from the lower face only.
+                    if (neighbor_idx > int(face_idx))
+                        this->unite(int(face_idx), int(neighbor_idx));
+                }
+            }, granularity);
+    }
+
+    // Only to be called after construction, when no unite() is running anymore.
+    int find(int face_idx) const
+    {
+        for (;;) {
+            int parent = m_parent[face_idx].load(std::memory_order_relaxed);
+            if (parent == face_idx)
+                return face_idx;
+            face_idx = parent;
+        }
+    }
+
+    // Label each face with the index of its patch. Returns the number of patches.
+    template<class ExPolicy>
+    size_t label(ExPolicy &&ex, std::vector<int> &face_patch) const
+    {
+        face_patch.assign(m_parent.size(), 0);
+        execution::for_each(ex, size_t(0), m_parent.size(),
+            [this, &face_patch](size_t face_idx) { face_patch[face_idx] = this->find(int(face_idx)); },
+            granularity);
+        // Enumerate the roots. A root is lower than all faces of its patch, thus its patch index is known before
+        // the other faces of its patch are visited.
+        int num_patches = 0;
+        for (size_t face_idx = 0; face_idx < face_patch.size(); ++ face_idx)
+            face_patch[face_idx] = face_patch[face_idx] == int(face_idx) ? num_patches ++ : face_patch[face_patch[face_idx]];
+        return size_t(num_patches);
+    }
+
+    bool has_multiple_patches() const
+    {
+        // Face zero is the root of its patch, a face with another root belongs to another patch.
+        for (size_t face_idx = 1; face_idx < m_parent.size(); ++ face_idx)
+            if (this->find(int(face_idx)) != 0)
+                return true;
+        return false;
+    }
+
+    // Meshes below this size are processed on the calling thread, the synchronization would cost more than it saves.
+    static constexpr size_t parallel_threshold = 50000;
+    static constexpr size_t granularity        = 4096;
+
+private:
+    int find_and_halve(int face_idx)
+    {
+        for (;;) {
+            int parent = m_parent[face_idx].load(std::memory_order_relaxed);
+            if (parent == face_idx)
+                return face_idx;
+            int grandparent = m_parent[parent].load(std::memory_order_relaxed);
+            if (grandparent != parent)
+                // Path halving. Parents only ever decrease, a failure means another thread shortened the path already.
+                m_parent[face_idx].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+            face_idx = grandparent;
+        }
+    }
+
+    void unite(int a, int b)
+    {
+        for (;;) {
+            a = this->find_and_halve(a);
+            b = this->find_and_halve(b);
+            if (a == b)
+                return;
+            if (a > b)
+                std::swap(a, b);
+            // Link the higher root below the lower one. If b stopped being a root in the meantime, retry.
+            int expected = b;
+            if (m_parent[b].compare_exchange_strong(expected, a, std::memory_order_relaxed))
+                return;
+        }
+    }
+
+    std::vector<std::atomic<int>> m_parent;
+};
+
+// Run the union-find in parallel for large meshes only.
+template<class NeighborIndex, class Fn>
+auto with_face_patches(const NeighborIndex &neighbor_index, size_t num_faces, Fn &&fn)
+{
+    if (num_faces < FacePatchUnionFind::parallel_threshold)
+        return fn(ex_seq, FacePatchUnionFind(ex_seq, neighbor_index, num_faces));
+    else
+        return fn(ex_tbb, FacePatchUnionFind(ex_tbb, neighbor_index, num_faces));
+}
+
 } // namespace meshsplit_detail
 
 // Funky wrapper for timinig of its_split() using various neighbor index creating methods, see sandboxes/its_neighbor_index/main.cpp
@@ -140,15 +249,26 @@ void its_split(const Its &m, OutputIt out_it)
     };
     std::vector<VertexConv> vidx_conv(its.vertices.size());
 
-    meshsplit_detail::NeighborVisitor visitor(its, meshsplit_detail::ItsWithNeighborsIndex_<Its>::get_index(m));
-    
-    std::vector<size_t> facets;
-    for (size_t part_id = 0;; ++part_id) {
-        // Collect all faces of the next patch.
-        facets.clear();
-        visitor.visit([&facets](size_t idx) { facets.emplace_back(idx); return true; });
-        if (facets.empty())
-            break;
+    // Label the faces with their patches using the thread safe union-find.
+    std::vector<int> face_patch;
+    const size_t     num_patches = with_face_patches(ItsWithNeighborsIndex_<Its>::get_index(m), its.indices.size(),
+        [&face_patch](auto &ex, const FacePatchUnionFind &union_find) { return union_find.label(ex, face_patch); });
+
+    // Sort the faces by patches (counting sort), keeping the order of faces inside each patch.
+    std::vector<size_t> patch_start(num_patches + 1, 0);
+    for (int patch_id : face_patch)
+        ++ patch_start[patch_id + 1];
+    for (size_t i = 1; i < patch_start.size(); ++ i)
+        patch_start[i] += patch_start[i - 1];
+    std::vector<size_t> patch_faces(face_patch.size());
+    {
+        std::vector<size_t> patch_end(patch_start.begin(), patch_start.end() - 1);
+        for (size_t face_id = 0; face_id < face_patch.size(); ++ face_id)
+            patch_faces[patch_end[face_patch[face_id]] ++] = face_id;
+    }
+
+    for (size_t part_id = 0; part_id < num_patches; ++part_id) {
+        Range facets(patch_faces.cbegin() + patch_start[part_id], patch_faces.cbegin() + patch_start[part_id + 1]);
 
         // Create a new mesh for the part that was just split off.
         indexed_triangle_set mesh;
@@ -190,31 +310,18 @@ std::vector<indexed_triangle_set> its_split(const Its &its)
 template<class Its> 
 bool its_is_splittable(const Its &m)
 {
-    meshsplit_detail::NeighborVisitor visitor(meshsplit_detail::ItsWithNeighborsIndex_<Its>::get_its(m), meshsplit_detail::ItsWithNeighborsIndex_<Its>::get_index(m));
-    bool has_some = false;
-    bool has_some2 = false;
-    // Traverse the 1st patch fully.
-    visitor.visit([&has_some](size_t idx) { has_some = true; return true; });
-    if (has_some)
-        // Just check whether there is any face of the 2nd patch.
-        visitor.visit([&has_some2](size_t idx) { has_some2 = true; return false; });
-    return has_some && has_some2;
+    using namespace meshsplit_detail;
+    return with_face_patches(ItsWithNeighborsIndex_<Its>::get_index(m), ItsWithNeighborsIndex_<Its>::get_its(m).indices.size(),
+        [](auto &, const FacePatchUnionFind &union_find) { return union_find.has_multiple_patches(); });
 }
 
 template<class Its>
 size_t its_number_of_patches(const Its &m)
 {
-    meshsplit_detail::NeighborVisitor visitor(meshsplit_detail::ItsWithNeighborsIndex_<Its>::get_its(m), meshsplit_detail::ItsWithNeighborsIndex_<Its>::get_index(m));
-    size_t num_patches = 0;
-    for (;;) {
-        bool has_some = false;
-        // Traverse the 1st patch fully.
-        visitor.visit([&has_some](size_t idx) { has_some = true; return true; });
-        if (! has_some)
-            break;
-        ++ num_patches;
-    }
-    return num_patches;
+    using namespace meshsplit_detail;
+    std::vector<int> face_patch;
+    return with_face_patches(ItsWithNeighborsIndex_<Its>::get_index(m), ItsWithNeighborsIndex_<Its>::get_its(m).indices.size(),
+        [&face_patch](auto &ex, const FacePatchUnionFind &union_find) { return union_find.label(ex, face_patch); });
 }
 
 template<class ExPolicy>
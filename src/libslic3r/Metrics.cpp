@@ -0,0 +1,175 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#include "Metrics.hpp"
+#include "Trace.hpp"
+#include "Utils.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <mutex>
+
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/fstream.hpp>
+
+namespace Slic3r::Metrics {
+
+namespace {
+
+// Upper bounds of the histogram buckets in seconds, the +Inf bucket is implicit.
+constexpr std::array<double, 11> s_buckets { 0.01, 0.05, 0.1, 0.5, 1., 2.5, 5., 10., 30., 60., 300. };
+
+struct Histogram
+{
+    // Not cumulative, the cumulative counts are calculated by to_text().
+    std::array<uint64_t, s_buckets.size() + 1> counts {};
+    uint64_t                                   sum_us { 0 };
+
+    void observe(uint64_t duration_us) {
+        const double seconds = double(duration_us) * 1e-6;
+        size_t       i       = 0;
+        for (; i < s_buckets.size() && seconds > s_buckets[i]; ++ i) ;
+        ++ counts[i];
+        sum_us += duration_us;
+    }
+};
+
+struct Storage
+{
+    std::mutex                      mutex;
+    std::map<std::string, Histogram> steps;
+    std::array<uint64_t, 3>         jobs {};
+    Histogram                       job_durations;
+    uint64_t                        output_bytes { 0 };
+    uint64_t                        cancellations { 0 };
+};
+
+Storage&          storage() { static Storage s_storage; return s_storage; }
+std::atomic<bool> s_enabled { false };
+
+const char* job_result_name(size_t result)
+{
+    switch (JobResult(result)) {
+    case JobResult::Ok:       return "ok";
+    case JobResult::Error:    return "error";
+    case JobResult::Canceled: return "canceled";
+    }
+    return "";
+}
+
+void append_histogram(std::string &out, const char *name, const std::string &labels, const Histogram &histogram)
+{
+    char     buf[64];
+    uint64_t cumulative = 0;
+    const std::string label_prefix = labels.empty() ? std::string() : labels + ",";
+    for (size_t i = 0; i < histogram.counts.size(); ++ i) {
+        cumulative += histogram.counts[i];
+        if (i < s_buckets.size())
+            snprintf(buf, sizeof(buf), "%g", s_buckets[i]);
+        out += std::string(name) + "_bucket{" + label_prefix + "le=\"" + (i < s_buckets.size() ? buf : "+Inf") + "\"} " +
+            std::to_string(cumulative) + "\n";
+    }
+    snprintf(buf, sizeof(buf), "%.6f", double(histogram.sum_us) * 1e-6);
+    const std::string braced = labels.empty() ? std::string() : "{" + labels + "}";
+    out += std::string(name) + "_sum" + braced + " " + buf + "\n";
+    out += std::string(name) + "_count" + braced + " " + std::to_string(cumulative) + "\n";
+}
+
+} // namespace
+
+bool enabled()
+{
+    return s_enabled.load(std::memory_order_relaxed);
+}
+
+void enable(bool enable)
+{
+    s_enabled.store(enable, std::memory_order_relaxed);
+    // The step durations are measured by the Trace::Scope spans.
+    Trace::detail::update_active();
+}
+
+void clear()
+{
+    Storage &s = storage();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.steps.clear();
+    s.jobs = {};
+    s.job_durations = {};
+    s.output_bytes  = 0;
+    s.cancellations = 0;
+}
+
+void observe_step(const std::string &step, uint64_t duration_us)
+{
+    Storage &s = storage();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.steps[step].observe(duration_us);
+}
+
+void observe_job(JobResult result, uint64_t duration_us, size_t output_bytes)
+{
+    Storage &s = storage();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    ++ s.jobs[size_t(result)];
+    s.job_durations.observe(duration_us);
+    s.output_bytes += output_bytes;
+}
+
+void count_cancellation()
+{
+    Storage &s = storage();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    ++ s.cancellations;
+}
+
+std::string to_text()
+{
+    Storage &s = storage();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    std::string out;
+    out += "# HELP prusaslicer_jobs_total Slicing jobs processed, by their result.\n"
+           "# TYPE prusaslicer_jobs_total counter\n";
+    for (size_t i = 0; i < s.jobs.size(); ++ i)
+        out += std::string("prusaslicer_jobs_total{result=\"") + job_result_name(i) + "\"} " + std::to_string(s.jobs[i]) + "\n";
+    out += "# HELP prusaslicer_job_duration_seconds Duration of the slicing jobs.\n"
+           "# TYPE prusaslicer_job_duration_seconds histogram\n";
+    append_histogram(out, "prusaslicer_job_duration_seconds", std::string(), s.job_durations);
+    out += "# HELP prusaslicer_step_duration_seconds Duration of the print steps and print object steps.\n"
+           "# TYPE prusaslicer_step_duration_seconds histogram\n";
+    for (const auto &[step, histogram] : s.steps)
+        append_histogram(out, "prusaslicer_step_duration_seconds", "step=\"" + step + "\"", histogram);
+    out += "# HELP prusaslicer_output_bytes_total Size of the exported G-code and SLA archives.\n"
+           "# TYPE prusaslicer_output_bytes_total counter\n"
+           "prusaslicer_output_bytes_total " + std::to_string(s.output_bytes) + "\n";
+    out += "# HELP prusaslicer_cancellations_total Canceled processing of a print.\n"
+           "# TYPE prusaslicer_cancellations_total counter\n"
+           "prusaslicer_cancellations_total " + std::to_string(s.cancellations) + "\n";
+    out += "# HELP prusaslicer_peak_memory_bytes Peak resident memory of the process.\n"
+           "# TYPE prusaslicer_peak_memory_bytes gauge\n"
+           "prusaslicer_peak_memory_bytes " + std::to_string(peak_memory_usage()) + "\n";
+    return out;
+}
+
+bool save(const std::string &path)
+{
+    const std::string path_tmp = path + ".tmp";
+    {
+        boost::nowide::ofstream file(path_tmp, std::ios::binary | std::ios::trunc);
+        file << to_text();
+        if (! file.good()) {
+            BOOST_LOG_TRIVIAL(error) << "Failed to write the metrics " << path_tmp;
+            return false;
+        }
+    }
+    if (std::error_code ec = rename_file(path_tmp, path); ec) {
+        BOOST_LOG_TRIVIAL(error) << "Failed to rename the metrics " << path_tmp << " to " << path << ": " << ec.message();
+        return false;
+    }
+    return true;
+}
+
+} // namespace Slic3r::Metrics
@@ -0,0 +1,54 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef libslic3r_Metrics_hpp_
+#define libslic3r_Metrics_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Slic3r {
+
+// Opt-in metrics of the slicing jobs processed by the command line slicer, mostly in the slicing server mode:
+// Counters of the jobs, of the cancellations and of the exported bytes, histograms of the job durations
+// and of the durations of the print steps and the peak memory of the process.
+// The durations of the print steps are collected from the "step" spans of Trace::Scope, thus the metrics
+// measure exactly what the trace shows, though the trace does not need to be enabled to collect the metrics.
+//
+// The metrics are exported in the Prometheus text exposition format, to be collected for example
+// by the textfile collector of the Prometheus node exporter. The metrics are disabled by default,
+// they are enabled by the --metrics command line option.
+namespace Metrics {
+
+enum class JobResult {
+    Ok,
+    Error,
+    Canceled,
+};
+
+bool        enabled();
+// Not thread safe, to be called before slicing is started.
+void        enable(bool enable);
+// Drop all the collected values.
+void        clear();
+
+// Called by Trace::Scope for the spans of the "step" category, the step name is stripped of the " (detail)" suffix.
+void        observe_step(const std::string &step, uint64_t duration_us);
+// Called by the command line slicer once a job finished, output_bytes is the size of the exported file.
+void        observe_job(JobResult result, uint64_t duration_us, size_t output_bytes);
+// Called once per canceled processing of a print.
+void        count_cancellation();
+
+// All the metrics in the Prometheus text exposition format.
+std::string to_text();
+// Save the metrics into a file, replacing it atomically, so that a collector never reads a partially written file.
+// Returns false if the file could not be written.
+bool        save(const std::string &path);
+
+} // namespace Metrics
+
+} // namespace Slic3r
+
+#endif // libslic3r_Metrics_hpp_
@@ -18,11 +18,17 @@
 #include <boost/multiprecision/integer.hpp>
 #endif
 
+#include <boost/functional/hash.hpp>
+
 #include <libnest2d/backends/libslic3r/geometries.hpp> // IWYU pragma: keep
 #include <libnest2d/utils/rotcalipers.hpp>
+#include <cassert>
 #include <cmath>
 #include <cinttypes>
 #include <cstdlib>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 
 #include "libnest2d/common.hpp"
 #include "libnest2d/geometry_traits.hpp"
@@ -40,17 +46,167 @@ using Rational = boost::rational<boost::multiprecision::int128_t>;
 using Rational = boost::rational<__int128>;
 #endif
 
+namespace {
+
+// Number type of the ratios compared by the rotating calipers. All of them are
+// of the form a / b * c with integral a, b and c: the squared cosines of the
+// caliper angles and the areas of the rectangles. Exact rationals normalize
+// their 128 bit numerator and denominator on every operation, which dominates
+// the running time. Comparing the long double approximations gives the exact
+// answer unless the two values are closer than their rounding error, which
+// happens only for degenerate inputs like parallel edges or boxes of equal
+// area. Only then the exact rationals are evaluated, so the results are the
+// same as if Rational was used everywhere.
+class FilteredRatio
+{
+public:
+    FilteredRatio() = default;
+    FilteredRatio(Unit a) : m_a{a}, m_approx{static_cast<long double>(a)} {}
+
+    FilteredRatio operator/(Unit b) const
+    {
+        assert(m_b == 1 && m_c == 1 && b != 0);
+        FilteredRatio ret = *this;
+        ret.m_b = b;
+        ret.m_approx /= static_cast<long double>(b);
+        return ret;
+    }
+
+    FilteredRatio operator*(Unit c) const
+    {
+        assert(m_c == 1);
+        FilteredRatio ret = *this;
+        ret.m_c = c;
+        ret.m_approx *= static_cast<long double>(c);
+        return ret;
+    }
+
+    friend bool operator<(const FilteredRatio &l, const FilteredRatio &r) { return compare(l, r) < 0; }
+    friend bool operator>(const FilteredRatio &l, const FilteredRatio &r) { return compare(l, r) > 0; }
+    friend bool operator<=(const FilteredRatio &l, const FilteredRatio &r) { return compare(l, r) <= 0; }
+    friend bool operator>=(const FilteredRatio &l, const FilteredRatio &r) { return compare(l, r) >= 0; }
+    friend bool operator==(const FilteredRatio &l, const FilteredRatio &r) { return compare(l, r) == 0; }
+    friend bool operator!=(const FilteredRatio &l, const FilteredRatio &r) { return compare(l, r) != 0; }
+
+private:
+    // Three roundings of the operands and two of the operations, each bounded
+    // by 2^-53 even if long double is just a double. The bound is very loose
+    // to stay on the safe side with any floating point environment.
+    static constexpr long double RelativeError = 1e-12l;
+
+    static int compare(const FilteredRatio &l, const FilteredRatio &r)
+    {
+        long double diff  = l.m_approx - r.m_approx;
+        long double bound = RelativeError * (std::abs(l.m_approx) + std::abs(r.m_approx));
+        if (diff > bound)
+            return 1;
+        if (diff < -bound)
+            return -1;
+        // A value compared with its copy, e.g. the smallest caliper angle.
+        if (l.m_a == r.m_a && l.m_b == r.m_b && l.m_c == r.m_c)
+            return 0;
+
+        Rational el = l.exact(), er = r.exact();
+        return el < er ? -1 : er < el ? 1 : 0;
+    }
+
+    Rational exact() const { return Rational(m_a) / m_b * m_c; }
+
+    Unit        m_a = 0, m_b = 1, m_c = 1;
+    long double m_approx = 0.l;
+};
+
+// Thread safe memoization of the rotating calipers. Arrange and fill bed query
+// the very same outlines for all copies of an object. Once the cache grows over
+// MaxEntries, it is flushed.
+template<class Value> class ResultCache
+{
+public:
+    struct Key
+    {
+        Points shape;
+        Point  box_size;
+
+        bool operator==(const Key &o) const
+        {
+            return box_size == o.box_size && shape == o.shape;
+        }
+    };
+
+    std::optional<Value> find(const Key &key) const
+    {
+        std::lock_guard lk{m_mutex};
+        auto it = m_results.find(key);
+        return it == m_results.end() ? std::nullopt : std::make_optional(it->second);
+    }
+
+    void insert(Key key, const Value &value)
+    {
+        std::lock_guard lk{m_mutex};
+        if (m_results.size() >= MaxEntries)
+            m_results.clear();
+
+        m_results.emplace(std::move(key), value);
+    }
+
+private:
+    static constexpr size_t MaxEntries = 1024;
+
+    struct KeyHash
+    {
+        size_t operator()(const Key &k) const
+        {
+            size_t seed = 0;
+            boost::hash_combine(seed, k.box_size.x());
+            boost::hash_combine(seed, k.box_size.y());
+            for (const Point &p : k.shape) {
+                boost::hash_combine(seed, p.x());
+                boost::hash_combine(seed, p.y());
+            }
+
+            return seed;
+        }
+    };
+
+    mutable std::mutex                       m_mutex;
+    std::unordered_map<Key, Value, KeyHash> m_results;
+};
+
+const Points &contour_points(const Points &pts) { return pts; }
+const Points &contour_points(const Polygon &p) { return p.points; }
+const Points &contour_points(const ExPolygon &p) { return p.contour.points; }
+
+} // namespace
+
 template<class P>
 libnest2d::RotatedBox<Point, Unit> minAreaBoundigBox_(
     const P &p, MinAreaBoundigBox::PolygonLevel lvl)
 {
+    static ResultCache<libnest2d::RotatedBox<Point, Unit>> cache;
+
     P chull = lvl == MinAreaBoundigBox::pcConvex ?
                         p :
                         libnest2d::sl::convexHull(p);
 
     libnest2d::removeCollinearPoints(chull);
 
-    return libnest2d::minAreaBoundingBox<P, Unit, Rational>(chull);
+    // The box is invariant to translation, all the copies of a shape are
+    // looked up by the vertices relative to the first one.
+    decltype(cache)::Key key;
+    key.shape = contour_points(chull);
+    if (! key.shape.empty()) {
+        Point front = key.shape.front();
+        for (Point &pt : key.shape)
+            pt -= front;
+    }
+
+    if (auto box = cache.find(key))
+        return *box;
+
+    auto box = libnest2d::minAreaBoundingBox<P, Unit, FilteredRatio>(chull);
+    cache.insert(std::move(key), box);
+
+    return box;
 }
 
 MinAreaBoundigBox::MinAreaBoundigBox(const Polygon &p, PolygonLevel pc)
@@ -120,11 +276,21 @@ double fit_into_box_rotation(const Polygon &shape, const BoundingBox &bb)
 {
     using namespace libnest2d;
 
+    // The bisection rotates the shape around the origin, thus the result
+    // depends on its position and only the box may be translated.
+    static ResultCache<double> cache;
+    decltype(cache)::Key key{shape.points, bb.size()};
+    if (auto rotation = cache.find(key))
+        return *rotation;
+
     _Box<Point> box{{bb.min.x(), bb.min.y()}, {bb.max.x(), bb.max.y()}};
 
-    return fitIntoBoxRotation<Polygon, TCompute<Polygon>, Rational>(shape,
-                                                                    box,
-                                                                    EPSILON);
+    double rotation = fitIntoBoxRotation<Polygon, TCompute<Polygon>, FilteredRatio>(shape,
+                                                                                    box,
+                                                                                    EPSILON);
+    cache.insert(std::move(key), rotation);
+
+    return rotation;
 }
 
 } // namespace Slic3r
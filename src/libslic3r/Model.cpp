@@ -1089,8 +1089,15 @@ Polygon ModelObject::convex_hull_2d(const Transform3d& trafo_instance) const
     tbb::parallel_for(tbb::blocked_range<size_t>(0, volumes.size()), [&](const tbb::blocked_range<size_t>& range) {
         for (size_t i = range.begin(); i < range.end(); ++i) {
             const ModelVolume* v = volumes[i];
-            if (v->is_model_part())
-                chs.emplace_back(its_convex_hull_2d_above(v->mesh().its, (trafo_instance * v->get_matrix()).cast<float>(), 0.0f));
+            if (v->is_model_part()) {
+                const Transform3f trafo = (trafo_instance * v->get_matrix()).cast<float>();
+                // If the volume is completely above the print bed, the projection of its convex hull is the same as the projection
+                // of its mesh, while the convex hull has just a fraction of the vertices of a big mesh.
+                const std::shared_ptr<const TriangleMesh> &hull    = v->get_convex_hull_shared_ptr();
+                const bool                                 use_hull = hull && ! hull->empty() &&
+                    std::all_of(hull->its.vertices.begin(), hull->its.vertices.end(), [&trafo](const Vec3f &p) { return (trafo * p).z() >= 0.f; });
+                chs.emplace_back(its_convex_hull_2d_above(use_hull ? hull->its : v->mesh().its, trafo, 0.0f));
+            }
         }
     });
 
@@ -1226,9 +1233,7 @@ void ModelObject::convert_units(ModelObjectPtrs& new_objects, ConversionType con
     int vol_idx = 0;
     for (ModelVolume* volume : volumes) {
         if (!volume->mesh().empty()) {
-            TriangleMesh mesh(volume->mesh());
-
-            ModelVolume* vol = new_object->add_volume(mesh);
+            ModelVolume* vol = new_object->add_volume(TriangleMesh(volume->mesh()));
             vol->name = volume->name;
             vol->set_type(volume->type());
             // Don't copy the config's ID.
@@ -1584,7 +1589,18 @@ unsigned int ModelObject::update_instances_print_volume_state(const BuildVolume
         for (const ModelVolume* vol : this->volumes)
             if (vol->is_model_part()) {
                 const Transform3d matrix = model_instance->get_matrix() * vol->get_matrix();
-                BuildVolume::ObjectState state = build_volume.object_state(vol->mesh().its, matrix.cast<float>(), true /* may be below print bed */);
+                // The vertices of the convex hull are a subset of the mesh vertices and all mesh vertices are inside the convex hull,
+                // thus against a convex build volume, the mesh is inside or completely below the print bed if and only if its convex hull is.
+                // Test the convex hull first, it is much cheaper for big meshes than the mesh itself.
+                BuildVolume::ObjectState state = BuildVolume::ObjectState::Colliding;
+                bool                     state_valid = false;
+                if (const std::shared_ptr<const TriangleMesh> &hull = vol->get_convex_hull_shared_ptr();
+                    hull && ! hull->empty() && build_volume.type() != BuildVolume::Type::Custom) {
+                    state = build_volume.object_state(hull->its, matrix.cast<float>(), true /* may be below print bed */);
+                    state_valid = state == BuildVolume::ObjectState::Inside || state == BuildVolume::ObjectState::Below;
+                }
+                if (! state_valid)
+                    state = build_volume.object_state(vol->mesh().its, matrix.cast<float>(), true /* may be below print bed */);
                 if (state == BuildVolume::ObjectState::Inside)
                     // Volume is completely inside.
                     inside_outside |= INSIDE;
@@ -1762,15 +1778,30 @@ bool ModelVolume::is_splittable() const
     return m_is_splittable == 1;
 }
 
+// Meshes and convex hulls are shared between copies of a ModelVolume (Print's copy of the Model, Undo / Redo stack, clipboard).
+// Modify the mesh in place only if this ModelVolume is its only owner, otherwise modify a private copy (copy on write).
+template<typename ModifyFn>
+static void modify_mesh_copy_on_write(std::shared_ptr<const TriangleMesh> &mesh, ModifyFn &&modify)
+{
+    if (! mesh)
+        return;
+    if (mesh.use_count() == 1)
+        modify(*const_cast<TriangleMesh*>(mesh.get()));
+    else {
+        auto copy = std::make_shared<TriangleMesh>(*mesh);
+        modify(*copy);
+        mesh = std::move(copy);
+    }
+}
+
 void ModelVolume::center_geometry_after_creation(bool update_source_offset)
 {
     Vec3d shift = this->mesh().bounding_box().center();
     if (!shift.isApprox(Vec3d::Zero()))
     {
-    	if (m_mesh)
-        	const_cast<TriangleMesh*>(m_mesh.get())->translate(-(float)shift(0), -(float)shift(1), -(float)shift(2));
-        if (m_convex_hull)
-			const_cast<TriangleMesh*>(m_convex_hull.get())->translate(-(float)shift(0), -(float)shift(1), -(float)shift(2));
+        auto translate_mesh = [&shift](TriangleMesh &mesh) { mesh.translate(-(float)shift(0), -(float)shift(1), -(float)shift(2)); };
+        modify_mesh_copy_on_write(m_mesh, translate_mesh);
+        modify_mesh_copy_on_write(m_convex_hull, translate_mesh);
         translate(shift);
     }
 
@@ -1955,33 +1986,28 @@ void ModelVolume::mirror(Axis axis)
     set_mirror(mirror);
 }
 
-// This method could only be called before the meshes of this ModelVolumes are not shared!
+// Scales the meshes in place if they are not shared, otherwise the shared meshes are left intact and this ModelVolume gets a scaled copy.
 void ModelVolume::scale_geometry_after_creation(const Vec3f& versor)
 {
-	const_cast<TriangleMesh*>(m_mesh.get())->scale(versor);
-	const_cast<TriangleMesh*>(m_convex_hull.get())->scale(versor);
+    auto scale_mesh = [&versor](TriangleMesh &mesh) { mesh.scale(versor); };
+    modify_mesh_copy_on_write(m_mesh, scale_mesh);
+    modify_mesh_copy_on_write(m_convex_hull, scale_mesh);
 }
 
 void ModelVolume::transform_this_mesh(const Transform3d &mesh_trafo, bool fix_left_handed)
 {
-	TriangleMesh mesh = this->mesh();
-	mesh.transform(mesh_trafo, fix_left_handed);
-	this->set_mesh(std::move(mesh));
-    TriangleMesh convex_hull = this->get_convex_hull();
-    convex_hull.transform(mesh_trafo, fix_left_handed);
-    m_convex_hull = std::make_shared<TriangleMesh>(std::move(convex_hull));
+    auto transform_mesh = [&mesh_trafo, fix_left_handed](TriangleMesh &mesh) { mesh.transform(mesh_trafo, fix_left_handed); };
+    modify_mesh_copy_on_write(m_mesh, transform_mesh);
+    modify_mesh_copy_on_write(m_convex_hull, transform_mesh);
     // Let the rest of the application know that the geometry changed, so the meshes have to be reloaded.
     this->set_new_unique_id();
 }
 
 void ModelVolume::transform_this_mesh(const Matrix3d &matrix, bool fix_left_handed)
 {
-	TriangleMesh mesh = this->mesh();
-	mesh.transform(matrix, fix_left_handed);
-	this->set_mesh(std::move(mesh));
-    TriangleMesh convex_hull = this->get_convex_hull();
-    convex_hull.transform(matrix, fix_left_handed);
-    m_convex_hull = std::make_shared<TriangleMesh>(std::move(convex_hull));
+    auto transform_mesh = [&matrix, fix_left_handed](TriangleMesh &mesh) { mesh.transform(matrix, fix_left_handed); };
+    modify_mesh_copy_on_write(m_mesh, transform_mesh);
+    modify_mesh_copy_on_write(m_convex_hull, transform_mesh);
     // Let the rest of the application know that the geometry changed, so the meshes have to be reloaded.
     this->set_new_unique_id();
 }
@@ -2043,6 +2069,9 @@ void ModelInstance::transform_polygon(Polygon* polygon) const
 
 indexed_triangle_set FacetsAnnotation::get_facets(const ModelVolume& mv, TriangleStateType type) const
 {
+    // Don't reconstruct the triangle splitting tree if there is nothing to return.
+    if (! this->may_have_facets(type))
+        return {};
     TriangleSelector selector(mv.mesh());
     // Reset of TriangleSelector is done inside TriangleSelector's constructor, so we don't need it to perform it again in deserialize().
     selector.deserialize(m_data, false);
@@ -2051,12 +2080,28 @@ indexed_triangle_set FacetsAnnotation::get_facets(const ModelVolume& mv, Triangl
 
 indexed_triangle_set FacetsAnnotation::get_facets_strict(const ModelVolume& mv, TriangleStateType type) const
 {
+    if (! this->may_have_facets(type))
+        return {};
     TriangleSelector selector(mv.mesh());
     // Reset of TriangleSelector is done inside TriangleSelector's constructor, so we don't need it to perform it again in deserialize().
     selector.deserialize(m_data, false);
     return selector.get_facets_strict(type);
 }
 
+std::vector<indexed_triangle_set> FacetsAnnotation::get_facets_strict(const ModelVolume& mv, const std::vector<TriangleStateType> &types) const
+{
+    std::vector<indexed_triangle_set> out(types.size());
+    if (std::none_of(types.begin(), types.end(), [this](TriangleStateType type) { return this->may_have_facets(type); }))
+        return out;
+    TriangleSelector selector(mv.mesh());
+    // Reset of TriangleSelector is done inside TriangleSelector's constructor, so we don't need it to perform it again in deserialize().
+    selector.deserialize(m_data, false);
+    for (size_t i = 0; i < types.size(); ++ i)
+        if (this->may_have_facets(types[i]))
+            out[i] = selector.get_facets_strict(types[i]);
+    return out;
+}
+
 bool FacetsAnnotation::has_facets(const ModelVolume& mv, TriangleStateType type) const
 {
     return TriangleSelector::has_facets(m_data, type);
@@ -2077,6 +2122,7 @@ void FacetsAnnotation::reset()
 {
     m_data.triangles_to_split.clear();
     m_data.bitstream.clear();
+    m_data.reset_used_states();
     this->touch();
 }
 
@@ -2274,7 +2320,7 @@ bool model_has_multi_part_objects(const Model &model)
 bool model_has_advanced_features(const Model &model)
 {
 	auto config_is_advanced = [](const ModelConfig &config) {
-        return ! (config.empty() || (config.size() == 1 && config.cbegin()->first == "extruder"));
+        return ! (config.empty() || (config.size() == 1 && config.cbegin()->key() == "extruder"));
 	};
     for (const ModelObject *model_object : model.objects) {
         // Is there more than one instance or advanced config data?
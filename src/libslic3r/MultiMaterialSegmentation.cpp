@@ -914,11 +914,26 @@ static inline std::vector<std::vector<ExPolygons>> mm_segmentation_top_and_botto
 #endif // MM_SEGMENTATION_DEBUG_TOP_BOTTOM
 
     if (max_top_layers > 0 || max_bottom_layers > 0) {
-        for (const ModelVolume *mv : print_object.model_object()->volumes)
-            if (mv->is_model_part()) {
+        // Reconstruct the painted triangles of all the volumes in parallel, the triangle splitting tree
+        // of each volume is reconstructed just once for all the extruders.
+        const ModelVolumePtrs &volumes = print_object.model_object()->volumes;
+        std::vector<TriangleStateType> extruder_states(num_extruders);
+        for (size_t extruder_idx = 0; extruder_idx < num_extruders; ++ extruder_idx)
+            extruder_states[extruder_idx] = TriangleStateType(extruder_idx);
+        std::vector<std::vector<indexed_triangle_set>> painted_per_volume(volumes.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, volumes.size()), [&volumes, &extruder_states, &painted_per_volume, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+            for (size_t volume_idx = range.begin(); volume_idx < range.end(); ++ volume_idx)
+                if (const ModelVolume *mv = volumes[volume_idx]; mv->is_model_part()) {
+                    throw_on_cancel_callback();
+                    painted_per_volume[volume_idx] = mv->mm_segmentation_facets.get_facets_strict(*mv, extruder_states);
+                }
+        });
+
+        for (size_t volume_idx = 0; volume_idx < volumes.size(); ++ volume_idx)
+            if (const ModelVolume *mv = volumes[volume_idx]; mv->is_model_part()) {
                 const Transform3d volume_trafo = object_trafo * mv->get_matrix();
                 for (size_t extruder_idx = 0; extruder_idx < num_extruders; ++ extruder_idx) {
-                    const indexed_triangle_set painted = mv->mm_segmentation_facets.get_facets_strict(*mv, TriangleStateType(extruder_idx));
+                    const indexed_triangle_set &painted = painted_per_volume[volume_idx][extruder_idx];
 #ifdef MM_SEGMENTATION_DEBUG_TOP_BOTTOM
                     {
                         static int iRun = 0;
@@ -1248,53 +1263,19 @@ static bool has_layer_only_one_color(const std::vector<ColoredLines> &colored_po
     return true;
 }
 
-std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
+#ifdef MM_SEGMENTATION_DEBUG
+static int iRun = 0;
+#endif // MM_SEGMENTATION_DEBUG
+
+// Project the painted triangles onto the layers and segment each layer by the colors of its contours.
+static void segment_layers_by_painting(const PrintObject &print_object, const std::vector<ExPolygons> &input_expolygons, std::vector<std::vector<ExPolygons>> &segmented_regions,
+                                       const size_t num_extruders, const std::function<void()> &throw_on_cancel_callback)
 {
-    const size_t                          num_extruders = print_object.print()->config().nozzle_diameter.size();
-    const size_t                          num_layers    = print_object.layers().size();
-    std::vector<std::vector<ExPolygons>>  segmented_regions(num_layers);
-    segmented_regions.assign(num_layers, std::vector<ExPolygons>(num_extruders + 1));
+    const size_t                          num_layers = input_expolygons.size();
+    const SpanOfConstPtrs<Layer>          layers     = print_object.layers();
     std::vector<std::vector<PaintedLine>> painted_lines(num_layers);
     std::array<std::mutex, 64>            painted_lines_mutex;
     std::vector<EdgeGrid::Grid>           edge_grids(num_layers);
-    const SpanOfConstPtrs<Layer>          layers = print_object.layers();
-    std::vector<ExPolygons>               input_expolygons(num_layers);
-
-    throw_on_cancel_callback();
-
-#ifdef MM_SEGMENTATION_DEBUG
-    static int iRun = 0;
-#endif // MM_SEGMENTATION_DEBUG
-
-    // Merge all regions and remove small holes
-    BOOST_LOG_TRIVIAL(debug) << "MM segmentation - slices preparation in parallel - begin";
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&layers, &input_expolygons, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
-        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
-            throw_on_cancel_callback();
-            ExPolygons ex_polygons;
-            for (LayerRegion *region : layers[layer_idx]->regions())
-                for (const Surface &surface : region->slices())
-                    Slic3r::append(ex_polygons, offset_ex(surface.expolygon, float(10 * SCALED_EPSILON)));
-            // All expolygons are expanded by SCALED_EPSILON, merged, and then shrunk again by SCALED_EPSILON
-            // to ensure that very close polygons will be merged.
-            ex_polygons = union_ex(ex_polygons);
-            // Remove all expolygons and holes with an area less than 0.1mm^2
-            remove_small_and_small_holes(ex_polygons, Slic3r::sqr(scale_(0.1f)));
-            // Occasionally, some input polygons contained self-intersections that caused problems with Voronoi diagrams
-            // and consequently with the extraction of colored segments by function extract_colored_segments.
-            // Calling simplify_polygons removes these self-intersections.
-            // Also, occasionally input polygons contained several points very close together (distance between points is 1 or so).
-            // Such close points sometimes caused that the Voronoi diagram has self-intersecting edges around these vertices.
-            // This consequently leads to issues with the extraction of colored segments by function extract_colored_segments.
-            // Calling expolygons_simplify fixed these issues.
-            input_expolygons[layer_idx] = remove_duplicates(expolygons_simplify(offset_ex(ex_polygons, -10.f * float(SCALED_EPSILON)), 5 * SCALED_EPSILON), scaled<coord_t>(0.01), PI/6);
-
-#ifdef MM_SEGMENTATION_DEBUG_INPUT
-            export_processed_input_expolygons_to_svg(debug_out_path("mm-input-%d-%d.svg", layer_idx, iRun), layers[layer_idx]->regions(), input_expolygons[layer_idx]);
-#endif // MM_SEGMENTATION_DEBUG_INPUT
-        }
-    }); // end of parallel_for
-    BOOST_LOG_TRIVIAL(debug) << "MM segmentation - slices preparation in parallel - end";
 
     std::vector<BoundingBox> layer_bboxes(num_layers);
     for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx) {
@@ -1436,9 +1417,109 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
                 export_regions_to_svg(debug_out_path("mm-regions-sides-%d-%d.svg", layer_idx, iRun), segmented_regions[layer_idx], input_expolygons[layer_idx]);
 #endif // MM_SEGMENTATION_DEBUG_REGIONS
             }
+            // Release the data of a segmented layer right away, so that only the layers being segmented hold their Voronoi diagrams,
+            // edge grids and painted lines.
+            edge_grids[layer_idx] = EdgeGrid::Grid();
+            std::vector<PaintedLine>().swap(painted_lines[layer_idx]);
         }
     }); // end of parallel_for
     BOOST_LOG_TRIVIAL(debug) << "MM segmentation - layers segmentation in parallel - end";
+}
+
+// Hash of everything the segmentation of layers by painting depends on, see MMSegmentationCache.
+static size_t mm_segmentation_key(const PrintObject &print_object, const std::vector<ExPolygons> &input_expolygons, const size_t num_extruders)
+{
+    size_t seed = 0;
+    auto hash_matrix = [&seed](const Transform3d &trafo) {
+        for (int i = 0; i < 16; ++ i)
+            boost::hash_combine(seed, trafo.matrix().data()[i]);
+    };
+    boost::hash_combine(seed, num_extruders);
+    hash_matrix(print_object.trafo());
+    boost::hash_combine(seed, print_object.center_offset().x());
+    boost::hash_combine(seed, print_object.center_offset().y());
+    for (const ModelVolume *mv : print_object.model_object()->volumes) {
+        boost::hash_combine(seed, mv->id().id);
+        boost::hash_combine(seed, mv->is_model_part());
+        boost::hash_combine(seed, mv->mm_segmentation_facets.timestamp());
+        hash_matrix(mv->get_matrix());
+    }
+    for (const Layer *layer : print_object.layers())
+        boost::hash_combine(seed, layer->slice_z);
+    auto hash_polygon = [&seed](const Polygon &polygon) {
+        boost::hash_combine(seed, polygon.size());
+        for (const Point &pt : polygon.points) {
+            boost::hash_combine(seed, pt.x());
+            boost::hash_combine(seed, pt.y());
+        }
+    };
+    for (const ExPolygons &expolygons : input_expolygons) {
+        boost::hash_combine(seed, expolygons.size());
+        for (const ExPolygon &expolygon : expolygons) {
+            hash_polygon(expolygon.contour);
+            boost::hash_combine(seed, expolygon.holes.size());
+            for (const Polygon &hole : expolygon.holes)
+                hash_polygon(hole);
+        }
+    }
+    return seed;
+}
+
+std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback,
+                                                                             MMSegmentationCache *cache)
+{
+    const size_t                          num_extruders = print_object.print()->config().nozzle_diameter.size();
+    const size_t                          num_layers    = print_object.layers().size();
+    std::vector<std::vector<ExPolygons>>  segmented_regions(num_layers);
+    segmented_regions.assign(num_layers, std::vector<ExPolygons>(num_extruders + 1));
+    const SpanOfConstPtrs<Layer>          layers = print_object.layers();
+    std::vector<ExPolygons>               input_expolygons(num_layers);
+
+    throw_on_cancel_callback();
+
+    // Merge all regions and remove small holes
+    BOOST_LOG_TRIVIAL(debug) << "MM segmentation - slices preparation in parallel - begin";
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&layers, &input_expolygons, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
+            throw_on_cancel_callback();
+            ExPolygons ex_polygons;
+            for (LayerRegion *region : layers[layer_idx]->regions())
+                for (const Surface &surface : region->slices())
+                    Slic3r::append(ex_polygons, offset_ex(surface.expolygon, float(10 * SCALED_EPSILON)));
+            // All expolygons are expanded by SCALED_EPSILON, merged, and then shrunk again by SCALED_EPSILON
+            // to ensure that very close polygons will be merged.
+            ex_polygons = union_ex(ex_polygons);
+            // Remove all expolygons and holes with an area less than 0.1mm^2
+            remove_small_and_small_holes(ex_polygons, Slic3r::sqr(scale_(0.1f)));
+            // Occasionally, some input polygons contained self-intersections that caused problems with Voronoi diagrams
+            // and consequently with the extraction of colored segments by function extract_colored_segments.
+            // Calling simplify_polygons removes these self-intersections.
+            // Also, occasionally input polygons contained several points very close together (distance between points is 1 or so).
+            // Such close points sometimes caused that the Voronoi diagram has self-intersecting edges around these vertices.
+            // This consequently leads to issues with the extraction of colored segments by function extract_colored_segments.
+            // Calling expolygons_simplify fixed these issues.
+            input_expolygons[layer_idx] = remove_duplicates(expolygons_simplify(offset_ex(ex_polygons, -10.f * float(SCALED_EPSILON)), 5 * SCALED_EPSILON), scaled<coord_t>(0.01), PI/6);
+
+#ifdef MM_SEGMENTATION_DEBUG_INPUT
+            export_processed_input_expolygons_to_svg(debug_out_path("mm-input-%d-%d.svg", layer_idx, iRun), layers[layer_idx]->regions(), input_expolygons[layer_idx]);
+#endif // MM_SEGMENTATION_DEBUG_INPUT
+        }
+    }); // end of parallel_for
+    BOOST_LOG_TRIVIAL(debug) << "MM segmentation - slices preparation in parallel - end";
+
+    const size_t key = cache ? mm_segmentation_key(print_object, input_expolygons, num_extruders) : 0;
+    if (cache && ! cache->empty() && cache->key == key && cache->segmented_regions.size() == num_layers) {
+        BOOST_LOG_TRIVIAL(debug) << "MM segmentation - reusing the segmentation of layers of the previous slicing";
+        segmented_regions = cache->segmented_regions;
+    } else {
+        if (cache)
+            cache->clear();
+        segment_layers_by_painting(print_object, input_expolygons, segmented_regions, num_extruders, throw_on_cancel_callback);
+        if (cache) {
+            cache->key               = key;
+            cache->segmented_regions = segmented_regions;
+        }
+    }
     throw_on_cancel_callback();
 
     if (auto max_width = print_object.config().mmu_segmented_region_max_width, interlocking_depth = print_object.config().mmu_segmented_region_interlocking_depth; max_width > 0.f) {
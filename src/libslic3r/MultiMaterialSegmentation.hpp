@@ -32,8 +32,25 @@ struct ColoredLine
 
 using ColoredLines = std::vector<ColoredLine>;
 
+// Segmentation of the layers by painting before the segmented regions are cut to mmu_segmented_region_max_width
+// and before the top and bottom layers are merged in. It depends on the painting, the transformations and the slices only,
+// thus PrintObject keeps it to be reused if the object is sliced again, for example after a slicing parameter changed,
+// which did not change the slices.
+struct MMSegmentationCache
+{
+    // Hash of the inputs the segmentation was calculated from.
+    size_t                               key { 0 };
+    std::vector<std::vector<ExPolygons>> segmented_regions;
+
+    void clear() { key = 0; segmented_regions.clear(); }
+    bool empty() const { return segmented_regions.empty(); }
+};
+
 // Returns MMU segmentation based on painting in MMU segmentation gizmo
-std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback);
+// If cache is provided, the projection of the painted triangles and the segmentation of the layers is skipped
+// if the cache matches the painting and the slices, otherwise the cache is updated.
+std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback,
+                                                                             MMSegmentationCache *cache = nullptr);
 
 } // namespace Slic3r
 
@@ -6,6 +6,7 @@
 #define slic3r_MutablePriorityQueue_hpp_
 
 #include <assert.h>
+#include <algorithm>
 #include <type_traits>
 #include <vector>
 #include <limits>
@@ -15,13 +16,17 @@ namespace Slic3r {
 
 constexpr auto InvalidQueueID = std::numeric_limits<size_t>::max();
 
-template<typename T, typename IndexSetter, typename LessPredicate, const bool ResetIndexWhenRemoved = false>
+// Mutable priority queue implemented as an implicit d-ary heap. Arity == 2 is the classic binary heap,
+// 4-ary or 8-ary heaps are shallower and their children are stored next to each other, which is more cache friendly
+// for large heaps at the cost of more comparisons per level when sifting down.
+template<typename T, typename IndexSetter, typename LessPredicate, const bool ResetIndexWhenRemoved = false, std::size_t Arity = 2>
 class MutablePriorityQueue
 {
 public:
 	static_assert(std::is_trivially_copyable<T>::value, "Template argument T must be a trivially copiable type in class template MutablePriorityQueue");
+	static_assert(Arity >= 2, "Template argument Arity of class template MutablePriorityQueue must be at least 2");
 
-	// It is recommended to use make_mutable_priority_queue() for construction.
+	// It is recommended to use make_mutable_priority_queue() or make_dary_mutable_priority_queue() for construction.
 	MutablePriorityQueue(IndexSetter &&index_setter, LessPredicate &&less_predicate) :
 		m_index_setter(std::forward<IndexSetter>(index_setter)), 
 		m_less_predicate(std::forward<LessPredicate>(less_predicate)) 
@@ -75,8 +80,15 @@ MutablePriorityQueue<T, IndexSetter, LessPredicate, ResetIndexWhenRemoved> make_
     	std::forward<IndexSetter>(index_setter), std::forward<LessPredicate>(less_predicate));
 }
 
-template<class T, class LessPredicate, class IndexSetter, const bool ResetIndexWhenRemoved>
-inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRemoved>::clear()
+template<typename T, std::size_t Arity, const bool ResetIndexWhenRemoved, typename IndexSetter, typename LessPredicate>
+MutablePriorityQueue<T, IndexSetter, LessPredicate, ResetIndexWhenRemoved, Arity> make_dary_mutable_priority_queue(IndexSetter &&index_setter, LessPredicate &&less_predicate)
+{
+    return MutablePriorityQueue<T, IndexSetter, LessPredicate, ResetIndexWhenRemoved, Arity>(
+    	std::forward<IndexSetter>(index_setter), std::forward<LessPredicate>(less_predicate));
+}
+
+template<class T, class LessPredicate, class IndexSetter, const bool ResetIndexWhenRemoved, std::size_t Arity>
+inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRemoved, Arity>::clear()
 { 
 	if constexpr (ResetIndexWhenRemoved) {
 		for (size_t idx = 0; idx < m_heap.size(); ++ idx)
@@ -86,8 +98,8 @@ inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRe
 	m_heap.clear();
 }
 
-template<class T, class LessPredicate, class IndexSetter, const bool ResetIndexWhenRemoved>
-inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRemoved>::push(const T &item)
+template<class T, class LessPredicate, class IndexSetter, const bool ResetIndexWhenRemoved, std::size_t Arity>
+inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRemoved, Arity>::push(const T &item)
 {
 	size_t idx = m_heap.size();
 	m_heap.emplace_back(item);
@@ -95,8 +107,8 @@ inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRe
 	update_heap_up(0, idx);
 }
 
-template<class T, class LessPredicate, class IndexSetter, const bool ResetIndexWhenRemoved>
-inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRemoved>::push(T &&item)
+template<class T, class LessPredicate, class IndexSetter, const bool ResetIndexWhenRemoved, std::size_t Arity>
+inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRemoved, Arity>::push(T &&item)
 {
 	size_t idx = m_heap.size();
 	m_heap.emplace_back(std::move(item));
@@ -104,8 +116,8 @@ inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRe
 	update_heap_up(0, idx);
 }
 
-template<class T, class LessPredicate, class IndexSetter, const bool ResetIndexWhenRemoved>
-inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRemoved>::pop()
+template<class T, class LessPredicate, class IndexSetter, const bool ResetIndexWhenRemoved, std::size_t Arity>
+inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRemoved, Arity>::pop()
 {
 	assert(! m_heap.empty());
 	if constexpr (ResetIndexWhenRemoved) {
@@ -121,8 +133,8 @@ inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRe
 		m_heap.clear();
 }
 
-template<class T, class LessPredicate, class IndexSetter, const bool ResetIndexWhenRemoved>
-inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRemoved>::remove(size_t idx)
+template<class T, class LessPredicate, class IndexSetter, const bool ResetIndexWhenRemoved, std::size_t Arity>
+inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRemoved, Arity>::remove(size_t idx)
 {
 	assert(idx < m_heap.size());
 	// Only mark as removed from the queue in release mode, if configured so.
@@ -141,13 +153,13 @@ inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRe
 	update_heap_up(0, idx);
 }
 
-template<class T, class LessPredicate, class IndexSetter, const bool ResetIndexWhenRemoved>
-inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRemoved>::update_heap_up(size_t top, size_t bottom)
+template<class T, class LessPredicate, class IndexSetter, const bool ResetIndexWhenRemoved, std::size_t Arity>
+inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRemoved, Arity>::update_heap_up(size_t top, size_t bottom)
 {
 	size_t childIdx = bottom;
 	T *child = &m_heap[childIdx];
 	for (;;) {
-		size_t parentIdx = (childIdx - 1) >> 1;
+		size_t parentIdx = (childIdx - 1) / Arity;
 		if (childIdx == 0 || parentIdx < top)
 			break;
 		T *parent = &m_heap[parentIdx];
@@ -165,18 +177,19 @@ inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRe
 	}
 }
 
-template<class T, class LessPredicate, class IndexSetter, const bool ResetIndexWhenRemoved>
-inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRemoved>::update_heap_down(size_t top, size_t bottom)
+template<class T, class LessPredicate, class IndexSetter, const bool ResetIndexWhenRemoved, std::size_t Arity>
+inline void MutablePriorityQueue<T, LessPredicate, IndexSetter, ResetIndexWhenRemoved, Arity>::update_heap_down(size_t top, size_t bottom)
 {
 	size_t parentIdx = top;
 	T *parent = &m_heap[parentIdx];
 	for (;;) {
-		size_t childIdx = (parentIdx << 1) + 1;
+		size_t childIdx = parentIdx * Arity + 1;
 		if (childIdx > bottom)
 			break;
 		T *child = &m_heap[childIdx];
-		size_t child2Idx = childIdx + 1;
-		if (child2Idx <= bottom) {
+		// Select the smallest of the (up to Arity) children, which are stored next to each other.
+		const size_t childEnd = std::min(childIdx + Arity - 1, bottom);
+		for (size_t child2Idx = childIdx + 1; child2Idx <= childEnd; ++ child2Idx) {
 			T *child2 = &m_heap[child2Idx];
 			if (! m_less_predicate(*child, *child2)) {
 				child = child2;
@@ -458,6 +471,139 @@ inline void MutableSkipHeapPriorityQueue<T, LessPredicate, IndexSetter, blocking
 	}
 }
 
+// Mutable bucket queue for items with small non-negative integer priorities, for example priorities quantized
+// to a grid or hop counts. Item priority is the bucket index returned by KeyGetter, lower bucket index is served first.
+// Items of the same priority are served in an unspecified order. push(), remove() and update() run in a constant time,
+// pop() amortizes the search for the next non-empty bucket, which is cheap if the priorities popped do not decrease
+// much over time (monotone use as in Dijkstra or greedy merging) and the range of priorities is small.
+// The interface is the same as of MutablePriorityQueue, the index passed to IndexSetter is an index of a slot
+// in the queue, which is to be passed to operator[], remove() and update().
+template<typename T, typename IndexSetter, typename KeyGetter, const bool ResetIndexWhenRemoved = false>
+class MutableBucketPriorityQueue
+{
+public:
+	static_assert(std::is_trivially_copyable<T>::value, "Template argument T must be a trivially copiable type in class template MutableBucketPriorityQueue");
+
+	// It is recommended to use make_bucket_mutable_priority_queue() for construction.
+	MutableBucketPriorityQueue(IndexSetter &&index_setter, KeyGetter &&key_getter) :
+		m_index_setter(std::forward<IndexSetter>(index_setter)), 
+		m_key_getter(std::forward<KeyGetter>(key_getter)) 
+		{}
+	~MutableBucketPriorityQueue()	{ clear(); }
+
+	MutableBucketPriorityQueue(MutableBucketPriorityQueue &&) = default;
+	MutableBucketPriorityQueue& operator=(MutableBucketPriorityQueue &&) = default;
+
+	// This class modifies the outside data through the m_index_setter
+	// and thus it should not be copied. The semantics is similar to std::unique_ptr
+	MutableBucketPriorityQueue(const MutableBucketPriorityQueue &) = delete;
+	MutableBucketPriorityQueue& operator=(const MutableBucketPriorityQueue &) = delete;
+
+	void		clear();
+	void		reserve(size_t cnt) 				{ m_items.reserve(cnt); m_slots.reserve(cnt); }
+	// Preallocate buckets for priorities 0 to (cnt - 1), otherwise buckets are allocated on demand.
+	void		reserve_buckets(size_t cnt)			{ if (cnt > m_buckets.size()) m_buckets.resize(cnt); }
+	void		push(const T &item);
+	void		pop()								{ assert(! empty()); this->remove(m_buckets[m_min_bucket].back()); }
+	T&			top()								{ assert(! empty()); return m_items[m_buckets[m_min_bucket].back()]; }
+	void		remove(size_t idx);
+	void		update(size_t idx) 					{ T item = m_items[idx]; remove(idx); push(item); }
+
+	size_t		size() const						{ return m_items.size(); }
+	bool		empty() const						{ return m_items.empty(); }
+	T&			operator[](std::size_t idx) noexcept { return m_items[idx]; }
+	const T&	operator[](std::size_t idx) const noexcept { return m_items[idx]; }
+    static constexpr size_t invalid_id() { return InvalidQueueID; }
+
+private:
+	struct Slot {
+		// Index of a bucket, thus the priority of an item.
+		size_t bucket;
+		// Position of the item index inside the bucket.
+		size_t pos;
+	};
+	// Items are stored densely, m_slots is parallel to m_items.
+	std::vector<T>					m_items;
+	std::vector<Slot>				m_slots;
+	// Indices into m_items for each priority.
+	std::vector<std::vector<size_t>> m_buckets;
+	// Lowest non-empty bucket if the queue is not empty.
+	size_t							m_min_bucket { InvalidQueueID };
+	IndexSetter						m_index_setter;
+	KeyGetter						m_key_getter;
+};
+
+template<typename T, const bool ResetIndexWhenRemoved, typename IndexSetter, typename KeyGetter>
+MutableBucketPriorityQueue<T, IndexSetter, KeyGetter, ResetIndexWhenRemoved> make_bucket_mutable_priority_queue(IndexSetter &&index_setter, KeyGetter &&key_getter)
+{
+    return MutableBucketPriorityQueue<T, IndexSetter, KeyGetter, ResetIndexWhenRemoved>(
+    	std::forward<IndexSetter>(index_setter), std::forward<KeyGetter>(key_getter));
+}
+
+template<class T, class IndexSetter, class KeyGetter, const bool ResetIndexWhenRemoved>
+inline void MutableBucketPriorityQueue<T, IndexSetter, KeyGetter, ResetIndexWhenRemoved>::clear()
+{
+	if constexpr (ResetIndexWhenRemoved) {
+		for (size_t idx = 0; idx < m_items.size(); ++ idx)
+			// Mark as removed from the queue.
+			m_index_setter(m_items[idx], this->invalid_id());
+	}
+	m_items.clear();
+	m_slots.clear();
+	// Keep the memory allocated by the buckets.
+	for (std::vector<size_t> &bucket : m_buckets)
+		bucket.clear();
+	m_min_bucket = InvalidQueueID;
+}
+
+template<class T, class IndexSetter, class KeyGetter, const bool ResetIndexWhenRemoved>
+inline void MutableBucketPriorityQueue<T, IndexSetter, KeyGetter, ResetIndexWhenRemoved>::push(const T &item)
+{
+	const size_t key = m_key_getter(item);
+	assert(key != InvalidQueueID);
+	if (key >= m_buckets.size())
+		m_buckets.resize(key + 1);
+	size_t idx = m_items.size();
+	m_items.emplace_back(item);
+	m_index_setter(m_items.back(), idx);
+	std::vector<size_t> &bucket = m_buckets[key];
+	m_slots.push_back({ key, bucket.size() });
+	bucket.emplace_back(idx);
+	m_min_bucket = std::min(m_min_bucket, key);
+}
+
+template<class T, class IndexSetter, class KeyGetter, const bool ResetIndexWhenRemoved>
+inline void MutableBucketPriorityQueue<T, IndexSetter, KeyGetter, ResetIndexWhenRemoved>::remove(size_t idx)
+{
+	assert(idx < m_items.size());
+	if constexpr (ResetIndexWhenRemoved) {
+		// Mark as removed from the queue.
+		m_index_setter(m_items[idx], this->invalid_id());
+	}
+	// Remove from the bucket by moving the last item of the bucket into its place.
+	{
+		const Slot slot = m_slots[idx];
+		std::vector<size_t> &bucket = m_buckets[slot.bucket];
+		bucket[slot.pos] = bucket.back();
+		m_slots[bucket[slot.pos]].pos = slot.pos;
+		bucket.pop_back();
+	}
+	// Remove from the dense storage by moving the last item into its place.
+	if (size_t last = m_items.size() - 1; idx != last) {
+		m_items[idx] = m_items[last];
+		m_slots[idx] = m_slots[last];
+		m_buckets[m_slots[idx].bucket][m_slots[idx].pos] = idx;
+		m_index_setter(m_items[idx], idx);
+	}
+	m_items.pop_back();
+	m_slots.pop_back();
+	if (m_items.empty())
+		m_min_bucket = InvalidQueueID;
+	else
+		while (m_buckets[m_min_bucket].empty())
+			++ m_min_bucket;
+}
+
 } // namespace Slic3r
 
 #endif /* slic3r_MutablePriorityQueue_hpp_ */
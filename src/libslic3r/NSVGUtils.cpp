@@ -6,11 +6,14 @@
 
 #include <boost/nowide/fstream.hpp>
 #include <nanosvg/nanosvg.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <array>
 #include <algorithm>
 #include <sstream>
 #include <cassert>
 #include <cstring>
+#include <vector>
 
 #include "Emboss.hpp" // heal for shape
 #include "libslic3r/ClipperUtils.hpp"
@@ -36,34 +39,47 @@ namespace Slic3r {
 
 ExPolygonsWithIds create_shape_with_ids(const NSVGimage &image, const NSVGLineParams &param)
 {
-    ExPolygonsWithIds result;
-    size_t shape_id = 0;
-    for (NSVGshape *shape_ptr = image.shapes; shape_ptr != NULL; shape_ptr = shape_ptr->next, ++shape_id) {
-        const NSVGshape &shape = *shape_ptr;
-        if (!(shape.flags & NSVG_FLAGS_VISIBLE))
-            continue;
+    std::vector<const NSVGshape *> shapes;
+    for (NSVGshape *shape_ptr = image.shapes; shape_ptr != NULL; shape_ptr = shape_ptr->next)
+        shapes.push_back(shape_ptr);
+
+    // Shapes are converted independently, images with many paths are converted in parallel.
+    // Each shape could create fill and stroke
+    std::vector<ExPolygonsWithIds> shapes_results(shapes.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, shapes.size()),
+    [&shapes, &shapes_results, &param](const tbb::blocked_range<size_t> &range) {
+        for (size_t shape_id = range.begin(); shape_id < range.end(); ++shape_id) {
+            const NSVGshape &shape = *shapes[shape_id];
+            if (!(shape.flags & NSVG_FLAGS_VISIBLE))
+                continue;
 
-        bool is_fill_used = shape.fill.type != NSVG_PAINT_NONE;
-        bool is_stroke_used = 
-            shape.stroke.type != NSVG_PAINT_NONE &&
-            shape.strokeWidth > 1e-5f;
+            bool is_fill_used = shape.fill.type != NSVG_PAINT_NONE;
+            bool is_stroke_used = 
+                shape.stroke.type != NSVG_PAINT_NONE &&
+                shape.strokeWidth > 1e-5f;
 
-        if (!is_fill_used && !is_stroke_used)
-            continue;
+            if (!is_fill_used && !is_stroke_used)
+                continue;
 
-        const LinesPath lines_path = linearize_path(shape.paths, param);
-
-        if (is_fill_used) {
-            unsigned unique_id = static_cast<unsigned>(2 * shape_id);
-            HealedExPolygons expoly = fill_to_expolygons(lines_path, shape, param);
-            result.push_back({unique_id, expoly.expolygons, expoly.is_healed});
-        }        
-        if (is_stroke_used) {
-            unsigned unique_id = static_cast<unsigned>(2 * shape_id + 1);
-            HealedExPolygons expoly = stroke_to_expolygons(lines_path, shape, param);
-            result.push_back({unique_id, expoly.expolygons, expoly.is_healed});
+            const LinesPath lines_path = linearize_path(shape.paths, param);
+
+            ExPolygonsWithIds &shape_result = shapes_results[shape_id];
+            if (is_fill_used) {
+                unsigned unique_id = static_cast<unsigned>(2 * shape_id);
+                HealedExPolygons expoly = fill_to_expolygons(lines_path, shape, param);
+                shape_result.push_back({unique_id, std::move(expoly.expolygons), expoly.is_healed});
+            }        
+            if (is_stroke_used) {
+                unsigned unique_id = static_cast<unsigned>(2 * shape_id + 1);
+                HealedExPolygons expoly = stroke_to_expolygons(lines_path, shape, param);
+                shape_result.push_back({unique_id, std::move(expoly.expolygons), expoly.is_healed});
+            }
         }
-    }
+    }); // END parallel for
+
+    ExPolygonsWithIds result;
+    for (ExPolygonsWithIds &shape_result : shapes_results)
+        result.insert(result.end(), std::make_move_iterator(shape_result.begin()), std::make_move_iterator(shape_result.end()));
 
     // SVG is used as centered
     // Do not disturb user by settings of pivot position
@@ -4,14 +4,71 @@
 ///|/
 #include "NormalUtils.hpp"
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <cmath>
 #include <cstddef>
+#include <algorithm>
 
 #include "libslic3r/Exception.hpp"
 #include "libslic3r/Point.hpp"
 
 using namespace Slic3r;
 
+namespace {
+
+// Meshes with less faces are processed on the calling thread.
+constexpr size_t normals_parallel_threshold = 100000;
+
+// Sums the normals of the faces incident to each vertex weighted by
+// weights_fn(face), which returns the weights of the three face corners, and
+// divides the sums by the sums of the weights.
+// Large meshes are processed in chunks of faces. The normals and weights of a
+// chunk are evaluated in parallel, then they are accumulated into the vertices
+// sequentially in the order of the faces. The floating point operations are the
+// same for any number of threads, thus the result is deterministic.
+template<typename WeightsFn>
+NormalUtils::Normals create_weighted_normals(const indexed_triangle_set &its, WeightsFn &&weights_fn)
+{
+    NormalUtils::Normals normals(its.vertices.size(), Vec3f(.0f, .0f, .0f));
+    std::vector<float>   weights(its.vertices.size(), 0.f);
+    auto accumulate = [&normals, &weights](const Vec3crd &face, const Vec3f &normal, const Vec3f &coefs) {
+        for (int i = 0; i < 3; ++i) {
+            normals[face[i]] += normal * coefs[i];
+            weights[face[i]] += coefs[i];
+        }
+    };
+
+    if (its.indices.size() < normals_parallel_threshold) {
+        for (const Vec3crd &face : its.indices)
+            accumulate(face, NormalUtils::create_triangle_normal(face, its.vertices), weights_fn(face));
+    } else {
+        constexpr size_t   chunk_size = normals_parallel_threshold;
+        std::vector<Vec3f> face_normals(chunk_size);
+        std::vector<Vec3f> face_coefs(chunk_size);
+        for (size_t chunk_begin = 0; chunk_begin < its.indices.size(); chunk_begin += chunk_size) {
+            const size_t chunk_end = std::min(chunk_begin + chunk_size, its.indices.size());
+            tbb::parallel_for(tbb::blocked_range<size_t>(chunk_begin, chunk_end, chunk_size / 16),
+                [&its, &weights_fn, &face_normals, &face_coefs, chunk_begin](const tbb::blocked_range<size_t> &range) {
+                    for (size_t face_idx = range.begin(); face_idx < range.end(); ++face_idx) {
+                        const Vec3crd &face = its.indices[face_idx];
+                        face_normals[face_idx - chunk_begin] = NormalUtils::create_triangle_normal(face, its.vertices);
+                        face_coefs[face_idx - chunk_begin]   = weights_fn(face);
+                    }
+                });
+            for (size_t face_idx = chunk_begin; face_idx < chunk_end; ++face_idx)
+                accumulate(its.indices[face_idx], face_normals[face_idx - chunk_begin], face_coefs[face_idx - chunk_begin]);
+        }
+    }
+
+    // normalize to size 1
+    for (size_t vertex_idx = 0; vertex_idx < normals.size(); ++vertex_idx)
+        normals[vertex_idx] /= weights[vertex_idx];
+    return normals;
+}
+
+} // namespace
+
 Vec3f NormalUtils::create_triangle_normal(
     const stl_triangle_vertex_indices &indices,
     const std::vector<stl_vertex> &    vertices)
@@ -27,33 +84,24 @@ Vec3f NormalUtils::create_triangle_normal(
 std::vector<Vec3f> NormalUtils::create_triangle_normals(
     const indexed_triangle_set &its)
 {
-    std::vector<Vec3f> normals;
-    normals.reserve(its.indices.size());
-    for (const Vec3crd &index : its.indices) {
-        normals.push_back(create_triangle_normal(index, its.vertices));
-    }
+    std::vector<Vec3f> normals(its.indices.size());
+    auto create = [&its, &normals](size_t begin, size_t end) {
+        for (size_t face_idx = begin; face_idx < end; ++face_idx)
+            normals[face_idx] = create_triangle_normal(its.indices[face_idx], its.vertices);
+    };
+    if (its.indices.size() < normals_parallel_threshold)
+        create(0, its.indices.size());
+    else
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size(), normals_parallel_threshold / 16),
+            [&create](const tbb::blocked_range<size_t> &range) { create(range.begin(), range.end()); });
     return normals;
 }
 
 NormalUtils::Normals NormalUtils::create_normals_average_neighbor(
     const indexed_triangle_set &its)
 {
-    size_t             count_vertices = its.vertices.size();
-    std::vector<Vec3f> normals(count_vertices, Vec3f(.0f, .0f, .0f));
-    std::vector<unsigned int> count(count_vertices, 0);
-    for (const Vec3crd &indice : its.indices) {
-        Vec3f normal = create_triangle_normal(indice, its.vertices);
-        for (int i = 0; i < 3; ++i) {
-            normals[indice[i]] += normal;
-            ++count[indice[i]];
-        }
-    }
-    // normalize to size 1
-    for (auto &normal : normals) {
-        size_t index = &normal - &normals.front();
-        normal /= static_cast<float>(count[index]);
-    }
-    return normals;
+    // Unit weights sum up exactly, same as counting the faces.
+    return create_weighted_normals(its, [](const Vec3crd &) { return Vec3f(1.f, 1.f, 1.f); });
 }
 
 // calc triangle angle of vertex defined by index to triangle indices
@@ -81,38 +129,19 @@ float NormalUtils::indice_angle(int                            i,
 NormalUtils::Normals NormalUtils::create_normals_angle_weighted(
     const indexed_triangle_set &its)
 {
-    size_t             count_vertices = its.vertices.size();
-    std::vector<Vec3f> normals(count_vertices, Vec3f(.0f, .0f, .0f));
-    std::vector<float> count(count_vertices, 0.f);
-    for (const Vec3crd &indice : its.indices) {
-        Vec3f normal = create_triangle_normal(indice, its.vertices);
+    return create_weighted_normals(its, [&its](const Vec3crd &indice) {
         Vec3f angles(indice_angle(0, indice, its.vertices),
                      indice_angle(1, indice, its.vertices), 0.f);
         angles[2] = (M_PI - angles[0] - angles[1]);
-        for (int i = 0; i < 3; ++i) {
-            const float &weight = angles[i];
-            normals[indice[i]] += normal * weight;
-            count[indice[i]] += weight;
-        }
-    }
-    // normalize to size 1
-    for (auto &normal : normals) {
-        size_t index = &normal - &normals.front();
-        normal /= count[index];
-    }
-    return normals;
+        return angles;
+    });
 }
 
 NormalUtils::Normals NormalUtils::create_normals_nelson_weighted(
     const indexed_triangle_set &its)
 {
-    size_t             count_vertices = its.vertices.size();
-    std::vector<Vec3f> normals(count_vertices, Vec3f(.0f, .0f, .0f));
-    std::vector<float> count(count_vertices, 0.f);
     const std::vector<stl_vertex> &vertices = its.vertices;
-    for (const Vec3crd &indice : its.indices) {
-        Vec3f normal = create_triangle_normal(indice, vertices);
-
+    return create_weighted_normals(its, [&vertices](const Vec3crd &indice) {
         const stl_vertex &v0 = vertices[indice[0]];
         const stl_vertex &v1 = vertices[indice[1]];
         const stl_vertex &v2 = vertices[indice[2]];
@@ -121,19 +150,8 @@ NormalUtils::Normals NormalUtils::create_normals_nelson_weighted(
         float e1 = (v1 - v2).norm();
         float e2 = (v2 - v0).norm();
 
-        Vec3f coefs(e0 * e2, e0 * e1, e1 * e2);
-        for (int i = 0; i < 3; ++i) {
-            const float &weight = coefs[i];
-            normals[indice[i]] += normal * weight;
-            count[indice[i]] += weight;
-        }
-    }
-    // normalize to size 1
-    for (auto &normal : normals) {
-        size_t index = &normal - &normals.front();
-        normal /= count[index];
-    }
-    return normals;
+        return Vec3f(e0 * e2, e0 * e1, e1 * e2);
+    });
 }
 
 // calculate normals by averaging normals of neghbor triangles
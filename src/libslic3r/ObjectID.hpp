@@ -12,6 +12,7 @@
 #include <cereal/cereal.hpp>
 #include <cinttypes>
 #include <cstddef>
+#include <atomic>
 
 namespace Slic3r {
 
@@ -54,8 +55,7 @@ private:
 // to synchronize the front end (UI) with the back end (BackgroundSlicingProcess / Print / PrintObject).
 // Also base for Print, PrintObject, SLAPrint, SLAPrintObject to provide a unique ID for matching Model / ModelObject
 // with their corresponding Print / PrintObject objects by the notification center at the UI when processing back-end warnings.
-// Achtung! The s_last_id counter is not thread safe, so it is expected, that the ObjectBase derived instances
-// are only instantiated from the main thread.
+// The s_last_id counter is atomic, so that models may be loaded by worker threads, for example when loading multiple files at once.
 class ObjectBase
 {
 public:
@@ -91,7 +91,7 @@ private:
     ObjectID                m_id;
 
 	static inline ObjectID  generate_new_id() { return ObjectID(++ s_last_id); }
-    static size_t           s_last_id;
+    static std::atomic<size_t> s_last_id;
 	
 	friend ObjectID wipe_tower_object_id();
 	friend ObjectID wipe_tower_instance_id();
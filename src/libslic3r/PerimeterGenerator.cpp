@@ -52,6 +52,37 @@
 
 namespace Slic3r {
 
+void PerimeterGenerator::LowerSlicesCache::set(Polygons &&polygons)
+{
+    this->polygons = std::move(polygons);
+    this->bboxes.clear();
+    this->bboxes.reserve(this->polygons.size());
+    for (const Polygon &polygon : this->polygons)
+        this->bboxes.emplace_back(polygon.points);
+}
+
+Polygons PerimeterGenerator::LowerSlicesCache::clipped(const BoundingBox &bbox) const
+{
+    // A polygon not overlapping bbox would be clipped to an empty polygon anyway.
+    Polygons out;
+    for (size_t i = 0; i < this->polygons.size(); ++ i)
+        if (this->bboxes[i].overlap(bbox))
+            if (Polygon clipped = ClipperUtils::clip_clipper_polygon_with_subject_bbox(this->polygons[i], bbox); ! clipped.empty())
+                out.emplace_back(std::move(clipped));
+    return out;
+}
+
+void PerimeterGenerator::prepare_lower_slices_cache(const Parameters &params, const ExPolygons *lower_slices, LowerSlicesCache &lower_slices_cache)
+{
+    if (params.config.overhangs && lower_slices != nullptr && lower_slices_cache.empty()) {
+        // We consider overhang any part where the entire nozzle diameter is not supported by the
+        // lower layer, so we take lower slices and offset them by half the nozzle diameter used
+        // in the current layer
+        double nozzle_diameter = params.print_config.nozzle_diameter.get_at(params.config.perimeter_extruder-1);
+        lower_slices_cache.set(offset(*lower_slices, float(scale_(+nozzle_diameter/2))));
+    }
+}
+
 ExtrusionMultiPath PerimeterGenerator::thick_polyline_to_multi_path(const ThickPolyline &thick_polyline, ExtrusionRole role, const Flow &flow, const float tolerance, const float merge_tolerance)
 {
     ExtrusionMultiPath multi_path;
@@ -280,7 +311,7 @@ static void fuzzy_extrusion_line(Arachne::ExtrusionLine &ext_lines, double fuzzy
 
 using PerimeterGeneratorLoops = std::vector<PerimeterGeneratorLoop>;
 
-static ExtrusionEntityCollection traverse_loops_classic(const PerimeterGenerator::Parameters &params, const Polygons &lower_slices_polygons_cache, const PerimeterGeneratorLoops &loops, ThickPolylines &thin_walls)
+static ExtrusionEntityCollection traverse_loops_classic(const PerimeterGenerator::Parameters &params, const PerimeterGenerator::LowerSlicesCache &lower_slices_cache, const PerimeterGeneratorLoops &loops, ThickPolylines &thin_walls)
 {
     // loops is an arrayref of ::Loop objects
     // turn each one into an ExtrusionLoop object
@@ -313,7 +344,7 @@ static ExtrusionEntityCollection traverse_loops_classic(const PerimeterGenerator
                   params.object_config.support_material_contact_distance.value == 0)) {
             BoundingBox bbox(polygon.points);
             bbox.offset(SCALED_EPSILON);
-            Polygons lower_slices_polygons_clipped = ClipperUtils::clip_clipper_polygons_with_subject_bbox(lower_slices_polygons_cache, bbox);
+            Polygons lower_slices_polygons_clipped = lower_slices_cache.clipped(bbox);
             // get non-overhang paths by intersecting this loop with the grown lower slices
             extrusion_paths_append(
                 paths,
@@ -376,7 +407,7 @@ static ExtrusionEntityCollection traverse_loops_classic(const PerimeterGenerator
         } else {
             const PerimeterGeneratorLoop &loop = loops[idx.first];
             assert(thin_walls.empty());
-            ExtrusionEntityCollection children = traverse_loops_classic(params, lower_slices_polygons_cache, loop.children, thin_walls);
+            ExtrusionEntityCollection children = traverse_loops_classic(params, lower_slices_cache, loop.children, thin_walls);
             out.entities.reserve(out.entities.size() + children.entities.size() + 1);
             ExtrusionLoop *eloop = static_cast<ExtrusionLoop*>(coll.entities[idx.first]);
             coll.entities[idx.first] = nullptr;
@@ -491,7 +522,7 @@ static ClipperLib_Z::Paths clip_extrusion(const ClipperLib_Z::Path &subject, con
     return clipped_paths;
 }
 
-static ExtrusionEntityCollection traverse_extrusions(const PerimeterGenerator::Parameters &params, const Polygons &lower_slices_polygons_cache, Arachne::PerimeterOrder::PerimeterExtrusions &pg_extrusions)
+static ExtrusionEntityCollection traverse_extrusions(const PerimeterGenerator::Parameters &params, const PerimeterGenerator::LowerSlicesCache &lower_slices_cache, Arachne::PerimeterOrder::PerimeterExtrusions &pg_extrusions)
 {
     ExtrusionEntityCollection extrusion_coll;
     for (Arachne::PerimeterOrder::PerimeterExtrusion &pg_extrusion : pg_extrusions) {
@@ -521,13 +552,15 @@ static ExtrusionEntityCollection traverse_extrusions(const PerimeterGenerator::P
             }
 
             ClipperLib_Z::Paths lower_slices_paths;
-            lower_slices_paths.reserve(lower_slices_polygons_cache.size());
+            lower_slices_paths.reserve(lower_slices_cache.polygons.size());
             {
                 Points clipped;
                 extrusion_path_bbox.offset(SCALED_EPSILON);
-                for (const Polygon &poly : lower_slices_polygons_cache) {
+                for (size_t i = 0; i < lower_slices_cache.polygons.size(); ++ i) {
+                    if (! lower_slices_cache.bboxes[i].overlap(extrusion_path_bbox))
+                        continue;
                     clipped.clear();
-                    ClipperUtils::clip_clipper_polygon_with_subject_bbox(poly.points, extrusion_path_bbox, clipped);
+                    ClipperUtils::clip_clipper_polygon_with_subject_bbox(lower_slices_cache.polygons[i].points, extrusion_path_bbox, clipped);
                     if (! clipped.empty()) {
                         lower_slices_paths.emplace_back();
                         ClipperLib_Z::Path &out = lower_slices_paths.back();
@@ -858,7 +891,7 @@ ExtrusionPaths sort_extra_perimeters(const ExtrusionPaths& extra_perims, int ind
 // Function will generate extra perimeters clipped over nonbridgeable areas of the provided surface and returns both the new perimeters and
 // Polygons filled by those clipped perimeters
 std::tuple<std::vector<ExtrusionPaths>, Polygons> generate_extra_perimeters_over_overhangs(ExPolygons               infill_area,
-                                                                                           const Polygons          &lower_slices_polygons,
+                                                                                           const PerimeterGenerator::LowerSlicesCache &lower_slices_cache,
                                                                                            int                      perimeter_count,
                                                                                            const Flow              &overhang_flow,
                                                                                            double                   scaled_resolution,
@@ -868,7 +901,7 @@ std::tuple<std::vector<ExtrusionPaths>, Polygons> generate_extra_perimeters_over
     coord_t anchors_size = std::min(coord_t(scale_(EXTERNAL_INFILL_MARGIN)), overhang_flow.scaled_spacing() * (perimeter_count + 1));
 
     BoundingBox infill_area_bb = get_extents(infill_area).inflated(SCALED_EPSILON);
-    Polygons optimized_lower_slices = ClipperUtils::clip_clipper_polygons_with_subject_bbox(lower_slices_polygons, infill_area_bb);
+    Polygons optimized_lower_slices = lower_slices_cache.clipped(infill_area_bb);
     Polygons overhangs  = diff(infill_area, optimized_lower_slices);
 
     if (overhangs.empty()) { return {}; }
@@ -956,9 +989,7 @@ std::tuple<std::vector<ExtrusionPaths>, Polygons> generate_extra_perimeters_over
                     Polylines  fills;
                     ExPolygons gap = shrinked.empty() ? offset_ex(prev, overhang_flow.scaled_spacing() * 0.5) : to_expolygons(shrinked);
 
-                    for (const ExPolygon &ep : gap) {
-                        ep.medial_axis(0.75 * overhang_flow.scaled_width(), 3.0 * overhang_flow.scaled_spacing(), &fills);
-                    }
+                    medial_axis(gap, 0.75 * overhang_flow.scaled_width(), 3.0 * overhang_flow.scaled_spacing(), &fills);
                     if (!fills.empty()) {
                         fills = intersection_pl(fills, shrinked_overhang_to_cover);
                         extrusion_paths_append(overhang_region, reconnect_polylines(fills, overhang_flow.scaled_spacing()),
@@ -1064,7 +1095,7 @@ void PerimeterGenerator::process_arachne(
     const ExPolygons           *lower_slices,
     const ExPolygons           *upper_slices,
     // Cache:
-    Polygons                   &lower_slices_polygons_cache,
+    LowerSlicesCache           &lower_slices_cache,
     // Output:
     // Loops with the external thin walls
     ExtrusionEntityCollection  &out_loops,
@@ -1084,13 +1115,7 @@ void PerimeterGenerator::process_arachne(
     coord_t solid_infill_spacing  = params.solid_infill_flow.scaled_spacing();
 
     // prepare grown lower layer slices for overhang detection
-    if (params.config.overhangs && lower_slices != nullptr && lower_slices_polygons_cache.empty()) {
-        // We consider overhang any part where the entire nozzle diameter is not supported by the
-        // lower layer, so we take lower slices and offset them by half the nozzle diameter used
-        // in the current layer
-        double nozzle_diameter = params.print_config.nozzle_diameter.get_at(params.config.perimeter_extruder-1);
-        lower_slices_polygons_cache = offset(*lower_slices, float(scale_(+nozzle_diameter/2)));
-    }
+    prepare_lower_slices_cache(params, lower_slices, lower_slices_cache);
 
     // we need to process each island separately because we might have different
     // extra perimeters for each one
@@ -1108,7 +1133,7 @@ void PerimeterGenerator::process_arachne(
 
     ExPolygons last   = offset_ex(surface.expolygon.simplify_p(params.scaled_resolution), - float(ext_perimeter_width / 2. - ext_perimeter_spacing / 2.));
     Polygons   last_p = to_polygons(last);
-    Arachne::WallToolPaths wall_tool_paths(last_p, ext_perimeter_spacing, perimeter_spacing, coord_t(loop_number + 1), 0, params.layer_height, params.object_config, params.print_config);
+    Arachne::WallToolPaths wall_tool_paths(last_p, ext_perimeter_spacing, perimeter_spacing, coord_t(loop_number + 1), 0, params.layer_height, params.object_config, params.print_config, params.throw_on_cancel);
     Arachne::Perimeters    perimeters     = wall_tool_paths.getToolPaths();
     ExPolygons             infill_contour = union_ex(wall_tool_paths.getInnerContour());
 
@@ -1146,7 +1171,7 @@ void PerimeterGenerator::process_arachne(
             top_expolygons = intersection_ex(top_expolygons, infill_contour);
 
             const Polygons not_top_polygons = to_polygons(not_top_expolygons);
-            Arachne::WallToolPaths inner_wall_tool_paths(not_top_polygons, perimeter_spacing, perimeter_spacing, coord_t(inner_loop_number + 1), 0, params.layer_height, params.object_config, params.print_config);
+            Arachne::WallToolPaths inner_wall_tool_paths(not_top_polygons, perimeter_spacing, perimeter_spacing, coord_t(inner_loop_number + 1), 0, params.layer_height, params.object_config, params.print_config, params.throw_on_cancel);
             Arachne::Perimeters inner_perimeters = inner_wall_tool_paths.getToolPaths();
 
             // Recalculate indexes of inner perimeters before merging them.
@@ -1165,7 +1190,7 @@ void PerimeterGenerator::process_arachne(
         } else {
             // There is no top surface ExPolygon, so we call Arachne again with parameters
             // like when the single perimeter feature is disabled.
-            Arachne::WallToolPaths no_single_perimeter_tool_paths(last_p, ext_perimeter_spacing, perimeter_spacing, coord_t(inner_loop_number + 2), 0, params.layer_height, params.object_config, params.print_config);
+            Arachne::WallToolPaths no_single_perimeter_tool_paths(last_p, ext_perimeter_spacing, perimeter_spacing, coord_t(inner_loop_number + 2), 0, params.layer_height, params.object_config, params.print_config, params.throw_on_cancel);
             perimeters     = no_single_perimeter_tool_paths.getToolPaths();
             infill_contour = union_ex(no_single_perimeter_tool_paths.getInnerContour());
         }
@@ -1233,7 +1258,7 @@ void PerimeterGenerator::process_arachne(
         }
     }
 
-    if (ExtrusionEntityCollection extrusion_coll = traverse_extrusions(params, lower_slices_polygons_cache, ordered_extrusions); !extrusion_coll.empty())
+    if (ExtrusionEntityCollection extrusion_coll = traverse_extrusions(params, lower_slices_cache, ordered_extrusions); !extrusion_coll.empty())
         out_loops.append(extrusion_coll);
 
     const coord_t spacing = (perimeters.size() == 1) ? ext_perimeter_spacing2 : perimeter_spacing;
@@ -1269,7 +1294,7 @@ void PerimeterGenerator::process_arachne(
         params.config.perimeters > 0 && params.layer_id > params.object_config.raft_layers) {
         // Generate extra perimeters on overhang areas, and cut them to these parts only, to save print time and material
         auto [extra_perimeters, filled_area] = generate_extra_perimeters_over_overhangs(infill_areas,
-                                                                                        lower_slices_polygons_cache,
+                                                                                        lower_slices_cache,
                                                                                         loop_number + 1,
                                                                                         params.overhang_flow, params.scaled_resolution,
                                                                                         params.object_config, params.print_config);
@@ -1294,7 +1319,7 @@ void PerimeterGenerator::process_classic(
     const ExPolygons           *lower_slices,
     const ExPolygons           *upper_slices,
     // Cache:
-    Polygons                   &lower_slices_polygons_cache,
+    LowerSlicesCache           &lower_slices_cache,
     // Output:
     // Loops with the external thin walls
     ExtrusionEntityCollection  &out_loops,
@@ -1328,13 +1353,7 @@ void PerimeterGenerator::process_classic(
     bool    has_gap_fill 		= params.config.gap_fill_enabled.value && params.config.gap_fill_speed.value > 0;
 
     // prepare grown lower layer slices for overhang detection
-    if (params.config.overhangs && lower_slices != nullptr && lower_slices_polygons_cache.empty()) {
-        // We consider overhang any part where the entire nozzle diameter is not supported by the
-        // lower layer, so we take lower slices and offset them by half the nozzle diameter used 
-        // in the current layer
-        double nozzle_diameter = params.print_config.nozzle_diameter.get_at(params.config.perimeter_extruder-1);
-        lower_slices_polygons_cache = offset(*lower_slices, float(scale_(+nozzle_diameter/2)));
-    }
+    prepare_lower_slices_cache(params, lower_slices, lower_slices_cache);
 
     // we need to process each island separately because we might have different
     // extra perimeters for each one
@@ -1377,8 +1396,7 @@ void PerimeterGenerator::process_classic(
                         diff_ex(last, offset(offsets, float(ext_perimeter_width / 2.) + ClipperSafetyOffset)),
                         float(min_width / 2.));
                     // the maximum thickness of our thin wall area is equal to the minimum thickness of a single loop
-                    for (ExPolygon &ex : expp)
-                        ex.medial_axis(min_width, ext_perimeter_width + ext_perimeter_spacing2, &thin_walls);
+                    medial_axis(expp, min_width, ext_perimeter_width + ext_perimeter_spacing2, &thin_walls);
                 }
                 if (params.spiral_vase && offsets.size() > 1) {
                 	// Remove all but the largest area polygon.
@@ -1560,7 +1578,7 @@ void PerimeterGenerator::process_classic(
             }
         }
         // at this point, all loops should be in contours[0]
-        ExtrusionEntityCollection entities = traverse_loops_classic(params, lower_slices_polygons_cache, contours.front(), thin_walls);
+        ExtrusionEntityCollection entities = traverse_loops_classic(params, lower_slices_cache, contours.front(), thin_walls);
         // if brim will be printed, reverse the order of perimeters so that
         // we continue inwards after having finished the brim
         // TODO: add test for perimeter order
@@ -1582,8 +1600,7 @@ void PerimeterGenerator::process_classic(
             opening_ex(gaps, float(min / 2.)),
             offset2_ex(gaps, - float(max / 2.), float(max / 2. + ClipperSafetyOffset)));
         ThickPolylines polylines;
-        for (const ExPolygon &ex : gaps_ex)
-            ex.medial_axis(min, max, &polylines);
+        medial_axis(gaps_ex, min, max, &polylines);
         if (! polylines.empty()) {
 			ExtrusionEntityCollection gap_fill;
 			variable_width_classic(polylines, ExtrusionRole::GapFill, params.solid_infill_flow, gap_fill.entities);
@@ -1639,7 +1656,7 @@ void PerimeterGenerator::process_classic(
         params.config.perimeters > 0 && params.layer_id > params.object_config.raft_layers) {
         // Generate extra perimeters on overhang areas, and cut them to these parts only, to save print time and material
         auto [extra_perimeters, filled_area] = generate_extra_perimeters_over_overhangs(infill_areas,
-                                                                                        lower_slices_polygons_cache,
+                                                                                        lower_slices_cache,
                                                                                         loop_number + 1,
                                                                                         params.overhang_flow, params.scaled_resolution,
                                                                                         params.object_config, params.print_config);
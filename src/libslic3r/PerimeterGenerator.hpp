@@ -7,9 +7,11 @@
 #ifndef slic3r_PerimeterGenerator_hpp_
 #define slic3r_PerimeterGenerator_hpp_
 
+#include <functional>
 #include <vector>
 
 #include "libslic3r.h"
+#include "BoundingBox.hpp"
 #include "ExtrusionEntityCollection.hpp"
 #include "Flow.hpp"
 #include "Polygon.hpp"
@@ -39,7 +41,8 @@ struct Parameters {
         const PrintRegionConfig    &config,
         const PrintObjectConfig    &object_config,
         const PrintConfig          &print_config,
-        const bool                  spiral_vase) :   
+        const bool                  spiral_vase,
+        std::function<void()>       throw_on_cancel = [](){}) :   
             layer_height(layer_height),
             layer_id(layer_id),
             perimeter_flow(perimeter_flow), 
@@ -53,7 +56,8 @@ struct Parameters {
             scaled_resolution(scaled<double>(print_config.gcode_resolution.value)),
             mm3_per_mm(perimeter_flow.mm3_per_mm()),
             ext_mm3_per_mm(ext_perimeter_flow.mm3_per_mm()), 
-            mm3_per_mm_overhang(overhang_flow.mm3_per_mm())
+            mm3_per_mm_overhang(overhang_flow.mm3_per_mm()),
+            throw_on_cancel(std::move(throw_on_cancel))
         {
         }
 
@@ -75,10 +79,29 @@ struct Parameters {
     double                       mm3_per_mm;
     double                       mm3_per_mm_overhang;
 
+    // Cancel point of the background processing, called between the stages of the perimeter generation.
+    std::function<void()>        throw_on_cancel;
+
 private:
     Parameters() = delete;
 };
 
+// Lower layer slices grown by half the nozzle diameter, used for overhang detection.
+// Computed once per layer region and shared by all its surfaces. Bounding boxes of the polygons
+// are cached, so that a perimeter is only clipped against the lower polygons it may overlap with.
+struct LowerSlicesCache {
+    Polygons                 polygons;
+    std::vector<BoundingBox> bboxes;
+
+    bool empty() const { return polygons.empty(); }
+    void set(Polygons &&polygons);
+    // Lower polygons clipped to bbox, polygons not overlapping bbox are skipped.
+    Polygons clipped(const BoundingBox &bbox) const;
+};
+
+// Grow lower_slices for overhang detection into lower_slices_cache, if not done yet.
+void prepare_lower_slices_cache(const Parameters &params, const ExPolygons *lower_slices, LowerSlicesCache &lower_slices_cache);
+
 void process_classic(
     // Inputs:
     const Parameters           &params,
@@ -86,7 +109,7 @@ void process_classic(
     const ExPolygons           *lower_slices,
     const ExPolygons           *upper_slices,
     // Cache:
-    Polygons                   &lower_slices_polygons_cache,
+    LowerSlicesCache           &lower_slices_cache,
     // Output:
     // Loops with the external thin walls
     ExtrusionEntityCollection  &out_loops,
@@ -102,7 +125,7 @@ void process_arachne(
     const ExPolygons           *lower_slices,
     const ExPolygons           *upper_slices,
     // Cache:
-    Polygons                   &lower_slices_polygons_cache,
+    LowerSlicesCache           &lower_slices_cache,
     // Output:
     // Loops with the external thin walls
     ExtrusionEntityCollection  &out_loops,
@@ -2362,6 +2362,11 @@ static std::string process_macro(const std::string &templ, client::MyContext &co
 
 std::string PlaceholderParser::process(const std::string &templ, unsigned int current_extruder_id, const DynamicConfig *config_override, DynamicConfig *config_outputs, ContextData *context_data) const
 {
+    // A template without any macro is returned unchanged without running the parser. Such templates are common
+    // among the custom G-codes processed at each layer change or tool change. Templates containing non-ASCII7
+    // characters are passed to the parser to be validated as UTF-8.
+    if (std::all_of(templ.begin(), templ.end(), [](char c) { return c != '{' && c != '[' && (unsigned char)c < 0x80; }))
+        return templ;
     client::MyContext context;
     context.external_config 	= this->external_config();
     context.config              = &this->config();
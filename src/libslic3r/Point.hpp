@@ -71,6 +71,9 @@ using Vec2d   = Eigen::Matrix<double,   2, 1, Eigen::DontAlign>;
 using Vec3d   = Eigen::Matrix<double,   3, 1, Eigen::DontAlign>;
 using Vec4d   = Eigen::Matrix<double,   4, 1, Eigen::DontAlign>;
 
+// Points are allocated by the TBB scalable allocator: The small blocks of the tiny polygons and polylines
+// are served from thread local pools without locking. Points is intentionally the same type as ClipperLib::Path,
+// so that the results of the Clipper operations are moved into Polygons / Polylines without copying.
 template<typename BaseType>
 using PointsAllocator = tbb::scalable_allocator<BaseType>;
 //using PointsAllocator = std::allocator<BaseType>;
@@ -583,6 +583,7 @@ static std::vector<std::string> s_Preset_sla_print_options {
     "support_points_minimal_distance",
     "slice_closing_radius",
     "slicing_mode",
+    "preview_booleans",
     "pad_enable",
     "pad_wall_thickness",
     "pad_wall_height",
@@ -685,7 +686,7 @@ static std::vector<std::string> s_Preset_sla_printer_options {
     "elefant_foot_min_width",
     "gamma_correction",
     "min_exposure_time", "max_exposure_time",
-    "min_initial_exposure_time", "max_initial_exposure_time", "sla_archive_format", "sla_output_precision",
+    "min_initial_exposure_time", "max_initial_exposure_time", "sla_archive_format", "sla_archive_compression_level", "sla_output_precision",
     //FIXME the print host keys are left here just for conversion from the Printer preset to Physical Printer preset.
     "print_host", "printhost_apikey", "printhost_cafile",
     "printer_notes",
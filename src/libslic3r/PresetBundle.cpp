@@ -11,6 +11,7 @@
 #include "Utils.hpp"
 #include "Model.hpp"
 #include "format.hpp"
+#include "libslic3r_version.h"
 
 #include <algorithm>
 #include <set>
@@ -22,10 +23,19 @@
 
 #include <boost/nowide/cstdio.hpp>
 #include <boost/nowide/fstream.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/iostreams/stream.hpp>
 #include <boost/property_tree/ini_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/locale.hpp>
 #include <boost/log/trivial.hpp>
+#include <boost/uuid/detail/md5.hpp>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/utility.hpp>
+#include <cereal/types/vector.hpp>
 
 #include <LibBGCode/core/core.hpp>
 
@@ -1405,6 +1415,253 @@ static void flatten_configbundle_hierarchy(boost::property_tree::ptree &tree, co
     flatten_configbundle_hierarchy(tree, "printer",         preset_bundle ? preset_bundle->printers.system_preset_names()      : std::vector<std::string>());
 }
 
+// Decide a full path to the .ini file of a print / filament / printer preset or of a physical printer.
+static boost::filesystem::path preset_file_path(const std::string &section_name, const std::string &name)
+{
+    auto file_name = boost::algorithm::iends_with(name, ".ini") ? name : name + ".ini";
+    return (boost::filesystem::path(data_dir()) 
+#ifdef SLIC3R_PROFILE_USE_PRESETS_SUBDIR
+        // Store the print/filament/printer presets into a "presets" directory.
+        / "presets" 
+#else
+        // Store the print/filament/printer presets at the same location as the upstream Slic3r.
+#endif
+        / section_name / file_name).make_preferred();
+}
+
+static bool is_preset_section(const std::string &section_name)
+{
+    return boost::starts_with(section_name, "print:") || boost::starts_with(section_name, "filament:") ||
+           boost::starts_with(section_name, "sla_print:") || boost::starts_with(section_name, "sla_material:") ||
+           boost::starts_with(section_name, "printer:") || boost::starts_with(section_name, "physical_printer:");
+}
+
+// Parse the names of obsolete presets. These presets will be deleted from user's
+// profile directory on installation of this vendor preset.
+static void load_obsolete_presets(const boost::property_tree::ptree &section, PresetBundle::ObsoletePresets &obsolete_presets)
+{
+    for (auto &kvp : section) {
+        std::vector<std::string> *dst = nullptr;
+        if (kvp.first == "print")
+            dst = &obsolete_presets.prints;
+        else if (kvp.first == "filament")
+            dst = &obsolete_presets.filaments;
+        else if (kvp.first == "sla_print")
+            dst = &obsolete_presets.sla_prints;
+        else if (kvp.first == "sla_material")
+            dst = &obsolete_presets.sla_materials;
+        else if (kvp.first == "printer")
+            dst = &obsolete_presets.printers;
+        if (dst)
+            unescape_strings_cstyle(kvp.second.data(), *dst);
+    }
+}
+
+// Binary cache of the system config bundles stored in data_dir()/cache/profiles.
+// Reading, flattening and parsing a vendor config bundle with thousands of presets dominates the application start up.
+// The presets resolved from a system config bundle are cached, each of them as the options differing from the default preset
+// of its collection, together with the non-preset sections of the bundle (vendor, printer models, obsolete presets).
+// The cache entry is only valid for the same bundle file (path, size and modification time), the same build
+// and the same definitions of the configuration options, as the options are stored by their runtime ordinals.
+namespace BundleCache {
+
+constexpr const char     s_magic[8] = { 'P', 'S', 'B', 'U', 'N', 'D', 'L', 'E' };
+constexpr const uint32_t s_version  = 1;
+
+struct CachedPreset
+{
+    Preset::Type             type { Preset::TYPE_INVALID };
+    std::string              name;
+    std::string              alias;
+    std::vector<std::string> renamed_from;
+    // Options differing from the default preset.
+    DynamicPrintConfig       config;
+
+    template<class Archive> void serialize(Archive &ar) { ar(type, name, alias, renamed_from, config); }
+};
+
+using Section = std::pair<std::string, std::vector<std::pair<std::string, std::string>>>;
+
+struct Entry
+{
+    std::vector<Section>      sections;
+    std::vector<CachedPreset> presets;
+
+    template<class Archive> void serialize(Archive &ar) { ar(sections, presets); }
+};
+
+static boost::filesystem::path entry_path(const std::string &bundle_path)
+{
+    using boost::uuids::detail::md5;
+    md5 hash;
+    hash.process_bytes(bundle_path.data(), bundle_path.size());
+    md5::digest_type digest{};
+    hash.get_digest(digest);
+    const auto *bytes = reinterpret_cast<const unsigned char*>(&digest);
+    std::string name = boost::filesystem::path(bundle_path).stem().string() + "-";
+    for (size_t i = 0; i < 8; ++ i) {
+        char buf[3];
+        snprintf(buf, sizeof(buf), "%02x", bytes[i]);
+        name += buf;
+    }
+    return (boost::filesystem::path(data_dir()) / "cache" / "profiles" / (name + ".bin")).make_preferred();
+}
+
+// Everything the validity of a cache entry depends on, besides the content of the cache entry itself.
+static std::string stamp(const std::string &bundle_path)
+{
+    using boost::uuids::detail::md5;
+    md5 hash;
+    auto process = [&hash](const std::string &str) { hash.process_bytes(str.data(), str.size() + 1); };
+    process(SLIC3R_BUILD_ID);
+    process(bundle_path);
+    process(std::to_string(boost::filesystem::file_size(bundle_path)));
+    process(std::to_string(boost::filesystem::last_write_time(bundle_path)));
+    for (const auto &[ordinal, def] : print_config_def.by_serialization_key_ordinal) {
+        process(std::to_string(ordinal) + " " + def->opt_key + " " + std::to_string(int(def->type)) + (def->nullable ? " nullable" : ""));
+        if (def->default_value)
+            process(def->default_value->serialize());
+        if (def->enum_def && def->enum_def->has_values())
+            for (const std::string &value : def->enum_def->values())
+                process(value);
+    }
+    md5::digest_type digest{};
+    hash.get_digest(digest);
+    return std::string(reinterpret_cast<const char*>(&digest), sizeof(digest));
+}
+
+// Returns false if the entry does not exist or if it is not valid.
+static bool load(const std::string &bundle_path, Entry &out)
+{
+    const boost::filesystem::path path = entry_path(bundle_path);
+    boost::system::error_code ec;
+    if (! boost::filesystem::exists(path, ec))
+        return false;
+
+    try {
+        boost::iostreams::mapped_file_source file(path);
+        if (file.size() < sizeof(s_magic) + sizeof(s_version) || memcmp(file.data(), s_magic, sizeof(s_magic)) != 0)
+            throw Slic3r::RuntimeError("Invalid header");
+        uint32_t version;
+        memcpy(&version, file.data() + sizeof(s_magic), sizeof(version));
+        if (version != s_version)
+            throw Slic3r::RuntimeError("Unsupported version");
+        boost::iostreams::stream<boost::iostreams::array_source> stream(file.data() + sizeof(s_magic) + sizeof(s_version), file.size() - sizeof(s_magic) - sizeof(s_version));
+        cereal::BinaryInputArchive archive(stream);
+        std::string entry_stamp;
+        archive(entry_stamp);
+        if (entry_stamp != stamp(bundle_path)) {
+            BOOST_LOG_TRIVIAL(info) << "Config bundle cache: Outdated entry " << path.string();
+            return false;
+        }
+        archive(out);
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(error) << "Config bundle cache: Ignoring invalid entry " << path.string() << ": " << ex.what();
+        return false;
+    }
+    BOOST_LOG_TRIVIAL(debug) << "Config bundle cache: Loaded " << path.string();
+    return true;
+}
+
+// Failure to store the entry is only logged.
+static void store(const std::string &bundle_path, const Entry &entry)
+{
+    const boost::filesystem::path path = entry_path(bundle_path);
+    // Write into a temporary file first and rename it, so that the application instances started in parallel never see a partial entry.
+    const boost::filesystem::path temp_path = path.string() + "." + std::to_string(get_current_pid()) + ".tmp";
+    try {
+        boost::filesystem::create_directories(path.parent_path());
+        {
+            boost::nowide::ofstream file(temp_path.string(), std::ios::binary | std::ios::trunc);
+            file.write(s_magic, sizeof(s_magic));
+            file.write(reinterpret_cast<const char*>(&s_version), sizeof(s_version));
+            {
+                cereal::BinaryOutputArchive archive(file);
+                archive(stamp(bundle_path), entry);
+            }
+            if (! file.good())
+                throw Slic3r::RuntimeError("Failed to write " + temp_path.string());
+        }
+        boost::filesystem::rename(temp_path, path);
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(error) << "Config bundle cache: Failed to store " << path.string() << ": " << ex.what();
+        boost::system::error_code ec;
+        boost::filesystem::remove(temp_path, ec);
+    }
+}
+
+// Options of config, which differ from the default config. The printer technology is always stored,
+// as it decides the default preset of the printers.
+static DynamicPrintConfig diff(const DynamicPrintConfig &config, const DynamicPrintConfig &default_config)
+{
+    DynamicPrintConfig out;
+    for (auto it = config.cbegin(); it != config.cend(); ++ it) {
+        const ConfigOption *opt_default = default_config.option(it->key());
+        if (opt_default == nullptr || *opt_default != *it->option() || it->key() == "printer_technology")
+            out.set_key_value(it->key(), it->option()->clone());
+    }
+    return out;
+}
+
+} // namespace BundleCache
+
+// Load the presets of a system config bundle from the binary cache, returns false if the cache entry is missing or outdated.
+// This PresetBundle is not modified in that case.
+bool PresetBundle::load_configbundle_from_cache(const std::string &path, size_t &presets_loaded)
+{
+    namespace pt = boost::property_tree;
+    BundleCache::Entry entry;
+    if (! BundleCache::load(path, entry))
+        return false;
+
+    pt::ptree tree;
+    for (const BundleCache::Section &section : entry.sections) {
+        pt::ptree &dst = tree.push_back(pt::ptree::value_type(section.first, pt::ptree()))->second;
+        for (const auto &[key, value] : section.second)
+            dst.push_back(pt::ptree::value_type(key, pt::ptree(value)));
+    }
+    VendorProfile vp;
+    try {
+        vp = VendorProfile::from_ini(tree, path);
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(error) << "Config bundle cache: Invalid vendor profile of " << path << ": " << ex.what();
+        return false;
+    }
+
+    const VendorProfile *vendor_profile = &this->vendors.insert({vp.id, vp}).first->second;
+    for (const auto &section : tree)
+        if (section.first == "obsolete_presets")
+            load_obsolete_presets(section.second, this->obsolete_presets);
+
+    // The presets are materialized from the default preset and from the cached differences without copying any values:
+    // The values equal to the defaults are shared with a copy of the default preset, the values equal to those of the preceding
+    // preset of the same collection are shared with that preset. Siblings in a bundle mostly differ in a few values only.
+    std::map<const Preset*, DynamicPrintConfig> default_configs;
+    std::map<Preset::Type, DynamicPrintConfig>  previous_configs;
+    for (BundleCache::CachedPreset &cached : entry.presets) {
+        PresetCollection &presets        = this->get_presets(cached.type);
+        const Preset     &default_preset = cached.type == Preset::TYPE_PRINTER ? presets.default_preset_for(cached.config) : presets.default_preset();
+        auto              it_default     = default_configs.find(&default_preset);
+        if (it_default == default_configs.end())
+            // Values of the copy are shareable, unlike the values of the default preset, which may have been handed out for modification.
+            it_default = default_configs.emplace(&default_preset, DynamicPrintConfig(default_preset.config)).first;
+        DynamicPrintConfig config = it_default->second;
+        config += std::move(cached.config);
+        if (auto it_previous = previous_configs.find(cached.type); it_previous != previous_configs.end())
+            config.share_equal_values(it_previous->second);
+        previous_configs[cached.type] = config;
+        Preset &loaded = presets.load_preset(preset_file_path(presets.section_name(), cached.name).string(), cached.name, std::move(config), false);
+        loaded.is_system    = true;
+        loaded.vendor       = vendor_profile;
+        loaded.alias        = std::move(cached.alias);
+        loaded.renamed_from = std::move(cached.renamed_from);
+    }
+    presets_loaded = entry.presets.size();
+
+    update_alias_maps();
+    return true;
+}
+
 // Load a config bundle file, into presets and store the loaded presets into separate files
 // of the local configuration directory.
 std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
@@ -1418,6 +1675,11 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
         // Reset this bundle, delete user profile files if SaveImported.
         this->reset(flags.has(LoadConfigBundleAttribute::SaveImported));
 
+    // System bundles are loaded from the binary cache if it is up to date, see BundleCache.
+    const bool use_cache = flags == LoadConfigBundleAttributes(LoadConfigBundleAttribute::LoadSystem);
+    if (size_t presets_loaded = 0; use_cache && this->load_configbundle_from_cache(path, presets_loaded))
+        return std::make_pair(PresetsConfigSubstitutions{}, presets_loaded);
+
     // 1) Read the complete config file into a boost::property_tree.
     namespace pt = boost::property_tree;
     pt::ptree tree;
@@ -1466,6 +1728,7 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
     std::string              active_physical_printer;
     size_t                   presets_loaded = 0;
     size_t                   ph_printers_loaded = 0;
+    std::vector<BundleCache::CachedPreset> cached_presets;
 
     for (const auto &section : tree) {
         PresetCollection         *presets = nullptr;
@@ -1516,23 +1779,7 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
                 }
             }
         } else if (section.first == "obsolete_presets") {
-            // Parse the names of obsolete presets. These presets will be deleted from user's
-            // profile directory on installation of this vendor preset.
-            for (auto &kvp : section.second) {
-                std::vector<std::string> *dst = nullptr;
-                if (kvp.first == "print")
-                    dst = &this->obsolete_presets.prints;
-                else if (kvp.first == "filament")
-                    dst = &this->obsolete_presets.filaments;
-                else if (kvp.first == "sla_print")
-                    dst = &this->obsolete_presets.sla_prints;
-                else if (kvp.first == "sla_material")
-                    dst = &this->obsolete_presets.sla_materials;
-                else if (kvp.first == "printer")
-                    dst = &this->obsolete_presets.printers;
-                if (dst)
-                    unescape_strings_cstyle(kvp.second.data(), *dst);
-            }
+            load_obsolete_presets(section.second, this->obsolete_presets);
         } else if (section.first == "settings") {
             // Load the settings.
             for (auto &kvp : section.second) {
@@ -1638,15 +1885,7 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
                 }
             }
             // Decide a full path to this .ini file.
-            auto file_name = boost::algorithm::iends_with(preset_name, ".ini") ? preset_name : preset_name + ".ini";
-            auto file_path = (boost::filesystem::path(data_dir()) 
-#ifdef SLIC3R_PROFILE_USE_PRESETS_SUBDIR
-                // Store the print/filament/printer presets into a "presets" directory.
-                / "presets" 
-#else
-                // Store the print/filament/printer presets at the same location as the upstream Slic3r.
-#endif
-                / presets->section_name() / file_name).make_preferred();
+            auto file_path = preset_file_path(presets->section_name(), preset_name);
             // Load the preset into the list of presets, save it to disk.
             Preset &loaded = presets->load_preset(file_path.string(), preset_name, std::move(config), false);
             if (flags.has(LoadConfigBundleAttribute::SaveImported))
@@ -1672,6 +1911,8 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
 	        else 
 	         	loaded.alias = std::move(alias_name);
 	        loaded.renamed_from = std::move(renamed_from);
+            if (use_cache)
+                cached_presets.push_back({ presets->type(), preset_name, loaded.alias, loaded.renamed_from, BundleCache::diff(loaded.config, *default_config) });
             if (! substitution_context.empty())
                 substitutions.push_back({ 
                     preset_name, presets->type(), PresetConfigSubstitutions::Source::ConfigBundle, 
@@ -1706,15 +1947,7 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
             }
 
             // Decide a full path to this .ini file.
-            auto file_name = boost::algorithm::iends_with(ph_printer_name, ".ini") ? ph_printer_name : ph_printer_name + ".ini";
-            auto file_path = (boost::filesystem::path(data_dir())
-#ifdef SLIC3R_PROFILE_USE_PRESETS_SUBDIR
-                // Store the physical printers into a "presets" directory.
-                / "presets"
-#else
-                // Store the physical printers at the same location as the upstream Slic3r.
-#endif
-                / "physical_printer" / file_name).make_preferred();
+            auto file_path = preset_file_path("physical_printer", ph_printer_name);
             // Load the preset into the list of presets, save it to disk.
             ph_printers->load_printer(file_path.string(), ph_printer_name, std::move(config), false, flags.has(LoadConfigBundleAttribute::SaveImported));
             if (! substitution_context.empty())
@@ -1751,6 +1984,19 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
         this->update_compatible(PresetSelectCompatibleType::Never);
     }
 
+    // Physical printers are not cached, neither are the results of substitutions, which are to be reported.
+    if (use_cache && substitutions.empty() && ph_printers_loaded == 0) {
+        BundleCache::Entry entry;
+        for (const auto &section : tree)
+            if (! is_preset_section(section.first)) {
+                BundleCache::Section &dst = entry.sections.emplace_back(section.first, std::vector<std::pair<std::string, std::string>>());
+                for (const auto &kvp : section.second)
+                    dst.second.emplace_back(kvp.first, kvp.second.data());
+            }
+        entry.presets = std::move(cached_presets);
+        BundleCache::store(path, entry);
+    }
+
     update_alias_maps();
 
     return std::make_pair(std::move(substitutions), presets_loaded + ph_printers_loaded);
@@ -203,6 +203,9 @@ public:
 
 private:
     std::pair<PresetsConfigSubstitutions, std::string> load_system_presets(ForwardCompatibilitySubstitutionRule compatibility_rule);
+    // Load the presets of a system config bundle from the binary cache of the resolved presets.
+    // Returns false and leaves this PresetBundle untouched if the cache entry is missing or outdated.
+    bool                        load_configbundle_from_cache(const std::string &path, size_t &presets_loaded);
     // Merge one vendor's presets with the other vendor's presets, report duplicates.
     std::vector<std::string>    merge_presets(PresetBundle &&other);
     // Update renamed_from and alias maps of system profiles.
@@ -29,8 +29,10 @@
 #include "Flow.hpp"
 #include "Geometry/ConvexHull.hpp"
 #include "I18N.hpp"
+#include "LayerSpill.hpp"
 #include "ShortestPath.hpp"
 #include "Thread.hpp"
+#include "Trace.hpp"
 #include "GCode.hpp"
 #include "libslic3r/GCode/WipeTower.hpp"
 #include "libslic3r/GCode/ConflictChecker.hpp"
@@ -42,12 +44,15 @@
 
 #include <algorithm>
 #include <limits>
+#include <map>
+#include <numeric>
 #include <string>
 #include <unordered_set>
 #include <boost/filesystem/path.hpp>
 #include <boost/format.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/regex.hpp>
+#include <oneapi/tbb/task_group.h>
 
 namespace Slic3r {
 
@@ -67,6 +72,7 @@ void Print::clear()
 	m_objects.clear();
     m_print_regions.clear();
     m_model.clear_objects();
+    m_wipe_tower_cache.reset();
 }
 
 // Called by Print::apply().
@@ -438,7 +444,8 @@ bool Print::sequential_print_horizontal_clearance_valid(const Print& print, Poly
         polygons->clear();
     std::vector<size_t> intersecting_idxs;
 
-	  std::map<ObjectID, Polygon> map_model_object_to_convex_hull;
+    const double clearance_radius = print.config().extruder_clearance_radius.value;
+	  std::map<ObjectID, const Polygon*> map_model_object_to_convex_hull;
 	  for (const PrintObject *print_object : print.objects()) {
 	      assert(! print_object->model_object()->instances.empty());
 	      assert(! print_object->instances().empty());
@@ -447,50 +454,64 @@ bool Print::sequential_print_horizontal_clearance_valid(const Print& print, Poly
         // Get convex hull of all printable volumes assigned to this print object.
         ModelInstance *model_instance0 = print_object->model_object()->instances.front();
 	      if (it_convex_hull == map_model_object_to_convex_hull.end()) {
-	          // Calculate the convex hull of a printable object. 
-	          // Grow convex hull with the clearance margin.
-	          // FIXME: Arrangement has different parameters for offsetting (jtMiter, limit 2)
-	          // which causes that the warning will be showed after arrangement with the
-	          // appropriate object distance. Even if I set this to jtMiter the warning still shows up.
             Geometry::Transformation trafo = model_instance0->get_transformation();
             trafo.set_offset({ 0.0, 0.0, model_instance0->get_offset().z() });
-            Polygon ch2d = print_object->model_object()->convex_hull_2d(trafo.get_matrix());
-            Polygons offs_ch2d = offset(ch2d,
-                // Shrink the extruder_clearance_radius a tiny bit, so that if the object arrangement algorithm placed the objects
-                // exactly by satisfying the extruder_clearance_radius, this test will not trigger collision.
-                float(scale_(0.5 * print.config().extruder_clearance_radius.value - BuildVolume::BedEpsilon)), jtRound, scale_(0.1));
-            // for invalid geometries the vector returned by offset() may be empty
-            if (!offs_ch2d.empty())
-                it_convex_hull = map_model_object_to_convex_hull.emplace_hint(it_convex_hull, model_object_id, offs_ch2d.front());
+            PrintObject::SequentialClearanceHull &cache = print_object->m_sequential_clearance_hull;
+            if (cache.radius != clearance_radius || ! cache.trafo.isApprox(trafo.get_matrix())) {
+	              // Calculate the convex hull of a printable object. 
+	              // Grow convex hull with the clearance margin.
+	              // FIXME: Arrangement has different parameters for offsetting (jtMiter, limit 2)
+	              // which causes that the warning will be showed after arrangement with the
+	              // appropriate object distance. Even if I set this to jtMiter the warning still shows up.
+                Polygon ch2d = print_object->model_object()->convex_hull_2d(trafo.get_matrix());
+                Polygons offs_ch2d = offset(ch2d,
+                    // Shrink the extruder_clearance_radius a tiny bit, so that if the object arrangement algorithm placed the objects
+                    // exactly by satisfying the extruder_clearance_radius, this test will not trigger collision.
+                    float(scale_(0.5 * clearance_radius - BuildVolume::BedEpsilon)), jtRound, scale_(0.1));
+                cache.trafo  = trafo.get_matrix();
+                cache.radius = clearance_radius;
+                // for invalid geometries the vector returned by offset() may be empty
+                cache.hull   = offs_ch2d.empty() ? Polygon() : std::move(offs_ch2d.front());
+            }
+            if (! cache.hull.empty())
+                it_convex_hull = map_model_object_to_convex_hull.emplace_hint(it_convex_hull, model_object_id, &cache.hull);
         }
         if (it_convex_hull != map_model_object_to_convex_hull.end()) {
             // Make a copy, so it may be rotated for instances.
-            Polygon convex_hull0 = it_convex_hull->second;
+            Polygon convex_hull0 = *it_convex_hull->second;
             const double z_diff = Geometry::rotation_diff_z(model_instance0->get_matrix(), print_object->instances().front().model_instance->get_matrix());
             if (std::abs(z_diff) > EPSILON)
                 convex_hull0.rotate(z_diff);
-            // Now we check that no instance of convex_hull intersects any of the previously checked object instances.
             for (const PrintInstance& instance : print_object->instances()) {
                 Polygon convex_hull = convex_hull0;
                 // instance.shift is a position of a centered object, while model object may not be centered.
                 // Convert the shift from the PrintObject's coordinates into ModelObject's coordinates by removing the centering offset.
                 convex_hull.translate(instance.shift - print_object->center_offset());
-                // if output needed, collect indices (inside convex_hulls_other) of intersecting hulls
-                for (size_t i = 0; i < convex_hulls_other.size(); ++i) {
-                    if (!intersection(convex_hulls_other[i], convex_hull).empty()) {
-                        if (polygons == nullptr)
-                            return false;
-                        else {
-                            intersecting_idxs.emplace_back(i);
-                            intersecting_idxs.emplace_back(convex_hulls_other.size());
-                        }
-                    }
-                }
                 convex_hulls_other.emplace_back(std::move(convex_hull));
             }
         }
     }
 
+    // Now we check that no instance hull intersects any other instance hull.
+    // Broad phase: Sweep the hulls sorted by the left side of their bounding boxes, only the hulls with overlapping
+    // bounding boxes are intersected exactly, thus plates with hundreds of distant instances are validated quickly.
+    std::vector<BoundingBox> bboxes;
+    bboxes.reserve(convex_hulls_other.size());
+    for (const Polygon &convex_hull : convex_hulls_other)
+        bboxes.emplace_back(convex_hull.bounding_box());
+    std::vector<size_t> sorted(convex_hulls_other.size());
+    std::iota(sorted.begin(), sorted.end(), 0);
+    std::sort(sorted.begin(), sorted.end(), [&bboxes](size_t l, size_t r) { return bboxes[l].min.x() < bboxes[r].min.x(); });
+    for (auto it = sorted.begin(); it != sorted.end(); ++ it)
+        for (auto it2 = std::next(it); it2 != sorted.end() && bboxes[*it2].min.x() <= bboxes[*it].max.x(); ++ it2)
+            if (bboxes[*it].overlap(bboxes[*it2]) && ! intersection(convex_hulls_other[*it], convex_hulls_other[*it2]).empty()) {
+                if (polygons == nullptr)
+                    return false;
+                // if output needed, collect indices (inside convex_hulls_other) of intersecting hulls
+                intersecting_idxs.emplace_back(*it);
+                intersecting_idxs.emplace_back(*it2);
+            }
+
     if (!intersecting_idxs.empty()) {
         // use collected indices (inside convex_hulls_other) to update output
         std::sort(intersecting_idxs.begin(), intersecting_idxs.end());
@@ -967,12 +988,43 @@ void Print::auto_assign_extruders(ModelObject* model_object) const
 }
 
 // Slicing process, running at a background thread.
+std::vector<MemoryUsageRecord> Print::memory_usage_records() const
+{
+    std::lock_guard<std::mutex> lock(m_memory_usage_mutex);
+    return m_memory_usage_records;
+}
+
+void Print::add_memory_usage_record(MemoryUsageRecord &&record)
+{
+    std::lock_guard<std::mutex> lock(m_memory_usage_mutex);
+    auto it = std::find_if(m_memory_usage_records.begin(), m_memory_usage_records.end(), [&record](const MemoryUsageRecord &r) {
+        return r.object_id == record.object_id && r.step_name == record.step_name;
+    });
+    if (it == m_memory_usage_records.end())
+        m_memory_usage_records.emplace_back(std::move(record));
+    else
+        *it = std::move(record);
+}
+
 void Print::process()
 {
     name_tbb_thread_pool_threads_set_locale();
 
     BOOST_LOG_TRIVIAL(info) << "Starting the slicing process." << log_memory_info();
+    // Each slicing process starts a new trace, the trace continues with the G-code export.
+    Trace::clear();
+    Trace::sample_memory("Starting the slicing process");
+    Trace::Scope trace("Print", "Print::process");
 
+    for (PrintObject *obj : m_objects)
+        obj->restore_spilled_layers();
+    {
+        // Drop the memory usage of the deleted objects.
+        std::lock_guard<std::mutex> lock(m_memory_usage_mutex);
+        m_memory_usage_records.erase(std::remove_if(m_memory_usage_records.begin(), m_memory_usage_records.end(), [this](const MemoryUsageRecord &record) {
+            return std::none_of(m_objects.begin(), m_objects.end(), [&record](const PrintObject *obj) { return obj->id().id == record.object_id; });
+        }), m_memory_usage_records.end());
+    }
     tbb::parallel_for(tbb::blocked_range<size_t>(0, m_objects.size(), 1), [this](const tbb::blocked_range<size_t> &range) {
         for (size_t idx = range.begin(); idx < range.end(); ++idx) {
             m_objects[idx]->make_perimeters();
@@ -981,23 +1033,65 @@ void Print::process()
         }
     }, tbb::simple_partitioner());
 
-    // The following step writes to m_shared_regions, it should not run in parallel.
-    for (PrintObject *obj : m_objects)
-        obj->generate_support_spots();
+    Trace::sample_memory("Perimeters and infill finished");
+    // The following step writes to m_shared_regions, which are shared by the PrintObjects of the same ModelObject.
+    // Only the objects sharing the same m_shared_regions are processed sequentially, the groups run in parallel.
+    {
+        std::vector<std::vector<PrintObject*>> shared_regions_groups;
+        {
+            std::map<const PrintObjectRegions*, size_t> shared_regions_to_group;
+            for (PrintObject *obj : m_objects) {
+                auto [it, inserted] = shared_regions_to_group.emplace(obj->m_shared_regions, shared_regions_groups.size());
+                if (inserted)
+                    shared_regions_groups.emplace_back();
+                shared_regions_groups[it->second].emplace_back(obj);
+            }
+        }
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, shared_regions_groups.size(), 1), [&shared_regions_groups](const tbb::blocked_range<size_t> &range) {
+            for (size_t idx = range.begin(); idx < range.end(); ++ idx)
+                for (PrintObject *obj : shared_regions_groups[idx])
+                    obj->generate_support_spots();
+        }, tbb::simple_partitioner());
+    }
     // check data from previous step, format the error message(s) and send alert to ui
     // this also has to be done sequentially.
     alert_when_supports_needed();
 
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_objects.size(), 1), [this](const tbb::blocked_range<size_t> &range) {
-        for (size_t idx = range.begin(); idx < range.end(); ++idx) {
-            PrintObject &obj = *m_objects[idx];
-            obj.generate_support_material();
-            obj.estimate_curled_extrusions();
-            obj.calculate_overhanging_perimeters();
-        }
-    }, tbb::simple_partitioner());
+    // The brim only depends on the first layers of the objects, which are final by now. Unless it has to be trimmed by a draft shield
+    // generated from the support layers, calculate the brim while the supports are being generated.
+    ExtrusionEntityCollection brim;
+    Polygons                  brim_islands_area;
+    tbb::task_group           brim_task;
+    const bool                brim_with_supports = ! this->is_step_done(psSkirtBrim) && this->has_brim() && config().draft_shield == dsDisabled;
+    if (brim_with_supports)
+        brim_task.run([this, &brim, &brim_islands_area]() {
+            Trace::Scope trace("Print", "make_brim");
+            brim = make_brim(*this, this->make_try_cancel(), brim_islands_area);
+        });
 
+    try {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_objects.size(), 1), [this](const tbb::blocked_range<size_t> &range) {
+            for (size_t idx = range.begin(); idx < range.end(); ++idx) {
+                PrintObject &obj = *m_objects[idx];
+                obj.generate_support_material();
+                obj.estimate_curled_extrusions();
+                obj.calculate_overhanging_perimeters();
+            }
+        }, tbb::simple_partitioner());
+    } catch (...) {
+        // Don't leave the brim task running on the Print being unwound.
+        brim_task.cancel();
+        brim_task.wait();
+        throw;
+    }
+    // Rethrows an exception of make_brim(), if any.
+    brim_task.wait();
+
+    Trace::sample_memory("Support material finished");
+    // None of the following steps nor the G-code export needs the intermediate layer data.
+    LayerSpill::spill_over_budget(m_objects);
     if (this->set_started(psWipeTower)) {
+        Trace::Scope trace("step", "psWipeTower");
         m_wipe_tower_data.clear();
         m_tool_ordering.clear();
         if (this->has_wipe_tower()) {
@@ -1012,6 +1106,7 @@ void Print::process()
         this->set_done(psWipeTower);
     }
     if (this->set_started(psSkirtBrim)) {
+        Trace::Scope trace("step", "psSkirtBrim");
         this->set_status(88, _u8L("Generating skirt and brim"));
 
         m_skirt.clear();
@@ -1029,7 +1124,11 @@ void Print::process()
         m_first_layer_convex_hull.points.clear();
         if (this->has_brim()) {
             Polygons islands_area;
-            m_brim = make_brim(*this, this->make_try_cancel(), islands_area);
+            if (brim_with_supports) {
+                m_brim       = std::move(brim);
+                islands_area = std::move(brim_islands_area);
+            } else
+                m_brim = make_brim(*this, this->make_try_cancel(), islands_area);
             for (Polygon &poly : union_(this->first_layer_islands(), islands_area))
                 append(m_first_layer_convex_hull.points, std::move(poly.points));
         }
@@ -1052,20 +1151,26 @@ void Print::process()
         m_wipe_tower_data.position = { m_config.wipe_tower_x, m_config.wipe_tower_y };
         m_wipe_tower_data.rotation_angle = m_config.wipe_tower_rotation_angle;
     }
-    auto conflictRes = ConflictChecker::find_inter_of_lines_in_diff_objs(objects(), m_wipe_tower_data);
+    ConflictResultOpt conflictRes;
+    {
+        Trace::Scope trace("Print", "ConflictChecker");
+        conflictRes = ConflictChecker::find_inter_of_lines_in_diff_objs(objects(), m_wipe_tower_data);
+    }
 
     m_conflict_result = conflictRes;
     if (conflictRes.has_value())
         BOOST_LOG_TRIVIAL(error) << boost::format("gcode path conflicts found between %1% and %2%") % conflictRes->_objName1 % conflictRes->_objName2;
 
     BOOST_LOG_TRIVIAL(info) << "Slicing process finished." << log_memory_info();
+    Trace::sample_memory("Slicing process finished");
 }
 
 // G-code export process, running at a background thread.
 // The export_gcode may die for various reasons (fails to process output_filename_format,
 // write error into the G-code, cannot execute post-processing scripts).
 // It is up to the caller to show an error message.
-std::string Print::export_gcode(const std::string& path_template, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb)
+std::string Print::export_gcode(const std::string& path_template, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb,
+                                GCodeProcessor::PartialResultCallback partial_result_cb)
 {
     // output everything to a G-code file
     // The following call may die if the output_filename_format template substitution fails.
@@ -1081,8 +1186,12 @@ std::string Print::export_gcode(const std::string& path_template, GCodeProcessor
     this->set_status(90, message);
 
     // Create GCode on heap, it has quite a lot of data.
-    std::unique_ptr<GCodeGenerator> gcode(new GCodeGenerator(const_cast<const Print*>(this)));
-    gcode->do_export(this, path.c_str(), result, thumbnail_cb);
+    {
+        Trace::Scope trace("step", "psGCodeExport");
+        std::unique_ptr<GCodeGenerator> gcode(new GCodeGenerator(const_cast<const Print*>(this)));
+        gcode->do_export(this, path.c_str(), result, thumbnail_cb, std::move(partial_result_cb));
+    }
+    Trace::sample_memory("G-code export finished");
 
     if (m_conflict_result.has_value())
         result->conflict_result = *m_conflict_result;
@@ -1553,23 +1662,14 @@ void Print::_make_wipe_tower()
     }
     this->throw_if_canceled();
 
-    // Initialize the wipe tower.
-    WipeTower wipe_tower(m_config, m_default_region_config, wipe_volumes, m_wipe_tower_data.tool_ordering.first_extruder());
-
-    // Set the extruder & material properties at the wipe tower object.
-    for (size_t i = 0; i < m_config.nozzle_diameter.size(); ++ i)
-        wipe_tower.set_extruder(i, m_config);
-
-    m_wipe_tower_data.priming = Slic3r::make_unique<std::vector<WipeTower::ToolChangeResult>>(
-        wipe_tower.prime((float)this->skirt_first_layer_height(), m_wipe_tower_data.tool_ordering.all_extruders(), false));
-
     // Lets go through the wipe tower layers and determine pairs of extruder changes for each
     // to pass to wipe_tower (so that it can use it for planning the layout of the tower)
+    auto cache = std::make_unique<WipeTowerCache>();
     {
         unsigned int current_extruder_id = m_wipe_tower_data.tool_ordering.all_extruders().back();
         for (auto &layer_tools : m_wipe_tower_data.tool_ordering.layer_tools()) { // for all layers
             if (!layer_tools.has_wipe_tower) continue;
-            wipe_tower.plan_toolchange((float)layer_tools.print_z, (float)layer_tools.wipe_tower_layer_height, current_extruder_id, current_extruder_id, false);
+            cache->plan.push_back({ (float)layer_tools.print_z, (float)layer_tools.wipe_tower_layer_height, current_extruder_id, current_extruder_id, 0.f });
             for (const auto extruder_id : layer_tools.extruders) {
                 const bool first_layer{&layer_tools == &m_wipe_tower_data.tool_ordering.front()};
                 const unsigned last_extruder_id{m_wipe_tower_data.tool_ordering.all_extruders().back()};
@@ -1585,8 +1685,7 @@ void Print::_make_wipe_tower()
                     volume_to_wipe += (float)m_config.filament_minimal_purge_on_wipe_tower.get_at(extruder_id);
 
                     // request a toolchange at the wipe tower with at least volume_to_wipe purging amount
-                    wipe_tower.plan_toolchange((float)layer_tools.print_z, (float)layer_tools.wipe_tower_layer_height,
-                                               current_extruder_id, extruder_id, volume_to_wipe);
+                    cache->plan.push_back({ (float)layer_tools.print_z, (float)layer_tools.wipe_tower_layer_height, current_extruder_id, extruder_id, volume_to_wipe });
                     current_extruder_id = extruder_id;
                 }
             }
@@ -1596,36 +1695,86 @@ void Print::_make_wipe_tower()
         }
     }
 
-    // Generate the wipe tower layers.
-    m_wipe_tower_data.tool_changes.reserve(m_wipe_tower_data.tool_ordering.layer_tools().size());
-    wipe_tower.generate(m_wipe_tower_data.tool_changes);
-    m_wipe_tower_data.depth = wipe_tower.get_depth();
-    m_wipe_tower_data.z_and_depth_pairs = wipe_tower.get_z_and_depth_pairs();
-    m_wipe_tower_data.brim_width = wipe_tower.get_brim_width();
-    m_wipe_tower_data.height = wipe_tower.get_wipe_tower_height();
-
-    // Unload the current filament over the purge tower.
+    // The wipe tower depends on the configuration and the planned tool changes only.
     coordf_t layer_height = m_objects.front()->config().layer_height.value;
-    if (m_wipe_tower_data.tool_ordering.back().wipe_tower_partitions > 0) {
-        // The wipe tower goes up to the last layer of the print.
-        if (wipe_tower.layer_finished()) {
-            // The wipe tower is printed to the top of the print and it has no space left for the final extruder purge.
-            // Lift Z to the next layer.
-            wipe_tower.set_layer(float(m_wipe_tower_data.tool_ordering.back().print_z + layer_height), float(layer_height), 0, false, true);
+    cache->config                   = m_config;
+    cache->default_region_config    = m_default_region_config;
+    cache->first_extruder           = m_wipe_tower_data.tool_ordering.first_extruder();
+    cache->all_extruders            = m_wipe_tower_data.tool_ordering.all_extruders();
+    cache->first_layer_height       = (float)this->skirt_first_layer_height();
+    cache->final_purge_z            = float(m_wipe_tower_data.tool_ordering.back().print_z);
+    cache->final_purge_layer_height = float(layer_height);
+    // The wipe tower goes up to the last layer of the print, otherwise the purge is performed at the last print layer.
+    cache->final_purge_lift         = m_wipe_tower_data.tool_ordering.back().wipe_tower_partitions > 0;
+
+    if (m_wipe_tower_cache &&
+        m_wipe_tower_cache->plan                     == cache->plan &&
+        m_wipe_tower_cache->first_extruder           == cache->first_extruder &&
+        m_wipe_tower_cache->all_extruders            == cache->all_extruders &&
+        m_wipe_tower_cache->first_layer_height       == cache->first_layer_height &&
+        m_wipe_tower_cache->final_purge_z            == cache->final_purge_z &&
+        m_wipe_tower_cache->final_purge_layer_height == cache->final_purge_layer_height &&
+        m_wipe_tower_cache->final_purge_lift         == cache->final_purge_lift &&
+        m_wipe_tower_cache->config.equals(cache->config) &&
+        m_wipe_tower_cache->default_region_config.equals(cache->default_region_config)) {
+        // Neither the configuration nor the planned tool changes changed, reuse the last wipe tower.
+        BOOST_LOG_TRIVIAL(debug) << "Reusing the wipe tower of the previous slicing";
+        cache = std::move(m_wipe_tower_cache);
+    } else {
+        m_wipe_tower_cache.reset();
+
+        // Initialize the wipe tower.
+        WipeTower wipe_tower(m_config, m_default_region_config, wipe_volumes, cache->first_extruder);
+
+        // Set the extruder & material properties at the wipe tower object.
+        for (size_t i = 0; i < m_config.nozzle_diameter.size(); ++ i)
+            wipe_tower.set_extruder(i, m_config);
+
+        cache->priming = wipe_tower.prime(cache->first_layer_height, cache->all_extruders, false);
+
+        for (const WipeTowerCache::ToolChange &tc : cache->plan)
+            wipe_tower.plan_toolchange(tc.print_z, tc.layer_height, tc.old_tool, tc.new_tool, tc.wipe_volume);
+
+        // Generate the wipe tower layers.
+        cache->tool_changes.reserve(m_wipe_tower_data.tool_ordering.layer_tools().size());
+        wipe_tower.generate(cache->tool_changes);
+        cache->depth = wipe_tower.get_depth();
+        cache->z_and_depth_pairs = wipe_tower.get_z_and_depth_pairs();
+        cache->brim_width = wipe_tower.get_brim_width();
+        cache->height = wipe_tower.get_wipe_tower_height();
+
+        // Unload the current filament over the purge tower.
+        if (cache->final_purge_lift) {
+            // The wipe tower goes up to the last layer of the print.
+            if (wipe_tower.layer_finished()) {
+                // The wipe tower is printed to the top of the print and it has no space left for the final extruder purge.
+                // Lift Z to the next layer.
+                wipe_tower.set_layer(float(cache->final_purge_z + layer_height), float(layer_height), 0, false, true);
+            } else {
+                // There is yet enough space at this layer of the wipe tower for the final purge.
+            }
         } else {
-            // There is yet enough space at this layer of the wipe tower for the final purge.
+            // The wipe tower does not reach the last print layer, perform the pruge at the last print layer.
+            wipe_tower.set_layer(cache->final_purge_z, float(layer_height), 0, false, true);
         }
-    } else {
-        // The wipe tower does not reach the last print layer, perform the pruge at the last print layer.
-        assert(m_wipe_tower_data.tool_ordering.back().wipe_tower_partitions == 0);
-        wipe_tower.set_layer(float(m_wipe_tower_data.tool_ordering.back().print_z), float(layer_height), 0, false, true);
+        cache->final_purge = wipe_tower.tool_change((unsigned int)(-1));
+
+        cache->used_filament_until_layer = wipe_tower.get_used_filament_until_layer();
+        cache->number_of_toolchanges = wipe_tower.get_number_of_toolchanges();
+        cache->width = wipe_tower.width();
     }
-    m_wipe_tower_data.final_purge = Slic3r::make_unique<WipeTower::ToolChangeResult>(
-        wipe_tower.tool_change((unsigned int)(-1)));
 
-    m_wipe_tower_data.used_filament_until_layer = wipe_tower.get_used_filament_until_layer();
-    m_wipe_tower_data.number_of_toolchanges = wipe_tower.get_number_of_toolchanges();
-    m_wipe_tower_data.width = wipe_tower.width();
+    m_wipe_tower_data.priming = Slic3r::make_unique<std::vector<WipeTower::ToolChangeResult>>(cache->priming);
+    m_wipe_tower_data.tool_changes = cache->tool_changes;
+    m_wipe_tower_data.depth = cache->depth;
+    m_wipe_tower_data.z_and_depth_pairs = cache->z_and_depth_pairs;
+    m_wipe_tower_data.brim_width = cache->brim_width;
+    m_wipe_tower_data.height = cache->height;
+    m_wipe_tower_data.final_purge = Slic3r::make_unique<WipeTower::ToolChangeResult>(cache->final_purge);
+    m_wipe_tower_data.used_filament_until_layer = cache->used_filament_until_layer;
+    m_wipe_tower_data.number_of_toolchanges = cache->number_of_toolchanges;
+    m_wipe_tower_data.width = cache->width;
+    m_wipe_tower_cache = std::move(cache);
     m_wipe_tower_data.first_layer_height = config().first_layer_height;
     m_wipe_tower_data.cone_angle = config().wipe_tower_cone_angle;
 }
@@ -28,6 +28,7 @@
 #include "BoundingBox.hpp"
 #include "ExtrusionEntityCollection.hpp"
 #include "Flow.hpp"
+#include "MemoryUsage.hpp"
 #include "Point.hpp"
 #include "Slicing.hpp"
 #include "SupportSpotsGenerator.hpp"
@@ -43,6 +44,7 @@
 #include <Eigen/Geometry>
 
 #include <functional>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <tcbspan/span.hpp>
@@ -56,6 +58,10 @@ class Print;
 class PrintObject;
 class SupportLayer;
 
+namespace ModelInfo {
+    struct Visibility;
+} // namespace ModelInfo
+
 namespace FillAdaptive {
     struct Octree;
     struct OctreeDeleter;
@@ -68,6 +74,13 @@ namespace FillLightning {
     using GeneratorPtr = std::unique_ptr<Generator, GeneratorDeleter>;
 }; // namespace FillLightning
 
+namespace FFFTreeSupport {
+    class TreeModelVolumes;
+    // To keep the definition of TreeModelVolumes opaque, we have to define a custom deleter.
+    struct TreeModelVolumesDeleter { void operator()(TreeModelVolumes *p); };
+    using TreeModelVolumesPtr = std::unique_ptr<TreeModelVolumes, TreeModelVolumesDeleter>;
+}; // namespace FFFTreeSupport
+
 // Print step IDs for keeping track of the print state.
 // The Print steps are applied in this order.
 enum PrintStep : unsigned int {
@@ -275,6 +288,14 @@ public:
     // Whoever will get a non-const pointer to PrintObject will be able to modify its layers.
     LayerPtrs&                   layers()               { return m_layers; }
     SupportLayerPtrs&            support_layers()       { return m_support_layers; }
+    // Collision and avoidance areas of the tree supports kept for the next run of the tree support generator.
+    FFFTreeSupport::TreeModelVolumesPtr& tree_model_volumes_cache() { return m_tree_model_volumes_cache; }
+    // Segmentation of the layers by painting kept for the next slicing of this object.
+    MMSegmentationCache&         mm_segmentation_cache() { return m_mm_segmentation_cache; }
+    // Surface visibility for the aligned seam placement. Kept over the G-code exports, validated by Seams::Placer.
+    // Only accessed by the G-code export, which is running on a single thread.
+    const std::shared_ptr<const ModelInfo::Visibility>& seam_visibility() const { return m_seam_visibility; }
+    void                         set_seam_visibility(std::shared_ptr<const ModelInfo::Visibility> visibility) const { m_seam_visibility = std::move(visibility); }
 
     // Bounding box is used to align the object infill patterns, and to calculate attractor for the rear seam.
     // The bounding box may not be quite snug.
@@ -295,6 +316,8 @@ public:
     // this value is not supposed to be compared with Layer::id
     // since they have different semantics.
     size_t 			total_layer_count() const { return this->layer_count() + this->support_layer_count(); }
+    // Estimated memory of the data of the object and support layers.
+    MemoryUsage     memory_usage() const;
     size_t 			layer_count() const { return m_layers.size(); }
     void 			clear_layers();
     const Layer* 	get_layer(int idx) const { return m_layers[idx]; }
@@ -359,6 +382,7 @@ private:
     // to be called from Print only.
     friend class Print;
     friend class PrintBaseWithState<PrintStep, psCount>;
+    friend class LayerSpill;
 
 	PrintObject(Print* print, ModelObject* model_object, const Transform3d& trafo, PrintInstances&& instances);
     ~PrintObject() override {
@@ -377,8 +401,16 @@ private:
     bool                    invalidate_all_steps();
     // Invalidate steps based on a set of parameters changed.
     // It may be called for both the PrintObjectConfig and PrintRegionConfig.
+    // If layer_ranges is not empty, the parameters changed only for the layers sliced inside layer_ranges, see invalidate_infill_in_layer_ranges().
     bool                    invalidate_state_by_config_options(
-        const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys);
+        const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys,
+        const std::vector<t_layer_height_range> &layer_ranges = {});
+    // Invalidates posInfill and its depending steps, but only the infill and ironing of the layers with slice_z inside layer_ranges
+    // will be generated again if the infill of the other layers was valid. Changing parameters of a layer range modifier
+    // consumed by the posInfill step only (for example the top fill pattern) thus does not regenerate the infill of the whole object.
+    bool                    invalidate_infill_in_layer_ranges(const std::vector<t_layer_height_range> &layer_ranges);
+    // Indices of the layers with slice_z inside layer_ranges, all layers if layer_ranges is empty.
+    std::vector<size_t>     layers_in_ranges(const std::vector<t_layer_height_range> &layer_ranges) const;
     // If ! m_slicing_params.valid, recalculate.
     void                    update_slicing_parameters();
 
@@ -397,6 +429,12 @@ private:
     void generate_support_material();
     void estimate_curled_extrusions();
     void calculate_overhanging_perimeters();
+    // Hides PrintObjectBaseWithState::set_started() to sample the allocation counters at the start of a step for account_memory().
+    bool set_started(PrintObjectStep step);
+    // Sample the memory usage once a step finished if MemoryAccounting is enabled.
+    void account_memory(const char *step_name);
+    // Reload the layer data spilled by LayerSpill if some of the PrintObject steps are to be executed again.
+    void restore_spilled_layers();
 
     void slice_volumes();
     // Has any support (not counting the raft).
@@ -434,9 +472,32 @@ private:
     // this is set to true when LayerRegion->slices is split in top/internal/bottom
     // so that next call to make_perimeters() performs a union() before computing loops
     bool                    				m_typed_slices = false;
+    // Layer ranges of which the infill resp. ironing is to be regenerated if posInfill resp. posIroning was invalidated partially.
+    // Empty if the step was invalidated for the whole object.
+    std::vector<t_layer_height_range>       m_infill_invalid_ranges;
+    std::vector<t_layer_height_range>       m_ironing_invalid_ranges;
+    // Temporary file with the layer data released by LayerSpill, empty if not spilled.
+    std::string                             m_layer_spill_path;
+    // Allocation counters at the start of the last started step.
+    AllocationCounters                      m_allocations_step_start;
+    // Convex hull of the ModelObject grown by the extruder clearance radius, cached by Print::sequential_print_horizontal_clearance_valid()
+    // for the transformation of the first ModelInstance without the XY offset and for the clearance radius,
+    // so that moving the instances over the bed does not recalculate the hull.
+    struct SequentialClearanceHull {
+        Transform3d trafo  { Transform3d::Identity() };
+        double      radius { -1. };
+        Polygon     hull;
+    };
+    mutable SequentialClearanceHull         m_sequential_clearance_hull;
 
     std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> m_adaptive_fill_octrees;
     FillLightning::GeneratorPtr m_lightning_generator;
+    // Released together with the layers or if the tree supports are not generated.
+    FFFTreeSupport::TreeModelVolumesPtr m_tree_model_volumes_cache;
+    // Kept over the slicing runs, validated by its key.
+    MMSegmentationCache                 m_mm_segmentation_cache;
+    // Seam visibility calculated by the last G-code export.
+    mutable std::shared_ptr<const ModelInfo::Visibility> m_seam_visibility;
 };
 
 
@@ -597,7 +658,10 @@ public:
 
     // Exports G-code into a file name based on the path_template, returns the file path of the generated G-code file.
     // If preview_data is not null, the preview_data is filled in for the G-code visualization (not used by the command line Slic3r).
-    std::string         export_gcode(const std::string& path_template, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb = nullptr);
+    // partial_result_cb receives snapshots of the G-code preview data while the G-code is being exported,
+    // see GCodeProcessor::set_partial_result_callback().
+    std::string         export_gcode(const std::string& path_template, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb = nullptr,
+                                     GCodeProcessor::PartialResultCallback partial_result_cb = nullptr);
 
     // methods for handling state
     bool                is_step_done(PrintStep step) const { return Inherited::is_step_done(step); }
@@ -630,9 +694,16 @@ public:
     SpanOfConstPtrs<PrintObject> objects() const { return SpanOfConstPtrs<PrintObject>(const_cast<const PrintObject* const* const>(m_objects.data()), m_objects.size()); }
     PrintObject*                get_object(size_t idx) { return const_cast<PrintObject*>(m_objects[idx]); }
     const PrintObject*          get_object(size_t idx) const { return m_objects[idx]; }
+    // Instances of ModelObjects sliced equally to another ModelObject are added to the PrintObjects of that other ModelObject,
+    // therefore the ModelObjects of the instances are searched as well.
     const PrintObject* get_print_object_by_model_object_id(ObjectID object_id) const {
         auto it = std::find_if(m_objects.begin(), m_objects.end(),
                                [object_id](const PrintObject* obj) { return obj->model_object()->id() == object_id; });
+        if (it == m_objects.end())
+            it = std::find_if(m_objects.begin(), m_objects.end(), [object_id](const PrintObject* obj) {
+                return std::any_of(obj->instances().begin(), obj->instances().end(),
+                    [object_id](const PrintInstance &instance) { return instance.model_instance->get_object()->id() == object_id; });
+            });
         return (it == m_objects.end()) ? nullptr : *it;
     }
     // PrintObject by its ObjectID, to be used to uniquely bind slicing warnings to their source PrintObjects
@@ -678,6 +749,10 @@ public:
     // Returns scaling for each axis representing shrinkage compensations in each axis.
     Vec3d shrinkage_compensation() const;
 
+    // Memory usage of the PrintObjects sampled after each of their steps finished, if MemoryAccounting is enabled.
+    // The last sample of each step of each PrintObject is kept. Safe to be called while the background processing is running.
+    std::vector<MemoryUsageRecord> memory_usage_records() const;
+
 protected:
     // Invalidates the step, and its depending steps in Print.
     bool                invalidate_step(PrintStep step);
@@ -689,6 +764,8 @@ private:
     void                _make_wipe_tower();
     void                finalize_first_layer_convex_hull();
     void                alert_when_supports_needed();
+    // Called by PrintObject::account_memory(), replaces the previous record of the same object and step.
+    void                add_memory_usage_record(MemoryUsageRecord &&record);
 
     // Islands of objects and their supports extruded at the 1st layer.
     Polygons            first_layer_islands() const;
@@ -722,6 +799,45 @@ private:
     ToolOrdering 							m_tool_ordering;
     WipeTowerData                           m_wipe_tower_data {m_tool_ordering};
 
+    // Wipe tower generated by the last _make_wipe_tower() call together with the inputs it was generated from.
+    // psWipeTower is invalidated by any change of the objects, though mostly the planned tool changes stay the same,
+    // for example if the infill of an object changed. The wipe tower G-code is reused in that case.
+    struct WipeTowerCache {
+        struct ToolChange {
+            float        print_z;
+            float        layer_height;
+            unsigned int old_tool;
+            unsigned int new_tool;
+            float        wipe_volume;
+            bool operator==(const ToolChange &rhs) const {
+                return print_z == rhs.print_z && layer_height == rhs.layer_height && old_tool == rhs.old_tool && new_tool == rhs.new_tool && wipe_volume == rhs.wipe_volume;
+            }
+        };
+        // Inputs.
+        PrintConfig                                           config;
+        PrintRegionConfig                                     default_region_config;
+        unsigned int                                          first_extruder;
+        std::vector<unsigned int>                             all_extruders;
+        float                                                 first_layer_height;
+        std::vector<ToolChange>                               plan;
+        // Z and layer height of the final purge.
+        float                                                 final_purge_z;
+        float                                                 final_purge_layer_height;
+        bool                                                  final_purge_lift;
+        // Outputs.
+        std::vector<WipeTower::ToolChangeResult>              priming;
+        std::vector<std::vector<WipeTower::ToolChangeResult>> tool_changes;
+        WipeTower::ToolChangeResult                           final_purge;
+        std::vector<std::pair<float, std::vector<float>>>     used_filament_until_layer;
+        int                                                   number_of_toolchanges;
+        float                                                 depth;
+        std::vector<std::pair<float, float>>                  z_and_depth_pairs;
+        float                                                 brim_width;
+        float                                                 height;
+        float                                                 width;
+    };
+    std::unique_ptr<WipeTowerCache>         m_wipe_tower_cache;
+
     // Estimated print time, filament consumed.
     PrintStatistics                         m_print_statistics;
 
@@ -736,6 +852,9 @@ private:
     friend class PrintObject;
 
     ConflictResultOpt m_conflict_result;
+
+    mutable std::mutex                      m_memory_usage_mutex;
+    std::vector<MemoryUsageRecord>          m_memory_usage_records;
 };
 
 } /* slic3r_Print_hpp_ */
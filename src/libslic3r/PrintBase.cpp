@@ -7,8 +7,11 @@
 
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/log/trivial.hpp>
 
 #include "I18N.hpp"
+#include "Metrics.hpp"
+#include "Trace.hpp"
 
 namespace Slic3r
 {
@@ -111,6 +114,59 @@ void PrintBase::status_update_warnings(int step, PrintStateBase::WarningLevel /*
         printf("%s warning: %s\n",  print_object ? "print_object" : "print", message.c_str());
 }
 
+void PrintBase::request_cancel(CancelStatus status)
+{
+    // Only the first request is timed, the successive ones are served by the same unwinding.
+    uint64_t not_requested = 0;
+    if (m_cancel_requested_us.compare_exchange_strong(not_requested, Trace::detail::now_microseconds()) && Metrics::enabled())
+        Metrics::count_cancellation();
+    m_cancel_status = status;
+}
+
+std::chrono::microseconds PrintBase::cancel_latency() const
+{
+    const uint64_t requested = m_cancel_requested_us.load(std::memory_order_acquire);
+    return requested == 0 ? std::chrono::microseconds::zero() : std::chrono::microseconds(Trace::detail::now_microseconds() - requested);
+}
+
+std::chrono::microseconds PrintBase::report_cancel_latency() const
+{
+    const uint64_t requested = m_cancel_requested_us.load(std::memory_order_acquire);
+    if (requested == 0)
+        return std::chrono::microseconds::zero();
+    const uint64_t now     = Trace::detail::now_microseconds();
+    const auto     latency = std::chrono::microseconds(now - requested);
+    if (latency > cancel_latency_target)
+        BOOST_LOG_TRIVIAL(warning) << "Background processing was canceled after " << latency.count() / 1000 << " ms, the target is "
+                                   << cancel_latency_target.count() << " ms. Enable the trace to find the step missing cancel points.";
+    else
+        BOOST_LOG_TRIVIAL(debug) << "Background processing was canceled after " << latency.count() / 1000 << " ms";
+    if (Trace::enabled())
+        Trace::detail::record_span("cancel", "Cancel latency", requested, now);
+    return latency;
+}
+
+void PrintBase::set_max_concurrency(size_t max_concurrency)
+{
+    if (max_concurrency != m_max_concurrency) {
+        m_max_concurrency = max_concurrency;
+        // The arena will be recreated with the new concurrency by the next execute_in_arena().
+        m_arena.reset();
+    }
+}
+
+void PrintBase::execute_in_arena(const std::function<void()> &fn)
+{
+    if (m_max_concurrency == 0) {
+        fn();
+        return;
+    }
+    if (! m_arena)
+        m_arena = std::make_unique<tbb::task_arena>(int(m_max_concurrency));
+    // Exceptions thrown by fn, including CanceledException, are rethrown by execute().
+    m_arena->execute(fn);
+}
+
 std::mutex& PrintObjectBase::state_mutex(PrintBase *print)
 { 
 	return print->state_mutex();
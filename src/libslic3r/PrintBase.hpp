@@ -11,7 +11,11 @@
 #include <string>
 #include <functional>
 #include <atomic>
+#include <chrono>
 #include <mutex>
+#include <memory>
+
+#include <oneapi/tbb/task_arena.h>
 
 #include "ObjectID.hpp"
 #include "Model.hpp"
@@ -516,10 +520,29 @@ public:
     // Has the calculation been canceled?
 	bool                       canceled() const { return m_cancel_status.load(std::memory_order_acquire) != NOT_CANCELED; }
     // Cancel the running computation. Stop execution of all the background threads.
-	void                       cancel() { m_cancel_status = CANCELED_BY_USER; }
-	void                       cancel_internal() { m_cancel_status = CANCELED_INTERNAL; }
+	void                       cancel() { this->request_cancel(CANCELED_BY_USER); }
+	void                       cancel_internal() { this->request_cancel(CANCELED_INTERNAL); }
     // Cancel the running computation. Stop execution of all the background threads.
-	void                       restart() { m_cancel_status = NOT_CANCELED; }
+	void                       restart() { m_cancel_status = NOT_CANCELED; m_cancel_requested_us = 0; }
+
+    // The cancel points (throw_if_canceled()) are to be placed densely enough for a canceled computation
+    // to unwind within this time after the cancellation was requested.
+    static constexpr std::chrono::milliseconds cancel_latency_target { 100 };
+    // Time elapsed since the first cancellation request, zero if the computation was not canceled.
+    // Measured right after the canceled process() returned, this is the latency of the cancel points.
+    std::chrono::microseconds  cancel_latency() const;
+    // To be called after the canceled process() returned: Log the cancel latency, warn if the target was exceeded
+    // and record the latency into the trace, where it overlaps the spans of the steps being unwound.
+    std::chrono::microseconds  report_cancel_latency() const;
+
+    // Limit the number of threads working on this print, zero for no limit other than the global "threads" setting.
+    // With a limit set, the print is processed inside its own TBB task arena, thus several prints processed
+    // concurrently in a single process do not starve each other. Not to be called while the print is being processed.
+    void                       set_max_concurrency(size_t max_concurrency);
+    size_t                     max_concurrency() const { return m_max_concurrency; }
+    // Call fn inside the task arena of this print. All the TBB algorithms launched by fn, including execution::for_each()
+    // and execution::reduce() with ex_tbb, run on the threads of this arena only. To be called around process() and export.
+    void                       execute_in_arena(const std::function<void()> &fn);
     // Returns true if the last step was finished with success.
     virtual bool               finished() const = 0;
 
@@ -562,7 +585,11 @@ protected:
     status_callback_type                    m_status_callback;
 
 private:
+    void                                    request_cancel(CancelStatus status);
+
     std::atomic<CancelStatus>               m_cancel_status;
+    // Trace::detail::now_microseconds() of the first cancellation request, zero if not canceled.
+    std::atomic<uint64_t>                   m_cancel_requested_us { 0 };
 
     // Callback to be evoked to stop the background processing before a state is updated.
     cancel_callback_type                    m_cancel_callback = [](){};
@@ -572,6 +599,11 @@ private:
     // while the data influencing the stage is modified.
     mutable std::mutex                      m_state_mutex;
 
+    // Zero for the global task arena, otherwise the concurrency of m_arena.
+    size_t                                  m_max_concurrency { 0 };
+    // Created lazily by execute_in_arena().
+    std::unique_ptr<tbb::task_arena>        m_arena;
+
     friend PrintTryCancel;
 };
 
@@ -780,6 +812,9 @@ protected:
         { return m_state.invalidate_multiple(il.begin(), il.end(), PrintObjectBase::cancel_callback(m_print)); }
     bool            invalidate_all_steps() 
         { return m_state.invalidate_all(PrintObjectBase::cancel_callback(m_print)); }
+    // To be called by the background processing thread, which has nothing to cancel.
+    bool            invalidate_all_steps_from_worker()
+        { std::lock_guard<std::mutex> lock(PrintObjectBase::state_mutex(m_print)); return m_state.invalidate_all([](){}); }
 
     bool            is_step_started_unguarded(PrintObjectStepEnum step) const { return m_state.is_started_unguarded(step); }
     bool            is_step_done_unguarded(PrintObjectStepEnum step) const { return m_state.is_done_unguarded(step); }
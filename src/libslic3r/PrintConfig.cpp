@@ -222,6 +222,13 @@ static inline const t_config_enum_values s_keys_map_SLASupportTreeType = {
 };
 CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(SLASupportTreeType);
 
+static const t_config_enum_values s_keys_map_SLAPreviewBooleans = {
+    {"exact",           int(SLAPreviewBooleans::Exact)},
+    {"approximate",     int(SLAPreviewBooleans::Approximate)},
+    {"auto",            int(SLAPreviewBooleans::Auto)}
+};
+CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(SLAPreviewBooleans)
+
 static const t_config_enum_values s_keys_map_BrimType = {
     {"no_brim",         btNoBrim},
     {"outer_only",      btOuterOnly},
@@ -2368,7 +2375,9 @@ void PrintConfigDef::init_fff_params()
     def->tooltip = L("If you want to process the output G-code through custom scripts, "
                    "just list their absolute paths here. Separate multiple scripts with a semicolon. "
                    "Scripts will be passed the absolute path to the G-code file as the first argument, "
-                   "and they can access the Slic3r config settings by reading environment variables.");
+                   "and they can access the Slic3r config settings by reading environment variables. "
+                   "A script prefixed with '|' is a filter, it reads the G-code on its standard input and writes "
+                   "the processed G-code to its standard output. Consecutive filters are chained into a pipeline and run concurrently.");
     def->gui_flags = "serialized";
     def->multiline = true;
     def->full_width = true;
@@ -4498,6 +4507,22 @@ void PrintConfigDef::init_sla_params()
     def->mode = comExpert;
     def->set_default_value(new ConfigOptionFloat(2.0));
 
+    def = this->add("preview_booleans", coEnum);
+    def->label = L("Preview booleans");
+    def->category = L("Advanced");
+    def->tooltip = L("How negative volumes and drain holes are subtracted from the object in the preview. "
+                     "Exact booleans may take a long time for large meshes, e.g. 3D scans. "
+                     "Approximate booleans are fast, but the preview is only as accurate as the voxel size. "
+                     "Auto uses the approximate booleans for large meshes only. "
+                     "The slices of the print are always exact.");
+    def->set_enum<SLAPreviewBooleans>({
+        { "exact",          L("Exact") },
+        { "approximate",    L("Approximate") },
+        { "auto",           L("Auto") }
+    });
+    def->mode = comExpert;
+    def->set_default_value(new ConfigOptionEnum<SLAPreviewBooleans>(SLAPreviewBooleans::Exact));
+
     def = this->add("material_print_speed", coEnum);
     def->label = L("Print speed");
     def->tooltip = L(
@@ -4516,6 +4541,15 @@ void PrintConfigDef::init_sla_params()
     def->mode = comAdvanced;
     def->set_default_value(new ConfigOptionString("SL1"));
 
+    def = this->add("sla_archive_compression_level", coInt);
+    def->label = L("Layer images compression level");
+    def->tooltip = L("Compression level of the PNG images of the layers stored in the SL1 archive, from 0 (no compression) to 10 (best compression). "
+                     "Lower levels export high resolution prints considerably faster at the cost of a larger archive.");
+    def->min = 0;
+    def->max = 10;
+    def->mode = comExpert;
+    def->set_default_value(new ConfigOptionInt(6));
+
     def = this->add("sla_output_precision", coFloat);
     def->label = L("SLA output precision");
     def->tooltip = L("Minimum resolution in nanometers");
@@ -5406,24 +5440,6 @@ std::string validate(const FullPrintConfig &cfg)
     return "";
 }
 
-// Declare and initialize static caches of StaticPrintConfig derived classes.
-#define PRINT_CONFIG_CACHE_ELEMENT_DEFINITION(r, data, CLASS_NAME) StaticPrintConfig::StaticCache<class Slic3r::CLASS_NAME> BOOST_PP_CAT(CLASS_NAME::s_cache_, CLASS_NAME);
-#define PRINT_CONFIG_CACHE_ELEMENT_INITIALIZATION(r, data, CLASS_NAME) Slic3r::CLASS_NAME::initialize_cache();
-#define PRINT_CONFIG_CACHE_INITIALIZE(CLASSES_SEQ) \
-    BOOST_PP_SEQ_FOR_EACH(PRINT_CONFIG_CACHE_ELEMENT_DEFINITION, _, BOOST_PP_TUPLE_TO_SEQ(CLASSES_SEQ)) \
-    int print_config_static_initializer() { \
-        /* Putting a trace here to avoid the compiler to optimize out this function. */ \
-        /*BOOST_LOG_TRIVIAL(trace) << "Initializing StaticPrintConfigs";*/ \
-        /* Tamas: alternative solution through a static volatile int. Boost log pollutes stdout and prevents tests from generating clean output */ \
-        static volatile int ret = 1; \
-        BOOST_PP_SEQ_FOR_EACH(PRINT_CONFIG_CACHE_ELEMENT_INITIALIZATION, _, BOOST_PP_TUPLE_TO_SEQ(CLASSES_SEQ)) \
-        return ret; \
-    }
-PRINT_CONFIG_CACHE_INITIALIZE((
-    PrintObjectConfig, PrintRegionConfig, MachineEnvelopeConfig, GCodeConfig, PrintConfig, FullPrintConfig, 
-    SLAMaterialConfig, SLAPrintConfig, SLAPrintObjectConfig, SLAPrinterConfig, SLAFullPrintConfig))
-static int print_config_static_initialized = print_config_static_initializer();
-
 CLIActionsConfigDef::CLIActionsConfigDef()
 {
     ConfigOptionDef* def;
@@ -5531,6 +5547,24 @@ CLIActionsConfigDef::CLIActionsConfigDef()
     def->label = L("Save config file");
     def->tooltip = L("Save configuration to the specified file.");
     def->set_default_value(new ConfigOptionString());
+
+    def = this->add("server", coBool);
+    def->label = L("Slicing server");
+    def->tooltip = L("Run as a persistent slicing server. Jobs are read from the standard input, one job per line, "
+                     "each line containing the actions, options and input files of a single slicing job "
+                     "in the command line syntax. Configuration loaded on the server command line is used as a base for all jobs. "
+                     "Each job is answered on the standard output by a line starting with \"ok\" or \"error\". "
+                     "The server terminates on \"quit\" or at the end of the input.");
+    def->set_default_value(new ConfigOptionBool(false));
+
+    def = this->add("coordinator", coBool);
+    def->label = L("Slicing coordinator");
+    def->tooltip = L("Read the slicing server jobs from the standard input and distribute them to slicing server worker processes, "
+                     "which process the jobs concurrently. The worker processes are started by the --worker commands, "
+                     "for example running the slicing server on a remote host sharing the file system with the coordinator, "
+                     "or as --workers local slicing servers using the configuration loaded on the coordinator command line. "
+                     "The jobs are answered in the order they were read.");
+    def->set_default_value(new ConfigOptionBool(false));
 }
 
 CLITransformConfigDef::CLITransformConfigDef()
@@ -5679,6 +5713,51 @@ CLIMiscConfigDef::CLIMiscConfigDef()
     def->tooltip = L("Sets the maximum number of threads the slicing process will use. If not defined, it will be decided automatically.");
     def->min = 1;
 
+    def = this->add("trace", coBool);
+    def->label = L("Trace the slicing process");
+    def->tooltip = L("Record a timeline of the slicing steps, print objects and parallel regions and save it next to the output file "
+                     "with the \".trace.json\" suffix added, in the Chrome trace event format (to be displayed by chrome://tracing or Perfetto). "
+                     "The GUI records the timeline if the SLIC3R_TRACE environment variable is set to 1.");
+
+    def = this->add("memory_report", coBool);
+    def->label = L("Report memory usage of the slicing steps");
+    def->tooltip = L("Estimate the memory occupied by the slices, surfaces, perimeters, infill and supports of each object after each slicing step "
+                     "and save the report next to the output file with the \".memory.json\" suffix added. "
+                     "The GUI shows the report in the System Information dialog if the SLIC3R_MEMORY_REPORT environment variable is set to 1.");
+
+    def = this->add("metrics", coString);
+    def->label = L("Metrics file");
+    def->tooltip = L("Write the metrics of the slicing jobs (numbers and durations of the jobs, durations of the print steps, "
+                     "cancellations, size of the exported files and peak memory) into this file after each job, "
+                     "in the Prometheus text exposition format, to be collected for example by the textfile collector "
+                     "of the Prometheus node exporter.");
+
+    def = this->add("slice_cache", coString);
+    def->label = L("Slice cache directory");
+    def->tooltip = L("Store the slices of the objects into this directory and reuse them when the same object is sliced "
+                     "with the same layer heights and slicing parameters again, for example with a different material profile. "
+                     "The GUI uses the directory set by the SLIC3R_SLICE_CACHE environment variable.");
+
+    def = this->add("memory_budget", coInt);
+    def->label = L("Memory budget");
+    def->tooltip = L("Once the estimated memory of the layer data of the objects exceeds this limit (in megabytes) "
+                     "after all the object steps are finished, the intermediate layer data not needed by the G-code export "
+                     "is written into temporary files. Zero disables the limit. "
+                     "The GUI uses the limit set by the SLIC3R_MEMORY_BUDGET environment variable.");
+    def->min = 0;
+    def->set_default_value(new ConfigOptionInt(0));
+
+    def = this->add("worker", coStrings);
+    def->label = L("Worker command");
+    def->tooltip = L("Command line starting a slicing server worker process of the slicing coordinator. "
+                     "The command has to run PrusaSlicer with the --server option. May be repeated to start multiple workers.");
+
+    def = this->add("workers", coInt);
+    def->label = L("Number of local workers");
+    def->tooltip = L("Number of the local slicing server worker processes of the slicing coordinator "
+                     "if no --worker command is given. If not defined, one worker is started per four hardware threads.");
+    def->min = 1;
+
     def = this->add("loglevel", coInt);
     def->label = L("Logging level");
     def->tooltip = L("Sets logging sensitivity. 0:fatal, 1:error, 2:warning, 3:info, 4:debug, 5:trace\n"
@@ -156,6 +156,17 @@ enum SLADisplayOrientation {
     sladoPortrait
 };
 
+// Backend of the booleans of the SLA preview mesh with negative volumes and drain holes.
+// The slices of the print are not affected.
+enum class SLAPreviewBooleans {
+    // CGAL booleans, falling back to voxelization if they fail.
+    Exact,
+    // Booleans of voxel grids, with resolution adapted to the size of the object.
+    Approximate,
+    // Exact for small meshes, approximate for large ones, e.g. 3D scans.
+    Auto,
+};
+
 using SLASupportTreeType = sla::SupportTreeType;
 using SLAPillarConnectionMode = sla::PillarConnectionMode;
 
@@ -247,6 +258,7 @@ CONFIG_OPTION_ENUM_DECLARE_STATIC_MAPS(SeamPosition)
 CONFIG_OPTION_ENUM_DECLARE_STATIC_MAPS(SLADisplayOrientation)
 CONFIG_OPTION_ENUM_DECLARE_STATIC_MAPS(SLAPillarConnectionMode)
 CONFIG_OPTION_ENUM_DECLARE_STATIC_MAPS(SLASupportTreeType)
+CONFIG_OPTION_ENUM_DECLARE_STATIC_MAPS(SLAPreviewBooleans)
 CONFIG_OPTION_ENUM_DECLARE_STATIC_MAPS(BrimType)
 CONFIG_OPTION_ENUM_DECLARE_STATIC_MAPS(DraftShield)
 CONFIG_OPTION_ENUM_DECLARE_STATIC_MAPS(LabelObjectsStyle)
@@ -427,6 +439,28 @@ protected:
         const std::vector<std::string>& keys()      const { return m_keys; }
         const T&                        defaults()  const { return *m_defaults; }
 
+        // Keys of options differing between two static configs of the same type.
+        // The options are accessed by their offsets, the keys are not looked up.
+        t_config_option_keys diff(const T *lhs, const T *rhs) const
+        {
+            t_config_option_keys out;
+            for (size_t i = 0; i < m_keys.size(); ++ i)
+                if (*option_at(lhs, m_offsets[i]) != *option_at(rhs, m_offsets[i]))
+                    out.emplace_back(m_keys[i]);
+            return out;
+        }
+
+        // Keys of options differing between a static config and any other config,
+        // ignoring options not present in both configs.
+        t_config_option_keys diff(const T *lhs, const ConfigBase &rhs) const
+        {
+            t_config_option_keys out;
+            for (size_t i = 0; i < m_keys.size(); ++ i)
+                if (const ConfigOption *opt = rhs.option(m_keys[i]); opt != nullptr && *option_at(lhs, m_offsets[i]) != *opt)
+                    out.emplace_back(m_keys[i]);
+            return out;
+        }
+
         // To be called during the StaticCache setup.
         // Collect option keys from m_map_name_to_offset,
         // assign default values to m_defaults.
@@ -436,6 +470,8 @@ protected:
             m_defaults = defaults;
             m_keys.clear();
             m_keys.reserve(m_map_name_to_offset.size());
+            m_offsets.clear();
+            m_offsets.reserve(m_map_name_to_offset.size());
             for (const auto &kvp : defs->options) {
                 // Find the option given the option name kvp.first by an offset from (char*)m_defaults.
                 ConfigOption *opt = this->optptr(kvp.first, m_defaults);
@@ -443,16 +479,20 @@ protected:
                     // This option is not defined by the ConfigBase of type T.
                     continue;
                 m_keys.emplace_back(kvp.first);
-                const ConfigOptionDef *def = defs->get(kvp.first);
-                assert(def != nullptr);
-                if (def->default_value)
-                    opt->set(def->default_value.get());
+                m_offsets.emplace_back((const char*)opt - (const char*)m_defaults);
+                if (kvp.second.default_value)
+                    opt->set(kvp.second.default_value.get());
             }
         }
 
     private:
+        static const ConfigOption* option_at(const T *owner, ptrdiff_t offset)
+            { return reinterpret_cast<const ConfigOption*>((const char*)owner + offset); }
+
         T                                  *m_defaults;
         std::vector<std::string>            m_keys;
+        // Offsets of the options from the owner, matching m_keys.
+        std::vector<ptrdiff_t>              m_offsets;
     };
 };
 
@@ -460,33 +500,42 @@ protected:
 public: \
     /* Overrides ConfigBase::optptr(). Find ando/or create a ConfigOption instance for a given name. */ \
     const ConfigOption*      optptr(const t_config_option_key &opt_key) const override \
-        { return s_cache_##CLASS_NAME.optptr(opt_key, this); } \
+        { return static_cache().optptr(opt_key, this); } \
     /* Overrides ConfigBase::optptr(). Find ando/or create a ConfigOption instance for a given name. */ \
     ConfigOption*            optptr(const t_config_option_key &opt_key, bool create = false) override \
-        { return s_cache_##CLASS_NAME.optptr(opt_key, this); } \
+        { return static_cache().optptr(opt_key, this); } \
     /* Overrides ConfigBase::keys(). Collect names of all configuration values maintained by this configuration store. */ \
-    t_config_option_keys     keys() const override { return s_cache_##CLASS_NAME.keys(); } \
-    const t_config_option_keys& keys_ref() const override { return s_cache_##CLASS_NAME.keys(); } \
-    static const CLASS_NAME& defaults() { assert(s_cache_##CLASS_NAME.initialized()); return s_cache_##CLASS_NAME.defaults(); } \
+    t_config_option_keys     keys() const override { return static_cache().keys(); } \
+    const t_config_option_keys& keys_ref() const override { return static_cache().keys(); } \
+    /* Hides ConfigBase::diff() by a faster variant iterating over the static options. */ \
+    t_config_option_keys     diff(const ConfigBase &other) const { return static_cache().diff(this, other); } \
+    t_config_option_keys     diff(const CLASS_NAME &other) const { return static_cache().diff(this, &other); } \
+    static const CLASS_NAME& defaults() { return static_cache().defaults(); } \
 private: \
-    friend int print_config_static_initializer(); \
-    static void initialize_cache() \
+    /* Cache object holding a key/option map, a list of option keys and a copy of this static config initialized with the defaults. */ \
+    /* It is built on first use (thread safe through the function local static) instead of during static initialization, */ \
+    /* so that a process pays only for the static configs it actually uses. */ \
+    static const StaticPrintConfig::StaticCache<CLASS_NAME>& static_cache() \
     { \
-        assert(! s_cache_##CLASS_NAME.initialized()); \
-        if (! s_cache_##CLASS_NAME.initialized()) { \
-            CLASS_NAME *inst = new CLASS_NAME(1); \
-            inst->initialize(s_cache_##CLASS_NAME, (const char*)inst); \
-            s_cache_##CLASS_NAME.finalize(inst, inst->def()); \
-        } \
+        static StaticPrintConfig::StaticCache<CLASS_NAME> cache; \
+        static const bool initialized = initialize_cache(cache); \
+        assert(initialized && cache.initialized()); \
+        (void)initialized; \
+        return cache; \
     } \
-    /* Cache object holding a key/option map, a list of option keys and a copy of this static config initialized with the defaults. */ \
-    static StaticPrintConfig::StaticCache<CLASS_NAME> s_cache_##CLASS_NAME;
+    static bool initialize_cache(StaticPrintConfig::StaticCache<CLASS_NAME> &cache) \
+    { \
+        CLASS_NAME *inst = new CLASS_NAME(1); \
+        inst->initialize(cache, (const char*)inst); \
+        cache.finalize(inst, inst->def()); \
+        return true; \
+    }
 
 #define STATIC_PRINT_CONFIG_CACHE(CLASS_NAME) \
     STATIC_PRINT_CONFIG_CACHE_BASE(CLASS_NAME) \
 public: \
     /* Public default constructor will initialize the key/option cache and the default object copy if needed. */ \
-    CLASS_NAME() { assert(s_cache_##CLASS_NAME.initialized()); *this = s_cache_##CLASS_NAME.defaults(); } \
+    CLASS_NAME() { *this = static_cache().defaults(); } \
 protected: \
     /* Protected constructor to be called when compounded. */ \
     CLASS_NAME(int) {}
@@ -552,7 +601,7 @@ protected: \
 #define PRINT_CONFIG_CLASS_DERIVED_DEFINE1(CLASS_NAME, CLASSES_PARENTS_TUPLE, PARAMETER_DEFINITION, PARAMETER_REGISTRATION, PARAMETER_HASHES, PARAMETER_EQUALS) \
 class CLASS_NAME : PRINT_CONFIG_CLASS_DERIVED_CLASS_LIST(CLASSES_PARENTS_TUPLE) { \
     STATIC_PRINT_CONFIG_CACHE_DERIVED(CLASS_NAME) \
-    CLASS_NAME() : PRINT_CONFIG_CLASS_DERIVED_INITIALIZER(CLASSES_PARENTS_TUPLE, 0) { assert(s_cache_##CLASS_NAME.initialized()); *this = s_cache_##CLASS_NAME.defaults(); } \
+    CLASS_NAME() : PRINT_CONFIG_CLASS_DERIVED_INITIALIZER(CLASSES_PARENTS_TUPLE, 0) { *this = static_cache().defaults(); } \
 public: \
     PARAMETER_DEFINITION \
     size_t hash() const throw() \
@@ -990,6 +1039,9 @@ PRINT_CONFIG_CLASS_DEFINE(
     ((ConfigOptionFloat, slice_closing_radius))
     ((ConfigOptionEnum<SlicingMode>, slicing_mode))
 
+    // Exact or approximate booleans when generating the preview mesh
+    ((ConfigOptionEnum<SLAPreviewBooleans>, preview_booleans))
+
     // Enabling or disabling support creation
     ((ConfigOptionBool,  supports_enable))
 
@@ -1267,6 +1319,7 @@ PRINT_CONFIG_CLASS_DEFINE(
     ((ConfigOptionFloat,                      min_initial_exposure_time))
     ((ConfigOptionFloat,                      max_initial_exposure_time))
     ((ConfigOptionString,                     sla_archive_format))
+    ((ConfigOptionInt,                        sla_archive_compression_level))
     ((ConfigOptionFloat,                      sla_output_precision))
     ((ConfigOptionString,                     printer_model))
 )
@@ -1559,11 +1612,11 @@ namespace cereal {
         size_t cnt = config.size();
         archive(cnt);
         for (auto it = config.cbegin(); it != config.cend(); ++it) {
-            const Slic3r::ConfigOptionDef* optdef = Slic3r::print_config_def.get(it->first);
+            const Slic3r::ConfigOptionDef* optdef = Slic3r::print_config_def.get(it->key());
             assert(optdef != nullptr);
             assert(optdef->serialization_key_ordinal > 0);
             archive(optdef->serialization_key_ordinal);
-            optdef->save_option_to_archive(archive, it->second.get());
+            optdef->save_option_to_archive(archive, it->option());
         }
     }
 }
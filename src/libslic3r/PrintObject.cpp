@@ -15,6 +15,7 @@
 #include <cmath>
 #include <functional>
 #include <map>
+#include <numeric>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -41,6 +42,8 @@
 #include "Geometry.hpp"
 #include "I18N.hpp"
 #include "Layer.hpp"
+#include "LayerSpill.hpp"
+#include "MemoryUsage.hpp"
 #include "PrintBase.hpp"
 #include "PrintConfig.hpp"
 #include "Support/SupportMaterial.hpp"
@@ -49,6 +52,7 @@
 #include "Slicing.hpp"
 #include "SurfaceCollection.hpp"
 #include "Tesselate.hpp"
+#include "Trace.hpp"
 #include "TriangleMeshSlicer.hpp"
 #include "Utils.hpp"
 #include "libslic3r/Fill/FillAdaptive.hpp"
@@ -174,6 +178,7 @@ void PrintObject::make_perimeters()
 
     if (! this->set_started(posPerimeters))
         return;
+    Trace::Scope trace("step", "posPerimeters", this->model_object()->name);
 
     m_print->set_status(20, _u8L("Generating perimeters"));
     BOOST_LOG_TRIVIAL(info) << "Generating perimeters..." << log_memory_info();
@@ -195,92 +200,137 @@ void PrintObject::make_perimeters()
     // but we don't generate any extra perimeter if fill density is zero, as they would be floating
     // inside the object - infill_only_where_needed should be the method of choice for printing
     // hollow objects
+    std::vector<size_t> extra_perimeters_regions;
     for (size_t region_id = 0; region_id < this->num_printing_regions(); ++ region_id) {
         const PrintRegion &region = this->printing_region(region_id);
-        if (! region.config().extra_perimeters || region.config().perimeters == 0 || region.config().fill_density == 0 || this->layer_count() < 2)
-            continue;
-
-        BOOST_LOG_TRIVIAL(debug) << "Generating extra perimeters for region " << region_id << " in parallel - start";
-        tbb::parallel_for(
-            tbb::blocked_range<size_t>(0, m_layers.size() - 1),
-            [this, &region, region_id](const tbb::blocked_range<size_t>& range) {
-                PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
-                for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
-                    m_print->throw_if_canceled();
-                    LayerRegion &layerm                     = *m_layers[layer_idx]->get_region(region_id);
-                    const LayerRegion &upper_layerm         = *m_layers[layer_idx+1]->get_region(region_id);
-                    const Polygons upper_layerm_polygons    = to_polygons(upper_layerm.slices().surfaces);
-                    // Filter upper layer polygons in intersection_ppl by their bounding boxes?
-                    // my $upper_layerm_poly_bboxes= [ map $_->bounding_box, @{$upper_layerm_polygons} ];
-                    const double total_loop_length      = total_length(upper_layerm_polygons);
-                    const coord_t perimeter_spacing     = layerm.flow(frPerimeter).scaled_spacing();
-                    const Flow ext_perimeter_flow       = layerm.flow(frExternalPerimeter);
-                    const coord_t ext_perimeter_width   = ext_perimeter_flow.scaled_width();
-                    const coord_t ext_perimeter_spacing = ext_perimeter_flow.scaled_spacing();
-
-                    // slice is not const because slice.extra_perimeters is being incremented.
-                    for (Surface &slice : layerm.m_slices.surfaces) {
-                        for (;;) {
-                            // compute the total thickness of perimeters
-                            const coord_t perimeters_thickness = ext_perimeter_width/2 + ext_perimeter_spacing/2
-                                + (region.config().perimeters-1 + slice.extra_perimeters) * perimeter_spacing;
-                            // define a critical area where we don't want the upper slice to fall into
-                            // (it should either lay over our perimeters or outside this area)
-                            const coord_t critical_area_depth = coord_t(perimeter_spacing * 1.5);
-                            const Polygons critical_area = diff(
-                                offset(slice.expolygon, float(- perimeters_thickness)),
-                                offset(slice.expolygon, float(- perimeters_thickness - critical_area_depth))
-                            );
-                            // check whether a portion of the upper slices falls inside the critical area
-                            const Polylines intersection = intersection_pl(to_polylines(upper_layerm_polygons), critical_area);
-                            // only add an additional loop if at least 30% of the slice loop would benefit from it
-                            if (total_length(intersection) <=  total_loop_length*0.3)
-                                break;
-                            /*
-                            if (0) {
-                                require "Slic3r/SVG.pm";
-                                Slic3r::SVG::output(
-                                    "extra.svg",
-                                    no_arrows   => 1,
-                                    expolygons  => union_ex($critical_area),
-                                    polylines   => [ map $_->split_at_first_point, map $_->p, @{$upper_layerm->slices} ],
-                                );
-                            }
-                            */
-                            ++ slice.extra_perimeters;
-                        }
-                        #ifdef DEBUG
-                            if (slice.extra_perimeters > 0)
-                                printf("  adding %d more perimeter(s) at layer %zu\n", slice.extra_perimeters, layer_idx);
-                        #endif
-                    }
+        if (region.config().extra_perimeters && region.config().perimeters > 0 && region.config().fill_density > 0 && this->layer_count() >= 2)
+            extra_perimeters_regions.emplace_back(region_id);
+    }
+    auto make_extra_perimeters = [this](const PrintRegion &region, LayerRegion &layerm, const LayerRegion &upper_layerm) {
+        const Polygons upper_layerm_polygons    = to_polygons(upper_layerm.slices().surfaces);
+        // Filter upper layer polygons in intersection_ppl by their bounding boxes?
+        // my $upper_layerm_poly_bboxes= [ map $_->bounding_box, @{$upper_layerm_polygons} ];
+        const double total_loop_length      = total_length(upper_layerm_polygons);
+        const coord_t perimeter_spacing     = layerm.flow(frPerimeter).scaled_spacing();
+        const Flow ext_perimeter_flow       = layerm.flow(frExternalPerimeter);
+        const coord_t ext_perimeter_width   = ext_perimeter_flow.scaled_width();
+        const coord_t ext_perimeter_spacing = ext_perimeter_flow.scaled_spacing();
+
+        // slice is not const because slice.extra_perimeters is being incremented.
+        for (Surface &slice : layerm.m_slices.surfaces) {
+            for (;;) {
+                // compute the total thickness of perimeters
+                const coord_t perimeters_thickness = ext_perimeter_width/2 + ext_perimeter_spacing/2
+                    + (region.config().perimeters-1 + slice.extra_perimeters) * perimeter_spacing;
+                // define a critical area where we don't want the upper slice to fall into
+                // (it should either lay over our perimeters or outside this area)
+                const coord_t critical_area_depth = coord_t(perimeter_spacing * 1.5);
+                const Polygons critical_area = diff(
+                    offset(slice.expolygon, float(- perimeters_thickness)),
+                    offset(slice.expolygon, float(- perimeters_thickness - critical_area_depth))
+                );
+                // check whether a portion of the upper slices falls inside the critical area
+                const Polylines intersection = intersection_pl(to_polylines(upper_layerm_polygons), critical_area);
+                // only add an additional loop if at least 30% of the slice loop would benefit from it
+                if (total_length(intersection) <=  total_loop_length*0.3)
+                    break;
+                /*
+                if (0) {
+                    require "Slic3r/SVG.pm";
+                    Slic3r::SVG::output(
+                        "extra.svg",
+                        no_arrows   => 1,
+                        expolygons  => union_ex($critical_area),
+                        polylines   => [ map $_->split_at_first_point, map $_->p, @{$upper_layerm->slices} ],
+                    );
                 }
+                */
+                ++ slice.extra_perimeters;
+            }
+            #ifdef DEBUG
+                if (slice.extra_perimeters > 0)
+                    printf("  adding %d more perimeter(s) at layer %zu\n", slice.extra_perimeters, layerm.layer()->id());
+            #endif
+        }
+    };
+
+    // Layers of prismatic objects often share all inputs of the perimeter generator, see Layer::perimeter_inputs_equal().
+    // Such a layer copies the perimeters of the first equal layer instead of generating them again.
+    // perimeters_source[layer_idx] == layer_idx for the layers, which generate their own perimeters.
+    std::vector<size_t> perimeters_source(m_layers.size());
+    std::iota(perimeters_source.begin(), perimeters_source.end(), 0);
+    size_t num_reused = 0;
+    {
+        // Fuzzy skin is random, spiral vase is not periodic.
+        bool reuse_perimeters = ! m_print->config().spiral_vase;
+        for (size_t region_id = 0; region_id < this->num_printing_regions(); ++ region_id)
+            if (this->printing_region(region_id).config().fuzzy_skin != FuzzySkinType::None)
+                reuse_perimeters = false;
+        if (reuse_perimeters && m_layers.size() > 2) {
+            std::vector<size_t> hashes(m_layers.size());
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, m_layers.size()), [this, &hashes](const tbb::blocked_range<size_t> &range) {
+                for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx)
+                    hashes[layer_idx] = m_layers[layer_idx]->perimeter_inputs_hash();
             });
-        m_print->throw_if_canceled();
-        BOOST_LOG_TRIVIAL(debug) << "Generating extra perimeters for region " << region_id << " in parallel - end";
+            std::unordered_map<size_t, std::vector<size_t>> sources_by_hash;
+            for (size_t layer_idx = 0; layer_idx < m_layers.size(); ++ layer_idx) {
+                std::vector<size_t> &sources = sources_by_hash[hashes[layer_idx]];
+                auto it = std::find_if(sources.begin(), sources.end(),
+                    [this, layer_idx](size_t source_idx) { return m_layers[layer_idx]->perimeter_inputs_equal(*m_layers[source_idx]); });
+                if (it == sources.end()) {
+                    sources.emplace_back(layer_idx);
+                } else {
+                    perimeters_source[layer_idx] = *it;
+                    ++ num_reused;
+                }
+            }
+            m_print->throw_if_canceled();
+        }
     }
 
+    // Extra perimeters of a layer only depend on the slices of the layer above, whose geometry is not modified by this step,
+    // and perimeters of a layer only depend on the extra perimeters of the same layer. Therefore both are calculated
+    // layer by layer in a single parallel pass, without a barrier over all the layers between them.
     BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - start";
     tbb::parallel_for(
         tbb::blocked_range<size_t>(0, m_layers.size()),
-        [this](const tbb::blocked_range<size_t>& range) {
+        [this, &extra_perimeters_regions, &make_extra_perimeters, &perimeters_source](const tbb::blocked_range<size_t>& range) {
             PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
+            Trace::Scope trace("parallel", "make_perimeters");
             for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
+                if (perimeters_source[layer_idx] != layer_idx)
+                    continue;
                 m_print->throw_if_canceled();
+                if (layer_idx + 1 < m_layers.size())
+                    for (size_t region_id : extra_perimeters_regions)
+                        make_extra_perimeters(this->printing_region(region_id), *m_layers[layer_idx]->get_region(region_id), *m_layers[layer_idx + 1]->get_region(region_id));
                 m_layers[layer_idx]->make_perimeters();
             }
         }
     );
     m_print->throw_if_canceled();
+    if (num_reused > 0) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_layers.size()), [this, &perimeters_source](const tbb::blocked_range<size_t> &range) {
+            for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx)
+                if (size_t source_idx = perimeters_source[layer_idx]; source_idx != layer_idx)
+                    m_layers[layer_idx]->copy_perimeters(*m_layers[source_idx]);
+        });
+        m_print->throw_if_canceled();
+    }
     BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - end";
+    BOOST_LOG_TRIVIAL(info) << "Perimeters of " << num_reused << " out of " << m_layers.size() << " layers reused from identical layers ("
+                            << (m_layers.empty() ? 0 : 100 * num_reused / m_layers.size()) << "%)";
 
     this->set_done(posPerimeters);
+
+    this->account_memory("posPerimeters");
 }
 
 void PrintObject::prepare_infill()
 {
     if (! this->set_started(posPrepareInfill))
         return;
+    Trace::Scope trace("step", "posPrepareInfill", this->model_object()->name);
 
     m_print->set_status(30, _u8L("Preparing infill"));
 
@@ -413,6 +463,8 @@ void PrintObject::prepare_infill()
 #endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
 
     this->set_done(posPrepareInfill);
+
+    this->account_memory("posPrepareInfill");
 }
 
 void PrintObject::clear_fills()
@@ -427,19 +479,25 @@ void PrintObject::infill()
     this->prepare_infill();
 
     if (this->set_started(posInfill)) {
+        Trace::Scope trace("step", "posInfill", this->model_object()->name);
         // TRN Status for the Print calculation 
         m_print->set_status(45, _u8L("Making infill"));
         const auto& adaptive_fill_octree = this->m_adaptive_fill_octrees.first;
         const auto& support_fill_octree = this->m_adaptive_fill_octrees.second;
 
-        BOOST_LOG_TRIVIAL(debug) << "Filling layers in parallel - start";
+        // Infill of the whole object removes the ironing of all layers.
+        if (m_infill_invalid_ranges.empty())
+            m_ironing_invalid_ranges.clear();
+        const std::vector<size_t> layer_ids = this->layers_in_ranges(m_infill_invalid_ranges);
+        BOOST_LOG_TRIVIAL(debug) << "Filling " << layer_ids.size() << " of " << m_layers.size() << " layers in parallel - start";
         tbb::parallel_for(
-            tbb::blocked_range<size_t>(0, m_layers.size()),
-            [this, &adaptive_fill_octree = adaptive_fill_octree, &support_fill_octree = support_fill_octree](const tbb::blocked_range<size_t>& range) {
+            tbb::blocked_range<size_t>(0, layer_ids.size()),
+            [this, &layer_ids, &adaptive_fill_octree = adaptive_fill_octree, &support_fill_octree = support_fill_octree](const tbb::blocked_range<size_t>& range) {
                 PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
-                for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
+                Trace::Scope trace("parallel", "make_fills");
+                for (size_t i = range.begin(); i < range.end(); ++ i) {
                     m_print->throw_if_canceled();
-                    m_layers[layer_idx]->make_fills(adaptive_fill_octree.get(), support_fill_octree.get(), this->m_lightning_generator.get());
+                    m_layers[layer_ids[i]]->make_fills(adaptive_fill_octree.get(), support_fill_octree.get(), this->m_lightning_generator.get());
                 }
             }
         );
@@ -448,34 +506,43 @@ void PrintObject::infill()
         /*  we could free memory now, but this would make this step not idempotent
         ### $_->fill_surfaces->clear for map @{$_->regions}, @{$object->layers};
         */
+        m_infill_invalid_ranges.clear();
         this->set_done(posInfill);
+        this->account_memory("posInfill");
     }
 }
 
 void PrintObject::ironing()
 {
     if (this->set_started(posIroning)) {
+        Trace::Scope trace("step", "posIroning", this->model_object()->name);
         BOOST_LOG_TRIVIAL(debug) << "Ironing in parallel - start";
+        // Ironing is appended to the fills, thus only the layers with regenerated infill are ironed if the infill was regenerated partially.
+        const std::vector<size_t> layer_ids = this->layers_in_ranges(m_ironing_invalid_ranges);
         tbb::parallel_for(
             // Ironing starting with layer 0 to support ironing all surfaces.
-            tbb::blocked_range<size_t>(0, m_layers.size()),
-            [this](const tbb::blocked_range<size_t>& range) {
+            tbb::blocked_range<size_t>(0, layer_ids.size()),
+            [this, &layer_ids](const tbb::blocked_range<size_t>& range) {
                 PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
-                for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
+                Trace::Scope trace("parallel", "make_ironing");
+                for (size_t i = range.begin(); i < range.end(); ++ i) {
                     m_print->throw_if_canceled();
-                    m_layers[layer_idx]->make_ironing();
+                    m_layers[layer_ids[i]]->make_ironing();
                 }
             }
         );
         m_print->throw_if_canceled();
         BOOST_LOG_TRIVIAL(debug) << "Ironing in parallel - end";
+        m_ironing_invalid_ranges.clear();
         this->set_done(posIroning);
+        this->account_memory("posIroning");
     }
 }
 
 void PrintObject::generate_support_spots()
 {
     if (this->set_started(posSupportSpotsSearch)) {
+        Trace::Scope trace("step", "posSupportSpotsSearch", this->model_object()->name);
         BOOST_LOG_TRIVIAL(debug) << "Searching support spots - start";
         m_print->set_status(65, _u8L("Searching support spots"));
         if (!this->shared_regions()->generated_support_points.has_value()) {
@@ -494,12 +561,14 @@ void PrintObject::generate_support_spots()
         }
         BOOST_LOG_TRIVIAL(debug) << "Searching support spots - end";
         this->set_done(posSupportSpotsSearch);
+        this->account_memory("posSupportSpotsSearch");
     }
 }
 
 void PrintObject::generate_support_material()
 {
     if (this->set_started(posSupportMaterial)) {
+        Trace::Scope trace("step", "posSupportMaterial", this->model_object()->name);
         this->clear_support_layers();
         if ((this->has_support() && m_layers.size() > 1) || (this->has_raft() && ! m_layers.empty())) {
             m_print->set_status(70, _u8L("Generating support material"));    
@@ -515,12 +584,14 @@ void PrintObject::generate_support_material()
 #endif
         }
         this->set_done(posSupportMaterial);
+        this->account_memory("posSupportMaterial");
     }
 }
 
 void PrintObject::estimate_curled_extrusions()
 {
     if (this->set_started(posEstimateCurledExtrusions)) {
+        Trace::Scope trace("step", "posEstimateCurledExtrusions", this->model_object()->name);
         if (this->print()->config().avoid_crossing_curled_overhangs ||
             std::any_of(this->print()->m_print_regions.begin(), this->print()->m_print_regions.end(),
                         [](const PrintRegion *region) { return region->config().enable_dynamic_overhang_speeds.getBool(); })) {
@@ -539,12 +610,14 @@ void PrintObject::estimate_curled_extrusions()
             BOOST_LOG_TRIVIAL(debug) << "Estimating areas with curled extrusions - end";
         }
         this->set_done(posEstimateCurledExtrusions);
+        this->account_memory("posEstimateCurledExtrusions");
     }
 }
 
 void PrintObject::calculate_overhanging_perimeters()
 {
     if (this->set_started(posCalculateOverhangingPerimeters)) {
+        Trace::Scope trace("step", "posCalculateOverhangingPerimeters", this->model_object()->name);
         BOOST_LOG_TRIVIAL(debug) << "Calculating overhanging perimeters - start";
         m_print->set_status(89, _u8L("Calculating overhanging perimeters"));
         std::vector<unsigned int>               extruders;
@@ -576,6 +649,7 @@ void PrintObject::calculate_overhanging_perimeters()
                                                                                &regions_with_dynamic_speeds](
                                                                                   const tbb::blocked_range<size_t> &range) {
                 PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
+                Trace::Scope trace("parallel", "calculate_and_split_overhanging_extrusions");
                 for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
                     auto l = m_layers[layer_idx];
                     if (l->id() == 0) { // first layer, do not split
@@ -598,6 +672,7 @@ void PrintObject::calculate_overhanging_perimeters()
             BOOST_LOG_TRIVIAL(debug) << "Calculating overhanging perimeters - end";
         }
         this->set_done(posCalculateOverhangingPerimeters);
+        this->account_memory("posCalculateOverhangingPerimeters");
     }
 }
 
@@ -662,6 +737,71 @@ void PrintObject::clear_layers()
     for (Layer *l : m_layers)
         delete l;
     m_layers.clear();
+    m_tree_model_volumes_cache.reset();
+    if (! m_layer_spill_path.empty()) {
+        LayerSpill::discard(m_layer_spill_path);
+        m_layer_spill_path.clear();
+    }
+}
+
+MemoryUsage PrintObject::memory_usage() const
+{
+    MemoryUsage out;
+    for (const Layer *layer : m_layers)
+        out += layer->memory_usage();
+    for (const SupportLayer *layer : m_support_layers)
+        out += layer->memory_usage();
+    return out;
+}
+
+bool PrintObject::set_started(PrintObjectStep step)
+{
+    if (! Inherited::set_started(step))
+        return false;
+    if (AllocationCounters::enabled() && MemoryAccounting::enabled())
+        m_allocations_step_start = AllocationCounters::now();
+    return true;
+}
+
+void PrintObject::account_memory(const char *step_name)
+{
+    if (! MemoryAccounting::enabled())
+        return;
+    const AllocationCounters allocations = AllocationCounters::now() - m_allocations_step_start;
+    MemoryUsage usage = this->memory_usage();
+    BOOST_LOG_TRIVIAL(info) << "Memory usage of " << this->model_object()->name << " after " << step_name << ": " <<
+        format_memsize_MB(usage.total()) << " (slices " << format_memsize_MB(usage.slices) << ", fill surfaces " << format_memsize_MB(usage.fill_surfaces) <<
+        ", intermediate " << format_memsize_MB(usage.intermediate) << ", perimeters " << format_memsize_MB(usage.perimeters) <<
+        ", fills " << format_memsize_MB(usage.fills) << ", support " << format_memsize_MB(usage.support) << ")";
+    if (AllocationCounters::enabled())
+        BOOST_LOG_TRIVIAL(info) << "Allocations of " << this->model_object()->name << " during " << step_name << ": " <<
+            allocations.count << " allocations, " << format_memsize_MB(allocations.bytes);
+    m_print->add_memory_usage_record({ this->id().id, this->model_object()->name, step_name, usage, allocations });
+}
+
+void PrintObject::restore_spilled_layers()
+{
+    if (m_layer_spill_path.empty())
+        return;
+    if (! this->is_step_done(posSlice)) {
+        // The object will be sliced again, the spilled data is obsolete.
+        LayerSpill::discard(m_layer_spill_path);
+        m_layer_spill_path.clear();
+        return;
+    }
+    for (int step = posPerimeters; step < posCount; ++ step)
+        if (! this->is_step_done(PrintObjectStep(step))) {
+            std::string path = std::move(m_layer_spill_path);
+            m_layer_spill_path.clear();
+            try {
+                LayerSpill::restore(*this, path);
+            } catch (const Slic3r::RuntimeError &ex) {
+                // Slice the object from scratch.
+                BOOST_LOG_TRIVIAL(error) << ex.what();
+                this->invalidate_all_steps_from_worker();
+            }
+            return;
+        }
 }
 
 Layer* PrintObject::add_layer(int id, coordf_t height, coordf_t print_z, coordf_t slice_z)
@@ -691,13 +831,16 @@ SupportLayerPtrs::iterator PrintObject::insert_support_layer(SupportLayerPtrs::i
 // Called by Print::apply().
 // This method only accepts PrintObjectConfig and PrintRegionConfig option keys.
 bool PrintObject::invalidate_state_by_config_options(
-    const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys)
+    const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys,
+    const std::vector<t_layer_height_range> &layer_ranges)
 {
     if (opt_keys.empty())
         return false;
 
     std::vector<PrintObjectStep> steps;
     bool invalidated = false;
+    // Some of the options invalidate the infill of layer_ranges only.
+    bool infill_in_layer_ranges = false;
     for (const t_config_option_key &opt_key : opt_keys) {
         if (   opt_key == "brim_width"
             || opt_key == "brim_separation"
@@ -827,7 +970,11 @@ bool PrintObject::invalidate_state_by_config_options(
             || opt_key == "infill_anchor_max"
             || opt_key == "top_infill_extrusion_width"
             || opt_key == "first_layer_extrusion_width") {
-            steps.emplace_back(posInfill);
+            // Filling a layer does not depend on the neighbor layers.
+            if (layer_ranges.empty())
+                steps.emplace_back(posInfill);
+            else
+                infill_in_layer_ranges = true;
         } else if (opt_key == "fill_pattern") {
             steps.emplace_back(posPrepareInfill);
         } else if (opt_key == "fill_density") {
@@ -909,12 +1056,55 @@ bool PrintObject::invalidate_state_by_config_options(
     sort_remove_duplicates(steps);
     for (PrintObjectStep step : steps)
         invalidated |= this->invalidate_step(step);
+    if (infill_in_layer_ranges)
+        invalidated |= this->invalidate_infill_in_layer_ranges(layer_ranges);
+    return invalidated;
+}
+
+bool PrintObject::invalidate_infill_in_layer_ranges(const std::vector<t_layer_height_range> &layer_ranges)
+{
+    // The infill is regenerated partially only if the infill of the layers outside of layer_ranges is valid:
+    // either posInfill is done or it was invalidated partially before. The same holds for ironing, which is regenerated
+    // partially only if the infill is regenerated partially.
+    const bool infill_partial  = this->is_step_done_unguarded(posInfill) || ! m_infill_invalid_ranges.empty();
+    const bool ironing_partial = infill_partial && (this->is_step_done_unguarded(posIroning) || ! m_ironing_invalid_ranges.empty());
+    std::vector<t_layer_height_range> infill_ranges  = std::move(m_infill_invalid_ranges);
+    std::vector<t_layer_height_range> ironing_ranges = std::move(m_ironing_invalid_ranges);
+    // Clears m_infill_invalid_ranges and m_ironing_invalid_ranges.
+    bool invalidated = this->invalidate_step(posInfill);
+    if (infill_partial) {
+        append(infill_ranges, layer_ranges);
+        m_infill_invalid_ranges = std::move(infill_ranges);
+    }
+    if (ironing_partial) {
+        append(ironing_ranges, layer_ranges);
+        m_ironing_invalid_ranges = std::move(ironing_ranges);
+    }
     return invalidated;
 }
 
+std::vector<size_t> PrintObject::layers_in_ranges(const std::vector<t_layer_height_range> &layer_ranges) const
+{
+    std::vector<size_t> out;
+    out.reserve(m_layers.size());
+    for (size_t layer_idx = 0; layer_idx < m_layers.size(); ++ layer_idx)
+        // Layers are assigned to the layer ranges by their slice_z, see layer_range_first(). A layer at the boundary
+        // of two ranges is conservatively considered to be inside both of them.
+        if (layer_ranges.empty() || std::any_of(layer_ranges.begin(), layer_ranges.end(),
+                [z = m_layers[layer_idx]->slice_z](const t_layer_height_range &range) { return range.first <= z && z <= range.second; }))
+            out.emplace_back(layer_idx);
+    return out;
+}
+
 bool PrintObject::invalidate_step(PrintObjectStep step)
 {
 	bool invalidated = Inherited::invalidate_step(step);
+    // The infill and ironing are regenerated for the whole object,
+    // see invalidate_infill_in_layer_ranges() for the partial invalidation.
+    if (step <= posInfill)
+        m_infill_invalid_ranges.clear();
+    if (step <= posIroning)
+        m_ironing_invalid_ranges.clear();
     
     // propagate to dependent steps
     if (step == posPerimeters) {
@@ -953,6 +1143,8 @@ bool PrintObject::invalidate_all_steps()
     bool result = Inherited::invalidate_all_steps() | m_print->invalidate_all_steps();
 	// Then reset some of the depending values.
 	m_slicing_params.valid = false;
+    m_infill_invalid_ranges.clear();
+    m_ironing_invalid_ranges.clear();
 	return result;
 }
 
@@ -960,7 +1152,8 @@ bool PrintObject::invalidate_all_steps()
 void PrintObject::cleanup()
 {
     if (this->query_reset_dirty_step_unguarded(posInfill))
-        this->clear_fills();
+        for (size_t layer_idx : this->layers_in_ranges(m_infill_invalid_ranges))
+            m_layers[layer_idx]->clear_fills();
     if (this->query_reset_dirty_step_unguarded(posSupportMaterial))
         this->clear_support_layers();
 }
@@ -1906,8 +2099,8 @@ void PrintObject::bridge_over_infill()
         }
     }
 
-    std::map<size_t, Polylines> infill_lines;
-    // SECTION to generate infill polylines
+    // SECTION to prepare the generators of the infill polylines. The infill polylines of the layer below each layer with candidates
+    // are generated on demand by the thread processing the layer and released right after, so that they are not held for all layers at once.
     {
         std::vector<std::pair<const Surface *, float>> surfaces_w_bottom_z;
         for (const auto &pair : surfaces_by_layer) {
@@ -1917,43 +2110,17 @@ void PrintObject::bridge_over_infill()
         }
 
         this->m_adaptive_fill_octrees = this->prepare_adaptive_infill_data(surfaces_w_bottom_z);
-
-        std::vector<size_t> layers_to_generate_infill;
-        for (const auto &pair : surfaces_by_layer) {
-            assert(pair.first > 0);
-            infill_lines[pair.first - 1] = {};
-            layers_to_generate_infill.push_back(pair.first - 1);
-        }
-
-        tbb::parallel_for(tbb::blocked_range<size_t>(0, layers_to_generate_infill.size()), [po = static_cast<const PrintObject *>(this),
-                                                                                            &layers_to_generate_infill,
-                                                                                            &infill_lines](tbb::blocked_range<size_t> r) {
-            PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
-            for (size_t job_idx = r.begin(); job_idx < r.end(); job_idx++) {
-                size_t lidx = layers_to_generate_infill[job_idx];
-                infill_lines.at(
-                    lidx) = po->get_layer(lidx)->generate_sparse_infill_polylines_for_anchoring(po->m_adaptive_fill_octrees.first.get(),
-                                                                                                po->m_adaptive_fill_octrees.second.get(),
-                                                                                                po->m_lightning_generator.get());
-            }
-        });
-#ifdef DEBUG_BRIDGE_OVER_INFILL
-        for (const auto &il : infill_lines) {
-            debug_draw(std::to_string(il.first) + "_infill_lines", to_lines(get_layer(il.first)->lslices), to_lines(il.second), {}, {});
-        }
-#endif
     }
 
     // cluster layers by depth needed for thick bridges. Each cluster is to be processed by single thread sequentially, so that bridges cannot appear one on another
     std::vector<std::vector<size_t>> clustered_layers_for_threads;
     float target_flow_height_factor = 0.9f;
     {
+        // note: surfaces_by_layer is ordered map
         std::vector<size_t> layers_with_candidates;
-        std::map<size_t, Polygons> layer_area_covered_by_candidates;
-        for (const auto& pair : surfaces_by_layer) {
+        for (const auto& pair : surfaces_by_layer)
             layers_with_candidates.push_back(pair.first);
-            layer_area_covered_by_candidates[pair.first] = {};
-        }
+        std::vector<Polygons> layer_area_covered_by_candidates(layers_with_candidates.size());
 
         // prepare inflated filter for each candidate on each layer. layers will be put into single thread cluster if they are close to each other (z-axis-wise)
         // and if the inflated AABB polygons overlap somewhere
@@ -1962,29 +2129,35 @@ void PrintObject::bridge_over_infill()
                                                                                             tbb::blocked_range<size_t> r) {
             PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
             for (size_t job_idx = r.begin(); job_idx < r.end(); job_idx++) {
-                size_t lidx = layers_with_candidates[job_idx];
-                for (const auto &candidate : surfaces_by_layer.at(lidx)) {
-                    Polygon candiate_inflated_aabb = get_extents(candidate.new_polys).inflated(scale_(7)).polygon();
-                    layer_area_covered_by_candidates.at(lidx) = union_(layer_area_covered_by_candidates.at(lidx),
-                                                                       Polygons{candiate_inflated_aabb});
-                }
+                Polygons candidates_inflated_aabbs;
+                for (const auto &candidate : surfaces_by_layer.at(layers_with_candidates[job_idx]))
+                    candidates_inflated_aabbs.emplace_back(get_extents(candidate.new_polys).inflated(scale_(7)).polygon());
+                layer_area_covered_by_candidates[job_idx] = union_(candidates_inflated_aabbs);
             }
         });
 
-        // note: surfaces_by_layer is ordered map
-        for (auto pair : surfaces_by_layer) {
-            if (clustered_layers_for_threads.empty() ||
-                this->get_layer(clustered_layers_for_threads.back().back())->print_z <
-                    this->get_layer(pair.first)->print_z -
-                        this->get_layer(pair.first)->regions()[0]->bridging_flow(frSolidInfill, true).height() * target_flow_height_factor -
-                        EPSILON ||
-                intersection(layer_area_covered_by_candidates[clustered_layers_for_threads.back().back()],
-                             layer_area_covered_by_candidates[pair.first])
-                    .empty()) {
-                clustered_layers_for_threads.push_back({pair.first});
-            } else {
-                clustered_layers_for_threads.back().push_back(pair.first);
+        // A layer joins the cluster of the previous layer with candidates if it is close to it and if their candidates overlap.
+        // This only depends on the pairs of the neighbor layers with candidates, thus it is evaluated in parallel.
+        std::vector<char> joins_previous_layer(layers_with_candidates.size(), false);
+        tbb::parallel_for(tbb::blocked_range<size_t>(1, std::max<size_t>(layers_with_candidates.size(), 1)), [po = static_cast<const PrintObject *>(this),
+                                                                                                                target_flow_height_factor, &layers_with_candidates,
+                                                                                                                &layer_area_covered_by_candidates, &joins_previous_layer](
+                                                                                                                   tbb::blocked_range<size_t> r) {
+            PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
+            for (size_t job_idx = r.begin(); job_idx < r.end(); job_idx++) {
+                const Layer *layer      = po->get_layer(layers_with_candidates[job_idx]);
+                const Layer *prev_layer = po->get_layer(layers_with_candidates[job_idx - 1]);
+                joins_previous_layer[job_idx] =
+                    prev_layer->print_z >= layer->print_z - layer->regions()[0]->bridging_flow(frSolidInfill, true).height() * target_flow_height_factor - EPSILON &&
+                    ! intersection(layer_area_covered_by_candidates[job_idx - 1], layer_area_covered_by_candidates[job_idx]).empty();
             }
+        });
+
+        for (size_t job_idx = 0; job_idx < layers_with_candidates.size(); ++ job_idx) {
+            if (joins_previous_layer[job_idx])
+                clustered_layers_for_threads.back().push_back(layers_with_candidates[job_idx]);
+            else
+                clustered_layers_for_threads.push_back({layers_with_candidates[job_idx]});
         }
 
 #ifdef DEBUG_BRIDGE_OVER_INFILL
@@ -2282,7 +2455,7 @@ void PrintObject::bridge_over_infill()
     tbb::parallel_for(tbb::blocked_range<size_t>(0, clustered_layers_for_threads.size()), [po = static_cast<const PrintObject *>(this),
                                                                                            target_flow_height_factor, &surfaces_by_layer,
                                                                                            &clustered_layers_for_threads,
-                                                                                           gather_areas_w_depth, &infill_lines,
+                                                                                           gather_areas_w_depth,
                                                                                            determine_bridging_angle,
                                                                                            construct_anchored_polygon](
                                                                                               tbb::blocked_range<size_t> r) {
@@ -2365,7 +2538,17 @@ void PrintObject::bridge_over_infill()
                 total_fill_area   = closing(total_fill_area, float(SCALED_EPSILON));
                 expansion_area    = closing(expansion_area, float(SCALED_EPSILON));
                 expansion_area    = intersection(expansion_area, deep_infill_area);
-                Polylines anchors = intersection_pl(infill_lines[lidx - 1], shrink(expansion_area, spacing));
+                Polylines anchors;
+                {
+                    // Infill lines of the layer below, only needed to find the anchors of this layer.
+                    Polylines infill_lines = po->get_layer(lidx - 1)->generate_sparse_infill_polylines_for_anchoring(po->m_adaptive_fill_octrees.first.get(),
+                                                                                                                po->m_adaptive_fill_octrees.second.get(),
+                                                                                                                po->m_lightning_generator.get());
+#ifdef DEBUG_BRIDGE_OVER_INFILL
+                    debug_draw(std::to_string(lidx - 1) + "_infill_lines", to_lines(po->get_layer(lidx - 1)->lslices), to_lines(infill_lines), {}, {});
+#endif
+                    anchors = intersection_pl(infill_lines, shrink(expansion_area, spacing));
+                }
                 Polygons internal_unsupported_area = shrink(deep_infill_area, spacing * 4.5);
 
 #ifdef DEBUG_BRIDGE_OVER_INFILL
@@ -2575,15 +2758,15 @@ static void apply_to_print_region_config(PrintRegionConfig &out, const DynamicPr
         }
     // 2) Copy the rest of the values.
     for (auto it = in.cbegin(); it != in.cend(); ++ it)
-        if (it->first != key_extruder)
-            if (ConfigOption* my_opt = out.option(it->first, false); my_opt != nullptr) {
-                if (one_of(it->first, keys_extruders)) {
+        if (it->key() != key_extruder)
+            if (ConfigOption* my_opt = out.option(it->key(), false); my_opt != nullptr) {
+                if (one_of(it->key(), keys_extruders)) {
                     // Ignore "default" extruders.
-                    int extruder = static_cast<const ConfigOptionInt*>(it->second.get())->value;
+                    int extruder = static_cast<const ConfigOptionInt*>(it->option())->value;
                     if (extruder > 0)
                         my_opt->setInt(extruder);
                 } else
-                    my_opt->set(it->second.get());
+                    my_opt->set(it->option());
             }
 }
 
@@ -2955,6 +3138,7 @@ void PrintObject::_generate_support_material()
     if (this->has_support() && (m_config.support_material_style == smsTree || m_config.support_material_style == smsOrganic)) {
         fff_tree_support_generate(*this, std::function<void()>([this](){ this->throw_if_canceled(); }));
     } else {
+        m_tree_model_volumes_cache.reset();
         // If support style is set to Organic however only raft will be built but no support,
         // build snug raft instead.
         PrintObjectSupportMaterial support_material(this, m_slicing_params);
@@ -3152,11 +3336,20 @@ static void project_triangles_to_slabs(SpanOfConstPtrs<Layer> layers, const inde
 void PrintObject::project_and_append_custom_facets(
         bool seam, TriangleStateType type, std::vector<Polygons>& out) const
 {
-    for (const ModelVolume* mv : this->model_object()->volumes)
-        if (mv->is_model_part()) {
-            const indexed_triangle_set custom_facets = seam
-                    ? mv->seam_facets.get_facets_strict(*mv, type)
-                    : mv->supported_facets.get_facets_strict(*mv, type);
+    const ModelVolumePtrs &volumes = this->model_object()->volumes;
+    // Reconstruct the painted triangles of the volumes in parallel, their triangle splitting trees are independent.
+    std::vector<indexed_triangle_set> custom_facets_per_volume(volumes.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, volumes.size()), [&volumes, &custom_facets_per_volume, seam, type](const tbb::blocked_range<size_t> &range) {
+        for (size_t volume_idx = range.begin(); volume_idx < range.end(); ++ volume_idx)
+            if (const ModelVolume *mv = volumes[volume_idx]; mv->is_model_part())
+                custom_facets_per_volume[volume_idx] = seam ?
+                    mv->seam_facets.get_facets_strict(*mv, type) :
+                    mv->supported_facets.get_facets_strict(*mv, type);
+    });
+
+    for (size_t volume_idx = 0; volume_idx < volumes.size(); ++ volume_idx)
+        if (const ModelVolume *mv = volumes[volume_idx]; mv->is_model_part()) {
+            const indexed_triangle_set &custom_facets = custom_facets_per_volume[volume_idx];
             if (! custom_facets.indices.empty()) {
                 if (seam)
                     project_triangles_to_slabs(this->layers(), custom_facets,
@@ -33,8 +33,10 @@
 #include "libslic3r/Polygon.hpp"
 #include "libslic3r/PrintBase.hpp"
 #include "libslic3r/PrintConfig.hpp"
+#include "libslic3r/SliceCache.hpp"
 #include "libslic3r/Slicing.hpp"
 #include "libslic3r/Surface.hpp"
+#include "libslic3r/Trace.hpp"
 #include "libslic3r/TriangleMesh.hpp"
 #include "libslic3r/TriangleMeshSlicer.hpp"
 #include "libslic3r/Utils.hpp"
@@ -84,8 +86,35 @@ static std::vector<ExPolygons> slice_volume(
             params2.trafo = params2.trafo * volume.get_matrix();
             if (params2.trafo.rotation().determinant() < 0.)
                 its_flip_triangles(its);
-            layers = slice_mesh_ex(its, zs, params2, throw_on_cancel_callback);
-            throw_on_cancel_callback();
+            // Only the layers crossing the volume produce any slices. Small volumes (typically modifiers)
+            // are sliced over their own Z extent only, the other layers are left empty.
+            // The slicer transforms the vertices in single precision, thus the extent is inflated by EPSILON.
+            const BoundingBoxf3 bbox   = volume.mesh().transformed_bounding_box(params2.trafo);
+            const size_t        zbegin = std::lower_bound(zs.begin(), zs.end(), bbox.min.z() - EPSILON, [](float z, double v) { return z < v; }) - zs.begin();
+            const size_t        zend   = std::upper_bound(zs.begin() + zbegin, zs.end(), bbox.max.z() + EPSILON, [](double v, float z) { return v < z; }) - zs.begin();
+            if (zbegin == zend)
+                return std::vector<ExPolygons>(zs.size(), ExPolygons());
+            const bool          all_zs = zbegin == 0 && zend == zs.size();
+            std::vector<float>  zs_volume;
+            if (! all_zs) {
+                zs_volume.assign(zs.begin() + zbegin, zs.begin() + zend);
+                params2.slicing_mode_normal_below_layer = params2.slicing_mode_normal_below_layer > zbegin ? params2.slicing_mode_normal_below_layer - zbegin : 0;
+            }
+            const std::vector<float> &zs_slice = all_zs ? zs : zs_volume;
+            std::string cache_key;
+            if (SliceCache::enabled())
+                cache_key = SliceCache::key(its, zs_slice, params2);
+            if (cache_key.empty() || ! SliceCache::load(cache_key, layers)) {
+                layers = slice_mesh_ex(its, zs_slice, params2, throw_on_cancel_callback);
+                throw_on_cancel_callback();
+                if (! cache_key.empty())
+                    SliceCache::store(cache_key, layers);
+            }
+            if (! all_zs) {
+                std::vector<ExPolygons> layers_volume = std::move(layers);
+                layers.assign(zs.size(), ExPolygons());
+                std::move(layers_volume.begin(), layers_volume.end(), layers.begin() + zbegin);
+            }
         }
     }
     return layers;
@@ -377,7 +406,8 @@ static std::vector<std::vector<ExPolygons>> slices_to_regions(
                                 RegionSlice &parent_slice = temp_slices[region.parent];
                                 RegionSlice &this_slice   = temp_slices[idx_region];
                                 ExPolygons   source       = std::move(this_slice.expolygons);
-                                if (parent_slice.expolygons.empty()) {
+                                // Modifier not touching its parent at this layer neither takes anything from it nor clips it.
+                                if (parent_slice.expolygons.empty() || ! get_extents(parent_slice.expolygons).overlap(get_extents(source))) {
                                     this_slice  .expolygons.clear();
                                 } else {
                                     this_slice  .expolygons = intersection_ex(parent_slice.expolygons, source);
@@ -528,6 +558,7 @@ void PrintObject::slice()
 {
     if (! this->set_started(posSlice))
         return;
+    Trace::Scope trace("step", "posSlice", this->model_object()->name);
     m_print->set_status(10, _u8L("Processing triangulated mesh"));
     std::vector<coordf_t> layer_height_profile;
     this->update_layer_height_profile(*this->model_object(), m_slicing_params, layer_height_profile);
@@ -575,13 +606,14 @@ void PrintObject::slice()
     if (m_layers.empty())
         throw Slic3r::SlicingError("No layers were detected. You might want to repair your STL file(s) or check their size or thickness and retry.\n");    
     this->set_done(posSlice);
+    this->account_memory("posSlice");
 }
 
 template<typename ThrowOnCancel>
 void apply_mm_segmentation(PrintObject &print_object, ThrowOnCancel throw_on_cancel)
 {
     // Returns MMU segmentation based on painting in MMU segmentation gizmo
-    std::vector<std::vector<ExPolygons>> segmentation = multi_material_segmentation_by_painting(print_object, throw_on_cancel);
+    std::vector<std::vector<ExPolygons>> segmentation = multi_material_segmentation_by_painting(print_object, throw_on_cancel, &print_object.mm_segmentation_cache());
     assert(segmentation.size() == print_object.layer_count());
     tbb::parallel_for(
         tbb::blocked_range<size_t>(0, segmentation.size(), std::max(segmentation.size() / 128, size_t(1))),
@@ -6,6 +6,9 @@
 
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/parallel_invoke.h>
+#include <mutex>
+#include <numeric>
 #include <tuple>
 #include <optional>
 #include <algorithm>
@@ -99,6 +102,7 @@ namespace QuadricEdgeCollapse {
     struct VertexInfo {
         SymMat q; // sum quadric of surround triangles
         uint32_t start = 0, count = 0; // vertex neighbor triangles
+        bool locked = false; // edges of locked vertex are never collapsed
         VertexInfo() = default;
         bool is_deleted() const { return count == 0; }
     };
@@ -132,7 +136,11 @@ namespace QuadricEdgeCollapse {
     double vertex_error(const SymMat &q, const Vec3d &vertex);
     SymMat create_quadric(const Triangle &t, const Vec3d& n, const Vertices &vertices);
     std::tuple<TriangleInfos, VertexInfos, EdgeInfos, Errors> 
-    init(const indexed_triangle_set &its, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn);
+    init(const indexed_triangle_set &its, const std::vector<bool> &locked, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn);
+    // Collapse edges of its until triangle_count or maximal_error is reached, returns the last collapsed error.
+    // locked is either empty or it marks vertices, which must not be moved nor removed.
+    float simplify(indexed_triangle_set &its, uint32_t triangle_count, float maximal_error,
+        const std::vector<bool> &locked, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn);
     std::optional<uint32_t> find_triangle_index1(uint32_t vi, const VertexInfo& v_info,
         uint32_t ti, const EdgeInfos& e_infos, const Indices& indices);
     void reorder_edges(EdgeInfos &e_infos, const VertexInfo &v_info, uint32_t ti0, uint32_t ti1);
@@ -169,6 +177,9 @@ namespace QuadricEdgeCollapse {
     const int status_set_offsets = 10;
     const int status_calc_errors = 30;
     const int status_create_refs = 10;
+    // partitioned simplification
+    const size_t min_cell_triangle_count = 100000;
+    const int status_cells_size = 80; // in percents, the rest is the pass over the seams
     } // namespace QuadricEdgeCollapse
 
 using namespace QuadricEdgeCollapse;
@@ -187,6 +198,17 @@ void Slic3r::its_quadric_edge_collapse(
     if (throw_on_cancel == nullptr) throw_on_cancel = []() {};
     if (status_fn == nullptr) status_fn = [](int) {};
 
+    float last_collapsed_error = simplify(its, triangle_count, maximal_error, {}, throw_on_cancel, status_fn);
+    if (max_error != nullptr) *max_error = last_collapsed_error;
+}
+
+float QuadricEdgeCollapse::simplify(indexed_triangle_set &its,
+                                    uint32_t              triangle_count,
+                                    float                 maximal_error,
+                                    const std::vector<bool> &locked,
+                                    ThrowOnCancel &       throw_on_cancel,
+                                    StatusFn &            status_fn)
+{
     StatusFn init_status_fn = [&](int percent) {
         float n_percent = percent * status_init_size / 100.f;
         status_fn(static_cast<int>(std::round(n_percent)));
@@ -196,7 +218,7 @@ void Slic3r::its_quadric_edge_collapse(
     VertexInfos   v_infos;
     EdgeInfos     e_infos;
     Errors        errors;
-    std::tie(t_infos, v_infos, e_infos, errors) = init(its, throw_on_cancel, init_status_fn);
+    std::tie(t_infos, v_infos, e_infos, errors) = init(its, locked, throw_on_cancel, init_status_fn);
     throw_on_cancel();
     status_fn(status_init_size);
 
@@ -359,6 +381,188 @@ void Slic3r::its_quadric_edge_collapse(
 
     // compact triangle
     compact(v_infos, t_infos, e_infos, its);
+    return last_collapsed_error;
+}
+
+void Slic3r::its_quadric_edge_collapse_partitioned(
+    indexed_triangle_set &    its,
+    uint32_t                  triangle_count,
+    float *                   max_error,
+    std::function<void(void)> throw_on_cancel,
+    std::function<void(int)>  status_fn,
+    size_t                    cell_count)
+{
+    // check input
+    if (triangle_count >= its.indices.size()) return;
+    float maximal_error = (max_error == nullptr)? std::numeric_limits<float>::max() : *max_error;
+    if (maximal_error <= 0.f) return;
+    if (throw_on_cancel == nullptr) throw_on_cancel = []() {};
+    if (status_fn == nullptr) status_fn = [](int) {};
+
+    // The cost of the collapse grows faster than linearly with the mesh size, thus the cells
+    // are kept small even if there are not that many threads.
+    if (cell_count == 0)
+        cell_count = its.indices.size() / min_cell_triangle_count;
+    if (cell_count < 2) {
+        its_quadric_edge_collapse(its, triangle_count, max_error, throw_on_cancel, status_fn);
+        return;
+    }
+
+    // Split triangles into spatial cells of similar size by recursive median bisection of their centroids.
+    std::vector<Vec3f> centroids(its.indices.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size()),
+    [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            const Triangle &t = its.indices[i];
+            centroids[i] = (its.vertices[t[0]] + its.vertices[t[1]] + its.vertices[t[2]]) / 3.f;
+        }
+    }); // END parallel for
+    std::vector<uint32_t> order(its.indices.size());
+    std::iota(order.begin(), order.end(), 0);
+    // cells[i] .. cells[i + 1] is a range of order
+    std::vector<size_t> cells(cell_count + 1, its.indices.size());
+    cells.front() = 0;
+    std::function<void(size_t, size_t, size_t, size_t)> bisect =
+        [&](size_t begin, size_t end, size_t first_cell, size_t num_cells) {
+        if (num_cells == 1) {
+            cells[first_cell] = begin;
+            return;
+        }
+        Vec3f bmin = centroids[order[begin]], bmax = bmin;
+        for (size_t i = begin + 1; i < end; ++i) {
+            bmin = bmin.cwiseMin(centroids[order[i]]);
+            bmax = bmax.cwiseMax(centroids[order[i]]);
+        }
+        int axis;
+        (bmax - bmin).maxCoeff(&axis);
+        size_t num_left = num_cells / 2;
+        size_t middle   = begin + (end - begin) * num_left / num_cells;
+        std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+            [&centroids, axis](uint32_t ti1, uint32_t ti2) { return centroids[ti1][axis] < centroids[ti2][axis]; });
+        tbb::parallel_invoke(
+            [&] { bisect(begin, middle, first_cell, num_left); },
+            [&] { bisect(middle, end, first_cell + num_left, num_cells - num_left); });
+    };
+    bisect(0, its.indices.size(), 0, cell_count);
+    centroids = {};
+    throw_on_cancel();
+
+    // Vertices shared by triangles of more cells are locked.
+    const uint32_t      no_cell = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> vertex_cells(its.vertices.size(), no_cell);
+    std::vector<bool>     locked(its.vertices.size(), false);
+    for (size_t cell = 0; cell < cell_count; ++cell)
+        for (size_t i = cells[cell]; i < cells[cell + 1]; ++i)
+            for (int j = 0; j < 3; ++j) {
+                uint32_t &vertex_cell = vertex_cells[its.indices[order[i]][j]];
+                if (vertex_cell == no_cell)
+                    vertex_cell = uint32_t(cell);
+                else if (vertex_cell != cell)
+                    locked[its.indices[order[i]][j]] = true;
+            }
+    vertex_cells = {};
+
+    struct Cell {
+        indexed_triangle_set its;
+        // global indices of the locked vertices, which are the first vertices of its
+        std::vector<uint32_t> locked_vertices;
+        float last_collapsed_error = 0.f;
+    };
+    std::vector<Cell> simplified(cell_count);
+    double     ratio = triangle_count / double(its.indices.size());
+    std::mutex status_mutex;
+    size_t     finished_cells = 0;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, cell_count, 1),
+    [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t cell = range.begin(); cell < range.end(); ++cell) {
+            Cell &out = simplified[cell];
+            // local vertex indices, locked vertices first
+            std::vector<uint32_t> vertices;
+            vertices.reserve(3 * (cells[cell + 1] - cells[cell]));
+            for (size_t i = cells[cell]; i < cells[cell + 1]; ++i)
+                for (int j = 0; j < 3; ++j)
+                    vertices.emplace_back(its.indices[order[i]][j]);
+            sort_remove_duplicates(vertices);
+            std::vector<uint32_t> local(vertices.size());
+            std::vector<bool>     cell_locked;
+            uint32_t              num_locked = 0;
+            for (uint32_t vi : vertices)
+                num_locked += locked[vi];
+            cell_locked.assign(vertices.size(), false);
+            std::fill(cell_locked.begin(), cell_locked.begin() + num_locked, true);
+            out.locked_vertices.reserve(num_locked);
+            out.its.vertices.resize(vertices.size());
+            for (uint32_t i = 0, next_unlocked = num_locked; i < vertices.size(); ++i) {
+                uint32_t vi = vertices[i];
+                if (locked[vi]) {
+                    local[i] = out.locked_vertices.size();
+                    out.locked_vertices.emplace_back(vi);
+                } else
+                    local[i] = next_unlocked++;
+                out.its.vertices[local[i]] = its.vertices[vi];
+            }
+            // triangles touching a locked vertex are not reduced in the cell, but by the pass over the seams
+            size_t num_seam_triangles = 0;
+            out.its.indices.reserve(cells[cell + 1] - cells[cell]);
+            for (size_t i = cells[cell]; i < cells[cell + 1]; ++i) {
+                const Triangle &t = its.indices[order[i]];
+                Triangle       &lt = out.its.indices.emplace_back();
+                for (int j = 0; j < 3; ++j)
+                    lt[j] = local[std::lower_bound(vertices.begin(), vertices.end(), uint32_t(t[j])) - vertices.begin()];
+                num_seam_triangles += lt[0] < int(num_locked) || lt[1] < int(num_locked) || lt[2] < int(num_locked);
+            }
+
+            auto cell_triangle_count = uint32_t(std::round(ratio * (out.its.indices.size() - num_seam_triangles))) + num_seam_triangles;
+            if (cell_triangle_count < out.its.indices.size()) {
+                StatusFn no_status = [](int) {};
+                out.last_collapsed_error = simplify(out.its, cell_triangle_count, maximal_error, cell_locked, throw_on_cancel, no_status);
+            }
+            assert(out.its.vertices.size() >= num_locked);
+
+            std::lock_guard lk(status_mutex);
+            status_fn(int(++finished_cells * status_cells_size / cell_count));
+        }
+    }); // END parallel for
+    order = {};
+    throw_on_cancel();
+
+    // Stitch the cells back together through the locked vertices.
+    float last_collapsed_error = 0.f;
+    std::vector<uint32_t> global_to_out(its.vertices.size(), std::numeric_limits<uint32_t>::max());
+    its.vertices.clear();
+    its.indices.clear();
+    for (Cell &cell : simplified) {
+        std::vector<uint32_t> local_to_out(cell.its.vertices.size());
+        for (size_t i = 0; i < cell.its.vertices.size(); ++i) {
+            if (i < cell.locked_vertices.size()) {
+                // locked vertex is shared with other cells, its position is not changed
+                uint32_t &out_idx = global_to_out[cell.locked_vertices[i]];
+                if (out_idx == std::numeric_limits<uint32_t>::max()) {
+                    out_idx = its.vertices.size();
+                    its.vertices.emplace_back(cell.its.vertices[i]);
+                }
+                local_to_out[i] = out_idx;
+            } else {
+                local_to_out[i] = its.vertices.size();
+                its.vertices.emplace_back(cell.its.vertices[i]);
+            }
+        }
+        for (const Triangle &t : cell.its.indices)
+            its.indices.emplace_back(local_to_out[t[0]], local_to_out[t[1]], local_to_out[t[2]]);
+        last_collapsed_error = std::max(last_collapsed_error, cell.last_collapsed_error);
+        cell = {};
+    }
+    global_to_out = {};
+
+    // Simplify the seams together with the rest of the mesh.
+    if (triangle_count < its.indices.size()) {
+        StatusFn seam_status_fn = [&status_fn](int percent) {
+            status_fn(status_cells_size + percent * (100 - status_cells_size) / 100);
+        };
+        last_collapsed_error = std::max(last_collapsed_error,
+            simplify(its, triangle_count, maximal_error, {}, throw_on_cancel, seam_status_fn));
+    }
+    status_fn(100);
     if (max_error != nullptr) *max_error = last_collapsed_error;
 }
 
@@ -454,7 +658,7 @@ SymMat QuadricEdgeCollapse::create_quadric(const Triangle &t,
 }
 
 std::tuple<TriangleInfos, VertexInfos, EdgeInfos, Errors> 
-QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn)
+QuadricEdgeCollapse::init(const indexed_triangle_set &its, const std::vector<bool> &locked, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn)
 {
     int status_offset = 0;
     TriangleInfos t_infos(its.indices.size());
@@ -496,12 +700,15 @@ QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_
     } // remove triangle quadrics
 
     // set offseted starts
+    assert(locked.empty() || locked.size() == v_infos.size());
     uint32_t triangle_start = 0;
-    for (VertexInfo &v_info : v_infos) {
+    for (size_t vi = 0; vi < v_infos.size(); ++vi) {
+        VertexInfo &v_info = v_infos[vi];
         v_info.start = triangle_start;
         triangle_start += v_info.count;
         // set filled vertex to zero
         v_info.count = 0;
+        v_info.locked = !locked.empty() && locked[vi];
     }
     assert(its.indices.size() * 3 == triangle_start);
 
@@ -723,6 +930,11 @@ Vec3d QuadricEdgeCollapse::calculate_3errors(const Triangle &   t,
         size_t   j2  = (j == 2) ? 0 : (j + 1);
         uint32_t vi0 = t[j];
         uint32_t vi1 = t[j2];
+        if (v_infos[vi0].locked || v_infos[vi1].locked) {
+            // never collapse, it is bigger than any maximal error
+            error[j] = std::numeric_limits<double>::infinity();
+            continue;
+        }
         SymMat   q(v_infos[vi0].q); // copy
         q += v_infos[vi1].q;
         error[j] = calculate_error(vi0, vi1, q, vertices);
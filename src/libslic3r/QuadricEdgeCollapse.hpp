@@ -36,6 +36,23 @@ void its_quadric_edge_collapse(
     std::function<void(void)> throw_on_cancel = nullptr,
     std::function<void(int)>  statusfn        = nullptr);
 
+/// <summary>
+/// Simplify mesh by Quadric metric, large meshes are split into spatial cells
+/// simplified concurrently. Vertices shared by more cells are locked, the seams
+/// between the cells are simplified by a final pass over the whole mesh.
+/// Much faster for large meshes, e.g. 3D scans, with a similar quality.
+/// </summary>
+/// <param name="cell_count">Number of the cells, 0 to select by the mesh size.
+/// Meshes too small to be split are simplified by its_quadric_edge_collapse().</param>
+/// Other parameters are the same as for its_quadric_edge_collapse().
+void its_quadric_edge_collapse_partitioned(
+    indexed_triangle_set &    its,
+    uint32_t                  triangle_count  = 0,
+    float *                   max_error       = nullptr,
+    std::function<void(void)> throw_on_cancel = nullptr,
+    std::function<void(int)>  statusfn        = nullptr,
+    size_t                    cell_count      = 0);
+
 } // namespace Slic3r
 #endif // slic3r_quadric_edge_collapse_hpp_
 
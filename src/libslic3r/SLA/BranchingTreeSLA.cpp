@@ -9,7 +9,9 @@
 #include <boost/log/trivial.hpp>
 #include <map>
 #include <algorithm>
+#include <memory>
 #include <mutex>
+#include <numeric>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -375,7 +377,7 @@ void create_branching_tree(SupportTreeBuilder &builder, const SupportableMesh &s
     auto coordfn = [&sm](size_t id, size_t dim) { return sm.pts[id].pos(dim); };
     KDTreeIndirect<3, float, decltype (coordfn)> tree{coordfn, sm.pts.size()};
 
-    auto nondup_idx = non_duplicate_suppt_indices(tree, sm.pts, 0.1);
+    auto nondup_idx = non_duplicate_suppt_indices(ex_tbb, tree, sm.pts, 0.1);
     std::vector<std::optional<Head>> heads(nondup_idx.size());
     auto leafs = reserve_vector<branchingtree::Node>(nondup_idx.size());
 
@@ -419,26 +421,79 @@ void create_branching_tree(SupportTreeBuilder &builder, const SupportableMesh &s
     for (auto &bp : bedpts)
         bp.Rmin = sm.cfg.head_back_radius_mm;
 
-    branchingtree::PointCloud nodes{std::move(meshpts), std::move(bedpts),
-                                    std::move(leafs), props};
-
-    BranchingTreeBuilder vbuilder{builder, sm, nodes};
-
-    execution::for_each(ex_tbb,
-                        size_t(0),
-                        nodes.get_leafs().size(),
-                        [&nodes, &vbuilder](size_t leaf_idx) {
-                            vbuilder.suggest_avoidance(nodes.get_leafs()[leaf_idx],
-                                                       nodes.properties().max_branch_length());
-                        });
+    // Clusters of support points far from each other are routed in
+    // parallel, each with its own point cloud.
+    struct ClusterTree {
+        // Ids of the heads of the leafs of the cloud.
+        std::vector<size_t>       head_ids;
+        branchingtree::PointCloud nodes;
+        BranchingTreeBuilder      vbuilder;
+
+        ClusterTree(SupportTreeBuilder              &builder,
+                    const SupportableMesh           &sm,
+                    std::vector<size_t>              ids,
+                    std::vector<branchingtree::Node> meshpts,
+                    std::vector<branchingtree::Node> bedpts,
+                    std::vector<branchingtree::Node> leafs,
+                    const branchingtree::Properties &props)
+            : head_ids{std::move(ids)}
+            , nodes{std::move(meshpts), std::move(bedpts), std::move(leafs), props}
+            , vbuilder{builder, sm, nodes}
+        {}
+    };
+
+    std::vector<branchingtree::LeafCluster> clusters = branchingtree::cluster_leafs(leafs, props);
+    std::vector<std::unique_ptr<ClusterTree>> trees;
+
+    if (clusters.size() < 2) {
+        std::vector<size_t> ids(leafs.size());
+        std::iota(ids.begin(), ids.end(), size_t(0));
+        trees.emplace_back(std::make_unique<ClusterTree>(builder, sm, std::move(ids),
+                                                         std::move(meshpts), std::move(bedpts),
+                                                         std::move(leafs), props));
+    } else {
+        // The regions of the clusters don't overlap, each mesh or bed point
+        // is needed by a single cluster at most.
+        auto select_pts = [](const std::vector<branchingtree::Node> &pts, const BoundingBoxf &region) {
+            std::vector<branchingtree::Node> ret;
+            for (const branchingtree::Node &n : pts)
+                if (region.contains(to_2d(n.pos).cast<double>()))
+                    ret.emplace_back(n);
+            return ret;
+        };
+
+        trees.reserve(clusters.size());
+        for (branchingtree::LeafCluster &cluster : clusters) {
+            auto cluster_leafs = reserve_vector<branchingtree::Node>(cluster.leafs.size());
+            for (size_t id : cluster.leafs)
+                cluster_leafs.emplace_back(leafs[id]);
+
+            trees.emplace_back(std::make_unique<ClusterTree>(builder, sm, std::move(cluster.leafs),
+                                                             select_pts(meshpts, cluster.region),
+                                                             select_pts(bedpts, cluster.region),
+                                                             std::move(cluster_leafs), props));
+        }
+    }
 
-    branchingtree::build_tree(nodes, vbuilder);
+    execution::for_each(ex_tbb, size_t(0), trees.size(), [&trees](size_t tree_idx) {
+        ClusterTree &tree = *trees[tree_idx];
+        execution::for_each(ex_tbb,
+                            size_t(0),
+                            tree.nodes.get_leafs().size(),
+                            [&tree](size_t leaf_idx) {
+                                tree.vbuilder.suggest_avoidance(tree.nodes.get_leafs()[leaf_idx],
+                                                                tree.nodes.properties().max_branch_length());
+                            });
 
-    build_pillars(builder, vbuilder, sm);
+        branchingtree::build_tree(tree.nodes, tree.vbuilder);
+    }, size_t(1));
 
-    for (size_t id : vbuilder.unroutable_pinheads())
-        builder.head(id).invalidate();
+    for (const std::unique_ptr<ClusterTree> &tree : trees) {
+        build_pillars(builder, tree->vbuilder, sm);
 
+        for (size_t id : tree->vbuilder.unroutable_pinheads())
+            builder.head(tree->head_ids[id]).invalidate();
+    }
 }
 
 }} // namespace Slic3r::sla
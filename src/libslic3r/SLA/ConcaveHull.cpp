@@ -11,6 +11,7 @@
 #include "libslic3r/ClipperUtils.hpp"
 #include "libslic3r/ExPolygon.hpp"
 #include "libslic3r/Line.hpp"
+#include "libslic3r/Execution/ExecutionTBB.hpp"
 
 namespace Slic3r {
 namespace sla {
@@ -49,11 +50,10 @@ Point ConcaveHull::centroid(const Points &pp)
 Points ConcaveHull::calculate_centroids() const
 {
     // We get the centroids of all the islands in the 2D slice
-    Points centroids;
-    centroids.reserve(m_polys.size());
-    std::transform(m_polys.begin(), m_polys.end(),
-                   std::back_inserter(centroids),
-                   [](const Polygon &poly) { return centroid(poly); });
+    Points centroids(m_polys.size());
+    execution::for_each(ex_tbb, size_t(0), m_polys.size(),
+                        [this, &centroids](size_t idx) { centroids[idx] = centroid(m_polys[idx]); },
+                        execution::max_concurrency(ex_tbb));
 
     return centroids;
 }
@@ -68,13 +68,30 @@ void ConcaveHull::add_connector_rectangles(const Points &centroids,
     // connector sticks are routed.
     Point cc = centroid(centroids);
 
-    PointIndex ctrindex;
-    unsigned  idx = 0;
-    for(const Point &ct : centroids) ctrindex.insert(to_vec3(ct), idx++);
+    std::vector<PointIndexEl> elements;
+    std::vector<Vec3d>        queries;
+    elements.reserve(centroids.size());
+    queries.reserve(centroids.size());
+    for (const Point &ct : centroids) {
+        elements.emplace_back(to_vec3(ct), unsigned(elements.size()));
+        queries.emplace_back(to_vec3(ct));
+    }
+    PointIndex ctrindex(elements);
 
     m_polys.reserve(m_polys.size() + centroids.size());
 
-    idx = 0;
+    // Distances of the islands to their nearest neighbors, queried for all the islands in parallel.
+    thr();
+    std::vector<std::vector<PointIndexEl>> nearest = ctrindex.nearest(queries, 2);
+    std::vector<double> distances(centroids.size(), double(max_dist));
+    for (size_t i = 0; i < centroids.size(); ++ i)
+        for (const PointIndexEl &el : nearest[i])
+            if (el.second != i) {
+                distances[i] = Line(to_vec2(el.first), centroids[i]).length();
+                break;
+            }
+
+    unsigned idx = 0;
     for (const Point &c : centroids) {
         thr();
 
@@ -82,16 +99,7 @@ void ConcaveHull::add_connector_rectangles(const Points &centroids,
         double l  = std::sqrt(dx * dx + dy * dy);
         double nx = dx / l, ny = dy / l;
 
-        const Point &ct = centroids[idx];
-
-        std::vector<PointIndexEl> result = ctrindex.nearest(to_vec3(ct), 2);
-
-        double dist = max_dist;
-        for (const PointIndexEl &el : result)
-            if (el.second != idx) {
-                dist = Line(to_vec2(el.first), ct).length();
-                break;
-            }
+        double dist = distances[idx];
 
         idx++;
 
@@ -138,10 +146,20 @@ ExPolygons offset_waffle_style_ex(const ConcaveHull &hull, coord_t delta)
     return to_expolygons(offset_waffle_style(hull, delta));
 }
 
+ExPolygons offset_waffle_style_ex(const Polygons &hull, coord_t delta)
+{
+    return to_expolygons(offset_waffle_style(hull, delta));
+}
+
 Polygons offset_waffle_style(const ConcaveHull &hull, coord_t delta)
+{
+    return offset_waffle_style(hull.polygons(), delta);
+}
+
+Polygons offset_waffle_style(const Polygons &hull, coord_t delta)
 {
     auto arc_tolerance = scaled<double>(0.01);
-    Polygons res = closing(hull.polygons(), 2 * delta, delta, ClipperLib::jtRound, arc_tolerance);
+    Polygons res = closing(hull, 2 * delta, delta, ClipperLib::jtRound, arc_tolerance);
 
     auto it = std::remove_if(res.begin(), res.end(), [](Polygon &p) { return p.is_clockwise(); });
     res.erase(it, res.end());
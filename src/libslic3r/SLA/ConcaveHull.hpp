@@ -58,6 +58,9 @@ public:
 
 ExPolygons offset_waffle_style_ex(const ConcaveHull &ccvhull, coord_t delta);
 Polygons   offset_waffle_style(const ConcaveHull &polys, coord_t delta);
+// Overloads taking the polygons of a concave hull, see ConcaveHull::polygons().
+ExPolygons offset_waffle_style_ex(const Polygons &ccvhull, coord_t delta);
+Polygons   offset_waffle_style(const Polygons &polys, coord_t delta);
 
 }}     // namespace Slic3r::sla
 #endif // CONCAVEHULL_HPP
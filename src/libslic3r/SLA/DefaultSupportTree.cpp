@@ -722,36 +722,45 @@ bool DefaultSupportTree::connect_to_model_body(Head &head)
 
 bool DefaultSupportTree::search_pillar_and_connect(const Head &source)
 {
-    // Hope that a local copy takes less time than the whole search loop.
-    // We also need to remove elements progressively from the copied index.
-    PointIndex spindex = m_pillar_index.guarded_clone();
+    // Instead of copying the whole index and removing the pillars progressively,
+    // the shared index is queried for more and more of the nearest pillars
+    // and the pillars already tried are skipped.
+    std::vector<unsigned> tried;
 
     long nearest_id = SupportTreeNode::ID_UNSET;
 
     Vec3d querypt = source.junction_point();
+    Vec3d qp(querypt.x(), querypt.y(), ground_level(m_sm));
 
-    while(nearest_id < 0 && !spindex.empty()) { m_thr();
+    for (unsigned k = 4; nearest_id < 0; k *= 2) { m_thr();
         // loop until a suitable head is not found
         // if there is a pillar closer than the cluster center
         // (this may happen as the clustering is not perfect)
         // than we will bridge to this closer pillar
 
-        Vec3d qp(querypt.x(), querypt.y(), ground_level(m_sm));
-        auto qres = spindex.nearest(qp, 1);
-        if(qres.empty()) break;
+        auto qres = m_pillar_index.guarded_query(qp, k);
+        std::sort(qres.begin(), qres.end(), [&qp](const PointIndexEl &e1, const PointIndexEl &e2) {
+            return (e1.first - qp).squaredNorm() < (e2.first - qp).squaredNorm();
+        });
 
-        auto ne = qres.front();
-        nearest_id = ne.second;
+        for (const PointIndexEl &ne : qres) {
+            if (std::find(tried.begin(), tried.end(), ne.second) != tried.end())
+                continue;
 
-        if(nearest_id >= 0) {
-            if (size_t(nearest_id) < m_builder.pillarcount()) {
-                if(!connect_to_nearpillar(source, nearest_id) ||
-                    m_builder.pillar(nearest_id).r_start < source.r_back_mm) {
-                    nearest_id = SupportTreeNode::ID_UNSET;    // continue searching
-                    spindex.remove(ne);       // without the current pillar
-                }
-            }
+            m_thr();
+            tried.emplace_back(ne.second);
+            nearest_id = ne.second;
+
+            if (size_t(nearest_id) < m_builder.pillarcount() &&
+                (!connect_to_nearpillar(source, nearest_id) ||
+                 m_builder.pillar(nearest_id).r_start < source.r_back_mm))
+                nearest_id = SupportTreeNode::ID_UNSET;    // continue searching
+            else
+                break;
         }
+
+        // All the pillars were tried.
+        if (qres.size() < k) break;
     }
 
     return nearest_id >= 0;
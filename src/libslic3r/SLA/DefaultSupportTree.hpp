@@ -12,6 +12,7 @@
 #include <map>
 #include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <utility>
 #include <vector>
 
@@ -29,7 +30,9 @@ inline constexpr const auto &suptree_ex_policy = ex_tbb;
 
 class PillarIndex {
     PointIndex m_index;
-    using Mutex = execution::BlockingMutex<decltype(suptree_ex_policy)>;
+    // The pillars are inserted by the support tree worker tasks while the other tasks query the index.
+    // The queries only share the lock, thus they do not serialize each other.
+    using Mutex = std::shared_mutex;
     mutable Mutex m_mutex;
 
 public:
@@ -43,7 +46,7 @@ public:
     template<class...Args>
     inline std::vector<PointIndexEl> guarded_query(Args&&...args) const
     {
-        std::lock_guard<Mutex> lck(m_mutex);
+        std::shared_lock<Mutex> lck(m_mutex);
         return m_index.query(std::forward<Args>(args)...);
     }
 
@@ -67,7 +70,7 @@ public:
 
     PointIndex guarded_clone()
     {
-        std::lock_guard<Mutex> lck(m_mutex);
+        std::shared_lock<Mutex> lck(m_mutex);
         return m_index;
     }
 };
@@ -129,13 +129,19 @@ template<class Cont> double csgmesh_positive_maxvolume(const Cont &csg)
 }
 
 template<class It>
-InteriorPtr generate_interior(const Range<It>       &csgparts,
-                              const HollowingConfig &hc  = {},
-                              const JobController   &ctl = {})
+double get_voxel_scale(const Range<It> &csgparts, const HollowingConfig &hc)
 {
-    double mesh_vol = csgmesh_positive_maxvolume(csgparts);
-    double voxsc    = get_voxel_scale(mesh_vol, hc);
+    return get_voxel_scale(csgmesh_positive_maxvolume(csgparts), hc);
+}
 
+// The distance field of a csg mesh, an input of generate_interior(). It only
+// depends on the mesh and on the voxel scale, thus it may be reused when
+// the other hollowing parameters change.
+template<class It>
+VoxelGridPtr generate_interior_grid(const Range<It>     &csgparts,
+                                    double               voxsc,
+                                    const JobController &ctl = {})
+{
     auto params = csg::VoxelizeParams{}
                       .voxel_scale(voxsc)
                       .exterior_bandwidth(3.f)
@@ -149,9 +155,17 @@ InteriorPtr generate_interior(const Range<It>       &csgparts,
     if (!ptr || (ctl.stopcondition && ctl.stopcondition()))
         return {};
 
-    ptr = redistance_grid(*ptr, IsoAtZero,
-                          params.exterior_bandwidth(),
-                          params.interior_bandwidth());
+    return redistance_grid(*ptr, IsoAtZero,
+                           params.exterior_bandwidth(),
+                           params.interior_bandwidth());
+}
+
+template<class It>
+InteriorPtr generate_interior(const Range<It>       &csgparts,
+                              const HollowingConfig &hc  = {},
+                              const JobController   &ctl = {})
+{
+    auto ptr = generate_interior_grid(csgparts, get_voxel_scale(csgparts, hc), ctl);
 
     return ptr ? generate_interior(*ptr, hc, ctl) :
                  InteriorPtr{};
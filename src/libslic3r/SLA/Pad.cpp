@@ -10,12 +10,14 @@
 #include <algorithm>
 #include <utility>
 #include <cstdlib>
+#include <mutex>
 
 #include "ConcaveHull.hpp"
 #include "libslic3r/ClipperUtils.hpp"
 #include "libslic3r/Tesselate.hpp"
 #include "libslic3r/MTUtils.hpp"
 #include "libslic3r/TriangulateWall.hpp"
+#include "libslic3r/Execution/ExecutionTBB.hpp"
 #include "libslic3r/I18N.hpp"
 #include "admesh/stl.h"
 #include "libslic3r/Point.hpp"
@@ -148,6 +150,37 @@ static inline double get_merge_distance(const PadConfig &c)
     return 2. * (1.8 * c.wall_thickness_mm) + c.max_merge_dist_mm;
 }
 
+// The concave hull of the blueprints only depends on the blueprints and on the merge distance,
+// not on the wall height, which changes the waffle offset and the 3D geometry only.
+// The most recent hulls are kept to be reused when the pad is regenerated with a different wall height.
+static Polygons concave_hull(Polygons &&polys, double merge_dist, ThrowOnCancel thr)
+{
+    struct Entry { Polygons input; double merge_dist; Polygons hull; };
+    static constexpr size_t cache_size = 4;
+    static std::mutex       cache_mutex;
+    static std::vector<Entry> cache;
+
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto it = std::find_if(cache.begin(), cache.end(), [&polys, merge_dist](const Entry &e) {
+            return e.merge_dist == merge_dist && e.input == polys;
+        });
+        if (it != cache.end()) {
+            // Move to the back, the least recently used entry is at the front.
+            std::rotate(it, it + 1, cache.end());
+            return cache.back().hull;
+        }
+    }
+
+    ConcaveHull hull{polys, merge_dist, thr};
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (cache.size() == cache_size)
+        cache.erase(cache.begin());
+    cache.push_back({std::move(polys), merge_dist, hull.polygons()});
+    return cache.back().hull;
+}
+
 // Part of the pad configuration that is used for 3D geometry generation
 struct PadConfig3D {
     double thickness, height, wing_height, slope;
@@ -296,13 +329,13 @@ private:
                                        const PadConfig  &cfg,
                                        ThrowOnCancel     thr)
     {
-        auto allin = reserve_vector<ExPolygon>(supp_bp.size() + model_bp.size());
+        Polygons allin;
+        allin.reserve(supp_bp.size() + model_bp.size());
 
         for (auto &ep : supp_bp) allin.emplace_back(ep.contour);
         for (auto &ep : model_bp) allin.emplace_back(ep.contour);
 
-        ConcaveHull cchull{allin, get_merge_distance(cfg), thr};
-        return offset_waffle_style_ex(cchull, get_waffle_offset(cfg));
+        return offset_waffle_style_ex(concave_hull(std::move(allin), get_merge_distance(cfg), thr), get_waffle_offset(cfg));
     }
 
     // To remove parts of the pad skeleton which do not host any supports
@@ -328,14 +361,13 @@ public:
                      const PadConfig & cfg,
                      ThrowOnCancel     thr)
     {
-        outer.reserve(support_blueprint.size() + model_blueprint.size());
-
-        for (auto &ep : support_blueprint) outer.emplace_back(ep.contour);
-        for (auto &ep : model_blueprint) outer.emplace_back(ep.contour);
+        Polygons allin;
+        allin.reserve(support_blueprint.size() + model_blueprint.size());
 
-        ConcaveHull ochull{outer, get_merge_distance(cfg), thr};
+        for (auto &ep : support_blueprint) allin.emplace_back(ep.contour);
+        for (auto &ep : model_blueprint) allin.emplace_back(ep.contour);
 
-        outer = offset_waffle_style_ex(ochull, get_waffle_offset(cfg));
+        outer = offset_waffle_style_ex(concave_hull(std::move(allin), get_merge_distance(cfg), thr), get_waffle_offset(cfg));
     }
 };
 
@@ -391,27 +423,48 @@ indexed_triangle_set create_outer_pad_geometry(const ExPolygons & skeleton,
                                                ThrowOnCancel      thr)
 {
     indexed_triangle_set ret;
+    // The caps of all the pad parts are triangulated at once in parallel.
+    ExPolygons bottom_polys(skeleton.size()), top_polys(skeleton.size());
+    double z_min = -cfg.height;
+
+    // The walls of the pad parts are generated in parallel, then merged in the order of the pad parts.
+    std::vector<indexed_triangle_set> part_walls(skeleton.size());
+    execution::for_each(ex_tbb, size_t(0), skeleton.size(),
+        [&skeleton, &cfg, &thr, z_min, &bottom_polys, &top_polys, &part_walls](size_t idx) {
+            const ExPolygon &pad_part = skeleton[idx];
+            ExPolygon top_poly{pad_part};
+            ExPolygon bottom_poly =
+                offset_contour_only(pad_part, -scaled(cfg.bottom_offset()));
+
+            if (bottom_poly.empty()) return;
+            thr();
+
+            indexed_triangle_set &mesh = part_walls[idx];
+            double z_max = 0;
+            its_merge(mesh, walls(top_poly.contour, bottom_poly.contour, z_max, z_min));
+
+            if (cfg.wing_height > 0. && add_cavity(mesh, top_poly, cfg, thr))
+                z_max = -cfg.wing_height;
+
+            for (auto &h : bottom_poly.holes)
+                its_merge(mesh, straight_walls(h, z_max, z_min));
+
+            bottom_polys[idx] = std::move(bottom_poly);
+            top_polys[idx]    = std::move(top_poly);
+        });
+
+    for (const indexed_triangle_set &mesh : part_walls)
+        its_merge(ret, mesh);
+    // Remove the pad parts, which were skipped.
+    for (size_t i = skeleton.size(); i > 0; -- i)
+        if (bottom_polys[i - 1].empty()) {
+            bottom_polys.erase(bottom_polys.begin() + (i - 1));
+            top_polys.erase(top_polys.begin() + (i - 1));
+        }
 
-    for (const ExPolygon &pad_part : skeleton) {
-        ExPolygon top_poly{pad_part};
-        ExPolygon bottom_poly =
-            offset_contour_only(pad_part, -scaled(cfg.bottom_offset()));
-
-        if (bottom_poly.empty()) continue;
-        thr();
-        
-        double z_min = -cfg.height, z_max = 0;
-        its_merge(ret, walls(top_poly.contour, bottom_poly.contour, z_max, z_min));
-
-        if (cfg.wing_height > 0. && add_cavity(ret, top_poly, cfg, thr))
-            z_max = -cfg.wing_height;
-
-        for (auto &h : bottom_poly.holes)
-            its_merge(ret, straight_walls(h, z_max, z_min));
-        
-        its_merge(ret, triangulate_expolygon_3d(bottom_poly, z_min, NORMALS_DOWN));
-        its_merge(ret, triangulate_expolygon_3d(top_poly, NORMALS_UP));
-    }
+    thr();
+    its_merge(ret, triangulate_expolygons_3d_parallel(bottom_polys, z_min, NORMALS_DOWN));
+    its_merge(ret, triangulate_expolygons_3d_parallel(top_polys, 0., NORMALS_UP));
 
     return ret;
 }
@@ -423,16 +476,24 @@ indexed_triangle_set create_inner_pad_geometry(const ExPolygons & skeleton,
     indexed_triangle_set ret;
 
     double z_max = 0., z_min = -cfg.height;
-    for (const ExPolygon &pad_part : skeleton) {
-        thr();
-        its_merge(ret, straight_walls(pad_part.contour, z_max, z_min));
+    std::vector<indexed_triangle_set> part_walls(skeleton.size());
+    execution::for_each(ex_tbb, size_t(0), skeleton.size(),
+        [&skeleton, &thr, z_max, z_min, &part_walls](size_t idx) {
+            thr();
+            const ExPolygon &pad_part = skeleton[idx];
+            indexed_triangle_set &mesh = part_walls[idx];
+            its_merge(mesh, straight_walls(pad_part.contour, z_max, z_min));
 
-        for (auto &h : pad_part.holes)
-            its_merge(ret, straight_walls(h, z_max, z_min));
-    
-        its_merge(ret, triangulate_expolygon_3d(pad_part, z_min, NORMALS_DOWN));
-        its_merge(ret, triangulate_expolygon_3d(pad_part, z_max, NORMALS_UP));
-    }
+            for (auto &h : pad_part.holes)
+                its_merge(mesh, straight_walls(h, z_max, z_min));
+        });
+
+    for (const indexed_triangle_set &mesh : part_walls)
+        its_merge(ret, mesh);
+
+    thr();
+    its_merge(ret, triangulate_expolygons_3d_parallel(skeleton, z_min, NORMALS_DOWN));
+    its_merge(ret, triangulate_expolygons_3d_parallel(skeleton, z_max, NORMALS_UP));
 
     return ret;
 }
@@ -484,23 +545,31 @@ void pad_blueprint(const indexed_triangle_set &mesh,
 
     std::vector<ExPolygons> out = slice_mesh_ex(mesh, heights, thrfn);
 
+    // Unification is expensive, a simplify also speeds up the pad generation.
+    // The slices are simplified in parallel.
+    execution::for_each(ex_tbb, size_t(0), out.size(), [&out, &thrfn](size_t idx) {
+        thrfn();
+        ExPolygons simplified;
+        for (ExPolygon &e : out[idx])
+            append(simplified, e.simplify(scaled<double>(0.1)));
+        out[idx] = std::move(simplified);
+    });
+
     size_t count = 0;
     for(auto& o : out) count += o.size();
 
-    // Unification is expensive, a simplify also speeds up the pad generation
     auto tmp = reserve_vector<ExPolygon>(count);
     for(ExPolygons& o : out)
-        for(ExPolygon& e : o) {
-            auto&& exss = e.simplify(scaled<double>(0.1));
-            for(ExPolygon& ep : exss) tmp.emplace_back(std::move(ep));
-        }
+        for(ExPolygon& e : o) tmp.emplace_back(std::move(e));
 
     ExPolygons utmp = union_ex(tmp);
 
-    for(auto& o : utmp) {
-        auto&& smp = o.simplify(scaled<double>(0.1));
-        output.insert(output.end(), smp.begin(), smp.end());
-    }
+    std::vector<ExPolygons> smp(utmp.size());
+    execution::for_each(ex_tbb, size_t(0), utmp.size(),
+                        [&utmp, &smp](size_t idx) { smp[idx] = utmp[idx].simplify(scaled<double>(0.1)); },
+                        execution::max_concurrency(ex_tbb));
+    for (ExPolygons &s : smp)
+        append(output, std::move(s));
 }
 
 void pad_blueprint(const indexed_triangle_set &mesh,
@@ -8,6 +8,7 @@
 
 #include <libslic3r/SLA/RasterBase.hpp>
 #include <libslic3r/SLA/AGGRaster.hpp>
+#include <libslic3r/SLA/ScanlineRaster.hpp>
 // minz image write:
 #include <miniz.h>
 #include <algorithm>
@@ -25,8 +26,9 @@ EncodedRaster PNGRasterEncoder::operator()(const void *ptr, size_t w, size_t h,
     std::vector<uint8_t> buf;
     size_t s = 0;
     
-    void *rawdata = tdefl_write_image_to_png_file_in_memory(
-        ptr, int(w), int(h), int(num_components), &s);
+    void *rawdata = tdefl_write_image_to_png_file_in_memory_ex(
+        ptr, int(w), int(h), int(num_components), &s,
+        std::clamp(compression_level, 0, 10), MZ_FALSE);
     
     // On error, data() will return an empty vector. No other info can be
     // retrieved from miniz anyway...
@@ -88,6 +90,14 @@ std::unique_ptr<RasterBase> create_raster_grayscale_aa(
     return rst;
 }
 
+std::unique_ptr<RasterBase> create_raster_grayscale_binary(
+    const Resolution        &res,
+    const PixelDim          &pxdim,
+    const RasterBase::Trafo &tr)
+{
+    return std::make_unique<RasterGrayscaleBinary>(res, pxdim, tr);
+}
+
 } // namespace sla
 } // namespace Slic3r
 
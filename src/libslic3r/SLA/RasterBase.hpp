@@ -108,6 +108,9 @@ public:
 };
 
 struct PNGRasterEncoder {
+    // Deflate level from 0 (store) to 10 (best), see miniz.
+    int compression_level = 6;
+
     EncodedRaster operator()(const void *ptr, size_t w, size_t h, size_t num_components);
 };
 
@@ -124,6 +127,12 @@ std::unique_ptr<RasterBase> create_raster_grayscale_aa(
     double                   gamma = 1.0,
     const RasterBase::Trafo &tr    = {});
 
+// Monochrome raster without anti-aliasing, see RasterGrayscaleBinary.
+std::unique_ptr<RasterBase> create_raster_grayscale_binary(
+    const Resolution        &res,
+    const PixelDim          &pxdim,
+    const RasterBase::Trafo &tr    = {});
+
 }} // namespace Slic3r::sla
 
 #endif // SLARASTERBASE_HPP
@@ -4,14 +4,15 @@
 ///|/
 #include <libslic3r/SLA/Rotfinder.hpp>
 #include <libslic3r/Execution/ExecutionTBB.hpp>
-#include <libslic3r/Optimize/BruteforceOptimizer.hpp>
 #include <libslic3r/Geometry.hpp>
+#include <libslic3r/QuadricEdgeCollapse.hpp>
 #include <limits>
 #include <thread>
 #include <algorithm>
 #include <array>
 #include <cmath>
 #include <iterator>
+#include <numeric>
 #include <vector>
 #include <cinttypes>
 #include <cstdlib>
@@ -21,7 +22,6 @@
 #include "libslic3r/BoundingBox.hpp"
 #include "libslic3r/Execution/Execution.hpp"
 #include "libslic3r/Model.hpp"
-#include "libslic3r/Optimize/Optimizer.hpp"
 #include "libslic3r/Point.hpp"
 #include "libslic3r/TriangleMesh.hpp"
 #include "libslic3r/libslic3r.h"
@@ -263,34 +263,126 @@ std::vector<XYRotation> get_chull_rotations(const TriangleMesh &mesh, size_t max
     return ret;
 }
 
-// Find the best score from a set of function inputs. Evaluate for every point.
-template<size_t N, class Fn, class It, class StopCond>
-std::array<double, N> find_min_score(Fn &&fn, It from, It to, StopCond &&stopfn)
+// Meshes with more faces are decimated for the coarse search of the rotations.
+constexpr uint32_t PROXY_FACE_COUNT = 20000;
+
+// Decimated copy of the mesh if it has too many faces, empty mesh otherwise.
+TriangleMesh get_proxy_mesh(const TriangleMesh &mesh)
 {
-    std::array<double, N> ret = {};
+    if (mesh.its.indices.size() <= PROXY_FACE_COUNT)
+        return {};
 
-    double score = std::numeric_limits<double>::max();
+    indexed_triangle_set its = mesh.its;
+    its_quadric_edge_collapse(its, PROXY_FACE_COUNT);
 
-    size_t Nthreads = std::thread::hardware_concurrency();
-    size_t dist = std::distance(from, to);
-    std::vector<double> scores(dist, score);
-
-    execution::for_each(
-        ex_tbb, size_t(0), dist, [&stopfn, &scores, &fn, &from](size_t i) {
-            if (stopfn()) return;
+    return TriangleMesh{std::move(its)};
+}
 
-            scores[i] = fn(*(from + i));
-        },
-        dist / Nthreads);
+// Evaluate fn for each of the inputs in parallel. The inputs are processed in
+// batches and the status is reported from the calling thread between the
+// batches. Inputs not evaluated due to the stop condition are scored NaN.
+template<class Fn, class Boilerplate>
+std::vector<double> eval_scores(Fn &&fn, const std::vector<XYRotation> &inputs, Boilerplate &bp)
+{
+    std::vector<double> scores(inputs.size(), NaNd);
+
+    size_t batchsize = std::max(size_t(1), size_t(4 * std::thread::hardware_concurrency()));
+    for (size_t from = 0; from < inputs.size() && !bp.stopcond(); from += batchsize) {
+        size_t to = std::min(inputs.size(), from + batchsize);
+        execution::for_each(
+            ex_tbb, from, to, [&fn, &scores, &inputs](size_t i) {
+                scores[i] = fn(inputs[i]);
+            },
+            size_t(1));
+
+        bp.statusfn(unsigned(to - from));
+    }
 
-    auto it = std::min_element(scores.begin(), scores.end());
+    return scores;
+}
 
-    if (it != scores.end())
-        ret = *(from + std::distance(scores.begin(), it));
+// Index of the minimum score, NaN scores are skipped. Returns scores.size()
+// if there is no valid score.
+size_t min_score_idx(const std::vector<double> &scores)
+{
+    size_t ret   = scores.size();
+    double score = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < scores.size(); ++i)
+        if (scores[i] < score) {
+            score = scores[i];
+            ret   = i;
+        }
 
     return ret;
 }
 
+// Find the best score from a set of function inputs. Evaluate for every point.
+template<class Fn, class Boilerplate>
+XYRotation find_min_score(Fn &&fn, const std::vector<XYRotation> &inputs, Boilerplate &bp)
+{
+    size_t idx = min_score_idx(eval_scores(fn, inputs, bp));
+
+    return idx < inputs.size() ? inputs[idx] : XYRotation{};
+}
+
+// Search the rotation minimizing fn over the whole range of rotations around
+// X and Y. A coarse grid is evaluated by proxyfn, which is expected to score
+// a decimated mesh. The neighborhood of the best rotation of the coarse grid
+// is then refined by fn on a grid shrinking by half in each step, until the
+// score stops improving.
+template<class ProxyFn, class Fn, class Boilerplate>
+XYRotation find_min_score_coarse_to_fine(ProxyFn &&proxyfn, Fn &&fn, Boilerplate &bp)
+{
+    // Size of the grid centered at the current rotation in a refinement step.
+    constexpr size_t REFINE_GRIDSIZE = 5;
+    constexpr size_t REFINE_TRIES    = REFINE_GRIDSIZE * REFINE_GRIDSIZE;
+    // Relative improvement of the score under which the refinement stops.
+    constexpr double STALL_REL_DIFF  = 1e-3;
+
+    // Three quarters of the budget are spent on the coarse grid.
+    size_t gridsize     = std::max(size_t(2), size_t(std::sqrt(0.75 * bp.max_tries)));
+    size_t coarse_tries = gridsize * gridsize;
+    size_t refine_steps = std::max(size_t(1), (bp.max_tries - std::min(size_t(bp.max_tries), coarse_tries)) / REFINE_TRIES);
+    bp.max_tries = unsigned(coarse_tries + refine_steps * REFINE_TRIES);
+
+    double step   = 2. * PI / (gridsize - 1);
+    auto   inputs = reserve_vector<XYRotation>(coarse_tries);
+    for (size_t i = 0; i < gridsize; ++i)
+        for (size_t j = 0; j < gridsize; ++j)
+            inputs.push_back({-PI + i * step, -PI + j * step});
+
+    XYRotation rot   = find_min_score(proxyfn, inputs, bp);
+    double     score = std::numeric_limits<double>::max();
+
+    for (size_t s = 0; s < refine_steps && !bp.stopcond(); ++s) {
+        inputs.clear();
+        for (size_t i = 0; i < REFINE_GRIDSIZE; ++i)
+            for (size_t j = 0; j < REFINE_GRIDSIZE; ++j)
+                inputs.push_back({rot[X] + (2. * i / (REFINE_GRIDSIZE - 1) - 1.) * step,
+                                  rot[Y] + (2. * j / (REFINE_GRIDSIZE - 1) - 1.) * step});
+
+        // The current rotation is in the center of the grid, thus the score
+        // can only improve.
+        std::vector<double> scores = eval_scores(fn, inputs, bp);
+        size_t idx = min_score_idx(scores);
+        if (idx == inputs.size())
+            break;
+
+        bool stalled = score < std::numeric_limits<double>::max() &&
+                       score - scores[idx] <= STALL_REL_DIFF * std::abs(score);
+
+        rot   = inputs[idx];
+        score = scores[idx];
+
+        if (stalled)
+            break;
+
+        step /= 2.;
+    }
+
+    return rot;
+}
+
 } // namespace
 
 
@@ -324,14 +416,13 @@ struct RotfinderBoilerplate {
         , params{p}
     {}
 
-    void statusfn() {
-        int s = status * 100 / max_tries;
+    void statusfn(unsigned count = 1) {
+        status += count;
+        int s = std::min(100, int(status * 100 / std::max(1u, max_tries)));
         if (s != prev_status) {
             params.statuscb()(s);
             prev_status = s;
         }
-
-        ++status;
     }
 
     bool stopcond() { return ! params.statuscb()(-1); }
@@ -342,27 +433,22 @@ Vec2d find_best_misalignment_rotation(const ModelObject &      mo,
 {
     RotfinderBoilerplate<1000> bp{mo, params};
 
-    // Preparing the optimizer.
-    size_t gridsize = std::sqrt(bp.max_tries);
-    opt::Optimizer<opt::AlgBruteForce> solver(
-        opt::StopCriteria{}.max_iterations(bp.max_tries)
-                           .stop_condition([&bp] { return bp.stopcond(); }),
-        gridsize
-    );
+    TriangleMesh proxy = get_proxy_mesh(bp.mesh);
+    const TriangleMesh &coarse_mesh = proxy.empty() ? bp.mesh : proxy;
 
     // We are searching rotations around only two axes x, y. Thus the
-    // problem becomes a 2 dimensional optimization task.
-    // We can specify the bounds for a dimension in the following way:
-    auto bounds = opt::bounds({ {-PI, PI}, {-PI, PI} });
-
-    auto result = solver.to_max().optimize(
-        [&bp] (const XYRotation &rot)
-        {
-            bp.statusfn();
-            return get_misalginment_score(bp.mesh, to_transform3f(rot));
-        }, opt::initvals({0., 0.}), bounds);
-
-    return {result.optimum[0], result.optimum[1]};
+    // problem becomes a 2 dimensional optimization task. The score is to be
+    // maximized.
+    XYRotation rot = find_min_score_coarse_to_fine(
+        [&coarse_mesh](const XYRotation &rot) {
+            return -get_misalginment_score(coarse_mesh, to_transform3f(rot));
+        },
+        [&bp](const XYRotation &rot) {
+            return -get_misalginment_score(bp.mesh, to_transform3f(rot));
+        },
+        bp);
+
+    return {rot[0], rot[1]};
 }
 
 Vec2d find_least_supports_rotation(const ModelObject &      mo,
@@ -378,48 +464,59 @@ Vec2d find_least_supports_rotation(const ModelObject &      mo,
 
     XYRotation rot;
 
+    TriangleMesh proxy = get_proxy_mesh(bp.mesh);
+    const TriangleMesh &coarse_mesh = proxy.empty() ? bp.mesh : proxy;
+
     // Different search methods have to be used depending on the model elevation
     if (is_on_floor(pocfg)) {
+        // The best rotations of the decimated mesh are scored again on the
+        // full mesh.
+        static constexpr size_t REFINE_COUNT = 8;
 
         std::vector<XYRotation> inputs = get_chull_rotations(bp.mesh, bp.max_tries);
-        bp.max_tries = inputs.size();
+        size_t refine_count = proxy.empty() ? 0 : std::min(REFINE_COUNT, inputs.size());
+        bp.max_tries = unsigned(inputs.size() + refine_count);
 
         // If the model can be placed on the bed directly, we only need to
         // check the 3D convex hull face rotations.
 
-        auto objfn = [&bp](const XYRotation &rot) {
-            bp.statusfn();
-            Transform3f tr = to_transform3f(rot);
-            return get_supportedness_onfloor_score(bp.mesh, tr);
-        };
+        std::vector<double> scores = eval_scores([&coarse_mesh](const XYRotation &rot) {
+            return get_supportedness_onfloor_score(coarse_mesh, to_transform3f(rot));
+        }, inputs, bp);
+
+        if (refine_count > 0) {
+            std::vector<size_t> order(inputs.size());
+            std::iota(order.begin(), order.end(), size_t(0));
+            std::partial_sort(order.begin(), order.begin() + refine_count, order.end(),
+                              [&scores](size_t a, size_t b) {
+                                  // NaN scores of the skipped inputs go last.
+                                  return std::isnan(scores[b]) ? !std::isnan(scores[a]) : scores[a] < scores[b];
+                              });
+
+            auto best = reserve_vector<XYRotation>(refine_count);
+            for (size_t i = 0; i < refine_count; ++i)
+                best.emplace_back(inputs[order[i]]);
+
+            inputs = std::move(best);
+            scores = eval_scores([&bp](const XYRotation &rot) {
+                return get_supportedness_onfloor_score(bp.mesh, to_transform3f(rot));
+            }, inputs, bp);
+        }
 
-        rot = find_min_score<2>(objfn, inputs.begin(), inputs.end(), [&bp] {
-            return bp.stopcond();
-        });
+        size_t idx = min_score_idx(scores);
+        rot = idx < inputs.size() ? inputs[idx] : XYRotation{};
 
     } else {
-        // Preparing the optimizer.
-        size_t gridsize = std::sqrt(bp.max_tries); // 2D grid has gridsize^2 calls
-        opt::Optimizer<opt::AlgBruteForce> solver(
-            opt::StopCriteria{}.max_iterations(bp.max_tries)
-                               .stop_condition([&bp] { return bp.stopcond(); }),
-            gridsize
-        );
-
         // We are searching rotations around only two axes x, y. Thus the
         // problem becomes a 2 dimensional optimization task.
-        // We can specify the bounds for a dimension in the following way:
-        auto bounds = opt::bounds({ {-PI, PI}, {-PI, PI} });
-
-        auto result = solver.to_min().optimize(
-            [&bp] (const XYRotation &rot)
-            {
-                bp.statusfn();
+        rot = find_min_score_coarse_to_fine(
+            [&coarse_mesh](const XYRotation &rot) {
+                return get_supportedness_score(coarse_mesh, to_transform3f(rot));
+            },
+            [&bp](const XYRotation &rot) {
                 return get_supportedness_score(bp.mesh, to_transform3f(rot));
-            }, opt::initvals({0., 0.}), bounds);
-
-        // Save the result
-        rot = result.optimum;
+            },
+            bp);
     }
 
     return {rot[0], rot[1]};
@@ -473,15 +570,12 @@ Vec2d find_min_z_height_rotation(const ModelObject &mo,
     inputs.shrink_to_fit();
     bp.max_tries = inputs.size();
 
-    auto objfn = [&bp, &chull](const XYRotation &rot) {
-        bp.statusfn();
+    auto objfn = [&chull](const XYRotation &rot) {
         Transform3f tr = to_transform3f(rot);
         return bounding_box_with_tr(chull.its, tr).size().z();
     };
 
-    XYRotation rot = find_min_score<2>(objfn, inputs.begin(), inputs.end(), [&bp] {
-        return bp.stopcond();
-    });
+    XYRotation rot = find_min_score(objfn, inputs, bp);
 
     return {rot[0], rot[1]};
 }
@@ -0,0 +1,119 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#include <libslic3r/SLA/ScanlineRaster.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#include "libslic3r/ExPolygon.hpp"
+
+namespace Slic3r { namespace sla {
+
+RasterGrayscaleBinary::RasterGrayscaleBinary(const Resolution &res, const PixelDim &pd, const Trafo &trafo)
+    : m_resolution(res)
+    , m_pxdim(pd)
+    , m_trafo(trafo)
+    , m_scale_x(SCALING_FACTOR)
+    , m_scale_y(SCALING_FACTOR)
+    , m_buf(res.pixels(), 0)
+{
+    assert(pd.w_mm != 0 && pd.h_mm != 0);
+    if (pd.w_mm != 0 && pd.h_mm != 0) {
+        m_scale_x /= pd.w_mm;
+        m_scale_y /= pd.h_mm;
+    }
+}
+
+void RasterGrayscaleBinary::clear()
+{
+    std::fill(m_buf.begin(), m_buf.end(), uint8_t(0));
+}
+
+void RasterGrayscaleBinary::add_edges(const Polygon &poly)
+{
+    if (poly.points.size() < 3)
+        return;
+
+    // The same transformation as AGGRaster::to_path() applies.
+    auto to_px = [this](const Point &p) {
+        Vec2d out = m_trafo.flipXY ? Vec2d(p.y() * m_scale_y, p.x() * m_scale_x) : Vec2d(p.x() * m_scale_x, p.y() * m_scale_y);
+        out += Vec2d(m_trafo.center_x * m_scale_x, m_trafo.center_y * m_scale_y);
+        if (m_trafo.mirror_x)
+            out.x() = double(m_resolution.width_px) - out.x();
+        if (m_trafo.mirror_y)
+            out.y() = double(m_resolution.height_px) - out.y();
+        return out;
+    };
+
+    Vec2d prev = to_px(poly.points.back());
+    for (const Point &pt : poly.points) {
+        const Vec2d next = to_px(pt);
+        if (prev.y() != next.y()) {
+            const bool   up = prev.y() < next.y();
+            const Vec2d &a  = up ? prev : next;
+            const Vec2d &b  = up ? next : prev;
+            m_edges.push_back({ a.x(), a.y(), b.y(), (b.x() - a.x()) / (b.y() - a.y()), up ? 1 : -1 });
+        }
+        prev = next;
+    }
+}
+
+void RasterGrayscaleBinary::draw(const ExPolygon &poly)
+{
+    m_edges.clear();
+    this->add_edges(poly.contour);
+    for (const Polygon &hole : poly.holes)
+        this->add_edges(hole);
+    if (m_edges.empty())
+        return;
+
+    std::sort(m_edges.begin(), m_edges.end(), [](const Edge &l, const Edge &r) { return l.y0 < r.y0; });
+    double ymax = m_edges.front().y1;
+    for (const Edge &edge : m_edges)
+        ymax = std::max(ymax, edge.y1);
+
+    // Scanline of row r samples the pixel centers at y = r + 0.5.
+    const auto height    = int(m_resolution.height_px);
+    const auto width     = int(m_resolution.width_px);
+    const int  row_begin = std::max(0, int(std::ceil(m_edges.front().y0 - 0.5)));
+    const int  row_end   = std::min(height, int(std::ceil(ymax - 0.5)));
+
+    m_active.clear();
+    size_t next_edge = 0;
+    for (int row = row_begin; row < row_end; ++ row) {
+        const double y = row + 0.5;
+        while (next_edge < m_edges.size() && m_edges[next_edge].y0 <= y)
+            m_active.emplace_back(next_edge ++);
+        m_active.erase(std::remove_if(m_active.begin(), m_active.end(), [this, y](size_t idx) { return m_edges[idx].y1 <= y; }), m_active.end());
+
+        m_crossings.clear();
+        for (size_t idx : m_active) {
+            const Edge &edge = m_edges[idx];
+            m_crossings.emplace_back(edge.x0 + (y - edge.y0) * edge.dxdy, edge.winding);
+        }
+        std::sort(m_crossings.begin(), m_crossings.end());
+
+        uint8_t *row_data = m_buf.data() + size_t(row) * m_resolution.width_px;
+        int      winding  = 0;
+        double   span_begin = 0.;
+        for (const auto &[x, edge_winding] : m_crossings) {
+            const int prev_winding = winding;
+            winding += edge_winding;
+            if (prev_winding == 0)
+                span_begin = x;
+            else if (winding == 0) {
+                // Fill the pixels with centers inside [span_begin, x).
+                const int col_begin = std::max(0, int(std::ceil(span_begin - 0.5)));
+                const int col_end   = std::min(width, int(std::ceil(x - 0.5)));
+                if (col_begin < col_end)
+                    memset(row_data + col_begin, 255, size_t(col_end - col_begin));
+            }
+        }
+    }
+}
+
+}} // namespace Slic3r::sla
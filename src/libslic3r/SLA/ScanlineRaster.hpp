@@ -0,0 +1,76 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef SLA_SCANLINERASTER_HPP
+#define SLA_SCANLINERASTER_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <libslic3r/SLA/RasterBase.hpp>
+
+namespace Slic3r {
+
+class ExPolygon;
+class Polygon;
+
+namespace sla {
+
+/*
+ * Monochrome canvas without anti-aliasing. A pixel is white if its center is
+ * inside of a polygon (non-zero winding rule), the background is black.
+ *
+ * The polygons are filled scanline by scanline, a span of a scanline is filled
+ * by a single memset. This is considerably faster than accumulating the pixel
+ * coverage by the AGG rasterizer and thresholding it, which RasterGrayscaleAA
+ * does for printers with anti-aliasing disabled.
+ */
+class RasterGrayscaleBinary : public RasterBase {
+public:
+    RasterGrayscaleBinary(const Resolution &res, const PixelDim &pd, const Trafo &trafo);
+
+    Trafo      trafo() const override { return m_trafo; }
+    Resolution resolution() const { return m_resolution; }
+    PixelDim   pixel_dimensions() const { return m_pxdim; }
+
+    void draw(const ExPolygon &poly) override;
+
+    EncodedRaster encode(RasterEncoder encoder) const override
+    {
+        return encoder(m_buf.data(), m_resolution.width_px, m_resolution.height_px, 1);
+    }
+
+    uint8_t read_pixel(size_t col, size_t row) const { return m_buf[row * m_resolution.width_px + col]; }
+
+    void clear();
+
+private:
+    struct Edge {
+        // Lower end point, y0 < y1.
+        double x0, y0;
+        double y1;
+        double dxdy;
+        int    winding;
+    };
+
+    void add_edges(const Polygon &poly);
+
+    Resolution           m_resolution;
+    PixelDim             m_pxdim;
+    Trafo                m_trafo;
+    // Pixel coordinates of scaled coordinates, see AGGRaster::to_path().
+    double               m_scale_x;
+    double               m_scale_y;
+    std::vector<uint8_t> m_buf;
+
+    // Work buffers of draw(), kept to avoid reallocation.
+    std::vector<Edge>                 m_edges;
+    std::vector<size_t>               m_active;
+    std::vector<std::pair<double, int>> m_crossings;
+};
+
+}} // namespace Slic3r::sla
+
+#endif // SLA_SCANLINERASTER_HPP
@@ -22,8 +22,27 @@
 #pragma warning(pop)
 #endif
 
+#include "libslic3r/Execution/ExecutionTBB.hpp"
+
 namespace Slic3r { namespace sla {
 
+namespace {
+
+// The batched queries are cheap, a chunk of them is processed by a single task.
+constexpr size_t BatchQueryGranularity = 64;
+
+template<class Result, class Query, class Fn>
+std::vector<std::vector<Result>> batch_query(const std::vector<Query> &queries, Fn &&fn)
+{
+    std::vector<std::vector<Result>> ret(queries.size());
+    execution::for_each(ex_tbb, size_t(0), queries.size(),
+                        [&queries, &ret, &fn](size_t idx) { ret[idx] = fn(queries[idx]); },
+                        BatchQueryGranularity);
+    return ret;
+}
+
+} // namespace
+
 /* **************************************************************************
  * PointIndex implementation
  * ************************************************************************** */
@@ -33,10 +52,15 @@ public:
     using BoostIndex = boost::geometry::index::rtree< PointIndexEl,
                                                      boost::geometry::index::rstar<16, 4> /* ? */ >;
 
+    Impl() = default;
+    // The range constructor of the boost rtree uses the packing algorithm.
+    explicit Impl(const std::vector<PointIndexEl> &elements) : m_store(elements.begin(), elements.end()) {}
+
     BoostIndex m_store;
 };
 
 PointIndex::PointIndex(): m_impl(new Impl()) {}
+PointIndex::PointIndex(const std::vector<PointIndexEl> &elements): m_impl(new Impl(elements)) {}
 PointIndex::~PointIndex() {}
 
 PointIndex::PointIndex(const PointIndex &cpy): m_impl(new Impl(*cpy.m_impl)) {}
@@ -82,6 +106,30 @@ std::vector<PointIndexEl> PointIndex::nearest(const Vec3d &el, unsigned k = 1) c
     return ret;
 }
 
+std::vector<PointIndexEl> PointIndex::within(const Vec3d &v, double radius) const
+{
+    namespace bgi = boost::geometry::index;
+    using Box3d = boost::geometry::model::box<Vec3d>;
+
+    const double radius2 = radius * radius;
+    const Vec3d  r(radius, radius, radius);
+    std::vector<PointIndexEl> ret;
+    m_impl->m_store.query(bgi::intersects(Box3d(v - r, v + r)) &&
+                              bgi::satisfies([&v, radius2](const PointIndexEl &el) { return (el.first - v).squaredNorm() <= radius2; }),
+                          std::back_inserter(ret));
+    return ret;
+}
+
+std::vector<std::vector<PointIndexEl>> PointIndex::nearest(const std::vector<Vec3d> &pts, unsigned k) const
+{
+    return batch_query<PointIndexEl>(pts, [this, k](const Vec3d &v) { return this->nearest(v, k); });
+}
+
+std::vector<std::vector<PointIndexEl>> PointIndex::within(const std::vector<Vec3d> &pts, double radius) const
+{
+    return batch_query<PointIndexEl>(pts, [this, radius](const Vec3d &v) { return this->within(v, radius); });
+}
+
 size_t PointIndex::size() const
 {
     return m_impl->m_store.size();
@@ -106,10 +154,14 @@ public:
     using BoostIndex = boost::geometry::index::
         rtree<BoxIndexEl, boost::geometry::index::rstar<16, 4> /* ? */>;
 
+    Impl() = default;
+    explicit Impl(const std::vector<BoxIndexEl> &elements) : m_store(elements.begin(), elements.end()) {}
+
     BoostIndex m_store;
 };
 
 BoxIndex::BoxIndex(): m_impl(new Impl()) {}
+BoxIndex::BoxIndex(const std::vector<BoxIndexEl> &elements): m_impl(new Impl(elements)) {}
 BoxIndex::~BoxIndex() {}
 
 BoxIndex::BoxIndex(const BoxIndex &cpy): m_impl(new Impl(*cpy.m_impl)) {}
@@ -138,11 +190,11 @@ bool BoxIndex::remove(const BoxIndexEl& el)
 }
 
 std::vector<BoxIndexEl> BoxIndex::query(const BoundingBox &qrbb,
-                                        BoxIndex::QueryType qt)
+                                        BoxIndex::QueryType qt) const
 {
     namespace bgi = boost::geometry::index;
 
-    std::vector<BoxIndexEl> ret; ret.reserve(m_impl->m_store.size());
+    std::vector<BoxIndexEl> ret;
 
     switch (qt) {
     case qtIntersects:
@@ -155,6 +207,11 @@ std::vector<BoxIndexEl> BoxIndex::query(const BoundingBox &qrbb,
     return ret;
 }
 
+std::vector<std::vector<BoxIndexEl>> BoxIndex::query(const std::vector<BoundingBox> &bbs, QueryType qt) const
+{
+    return batch_query<BoxIndexEl>(bbs, [this, qt](const BoundingBox &bb) { return this->query(bb, qt); });
+}
+
 size_t BoxIndex::size() const
 {
     return m_impl->m_store.size();
@@ -22,6 +22,8 @@ namespace sla {
 typedef Eigen::Matrix<double,   3, 1, Eigen::DontAlign> Vec3d;
 using PointIndexEl = std::pair<Vec3d, unsigned>;
 
+// The const queries of PointIndex and BoxIndex may be issued concurrently from multiple threads
+// without any locking, as long as the index is not modified at the same time.
 class PointIndex {
     class Impl;
 
@@ -31,6 +33,9 @@ class PointIndex {
 public:
 
     PointIndex();
+    // Build the index from all the elements at once by packing (sort-tile-recursive bulk loading).
+    // Faster to build and to query than an index built by inserting the elements one by one.
+    explicit PointIndex(const std::vector<PointIndexEl> &elements);
     ~PointIndex();
 
     PointIndex(const PointIndex&);
@@ -52,6 +57,12 @@ public:
     {
         return nearest(v, k);
     }
+    // Elements not further than radius from the query point.
+    std::vector<PointIndexEl> within(const Vec3d &v, double radius) const;
+
+    // Batched queries, answered in parallel. The i-th result belongs to the i-th query point.
+    std::vector<std::vector<PointIndexEl>> nearest(const std::vector<Vec3d> &pts, unsigned k) const;
+    std::vector<std::vector<PointIndexEl>> within(const std::vector<Vec3d> &pts, double radius) const;
 
     // For testing
     size_t size() const;
@@ -72,6 +83,8 @@ class BoxIndex {
 public:
     
     BoxIndex();
+    // Build the index from all the elements at once by packing, see PointIndex.
+    explicit BoxIndex(const std::vector<BoxIndexEl> &elements);
     ~BoxIndex();
     
     BoxIndex(const BoxIndex&);
@@ -89,7 +102,9 @@ public:
 
     enum QueryType { qtIntersects, qtWithin };
 
-    std::vector<BoxIndexEl> query(const BoundingBox&, QueryType qt);
+    std::vector<BoxIndexEl> query(const BoundingBox&, QueryType qt) const;
+    // Batched queries, answered in parallel. The i-th result belongs to the i-th query box.
+    std::vector<std::vector<BoxIndexEl>> query(const std::vector<BoundingBox> &bbs, QueryType qt) const;
     
     // For testing
     size_t size() const;
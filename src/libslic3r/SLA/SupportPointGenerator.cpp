@@ -3,6 +3,7 @@
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
 #include <random>
+#include <array>
 #include <cstdlib>
 #include <limits>
 #include <numeric>
@@ -98,26 +99,41 @@ void SupportPointGenerator::project_onto_mesh(std::vector<sla::SupportPoint>& po
     // Use a reasonable granularity to account for the worker thread synchronization cost.
     static constexpr size_t gransize = 64;
 
-    execution::for_each(ex_tbb, size_t(0), points.size(), [this, &points](size_t idx)
+    execution::for_each(ex_tbb, size_t(0), (points.size() + gransize - 1) / gransize, [this, &points](size_t chunk)
     {
-        if ((idx % 16) == 0)
-            // Don't call the following function too often as it flushes CPU write caches due to synchronization primitves.
-            m_throw_on_cancel();
+        // Don't call the following function too often as it flushes CPU write caches due to synchronization primitves.
+        m_throw_on_cancel();
 
-        Vec3f& p = points[idx].pos;
-        // Project the point upward and downward and choose the closer intersection with the mesh.
-        AABBMesh::hit_result hit_up   = m_emesh.query_ray_hit(p.cast<double>(), Vec3d(0., 0., 1.));
-        AABBMesh::hit_result hit_down = m_emesh.query_ray_hit(p.cast<double>(), Vec3d(0., 0., -1.));
+        size_t from = chunk * gransize;
+        size_t n    = std::min(gransize, points.size() - from);
+
+        // Project the points upward and downward and choose the closer intersection with the mesh.
+        // The rays of neighboring points are coherent, they are cast in packets, first all upward, then all downward.
+        std::array<Vec3d, 2 * gransize>                sources;
+        std::array<Vec3d, 2 * gransize>                dirs;
+        std::array<AABBMesh::hit_result, 2 * gransize> hits;
+        for (size_t i = 0; i < n; ++ i) {
+            sources[i] = sources[n + i] = points[from + i].pos.cast<double>();
+            dirs[i]     = Vec3d(0., 0., 1.);
+            dirs[n + i] = Vec3d(0., 0., -1.);
+        }
+        m_emesh.batch_query_ray_hit({ sources.data(), 2 * n }, { dirs.data(), 2 * n }, { hits.data(), 2 * n });
 
-        bool up   = hit_up.is_hit();
-        bool down = hit_down.is_hit();
+        for (size_t i = 0; i < n; ++ i) {
+            const AABBMesh::hit_result &hit_up   = hits[i];
+            const AABBMesh::hit_result &hit_down = hits[n + i];
 
-        if (!up && !down)
-            return;
+            bool up   = hit_up.is_hit();
+            bool down = hit_down.is_hit();
 
-        AABBMesh::hit_result& hit = (!down || (hit_up.distance() < hit_down.distance())) ? hit_up : hit_down;
-        p = p + (hit.distance() * hit.direction()).cast<float>();
-    }, gransize);
+            if (!up && !down)
+                continue;
+
+            const AABBMesh::hit_result &hit = (!down || (hit_up.distance() < hit_down.distance())) ? hit_up : hit_down;
+            Vec3f &p = points[from + i].pos;
+            p = p + (hit.distance() * hit.direction()).cast<float>();
+        }
+    }, size_t(1));
 }
 
 static std::vector<SupportPointGenerator::MyLayer> make_layers(
@@ -277,12 +293,27 @@ void SupportPointGenerator::process(const std::vector<ExPolygons>& slices, const
                     above_link.island->supports_force_inherited += below_support_force * above_link.overlap_area / above_overlap_area;
             }
         }
+        // Sampling the new islands and the overhangs does not depend on the support points placed so far, sample the islands
+        // of the layer in parallel. Each island gets its own random generator seeded in order to keep the output deterministic.
+        std::vector<IslandSamples> island_samples(layer_top->islands.size());
+        for (IslandSamples &samples : island_samples)
+            samples.rng.seed(m_rng());
+        execution::for_each(ex_tbb, size_t(0), island_samples.size(), [this, layer_top, &island_samples](size_t idx) {
+            const Structure &s       = layer_top->islands[idx];
+            IslandSamples   &samples = island_samples[idx];
+            if (s.islands_below.empty())
+                samples.samples = this->sample_islands({ *s.polygon }, IslandCoverageFlags(icfIsNew | icfWithBoundary), samples.rng);
+            else if (! s.overhangs.empty())
+                samples.samples = this->sample_islands(s.overhangs, icfNone, samples.rng);
+        }, execution::max_concurrency(ex_tbb));
+
         // Now iterate over all polygons and append new points if needed.
-        for (Structure &s : layer_top->islands) {
+        for (size_t idx = 0; idx < layer_top->islands.size(); ++ idx) {
+            Structure &s = layer_top->islands[idx];
             // Penalization resulting from large diff from the last layer:
             s.supports_force_inherited /= std::max(1.f, 0.17f * (s.overhangs_area) / s.area);
 
-            add_support_points(s, point_grid);
+            add_support_points(s, point_grid, island_samples[idx]);
         }
 
         m_throw_on_cancel();
@@ -292,7 +323,7 @@ void SupportPointGenerator::process(const std::vector<ExPolygons>& slices, const
     }
 }
 
-void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure &s, SupportPointGenerator::PointGrid3D &grid3d)
+void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure &s, SupportPointGenerator::PointGrid3D &grid3d, IslandSamples &samples)
 {
     // Select each type of surface (overrhang, dangling, slope), derive the support
     // force deficit for it and call uniformly conver with the right params
@@ -303,12 +334,12 @@ void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure
     if (s.islands_below.empty()) {
         // completely new island - needs support no doubt
         // deficit is full, there is nothing below that would hold this island
-        uniformly_cover({ *s.polygon }, s, s.area * tp, grid3d, IslandCoverageFlags(icfIsNew | icfWithBoundary) );
+        uniformly_cover({ *s.polygon }, s, s.area * tp, grid3d, samples.rng, IslandCoverageFlags(icfIsNew | icfWithBoundary), &samples.samples);
         return;
     }
 
     if (! s.overhangs.empty()) {
-        uniformly_cover(s.overhangs, s, s.overhangs_area * tp, grid3d);
+        uniformly_cover(s.overhangs, s, s.overhangs_area * tp, grid3d, samples.rng, icfNone, &samples.samples);
     }
 
     auto areafn = [](double sum, auto &p) { return sum + p.area() * SCALING_FACTOR * SCALING_FACTOR; };
@@ -319,13 +350,13 @@ void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure
         // What we now have in polygons needs support, regardless of what the forces are, so we can add them.
 
         double a = std::accumulate(s.dangling_areas.begin(), s.dangling_areas.end(), 0., areafn);
-        uniformly_cover(s.dangling_areas, s, a * tp - a * current * s.area, grid3d, icfWithBoundary);
+        uniformly_cover(s.dangling_areas, s, a * tp - a * current * s.area, grid3d, samples.rng, icfWithBoundary);
     }
 
     current = s.supports_force_total();
     if (! s.overhangs_slopes.empty()) {
         double a = std::accumulate(s.overhangs_slopes.begin(), s.overhangs_slopes.end(), 0., areafn);
-        uniformly_cover(s.overhangs_slopes, s, a * tp - a * current / s.area, grid3d, icfWithBoundary);
+        uniformly_cover(s.overhangs_slopes, s, a * tp - a * current / s.area, grid3d, samples.rng, icfWithBoundary);
     }
 }
 
@@ -540,7 +571,24 @@ static inline std::vector<Vec2f> poisson_disk_from_samples(const std::vector<Vec
 }
 
 
-void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, PointGrid3D &grid3d, IslandCoverageFlags flags)
+float SupportPointGenerator::initial_poisson_radius() const
+{
+    const float density_horizontal = m_config.tear_pressure() / m_config.support_force();
+    //FIXME why?
+    return std::max(m_config.minimal_distance, 1.f / (5.f * density_horizontal));
+//    return 1.f / (15.f * density_horizontal);
+}
+
+std::vector<Vec2f> SupportPointGenerator::sample_islands(const ExPolygons& islands, IslandCoverageFlags flags, std::mt19937 &rng) const
+{
+    const float poisson_radius  = initial_poisson_radius();
+    const float samples_per_mm2 = 30.f / (float(M_PI) * poisson_radius * poisson_radius);
+    return flags & icfWithBoundary ?
+        sample_expolygon_with_boundary(islands, samples_per_mm2, 5.f / poisson_radius, rng) :
+        sample_expolygon(islands, samples_per_mm2, rng);
+}
+
+void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, PointGrid3D &grid3d, std::mt19937 &rng, IslandCoverageFlags flags, std::vector<Vec2f> *samples)
 {
     //int num_of_points = std::max(1, (int)((island.area()*pow(SCALING_FACTOR, 2) * m_config.tear_pressure)/m_config.support_force));
 
@@ -564,22 +612,12 @@ void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure
     // Number of newly added points.
     const size_t poisson_samples_target = size_t(ceil(support_force_deficit / m_config.support_force()));
 
-    const float density_horizontal = m_config.tear_pressure() / m_config.support_force();
-    //FIXME why?
-    float poisson_radius		= std::max(m_config.minimal_distance, 1.f / (5.f * density_horizontal));
-//    const float poisson_radius     = 1.f / (15.f * density_horizontal);
-    const float samples_per_mm2 = 30.f / (float(M_PI) * poisson_radius * poisson_radius);
+    float poisson_radius		= initial_poisson_radius();
     // Minimum distance between samples, in 3D space.
 //    float min_spacing			= poisson_radius / 3.f;
     float min_spacing			= poisson_radius;
 
-    //FIXME share the random generator. The random generator may be not so cheap to initialize, also we don't want the random generator to be restarted for each polygon.
-
-    std::vector<Vec2f> raw_samples =
-        flags & icfWithBoundary ?
-            sample_expolygon_with_boundary(islands, samples_per_mm2,
-                                           5.f / poisson_radius, m_rng) :
-            sample_expolygon(islands, samples_per_mm2, m_rng);
+    std::vector<Vec2f> raw_samples = samples ? std::move(*samples) : sample_islands(islands, flags, rng);
 
     std::vector<Vec2f>  poisson_samples;
     for (size_t iter = 0; iter < 4; ++ iter) {
@@ -611,7 +649,7 @@ void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure
 
 //    assert(! poisson_samples.empty());
     if (poisson_samples_target < poisson_samples.size()) {
-        std::shuffle(poisson_samples.begin(), poisson_samples.end(), m_rng);
+        std::shuffle(poisson_samples.begin(), poisson_samples.end(), rng);
         poisson_samples.erase(poisson_samples.begin() + poisson_samples_target, poisson_samples.end());
     }
     for (const Vec2f &pt : poisson_samples) {
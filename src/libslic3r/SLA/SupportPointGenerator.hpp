@@ -222,9 +222,22 @@ public:
 
 private:
 
-    void uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, PointGrid3D &grid3d, IslandCoverageFlags flags = icfNone);
+    // Random generator and samples of an island prepared before its support points are placed.
+    struct IslandSamples {
+        std::mt19937       rng;
+        // Samples of a new island or of the overhangs of an island.
+        std::vector<Vec2f> samples;
+    };
+
+    // Initial radius of the Poisson disk sampling of uniformly_cover().
+    float initial_poisson_radius() const;
+    // Random samples of the islands to be covered by support points. The samples don't depend on the support points placed already.
+    std::vector<Vec2f> sample_islands(const ExPolygons& islands, IslandCoverageFlags flags, std::mt19937 &rng) const;
+
+    // If samples are not provided, the islands are sampled by sample_islands().
+    void uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, PointGrid3D &grid3d, std::mt19937 &rng, IslandCoverageFlags flags = icfNone, std::vector<Vec2f> *samples = nullptr);
 
-    void add_support_points(Structure& structure, PointGrid3D &grid3d);
+    void add_support_points(Structure& structure, PointGrid3D &grid3d, IslandSamples &samples);
 
     void project_onto_mesh(std::vector<SupportPoint>& points) const;
 
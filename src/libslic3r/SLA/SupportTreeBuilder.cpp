@@ -8,6 +8,7 @@
 #include "libslic3r/BoundingBox.hpp"
 #include "libslic3r/SLA/SupportTree.hpp"
 #include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/Execution/ExecutionTBB.hpp"
 
 namespace Slic3r {
 namespace sla {
@@ -91,46 +92,56 @@ const indexed_triangle_set &SupportTreeBuilder::merged_mesh(size_t steps) const
 {
     if (m_meshcache_valid) return m_meshcache;
     
-    indexed_triangle_set merged;
-    
-    for (auto &head : m_heads) {
-        if (ctl().stopcondition()) break;
-        if (head.is_valid()) its_merge(merged, get_mesh(head, steps));
-    }
-    
-    for (auto &pill : m_pillars) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(pill, steps));
-    }
-
-    for (auto &pedest : m_pedestals) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(pedest, steps));
-    }
-    
-    for (auto &j : m_junctions) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(j, steps));
+    // Meshes of all the elements, in the order of the element types.
+    size_t n_elements = m_heads.size() + m_pillars.size() + m_pedestals.size() + m_junctions.size() +
+                        m_bridges.size() + m_crossbridges.size() + m_diffbridges.size() + m_anchors.size();
+    std::vector<indexed_triangle_set> meshes(n_elements);
+
+    auto mesh_of = [this, steps](size_t idx) -> indexed_triangle_set {
+        if (idx < m_heads.size())
+            return m_heads[idx].is_valid() ? get_mesh(m_heads[idx], steps) : indexed_triangle_set{};
+        idx -= m_heads.size();
+        if (idx < m_pillars.size()) return get_mesh(m_pillars[idx], steps);
+        idx -= m_pillars.size();
+        if (idx < m_pedestals.size()) return get_mesh(m_pedestals[idx], steps);
+        idx -= m_pedestals.size();
+        if (idx < m_junctions.size()) return get_mesh(m_junctions[idx], steps);
+        idx -= m_junctions.size();
+        if (idx < m_bridges.size()) return get_mesh(m_bridges[idx], steps);
+        idx -= m_bridges.size();
+        if (idx < m_crossbridges.size()) return get_mesh(m_crossbridges[idx], steps);
+        idx -= m_crossbridges.size();
+        if (idx < m_diffbridges.size()) return get_mesh(m_diffbridges[idx], steps);
+        idx -= m_diffbridges.size();
+        return get_mesh(m_anchors[idx], steps);
+    };
+
+    // Generate the element meshes in parallel, then copy them into a preallocated mesh.
+    execution::for_each(ex_tbb, size_t(0), n_elements, [this, &meshes, &mesh_of](size_t idx) {
+        if (! ctl().stopcondition())
+            meshes[idx] = mesh_of(idx);
+    }, 64);
+
+    std::vector<size_t> vertices_offset(n_elements + 1, 0);
+    std::vector<size_t> indices_offset(n_elements + 1, 0);
+    for (size_t i = 0; i < n_elements; ++ i) {
+        vertices_offset[i + 1] = vertices_offset[i] + meshes[i].vertices.size();
+        indices_offset[i + 1]  = indices_offset[i] + meshes[i].indices.size();
     }
 
-    for (auto &bs : m_bridges) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(bs, steps));
-    }
-    
-    for (auto &bs : m_crossbridges) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(bs, steps));
-    }
-
-    for (auto &bs : m_diffbridges) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(bs, steps));
-    }
-
-    for (auto &anch : m_anchors) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(anch, steps));
+    indexed_triangle_set merged;
+    if (! ctl().stopcondition()) {
+        merged.vertices.resize(vertices_offset.back());
+        merged.indices.resize(indices_offset.back());
+        execution::for_each(ex_tbb, size_t(0), n_elements, [&meshes, &merged, &vertices_offset, &indices_offset](size_t idx) {
+            const indexed_triangle_set &mesh = meshes[idx];
+            std::copy(mesh.vertices.begin(), mesh.vertices.end(), merged.vertices.begin() + vertices_offset[idx]);
+            const auto offset = int(vertices_offset[idx]);
+            std::transform(mesh.indices.begin(), mesh.indices.end(), merged.indices.begin() + indices_offset[idx],
+                           [offset](const stl_triangle_vertex_indices &face) -> stl_triangle_vertex_indices { return face.array() + offset; });
+            // Release the element mesh as soon as it is copied.
+            meshes[idx] = {};
+        }, 64);
     }
 
     if (ctl().stopcondition()) {
@@ -7,9 +7,41 @@
 #include <cmath>
 #include <cassert>
 #include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
 
 namespace Slic3r { namespace sla {
 
+namespace {
+
+// Unit meshes by the number of steps, one cache per generator. The meshes are
+// never released, there are just a few detail levels in use.
+template<class Generator>
+const indexed_triangle_set &cached_unit_mesh(size_t steps, Generator &&generate)
+{
+    static std::mutex mutex;
+    static std::map<size_t, std::unique_ptr<indexed_triangle_set>> meshes;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<indexed_triangle_set> &mesh = meshes[steps];
+    if (! mesh)
+        mesh = std::make_unique<indexed_triangle_set>(generate(steps));
+    return *mesh;
+}
+
+} // namespace
+
+// The vertices of sphere() and of its_make_cylinder() scale linearly with the radius and the height.
+const indexed_triangle_set &unit_sphere(size_t steps)
+{
+    return cached_unit_mesh(steps, [](size_t steps) { return sphere(1., make_portion(0, PI), 2 * PI / steps); });
+}
+
+const indexed_triangle_set &unit_cylinder(size_t steps)
+{
+    return cached_unit_mesh(steps, [](size_t steps) { return its_make_cylinder(1., 1., 2 * PI / steps); });
+}
+
 indexed_triangle_set sphere(double rho, Portion portion, double fa) {
 
     indexed_triangle_set ret;
@@ -245,13 +277,15 @@ indexed_triangle_set get_mesh(const Bridge &br, size_t steps)
     Vec3d dir = v.normalized();
     double d = v.norm();
 
-    indexed_triangle_set mesh = cylinder(br.r, d, steps);
+    indexed_triangle_set mesh = unit_cylinder(steps);
 
     auto quater = Quaternion::FromTwoVectors(Vec3f{0.f, 0.f, 1.f},
                                              dir.cast<float>());
 
+    // Scale the unit cylinder, rotate and move it in a single pass.
+    const Vec3f scale{ float(br.r), float(br.r), float(d) };
     Vec3f startp = br.startp.cast<float>();
-    for(auto& p : mesh.vertices) p = quater * p + startp;
+    for(auto& p : mesh.vertices) p = quater * p.cwiseProduct(scale) + startp;
 
     return mesh;
 }
@@ -29,6 +29,12 @@ indexed_triangle_set sphere(double  rho,
                             Portion portion = make_portion(0., PI),
                             double  fa      = (2. * PI / 360.));
 
+// Canonical meshes of a unit sphere and of a unit cylinder for the given number of steps.
+// They are generated once and shared by all the support elements, which only
+// scale and transform them.
+const indexed_triangle_set &unit_sphere(size_t steps);
+const indexed_triangle_set &unit_cylinder(size_t steps);
+
 // Down facing cylinder in Z direction with arguments:
 // r: radius
 // h: height
@@ -38,7 +44,10 @@ inline indexed_triangle_set cylinder(double       r,
                               double       h,
                               size_t       steps = 45)
 {
-    return its_make_cylinder(r, h, 2 * PI / steps);
+    indexed_triangle_set mesh = unit_cylinder(steps);
+    const Vec3f scale{ float(r), float(r), float(h) };
+    for (auto &p : mesh.vertices) p = p.cwiseProduct(scale);
+    return mesh;
 }
 
 indexed_triangle_set pinhead(double r_pin,
@@ -73,9 +82,13 @@ inline indexed_triangle_set get_mesh(const Pedestal &p, size_t steps)
 
 inline indexed_triangle_set get_mesh(const Junction &j, size_t steps)
 {
-    indexed_triangle_set mesh = sphere(j.r, make_portion(0, PI), 2 * PI / steps);
+    // prohibit close to zero radius, see sphere()
+    if (j.r <= 1e-6 && j.r >= -1e-6) return {};
+
+    indexed_triangle_set mesh = unit_sphere(steps);
+    auto  r   = float(j.r);
     Vec3f pos = j.pos.cast<float>();
-    for(auto& p : mesh.vertices) p += pos;
+    for(auto& p : mesh.vertices) p = p * r + pos;
     return mesh;
 }
 
@@ -9,6 +9,7 @@
 #include <optional>
 
 #include <libslic3r/Execution/Execution.hpp>
+#include <libslic3r/KDTreeIndirect.hpp>
 #include <libslic3r/Optimize/NLoptOptimizer.hpp>
 #include <libslic3r/Optimize/BruteforceOptimizer.hpp>
 #include <libslic3r/MeshNormals.hpp>
@@ -294,25 +295,31 @@ inline double distance(const SupportPoint &a, const SupportPoint &b)
     return (a.pos - b.pos).norm();
 }
 
-template<class PtIndex>
-std::vector<size_t> non_duplicate_suppt_indices(const PtIndex &index,
+// A support point is a duplicate if the closest of the support points, which are not duplicates, is closer than eps.
+// The neighbourhoods of the points are searched in parallel, a point is a duplicate if any of its neighbours closer
+// than eps is not a duplicate, which gives the same result as testing the closest one sequentially.
+template<class Ex, class PtIndex>
+std::vector<size_t> non_duplicate_suppt_indices(Ex                   ex,
+                                                const PtIndex       &index,
                                                 const SupportPoints &suppts,
-                                                double         eps)
+                                                double               eps)
 {
+    auto positions = reserve_vector<Vec3f>(suppts.size());
+    for (const SupportPoint &sp : suppts)
+        positions.emplace_back(sp.pos);
+    // Inflated search radius, the neighbours are tested exactly below.
+    std::vector<std::vector<size_t>> neighbours =
+        batch_find_nearby_points(ex, index, positions, float(2. * eps));
+
     std::vector<bool> to_remove(suppts.size(), false);
 
-    for (size_t i = 0; i < suppts.size(); ++i) {
-        size_t closest_idx =
-            find_closest_point(index, suppts[i].pos,
-                               [&i, &to_remove](size_t i_closest) {
-                                   return i_closest != i &&
-                                          !to_remove[i_closest];
-                               });
-
-        if (closest_idx < suppts.size() &&
-            (suppts[i].pos - suppts[closest_idx].pos).norm() < eps)
-            to_remove[i] = true;
-    }
+    for (size_t i = 0; i < suppts.size(); ++i)
+        for (size_t j : neighbours[i])
+            if (j != i && !to_remove[j] &&
+                (suppts[i].pos - suppts[j].pos).norm() < eps) {
+                to_remove[i] = true;
+                break;
+            }
 
     auto ret = reserve_vector<size_t>(suppts.size());
     for (size_t i = 0; i < to_remove.size(); i++)
@@ -14,6 +14,7 @@
 
 #include "Geometry.hpp"
 #include "Thread.hpp"
+#include "Trace.hpp"
 
 #include <unordered_set>
 #include <numeric>
@@ -740,6 +741,8 @@ void SLAPrint::process()
     double st = Steps::min_objstatus;
 
     BOOST_LOG_TRIVIAL(info) << "Start slicing process.";
+    Trace::clear();
+    Trace::sample_memory("Start slicing process");
 
 #ifdef SLAPRINT_DO_BENCHMARK
     Benchmark bench;
@@ -804,6 +807,7 @@ void SLAPrint::process()
 
     // If everything vent well
     m_report_status(*this, 100, _u8L("Slicing done"));
+    Trace::sample_memory("Slicing done");
 
 #ifdef SLAPRINT_DO_BENCHMARK
     std::string csvbenchstr;
@@ -863,6 +867,7 @@ bool SLAPrint::invalidate_state_by_config_options(const std::vector<t_config_opt
         "display_mirror_y"sv,
         "display_orientation"sv,
         "sla_archive_format"sv,
+        "sla_archive_compression_level"sv,
         "sla_output_precision"sv,
         // tilt params
         "delay_before_exposure"sv,
@@ -956,6 +961,7 @@ bool SLAPrint::is_step_done(SLAPrintObjectStep step) const
 
 SLAPrintObject::SLAPrintObject(SLAPrint *print, ModelObject *model_object)
     : Inherited(print, model_object)
+    , m_cgal_boolean_cache(std::make_unique<csg::CGALBooleanCache>())
 {}
 
 SLAPrintObject::~SLAPrintObject() {}
@@ -970,7 +976,9 @@ bool SLAPrintObject::invalidate_state_by_config_options(const std::vector<t_conf
     std::vector<SLAPrintObjectStep> steps;
     bool invalidated = false;
     for (const t_config_option_key &opt_key : opt_keys) {
-        if (   opt_key == "hollowing_enable"
+        if (opt_key == "preview_booleans") {
+            steps.emplace_back(slaposAssembly);
+        } else if (   opt_key == "hollowing_enable"
             || opt_key == "hollowing_min_thickness"
             || opt_key == "hollowing_quality"
             || opt_key == "hollowing_closing_distance"
@@ -1298,17 +1306,4 @@ void SLAPrint::StatusReporter::operator()(SLAPrint &         p,
     p.set_status(int(std::round(st)), msg, flags);
 }
 
-namespace csg {
-
-MeshBoolean::cgal::CGALMeshPtr get_cgalmesh(const CSGPartForStep &part)
-{
-    if (!part.cgalcache && csg::get_mesh(part)) {
-        part.cgalcache = csg::get_cgalmesh(static_cast<const csg::CSGPart&>(part));
-    }
-
-    return part.cgalcache? clone(*part.cgalcache) : nullptr;
-}
-
-} // namespace csg
-
 } // namespace Slic3r
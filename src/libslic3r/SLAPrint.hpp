@@ -92,7 +92,6 @@ namespace Slic3r {
 struct CSGPartForStep : public csg::CSGPart
 {
     SLAPrintObjectStep key;
-    mutable MeshBoolean::cgal::CGALMeshPtr cgalcache;
 
     CSGPartForStep(SLAPrintObjectStep k, CSGPart &&p = {})
         : key{k}, CSGPart{std::move(p)}
@@ -109,11 +108,7 @@ struct CSGPartForStep : public csg::CSGPart
     bool operator<(const CSGPartForStep &other) const { return key < other.key; }
 };
 
-namespace csg {
-
-MeshBoolean::cgal::CGALMeshPtr get_cgalmesh(const CSGPartForStep &part);
-
-} // namespace csg
+namespace csg { class CGALBooleanCache; }
 
 class SLAPrintObject : public _SLAPrintObjectBase
 {
@@ -420,6 +415,23 @@ private:
     };
     
     std::unique_ptr<HollowingData> m_hollowing_data;
+
+    // Distance field of the assembled mesh kept between the runs of the
+    // hollowing step, so that changing the wall thickness or the closing
+    // distance does not voxelize the mesh again. Released when the mesh is
+    // assembled again or when hollowing is disabled.
+    struct HollowingGridCache
+    {
+        double            voxel_scale = 0.;
+        Slic3r::VoxelGridPtr grid;
+    };
+
+    HollowingGridCache m_hollowing_grid_cache;
+
+    // CGAL meshes of the parts in m_mesh_to_slice and the partial results of
+    // their booleans, kept between the runs of the print steps, so that moving
+    // a negative volume recomputes only the booleans following it.
+    std::unique_ptr<csg::CGALBooleanCache> m_cgal_boolean_cache;
 };
 
 using PrintObjects = std::vector<SLAPrintObject*>;
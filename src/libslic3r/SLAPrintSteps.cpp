@@ -55,6 +55,7 @@
 #include "libslic3r/SLA/SupportTree.hpp"
 #include "libslic3r/SLA/SupportTreeStrategies.hpp"
 #include "libslic3r/SLAPrint.hpp"
+#include "libslic3r/Trace.hpp"
 #include "libslic3r/TriangleMesh.hpp"
 
 namespace Slic3r {
@@ -159,8 +160,9 @@ void SLAPrint::Steps::apply_printer_corrections(SLAPrintObject &po, SliceOrigin
 indexed_triangle_set SLAPrint::Steps::generate_preview_vdb(
     SLAPrintObject &po, SLAPrintObjectStep step)
 {
-    // Empirical upper limit to not get excessive performance hit
+    // Empirical upper limits to not get excessive performance hit
     constexpr double MaxPreviewVoxelScale = 12.;
+    constexpr double MaxPreviewVoxels     = 16e6;
 
     // update preview mesh
     double vscale = std::min(MaxPreviewVoxelScale,
@@ -176,18 +178,35 @@ indexed_triangle_set SLAPrint::Steps::generate_preview_vdb(
     });
 
     auto r = range(po.m_mesh_to_slice);
-    auto grid = csg::voxelize_csgmesh(r, voxparams);
-    auto m = grid ? grid_to_mesh(*grid, 0., 0.01) : indexed_triangle_set{};
+
+    // Large objects are previewed with coarser voxels.
+    voxparams.voxel_scale(csg::adaptive_voxel_scale(r, voxparams, MaxPreviewVoxels));
+
+    auto m = csg::voxel_csgmesh_booleans(r, voxparams);
     float loss_less_max_error = float(1e-6);
     its_quadric_edge_collapse(m, 0U, &loss_less_max_error);
 
     return m;
 }
 
+// Number of triangles of all the parts of the csg collection.
+template<class Cont> size_t csgmesh_face_count(const Cont &csg)
+{
+    size_t cnt = 0;
+    for (const auto &m : csg)
+        if (const indexed_triangle_set *its = csg::get_mesh(m))
+            cnt += its->indices.size();
+
+    return cnt;
+}
+
 void SLAPrint::Steps::generate_preview(SLAPrintObject &po, SLAPrintObjectStep step)
 {
     using std::chrono::high_resolution_clock;
 
+    // Above this size of the input, SLAPreviewBooleans::Auto does not try the CGAL booleans.
+    constexpr size_t AutoApproximateFaceCount = 300000;
+
     auto start{high_resolution_clock::now()};
 
     auto r = range(po.m_mesh_to_slice);
@@ -195,13 +214,22 @@ void SLAPrint::Steps::generate_preview(SLAPrintObject &po, SLAPrintObjectStep st
 
     bool handled   = false;
 
+    SLAPreviewBooleans booleans = po.m_config.preview_booleans.value;
+    bool approximate = booleans == SLAPreviewBooleans::Approximate ||
+                       (booleans == SLAPreviewBooleans::Auto &&
+                        csgmesh_face_count(r) > AutoApproximateFaceCount);
+
     if (is_all_positive(r)) {
         m = csgmesh_merge_positive_parts(r);
         handled = true;
-    } else if (csg::check_csgmesh_booleans(r) == r.end()) {
+    } else if (approximate) {
+        // Requested by the user, thus no warning about the approximation.
+        m = generate_preview_vdb(po, step);
+        handled = true;
+    } else if (csg::check_csgmesh_booleans(r, *po.m_cgal_boolean_cache) == r.end()) {
         MeshBoolean::cgal::CGALMeshPtr cgalmeshptr;
         try {
-            cgalmeshptr = csg::perform_csgmesh_booleans(r);
+            cgalmeshptr = csg::perform_csgmesh_booleans(r, *po.m_cgal_boolean_cache);
         } catch (...) {
             // leaves cgalmeshptr as nullptr
         }
@@ -343,6 +371,7 @@ void SLAPrint::Steps::mesh_assembly(SLAPrintObject &po)
     po.m_mesh_to_slice.clear();
     po.m_supportdata.reset();
     po.m_hollowing_data.reset();
+    po.m_hollowing_grid_cache = {};
 
     csg::model_to_csgmesh(*po.model_object(), po.trafo(),
                           csg_inserter{po.m_mesh_to_slice, slaposAssembly},
@@ -360,6 +389,7 @@ void SLAPrint::Steps::hollow_model(SLAPrintObject &po)
 
     if (! po.m_config.hollowing_enable.getBool()) {
         BOOST_LOG_TRIVIAL(info) << "Skipping hollowing step!";
+        po.m_hollowing_grid_cache = {};
         return;
     }
 
@@ -373,8 +403,21 @@ void SLAPrint::Steps::hollow_model(SLAPrintObject &po)
     ctl.stopcondition = [this]() { return canceled(); };
     ctl.cancelfn = [this]() { throw_if_canceled(); };
 
-    sla::InteriorPtr interior =
-        generate_interior(po.mesh_to_slice(), hlwcfg, ctl);
+    // The voxelized mesh only depends on the voxel scale, reuse it if only
+    // the wall thickness or the closing distance changed.
+    double voxel_scale = sla::get_voxel_scale(po.mesh_to_slice(), hlwcfg);
+    SLAPrintObject::HollowingGridCache &cache = po.m_hollowing_grid_cache;
+    if (! cache.grid || cache.voxel_scale != voxel_scale) {
+        cache = {};
+        cache.grid = sla::generate_interior_grid(po.mesh_to_slice(), voxel_scale, ctl);
+        throw_if_canceled();
+        cache.voxel_scale = voxel_scale;
+    } else
+        BOOST_LOG_TRIVIAL(info) << "Reusing the voxelized mesh for hollowing";
+
+    sla::InteriorPtr interior;
+    if (cache.grid)
+        interior = generate_interior(*cache.grid, hlwcfg, ctl);
 
     if (!interior || sla::get_mesh(*interior).empty())
         BOOST_LOG_TRIVIAL(warning) << "Hollowed interior is empty!";
@@ -1155,19 +1198,29 @@ void SLAPrint::Steps::merge_slices_and_eval_stats() {
     const auto height         = scaled<double>(printer_config.display_height.getFloat());
     const double display_area = width*height;
 
-    std::vector<std::tuple<double, double, bool, double, double>> layers_info; // time, area, is_fast, models_volume, supports_volume
-    layers_info.resize(printer_input.size());
+    // Statistics of a single layer, calculated in parallel and accumulated sequentially.
+    struct LayerInfo {
+        double time            = 0.;
+        double area            = 0.;
+        bool   is_fast         = false;
+        double models_volume   = 0.;
+        double supports_volume = 0.;
+    };
+    std::vector<LayerInfo> layers_info(printer_input.size());
 
     const double delta_fade_time = (init_exp_time - exp_time) / (fade_layers_cnt + 1);
 
     // Going to parallel:
     auto printlayerfn = [this,
             // functions and read only vars
-            area_fill, display_area, exp_time, init_exp_time, fast_tilt, slow_tilt, hv_tilt, material_config, delta_fade_time, is_prusa_print, first_slow_layers, below, above,
+            area_fill, display_area, exp_time, init_exp_time, fast_tilt, slow_tilt, hv_tilt, &material_config, delta_fade_time, is_prusa_print, first_slow_layers, &below, &above,
 
             // write vars
             &layers_info](size_t sliced_layer_cnt)
     {
+        // The merging of the layers is expensive, stop early if canceled.
+        if (canceled()) return;
+
         PrintLayer &layer = m_print->m_printer_input[sliced_layer_cnt];
 
         // vector of slice record references
@@ -1287,30 +1340,35 @@ void SLAPrint::Steps::merge_slices_and_eval_stats() {
         layer_times += std::max(exp_time, init_exp_time - sliced_layer_cnt * delta_fade_time);
 
         // Collect values for this layer.
-        layers_info[sliced_layer_cnt] = std::make_tuple(layer_times, layer_area * SCALING_FACTOR * SCALING_FACTOR, is_fast_layer, models_volume, supports_volume);
+        layers_info[sliced_layer_cnt] = { layer_times, layer_area * SCALING_FACTOR * SCALING_FACTOR, is_fast_layer, models_volume, supports_volume };
     };
 
     // sequential version for debugging:
     // for(size_t i = 0; i < printer_input.size(); ++i) printlayerfn(i);
-    execution::for_each(ex_tbb, size_t(0), printer_input.size(), printlayerfn,
-                        execution::max_concurrency(ex_tbb));
+    // The cost of the layers differs a lot (large model layers vs. thin support layers),
+    // thus the layers are scheduled one by one for the threads to be well balanced.
+    execution::for_each(ex_tbb, size_t(0), printer_input.size(), printlayerfn, 1);
+    throw_if_canceled();
 
     print_statistics.clear();
 
     if (printer_input.size() == 0)
         print_statistics.estimated_print_time = NaNd;
     else {
-        size_t i=0;
-        for (const auto& [time, area, is_fast, models_volume, supports_volume] : layers_info) {
-            print_statistics.fast_layers_count += int(is_fast);
-            print_statistics.slow_layers_count += int(! is_fast);
-            print_statistics.layers_areas.emplace_back(area);
-            print_statistics.estimated_print_time += time;
-            print_statistics.layers_times_running_total.emplace_back(time + (i==0 ? 0. : print_statistics.layers_times_running_total[i-1]));
-            print_statistics.objects_used_material += models_volume  * SCALING_FACTOR * SCALING_FACTOR;
-            print_statistics.support_used_material += supports_volume * SCALING_FACTOR * SCALING_FACTOR;
-            ++i;
+        // Cheap sequential prefix pass accumulating the statistics of the layers.
+        print_statistics.layers_areas.reserve(layers_info.size());
+        print_statistics.layers_times_running_total.reserve(layers_info.size());
+        double running_time = 0.;
+        for (const LayerInfo &info : layers_info) {
+            print_statistics.fast_layers_count += int(info.is_fast);
+            print_statistics.slow_layers_count += int(! info.is_fast);
+            print_statistics.layers_areas.emplace_back(info.area);
+            running_time += info.time;
+            print_statistics.layers_times_running_total.emplace_back(running_time);
+            print_statistics.objects_used_material += info.models_volume  * SCALING_FACTOR * SCALING_FACTOR;
+            print_statistics.support_used_material += info.supports_volume * SCALING_FACTOR * SCALING_FACTOR;
         }
+        print_statistics.estimated_print_time = running_time;
         if (is_prusa_print)
             // For our SLA printers, we add an error of the estimate:
             print_statistics.estimated_print_time_tolerance = 0.03 * print_statistics.estimated_print_time;
@@ -1392,6 +1450,7 @@ double SLAPrint::Steps::progressrange(SLAPrintStep step) const
 
 void SLAPrint::Steps::execute(SLAPrintObjectStep step, SLAPrintObject &obj)
 {
+    Trace::Scope trace("step", label(step).c_str(), obj.model_object()->name);
     switch(step) {
     case slaposAssembly: mesh_assembly(obj); break;
     case slaposHollowing: hollow_model(obj); break;
@@ -1407,6 +1466,7 @@ void SLAPrint::Steps::execute(SLAPrintObjectStep step, SLAPrintObject &obj)
 
 void SLAPrint::Steps::execute(SLAPrintStep step)
 {
+    Trace::Scope trace("step", label(step));
     switch (step) {
     case slapsMergeSlicesAndEval: merge_slices_and_eval_stats(); break;
     case slapsRasterize: rasterize(); break;
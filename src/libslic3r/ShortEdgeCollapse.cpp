@@ -5,7 +5,8 @@
 #include "ShortEdgeCollapse.hpp"
 
 #include <boost/random/uniform_int_distribution.hpp>
-#include <ankerl/unordered_dense.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <random>
 #include <algorithm>
 #include <utility>
@@ -182,32 +183,44 @@ void its_short_edge_collpase(indexed_triangle_set &mesh, size_t target_triangle_
     }
 
     //Extract the result mesh
-    ankerl::unordered_dense::map<size_t, size_t> final_vertices_mapping;
+    // Flatten the vertex mapping, so that the final faces may be resolved in parallel.
+    for (size_t idx = 0; idx < vertices_index_mapping.size(); ++idx) {
+        get_final_index(idx);
+    }
+    std::vector<Vec3i> final_faces(face_indices.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, face_indices.size(), 4096),
+        [&mesh, &face_indices, &vertices_index_mapping, &final_faces](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++i) {
+                for (size_t j = 0; j < 3; ++j) {
+                    final_faces[i][j] = vertices_index_mapping[mesh.indices[face_indices[i]][j]];
+                }
+            }
+        });
+
+    // vertices are renumbered in the order of their first use
+    std::vector<int> final_vertices_mapping(mesh.vertices.size(), -1);
     std::vector<Vec3f> final_vertices;
     std::vector<Vec3i> final_indices;
-    final_indices.reserve(face_indices.size());
-    for (size_t idx : face_indices) {
-        Vec3i final_face;
-        for (size_t i = 0; i < 3; ++i) {
-            final_face[i] = get_final_index(mesh.indices[idx][i]);
-        }
+    final_indices.reserve(final_faces.size());
+    for (Vec3i final_face : final_faces) {
         if (final_face[0] == final_face[1] || final_face[1] == final_face[2] || final_face[2] == final_face[0]) {
             continue; // discard degenerate triangles
         }
 
         for (size_t i = 0; i < 3; ++i) {
-            if (final_vertices_mapping.find(final_face[i]) == final_vertices_mapping.end()) {
-                final_vertices_mapping[final_face[i]] = final_vertices.size();
+            int &final_vertex = final_vertices_mapping[final_face[i]];
+            if (final_vertex == -1) {
+                final_vertex = int(final_vertices.size());
                 final_vertices.push_back(mesh.vertices[final_face[i]]);
             }
-            final_face[i] = final_vertices_mapping[final_face[i]];
+            final_face[i] = final_vertex;
         }
 
         final_indices.push_back(final_face);
     }
 
-    mesh.vertices = final_vertices;
-    mesh.indices = final_indices;
+    mesh.vertices = std::move(final_vertices);
+    mesh.indices = std::move(final_indices);
 }
 
 } //namespace Slic3r
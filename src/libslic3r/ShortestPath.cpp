@@ -29,6 +29,41 @@
 
 namespace Slic3r {
 
+// The closest point queries of the greedy chaining algorithms below filter out the end points, which were already connected,
+// thus the queries slow down as the chains grow, approaching quadratic time complexity for a large number of short segments.
+// Rebuild the KD tree over the end points, which may still be connected to, once the number of end points connected since
+// the last rebuild exceeds half of the end points stored in the KD tree. Each rebuild costs O(n log n) and it is triggered
+// by O(n) connections, thus the amortized cost is O(log n) per connection.
+class KDTreePruning {
+public:
+	KDTreePruning(size_t num_points) : m_num_points_in_tree(num_points) {}
+
+	// To be called whenever end points stored in the KD tree were connected.
+	void removed(size_t num_points) { m_num_removed += num_points; }
+
+	// Rebuild the KD tree if enough end points were connected. valid(idx) shall return true if the idx-th end point
+	// may still be returned by any of the closest point queries to follow.
+	template<typename KDTreeType, typename ValidFn>
+	void update(KDTreeType &kdtree, size_t num_points, ValidFn valid) {
+		if (m_num_removed * 2 > m_num_points_in_tree && m_num_points_in_tree > 64) {
+			std::vector<size_t> indices;
+			indices.reserve(m_num_points_in_tree);
+			for (size_t idx = 0; idx < num_points; ++ idx)
+				if (valid(idx))
+					indices.emplace_back(idx);
+			m_num_removed = 0;
+			if (! indices.empty()) {
+				m_num_points_in_tree = indices.size();
+				kdtree.build(indices);
+			}
+		}
+	}
+
+private:
+	size_t m_num_points_in_tree;
+	size_t m_num_removed { 0 };
+};
+
 // Naive implementation of the Traveling Salesman Problem, it works by always taking the next closest neighbor.
 // This implementation will always produce valid result even if some segments cannot reverse.
 template<typename EndPointType, typename KDTreeType, typename CouldReverseFunc>
@@ -45,9 +80,11 @@ std::vector<std::pair<size_t, bool>> chain_segments_closest_point(std::vector<En
 	out.emplace_back(first_point_idx / 2, (first_point_idx & 1) != 0);
 	first_point.chain_id = 1;
 	size_t this_idx = first_point_idx ^ 1;
+	KDTreePruning kdtree_pruning(end_points.size());
 	for (int iter = (int)num_segments - 2; iter >= 0; -- iter) {
 		EndPointType &this_point = end_points[this_idx];
     	this_point.chain_id = 1;
+		kdtree_pruning.update(kdtree, end_points.size(), [&end_points](size_t idx) { return end_points[idx].chain_id == 0; });
     	// Find the closest point to this end_point, which lies on a different extrusion path (filtered by the lambda).
     	// Ignore the starting point as the starting point is considered to be occupied, no end point coud connect to it.
 		size_t next_idx = find_closest_point(kdtree, this_point.pos,
@@ -60,6 +97,7 @@ std::vector<std::pair<size_t, bool>> chain_segments_closest_point(std::vector<En
 		assert((next_idx & 1) == 0 || could_reverse_func(next_idx >> 1));
 		out.emplace_back(next_idx / 2, (next_idx & 1) != 0);
 		this_idx = next_idx ^ 1;
+		kdtree_pruning.removed(2);
 	}
 #ifndef NDEBUG
 	assert(end_points[this_idx].chain_id == 0);
@@ -266,6 +304,7 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 #ifndef NDEBUG
 		double distance_taken_last = 0.;
 #endif /* NDEBUG */
+		KDTreePruning kdtree_pruning(end_points.size());
 		for (int iter = int(num_segments) - 2;; -- iter) {
 			assert(validate_graph_and_queue());
 	    	// Take the first end point, for which the link points to the currently closest valid neighbor.
@@ -311,6 +350,7 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 								equivalent_chain.merge(end_point1_other_chain_id, end_point2_other_chain_id));
 				end_point1.chain_id = chain_id;
 				end_point2.chain_id = chain_id;
+				kdtree_pruning.removed(2);
 				assert(validate_graph_and_queue());
 				if (iter == 0) {
 					// Last iteration. There shall be exactly one or two end points waiting to be connected.
@@ -330,6 +370,8 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 				// This edge forms a loop. Update end_point1 and try another one.
 				++ iter;
 				end_point1.edge_out = nullptr;
+				// Only end points not connected yet may be connected to.
+				kdtree_pruning.update(kdtree, end_points.size(), [&end_points](size_t idx) { return end_points[idx].chain_id == 0; });
 		    	// Update edge_out and distance.
 		    	size_t this_idx = &end_point1 - &end_points.front();
 		    	// Find the closest point to this end_point, which lies on a different extrusion path (filtered by the filter lambda).
@@ -338,7 +380,7 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 			    	assert(end_points[this_idx].chain_id == 0);
 					if ((idx ^ this_idx) <= 1 || end_points[idx].chain_id != 0)
 						// Points of the same segment shall not be connected,
-						// cannot connect to an already connected point (ideally those would be removed from the KD tree, but the update is difficult).
+						// cannot connect to an already connected point (those are removed from the KD tree lazily, see KDTreePruning).
 						return false;
 			    	size_t chain1 = equivalent_chain(end_points[this_idx ^ 1].chain_id);
 			    	size_t chain2 = equivalent_chain(end_points[idx      ^ 1].chain_id);
@@ -353,8 +395,6 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 #endif /* NDEBUG */
 				// Update position of this end point in the queue based on the distance calculated at the line above.
 				queue.update(end_point1.heap_idx);
-		    	//FIXME Remove the other end point from the KD tree.
-		    	// As the KD tree update is expensive, do it only after some larger number of points is removed from the queue.
 				assert(validate_graph_and_queue());
 	    	}
 		}
@@ -403,9 +443,12 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 					} while (first_point != nullptr);
 				}
 			}
-			if (failed)
+			if (failed) {
 				// As a last resort, try a dumb algorithm, which is not sensitive to edge reversal constraints.
+				// It resets the chain IDs, thus it needs the KD tree over all the end points.
+				kdtree.build(end_points.size());
 				out = chain_segments_closest_point<EndPoint, decltype(kdtree), CouldReverseFunc>(end_points, kdtree, could_reverse_func, (initial_point != nullptr) ? *initial_point : end_points.front());
+			}
 		} else {
 			assert(! failed);
 		}
@@ -449,7 +492,7 @@ void update_end_point_in_queue(QueueType &queue, const KDTreeType &kdtree, Chain
 			size_t chain2b = end_points[idx ^ 1].chain_id;
 			if (chain2a > 0 && chain2b > 0)
 				// Only unconnected end point or a point next to an unconnected end point may be connected to.
-				// Ideally those would be removed from the KD tree, but the update is difficult.
+				// Those are removed from the KD tree lazily, see KDTreePruning.
 				return false;
 	    	assert(chain2a == 0 || chain2b == 0);
 	    	size_t chain2 = chains.equivalent(std::max(chain2a, chain2b));
@@ -770,8 +813,12 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 		// required is higher than expected (it would be the number of links, num_segments - 1).
 		// The limit here may not be necessary, but it guards us against an endless loop if something goes wrong.
 		size_t num_iter = num_segments * 16;
+		KDTreePruning kdtree_pruning(end_points.size());
 		for (size_t num_connections_to_end = num_segments - 1; num_iter > 0; -- num_iter) {
 			assert(validate_graph_and_queue());
+			// Segments connected at both ends are inside a chain for good, they may not be connected to anymore.
+			kdtree_pruning.update(kdtree, end_points.size(), [&end_points, first_point_idx](size_t idx) {
+				return idx != first_point_idx && (end_points[idx].chain_id == 0 || end_points[idx ^ 1].chain_id == 0); });
 	    	// Take the first end point, for which the link points to the currently closest valid neighbor.
 	    	EndPoint *end_point1       = queue.top();
 	    	assert(end_point1 != first_point);
@@ -879,6 +926,7 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 					chain.begin->chain_id = 0;
 				if (chain.end != first_point)
 					chain.end->chain_id = 0;
+				kdtree_pruning.removed(2);
 				if (-- num_connections_to_end == 0) {
 					assert(validate_graph_and_queue());
 					// Last iteration. There shall be exactly one or two end points waiting to be connected.
@@ -932,8 +980,6 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 //					printf("Warning: taking shorter length than previously is suspicious\n");
 				}
 #endif /* NDEBUG */
-		    	//FIXME Remove the other end point from the KD tree.
-		    	// As the KD tree update is expensive, do it only after some larger number of points is removed from the queue.
 		    }
 			assert(validate_graph_and_queue());
 		}
@@ -982,9 +1028,12 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 					} while (first_point != nullptr);
 				}
 			}
-			if (failed)
+			if (failed) {
 				// As a last resort, try a dumb algorithm, which is not sensitive to edge reversal constraints.
+				// It resets the chain IDs, thus it needs the KD tree over all the end points.
+				kdtree.build(end_points.size());
 				out = chain_segments_closest_point<EndPoint, decltype(kdtree), CouldReverseFunc>(end_points, kdtree, could_reverse_func, (initial_point != nullptr) ? *initial_point : end_points.front());
+			}
 		} else {
 			assert(! failed);
 		}
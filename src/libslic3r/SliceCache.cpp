@@ -0,0 +1,230 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#include "SliceCache.hpp"
+#include "Exception.hpp"
+#include "TriangleMeshSlicer.hpp"
+#include "Utils.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/cstdlib.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/uuid/detail/md5.hpp>
+
+#include "admesh/stl.h"
+
+namespace Slic3r::SliceCache {
+
+namespace {
+
+// Bump the version whenever the output of slice_mesh_ex() or the file format changes.
+constexpr const char     s_magic[8] = { 'P', 'S', 'S', 'L', 'I', 'C', 'E', '1' };
+constexpr const uint32_t s_version  = 1;
+
+std::string& directory_storage()
+{
+    static std::string s_directory = []() -> std::string {
+        const char *env = boost::nowide::getenv("SLIC3R_SLICE_CACHE");
+        return env == nullptr ? std::string() : std::string(env);
+    }();
+    return s_directory;
+}
+
+boost::filesystem::path entry_path(const std::string &key)
+{
+    return boost::filesystem::path(directory()) / (key + ".slices");
+}
+
+template<typename T> void write_pod(std::vector<char> &out, const T &value)
+{
+    const char *begin = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), begin, begin + sizeof(T));
+}
+
+// Sequential reader over a memory mapped cache entry with bounds checking.
+class Reader
+{
+public:
+    Reader(const char *data, size_t size) : m_ptr(data), m_end(data + size) {}
+
+    template<typename T> bool read(T &value) {
+        if (size_t(m_end - m_ptr) < sizeof(T))
+            return false;
+        memcpy(&value, m_ptr, sizeof(T));
+        m_ptr += sizeof(T);
+        return true;
+    }
+
+    bool read(Polygon &polygon) {
+        uint32_t num_points;
+        if (! this->read(num_points) || size_t(m_end - m_ptr) / sizeof(Point) < num_points)
+            return false;
+        polygon.points.resize(num_points);
+        memcpy(polygon.points.data(), m_ptr, num_points * sizeof(Point));
+        m_ptr += num_points * sizeof(Point);
+        return true;
+    }
+
+    size_t remaining() const { return size_t(m_end - m_ptr); }
+    bool   at_end() const { return m_ptr == m_end; }
+
+private:
+    const char *m_ptr;
+    const char *m_end;
+};
+
+void write(std::vector<char> &out, const Polygon &polygon)
+{
+    write_pod(out, uint32_t(polygon.points.size()));
+    const char *begin = reinterpret_cast<const char*>(polygon.points.data());
+    out.insert(out.end(), begin, begin + polygon.points.size() * sizeof(Point));
+}
+
+} // namespace
+
+void set_directory(const std::string &path)
+{
+    if (! path.empty()) {
+        boost::system::error_code ec;
+        boost::filesystem::create_directories(path, ec);
+        if (ec) {
+            BOOST_LOG_TRIVIAL(error) << "Slice cache: Failed to create directory " << path << ": " << ec.message();
+            directory_storage().clear();
+            return;
+        }
+    }
+    directory_storage() = path;
+}
+
+const std::string& directory()
+{
+    return directory_storage();
+}
+
+std::string key(const indexed_triangle_set &its, const std::vector<float> &zs, const MeshSlicingParamsEx &params)
+{
+    // boost::uuids::detail::md5 is an internal namespace thus it may change in the future, see AppConfig.cpp.
+    using boost::uuids::detail::md5;
+    md5 hash;
+    auto process = [&hash](const void *data, size_t size) { hash.process_bytes(data, size); };
+    auto process_pod = [&process](const auto &value) { process(&value, sizeof(value)); };
+
+    process(s_magic, sizeof(s_magic));
+    process_pod(s_version);
+    process_pod(uint64_t(its.vertices.size()));
+    process(its.vertices.data(), its.vertices.size() * sizeof(stl_vertex));
+    process_pod(uint64_t(its.indices.size()));
+    process(its.indices.data(), its.indices.size() * sizeof(stl_triangle_vertex_indices));
+    process_pod(uint64_t(zs.size()));
+    process(zs.data(), zs.size() * sizeof(float));
+    process_pod(params.mode);
+    process_pod(uint64_t(params.slicing_mode_normal_below_layer));
+    process_pod(params.mode_below);
+    process(params.trafo.matrix().data(), 16 * sizeof(double));
+    process_pod(params.closing_radius);
+    process_pod(params.extra_offset);
+    process_pod(params.resolution);
+
+    md5::digest_type digest{};
+    hash.get_digest(digest);
+    const auto *bytes = reinterpret_cast<const unsigned char*>(&digest);
+    std::string out;
+    out.reserve(2 * sizeof(digest));
+    for (size_t i = 0; i < sizeof(digest); ++ i) {
+        char buf[3];
+        snprintf(buf, sizeof(buf), "%02x", bytes[i]);
+        out += buf;
+    }
+    return out;
+}
+
+bool load(const std::string &key, std::vector<ExPolygons> &out)
+{
+    const boost::filesystem::path path = entry_path(key);
+    boost::system::error_code ec;
+    if (! boost::filesystem::exists(path, ec))
+        return false;
+
+    try {
+        boost::iostreams::mapped_file_source file(path);
+        Reader   reader(file.data(), file.size());
+        char     magic[sizeof(s_magic)];
+        uint32_t version;
+        uint32_t num_layers;
+        if (! reader.read(magic) || memcmp(magic, s_magic, sizeof(s_magic)) != 0 || ! reader.read(version) || version != s_version || ! reader.read(num_layers))
+            throw Slic3r::RuntimeError("Invalid header");
+        // Each layer, each ExPolygon and each hole occupies at least 4 bytes, don't allocate for counts of a corrupted file.
+        if (num_layers > reader.remaining() / 4)
+            throw Slic3r::RuntimeError("Truncated file");
+        std::vector<ExPolygons> layers(num_layers);
+        for (ExPolygons &layer : layers) {
+            uint32_t num_expolygons;
+            if (! reader.read(num_expolygons) || num_expolygons > reader.remaining() / 8)
+                throw Slic3r::RuntimeError("Truncated file");
+            layer.assign(num_expolygons, ExPolygon());
+            for (ExPolygon &expoly : layer) {
+                uint32_t num_holes;
+                if (! reader.read(expoly.contour) || ! reader.read(num_holes) || num_holes > reader.remaining() / 4)
+                    throw Slic3r::RuntimeError("Truncated file");
+                expoly.holes.assign(num_holes, Polygon());
+                for (Polygon &hole : expoly.holes)
+                    if (! reader.read(hole))
+                        throw Slic3r::RuntimeError("Truncated file");
+            }
+        }
+        if (! reader.at_end())
+            throw Slic3r::RuntimeError("Trailing data");
+        out = std::move(layers);
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(error) << "Slice cache: Ignoring invalid entry " << path.string() << ": " << ex.what();
+        return false;
+    }
+    BOOST_LOG_TRIVIAL(debug) << "Slice cache: Loaded " << path.string();
+    return true;
+}
+
+void store(const std::string &key, const std::vector<ExPolygons> &slices)
+{
+    std::vector<char> data;
+    write_pod(data, s_magic);
+    write_pod(data, s_version);
+    write_pod(data, uint32_t(slices.size()));
+    for (const ExPolygons &layer : slices) {
+        write_pod(data, uint32_t(layer.size()));
+        for (const ExPolygon &expoly : layer) {
+            write(data, expoly.contour);
+            write_pod(data, uint32_t(expoly.holes.size()));
+            for (const Polygon &hole : expoly.holes)
+                write(data, hole);
+        }
+    }
+
+    // Write into a temporary file first and rename it, so that processes sharing the cache never see a partial entry.
+    const boost::filesystem::path path      = entry_path(key);
+    const boost::filesystem::path temp_path = path.string() + "." + std::to_string(get_current_pid()) + ".tmp";
+    {
+        boost::nowide::ofstream file(temp_path.string(), std::ios::binary | std::ios::trunc);
+        file.write(data.data(), std::streamsize(data.size()));
+        if (! file.good()) {
+            BOOST_LOG_TRIVIAL(error) << "Slice cache: Failed to write " << temp_path.string();
+            file.close();
+            boost::system::error_code ec;
+            boost::filesystem::remove(temp_path, ec);
+            return;
+        }
+    }
+    boost::system::error_code ec;
+    boost::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        BOOST_LOG_TRIVIAL(error) << "Slice cache: Failed to store " << path.string() << ": " << ec.message();
+        boost::filesystem::remove(temp_path, ec);
+    }
+}
+
+} // namespace Slic3r::SliceCache
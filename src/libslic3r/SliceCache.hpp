@@ -0,0 +1,47 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef libslic3r_SliceCache_hpp_
+#define libslic3r_SliceCache_hpp_
+
+#include <string>
+#include <vector>
+
+#include "ExPolygon.hpp"
+
+struct indexed_triangle_set;
+
+namespace Slic3r {
+
+struct MeshSlicingParamsEx;
+
+// Optional content addressed on-disk cache of the slices of a single mesh.
+// The key is a hash of everything slice_mesh_ex() depends on: the triangles, the transformation,
+// the Z coordinates of the slicing planes (thus the layer height profile) and the slicing parameters
+// derived from the print configuration. Slicing the same object with print profiles differing in
+// non-slicing parameters (for example a different material) reloads the slices of the previous run.
+//
+// The cache is disabled by default. It is enabled by the --slice-cache command line option or by
+// the SLIC3R_SLICE_CACHE environment variable pointing to a directory. Entries are never evicted,
+// the directory is expected to be cleaned up externally.
+namespace SliceCache {
+
+// Empty path disables the cache. The directory is created if it does not exist.
+// Not thread safe, to be called before slicing is started.
+void               set_directory(const std::string &path);
+const std::string& directory();
+inline bool        enabled() { return ! directory().empty(); }
+
+// Key of slice_mesh_ex(its, zs, params).
+std::string        key(const indexed_triangle_set &its, const std::vector<float> &zs, const MeshSlicingParamsEx &params);
+// Returns false if the entry does not exist or if it is not valid, out is left untouched in that case.
+bool               load(const std::string &key, std::vector<ExPolygons> &out);
+// Failure to store the entry is only logged.
+void               store(const std::string &key, const std::vector<ExPolygons> &slices);
+
+} // namespace SliceCache
+
+} // namespace Slic3r
+
+#endif // libslic3r_SliceCache_hpp_
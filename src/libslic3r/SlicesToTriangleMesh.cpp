@@ -3,6 +3,7 @@
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
 #include <boost/log/trivial.hpp>
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 
@@ -17,33 +18,41 @@
 namespace Slic3r {
 
 // Same as walls() but with identical higher and lower polygons.
-indexed_triangle_set inline straight_walls(const Polygon &plate,
-                                     double         lo_z,
-                                     double         hi_z)
+// Appends to the mesh in place, the buffers are expected to be reserved by the caller.
+static void append_straight_walls(indexed_triangle_set &its, const Polygon &plate, double lo_z, double hi_z)
 {
-    return wall_strip(plate, lo_z, hi_z);
+    const int startidx = int(its.vertices.size());
+    const int offs     = int(plate.points.size());
+    // The expression unscaled(p).cast<float>().eval() is important here, see wall_strip().
+    for (const Point &p : plate.points)
+        its.vertices.emplace_back(to_3d(unscaled(p).cast<float>().eval(), float(lo_z)));
+    for (const Point &p : plate.points)
+        its.vertices.emplace_back(to_3d(unscaled(p).cast<float>().eval(), float(hi_z)));
+    for (int i = startidx + 1; i < startidx + offs; ++i) {
+        its.indices.emplace_back(i - 1, i, i + offs - 1);
+        its.indices.emplace_back(i, i + offs, i + offs - 1);
+    }
+    its.indices.emplace_back(startidx + offs - 1, startidx, startidx + 2 * offs - 1);
+    its.indices.emplace_back(startidx, startidx + offs, startidx + 2 * offs - 1);
 }
 
-indexed_triangle_set inline straight_walls(const ExPolygon &plate,
-                                     double           lo_z,
-                                     double           hi_z)
+static void append_straight_walls(indexed_triangle_set &its, const ExPolygons &slice, double lo_z, double hi_z)
 {
-    indexed_triangle_set ret = straight_walls(plate.contour, lo_z, hi_z);
-    for (auto &h : plate.holes)
-        its_merge(ret, straight_walls(h, lo_z, hi_z));
-
-    return ret;
+    for (const ExPolygon &poly : slice) {
+        append_straight_walls(its, poly.contour, lo_z, hi_z);
+        for (const Polygon &h : poly.holes)
+            append_straight_walls(its, h, lo_z, hi_z);
+    }
 }
 
-indexed_triangle_set inline straight_walls(const ExPolygons &slice,
-                                     double            lo_z,
-                                     double            hi_z)
+// A triangle soup produced by the tesselation, three vertices per triangle.
+static void append_triangles(indexed_triangle_set &its, const Pointf3s &triangles)
 {
-    indexed_triangle_set ret;
-    for (const ExPolygon &poly : slice)
-        its_merge(ret, straight_walls(poly, lo_z, hi_z));
-
-    return ret;
+    int idx = int(its.vertices.size());
+    for (const Vec3d &p : triangles)
+        its.vertices.emplace_back(p.cast<float>());
+    for (size_t i = 0; i < triangles.size(); i += 3, idx += 3)
+        its.indices.emplace_back(idx, idx + 1, idx + 2);
 }
 
 indexed_triangle_set slices_to_mesh(
@@ -52,41 +61,69 @@ indexed_triangle_set slices_to_mesh(
     const std::vector<float> &     grid)
 {
     assert(slices.size() == grid.size());
+    if (slices.empty())
+        return {};
 
+    // Each layer produces the caps at its z and the walls up to the next layer.
+    // The bottom cap with the walls of the first layer and the top cap are produced as two extra layers.
     using Layers = std::vector<indexed_triangle_set>;
-    Layers layers(slices.size());
-    size_t len = slices.size() - 1;
-
-    auto threads_cnt = execution::max_concurrency(ex_tbb);
-    execution::for_each(ex_tbb, size_t(0), len, [&slices, &layers, &grid](size_t i) {
-        const ExPolygons &upper = slices[i + 1];
-        const ExPolygons &lower = slices[i];
-
-        // Small 0 area artefacts can be created by diff_ex, and the
-        // tesselation also can create 0 area triangles. These will be removed
-        // by its_remove_degenerate_faces.
-        ExPolygons free_top = diff_ex(lower, upper);
-        ExPolygons overhang = diff_ex(upper, lower);
-        its_merge(layers[i], triangulate_expolygons_3d(free_top, grid[i], NORMALS_UP));
-        its_merge(layers[i], triangulate_expolygons_3d(overhang, grid[i], NORMALS_DOWN));
-        its_merge(layers[i], straight_walls(upper, grid[i], grid[i + 1]));
-        }, threads_cnt);
-
-    auto merge_fn = []( const indexed_triangle_set &a, const indexed_triangle_set &b ) {
-        indexed_triangle_set res{a}; its_merge(res, b); return res;
-    };
-
-    auto ret = execution::reduce(ex_tbb, layers.begin(), layers.end(),
-                                 indexed_triangle_set{}, merge_fn,
-                                 threads_cnt);
-
-    its_merge(ret, triangulate_expolygons_3d(slices.front(), zmin, NORMALS_DOWN));
-    its_merge(ret, straight_walls(slices.front(), zmin, grid.front()));
-    its_merge(ret, triangulate_expolygons_3d(slices.back(), grid.back(), NORMALS_UP));
+    const size_t len = slices.size() - 1;
+    Layers layers(slices.size() + 1);
+
+    execution::for_each(ex_tbb, size_t(0), layers.size(), [&slices, &layers, &grid, zmin, len](size_t i) {
+        indexed_triangle_set &layer = layers[i];
+        // Z range and the slice of the walls, triangles of the caps.
+        const ExPolygons *walls = nullptr;
+        double            walls_lo = 0., walls_hi = 0.;
+        Pointf3s          caps;
+        if (i < len) {
+            const ExPolygons &upper = slices[i + 1];
+            const ExPolygons &lower = slices[i];
+            // Small 0 area artefacts can be created by diff_ex, and the
+            // tesselation also can create 0 area triangles. These will be removed
+            // by its_remove_degenerate_faces.
+            caps = triangulate_expolygons_3d_parallel(diff_ex(lower, upper), grid[i], NORMALS_UP);
+            append(caps, triangulate_expolygons_3d_parallel(diff_ex(upper, lower), grid[i], NORMALS_DOWN));
+            walls    = &upper;
+            walls_lo = grid[i];
+            walls_hi = grid[i + 1];
+        } else if (i == len) {
+            caps     = triangulate_expolygons_3d_parallel(slices.front(), zmin, NORMALS_DOWN);
+            walls    = &slices.front();
+            walls_lo = zmin;
+            walls_hi = grid.front();
+        } else
+            caps     = triangulate_expolygons_3d_parallel(slices.back(), grid.back(), NORMALS_UP);
+        // Preallocate the layer, each wall segment produces two vertices and two triangles.
+        const size_t num_wall_points = walls ? count_points(*walls) : 0;
+        layer.vertices.reserve(caps.size() + 2 * num_wall_points);
+        layer.indices.reserve(caps.size() / 3 + 2 * num_wall_points);
+        append_triangles(layer, caps);
+        if (walls)
+            append_straight_walls(layer, *walls, walls_lo, walls_hi);
+    });
+
+    // Merge the layers into buffers allocated at once, the offsets of the layers are the prefix sums of their sizes.
+    std::vector<std::pair<size_t, size_t>> offsets(layers.size() + 1, { 0, 0 });
+    for (size_t i = 0; i < layers.size(); ++ i)
+        offsets[i + 1] = { offsets[i].first + layers[i].vertices.size(), offsets[i].second + layers[i].indices.size() };
+    indexed_triangle_set ret;
+    ret.vertices.resize(offsets.back().first);
+    ret.indices.resize(offsets.back().second);
+    execution::for_each(ex_tbb, size_t(0), layers.size(), [&layers, &offsets, &ret](size_t i) {
+        const indexed_triangle_set &layer = layers[i];
+        std::copy(layer.vertices.begin(), layer.vertices.end(), ret.vertices.begin() + offsets[i].first);
+        const int offset = int(offsets[i].first);
+        std::transform(layer.indices.begin(), layer.indices.end(), ret.indices.begin() + offsets[i].second,
+            [offset](const stl_triangle_vertex_indices &f) { return (f.array() + offset).matrix().eval(); });
+        // Release the layer early.
+        layers[i] = indexed_triangle_set();
+    });
 
     // FIXME: these repairs do not fix the mesh entirely. There will be cracks
     // in the output. It is very hard to do the meshing in a way that does not
     // leave errors.
+    // The vertices are welded across the layers by the parallel sort of its_merge_vertices().
     int num_mergedv = its_merge_vertices(ret);
     BOOST_LOG_TRIVIAL(debug) << "Merged vertices count: " << num_mergedv;
 
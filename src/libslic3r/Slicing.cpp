@@ -246,8 +246,13 @@ std::vector<double> layer_height_profile_adaptive(const SlicingParameters& slici
 {
     // 1) Initialize the SlicingAdaptive class with the object meshes.
     SlicingAdaptive as;
-    as.set_slicing_parameters(slicing_params);
     as.prepare(object);
+    return layer_height_profile_adaptive(slicing_params, as, quality_factor);
+}
+
+std::vector<double> layer_height_profile_adaptive(const SlicingParameters& slicing_params, SlicingAdaptive &as, float quality_factor)
+{
+    as.set_slicing_parameters(slicing_params);
 
     // 2) Generate layers using the algorithm of @platsch 
     std::vector<double> layer_height_profile;
@@ -258,14 +263,14 @@ std::vector<double> layer_height_profile_adaptive(const SlicingParameters& slici
         layer_height_profile.push_back(slicing_params.first_object_layer_height);
     }
     double print_z = slicing_params.first_object_layer_height;
-    // last facet visited by the as.next_layer_height() function, where the facets are sorted by their increasing Z span.
-    size_t current_facet = 0;
+    // facets crossing the last print_z visited by the as.next_layer_height() function, where the facets are sorted by their increasing Z span.
+    SlicingAdaptive::Cursor cursor;
     // loop until we have at least one layer and the max slice_z reaches the object height
     while (print_z + EPSILON < slicing_params.object_print_z_uncompensated_height()) {
         float height = slicing_params.max_layer_height;
         // Slic3r::debugf "\n Slice layer: %d\n", $id;
         // determine next layer height
-        float cusp_height = as.next_layer_height(float(print_z), quality_factor, current_facet);
+        float cusp_height = as.next_layer_height(float(print_z), quality_factor, cursor);
 
 #if 0
         // check for horizontal features and object size
@@ -28,6 +28,7 @@ class PrintConfig;
 class PrintObjectConfig;
 class ModelConfig;
 class ModelObject;
+class SlicingAdaptive;
 class DynamicPrintConfig;
 
 // Parameters to guide object slicing and support generation.
@@ -157,6 +158,11 @@ std::vector<coordf_t> layer_height_profile_from_ranges(
 std::vector<double> layer_height_profile_adaptive(
     const SlicingParameters& slicing_params,
     const ModelObject& object, float quality_factor);
+// Same as above with the faces collected by SlicingAdaptive::prepare() beforehand,
+// so that the profile is recalculated for another quality factor without collecting the faces again.
+std::vector<double> layer_height_profile_adaptive(
+    const SlicingParameters& slicing_params,
+    SlicingAdaptive& slicing_adaptive, float quality_factor);
 
 struct HeightProfileSmoothingParams
 {
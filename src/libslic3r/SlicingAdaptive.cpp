@@ -81,14 +81,28 @@ static inline float layer_height_from_slope(const SlicingAdaptive::FaceZ &face,
 void SlicingAdaptive::clear()
 {
 	m_faces.clear();
+	m_prepared_volumes.clear();
+	m_prepared_instance = Transform3d::Identity();
 }
 
 void SlicingAdaptive::prepare(const ModelObject &object)
 {
+    const ModelInstance &first_instance = *object.instances.front();
+    std::vector<std::pair<std::shared_ptr<const TriangleMesh>, Transform3d>> volumes;
+    for (const ModelVolume *volume : object.volumes)
+        if (volume->is_model_part())
+            volumes.emplace_back(volume->get_mesh_shared_ptr(), volume->get_matrix());
+    if (! m_faces.empty() && m_prepared_instance.isApprox(first_instance.get_matrix()) &&
+        std::equal(volumes.begin(), volumes.end(), m_prepared_volumes.begin(), m_prepared_volumes.end(),
+            [](const auto &l, const auto &r) { return l.first == r.first && l.second.isApprox(r.second); }))
+        // Faces of the same meshes were already collected.
+        return;
+
     this->clear();
+    m_prepared_volumes  = std::move(volumes);
+    m_prepared_instance = first_instance.get_matrix();
 
     TriangleMesh		 mesh			= object.raw_mesh();
-    const ModelInstance &first_instance = *object.instances.front();
     mesh.transform(first_instance.get_matrix(), first_instance.is_left_handed());
 
     // 1) Collect faces from mesh.
@@ -100,18 +114,18 @@ void SlicingAdaptive::prepare(const ModelObject &object)
 			std::min(std::min(vertex[0].z(), vertex[1].z()), vertex[2].z()),
 			std::max(std::max(vertex[0].z(), vertex[1].z()), vertex[2].z())
 		};
-		m_faces.emplace_back(FaceZ({ face_z_span, std::abs(n.z()), std::sqrt(n.x() * n.x() + n.y() * n.y()) }));
+		m_faces.emplace_back(FaceZ({ face_z_span, std::abs(n.z()), std::sqrt(n.x() * n.x() + n.y() * n.y()), 0.f }));
+		m_faces.back().height_factor = layer_height_from_slope(m_faces.back(), 1.f);
     }
 
 	// 2) Sort faces lexicographically by their Z span.
 	std::sort(m_faces.begin(), m_faces.end(), [](const FaceZ &f1, const FaceZ &f2) { return f1.z_span < f2.z_span; });
 }
 
-// current_facet is in/out parameter, rememebers the index of the last face of m_faces visited, 
-// where this function will start from.
+// cursor is in/out parameter, remembers the faces of m_faces crossing the last print_z.
 // print_z - the top print surface of the previous layer.
 // returns height of the next layer.
-float SlicingAdaptive::next_layer_height(const float print_z, float quality_factor, size_t &current_facet)
+float SlicingAdaptive::next_layer_height(const float print_z, float quality_factor, Cursor &cursor) const
 {
 	float  height = (float)m_slicing_params.max_layer_height;
 
@@ -135,29 +149,24 @@ float SlicingAdaptive::next_layer_height(const float print_z, float quality_fact
 	}
 	
 	// find all facets intersecting the slice-layer
-	size_t ordered_id = current_facet;
 	{
-		bool first_hit = false;
-		for (; ordered_id < m_faces.size(); ++ ordered_id) {
-	        const std::pair<float, float> &zspan = m_faces[ordered_id].z_span;
-	        // facet's minimum is higher than slice_z -> end loop
-			if (zspan.first >= print_z)
-				break;
-			// facet's maximum is higher than slice_z -> store the first event for next cusp_height call to begin at this point
-			if (zspan.second > print_z) {
-				// first event?
-				if (! first_hit) {
-					first_hit = true;
-					current_facet = ordered_id;
-	            }
-				// skip touching facets which could otherwise cause small cusp values
-				if (zspan.second < print_z + EPSILON)
-					continue;
-				// compute cusp-height for this facet and store minimum of all heights
-				height = std::min(height, layer_height_from_slope(m_faces[ordered_id], max_surface_deviation));
-	        }
+		// Facets newly starting below slice_z enter the sweep.
+		auto heap_greater = [](const std::pair<float, size_t> &l, const std::pair<float, size_t> &r) { return l > r; };
+		for (; cursor.next_face < m_faces.size() && m_faces[cursor.next_face].z_span.first < print_z; ++ cursor.next_face) {
+			cursor.active.emplace_back(m_faces[cursor.next_face].height_factor, cursor.next_face);
+			std::push_heap(cursor.active.begin(), cursor.active.end(), heap_greater);
+		}
+		// Facets ending below slice_z leave the sweep, including the touching facets which could otherwise cause small cusp values.
+		// As slice_z does not decrease, a facet removed will never cross slice_z again.
+		while (! cursor.active.empty() && m_faces[cursor.active.front().second].z_span.second < print_z + EPSILON) {
+			std::pop_heap(cursor.active.begin(), cursor.active.end(), heap_greater);
+			cursor.active.pop_back();
 		}
+		// The facet with the lowest height factor limits the cusp height the most.
+		if (! cursor.active.empty())
+			height = std::min(height, layer_height_from_slope(m_faces[cursor.active.front().second], max_surface_deviation));
 	}
+	size_t ordered_id = cursor.next_face;
 
 	// lower height limit due to printer capabilities
 	height = std::max(height, float(m_slicing_params.min_layer_height));
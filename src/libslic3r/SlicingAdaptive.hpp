@@ -8,10 +8,12 @@
 #define slic3r_SlicingAdaptive_hpp_
 
 #include <stddef.h>
+#include <memory>
 #include <utility>
 #include <vector>
 #include <cstddef>
 
+#include "Point.hpp"
 #include "Slicing.hpp"
 #include "admesh/stl.h"
 
@@ -20,17 +22,31 @@ namespace Slic3r
 
 class ModelVolume;
 class ModelObject;
+class TriangleMesh;
 
 class SlicingAdaptive
 {
 public:
     void  clear();
     void  set_slicing_parameters(SlicingParameters params) { m_slicing_params = params; }
+    // Collect and sort the faces of the object. The faces do not depend on the quality,
+    // thus prepare() does nothing if called again for an object with the same meshes and transformations.
     void  prepare(const ModelObject &object);
+
+    // State of the sweep of next_layer_height() over the faces sorted by their Z span.
+    struct Cursor {
+        // Index of the first face of m_faces starting above the last print_z.
+        size_t                              next_face { 0 };
+        // Min heap of the faces starting below the last print_z by their height_factor,
+        // the faces ending below print_z are removed lazily once they reach the top of the heap.
+        std::vector<std::pair<float, size_t>> active;
+    };
     // Return next layer height starting from the last print_z, using a quality measure
     // (quality in range from 0 to 1, 0 - highest quality at low layer heights, 1 - lowest print quality at high layer heights).
     // The layer height curve shall be centered roughly around the default profile's layer height for quality 0.5.
-	float next_layer_height(const float print_z, float quality, size_t &current_facet);
+    // print_z shall not decrease between the calls sharing the cursor, then the faces crossing print_z are found
+    // in logarithmic time instead of visiting all the faces starting below print_z.
+	float next_layer_height(const float print_z, float quality, Cursor &cursor) const;
     float horizontal_facet_distance(float z);
 
 	struct FaceZ {
@@ -39,12 +55,20 @@ public:
 		float					n_cos;
 		// Sine of the normal vector towards the Z axis.
 		float					n_sin;
+		// Layer height limited by the slope of this face for a unit surface deviation. The layer height
+		// for a quality is proportional to it, thus the faces are ordered by it independently of the quality.
+		float					height_factor;
 	};
 
 protected:
 	SlicingParameters 		m_slicing_params;
 
 	std::vector<FaceZ>		m_faces;
+
+	// Meshes and transformations of the model parts and the transformation of the first instance of the object
+	// m_faces were collected from. The meshes are held to recognize a replaced mesh.
+	std::vector<std::pair<std::shared_ptr<const TriangleMesh>, Transform3d>> m_prepared_volumes;
+	Transform3d				m_prepared_instance { Transform3d::Identity() };
 };
 
 }; // namespace Slic3r
@@ -608,27 +608,44 @@ static std::pair<int, int> discretize_circle(const Vec3f &center, const Vec3f &n
     return { begin, int(pts.size()) };
 }
 
-// Returns Z span of the generated mesh.
-static std::pair<float, float> extrude_branch(
+// Tube around a branch: A chain of 3D circles closed by half spheres, which end with the bottom and top apex points.
+// The tube is not triangulated in one go: Each range of slicing planes is sliced from a triangulation of just the circles
+// it may intersect, see slice_branch_tube(), thus the memory does not grow with the length of the branch.
+struct BranchTube
+{
+    struct Circle {
+        Vec3f center;
+        Vec3f normal;
+        float radius;
+        // Z span of the circle.
+        float zmin;
+        float zmax;
+    };
+    Vec3f               apex_bottom;
+    std::vector<Circle> circles;
+    Vec3f               apex_top;
+};
+
+static constexpr const float branch_tube_eps = 0.015f;
+
+static BranchTube branch_tube(
     const std::vector<const SupportElement*>    &path,
     const TreeSupportSettings                   &config,
-    const SlicingParameters                     &slicing_params,
-    const std::vector<SupportElements>          &move_bounds,
-    indexed_triangle_set                        &result)
+    const SlicingParameters                     &slicing_params)
 {
     Vec3d p1, p2, p3;
     Vec3d v1, v2;
     Vec3d nprev;
     Vec3d ncurrent;
     assert(path.size() >= 2);
-    static constexpr const float eps = 0.015f;
-    std::pair<int, int> prev_strip;
+    static constexpr const float eps = branch_tube_eps;
 
-//    char fname[2048];
-//    static int irun = 0;
-
-    float zmin = 0;
-    float zmax = 0;
+    BranchTube out;
+    auto add_circle = [&out](const Vec3f &center, const Vec3f &normal, float radius) {
+        // Half height of the circle projected to the Z axis.
+        const float dz = radius * std::sqrt(std::max(0.f, 1.f - sqr(normal.z())));
+        out.circles.push_back({ center, normal, radius, center.z() - dz, center.z() + dz });
+    };
 
     for (size_t ipath = 1; ipath < path.size(); ++ ipath) {
         const SupportElement &prev    = *path[ipath - 1];
@@ -644,20 +661,10 @@ static std::pair<float, float> extrude_branch(
             float angle_step = 2. * acos(1. - eps / radius);
             auto  nsteps     = int(ceil(M_PI / (2. * angle_step)));
             angle_step       = M_PI / (2. * nsteps);
-            int   ifan       = int(result.vertices.size());
-            result.vertices.emplace_back((p1 - nprev * radius).cast<float>());
-            zmin = result.vertices.back().z();
+            out.apex_bottom  = (p1 - nprev * radius).cast<float>();
             float angle = angle_step;
-            for (int i = 1; i < nsteps; ++ i, angle += angle_step) {
-                std::pair<int, int> strip = discretize_circle((p1 - nprev * radius * cos(angle)).cast<float>(), nprev.cast<float>(), radius * sin(angle), eps, result.vertices);
-                if (i == 1)
-                    triangulate_fan<false>(result, ifan, strip.first, strip.second);
-                else
-                    triangulate_strip(result, prev_strip.first, prev_strip.second, strip.first, strip.second);
-//                sprintf(fname, "d:\\temp\\meshes\\tree-partial-%d.obj", ++ irun);
-//                its_write_obj(result, fname);
-                prev_strip = strip;
-            }
+            for (int i = 1; i < nsteps; ++ i, angle += angle_step)
+                add_circle((p1 - nprev * radius * cos(angle)).cast<float>(), nprev.cast<float>(), radius * sin(angle));
         }
         if (ipath + 1 == path.size()) {
             // End of the tube.
@@ -668,45 +675,99 @@ static std::pair<float, float> extrude_branch(
             auto  nsteps = int(ceil(M_PI / (2. * angle_step)));
             angle_step = M_PI / (2. * nsteps);
             auto angle = float(M_PI / 2.);
-            for (int i = 0; i < nsteps; ++ i, angle -= angle_step) {
-                std::pair<int, int> strip = discretize_circle((p2 + ncurrent * radius * cos(angle)).cast<float>(), ncurrent.cast<float>(), radius * sin(angle), eps, result.vertices);
-                triangulate_strip(result, prev_strip.first, prev_strip.second, strip.first, strip.second);
-//                sprintf(fname, "d:\\temp\\meshes\\tree-partial-%d.obj", ++ irun);
-//                its_write_obj(result, fname);
-                prev_strip = strip;
-            }
-            int ifan = int(result.vertices.size());
-            result.vertices.emplace_back((p2 + ncurrent * radius).cast<float>());
-            zmax = result.vertices.back().z();
-            triangulate_fan<true>(result, ifan, prev_strip.first, prev_strip.second);
-//            sprintf(fname, "d:\\temp\\meshes\\tree-partial-%d.obj", ++ irun);
-//            its_write_obj(result, fname);
+            for (int i = 0; i < nsteps; ++ i, angle -= angle_step)
+                add_circle((p2 + ncurrent * radius * cos(angle)).cast<float>(), ncurrent.cast<float>(), radius * sin(angle));
+            out.apex_top = (p2 + ncurrent * radius).cast<float>();
         } else {
             const SupportElement &next = *path[ipath + 1];
             assert(current.state.layer_idx + 1 == next.state.layer_idx);
             p3 = to_3d(unscaled<double>(next.state.result_on_layer), layer_z(slicing_params, config, next.state.layer_idx));
             v2 = (p3 - p2).normalized();
             ncurrent = (v1 + v2).normalized();
-            float radius = unscaled<float>(support_element_radius(config, current));
-            std::pair<int, int> strip = discretize_circle(p2.cast<float>(), ncurrent.cast<float>(), radius, eps, result.vertices);
-            triangulate_strip(result, prev_strip.first, prev_strip.second, strip.first, strip.second);
-            prev_strip = strip;
-//            sprintf(fname, "d:\\temp\\meshes\\tree-partial-%d.obj", ++irun);
-//            its_write_obj(result, fname);
+            add_circle(p2.cast<float>(), ncurrent.cast<float>(), unscaled<float>(support_element_radius(config, current)));
         }
-#if 0
-        if (circles_intersect(p1, nprev, support_element_radius(settings, prev), p2, ncurrent, support_element_radius(settings, current))) {
-            // Cannot connect previous and current slice using a simple zig-zag triangulation,
-            // because the two circles intersect.
+    }
 
-        } else {
-            // Continue with chaining.
+    return out;
+}
 
-        }
-#endif
+// Triangulate circles [first, last] of a tube, closed by the bottom resp. top half sphere if bottom_cap resp. top_cap.
+// The triangles are the same, whichever range of circles is triangulated.
+static void triangulate_branch_tube(const BranchTube &tube, size_t first, size_t last, bool bottom_cap, bool top_cap, indexed_triangle_set &result)
+{
+    assert(first <= last && last < tube.circles.size());
+    assert(! bottom_cap || first == 0);
+    assert(! top_cap || last + 1 == tube.circles.size());
+    int ifan_bottom = -1;
+    if (bottom_cap) {
+        ifan_bottom = int(result.vertices.size());
+        result.vertices.emplace_back(tube.apex_bottom);
     }
+    std::pair<int, int> prev_strip;
+    for (size_t i = first; i <= last; ++ i) {
+        const BranchTube::Circle &circle = tube.circles[i];
+        std::pair<int, int> strip = discretize_circle(circle.center, circle.normal, circle.radius, branch_tube_eps, result.vertices);
+        if (i == first) {
+            if (bottom_cap)
+                triangulate_fan<false>(result, ifan_bottom, strip.first, strip.second);
+        } else
+            triangulate_strip(result, prev_strip.first, prev_strip.second, strip.first, strip.second);
+        prev_strip = strip;
+    }
+    if (top_cap) {
+        int ifan = int(result.vertices.size());
+        result.vertices.emplace_back(tube.apex_top);
+        triangulate_fan<true>(result, ifan, prev_strip.first, prev_strip.second);
+    }
+}
 
-    return std::make_pair(zmin, zmax);
+// Slice a tube at ascending slice_z, producing the same polygons as slicing the triangulation of the whole tube.
+// The slicing planes are processed in batches. Each batch slices the triangulation of the circles between the last circle
+// below the batch and the first circle above the batch, these boundary circles are not intersected by the slicing planes
+// of the batch, thus the open triangulation produces closed slices.
+static std::vector<Polygons> slice_branch_tube(
+    const BranchTube &tube, const std::vector<float> &slice_z, const MeshSlicingParams &mesh_slicing_params,
+    indexed_triangle_set &partial_mesh, std::function<void()> throw_on_cancel)
+{
+    // Batch of slicing planes, amortizing the slicing overhead over multiple layers.
+    static constexpr const size_t batch_size = 16;
+    // Clearance of the boundary circles from the slicing planes to account for the rounding of the discretized circles.
+    static constexpr const float  z_clearance = 1e-3f;
+
+    assert(std::is_sorted(slice_z.begin(), slice_z.end()));
+    const size_t num_circles = tube.circles.size();
+    assert(num_circles > 0);
+    // Maximum Z of the bottom apex and circles [0, i], minimum Z of circles [i, n) and the top apex.
+    std::vector<float> zmax_prefix(num_circles);
+    std::vector<float> zmin_suffix(num_circles);
+    for (size_t i = 0; i < num_circles; ++ i)
+        zmax_prefix[i] = std::max(i == 0 ? tube.apex_bottom.z() : zmax_prefix[i - 1], tube.circles[i].zmax);
+    for (size_t i = num_circles; i > 0; -- i)
+        zmin_suffix[i - 1] = std::min(i == num_circles ? tube.apex_top.z() : zmin_suffix[i], tube.circles[i - 1].zmin);
+
+    std::vector<Polygons> out;
+    out.reserve(slice_z.size());
+    std::vector<float> batch_z;
+    for (size_t ibatch = 0; ibatch < slice_z.size(); ibatch += batch_size) {
+        batch_z.assign(slice_z.begin() + ibatch, slice_z.begin() + std::min(ibatch + batch_size, slice_z.size()));
+        const float zlo = batch_z.front() - z_clearance;
+        const float zhi = batch_z.back()  + z_clearance;
+        // The last circle, which is above all the preceding circles and the bottom apex and which is below the batch.
+        auto  it_first = std::lower_bound(zmax_prefix.begin(), zmax_prefix.end(), zlo);
+        bool  bottom_cap = it_first == zmax_prefix.begin();
+        size_t first = bottom_cap ? 0 : size_t(it_first - zmax_prefix.begin()) - 1;
+        // The first circle, which is below all the following circles and the top apex and which is above the batch.
+        auto   it_last = std::upper_bound(zmin_suffix.begin(), zmin_suffix.end(), zhi);
+        bool   top_cap = it_last == zmin_suffix.end();
+        size_t last    = top_cap ? num_circles - 1 : size_t(it_last - zmin_suffix.begin());
+        if (first > last)
+            // Degenerate tube, triangulate it whole.
+            first = 0, last = num_circles - 1, bottom_cap = top_cap = true;
+        partial_mesh.clear();
+        triangulate_branch_tube(tube, first, last, bottom_cap, top_cap, partial_mesh);
+        append(out, slice_mesh(partial_mesh, batch_z, mesh_slicing_params, throw_on_cancel));
+    }
+    return out;
 }
 
 #ifdef TREE_SUPPORT_ORGANIC_NUDGE_NEW
@@ -1212,16 +1273,16 @@ void organic_draw_branches(
     mesh_slicing_params.mode = MeshSlicingParams::SlicingMode::Positive;
 
     tbb::parallel_for(tbb::blocked_range<size_t>(0, trees.size(), 1),
-        [&trees, &volumes, &config, &slicing_params, &move_bounds, &mesh_slicing_params, &throw_on_cancel](const tbb::blocked_range<size_t> &range) {
+        [&trees, &volumes, &config, &slicing_params, &mesh_slicing_params, &throw_on_cancel](const tbb::blocked_range<size_t> &range) {
             indexed_triangle_set    partial_mesh;
             std::vector<float>      slice_z;
             std::vector<Polygons>   bottom_contacts;
             for (size_t tree_id = range.begin(); tree_id < range.end(); ++ tree_id) {
                 Tree &tree = trees[tree_id];
                 for (const Branch &branch : tree.branches) {
-                    // Triangulate the tube.
-                    partial_mesh.clear();
-                    std::pair<float, float> zspan = extrude_branch(branch.path, config, slicing_params, move_bounds, partial_mesh);
+                    // Discretize the tube, it is triangulated and sliced by slice_branch_tube() piece by piece.
+                    const BranchTube tube = branch_tube(branch.path, config, slicing_params);
+                    std::pair<float, float> zspan { tube.apex_bottom.z(), tube.apex_top.z() };
                     LayerIndex layer_begin = branch.has_root ?
                         branch.path.front()->state.layer_idx : 
                         std::min(branch.path.front()->state.layer_idx, layer_idx_ceil(slicing_params, config, zspan.first));
@@ -1234,7 +1295,7 @@ void organic_draw_branches(
                         const double bottom_z = layer_idx > 0 ? layer_z(slicing_params, config, layer_idx - 1) : 0.;
                         slice_z.emplace_back(float(0.5 * (bottom_z + print_z)));
                     }
-                    std::vector<Polygons> slices = slice_mesh(partial_mesh, slice_z, mesh_slicing_params, throw_on_cancel);
+                    std::vector<Polygons> slices = slice_branch_tube(tube, slice_z, mesh_slicing_params, partial_mesh, throw_on_cancel);
                     bottom_contacts.clear();
                     //FIXME parallelize?
                     for (LayerIndex i = 0; i < LayerIndex(slices.size()); ++ i)
@@ -4,6 +4,7 @@
 ///|/
 #include <boost/container/static_vector.hpp>
 #include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/enumerable_thread_specific.h>
 #include <oneapi/tbb/parallel_for.h>
 #include <boost/log/trivial.hpp>
 #include <cmath>
@@ -350,24 +351,31 @@ SupportGeneratorLayersPtr generate_raft_base(
         const bool     brim_outer      = brim_type == btOuterOnly || brim_type == btOuterAndInner;
         const bool     brim_inner      = brim_type == btInnerOnly || brim_type == btOuterAndInner;
         const auto     brim_separation = scaled<float>(object.config().brim_separation.value + object.config().brim_width.value);
-        for (const ExPolygon &ex : object.layers().front()->lslices) {
+        // The islands are independent, offset them in parallel.
+        const ExPolygons     &islands = object.layers().front()->lslices;
+        std::vector<Polygons> brim_islands(islands.size());
+        clipper_batch(islands.size(), [&](size_t island_idx) {
+            const ExPolygon &ex          = islands[island_idx];
+            Polygons        &brim_island = brim_islands[island_idx];
             if (brim_outer && brim_inner)
-                polygons_append(brim, offset(ex, brim_separation));
+                brim_island = offset(ex, brim_separation);
             else {
                 if (brim_outer)
-                    polygons_append(brim, offset(ex.contour, brim_separation, ClipperLib::jtRound, float(scale_(0.1))));
+                    brim_island = offset(ex.contour, brim_separation, ClipperLib::jtRound, float(scale_(0.1)));
                 else
-                    brim.emplace_back(ex.contour);
+                    brim_island.emplace_back(ex.contour);
                 if (brim_inner) {
                     Polygons holes = ex.holes;
                     polygons_reverse(holes);
                     holes = shrink(holes, brim_separation, ClipperLib::jtRound, float(scale_(0.1)));
                     polygons_reverse(holes);
-                    polygons_append(brim, std::move(holes));
+                    polygons_append(brim_island, std::move(holes));
                 } else
-                    polygons_append(brim, ex.holes);
+                    polygons_append(brim_island, ex.holes);
             }
-        }
+        });
+        for (Polygons &brim_island : brim_islands)
+            polygons_append(brim, std::move(brim_island));
         brim = union_(brim);
     }
 
@@ -488,6 +496,33 @@ SupportGeneratorLayersPtr generate_raft_base(
     return raft_layers;
 }
 
+// Fill num_islands islands of a support layer by calling fill_island(dst, island_idx, filler).
+// If there are enough islands, they are filled in parallel. As the fillers are stateful, each thread fills with its own
+// copy of the filler. The extrusions are collected per island and appended to dst in the order of the islands.
+template<typename FillIslandFn>
+static inline void fill_islands(ExtrusionEntitiesPtr &dst, size_t num_islands, Fill *filler, FillIslandFn &&fill_island)
+{
+    static constexpr size_t min_islands_parallel = 4;
+    if (num_islands < min_islands_parallel) {
+        for (size_t idx = 0; idx < num_islands; ++ idx)
+            fill_island(dst, idx, filler);
+        return;
+    }
+    std::vector<ExtrusionEntitiesPtr> islands(num_islands);
+    tbb::enumerable_thread_specific<std::unique_ptr<Fill>> fillers([filler]() { return std::unique_ptr<Fill>(filler->clone()); });
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_islands), [&islands, &fillers, &fill_island](const tbb::blocked_range<size_t> &range) {
+        Fill *filler_local = fillers.local().get();
+        for (size_t idx = range.begin(); idx < range.end(); ++ idx)
+            fill_island(islands[idx], idx, filler_local);
+    });
+    size_t num_entities = dst.size();
+    for (const ExtrusionEntitiesPtr &island : islands)
+        num_entities += island.size();
+    dst.reserve(num_entities);
+    for (const ExtrusionEntitiesPtr &island : islands)
+        dst.insert(dst.end(), island.begin(), island.end());
+}
+
 static inline void fill_expolygon_generate_paths(
     ExtrusionEntitiesPtr    &dst,
     ExPolygon              &&expolygon,
@@ -519,8 +554,9 @@ static inline void fill_expolygons_generate_paths(
     ExtrusionRole            role,
     const Flow              &flow)
 {
-    for (ExPolygon &expoly : expolygons)
-        fill_expolygon_generate_paths(dst, std::move(expoly), filler, fill_params, density, role, flow);
+    fill_islands(dst, expolygons.size(), filler, [&expolygons, &fill_params, density, role, &flow](ExtrusionEntitiesPtr &dst_island, size_t idx, Fill *filler_island) {
+        fill_expolygon_generate_paths(dst_island, std::move(expolygons[idx]), filler_island, fill_params, density, role, flow);
+    });
 }
 
 static inline void fill_expolygons_generate_paths(
@@ -815,20 +851,23 @@ static inline void fill_expolygons_with_sheath_generate_paths(
     // Clip the sheath path to avoid the extruder to get exactly on the first point of the loop.
     const double clip_length = spacing * 0.15;
 
-    for (ExPolygon &expoly : closing_ex(polygons, float(SCALED_EPSILON), float(SCALED_EPSILON + 0.5*flow.scaled_width()))) {
+    ExPolygons islands = closing_ex(polygons, float(SCALED_EPSILON), float(SCALED_EPSILON + 0.5*flow.scaled_width()));
+    fill_islands(dst, islands.size(), filler, [&islands, &fill_params, density, role, &flow, no_sort, prefer_clockwise_movements, spacing, clip_length]
+        (ExtrusionEntitiesPtr &dst_island, size_t idx, Fill *filler_island) {
+        const ExPolygon &expoly = islands[idx];
         // Don't reorder the skirt and its infills.
         std::unique_ptr<ExtrusionEntityCollection> eec;
         if (no_sort) {
             eec = std::make_unique<ExtrusionEntityCollection>();
             eec->no_sort = true;
         }
-        ExtrusionEntitiesPtr &out = no_sort ? eec->entities : dst;
+        ExtrusionEntitiesPtr &out = no_sort ? eec->entities : dst_island;
         extrusion_entities_append_paths(out, draw_perimeters(expoly, clip_length, prefer_clockwise_movements), { ExtrusionRole::SupportMaterial, flow }, false);
         // Fill in the rest.
-        fill_expolygons_generate_paths(out, offset_ex(expoly, float(-0.4 * spacing)), filler, fill_params, density, role, flow);
+        fill_expolygons_generate_paths(out, offset_ex(expoly, float(-0.4 * spacing)), filler_island, fill_params, density, role, flow);
         if (no_sort && ! eec->empty())
-            dst.emplace_back(eec.release());
-    }
+            dst_island.emplace_back(eec.release());
+    });
 }
 
 // Support layers, partially processed.
@@ -1510,6 +1549,11 @@ void generate_support_toolpaths(
         [&support_layers, &raft_layers, &intermediate_layers, &config, &support_params, &slicing_params,
             &bbox_object, link_max_length_factor]
             (const tbb::blocked_range<size_t>& range) {
+        // The fillers are shared by all the raft layers of this range, their parameters are set up for each layer.
+        std::unique_ptr<Fill> filler_interface = std::unique_ptr<Fill>(Fill::new_from_type(support_params.raft_interface_fill_pattern));
+        std::unique_ptr<Fill> filler_support   = std::unique_ptr<Fill>(Fill::new_from_type(support_params.base_fill_pattern));
+        filler_interface->set_bounding_box(bbox_object);
+        filler_support->set_bounding_box(bbox_object);
         for (size_t support_layer_id = range.begin(); support_layer_id < range.end(); ++ support_layer_id)
         {
             assert(support_layer_id < raft_layers.size());
@@ -1517,11 +1561,6 @@ void generate_support_toolpaths(
             assert(support_layer.support_fills.entities.empty());
             SupportGeneratorLayer      &raft_layer    = *raft_layers[support_layer_id];
 
-            std::unique_ptr<Fill> filler_interface = std::unique_ptr<Fill>(Fill::new_from_type(support_params.raft_interface_fill_pattern));
-            std::unique_ptr<Fill> filler_support   = std::unique_ptr<Fill>(Fill::new_from_type(support_params.base_fill_pattern));
-            filler_interface->set_bounding_box(bbox_object);
-            filler_support->set_bounding_box(bbox_object);
-
             // Print the tree supports cutting through the raft with the exception of the 1st layer, where a full support layer will be printed below
             // both the raft and the trees.
             // Trim the raft layers with the tree polygons.
@@ -113,6 +113,8 @@ TreeModelVolumes::TreeModelVolumes(
         m_radius_0 = config.getRadius(0);
         m_raft_layers = config.raft_layers;
         m_current_outline_idx = 0;
+        // Calculated here rather than in precalculate(), as ceilRadius() and thus the cached areas depend on it, see reuse_caches().
+        this->calculate_ignorable_radii(config);
 
         m_layer_outlines.emplace_back(mesh_settings, std::vector<Polygons>{});
         std::vector<Polygons> &outlines = m_layer_outlines.front().second;
@@ -164,6 +166,72 @@ TreeModelVolumes::TreeModelVolumes(
 #endif
 }
 
+void TreeModelVolumes::calculate_ignorable_radii(const TreeSupportSettings &config)
+{
+    // calculate which radius each layer in the tip may have.
+    std::vector<coord_t> possible_tip_radiis;
+    for (size_t distance_to_top = 0; distance_to_top <= config.tip_layers; ++ distance_to_top) {
+        possible_tip_radiis.emplace_back(ceilRadius(config.getRadius(distance_to_top)));
+        possible_tip_radiis.emplace_back(ceilRadius(config.getRadius(distance_to_top) + m_current_min_xy_dist_delta));
+    }
+    sort_remove_duplicates(possible_tip_radiis);
+    // It theoretically may happen in the tip, that the radius can change so much in-between 2 layers, 
+    // that a ceil step is skipped (as in there is a radius r so that ceilRadius(radius(dtt))<ceilRadius(r)<ceilRadius(radius(dtt+1))). 
+    // As such a radius will not reasonable happen in the tree and it will most likely not be requested,
+    // there is no need to calculate them. So just skip these.
+    m_ignorable_radii.clear();
+    for (coord_t radius_eval = m_radius_0; radius_eval <= config.branch_radius; radius_eval = ceilRadius(radius_eval + 1))
+        if (! std::binary_search(possible_tip_radiis.begin(), possible_tip_radiis.end(), radius_eval))
+            m_ignorable_radii.emplace_back(radius_eval);
+}
+
+void TreeModelVolumesDeleter::operator()(TreeModelVolumes *p)
+{
+    delete p;
+}
+
+bool TreeModelVolumes::reuse_caches(TreeModelVolumes &&other)
+{
+    // Anything the cached areas depend on besides the radius and the layer index.
+    auto outlines_equal = [](const std::pair<TreeSupportMeshGroupSettings, std::vector<Polygons>> &l, const std::pair<TreeSupportMeshGroupSettings, std::vector<Polygons>> &r) {
+        return l.first.layer_height                     == r.first.layer_height &&
+               l.first.resolution                       == r.first.resolution &&
+               l.first.support_xy_distance              == r.first.support_xy_distance &&
+               l.first.support_top_distance             == r.first.support_top_distance &&
+               l.first.support_bottom_distance          == r.first.support_bottom_distance &&
+               l.first.support_material_buildplate_only == r.first.support_material_buildplate_only &&
+               l.second                                 == r.second;
+    };
+    if (m_max_move                   != other.m_max_move ||
+        m_max_move_slow              != other.m_max_move_slow ||
+        m_min_resolution             != other.m_min_resolution ||
+        m_current_outline_idx        != other.m_current_outline_idx ||
+        m_current_min_xy_dist        != other.m_current_min_xy_dist ||
+        m_current_min_xy_dist_delta  != other.m_current_min_xy_dist_delta ||
+        m_support_rests_on_model     != other.m_support_rests_on_model ||
+        m_increase_until_radius      != other.m_increase_until_radius ||
+        m_radius_0                   != other.m_radius_0 ||
+        m_ignorable_radii            != other.m_ignorable_radii ||
+        m_raft_layers                != other.m_raft_layers ||
+        m_machine_border             != other.m_machine_border ||
+        m_anti_overhang              != other.m_anti_overhang ||
+        ! std::equal(m_layer_outlines.begin(), m_layer_outlines.end(), other.m_layer_outlines.begin(), other.m_layer_outlines.end(), outlines_equal))
+        return false;
+
+    m_collision_cache                   = std::move(other.m_collision_cache);
+    m_collision_cache_holefree          = std::move(other.m_collision_cache_holefree);
+    m_avoidance_cache                   = std::move(other.m_avoidance_cache);
+    m_avoidance_cache_slow              = std::move(other.m_avoidance_cache_slow);
+    m_avoidance_cache_to_model          = std::move(other.m_avoidance_cache_to_model);
+    m_avoidance_cache_to_model_slow     = std::move(other.m_avoidance_cache_to_model_slow);
+    m_placeable_areas_cache             = std::move(other.m_placeable_areas_cache);
+    m_avoidance_cache_holefree          = std::move(other.m_avoidance_cache_holefree);
+    m_avoidance_cache_holefree_to_model = std::move(other.m_avoidance_cache_holefree_to_model);
+    m_wall_restrictions_cache           = std::move(other.m_wall_restrictions_cache);
+    m_wall_restrictions_cache_min       = std::move(other.m_wall_restrictions_cache_min);
+    return true;
+}
+
 void TreeModelVolumes::precalculate(const PrintObject& print_object, const coord_t max_layer, std::function<void()> throw_on_cancel)
 {
     auto t_start = std::chrono::high_resolution_clock::now();
@@ -174,25 +242,6 @@ void TreeModelVolumes::precalculate(const PrintObject& print_object, const coord
     // like inital layer diameter are only done in once.
     TreeSupportSettings config(m_layer_outlines[m_current_outline_idx].first, print_object.slicing_parameters());
 
-    {
-        // calculate which radius each layer in the tip may have.
-        std::vector<coord_t> possible_tip_radiis;
-        for (size_t distance_to_top = 0; distance_to_top <= config.tip_layers; ++ distance_to_top) {
-            possible_tip_radiis.emplace_back(ceilRadius(config.getRadius(distance_to_top)));
-            possible_tip_radiis.emplace_back(ceilRadius(config.getRadius(distance_to_top) + m_current_min_xy_dist_delta));
-        }
-        sort_remove_duplicates(possible_tip_radiis);
-        // It theoretically may happen in the tip, that the radius can change so much in-between 2 layers, 
-        // that a ceil step is skipped (as in there is a radius r so that ceilRadius(radius(dtt))<ceilRadius(r)<ceilRadius(radius(dtt+1))). 
-        // As such a radius will not reasonable happen in the tree and it will most likely not be requested,
-        // there is no need to calculate them. So just skip these.
-        for (coord_t radius_eval = m_radius_0; radius_eval <= config.branch_radius; radius_eval = ceilRadius(radius_eval + 1))
-            if (! std::binary_search(possible_tip_radiis.begin(), possible_tip_radiis.end(), radius_eval))
-                m_ignorable_radii.emplace_back(radius_eval);
-    }
-
-    throw_on_cancel();
-
     // it may seem that the required avoidance can be of a smaller radius when going to model (no initial layer diameter for to model branches)
     // but as for every branch going towards the bp, the to model avoidance is required to check for possible merges with to model branches, this assumption is in-fact wrong.
     std::unordered_map<coord_t, LayerIndex> radius_until_layer;
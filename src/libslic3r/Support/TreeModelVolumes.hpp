@@ -65,6 +65,11 @@ public:
     TreeModelVolumes(const TreeModelVolumes&) = delete;
     TreeModelVolumes& operator=(const TreeModelVolumes&) = delete;
 
+    // Move the collision, avoidance and placeable caches from other if they were calculated for the same object outlines,
+    // support blockers and parameters. The caches are keyed by radius and layer, thus precalculate() then calculates
+    // only the radii and layers not calculated yet. Returns false if the caches of other are not compatible.
+    bool reuse_caches(TreeModelVolumes &&other);
+
     void clear() { 
         this->clear_all_but_object_collision();
         m_collision_cache.clear();
@@ -344,6 +349,11 @@ private:
      */
     coord_t ceilRadius(const coord_t radius) const;
 
+    /*!
+     * \brief Collect the radii, which will never be requested by the tips of the trees, into m_ignorable_radii.
+     */
+    void calculate_ignorable_radii(const TreeSupportSettings &config);
+
     /*!
      * \brief Creates the areas that have to be avoided by the tree's branches to prevent collision with the model on this layer.
      *
@@ -24,6 +24,7 @@
 #include <cmath>
 #include <cstdint>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <numeric>
@@ -2334,7 +2335,7 @@ static SupportElementMerging* merge_influence_areas_two_sets(
  *  Value is the influence area where the center of a circle of support may be placed.
  * \param layer_idx[in] The current layer.
  */
-static void merge_influence_areas(
+static void merge_influence_areas_cluster(
     const TreeModelVolumes             &volumes, 
     const TreeSupportSettings          &config, 
     const LayerIndex                    layer_idx,
@@ -2424,6 +2425,100 @@ static void merge_influence_areas(
     }
 }
 
+// Split influence areas into clusters, which will never be merged with each other: Two elements are merged only if the bounding box
+// of the smaller one inflated by the difference of their radii intersects the bounding box of the bigger one, see merge_influence_areas_two_elements(),
+// and a merged element is contained inside the bounding box of the bigger one. Returns the cluster index of each influence area,
+// clusters are numbered in the order of their first influence area.
+static std::vector<size_t> influence_areas_clusters(const TreeSupportSettings &config, const std::vector<SupportElementMerging> &influence_areas, size_t &num_clusters)
+{
+    // A merged element is not wider than the element with the maximum distance to top, effective radius height and elephant foot increase,
+    // thus the difference of radii of any two elements is bounded by the difference of the widest and the thinnest elements.
+    SupportElementState widest;
+    coord_t             min_radius = std::numeric_limits<coord_t>::max();
+    widest.distance_to_top         = 0;
+    widest.effective_radius_height = 0;
+    widest.elephant_foot_increases = 0;
+    for (const SupportElementMerging &elem : influence_areas) {
+        widest.distance_to_top         = std::max(widest.distance_to_top, elem.state.distance_to_top);
+        widest.effective_radius_height = std::max(widest.effective_radius_height, elem.state.effective_radius_height);
+        widest.elephant_foot_increases = std::max(widest.elephant_foot_increases, elem.state.elephant_foot_increases);
+        min_radius = std::min(min_radius, support_element_radius(config, elem.state));
+    }
+    // Inflating both bounding boxes by half of the radius difference is equivalent to inflating one of them by the full difference.
+    const coord_t inflate = (std::max<coord_t>(support_element_radius(config, widest) - min_radius, 0) + 1) / 2 + SCALED_EPSILON;
+
+    // Union-find over the overlapping inflated bounding boxes, overlaps are found by sweeping along the X axis.
+    std::vector<size_t> parent(influence_areas.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](size_t i) {
+        while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    std::vector<size_t> sorted(influence_areas.size());
+    std::iota(sorted.begin(), sorted.end(), 0);
+    std::sort(sorted.begin(), sorted.end(), [&influence_areas](size_t l, size_t r) {
+        const coord_t xl = influence_areas[l].bbox().min().x();
+        const coord_t xr = influence_areas[r].bbox().min().x();
+        return xl < xr || (xl == xr && l < r);
+    });
+    for (auto it = sorted.begin(); it != sorted.end(); ++ it) {
+        const Eigen::AlignedBox<coord_t, 2> &bbox = influence_areas[*it].bbox();
+        for (auto it2 = std::next(it); it2 != sorted.end(); ++ it2) {
+            const Eigen::AlignedBox<coord_t, 2> &bbox2 = influence_areas[*it2].bbox();
+            if (bbox2.min().x() - inflate > bbox.max().x() + inflate)
+                break;
+            if (bbox2.min().y() - inflate <= bbox.max().y() + inflate && bbox.min().y() - inflate <= bbox2.max().y() + inflate)
+                if (size_t i = find(*it), j = find(*it2); i != j)
+                    // Keep the lower index as the root, so that the roots do not depend on the sweep order.
+                    parent[std::max(i, j)] = std::min(i, j);
+        }
+    }
+
+    std::vector<size_t> out(influence_areas.size());
+    num_clusters = 0;
+    for (size_t i = 0; i < influence_areas.size(); ++ i) {
+        const size_t root = find(i);
+        // Roots are the first elements of their clusters.
+        out[i] = root == i ? num_clusters ++ : out[root];
+    }
+    return out;
+}
+
+// Merge influence areas of clusters, which could not be merged with each other, in parallel.
+// The result does not depend on the number of threads: Each cluster is merged into its own vector,
+// the results are concatenated in the order of the clusters.
+static void merge_influence_areas(
+    const TreeModelVolumes             &volumes, 
+    const TreeSupportSettings          &config, 
+    const LayerIndex                    layer_idx,
+    std::vector<SupportElementMerging> &influence_areas,
+    std::function<void()>               throw_on_cancel)
+{
+    if (influence_areas.size() < 2)
+        return;
+
+    size_t                    num_clusters;
+    const std::vector<size_t> cluster_ids = influence_areas_clusters(config, influence_areas, num_clusters);
+    if (num_clusters == 1) {
+        merge_influence_areas_cluster(volumes, config, layer_idx, influence_areas, throw_on_cancel);
+        return;
+    }
+
+    std::vector<std::vector<SupportElementMerging>> clusters(num_clusters);
+    for (size_t i = 0; i < influence_areas.size(); ++ i)
+        clusters[cluster_ids[i]].emplace_back(std::move(influence_areas[i]));
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, clusters.size(), 1),
+        [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t cluster_idx = range.begin(); cluster_idx < range.end(); ++ cluster_idx)
+            if (clusters[cluster_idx].size() > 1)
+                merge_influence_areas_cluster(volumes, config, layer_idx, clusters[cluster_idx], throw_on_cancel);
+    });
+    influence_areas.clear();
+    for (std::vector<SupportElementMerging> &cluster : clusters)
+        std::move(cluster.begin(), cluster.end(), std::back_inserter(influence_areas));
+}
+
 /*!
  * \brief Propagates influence downwards, and merges overlapping ones.
  *
@@ -3466,11 +3561,18 @@ static void generate_support_areas(Print &print, const BuildVolume &build_volume
 #endif // SLIC3R_TREESUPPORT_PROGRESS
         PrintObject &print_object = *print.get_object(processing.second.front());
         // Generator for model collision, avoidance and internal guide volumes.
-        TreeModelVolumes volumes{ print_object, build_volume, config.maximum_move_distance, config.maximum_move_distance_slow, processing.second.front(),
+        TreeModelVolumesPtr volumes_ptr{ new TreeModelVolumes{ print_object, build_volume, config.maximum_move_distance, config.maximum_move_distance_slow, processing.second.front(),
 #ifdef SLIC3R_TREESUPPORTS_PROGRESS
             m_progress_multiplier, m_progress_offset, 
 #endif // SLIC3R_TREESUPPORTS_PROGRESS
-            /* additional_excluded_areas */{} };
+            /* additional_excluded_areas */{} } };
+        TreeModelVolumes &volumes = *volumes_ptr;
+        // Collisions and avoidances of the previous run stay valid if only the support interfaces, density etc. changed.
+        if (TreeModelVolumesPtr &cached = print_object.tree_model_volumes_cache(); cached) {
+            if (volumes.reuse_caches(std::move(*cached)))
+                BOOST_LOG_TRIVIAL(debug) << "Tree support: Reusing collision and avoidance areas of the previous run";
+            cached.reset();
+        }
 
         //FIXME generating overhangs just for the furst mesh of the group.
         assert(processing.second.size() == 1);
@@ -3478,6 +3580,9 @@ static void generate_support_areas(Print &print, const BuildVolume &build_volume
 
         // ### Precalculate avoidances, collision etc.
         size_t num_support_layers = precalculate(print, overhangs, processing.first, processing.second, volumes, throw_on_cancel);
+        // The areas calculated lazily after precalculate() are cached as well, volumes stays valid until the object is deleted,
+        // resliced or its tree supports are generated again.
+        print_object.tree_model_volumes_cache() = std::move(volumes_ptr);
         bool   has_support = num_support_layers > 0;
         bool   has_raft    = config.raft_layers.size() > 0;
         num_support_layers = std::max(num_support_layers, config.raft_layers.size());
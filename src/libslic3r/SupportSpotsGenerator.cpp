@@ -246,23 +246,26 @@ SliceConnection estimate_slice_connection(size_t slice_idx, const Layer *layer)
     return connection;
 };
 
+// Number of layers, for which the slice connections are precomputed at once. The window is processed in parallel
+// and released before the next one is computed, thus the memory does not grow with the layer count.
+constexpr size_t slice_connections_window = 64;
+
+// Slice connections of layers <layer_begin, layer_end), indexed by layer_idx - layer_begin.
 using PrecomputedSliceConnections = std::vector<std::vector<SliceConnection>>;
-PrecomputedSliceConnections precompute_slices_connections(const PrintObject *po)
+PrecomputedSliceConnections precompute_slices_connections(const PrintObject *po, size_t layer_begin, size_t layer_end)
 {
-    PrecomputedSliceConnections result{};
-    for (size_t lidx = 0; lidx < po->layer_count(); lidx++) {
-        result.emplace_back(std::vector<SliceConnection>{});
-        for (size_t slice_idx = 0; slice_idx < po->get_layer(lidx)->lslices_ex.size(); slice_idx++) {
-            result[lidx].push_back(SliceConnection{});
-        }
+    PrecomputedSliceConnections result(layer_end - layer_begin);
+    for (size_t lidx = layer_begin; lidx < layer_end; lidx++) {
+        result[lidx - layer_begin].assign(po->get_layer(lidx)->lslices_ex.size(), SliceConnection{});
     }
 
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, po->layers().size()), [po, &result](tbb::blocked_range<size_t> r) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(layer_begin, layer_end), [po, layer_begin, &result](tbb::blocked_range<size_t> r) {
         for (size_t lidx = r.begin(); lidx < r.end(); lidx++) {
             const Layer *l = po->get_layer(lidx);
-            tbb::parallel_for(tbb::blocked_range<size_t>(0, l->lslices_ex.size()), [lidx, l, &result](tbb::blocked_range<size_t> r2) {
+            std::vector<SliceConnection> &layer_result = result[lidx - layer_begin];
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, l->lslices_ex.size()), [l, &layer_result](tbb::blocked_range<size_t> r2) {
                 for (size_t slice_idx = r2.begin(); slice_idx < r2.end(); slice_idx++) {
-                    result[lidx][slice_idx] = estimate_slice_connection(slice_idx, l);
+                    layer_result[slice_idx] = estimate_slice_connection(slice_idx, l);
                 }
             });
         }
@@ -408,6 +411,7 @@ std::vector<ExtrusionLine> check_extrusion_entity_stability(const ExtrusionEntit
         lines_out.reserve(annotated_points.size());
         float bridged_distance = annotated_points.front().position != annotated_points.back().position ? (params.bridge_distance + 1.0f) :
                                                                                                          0.0f;
+        size_t bottom_line_hint = size_t(-1);
         for (size_t i = 0; i < annotated_points.size(); ++i) {
             ExtrusionProcessor::ExtendedPoint       &curr_point = annotated_points[i];
             const ExtrusionProcessor::ExtendedPoint &prev_point = i > 0 ? annotated_points[i - 1] : annotated_points[i];
@@ -415,11 +419,17 @@ std::vector<ExtrusionLine> check_extrusion_entity_stability(const ExtrusionEntit
             ExtrusionLine line_out{prev_point.position.cast<float>(), curr_point.position.cast<float>(), line_len, entity};
 
             Vec2f middle                               = 0.5 * (line_out.a + line_out.b);
-            auto [middle_distance, bottom_line_idx, x] = prev_layer_lines.distance_from_lines_extra<false>(middle);
+            auto [middle_distance, bottom_line_idx, x] = prev_layer_lines.distance_from_lines_extra<false>(middle, bottom_line_hint);
             ExtrusionLine bottom_line = prev_layer_lines.get_lines().empty() ? ExtrusionLine{} : prev_layer_lines.get_line(bottom_line_idx);
-
-            // correctify the distance sign using slice polygons
-            float sign = (prev_layer_boundary.distance_from_lines<true>(curr_point.position) + 0.5f * flow_width) < 0.0f ? -1.0f : 1.0f;
+            bottom_line_hint          = bottom_line_idx;
+
+            // correctify the distance sign using slice polygons: negative if the point is inside the previous layer slices by more than
+            // half of the flow width. The point in polygon test is cheaper than the nearest line search, which is only done for points inside
+            // and then limited to the half of the flow width.
+            float sign = prev_layer_boundary.outside(curr_point.position) < 0 &&
+                                 prev_layer_boundary.all_lines_in_radius(curr_point.position, 0.5f * flow_width).empty() ?
+                             -1.0f :
+                             1.0f;
             curr_point.distance *= sign;
 
             SupportPointCause potential_cause = SupportPointCause::FloatingExtrusion;
@@ -842,6 +852,25 @@ public:
         active_object_parts.erase(from_flat);
         active_object_parts_id_mapping[from] = to_flat;
     }
+
+    // Drop the parts, which do not continue to the layer described by slice_to_part_mapping, and the merge history
+    // not referenced by that layer. The dropped parts are never accessed again, they would only accumulate memory.
+    void retain(const std::unordered_map<size_t, size_t> &slice_to_part_mapping)
+    {
+        std::unordered_map<size_t, ObjectPart> retained_parts;
+        std::unordered_map<size_t, size_t>     retained_id_mapping;
+        for (const auto &[slice_idx, id] : slice_to_part_mapping) {
+            size_t flat_id = this->get_flat_id(id);
+            retained_id_mapping.emplace(id, flat_id);
+            retained_id_mapping.emplace(flat_id, flat_id);
+            if (auto it = active_object_parts.find(flat_id); it != active_object_parts.end()) {
+                retained_parts.emplace(flat_id, std::move(it->second));
+                active_object_parts.erase(it);
+            }
+        }
+        active_object_parts            = std::move(retained_parts);
+        active_object_parts_id_mapping = std::move(retained_id_mapping);
+    }
 };
 
 // Function that is used when new support point is generated. It will update the ObjectPart stability, weakest conneciton info,
@@ -938,7 +967,7 @@ std::vector<EnitityToCheck> gather_entities_to_check(const Layer* layer) {
 
 LocalSupports compute_local_supports(
     const std::vector<EnitityToCheck>& entities_to_check,
-    const std::optional<Linesf>& previous_layer_boundary,
+    const AABBTreeLines::LinesDistancer<Linef>& prev_layer_boundary_distancer,
     const LD& prev_layer_ext_perim_lines,
     size_t slices_count,
     const Params& params
@@ -946,9 +975,6 @@ LocalSupports compute_local_supports(
     std::vector<tbb::concurrent_vector<ExtrusionLine>> unstable_lines_per_slice(slices_count);
     std::vector<tbb::concurrent_vector<ExtrusionLine>> ext_perim_lines_per_slice(slices_count);
 
-    AABBTreeLines::LinesDistancer<Linef> prev_layer_boundary_distancer =
-        (previous_layer_boundary ? AABBTreeLines::LinesDistancer<Linef>{*previous_layer_boundary} : AABBTreeLines::LinesDistancer<Linef>{});
-
     if constexpr (debug_files) {
         for (const auto &e_to_check : entities_to_check) {
             for (const auto &line : check_extrusion_entity_stability(e_to_check.e, e_to_check.region, prev_layer_ext_perim_lines,
@@ -1122,30 +1148,36 @@ void reckon_global_supports(const tbb::concurrent_vector<ExtrusionLine> &externa
     }
 }
 
-std::tuple<SupportPoints, PartialObjects> check_stability(const PrintObject                 *po,
-                                                          const PrecomputedSliceConnections &precomputed_slices_connections,
-                                                          const PrintTryCancel              &cancel_func,
-                                                          const Params                      &params)
+std::tuple<SupportPoints, PartialObjects> check_stability(const PrintObject    *po,
+                                                          const PrintTryCancel &cancel_func,
+                                                          const Params         &params)
 {
     SupportPoints     supp_points{};
     SupportGridFilter supports_presence_grid(po, params.min_distance_between_support_points);
     ActiveObjectParts active_object_parts{};
     PartialObjects    partial_objects{};
     LD                prev_layer_ext_perim_lines;
+    // Boundary of the slices of the previous layer, built once per layer.
+    AABBTreeLines::LinesDistancer<Linef> prev_layer_boundary;
 
     SliceMappings slice_mappings;
 
+    PrecomputedSliceConnections slices_connections;
+    size_t                      slices_connections_begin = 0;
 
     for (size_t layer_idx = 0; layer_idx < po->layer_count(); ++layer_idx) {
         cancel_func();
         const Layer *layer                 = po->get_layer(layer_idx);
         float        bottom_z              = layer->bottom_z();
 
-        slice_mappings = update_active_object_parts(layer, params, precomputed_slices_connections[layer_idx], slice_mappings, active_object_parts, partial_objects);
+        if (layer_idx == slices_connections_begin + slices_connections.size()) {
+            // The previous window was fully processed, release it and precompute the next one.
+            slices_connections_begin = layer_idx;
+            slices_connections       = precompute_slices_connections(po, layer_idx, std::min(layer_idx + slice_connections_window, po->layer_count()));
+        }
 
-        std::optional<Linesf> prev_layer_boundary = layer->lower_layer != nullptr ?
-                                                        std::optional{to_unscaled_linesf(layer->lower_layer->lslices)} :
-                                                        std::nullopt;
+        slice_mappings = update_active_object_parts(layer, params, slices_connections[layer_idx - slices_connections_begin], slice_mappings, active_object_parts, partial_objects);
+        active_object_parts.retain(slice_mappings.index_to_object_part_mapping);
 
         LocalSupports local_supports{
             compute_local_supports(gather_entities_to_check(layer), prev_layer_boundary, prev_layer_ext_perim_lines, layer->lslices_ex.size(), params)};
@@ -1175,6 +1207,7 @@ std::tuple<SupportPoints, PartialObjects> check_stability(const PrintObject
             current_layer_ext_perims_lines.insert(current_layer_ext_perims_lines.end(), external_perimeter_lines.begin(), external_perimeter_lines.end());
         } // slice iterations
         prev_layer_ext_perim_lines = LD(current_layer_ext_perims_lines);
+        prev_layer_boundary        = AABBTreeLines::LinesDistancer<Linef>{to_unscaled_linesf(layer->lslices)};
     } // layer iterations
 
     for (const auto& active_obj_pair : slice_mappings.index_to_object_part_mapping) {
@@ -1229,8 +1262,7 @@ void debug_export(const SupportPoints& support_points,const PartialObjects& obje
 
 std::tuple<SupportPoints, PartialObjects> full_search(const PrintObject *po, const PrintTryCancel& cancel_func, const Params &params)
 {
-    auto precomputed_slices_connections = precompute_slices_connections(po);
-    auto results = check_stability(po, precomputed_slices_connections, cancel_func, params);
+    auto results = check_stability(po, cancel_func, params);
 #ifdef DEBUG_FILES
     auto [supp_points, objects] = results;
     debug_export(supp_points, objects, "issues");
@@ -1262,6 +1294,7 @@ void estimate_supports_malformations(SupportLayerPtrs &layers, float flow_width,
             auto annotated_points = ExtrusionProcessor::estimate_points_properties<
                 false>(pol.points, prev_layer_lines, config);
 
+            size_t bottom_line_hint = size_t(-1);
             for (size_t i = 0; i < annotated_points.size(); ++i) {
                 const ExtrusionProcessor::ExtendedPoint &a = i > 0 ? annotated_points[i - 1] : annotated_points[i];
                 const ExtrusionProcessor::ExtendedPoint &b = annotated_points[i];
@@ -1269,9 +1302,10 @@ void estimate_supports_malformations(SupportLayerPtrs &layers, float flow_width,
                                        extrusion};
 
                 Vec2f middle                               = 0.5 * (line_out.a + line_out.b);
-                auto [middle_distance, bottom_line_idx, x] = prev_layer_lines.distance_from_lines_extra<false>(middle);
+                auto [middle_distance, bottom_line_idx, x] = prev_layer_lines.distance_from_lines_extra<false>(middle, bottom_line_hint);
                 ExtrusionLine bottom_line                  = prev_layer_lines.get_lines().empty() ? ExtrusionLine{} :
                                                                                                     prev_layer_lines.get_line(bottom_line_idx);
+                bottom_line_hint                           = bottom_line_idx;
 
                 Vec2f v1   = (bottom_line.b - bottom_line.a);
                 Vec2f v2   = (a.position.cast<float>() - bottom_line.a);
@@ -1343,6 +1377,7 @@ void estimate_malformations(LayerPtrs &layers, const Params &params)
                 auto annotated_points = ExtrusionProcessor::estimate_points_properties<
                     false>(extrusion_pts, prev_layer_lines, config);
 
+                size_t bottom_line_hint = size_t(-1);
                 for (size_t i = 0; i < annotated_points.size(); ++i) {
                     const ExtrusionProcessor::ExtendedPoint &a = i > 0 ? annotated_points[i - 1] : annotated_points[i];
                     const ExtrusionProcessor::ExtendedPoint &b = annotated_points[i];
@@ -1350,9 +1385,10 @@ void estimate_malformations(LayerPtrs &layers, const Params &params)
                                            extrusion};
 
                     Vec2f middle                               = 0.5 * (line_out.a + line_out.b);
-                    auto [middle_distance, bottom_line_idx, x] = prev_layer_lines.distance_from_lines_extra<false>(middle);
+                    auto [middle_distance, bottom_line_idx, x] = prev_layer_lines.distance_from_lines_extra<false>(middle, bottom_line_hint);
                     ExtrusionLine bottom_line                  = prev_layer_lines.get_lines().empty() ? ExtrusionLine{} :
                                                                                                         prev_layer_lines.get_line(bottom_line_idx);
+                    bottom_line_hint                           = bottom_line_idx;
 
                     // correctify the distance sign using slice polygons
                     float sign = (prev_layer_boundary.distance_from_lines<true>(middle.cast<double>()) + 0.5f * flow_width) < 0.0f ? -1.0f :
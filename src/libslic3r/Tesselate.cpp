@@ -5,11 +5,14 @@
 #include "Tesselate.hpp"
 
 #include <glu-libtess.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <algorithm>
 #include <deque>
 #include <utility>
 #include <cassert>
 #include <cstring>
+#include <memory>
 
 #include "ExPolygon.hpp"
 #include "admesh/stl.h"
@@ -257,6 +260,101 @@ std::vector<Vec2f> triangulate_expolygons_2f(const ExPolygons &polys, bool flip)
     return out;
 }
 
+// Ear clipping of a simple polygon without holes, oriented counter-clockwise. Vertices are tested with exact integer
+// predicates, collinear vertices are dropped without emitting a triangle.
+// Returns false if no ear was found and the polygon is thus not simple, then the output is left unchanged.
+static bool triangulate_ear_clipping(const Polygon &contour, double z, bool flip, std::vector<Vec3d> &out)
+{
+    const Points &pts = contour.points;
+    const size_t  n   = pts.size();
+    if (n < 3)
+        return true;
+    auto cross = [&pts](size_t a, size_t b, size_t c) {
+        return int64_t(pts[b].x() - pts[a].x()) * int64_t(pts[c].y() - pts[a].y()) -
+               int64_t(pts[b].y() - pts[a].y()) * int64_t(pts[c].x() - pts[a].x());
+    };
+    // Circular doubly linked list of the vertices not yet clipped.
+    std::vector<size_t> prev(n), next(n);
+    for (size_t i = 0; i < n; ++ i) {
+        prev[i] = i == 0 ? n - 1 : i - 1;
+        next[i] = i + 1 == n ? 0 : i + 1;
+    }
+    auto is_ear = [&](size_t i) {
+        const size_t a = prev[i], c = next[i];
+        if (cross(a, i, c) <= 0)
+            return false;
+        // No other reflex or collinear vertex may lie inside the triangle or on its boundary.
+        for (size_t j = next[c]; j != a; j = next[j])
+            if (cross(prev[j], j, next[j]) <= 0 && cross(a, i, j) >= 0 && cross(i, c, j) >= 0 && cross(c, a, j) >= 0)
+                return false;
+        return true;
+    };
+    const size_t out_size = out.size();
+    out.reserve(out_size + 3 * (n - 2));
+    auto emplace = [&out, z](const Point &pt) { out.emplace_back(unscale<double>(pt.x()), unscale<double>(pt.y()), z); };
+    size_t remaining = n;
+    size_t i         = 0;
+    // Number of vertices visited since the last clipped one.
+    size_t visited   = 0;
+    while (remaining > 3) {
+        if (cross(prev[i], i, next[i]) == 0) {
+            // Collinear or duplicate vertex, drop it.
+        } else if (is_ear(i)) {
+            emplace(pts[prev[i]]);
+            emplace(pts[flip ? next[i] : i]);
+            emplace(pts[flip ? i : next[i]]);
+        } else if (++ visited > remaining) {
+            out.resize(out_size);
+            return false;
+        } else {
+            i = next[i];
+            continue;
+        }
+        next[prev[i]] = next[i];
+        prev[next[i]] = prev[i];
+        i = prev[i];
+        -- remaining;
+        visited = 0;
+    }
+    if (int64_t c = cross(prev[i], i, next[i]); c > 0) {
+        emplace(pts[prev[i]]);
+        emplace(pts[flip ? next[i] : i]);
+        emplace(pts[flip ? i : next[i]]);
+    } else if (c < 0) {
+        out.resize(out_size);
+        return false;
+    }
+    return true;
+}
+
+// Contours with more vertices are left to glu-libtess, as the ear clipping is quadratic in the number of vertices.
+static constexpr size_t ear_clipping_max_points = 256;
+
+std::vector<Vec3d> triangulate_expolygons_3d_parallel(const ExPolygons &polys, coordf_t z, bool flip)
+{
+    std::vector<std::vector<Vec3d>> triangles(polys.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, polys.size()), [&polys, &triangles, z, flip](const tbb::blocked_range<size_t> &range) {
+        std::unique_ptr<GluTessWrapper> tess;
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            const ExPolygon &expoly = polys[i];
+            if (expoly.holes.empty() && expoly.contour.size() <= ear_clipping_max_points &&
+                triangulate_ear_clipping(expoly.contour, z, flip, triangles[i]))
+                continue;
+            if (! tess)
+                tess = std::make_unique<GluTessWrapper>();
+            triangles[i] = tess->tesselate3d(expoly, z, flip);
+        }
+    });
+    std::vector<Vec3d> out;
+    size_t num_points = 0;
+    for (const std::vector<Vec3d> &t : triangles)
+        num_points += t.size();
+    out.reserve(num_points);
+    for (const std::vector<Vec3d> &t : triangles)
+        append(out, t);
+    return out;
+}
+
 indexed_triangle_set wall_strip(const Polygon &poly, double lower_z_mm, double upper_z_mm)
 {
     indexed_triangle_set ret;
@@ -24,6 +24,11 @@ extern std::vector<Vec2d> triangulate_expolygon_2d (const ExPolygon  &poly,  boo
 extern std::vector<Vec2d> triangulate_expolygons_2d(const ExPolygons &polys, bool flip = NORMALS_UP);
 extern std::vector<Vec2f> triangulate_expolygon_2f (const ExPolygon  &poly,  bool flip = NORMALS_UP);
 extern std::vector<Vec2f> triangulate_expolygons_2f(const ExPolygons &polys, bool flip = NORMALS_UP);
+// Triangulate the ExPolygons in parallel, the triangles are returned in the order of the input ExPolygons.
+// ExPolygons without holes are triangulated by ear clipping if the contour is simple and not too large,
+// the other ExPolygons by glu-libtess. The triangles cover the same area as triangulate_expolygons_3d(),
+// though they are not identical, thus the function is intended for meshing, not for code comparing the triangles.
+extern std::vector<Vec3d> triangulate_expolygons_3d_parallel(const ExPolygons &polys, coordf_t z = 0, bool flip = NORMALS_UP);
 
 indexed_triangle_set wall_strip(const Polygon &poly,
                                 double         lower_z_mm,
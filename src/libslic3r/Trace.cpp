@@ -0,0 +1,194 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#include "Trace.hpp"
+#include "Metrics.hpp"
+#include "Thread.hpp"
+#include "Utils.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <vector>
+
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/cstdio.hpp>
+#include <boost/nowide/cstdlib.hpp>
+
+#include <tbb/enumerable_thread_specific.h>
+
+namespace Slic3r::Trace {
+
+namespace {
+
+struct Event
+{
+    // 'X' for a span, 'i' for an instant event.
+    char        phase;
+    const char *category;
+    std::string name;
+    uint64_t    start_us;
+    uint64_t    duration_us;
+    // Content of the JSON "args" object, may be empty.
+    std::string args;
+};
+
+struct ThreadEvents
+{
+    ThreadEvents() {
+        static std::atomic<int> s_last_thread_id { 0 };
+        thread_id = ++ s_last_thread_id;
+        if (std::optional<std::string> name = get_current_thread_name(); name)
+            thread_name = *name;
+    }
+    int                 thread_id;
+    std::string         thread_name;
+    std::vector<Event>  events;
+};
+
+// Each thread records into its own buffer, thus recording does not need to be synchronized.
+tbb::enumerable_thread_specific<ThreadEvents, tbb::cache_aligned_allocator<ThreadEvents>, tbb::ets_key_per_instance> s_events;
+
+bool enabled_by_environment()
+{
+    const char *env = boost::nowide::getenv("SLIC3R_TRACE");
+    return env != nullptr && *env != 0 && std::atoi(env) != 0;
+}
+
+void append_json_string(std::string &out, const std::string &s)
+{
+    out += '"';
+    for (char c : s) {
+        switch (c) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n";  break;
+        case '\r': out += "\\r";  break;
+        case '\t': out += "\\t";  break;
+        default:
+            if ((unsigned char)c < 0x20) {
+                char buf[8];
+                sprintf(buf, "\\u%04x", int(c));
+                out += buf;
+            } else
+                out += c;
+        }
+    }
+    out += '"';
+}
+
+} // namespace
+
+namespace detail {
+
+std::atomic<bool> s_enabled { enabled_by_environment() };
+std::atomic<bool> s_active  { s_enabled.load() };
+
+void update_active()
+{
+    s_active.store(s_enabled.load(std::memory_order_relaxed) || Metrics::enabled(), std::memory_order_relaxed);
+}
+
+uint64_t now_microseconds()
+{
+    static const auto s_epoch = std::chrono::steady_clock::now();
+    // Never return zero, zero marks a disabled Scope.
+    return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_epoch).count()) + 1;
+}
+
+void record_span(const char *category, std::string &&name, uint64_t start_us, uint64_t end_us)
+{
+    if (Metrics::enabled() && std::string_view(category) == "step")
+        Metrics::observe_step(name.substr(0, name.find(" (")), end_us - start_us);
+    if (enabled())
+        s_events.local().events.push_back({ 'X', category, std::move(name), start_us, end_us - start_us, {} });
+}
+
+} // namespace detail
+
+void enable(bool enable)
+{
+    detail::s_enabled.store(enable, std::memory_order_relaxed);
+    detail::update_active();
+}
+
+void clear()
+{
+    for (ThreadEvents &thread_events : s_events)
+        thread_events.events.clear();
+}
+
+void sample_memory(const char *name)
+{
+    if (! enabled())
+        return;
+    std::string args = "\"memory\":";
+    append_json_string(args, log_memory_info(true));
+    s_events.local().events.push_back({ 'i', "memory", name, detail::now_microseconds(), 0, std::move(args) });
+}
+
+bool save(const std::string &path)
+{
+    FILE *file = boost::nowide::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        BOOST_LOG_TRIVIAL(error) << "Failed to open the trace file " << path;
+        return false;
+    }
+    std::string out;
+    bool        first = true;
+    auto        begin_event = [&out, &first]() { out += first ? "\n" : ",\n"; first = false; };
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+    for (const ThreadEvents &thread_events : s_events) {
+        out.clear();
+        if (! thread_events.thread_name.empty()) {
+            begin_event();
+            out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(thread_events.thread_id) + ",\"args\":{\"name\":";
+            append_json_string(out, thread_events.thread_name);
+            out += "}}";
+        }
+        for (const Event &event : thread_events.events) {
+            begin_event();
+            out += "{\"name\":";
+            append_json_string(out, event.name);
+            out += ",\"cat\":\"";
+            out += event.category;
+            out += "\",\"ph\":\"";
+            out += event.phase;
+            out += "\",\"ts\":" + std::to_string(event.start_us);
+            if (event.phase == 'X')
+                out += ",\"dur\":" + std::to_string(event.duration_us);
+            else
+                out += ",\"s\":\"g\"";
+            out += ",\"pid\":1,\"tid\":" + std::to_string(thread_events.thread_id);
+            if (! event.args.empty())
+                out += ",\"args\":{" + event.args + "}";
+            out += '}';
+        }
+        fwrite(out.data(), 1, out.size(), file);
+    }
+    fputs("\n]}\n", file);
+    const bool ok = ferror(file) == 0;
+    if (fclose(file) != 0 || ! ok) {
+        BOOST_LOG_TRIVIAL(error) << "Failed to write the trace file " << path;
+        return false;
+    }
+    BOOST_LOG_TRIVIAL(info) << "Trace of the slicing process saved to " << path;
+    return true;
+}
+
+std::map<std::string, uint64_t> total_durations(const char *category)
+{
+    std::map<std::string, uint64_t> out;
+    const std::string_view          category_view(category);
+    for (const ThreadEvents &thread_events : s_events)
+        for (const Event &event : thread_events.events)
+            if (event.phase == 'X' && category_view == event.category) {
+                size_t detail_begin = event.name.find(" (");
+                out[event.name.substr(0, detail_begin)] += event.duration_us;
+            }
+    return out;
+}
+
+} // namespace Slic3r::Trace
@@ -0,0 +1,90 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef libslic3r_Trace_hpp_
+#define libslic3r_Trace_hpp_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace Slic3r {
+
+// Opt-in timeline instrumentation of the slicing process.
+// When enabled, spans of the print steps, of the print objects and of the parallel regions are recorded
+// together with the thread they ran on, and they may be saved in the Chrome trace event format,
+// to be inspected with chrome://tracing or https://ui.perfetto.dev
+//
+// Recording is disabled by default. It is enabled by the --trace command line option
+// or by the SLIC3R_TRACE environment variable set to a non-zero value (also for the GUI).
+// A disabled trace costs a single relaxed atomic load per span.
+namespace Trace {
+
+namespace detail {
+    extern std::atomic<bool> s_enabled;
+    // Either the trace or the Metrics are enabled, the spans are measured.
+    extern std::atomic<bool> s_active;
+    // To be called after the trace or the Metrics were enabled or disabled.
+    void     update_active();
+    uint64_t now_microseconds();
+    // Records the span into the trace if enabled and passes the spans of the "step" category to Metrics if enabled.
+    void     record_span(const char *category, std::string &&name, uint64_t start_us, uint64_t end_us);
+}
+
+inline bool enabled() { return detail::s_enabled.load(std::memory_order_relaxed); }
+void        enable(bool enable);
+// Drop all the recorded events.
+void        clear();
+// Record a sample of the memory consumption of the process as reported by log_memory_info().
+void        sample_memory(const char *name);
+// Save the recorded events into a JSON file in the Chrome trace event format.
+// Returns false if the file could not be written.
+bool        save(const std::string &path);
+// Sum of the durations of the recorded spans of a category in microseconds, grouped by the span name
+// with the " (detail)" suffix stripped. Spans running in parallel are summed up.
+std::map<std::string, uint64_t> total_durations(const char *category);
+
+// Records a span from its construction to its destruction on the current thread.
+// The category is expected to be a string literal.
+class Scope
+{
+public:
+    Scope(const char *category, const char *name) : m_category(category) {
+        if (detail::s_active.load(std::memory_order_relaxed)) {
+            m_name  = name;
+            m_start = detail::now_microseconds();
+        }
+    }
+    Scope(const char *category, std::string name) : m_category(category) {
+        if (detail::s_active.load(std::memory_order_relaxed)) {
+            m_name  = std::move(name);
+            m_start = detail::now_microseconds();
+        }
+    }
+    // Span named "name (detail)", for example a print step applied to a named object.
+    Scope(const char *category, const char *name, const std::string &detail) : m_category(category) {
+        if (detail::s_active.load(std::memory_order_relaxed)) {
+            m_name  = std::string(name) + " (" + detail + ")";
+            m_start = detail::now_microseconds();
+        }
+    }
+    ~Scope() {
+        if (m_start != 0)
+            detail::record_span(m_category, std::move(m_name), m_start, detail::now_microseconds());
+    }
+    Scope(const Scope &) = delete;
+    Scope& operator=(const Scope &) = delete;
+
+private:
+    const char *m_category;
+    std::string m_name;
+    uint64_t    m_start { 0 };
+};
+
+} // namespace Trace
+
+} // namespace Slic3r
+
+#endif // libslic3r_Trace_hpp_
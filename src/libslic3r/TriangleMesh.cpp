@@ -26,6 +26,9 @@
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/concurrent_vector.h>
 #include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/parallel_scan.h>
+#include <oneapi/tbb/parallel_sort.h>
+#include <atomic>
 #include <cmath>
 #include <vector>
 #include <utility>
@@ -708,123 +711,179 @@ std::vector<Vec3i> its_face_edge_ids(const indexed_triangle_set &its, std::vecto
 }
 
 // Merge duplicate vertices, return number of vertices removed.
+// Meshes with less vertices / faces are post-processed on the calling thread, not being worth the synchronization.
+static constexpr size_t its_parallel_threshold = 100000;
+
+// Calls fn(begin, end) for subranges of [0, size), in parallel for large sizes.
+template<typename Fn>
+static void its_for_each_range(size_t size, Fn &&fn)
+{
+    if (size < its_parallel_threshold)
+        fn(size_t(0), size);
+    else
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, size, its_parallel_threshold / 16),
+            [&fn](const tbb::blocked_range<size_t> &range) { fn(range.begin(), range.end()); });
+}
+
+// Calculates new indices of the items to be kept, preserving their order. Items not kept are not assigned a new index.
+// Returns the number of items kept.
+template<typename KeepFn>
+static int its_new_indices_of_kept(size_t size, KeepFn &&keep, std::vector<int> &new_index)
+{
+    new_index.assign(size, -1);
+    auto scan = [&keep, &new_index](size_t begin, size_t end, int num_kept, bool is_final_scan) {
+        for (size_t i = begin; i < end; ++ i)
+            if (keep(i)) {
+                if (is_final_scan)
+                    new_index[i] = num_kept;
+                ++ num_kept;
+            }
+        return num_kept;
+    };
+    if (size < its_parallel_threshold)
+        return scan(0, size, 0, true);
+    return tbb::parallel_scan(tbb::blocked_range<size_t>(0, size, its_parallel_threshold / 16), 0,
+        [&scan](const tbb::blocked_range<size_t> &range, int num_kept, bool is_final_scan) { return scan(range.begin(), range.end(), num_kept, is_final_scan); },
+        std::plus<int>());
+}
+
+// Moves the kept vertices to their new indices vertex_map[old index], then replaces vertex indices of faces with vertex_map[old index].
+template<typename KeepFn>
+static void its_remap_vertices(indexed_triangle_set &its, KeepFn &&keep, const std::vector<int> &vertex_map, int num_kept, bool shrink_to_fit)
+{
+    if (its.vertices.size() < its_parallel_threshold) {
+        // The new indices are not higher than the old ones, compactify in place.
+        for (size_t i = 0; i < its.vertices.size(); ++ i)
+            if (keep(i) && vertex_map[i] < int(i))
+                its.vertices[vertex_map[i]] = its.vertices[i];
+        its.vertices.erase(its.vertices.begin() + num_kept, its.vertices.end());
+        if (shrink_to_fit)
+            its.vertices.shrink_to_fit();
+    } else {
+        // Parallel in place compaction would race, copy.
+        std::vector<Vec3f> vertices(num_kept);
+        its_for_each_range(its.vertices.size(), [&its, &keep, &vertex_map, &vertices](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++ i)
+                if (keep(i))
+                    vertices[vertex_map[i]] = its.vertices[i];
+        });
+        its.vertices = std::move(vertices);
+    }
+    its_for_each_range(its.indices.size(), [&its, &vertex_map](size_t begin, size_t end) {
+        for (size_t face_idx = begin; face_idx < end; ++ face_idx)
+            for (int i = 0; i < 3; ++ i)
+                its.indices[face_idx](i) = vertex_map[its.indices[face_idx](i)];
+    });
+}
+
 int its_merge_vertices(indexed_triangle_set &its, bool shrink_to_fit)
 {
     // 1) Sort indices to vertices lexicographically by coordinates AND vertex index.
+    // As the vertex index is a part of the key, the order is total and the result is deterministic even if sorted in parallel.
     auto sorted = reserve_vector<int>(its.vertices.size());
     for (int i = 0; i < int(its.vertices.size()); ++ i)
         sorted.emplace_back(i);
-    std::sort(sorted.begin(), sorted.end(), [&its](int il, int ir) {
+    auto vertex_lower = [&its](int il, int ir) {
         const Vec3f &l = its.vertices[il];
         const Vec3f &r = its.vertices[ir];
         // Sort lexicographically by coordinates AND vertex index.
         return l.x() < r.x() || (l.x() == r.x() && (l.y() < r.y() || (l.y() == r.y() && (l.z() < r.z() || (l.z() == r.z() && il < ir)))));
-    });
+    };
+    if (sorted.size() < its_parallel_threshold)
+        std::sort(sorted.begin(), sorted.end(), vertex_lower);
+    else
+        tbb::parallel_sort(sorted.begin(), sorted.end(), vertex_lower);
 
     // 2) Map duplicate vertices to the one with the lowest vertex index.
     // The vertex to stay will have a map_vertices[...] == -1 index assigned, the other vertices will point to it.
+    // Each run of duplicates is processed by the range containing its first vertex.
     std::vector<int> map_vertices(its.vertices.size(), -1);
-    for (int i = 0; i < int(sorted.size());) {
-        const int    u = sorted[i];
-        const Vec3f &p = its.vertices[u];
-        int j = i;
-        for (++ j; j < int(sorted.size()); ++ j) {
-            const int    v = sorted[j];
-            const Vec3f &q = its.vertices[v];
-            if (p != q)
-                break;
-            assert(v > u);
-            map_vertices[v] = u;
-        }
-        i = j;
-    }
-
-    // 3) Shrink its.vertices, update map_vertices with the new vertex indices.
-    int k = 0;
-    for (int i = 0; i < int(its.vertices.size()); ++ i) {
-        if (map_vertices[i] == -1) {
-            map_vertices[i] = k;
-            if (k < i)
-                its.vertices[k] = its.vertices[i];
-            ++ k;
-        } else {
-            assert(map_vertices[i] < i);
-            map_vertices[i] = map_vertices[map_vertices[i]];
+    its_for_each_range(sorted.size(), [&its, &sorted, &map_vertices](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++ i) {
+            const int    u = sorted[i];
+            const Vec3f &p = its.vertices[u];
+            if (i > 0 && its.vertices[sorted[i - 1]] == p)
+                // Not the first of its run.
+                continue;
+            for (size_t j = i + 1; j < sorted.size(); ++ j) {
+                const int    v = sorted[j];
+                const Vec3f &q = its.vertices[v];
+                if (p != q)
+                    break;
+                assert(v > u);
+                map_vertices[v] = u;
+            }
         }
-    }
+    });
 
+    // 3) Calculate the new vertex indices, map the duplicate vertices to the new indices of the vertices they are merged with.
+    auto             keep = [&map_vertices](size_t i) { return map_vertices[i] == -1; };
+    std::vector<int> new_index;
+    const int        k = its_new_indices_of_kept(its.vertices.size(), keep, new_index);
     int num_erased = int(its.vertices.size()) - k;
 
     if (num_erased) {
-        // Shrink the vertices.
-        its.vertices.erase(its.vertices.begin() + k, its.vertices.end());
-        // Remap face indices.
-        for (stl_triangle_vertex_indices &face : its.indices)
-            for (int i = 0; i < 3; ++ i)
-                face(i) = map_vertices[face(i)];
-        // Optionally shrink to fit (reallocate) vertices.
-        if (shrink_to_fit)
-            its.vertices.shrink_to_fit();
+        its_for_each_range(new_index.size(), [&map_vertices, &new_index](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++ i)
+                if (map_vertices[i] != -1) {
+                    assert(map_vertices[i] < int(i));
+                    new_index[i] = new_index[map_vertices[i]];
+                }
+        });
+        // Shrink the vertices, remap face indices.
+        its_remap_vertices(its, keep, new_index, k, shrink_to_fit);
     }
 
     return num_erased;
 }
 
-void its_flip_triangles(indexed_triangle_set &its)
-{
-    for (stl_triangle_vertex_indices &face : its.indices)
-        std::swap(face(1), face(2));
-}
-
-int its_num_degenerate_faces(const indexed_triangle_set &its)
-{
-    return std::count_if(its.indices.begin(), its.indices.end(), [](auto &face) {
-        return face(0) == face(1) || face(0) == face(2) || face(1) == face(2);
-    });
-}
-
 int its_remove_degenerate_faces(indexed_triangle_set &its, bool shrink_to_fit)
 {
-    auto it = std::remove_if(its.indices.begin(), its.indices.end(), [](auto &face) {
+    auto degenerate = [](const stl_triangle_vertex_indices &face) {
         return face(0) == face(1) || face(0) == face(2) || face(1) == face(2);
-    });
-
-    int removed = std::distance(it, its.indices.end());
-    its.indices.erase(it, its.indices.end());
+    };
 
-    if (removed && shrink_to_fit)
-        its.indices.shrink_to_fit();
+    if (its.indices.size() < its_parallel_threshold) {
+        auto it = std::remove_if(its.indices.begin(), its.indices.end(), degenerate);
+        int removed = std::distance(it, its.indices.end());
+        its.indices.erase(it, its.indices.end());
+        if (removed && shrink_to_fit)
+            its.indices.shrink_to_fit();
+        return removed;
+    }
 
+    // Stable parallel compaction: calculate the new face indices (prefix sum), then copy.
+    std::vector<int> new_index;
+    const int        num_kept = its_new_indices_of_kept(its.indices.size(), [&its, &degenerate](size_t i) { return ! degenerate(its.indices[i]); }, new_index);
+    int removed = int(its.indices.size()) - num_kept;
+    if (removed) {
+        std::vector<stl_triangle_vertex_indices> indices(num_kept);
+        its_for_each_range(its.indices.size(), [&its, &new_index, &indices](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++ i)
+                if (new_index[i] != -1)
+                    indices[new_index[i]] = its.indices[i];
+        });
+        its.indices = std::move(indices);
+    }
     return removed;
 }
 
 int its_compactify_vertices(indexed_triangle_set &its, bool shrink_to_fit)
 {
-    // First used to mark referenced vertices, later used for mapping old vertex index to a new one.
-    std::vector<int> vertex_map(its.vertices.size(), 0);
-    // Mark referenced vertices.
-    for (const stl_triangle_vertex_indices &face : its.indices)
-        for (int i = 0; i < 3; ++ i)
-            vertex_map[face(i)] = 1;
-    // Compactify vertices, update map from old vertex index to a new one.
-    int last = 0;
-    for (int i = 0; i < int(vertex_map.size()); ++ i)
-        if (vertex_map[i]) {
-            if (last < i)
-                its.vertices[last] = its.vertices[i];
-            vertex_map[i] = last ++;
-        }
-    int removed = int(its.vertices.size()) - last;
-    if (removed) {
-        its.vertices.erase(its.vertices.begin() + last, its.vertices.end());
-        // Update faces with the new vertex indices.
-        for (stl_triangle_vertex_indices &face : its.indices)
+    // Mark referenced vertices. Multiple faces may mark the same vertex concurrently.
+    std::vector<std::atomic<char>> referenced(its.vertices.size());
+    its_for_each_range(its.indices.size(), [&its, &referenced](size_t begin, size_t end) {
+        for (size_t face_idx = begin; face_idx < end; ++ face_idx)
             for (int i = 0; i < 3; ++ i)
-                face(i) = vertex_map[face(i)];
-        // Optionally shrink the vertices.
-        if (shrink_to_fit)
-            its.vertices.shrink_to_fit();
-    }
+                referenced[its.indices[face_idx](i)].store(1, std::memory_order_relaxed);
+    });
+    // Calculate the new vertex indices, then compactify vertices and update faces with the new vertex indices.
+    auto             keep = [&referenced](size_t i) { return referenced[i].load(std::memory_order_relaxed) != 0; };
+    std::vector<int> vertex_map;
+    const int        last = its_new_indices_of_kept(its.vertices.size(), keep, vertex_map);
+    int removed = int(its.vertices.size()) - last;
+    if (removed)
+        its_remap_vertices(its, keep, vertex_map, last, shrink_to_fit);
     return removed;
 }
 
@@ -1686,10 +1745,11 @@ std::vector<Vec3i> its_face_neighbors_par(const indexed_triangle_set &its)
 
 std::vector<Vec3f> its_face_normals(const indexed_triangle_set &its) 
 {
-    std::vector<Vec3f> normals;
-    normals.reserve(its.indices.size());
-    for (stl_triangle_vertex_indices face : its.indices)
-        normals.push_back(its_face_normal(its, face));
+    std::vector<Vec3f> normals(its.indices.size());
+    its_for_each_range(its.indices.size(), [&its, &normals](size_t begin, size_t end) {
+        for (size_t face_idx = begin; face_idx < end; ++ face_idx)
+            normals[face_idx] = its_face_normal(its, its.indices[face_idx]);
+    });
     return normals;
 }
 
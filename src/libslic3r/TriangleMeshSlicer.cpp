@@ -380,39 +380,18 @@ private:
     std::array<CacheLineAlignedMutex, 64> m_mutexes;
 };
 
-template<typename TransformVertex>
-void slice_facet_at_zs(
-    // Scaled or unscaled vertices. transform_vertex_fn may scale zs.
-    const std::vector<Vec3f>                         &mesh_vertices,
-    const TransformVertex                            &transform_vertex_fn,
-    const stl_triangle_vertex_indices                &indices,
-    const Vec3i                                      &edge_ids,
-    // Scaled or unscaled zs. If vertices have their zs scaled or transform_vertex_fn scales them, then zs have to be scaled as well.
-    const std::vector<float>                         &zs,
-    std::vector<IntersectionLines>                   &lines,
-    LinesMutexes                                     &lines_mutex)
+// Equivalent to std::lower_bound(zs.begin(), zs.end(), z), however the search starts at hint, which is updated
+// with the result. Neighbor facets of a mesh tend to lie between the same pair of the slicing planes,
+// thus the binary search is mostly avoided.
+static inline std::vector<float>::const_iterator zs_lower_bound(const std::vector<float> &zs, const float z, size_t &hint)
 {
-    stl_vertex vertices[3] { transform_vertex_fn(mesh_vertices[indices(0)]), transform_vertex_fn(mesh_vertices[indices(1)]), transform_vertex_fn(mesh_vertices[indices(2)]) };
-
-    // find facet extents
-    const float min_z = fminf(vertices[0].z(), fminf(vertices[1].z(), vertices[2].z()));
-    const float max_z = fmaxf(vertices[0].z(), fmaxf(vertices[1].z(), vertices[2].z()));
-    
-    // find layer extents
-    auto min_layer = std::lower_bound(zs.begin(), zs.end(), min_z); // first layer whose slice_z is >= min_z
-    auto max_layer = std::upper_bound(min_layer, zs.end(), max_z); // first layer whose slice_z is > max_z
-    int  idx_vertex_lowest = (vertices[1].z() == min_z) ? 1 : ((vertices[2].z() == min_z) ? 2 : 0);
-    
-    for (auto it = min_layer; it != max_layer; ++ it) {
-        IntersectionLine il;
-        // Ignore horizontal triangles. Any valid horizontal triangle must have a vertical triangle connected, otherwise the part has zero volume.
-        if (min_z != max_z && slice_facet(*it, vertices, indices, edge_ids, idx_vertex_lowest, false, il) == FacetSliceType::Slicing) {
-            assert(il.edge_type != IntersectionLine::FacetEdgeType::Horizontal);
-            size_t slice_id = it - zs.begin();
-            boost::lock_guard<std::mutex> l(lines_mutex(slice_id));
-            lines[slice_id].emplace_back(il);
-        }
-    }
+    auto it = zs.begin() + hint;
+    if (it != zs.end() && *it < z)
+        it = std::lower_bound(it + 1, zs.end(), z);
+    else if (it != zs.begin() && *(it - 1) >= z)
+        it = std::lower_bound(zs.begin(), it, z);
+    hint = it - zs.begin();
+    return it;
 }
 
 template<typename TransformVertex, typename ThrowOnCancel>
@@ -425,17 +404,101 @@ static inline std::vector<IntersectionLines> slice_make_lines(
     const ThrowOnCancel                              throw_on_cancel_fn)
 {
     std::vector<IntersectionLines>  lines(zs.size(), IntersectionLines{});
-    LinesMutexes                    lines_mutex;
+    if (zs.empty() || indices.empty())
+        return lines;
+
+    // Intersection line tagged with the index of its slicing plane.
+    struct SliceLine {
+        uint32_t         slice_id;
+        IntersectionLine line;
+    };
+    // The facets are split into chunks in a deterministic way. Each chunk collects its intersection lines sorted by the slicing plane,
+    // they are merged into the layers in the order of the chunks afterwards. Thus no locking is needed
+    // and the order of the lines in a layer does not depend on thread scheduling.
+    const size_t                        chunk_size = std::max<size_t>(16384, indices.size() / 256 + 1);
+    const size_t                        num_chunks = (indices.size() + chunk_size - 1) / chunk_size;
+    std::vector<std::vector<SliceLine>> chunk_lines(num_chunks);
     tbb::parallel_for(
-        tbb::blocked_range<int>(0, int(indices.size())),
-        [&vertices, &transform_vertex_fn, &indices, &face_edge_ids, &zs, &lines, &lines_mutex, throw_on_cancel_fn](const tbb::blocked_range<int> &range) {
-            for (int face_idx = range.begin(); face_idx < range.end(); ++ face_idx) {
-                if ((face_idx & 0x0ffff) == 0)
-                    throw_on_cancel_fn();
-                slice_facet_at_zs(vertices, transform_vertex_fn, indices[face_idx], face_edge_ids[face_idx], zs, lines, lines_mutex);
+        tbb::blocked_range<size_t>(0, num_chunks, 1),
+        [&vertices, &transform_vertex_fn, &indices, &face_edge_ids, &zs, &chunk_lines, chunk_size, throw_on_cancel_fn](const tbb::blocked_range<size_t> &range) {
+            // Facets of a chunk are processed in batches: The vertices of a batch are transformed first, then the Z extents of the facets
+            // are calculated in a structure of arrays by a loop which is vectorized by the compiler. Only the facets spanning
+            // a slicing plane, which is a small fraction of the facets of a finely tesselated mesh, are sliced.
+            static constexpr const size_t batch_size_max = 256;
+            std::array<stl_vertex, 3 * batch_size_max> batch_vertices;
+            std::array<float, batch_size_max>          batch_min_z;
+            std::array<float, batch_size_max>          batch_max_z;
+            for (size_t chunk_id = range.begin(); chunk_id < range.end(); ++ chunk_id) {
+                throw_on_cancel_fn();
+                std::vector<SliceLine> &out       = chunk_lines[chunk_id];
+                const size_t            chunk_end = std::min(indices.size(), (chunk_id + 1) * chunk_size);
+                size_t                  hint      = 0;
+                for (size_t batch_begin = chunk_id * chunk_size; batch_begin < chunk_end; batch_begin += batch_size_max) {
+                    const size_t batch_size = std::min(batch_size_max, chunk_end - batch_begin);
+                    for (size_t i = 0; i < batch_size; ++ i) {
+                        const stl_triangle_vertex_indices &facet = indices[batch_begin + i];
+                        batch_vertices[3 * i]     = transform_vertex_fn(vertices[facet(0)]);
+                        batch_vertices[3 * i + 1] = transform_vertex_fn(vertices[facet(1)]);
+                        batch_vertices[3 * i + 2] = transform_vertex_fn(vertices[facet(2)]);
+                    }
+                    for (size_t i = 0; i < batch_size; ++ i) {
+                        const float z0 = batch_vertices[3 * i].z();
+                        const float z1 = batch_vertices[3 * i + 1].z();
+                        const float z2 = batch_vertices[3 * i + 2].z();
+                        batch_min_z[i] = std::min(z0, std::min(z1, z2));
+                        batch_max_z[i] = std::max(z0, std::max(z1, z2));
+                    }
+                    for (size_t i = 0; i < batch_size; ++ i) {
+                        const float min_z = batch_min_z[i];
+                        const float max_z = batch_max_z[i];
+                        // Ignore horizontal triangles. Any valid horizontal triangle must have a vertical triangle connected, otherwise the part has zero volume.
+                        if (min_z == max_z)
+                            continue;
+                        // first layer whose slice_z is >= min_z
+                        auto min_layer = zs_lower_bound(zs, min_z, hint);
+                        if (min_layer == zs.end() || *min_layer > max_z)
+                            // The facet does not span any slicing plane.
+                            continue;
+                        // first layer whose slice_z is > max_z
+                        auto              max_layer         = std::upper_bound(min_layer, zs.end(), max_z);
+                        const stl_vertex *facet_vertices    = batch_vertices.data() + 3 * i;
+                        const size_t      face_idx          = batch_begin + i;
+                        int               idx_vertex_lowest = (facet_vertices[1].z() == min_z) ? 1 : ((facet_vertices[2].z() == min_z) ? 2 : 0);
+                        for (auto it = min_layer; it != max_layer; ++ it) {
+                            IntersectionLine il;
+                            if (slice_facet(*it, facet_vertices, indices[face_idx], face_edge_ids[face_idx], idx_vertex_lowest, false, il) == FacetSliceType::Slicing) {
+                                assert(il.edge_type != IntersectionLine::FacetEdgeType::Horizontal);
+                                out.push_back({ uint32_t(it - zs.begin()), il });
+                            }
+                        }
+                    }
+                }
+                std::stable_sort(out.begin(), out.end(), [](const SliceLine &l, const SliceLine &r) { return l.slice_id < r.slice_id; });
             }
-        }
-    );
+        });
+
+    throw_on_cancel_fn();
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, zs.size()),
+        [&chunk_lines, &lines](const tbb::blocked_range<size_t> &range) {
+            auto lower = [](const SliceLine &l, uint32_t slice_id) { return l.slice_id < slice_id; };
+            std::vector<std::pair<const SliceLine*, const SliceLine*>> spans(chunk_lines.size());
+            for (size_t slice_id = range.begin(); slice_id < range.end(); ++ slice_id) {
+                size_t num_lines = 0;
+                for (size_t chunk_id = 0; chunk_id < chunk_lines.size(); ++ chunk_id) {
+                    const std::vector<SliceLine> &src   = chunk_lines[chunk_id];
+                    const SliceLine              *begin = src.data() + (std::lower_bound(src.begin(), src.end(), uint32_t(slice_id), lower) - src.begin());
+                    const SliceLine              *end   = src.data() + (std::lower_bound(src.begin(), src.end(), uint32_t(slice_id + 1), lower) - src.begin());
+                    spans[chunk_id] = { begin, end };
+                    num_lines += end - begin;
+                }
+                IntersectionLines &dst = lines[slice_id];
+                dst.reserve(num_lines);
+                for (const auto &[begin, end] : spans)
+                    for (const SliceLine *l = begin; l != end; ++ l)
+                        dst.emplace_back(l->line);
+            }
+        });
     return lines;
 }
 
@@ -2157,7 +2220,7 @@ static void triangulate_slice(
 
     if (triangulate) {
         size_t idx_vertex_new_first = its.vertices.size();
-        Pointf3s triangles = triangulate_expolygons_3d(make_expolygons_simple(lines), z, normals_down);
+        Pointf3s triangles = triangulate_expolygons_3d_parallel(make_expolygons_simple(lines), z, normals_down);
         for (size_t i = 0; i < triangles.size(); ) {
             stl_triangle_vertex_indices facet;
             for (size_t j = 0; j < 3; ++ j) {
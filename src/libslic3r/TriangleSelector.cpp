@@ -239,7 +239,7 @@ int TriangleSelector::select_unsplit_triangle(const Vec3f &hit, int facet_idx) c
     return this->select_unsplit_triangle(hit, facet_idx, neighbors);
 }
 
-void TriangleSelector::select_patch(int facet_start, std::unique_ptr<Cursor> &&cursor, TriangleStateType new_state, const Transform3d& trafo_no_translate, bool triangle_splitting, float highlight_by_angle_deg)
+bool TriangleSelector::select_patch(int facet_start, std::unique_ptr<Cursor> &&cursor, TriangleStateType new_state, const Transform3d& trafo_no_translate, bool triangle_splitting, float highlight_by_angle_deg)
 {
     assert(facet_start < m_orig_size_indices);
 
@@ -258,29 +258,37 @@ void TriangleSelector::select_patch(int facet_start, std::unique_ptr<Cursor> &&c
     const float highlight_angle_limit = cos(Geometry::deg2rad(highlight_by_angle_deg));
     Vec3f       vec_down              = (trafo_no_translate.inverse() * -Vec3d::UnitZ()).normalized().cast<float>();
 
+    // Keep track of facets of the original mesh we already enqueued.
+    if (m_patch_visited.size() != size_t(m_orig_size_indices) || ++ m_patch_visited_stamp == 0) {
+        m_patch_visited.assign(m_orig_size_indices, 0);
+        m_patch_visited_stamp = 1;
+    }
+    m_patch_modified = false;
+
     // Now start with the facet the pointer points to and check all adjacent facets.
     std::vector<int> facets_to_check;
     facets_to_check.reserve(16);
     facets_to_check.emplace_back(facet_start);
-    // Keep track of facets of the original mesh we already processed.
-    std::vector<bool> visited(m_orig_size_indices, false);
+    m_patch_visited[facet_start] = m_patch_visited_stamp;
     // Breadth-first search around the hit point. facets_to_check may grow significantly large.
     // Head of the bread-first facets_to_check FIFO.
     int facet_idx = 0;
     while (facet_idx < int(facets_to_check.size())) {
         int          facet        = facets_to_check[facet_idx];
         const Vec3f &facet_normal = m_face_normals[m_triangles[facet].source_triangle];
-        if (!visited[facet] && (highlight_by_angle_deg == 0.f || vec_down.dot(facet_normal) >= highlight_angle_limit)) {
+        if (highlight_by_angle_deg == 0.f || vec_down.dot(facet_normal) >= highlight_angle_limit) {
             if (select_triangle(facet, new_state, triangle_splitting)) {
                 // add neighboring facets to list to be processed later
                 for (int neighbor_idx : m_neighbors[facet])
-                    if (neighbor_idx >= 0 && m_cursor->is_facet_visible(neighbor_idx, m_face_normals))
+                    if (neighbor_idx >= 0 && m_patch_visited[neighbor_idx] != m_patch_visited_stamp && m_cursor->is_facet_visible(neighbor_idx, m_face_normals)) {
+                        m_patch_visited[neighbor_idx] = m_patch_visited_stamp;
                         facets_to_check.push_back(neighbor_idx);
+                    }
             }
         }
-        visited[facet] = true;
         ++facet_idx;
     }
+    return m_patch_modified;
 }
 
 bool TriangleSelector::is_facet_clipped(int facet_idx, const ClippingPlane &clp) const
@@ -882,6 +890,8 @@ bool TriangleSelector::select_triangle_recursive(int facet_idx, const Vec3i &nei
         return false;
 
     if (num_of_inside_vertices == 3) {
+        if (tr->is_split() || tr->get_state() != type)
+            m_patch_modified = true;
         // dump any subdivision and select whole triangle
         undivide_triangle(facet_idx);
         tr->set_state(type);
@@ -895,6 +905,9 @@ bool TriangleSelector::select_triangle_recursive(int facet_idx, const Vec3i &nei
             return true;
         }
 
+        if (! tr->is_split())
+            // Either split below or its state changes.
+            m_patch_modified = true;
         if (triangle_splitting)
             split_triangle(facet_idx, neighbors);
         else if (!m_triangles[facet_idx].is_split())
@@ -289,7 +289,8 @@ public:
     [[nodiscard]] int select_unsplit_triangle(const Vec3f &hit, int facet_idx, const Vec3i &neighbors) const;
 
     // Select all triangles fully inside the circle, subdivide where needed.
-    void select_patch(int                       facet_start,                   // facet of the original mesh (unsplit) that the hit point belongs to
+    // Returns false if no triangle was modified, thus the render data does not need to be updated.
+    bool select_patch(int                       facet_start,                   // facet of the original mesh (unsplit) that the hit point belongs to
                       std::unique_ptr<Cursor> &&cursor,                        // Cursor containing information about the point where to start, camera position (mesh coords), matrix to get from mesh to world, and its shape and type.
                       TriangleStateType         new_state,                     // enforcer or blocker?
                       const Transform3d        &trafo_no_translate,            // matrix to get from mesh to world without translation
@@ -434,6 +435,13 @@ protected:
     std::unique_ptr<Cursor> m_cursor;
     // Zero indicates an uninitialized state.
     float m_old_cursor_radius_sqr = 0;
+    // Set by select_triangle_recursive() if a triangle was split or its state changed.
+    bool m_patch_modified = false;
+    // Stamps of the original triangles enqueued by select_patch(). Compared to a std::vector<bool> allocated
+    // for each call, marking the triangles by an increasing stamp keeps the cost of a brush stroke
+    // proportional to the size of the brush, not to the size of the mesh.
+    std::vector<uint32_t> m_patch_visited;
+    uint32_t              m_patch_visited_stamp = 0;
 
     // Private functions:
 private:
@@ -31,6 +31,8 @@ extern std::string format_memsize(size_t bytes, unsigned int decimals = 1);
 // The string is non-empty if the loglevel >= info (3) or ignore_loglevel==true.
 // Latter is used to get the memory info from SysInfoDialog.
 extern std::string log_memory_info(bool ignore_loglevel = false);
+// Returns the peak resident memory of the process in bytes, zero if not available.
+extern size_t peak_memory_usage();
 extern void enforce_thread_count(std::size_t count);
 // Returns the size of physical memory (RAM) in bytes.
 extern size_t total_physical_memory();
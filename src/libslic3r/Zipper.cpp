@@ -3,7 +3,9 @@
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
 #include <boost/log/trivial.hpp>
+#include <oneapi/tbb/task_group.h>
 #include <cstring>
+#include <deque>
 
 #include "Exception.hpp"
 #include "Zipper.hpp"
@@ -19,10 +21,47 @@
 
 namespace Slic3r {
 
+namespace {
+
+// Compressed entries are buffered until this many uncompressed bytes are pending,
+// then the compression is waited for and the entries are written into the archive.
+constexpr size_t max_pending_bytes = 64 * 1024 * 1024;
+
+} // namespace
+
+int Zipper::compression_level(e_compression compression)
+{
+    switch (compression) {
+    case NO_COMPRESSION:      return MZ_NO_COMPRESSION;
+    case FAST_COMPRESSION:    return MZ_BEST_SPEED;
+    case DEFAULT_COMPRESSION: return MZ_DEFAULT_LEVEL;
+    case TIGHT_COMPRESSION:   return MZ_BEST_COMPRESSION;
+    }
+    return MZ_DEFAULT_LEVEL;
+}
+
 class Zipper::Impl: public MZ_Archive {
 public:
     std::string m_zipname;
 
+    struct PendingEntry {
+        std::string name;
+        // Uncompressed data, released once compressed if the compression pays off.
+        std::string data;
+        size_t      data_size { 0 };
+        int         level { MZ_NO_COMPRESSION };
+        std::string compressed;
+        mz_uint32   crc32 { 0 };
+        bool        compressed_ok { false };
+    };
+    // std::deque keeps the references to the entries valid while the background tasks run.
+    std::deque<PendingEntry> m_pending;
+    size_t                   m_pending_bytes { 0 };
+    tbb::task_group          m_compress_tasks;
+    DeflateFn                m_deflate { deflate_raw };
+
+    ~Impl() { m_compress_tasks.wait(); }
+
     std::string formatted_errorstr() const
     {
         return _u8L("Error with ZIP archive") + " " + m_zipname + ": " +
@@ -38,6 +77,61 @@ public:
     {
         return arch.m_zip_mode != MZ_ZIP_MODE_WRITING_HAS_BEEN_FINALIZED;
     }
+
+    void add_entry(const std::string &name, std::string &&data, int level)
+    {
+        if (level == MZ_NO_COMPRESSION && m_pending.empty()) {
+            // Nothing is pending, thus the ordering of entries is kept when written right away.
+            if (! mz_zip_writer_add_mem(&arch, name.c_str(), data.data(), data.size(), MZ_NO_COMPRESSION))
+                this->blow_up();
+            return;
+        }
+
+        PendingEntry &entry = m_pending.emplace_back();
+        entry.name      = name;
+        entry.data      = std::move(data);
+        entry.data_size = entry.data.size();
+        entry.level     = level;
+        m_pending_bytes += entry.data_size;
+        if (level != MZ_NO_COMPRESSION && ! entry.data.empty())
+            m_compress_tasks.run([&entry, deflate = m_deflate]() {
+                entry.crc32 = mz_uint32(mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const unsigned char*>(entry.data.data()), entry.data.size()));
+                try {
+                    entry.compressed_ok = deflate(entry.data.data(), entry.data.size(), entry.level, entry.compressed);
+                } catch (...) {
+                    entry.compressed_ok = false;
+                }
+                if (entry.compressed_ok && entry.compressed.size() < entry.data.size())
+                    // Release the memory early.
+                    std::string().swap(entry.data);
+                else
+                    // Compression failed or did not pay off, the entry will be stored.
+                    std::string().swap(entry.compressed);
+            });
+
+        if (m_pending_bytes > max_pending_bytes)
+            this->write_pending();
+    }
+
+    // Wait for the background compression and write the pending entries in the order they were added.
+    void write_pending()
+    {
+        m_compress_tasks.wait();
+        for (; ! m_pending.empty(); m_pending.pop_front()) {
+            const PendingEntry &entry = m_pending.front();
+            bool ok = entry.data.empty() && entry.data_size > 0 ?
+                // Compressed data, pass the size and CRC of the uncompressed data, so that miniz stores it as deflated.
+                mz_zip_writer_add_mem_ex_v2(&arch, entry.name.c_str(), entry.compressed.data(), entry.compressed.size(), nullptr, 0,
+                    mz_uint(entry.level) | MZ_ZIP_FLAG_COMPRESSED_DATA, entry.data_size, entry.crc32, nullptr, nullptr, 0, nullptr, 0) :
+                mz_zip_writer_add_mem(&arch, entry.name.c_str(), entry.data.data(), entry.data.size(), MZ_NO_COMPRESSION);
+            if (! ok) {
+                m_pending.clear();
+                m_pending_bytes = 0;
+                this->blow_up();
+            }
+        }
+        m_pending_bytes = 0;
+    }
 };
 
 Zipper::Zipper(const std::string &zipfname, e_compression compression)
@@ -58,7 +152,7 @@ Zipper::~Zipper()
 {
     if(m_impl->is_alive()) {
         // Flush the current entry if not finished yet.
-        try { finish_entry(); } catch(...) {
+        try { finish_entry(); m_impl->write_pending(); } catch(...) {
             BOOST_LOG_TRIVIAL(error) << m_impl->formatted_errorstr();
         }
 
@@ -94,19 +188,16 @@ void Zipper::add_entry(const std::string &name)
 }
 
 void Zipper::add_entry(const std::string &name, const void *data, size_t l)
+{
+    add_entry(name, data, l, m_compression);
+}
+
+void Zipper::add_entry(const std::string &name, const void *data, size_t l, e_compression compression)
 {
     if(!m_impl->is_alive()) return;
 
     finish_entry();
-    mz_uint cmpr = MZ_NO_COMPRESSION;
-    switch (m_compression) {
-    case NO_COMPRESSION: cmpr = MZ_NO_COMPRESSION; break;
-    case FAST_COMPRESSION: cmpr = MZ_BEST_SPEED; break;
-    case TIGHT_COMPRESSION: cmpr = MZ_BEST_COMPRESSION; break;
-    }
-
-    if(!mz_zip_writer_add_mem(&m_impl->arch, name.c_str(), data, l, cmpr))
-        m_impl->blow_up();
+    m_impl->add_entry(name, std::string(static_cast<const char*>(data), l), Zipper::compression_level(compression));
 
     m_entry.clear();
     m_data.clear();
@@ -116,20 +207,8 @@ void Zipper::finish_entry()
 {
     if(!m_impl->is_alive()) return;
 
-    if(!m_data.empty() && !m_entry.empty()) {
-        mz_uint compression = MZ_NO_COMPRESSION;
-
-        switch (m_compression) {
-        case NO_COMPRESSION: compression = MZ_NO_COMPRESSION; break;
-        case FAST_COMPRESSION: compression = MZ_BEST_SPEED; break;
-        case TIGHT_COMPRESSION: compression = MZ_BEST_COMPRESSION; break;
-        }
-
-        if(!mz_zip_writer_add_mem(&m_impl->arch, m_entry.c_str(),
-                                  m_data.c_str(),
-                                  m_data.size(),
-                                  compression)) m_impl->blow_up();
-    }
+    if(!m_data.empty() && !m_entry.empty())
+        m_impl->add_entry(m_entry, std::move(m_data), Zipper::compression_level(m_compression));
 
     m_data.clear();
     m_entry.clear();
@@ -139,8 +218,11 @@ void Zipper::finalize()
 {
     finish_entry();
 
-    if(m_impl->is_alive()) if(!mz_zip_writer_finalize_archive(&m_impl->arch))
-        m_impl->blow_up();
+    if(m_impl->is_alive()) {
+        m_impl->write_pending();
+        if(!mz_zip_writer_finalize_archive(&m_impl->arch))
+            m_impl->blow_up();
+    }
 }
 
 const std::string &Zipper::get_filename() const
@@ -148,4 +230,10 @@ const std::string &Zipper::get_filename() const
     return m_impl->m_zipname;
 }
 
+void Zipper::set_deflate_backend(DeflateFn deflate)
+{
+    // Entries being compressed keep their own copy of the backend.
+    m_impl->m_deflate = std::move(deflate);
+}
+
 }
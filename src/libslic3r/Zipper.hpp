@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <string>
 #include <memory>
+#include <functional>
 #include <type_traits>
 #include <utility>
 #include <cstddef>
@@ -16,15 +17,27 @@
 namespace Slic3r {
 
 // Class for creating zip archives.
+// Entries are compressed in parallel in the background and written into the archive in the order
+// they were added. Errors of the background compression are reported by the next call writing into the archive.
 class Zipper {
 public:
-    // Three compression levels supported
+    // Compression levels supported, trading speed for ratio.
     enum e_compression {
         NO_COMPRESSION,
         FAST_COMPRESSION,
+        // The default level of miniz / zlib.
+        DEFAULT_COMPRESSION,
         TIGHT_COMPRESSION
     };
 
+    // Compression backend: Compresses data into a raw deflate stream (without the zlib header)
+    // with a zlib compression level (1 to 9, 10 for the slowest and tightest), appending to out.
+    // Returns false on failure. Called from multiple threads at once.
+    using DeflateFn = std::function<bool(const void *data, size_t bytes, int level, std::string &out)>;
+
+    // zlib compression level (0 to 10) of a compression level of Zipper.
+    static int compression_level(e_compression compression);
+
 private:
     class Impl;
 
@@ -60,6 +73,10 @@ public:
     /// This method throws exactly like finish_entry() does.
     void add_entry(const std::string& name, const void* data, size_t bytes);
 
+    /// Same as above with the compression level overridden for this entry,
+    /// for example to store data which is compressed already.
+    void add_entry(const std::string& name, const void* data, size_t bytes, e_compression compression);
+
     // Writing data to the archive works like with standard streams. The target
     // within the zip file is the entry created with the add_entry method.
 
@@ -94,6 +111,9 @@ public:
     void finalize();
 
     const std::string & get_filename() const;
+
+    // Replace the default deflate engine of miniz with another one.
+    void set_deflate_backend(DeflateFn deflate);
 };
 
 
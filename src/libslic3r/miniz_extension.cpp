@@ -3,6 +3,7 @@
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
 #include <cstdio>
+#include <memory>
 
 #include "miniz_extension.hpp"
 #include "miniz.h"
@@ -161,4 +162,17 @@ std::string MZ_Archive::get_errorstr(mz_zip_error mz_err)
     return "unknown error";
 }
 
+bool deflate_raw(const void *data, size_t bytes, int level, std::string &out)
+{
+    // The compressor state is large (hundreds of kB), allocate it on heap.
+    auto compressor = std::make_unique<tdefl_compressor>();
+    const int flags = int(tdefl_create_comp_flags_from_zip_params(level, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY));
+    auto put_buf = [](const void *buf, int len, void *user) -> mz_bool {
+        static_cast<std::string*>(user)->append(static_cast<const char*>(buf), size_t(len));
+        return MZ_TRUE;
+    };
+    return tdefl_init(compressor.get(), put_buf, &out, flags) == TDEFL_STATUS_OKAY &&
+           tdefl_compress_buffer(compressor.get(), data, bytes, TDEFL_FINISH) == TDEFL_STATUS_DONE;
+}
+
 } // namespace Slic3r
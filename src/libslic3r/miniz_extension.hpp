@@ -15,6 +15,11 @@ bool open_zip_writer(mz_zip_archive *zip, const std::string &fname_utf8);
 bool close_zip_reader(mz_zip_archive *zip);
 bool close_zip_writer(mz_zip_archive *zip);
 
+// Compress data into a raw deflate stream (without the zlib header, as stored inside ZIP archives)
+// with a compression level from 0 to MZ_UBER_COMPRESSION, appending to out.
+// Thread safe, each call uses its own compressor.
+bool deflate_raw(const void *data, size_t bytes, int level, std::string &out);
+
 class MZ_Archive {
 public:
     mz_zip_archive arch;
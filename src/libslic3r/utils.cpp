@@ -1190,6 +1190,25 @@ std::string log_memory_info(bool ignore_loglevel)
     return out;
 }
 
+size_t peak_memory_usage()
+{
+#ifdef WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return size_t(pmc.PeakWorkingSetSize);
+#elif defined(__linux__) or defined(__APPLE__)
+    rusage memory_info;
+    if (getrusage(RUSAGE_SELF, &memory_info) == 0) {
+        size_t peak_mem_usage = (size_t)memory_info.ru_maxrss;
+    #ifdef __linux__
+        peak_mem_usage *= 1024; // getrusage returns the value in kB on linux
+    #endif
+        return peak_mem_usage;
+    }
+#endif
+    return 0;
+}
+
 // Returns the size of physical memory (RAM) in bytes.
 // http://nadeausoftware.com/articles/2012/09/c_c_tip_how_get_physical_memory_size_system
 size_t total_physical_memory()
@@ -372,6 +372,17 @@ public:
         EGCodeExtrusionRole::Skirt, EGCodeExtrusionRole::SupportMaterial, EGCodeExtrusionRole::SupportMaterialInterface,
         EGCodeExtrusionRole::WipeTower, EGCodeExtrusionRole::Custom }) const;
     //
+    // Get the max count of segments rendered in a frame, 0 if unlimited.
+    //
+    size_t get_segments_budget() const;
+    //
+    // Set the max count of segments rendered in a frame, 0 if unlimited.
+    // When zoomed out, nearly collinear segments are merged according to the projected size of the toolpaths,
+    // the level of detail is further reduced if the count of rendered segments still exceeds the budget.
+    // Not supported when using OpenGL ES.
+    //
+    void set_segments_budget(size_t budget);
+    //
     // Return the size of the used cpu memory, in bytes
     //
     size_t get_used_cpu_memory() const;
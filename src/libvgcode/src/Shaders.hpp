@@ -30,6 +30,12 @@ static const char* Segments_Vertex_Shader =
 "uniform samplerBuffer height_width_angle_tex;\n"
 "uniform samplerBuffer color_tex;\n"
 "uniform usamplerBuffer segment_index_tex;\n"
+"uniform int segment_index_offset;\n"
+"uniform ivec2 view_range;\n"
+"uniform uint visibility_mask;\n"
+"uniform int top_layer_id;\n"
+"uniform int not_grayed_id;\n"
+"uniform vec3 grayed_color;\n"
 "in int vertex_id;\n"
 "out vec3 color;\n"
 "vec3 decode_color(float color) {\n"
@@ -47,8 +53,18 @@ static const char* Segments_Vertex_Shader =
 "  return ambient + top_diffuse + front_diffuse + top_specular + emission;\n"
 "}\n"
 "void main() {\n"
-"  int id_a = int(texelFetch(segment_index_tex, gl_InstanceID).r);\n"
-"  int id_b = id_a + 1;\n"
+"  // the upper bits of the segment index contain the count of merged segments, see ViewerImpl::update_enabled_segments_lod()\n"
+"  uint segment_index = texelFetch(segment_index_tex, segment_index_offset + gl_InstanceID).r;\n"
+"  int id_begin = int(segment_index & 0x07FFFFFFu);\n"
+"  // clip the segment to the visible range\n"
+"  int id_a = max(id_begin, view_range.x);\n"
+"  int id_b = min(id_begin + 1 + int(segment_index >> 27), view_range.y);\n"
+"  if (id_a >= id_b || (visibility_mask & (1u << uint(texelFetch(height_width_angle_tex, id_a).w))) == 0u) {\n"
+"    // hidden segment, collapse it into a degenerate primitive\n"
+"    color = vec3(0.0);\n"
+"    gl_Position = vec4(0.0, 0.0, 0.0, 1.0);\n"
+"    return;\n"
+"  }\n"
 "  vec3 pos_a = texelFetch(position_tex, id_a).xyz;\n"
 "  vec3 pos_b = texelFetch(position_tex, id_b).xyz;\n"
 "  vec3 line = pos_b - pos_a;\n"
@@ -132,7 +148,8 @@ static const char* Segments_Vertex_Shader =
 "  }\n"
 "  vec3 eye_position = (view_matrix * vec4(pos, 1.0)).xyz;\n"
 "  vec3 eye_normal = (view_matrix * vec4(normalize(pos - endpoint_pos), 0.0)).xyz;\n"
-"  vec3 color_base = decode_color(texelFetch(color_tex, id).r);\n"
+"  bool grayed = int(texelFetch(position_tex, id).w) < top_layer_id && id != not_grayed_id;\n"
+"  vec3 color_base = grayed ? grayed_color : decode_color(texelFetch(color_tex, id).r);\n"
 "  color = color_base * lighting(eye_position, eye_normal);\n"
 "  gl_Position = projection_matrix * vec4(eye_position, 1.0);\n"
 "}\n";
@@ -162,6 +179,10 @@ static const char* Options_Vertex_Shader =
 "uniform samplerBuffer height_width_angle_tex;\n"
 "uniform samplerBuffer color_tex;\n"
 "uniform usamplerBuffer segment_index_tex;\n"
+"uniform int segment_index_offset;\n"
+"uniform int top_layer_id;\n"
+"uniform int not_grayed_id;\n"
+"uniform vec3 grayed_color;\n"
 "in vec3 in_position;\n"
 "in vec3 in_normal;\n"
 "out vec3 color;\n"
@@ -180,7 +201,7 @@ static const char* Options_Vertex_Shader =
 "  return ambient + top_diffuse + front_diffuse + top_specular + emission;\n"
 "}\n"
 "void main() {\n"
-"  int id = int(texelFetch(segment_index_tex, gl_InstanceID).r);\n"
+"  int id = int(texelFetch(segment_index_tex, segment_index_offset + gl_InstanceID).r);\n"
 "  vec2 height_width = texelFetch(height_width_angle_tex, id).xy;\n"
 "  vec3 offset = texelFetch(position_tex, id).xyz - vec3(0.0, 0.0, 0.5 * height_width.x);\n"
 "  height_width *= scaling_factor;\n"
@@ -190,7 +211,8 @@ static const char* Options_Vertex_Shader =
 "    0.0, 0.0, height_width.x);\n"
 "  vec3 eye_position = (view_matrix * vec4(scale_matrix * in_position + offset, 1.0)).xyz;\n"
 "  vec3 eye_normal = (view_matrix * vec4(in_normal, 0.0)).xyz;\n"
-"  vec3 color_base = decode_color(texelFetch(color_tex, id).r);\n"
+"  bool grayed = int(texelFetch(position_tex, id).w) < top_layer_id && id != not_grayed_id;\n"
+"  vec3 color_base = grayed ? grayed_color : decode_color(texelFetch(color_tex, id).r);\n"
 "  color = color_base * lighting(eye_position, eye_normal);\n"
 "  gl_Position = projection_matrix * vec4(eye_position, 1.0);\n"
 "}\n";
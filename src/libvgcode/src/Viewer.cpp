@@ -357,6 +357,16 @@ size_t Viewer::get_used_gpu_memory() const
     return m_impl->get_used_gpu_memory();
 }
 
+size_t Viewer::get_segments_budget() const
+{
+    return m_impl->get_segments_budget();
+}
+
+void Viewer::set_segments_budget(size_t budget)
+{
+    m_impl->set_segments_budget(budget);
+}
+
 #if VGCODE_ENABLE_COG_AND_TOOL_MARKERS
 Vec3 Viewer::get_cog_position() const
 {
@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <cstring>
 
 namespace libvgcode {
 
@@ -264,6 +265,54 @@ unsigned int init_shader(const std::string& shader_name, const char* vertex_shad
     return shader_id;
 }
 
+// Bits of the visibility mask of the segments shader, extrusion roles use the bits [0..GCODE_EXTRUSION_ROLES_COUNT)
+static constexpr uint32_t SEGMENTS_VISIBILITY_TRAVELS_BIT = GCODE_EXTRUSION_ROLES_COUNT;
+static constexpr uint32_t SEGMENTS_VISIBILITY_WIPES_BIT = GCODE_EXTRUSION_ROLES_COUNT + 1;
+static constexpr uint32_t SEGMENTS_VISIBILITY_NEVER_BIT = 31;
+static_assert(SEGMENTS_VISIBILITY_WIPES_BIT < SEGMENTS_VISIBILITY_NEVER_BIT);
+
+#if !defined(ENABLE_OPENGL_ES)
+// Level of detail of the rendered segments.
+// Consecutive segments with the same attributes are merged into a single one while the vertices
+// in between lay closer to it than the tolerance of the current level. The tolerance of level N > 0
+// is LOD_MIN_TOLERANCE_MM * 2^(N-1), the level is chosen so that the tolerance stays under
+// LOD_PIXEL_TOLERANCE pixels at the point of the toolpaths closest to the camera.
+// The count of merged segments is stored in the upper LOD_SPAN_BITS bits of the segment index
+// sent to the gpu, thus level of detail is disabled for toolpaths with more than LOD_MAX_VERTEX_ID vertices.
+static constexpr float LOD_MIN_TOLERANCE_MM = 0.01f;
+static constexpr float LOD_PIXEL_TOLERANCE = 0.5f;
+static constexpr uint8_t LOD_MAX_LEVEL = 10;
+static constexpr uint32_t LOD_SPAN_BITS = 5;
+static constexpr uint32_t LOD_SPAN_SHIFT = 32 - LOD_SPAN_BITS;
+static constexpr uint32_t LOD_MAX_SPAN = 1 << LOD_SPAN_BITS;
+static constexpr size_t LOD_MAX_VERTEX_ID = (size_t(1) << LOD_SPAN_SHIFT) - 1;
+
+static uint32_t lod_segment_begin(uint32_t segment)
+{
+    return segment & static_cast<uint32_t>(LOD_MAX_VERTEX_ID);
+}
+
+static uint32_t lod_segment_end(uint32_t segment)
+{
+    return lod_segment_begin(segment) + 1 + (segment >> LOD_SPAN_SHIFT);
+}
+
+static float lod_level_tolerance(uint8_t level)
+{
+    return (level == 0) ? 0.0f : LOD_MIN_TOLERANCE_MM * static_cast<float>(1 << (level - 1));
+}
+
+static float sqr_distance_to_segment(const Vec3& p, const Vec3& a, const Vec3& b)
+{
+    const Vec3 ab = b - a;
+    const Vec3 ap = p - a;
+    const float sqr_len = dot(ab, ab);
+    const float t = (sqr_len > 0.0f) ? std::clamp(dot(ap, ab) / sqr_len, 0.0f, 1.0f) : 0.0f;
+    const Vec3 d = ap - t * ab;
+    return dot(d, d);
+}
+#endif // ENABLE_OPENGL_ES
+
 static void delete_textures(unsigned int& id)
 {
     if (id != 0) {
@@ -757,6 +806,14 @@ void ViewerImpl::init(const std::string& opengl_context_version)
     m_uni_segments_height_width_angle_tex_id = glGetUniformLocation(m_segments_shader_id, "height_width_angle_tex");
     m_uni_segments_colors_tex_id             = glGetUniformLocation(m_segments_shader_id, "color_tex");
     m_uni_segments_segment_index_tex_id      = glGetUniformLocation(m_segments_shader_id, "segment_index_tex");
+#if !defined(ENABLE_OPENGL_ES)
+    m_uni_segments_segment_index_offset_id   = glGetUniformLocation(m_segments_shader_id, "segment_index_offset");
+    m_uni_segments_view_range_id             = glGetUniformLocation(m_segments_shader_id, "view_range");
+    m_uni_segments_visibility_mask_id        = glGetUniformLocation(m_segments_shader_id, "visibility_mask");
+    m_uni_segments_top_layer_id              = glGetUniformLocation(m_segments_shader_id, "top_layer_id");
+    m_uni_segments_not_grayed_id             = glGetUniformLocation(m_segments_shader_id, "not_grayed_id");
+    m_uni_segments_grayed_color_id           = glGetUniformLocation(m_segments_shader_id, "grayed_color");
+#endif // ENABLE_OPENGL_ES
     glcheck();
     assert(m_uni_segments_view_matrix_id != -1 &&
            m_uni_segments_projection_matrix_id != -1 &&
@@ -765,6 +822,14 @@ void ViewerImpl::init(const std::string& opengl_context_version)
            m_uni_segments_height_width_angle_tex_id != -1 &&
            m_uni_segments_colors_tex_id != -1 &&
            m_uni_segments_segment_index_tex_id != -1);
+#if !defined(ENABLE_OPENGL_ES)
+    assert(m_uni_segments_segment_index_offset_id != -1 &&
+           m_uni_segments_view_range_id != -1 &&
+           m_uni_segments_visibility_mask_id != -1 &&
+           m_uni_segments_top_layer_id != -1 &&
+           m_uni_segments_not_grayed_id != -1 &&
+           m_uni_segments_grayed_color_id != -1);
+#endif // ENABLE_OPENGL_ES
 
     m_segment_template.init();
 
@@ -781,6 +846,12 @@ void ViewerImpl::init(const std::string& opengl_context_version)
     m_uni_options_height_width_angle_tex_id = glGetUniformLocation(m_options_shader_id, "height_width_angle_tex");
     m_uni_options_colors_tex_id             = glGetUniformLocation(m_options_shader_id, "color_tex");
     m_uni_options_segment_index_tex_id      = glGetUniformLocation(m_options_shader_id, "segment_index_tex");
+#if !defined(ENABLE_OPENGL_ES)
+    m_uni_options_segment_index_offset_id   = glGetUniformLocation(m_options_shader_id, "segment_index_offset");
+    m_uni_options_top_layer_id              = glGetUniformLocation(m_options_shader_id, "top_layer_id");
+    m_uni_options_not_grayed_id             = glGetUniformLocation(m_options_shader_id, "not_grayed_id");
+    m_uni_options_grayed_color_id           = glGetUniformLocation(m_options_shader_id, "grayed_color");
+#endif // ENABLE_OPENGL_ES
     glcheck();
     assert(m_uni_options_view_matrix_id != -1 &&
            m_uni_options_projection_matrix_id != -1 &&
@@ -788,6 +859,12 @@ void ViewerImpl::init(const std::string& opengl_context_version)
            m_uni_options_height_width_angle_tex_id != -1 &&
            m_uni_options_colors_tex_id != -1 &&
            m_uni_options_segment_index_tex_id != -1);
+#if !defined(ENABLE_OPENGL_ES)
+    assert(m_uni_options_segment_index_offset_id != -1 &&
+           m_uni_options_top_layer_id != -1 &&
+           m_uni_options_not_grayed_id != -1 &&
+           m_uni_options_grayed_color_id != -1);
+#endif // ENABLE_OPENGL_ES
 
     m_option_template.init(16);
 
@@ -877,8 +954,11 @@ void ViewerImpl::reset()
 #ifdef ENABLE_OPENGL_ES
     m_texture_data.reset();
 #else
-    m_enabled_segments_count = 0;
-    m_enabled_options_count = 0;
+    m_enabled_segments.clear();
+    m_rendered_segments.clear();
+    m_enabled_options.clear();
+    m_lod_level = 0;
+    m_update_lod = false;
 
     m_settings_used_for_ranges = std::nullopt;
 
@@ -902,6 +982,66 @@ void ViewerImpl::reset()
 // to position and heights_widths_angles vectors
 using Vec4 = std::array<float, 4>;
 
+#if !defined(ENABLE_OPENGL_ES)
+// Heights, widths, angles and visibility bits are sent to gpu as half floats (GL_RGBA16F), halving the size of their buffer.
+// The precision of a half float (11 bits of mantissa) is more than enough for them, the visibility bits are small integers
+// represented exactly.
+using Half4 = std::array<uint16_t, 4>;
+
+// Conversion of a float to the IEEE 754 half float, rounding to the nearest even.
+static uint16_t float_to_half(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    const uint32_t abs_bits = bits & 0x7fffffff;
+    if (abs_bits >= 0x7f800000)
+        // inf or nan
+        return sign | 0x7c00 | (abs_bits > 0x7f800000 ? 0x0200 : 0);
+    if (abs_bits >= 0x477ff000)
+        // overflow, rounds to inf
+        return sign | 0x7c00;
+    if (abs_bits < 0x38800000) {
+        // denormalized half or zero
+        if (abs_bits < 0x33000000)
+            return sign;
+        const uint32_t exponent = abs_bits >> 23;
+        const uint32_t mantissa = (abs_bits & 0x007fffff) | 0x00800000;
+        const uint32_t shift = 126 - exponent;
+        uint32_t half = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1) != 0))
+            ++half;
+        return sign | static_cast<uint16_t>(half);
+    }
+    // normalized half, the carry of the rounding correctly propagates into the exponent
+    uint32_t half = (abs_bits - 0x38000000) >> 13;
+    const uint32_t remainder = abs_bits & 0x1fff;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1) != 0))
+        ++half;
+    return sign | static_cast<uint16_t>(half);
+}
+
+static Half4 to_half4(const Vec4& v)
+{
+    return { float_to_half(v[0]), float_to_half(v[1]), float_to_half(v[2]), float_to_half(v[3]) };
+}
+#endif // !ENABLE_OPENGL_ES
+
+// Index of the bit of the visibility mask used by the segments shader, see ViewerImpl::get_segments_visibility_mask()
+static float segment_visibility_bit(const PathVertex& v)
+{
+    if (v.is_travel())
+        return static_cast<float>(SEGMENTS_VISIBILITY_TRAVELS_BIT);
+    else if (v.is_wipe())
+        return static_cast<float>(SEGMENTS_VISIBILITY_WIPES_BIT);
+    else if (v.is_extrusion())
+        return static_cast<float>(v.role);
+    else
+        return static_cast<float>(SEGMENTS_VISIBILITY_NEVER_BIT);
+}
+
 static void extract_pos_and_or_hwa(const std::vector<PathVertex>& vertices, float travels_radius, float wipes_radius, BitSet<>& valid_lines_bitset,
     std::vector<Vec4>* positions = nullptr, std::vector<Vec4>* heights_widths_angles = nullptr, bool update_bitset = false) {
   static constexpr const Vec3 ZERO = { 0.0f, 0.0f, 0.0f };
@@ -937,8 +1077,8 @@ static void extract_pos_and_or_hwa(const std::vector<PathVertex>& vertices, floa
         }
         
         if (positions != nullptr) {
-            // the last component is a dummy float to comply with GL_RGBA32F format
-            Vec4 position = { v.position[0], v.position[1], v.position[2], 0.0f };
+            // the last component contains the layer id, used by the shaders to render the toolpaths below the top layer as grayed
+            Vec4 position = { v.position[0], v.position[1], v.position[2], static_cast<float>(v.layer_id) };
             if (move_type == EMoveType::Extrude)
                 // push down extrusion vertices by half height to render them at the right z
                 position[2] -= 0.5f * v.height;
@@ -960,9 +1100,9 @@ static void extract_pos_and_or_hwa(const std::vector<PathVertex>& vertices, floa
                 height = v.height;
                 width = v.width;
             }
-            // the last component is a dummy float to comply with GL_RGBA32F format
+            // the last component contains the index of the bit of the visibility mask used by the segments shader
             heights_widths_angles->push_back({ height, width,
-                std::atan2(prev_line[0] * this_line[1] - prev_line[1] * this_line[0], dot(prev_line, this_line)), 0.0f });
+                std::atan2(prev_line[0] * this_line[1] - prev_line[1] * this_line[0], dot(prev_line, this_line)), segment_visibility_bit(v) });
         }
     }
 }
@@ -1057,7 +1197,7 @@ void ViewerImpl::load(GCodeInputData&& gcode_data)
         m_texture_data.set_heights_widths_angles(heights_widths_angles);
 #else
         m_positions_tex_size = positions.size() * sizeof(Vec3);
-        m_height_width_angle_tex_size = heights_widths_angles.size() * sizeof(Vec3);
+        m_height_width_angle_tex_size = heights_widths_angles.size() * sizeof(Half4);
 
         int old_bound_texture = 0;
         glsafe(glGetIntegerv(GL_TEXTURE_BINDING_BUFFER, &old_bound_texture));
@@ -1072,7 +1212,9 @@ void ViewerImpl::load(GCodeInputData&& gcode_data)
         // create and fill height, width and angles buffer
         glsafe(glGenBuffers(1, &m_heights_widths_angles_buf_id));
         glsafe(glBindBuffer(GL_TEXTURE_BUFFER, m_heights_widths_angles_buf_id));
-        glsafe(glBufferData(GL_TEXTURE_BUFFER, heights_widths_angles.size() * sizeof(Vec4), heights_widths_angles.data(), GL_DYNAMIC_DRAW));
+        std::vector<Half4> half_heights_widths_angles(heights_widths_angles.size());
+        std::transform(heights_widths_angles.begin(), heights_widths_angles.end(), half_heights_widths_angles.begin(), to_half4);
+        glsafe(glBufferData(GL_TEXTURE_BUFFER, half_heights_widths_angles.size() * sizeof(Half4), half_heights_widths_angles.data(), GL_DYNAMIC_DRAW));
         glsafe(glGenTextures(1, &m_heights_widths_angles_tex_id));
         glsafe(glBindTexture(GL_TEXTURE_BUFFER, m_heights_widths_angles_tex_id));
 
@@ -1112,24 +1254,15 @@ void ViewerImpl::update_enabled_entities()
 
     std::vector<uint32_t> enabled_segments;
     std::vector<uint32_t> enabled_options;
-    Interval range = m_view_range.get_visible();
-
-    // when top layer only visualization is enabled, we need to render
-    // all the toolpaths in the other layers as grayed, so extend the range
-    // to contain them
-    if (m_settings.top_layer_only_view_range)
-        range[0] = m_view_range.get_full()[0];
-
-    // to show the options at the current tool marker position we need to extend the range by one extra step
-    if (m_vertices[range[1]].is_option() && range[1] < static_cast<uint32_t>(m_vertices.size()) - 1)
-        ++range[1];
-
-    if (m_settings.spiral_vase_mode) {
-        // when spiral vase mode is enabled and only one layer is shown, extend the range by one step
-        const Interval& layers_range = m_layers.get_view_range();
-        if (layers_range[0] > 0 && layers_range[0] == layers_range[1])
-            --range[0];
-    }
+#ifdef ENABLE_OPENGL_ES
+    const Interval range = get_enabled_entities_range();
+    const bool filter_segments = true;
+#else
+    // the visible range, the extrusion roles and the travels and wipes visibility are applied by the shaders,
+    // see render_segments() and render_options(), so that moving the sliders does not require to update the gpu buffers
+    const Interval range = { 0, m_vertices.size() };
+    const bool filter_segments = false;
+#endif // ENABLE_OPENGL_ES
 
     for (size_t i = range[0]; i < range[1]; ++i) {
         const PathVertex& v = m_vertices[i];
@@ -1137,11 +1270,11 @@ void ViewerImpl::update_enabled_entities()
         if (!m_valid_lines_bitset[i] && !v.is_option())
             continue;
         if (v.is_travel()) {
-            if (!m_settings.options_visibility[size_t(EOptionType::Travels)])
+            if (filter_segments && !m_settings.options_visibility[size_t(EOptionType::Travels)])
                 continue;
         }
         else if (v.is_wipe()) {
-            if (!m_settings.options_visibility[size_t(EOptionType::Wipes)])
+            if (filter_segments && !m_settings.options_visibility[size_t(EOptionType::Wipes)])
                 continue;
         }
         else if (v.is_option()) {
@@ -1149,7 +1282,7 @@ void ViewerImpl::update_enabled_entities()
                 continue;
         }
         else if (v.is_extrusion()) {
-            if (!m_settings.extrusion_roles_visibility[size_t(v.role)])
+            if (filter_segments && !m_settings.extrusion_roles_visibility[size_t(v.role)])
                 continue;
         }
         else
@@ -1165,19 +1298,21 @@ void ViewerImpl::update_enabled_entities()
     m_texture_data.set_enabled_segments(enabled_segments);
     m_texture_data.set_enabled_options(enabled_options);
 #else
-    m_enabled_segments_count = enabled_segments.size();
-    m_enabled_options_count = enabled_options.size();
-
-    m_enabled_segments_tex_size = enabled_segments.size() * sizeof(uint32_t);
     m_enabled_options_tex_size = enabled_options.size() * sizeof(uint32_t);
 
-    // update gpu buffer for enabled segments
-    assert(m_enabled_segments_buf_id > 0);
-    glsafe(glBindBuffer(GL_TEXTURE_BUFFER, m_enabled_segments_buf_id));
-    if (!enabled_segments.empty())
-        glsafe(glBufferData(GL_TEXTURE_BUFFER, enabled_segments.size() * sizeof(uint32_t), enabled_segments.data(), GL_STATIC_DRAW));
-    else
-        glsafe(glBufferData(GL_TEXTURE_BUFFER, 0, nullptr, GL_STATIC_DRAW));
+    // the gpu buffer for enabled segments is updated in render() for the current level of detail
+    m_enabled_segments = std::move(enabled_segments);
+    m_enabled_segments_box = { Vec3{ FLT_MAX, FLT_MAX, FLT_MAX }, Vec3{ -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+    for (uint32_t id : m_enabled_segments) {
+        for (uint32_t v_id : { id, id + 1 }) {
+            const Vec3& position = m_vertices[v_id].position;
+            for (int j = 0; j < 3; ++j) {
+                m_enabled_segments_box[0][j] = std::min(m_enabled_segments_box[0][j], position[j]);
+                m_enabled_segments_box[1][j] = std::max(m_enabled_segments_box[1][j], position[j]);
+            }
+        }
+    }
+    m_update_lod = true;
 
     // update gpu buffer for enabled options
     assert(m_enabled_options_buf_id > 0);
@@ -1188,11 +1323,46 @@ void ViewerImpl::update_enabled_entities()
         glsafe(glBufferData(GL_TEXTURE_BUFFER, 0, nullptr, GL_STATIC_DRAW));
 
     glsafe(glBindBuffer(GL_TEXTURE_BUFFER, 0));
+    m_enabled_options = std::move(enabled_options);
 #endif // ENABLE_OPENGL_ES
 
     m_settings.update_enabled_entities = false;
 }
 
+Interval ViewerImpl::get_enabled_entities_range() const
+{
+    Interval range = m_view_range.get_visible();
+
+    // when top layer only visualization is enabled, we need to render
+    // all the toolpaths in the other layers as grayed, so extend the range
+    // to contain them
+    if (m_settings.top_layer_only_view_range)
+        range[0] = m_view_range.get_full()[0];
+
+    // to show the options at the current tool marker position we need to extend the range by one extra step
+    if (m_vertices[range[1]].is_option() && range[1] < m_vertices.size() - 1)
+        ++range[1];
+
+    if (m_settings.spiral_vase_mode) {
+        // when spiral vase mode is enabled and only one layer is shown, extend the range by one step
+        const Interval& layers_range = m_layers.get_view_range();
+        if (layers_range[0] > 0 && layers_range[0] == layers_range[1])
+            --range[0];
+    }
+
+    return range;
+}
+
+#if !defined(ENABLE_OPENGL_ES)
+std::pair<int, int> ViewerImpl::get_grayed_layers() const
+{
+    const bool color_top_layer_only = m_view_range.get_full()[1] != m_view_range.get_visible()[1];
+    const int top_layer_id = (m_settings.top_layer_only_view_range && color_top_layer_only) ? static_cast<int>(m_layers.get_view_range()[1]) : 0;
+    const int not_grayed_id = m_settings.spiral_vase_mode ? static_cast<int>(m_view_range.get_enabled()[0]) : -1;
+    return { top_layer_id, not_grayed_id };
+}
+#endif // ENABLE_OPENGL_ES
+
 static float encode_color(const Color& color) {
     const int r = static_cast<int>(color[0]);
     const int g = static_cast<int>(color[1]);
@@ -1209,6 +1379,7 @@ void ViewerImpl::update_colors_texture()
         return;
 #endif // ENABLE_OPENGL_ES
 
+#ifdef ENABLE_OPENGL_ES
     const size_t top_layer_id = m_settings.top_layer_only_view_range ? m_layers.get_view_range()[1] : 0;
     const bool color_top_layer_only = m_view_range.get_full()[1] != m_view_range.get_visible()[1];
 
@@ -1221,18 +1392,18 @@ void ViewerImpl::update_colors_texture()
                     (!m_settings.spiral_vase_mode || i != m_view_range.get_enabled()[0])) ?
                     encode_color(DUMMY_COLOR) : m_vertices_colors[i];
 
-    #ifdef ENABLE_OPENGL_ES
-        if (!colors.empty())
-            // update gpu buffer for colors
-            m_texture_data.set_colors(colors);
-    #else
-        m_colors_tex_size = colors.size() * sizeof(float);
-
+    if (!colors.empty())
         // update gpu buffer for colors
-        glsafe(glBindBuffer(GL_TEXTURE_BUFFER, m_colors_buf_id));
-        glsafe(glBufferData(GL_TEXTURE_BUFFER, colors.size() * sizeof(float), colors.data(), GL_STATIC_DRAW));
-        glsafe(glBindBuffer(GL_TEXTURE_BUFFER, 0));
-    #endif // ENABLE_OPENGL_ES
+        m_texture_data.set_colors(colors);
+#else
+    // the vertices to be rendered as dark grey are selected by the shaders, see get_grayed_layers()
+    m_colors_tex_size = m_vertices_colors.size() * sizeof(float);
+
+    // update gpu buffer for colors
+    glsafe(glBindBuffer(GL_TEXTURE_BUFFER, m_colors_buf_id));
+    glsafe(glBufferData(GL_TEXTURE_BUFFER, m_vertices_colors.size() * sizeof(float), m_vertices_colors.data(), GL_STATIC_DRAW));
+    glsafe(glBindBuffer(GL_TEXTURE_BUFFER, 0));
+#endif // ENABLE_OPENGL_ES
 }
 
 
@@ -1262,6 +1433,10 @@ void ViewerImpl::update_colors()
     
     update_colors_texture();
     m_settings.update_colors = false;
+#if !defined(ENABLE_OPENGL_ES)
+    // segments are merged only if they share the same color
+    m_update_lod = true;
+#endif // ENABLE_OPENGL_ES
 }
 
 void ViewerImpl::render(const Mat4x4& view_matrix, const Mat4x4& projection_matrix)
@@ -1277,6 +1452,15 @@ void ViewerImpl::render(const Mat4x4& view_matrix, const Mat4x4& projection_matr
 
     const Mat4x4 inv_view_matrix = inverse(view_matrix);
     const Vec3 camera_position = { inv_view_matrix[12], inv_view_matrix[13], inv_view_matrix[14] };
+
+#if !defined(ENABLE_OPENGL_ES)
+    const uint8_t lod_level = get_lod_level(projection_matrix, camera_position);
+    if (m_update_lod || lod_level != m_lod_level) {
+        m_lod_level = lod_level;
+        update_enabled_segments_lod();
+    }
+#endif // ENABLE_OPENGL_ES
+
     render_segments(view_matrix, projection_matrix, camera_position);
     render_options(view_matrix, projection_matrix);
 
@@ -1308,9 +1492,11 @@ void ViewerImpl::set_layers_view_range(Interval::value_type min, Interval::value
     // force immediate update of the full range
     update_view_full_range();
     m_view_range.set_visible(m_view_range.get_enabled());
+#ifdef ENABLE_OPENGL_ES
     m_settings.update_enabled_entities = true;
     //m_settings.update_colors = true;
     update_colors_texture();
+#endif // ENABLE_OPENGL_ES
 }
 
 void ViewerImpl::toggle_top_layer_only_view_range()
@@ -1318,9 +1504,11 @@ void ViewerImpl::toggle_top_layer_only_view_range()
     m_settings.top_layer_only_view_range = !m_settings.top_layer_only_view_range;
     update_view_full_range();
     m_view_range.set_visible(m_view_range.get_enabled());
+#ifdef ENABLE_OPENGL_ES
     m_settings.update_enabled_entities = true;
     //m_settings.update_colors = true;
     update_colors_texture();
+#endif // ENABLE_OPENGL_ES
 }
 
 std::vector<ETimeMode> ViewerImpl::get_time_modes() const
@@ -1417,7 +1605,9 @@ void ViewerImpl::toggle_extrusion_role_visibility(EGCodeExtrusionRole role)
 {
     m_settings.extrusion_roles_visibility[size_t(role)] = ! m_settings.extrusion_roles_visibility[size_t(role)];
     update_view_full_range();
+#ifdef ENABLE_OPENGL_ES
     m_settings.update_enabled_entities = true;
+#endif // ENABLE_OPENGL_ES
     m_settings.update_colors = true;
 }
 
@@ -1427,9 +1617,11 @@ void ViewerImpl::set_view_visible_range(Interval::value_type min, Interval::valu
     // when calling m_view_range.set_visible()
     update_view_full_range();
     m_view_range.set_visible(min, max);
+#ifdef ENABLE_OPENGL_ES
     update_enabled_entities();
     //m_settings.update_colors = true;
     update_colors_texture();
+#endif // ENABLE_OPENGL_ES
 }
 
 float ViewerImpl::get_estimated_time_at(size_t id) const
@@ -1597,6 +1789,14 @@ void ViewerImpl::set_travels_radius(float radius)
     update_heights_widths();
 }
 
+void ViewerImpl::set_segments_budget(size_t budget)
+{
+    m_segments_budget = budget;
+#if !defined(ENABLE_OPENGL_ES)
+    m_update_lod = true;
+#endif // ENABLE_OPENGL_ES
+}
+
 void ViewerImpl::set_wipes_radius(float radius)
 {
     m_wipes_radius = std::clamp(radius, MIN_WIPES_RADIUS_MM, MAX_WIPES_RADIUS_MM);
@@ -1626,6 +1826,11 @@ size_t ViewerImpl::get_used_cpu_memory() const
     }
     ret += STDVEC_MEMSIZE(m_tool_colors, Color);
     ret += STDVEC_MEMSIZE(m_color_print_colors, Color);
+#if !defined(ENABLE_OPENGL_ES)
+    ret += STDVEC_MEMSIZE(m_enabled_segments, uint32_t);
+    ret += STDVEC_MEMSIZE(m_rendered_segments, uint32_t);
+    ret += STDVEC_MEMSIZE(m_enabled_options, uint32_t);
+#endif // ENABLE_OPENGL_ES
     return ret;
 }
 
@@ -1817,18 +2022,20 @@ void ViewerImpl::update_heights_widths()
 
     glsafe(glBindBuffer(GL_TEXTURE_BUFFER, m_heights_widths_angles_buf_id));
 
-    Vec3* buffer = static_cast<Vec3*>(glMapBuffer(GL_TEXTURE_BUFFER, GL_WRITE_ONLY));
+    Half4* buffer = static_cast<Half4*>(glMapBuffer(GL_TEXTURE_BUFFER, GL_WRITE_ONLY));
     glcheck();
 
+    const uint16_t travels_radius = float_to_half(m_travels_radius);
+    const uint16_t wipes_radius   = float_to_half(m_wipes_radius);
     for (size_t i = 0; i < m_vertices.size(); ++i) {
         const PathVertex& v = m_vertices[i];
         if (v.is_travel()) {
-            buffer[i][0] = m_travels_radius;
-            buffer[i][1] = m_travels_radius;
+            buffer[i][0] = travels_radius;
+            buffer[i][1] = travels_radius;
         }
         else if (v.is_wipe()) {
-            buffer[i][0] = m_wipes_radius;
-            buffer[i][1] = m_wipes_radius;
+            buffer[i][0] = wipes_radius;
+            buffer[i][1] = wipes_radius;
         }
     }
 
@@ -1837,6 +2044,125 @@ void ViewerImpl::update_heights_widths()
 #endif // ENABLE_OPENGL_ES
 }
 
+#if !defined(ENABLE_OPENGL_ES)
+uint32_t ViewerImpl::get_segments_visibility_mask() const
+{
+    uint32_t mask = 0;
+    for (size_t i = 0; i < GCODE_EXTRUSION_ROLES_COUNT; ++i) {
+        if (m_settings.extrusion_roles_visibility[i])
+            mask |= 1u << i;
+    }
+    if (m_settings.options_visibility[size_t(EOptionType::Travels)])
+        mask |= 1u << SEGMENTS_VISIBILITY_TRAVELS_BIT;
+    if (m_settings.options_visibility[size_t(EOptionType::Wipes)])
+        mask |= 1u << SEGMENTS_VISIBILITY_WIPES_BIT;
+    return mask;
+}
+
+uint8_t ViewerImpl::get_lod_level(const Mat4x4& projection_matrix, const Vec3& camera_position) const
+{
+    if (m_enabled_segments.empty() || m_vertices.size() > LOD_MAX_VERTEX_ID)
+        return 0;
+
+    std::array<int, 4> viewport = { 0, 0, 0, 0 };
+    glsafe(glGetIntegerv(GL_VIEWPORT, viewport.data()));
+    if (viewport[3] <= 0 || projection_matrix[5] <= 0.0f)
+        return 0;
+
+    // size of a pixel, in mm, at the point of the enabled segments closest to the camera
+    float distance = 1.0f;
+    if (projection_matrix[15] == 0.0f) {
+        // perspective projection
+        Vec3 closest_point;
+        for (int i = 0; i < 3; ++i) {
+            closest_point[i] = std::clamp(camera_position[i], m_enabled_segments_box[0][i], m_enabled_segments_box[1][i]);
+        }
+        distance = length(camera_position - closest_point);
+    }
+    const float pixel_size = 2.0f * distance / (projection_matrix[5] * static_cast<float>(viewport[3]));
+    const float tolerance = LOD_PIXEL_TOLERANCE * pixel_size;
+    if (tolerance < LOD_MIN_TOLERANCE_MM)
+        return 0;
+
+    return static_cast<uint8_t>(std::min<int>(LOD_MAX_LEVEL, 1 + static_cast<int>(std::log2(tolerance / LOD_MIN_TOLERANCE_MM))));
+}
+
+void ViewerImpl::build_lod_segments(float tolerance, std::vector<uint32_t>& segments) const
+{
+    segments.clear();
+    segments.reserve(m_enabled_segments.size());
+
+    const float sqr_tolerance = tolerance * tolerance;
+    const size_t count = m_enabled_segments.size();
+    size_t i = 0;
+    while (i < count) {
+        const uint32_t id_a = m_enabled_segments[i];
+        const PathVertex& v_a = m_vertices[id_a];
+        // infill is the least noticeable feature when zoomed out, decimate it more aggressively
+        const float sqr_segment_tolerance = (v_a.role == EGCodeExtrusionRole::InternalInfill) ? 4.0f * sqr_tolerance : sqr_tolerance;
+        uint32_t span = 1;
+        while (span < LOD_MAX_SPAN && i + span < count && m_enabled_segments[i + span] == id_a + span) {
+            const uint32_t id_mid = id_a + span;
+            const uint32_t id_b = id_mid + 1;
+            const PathVertex& v_b = m_vertices[id_b];
+            if (v_b.type != v_a.type || v_b.role != v_a.role || v_b.layer_id != v_a.layer_id ||
+                v_b.height != v_a.height || v_b.width != v_a.width || m_vertices_colors[id_b] != m_vertices_colors[id_a] ||
+                m_vertices_colors[id_mid] != m_vertices_colors[id_a])
+                break;
+            bool within_tolerance = true;
+            for (uint32_t j = id_a + 1; j < id_b; ++j) {
+                if (sqr_distance_to_segment(m_vertices[j].position, v_a.position, v_b.position) > sqr_segment_tolerance) {
+                    within_tolerance = false;
+                    break;
+                }
+            }
+            if (!within_tolerance)
+                break;
+            ++span;
+        }
+        segments.push_back(id_a | ((span - 1) << LOD_SPAN_SHIFT));
+        i += span;
+    }
+}
+
+void ViewerImpl::update_enabled_segments_lod()
+{
+    std::vector<uint32_t> lod_segments;
+    const std::vector<uint32_t>* segments = &m_enabled_segments;
+    if (m_vertices.size() <= LOD_MAX_VERTEX_ID) {
+        uint8_t level = m_lod_level;
+        // when over budget, raise the level of detail until the segments fit into it
+        if (level == 0 && m_segments_budget > 0 && m_enabled_segments.size() > m_segments_budget)
+            level = 1;
+        while (level > 0) {
+            build_lod_segments(lod_level_tolerance(level), lod_segments);
+            segments = &lod_segments;
+            if (m_segments_budget == 0 || lod_segments.size() <= m_segments_budget || level == LOD_MAX_LEVEL)
+                break;
+            ++level;
+        }
+    }
+
+    m_enabled_segments_tex_size = segments->size() * sizeof(uint32_t);
+
+    // update gpu buffer for enabled segments
+    assert(m_enabled_segments_buf_id > 0);
+    glsafe(glBindBuffer(GL_TEXTURE_BUFFER, m_enabled_segments_buf_id));
+    if (!segments->empty())
+        glsafe(glBufferData(GL_TEXTURE_BUFFER, segments->size() * sizeof(uint32_t), segments->data(), GL_STATIC_DRAW));
+    else
+        glsafe(glBufferData(GL_TEXTURE_BUFFER, 0, nullptr, GL_STATIC_DRAW));
+    glsafe(glBindBuffer(GL_TEXTURE_BUFFER, 0));
+
+    // keep a copy to select the segments in the visible range, see render_segments()
+    if (segments == &lod_segments)
+        m_rendered_segments = std::move(lod_segments);
+    else
+        m_rendered_segments = m_enabled_segments;
+    m_update_lod = false;
+}
+#endif // ENABLE_OPENGL_ES
+
 void ViewerImpl::render_segments(const Mat4x4& view_matrix, const Mat4x4& projection_matrix, const Vec3& camera_position)
 {
     if (m_segments_shader_id == 0)
@@ -1844,10 +2170,19 @@ void ViewerImpl::render_segments(const Mat4x4& view_matrix, const Mat4x4& projec
 
 #ifdef ENABLE_OPENGL_ES
     if (m_texture_data.get_enabled_segments_count() == 0)
+        return;
 #else
-    if (m_enabled_segments_count == 0)
-#endif // ENABLE_OPENGL_ES
+    // the rendered segments are sorted, select the ones intersecting the visible range,
+    // the shader clips the merged segments crossing its boundaries
+    const Interval range = get_enabled_entities_range();
+    const auto segments_begin = std::partition_point(m_rendered_segments.begin(), m_rendered_segments.end(),
+        [&range](uint32_t segment) { return lod_segment_end(segment) <= range[0]; });
+    const auto segments_end = std::partition_point(segments_begin, m_rendered_segments.end(),
+        [&range](uint32_t segment) { return lod_segment_begin(segment) < range[1]; });
+    if (segments_begin == segments_end)
         return;
+    const auto [top_layer_id, not_grayed_id] = get_grayed_layers();
+#endif // ENABLE_OPENGL_ES
 
     int curr_active_texture = 0;
     glsafe(glGetIntegerv(GL_ACTIVE_TEXTURE, &curr_active_texture));
@@ -1865,6 +2200,14 @@ void ViewerImpl::render_segments(const Mat4x4& view_matrix, const Mat4x4& projec
     glsafe(glUniformMatrix4fv(m_uni_segments_view_matrix_id, 1, GL_FALSE, view_matrix.data()));
     glsafe(glUniformMatrix4fv(m_uni_segments_projection_matrix_id, 1, GL_FALSE, projection_matrix.data()));
     glsafe(glUniform3fv(m_uni_segments_camera_position_id, 1, camera_position.data()));
+#if !defined(ENABLE_OPENGL_ES)
+    glsafe(glUniform1i(m_uni_segments_segment_index_offset_id, static_cast<int>(std::distance(m_rendered_segments.begin(), segments_begin))));
+    glsafe(glUniform2i(m_uni_segments_view_range_id, static_cast<int>(range[0]), static_cast<int>(range[1])));
+    glsafe(glUniform1ui(m_uni_segments_visibility_mask_id, get_segments_visibility_mask()));
+    glsafe(glUniform1i(m_uni_segments_top_layer_id, top_layer_id));
+    glsafe(glUniform1i(m_uni_segments_not_grayed_id, not_grayed_id));
+    glsafe(glUniform3f(m_uni_segments_grayed_color_id, DUMMY_COLOR[0] / 255.0f, DUMMY_COLOR[1] / 255.0f, DUMMY_COLOR[2] / 255.0f));
+#endif // ENABLE_OPENGL_ES
 
     glsafe(glDisable(GL_CULL_FACE));
 
@@ -1899,7 +2242,7 @@ void ViewerImpl::render_segments(const Mat4x4& view_matrix, const Mat4x4& projec
     glsafe(glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_positions_buf_id));
     glsafe(glActiveTexture(GL_TEXTURE1));
     glsafe(glBindTexture(GL_TEXTURE_BUFFER, m_heights_widths_angles_tex_id));
-    glsafe(glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_heights_widths_angles_buf_id));
+    glsafe(glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA16F, m_heights_widths_angles_buf_id));
     glsafe(glActiveTexture(GL_TEXTURE2));
     glsafe(glBindTexture(GL_TEXTURE_BUFFER, m_colors_tex_id));
     glsafe(glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, m_colors_buf_id));
@@ -1907,7 +2250,7 @@ void ViewerImpl::render_segments(const Mat4x4& view_matrix, const Mat4x4& projec
     glsafe(glBindTexture(GL_TEXTURE_BUFFER, m_enabled_segments_tex_id));
     glsafe(glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, m_enabled_segments_buf_id));
 
-    m_segment_template.render(m_enabled_segments_count);
+    m_segment_template.render(static_cast<size_t>(std::distance(segments_begin, segments_end)));
 #endif // ENABLE_OPENGL_ES
 
     if (curr_cull_face)
@@ -1932,10 +2275,15 @@ void ViewerImpl::render_options(const Mat4x4& view_matrix, const Mat4x4& project
 
 #ifdef ENABLE_OPENGL_ES
     if (m_texture_data.get_enabled_options_count() == 0)
+        return;
 #else
-    if (m_enabled_options_count == 0)
-#endif // ENABLE_OPENGL_ES
+    const Interval range = get_enabled_entities_range();
+    const auto options_begin = std::lower_bound(m_enabled_options.begin(), m_enabled_options.end(), range[0]);
+    const auto options_end = std::lower_bound(options_begin, m_enabled_options.end(), range[1]);
+    if (options_begin == options_end)
         return;
+    const auto [top_layer_id, not_grayed_id] = get_grayed_layers();
+#endif // ENABLE_OPENGL_ES
 
     int curr_active_texture = 0;
     glsafe(glGetIntegerv(GL_ACTIVE_TEXTURE, &curr_active_texture));
@@ -1952,6 +2300,12 @@ void ViewerImpl::render_options(const Mat4x4& view_matrix, const Mat4x4& project
     glsafe(glUniform1i(m_uni_options_segment_index_tex_id, 3));
     glsafe(glUniformMatrix4fv(m_uni_options_view_matrix_id, 1, GL_FALSE, view_matrix.data()));
     glsafe(glUniformMatrix4fv(m_uni_options_projection_matrix_id, 1, GL_FALSE, projection_matrix.data()));
+#if !defined(ENABLE_OPENGL_ES)
+    glsafe(glUniform1i(m_uni_options_segment_index_offset_id, static_cast<int>(std::distance(m_enabled_options.begin(), options_begin))));
+    glsafe(glUniform1i(m_uni_options_top_layer_id, top_layer_id));
+    glsafe(glUniform1i(m_uni_options_not_grayed_id, not_grayed_id));
+    glsafe(glUniform3f(m_uni_options_grayed_color_id, DUMMY_COLOR[0] / 255.0f, DUMMY_COLOR[1] / 255.0f, DUMMY_COLOR[2] / 255.0f));
+#endif // ENABLE_OPENGL_ES
 
     glsafe(glEnable(GL_CULL_FACE));
 
@@ -1986,7 +2340,7 @@ void ViewerImpl::render_options(const Mat4x4& view_matrix, const Mat4x4& project
     glsafe(glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_positions_buf_id));
     glsafe(glActiveTexture(GL_TEXTURE1));
     glsafe(glBindTexture(GL_TEXTURE_BUFFER, m_heights_widths_angles_tex_id));
-    glsafe(glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_heights_widths_angles_buf_id));
+    glsafe(glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA16F, m_heights_widths_angles_buf_id));
     glsafe(glActiveTexture(GL_TEXTURE2));
     glsafe(glBindTexture(GL_TEXTURE_BUFFER, m_colors_tex_id));
     glsafe(glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, m_colors_buf_id));
@@ -1994,7 +2348,7 @@ void ViewerImpl::render_options(const Mat4x4& view_matrix, const Mat4x4& project
     glsafe(glBindTexture(GL_TEXTURE_BUFFER, m_enabled_options_tex_id));
     glsafe(glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, m_enabled_options_buf_id));
 
-    m_option_template.render(m_enabled_options_count);
+    m_option_template.render(static_cast<size_t>(std::distance(options_begin, options_end)));
 #endif // ENABLE_OPENGL_ES
 
     if (!curr_cull_face)
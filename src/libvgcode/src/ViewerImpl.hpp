@@ -167,6 +167,9 @@ public:
     float get_wipes_radius() const { return m_wipes_radius; }
     void set_wipes_radius(float radius);
 
+    size_t get_segments_budget() const { return m_segments_budget; }
+    void set_segments_budget(size_t budget);
+
     size_t get_used_cpu_memory() const;
     size_t get_used_gpu_memory() const;
 
@@ -233,6 +236,10 @@ private:
     //
     float m_wipes_radius{ DEFAULT_WIPES_RADIUS_MM };
     //
+    // Max count of segments to render, 0 if unlimited
+    //
+    size_t m_segments_budget{ 0 };
+    //
     // Palette used to render extrusion roles
     //
     std::array<Color, size_t(EGCodeExtrusionRole::COUNT)> m_extrusion_roles_colors;
@@ -311,6 +318,14 @@ private:
     int m_uni_segments_height_width_angle_tex_id{ -1 };
     int m_uni_segments_colors_tex_id{ -1 };
     int m_uni_segments_segment_index_tex_id{ -1 };
+#if !defined(ENABLE_OPENGL_ES)
+    int m_uni_segments_segment_index_offset_id{ -1 };
+    int m_uni_segments_view_range_id{ -1 };
+    int m_uni_segments_visibility_mask_id{ -1 };
+    int m_uni_segments_top_layer_id{ -1 };
+    int m_uni_segments_not_grayed_id{ -1 };
+    int m_uni_segments_grayed_color_id{ -1 };
+#endif // ENABLE_OPENGL_ES
     //
     // Caches for OpenGL uniforms id for options shader 
     //
@@ -320,6 +335,12 @@ private:
     int m_uni_options_height_width_angle_tex_id{ -1 };
     int m_uni_options_colors_tex_id{ -1 };
     int m_uni_options_segment_index_tex_id{ -1 };
+#if !defined(ENABLE_OPENGL_ES)
+    int m_uni_options_segment_index_offset_id{ -1 };
+    int m_uni_options_top_layer_id{ -1 };
+    int m_uni_options_not_grayed_id{ -1 };
+    int m_uni_options_grayed_color_id{ -1 };
+#endif // ENABLE_OPENGL_ES
 #if VGCODE_ENABLE_COG_AND_TOOL_MARKERS
     //
     // Caches for OpenGL uniforms id for cog marker shader 
@@ -433,13 +454,22 @@ private:
     //
     unsigned int m_enabled_segments_buf_id{ 0 };
     unsigned int m_enabled_segments_tex_id{ 0 };
-    size_t m_enabled_segments_count{ 0 };
+    //
+    // Full detail list of enabled segments and its bounding box.
+    // The list sent to gpu is generated from it for the current level of detail, a copy is kept
+    // to select the segments in the visible range
+    //
+    std::vector<uint32_t> m_enabled_segments;
+    std::vector<uint32_t> m_rendered_segments;
+    AABox m_enabled_segments_box;
+    uint8_t m_lod_level{ 0 };
+    bool m_update_lod{ false };
     //
     // OpenGL buffers to store enabled options
     //
     unsigned int m_enabled_options_buf_id{ 0 };
     unsigned int m_enabled_options_tex_id{ 0 };
-    size_t m_enabled_options_count{ 0 };
+    std::vector<uint32_t> m_enabled_options;
     //
     // Caches for size of data sent to gpu, in bytes
     //
@@ -453,6 +483,21 @@ private:
     void update_view_full_range();
     void update_color_ranges();
     void update_heights_widths();
+    //
+    // Return the range of vertices whose segments and options are rendered
+    //
+    Interval get_enabled_entities_range() const;
+#if !defined(ENABLE_OPENGL_ES)
+    //
+    // Return the id of the top layer, the toolpaths below it are rendered as grayed, and the id of the vertex
+    // excluded from graying, -1 if none
+    //
+    std::pair<int, int> get_grayed_layers() const;
+    uint32_t get_segments_visibility_mask() const;
+    uint8_t get_lod_level(const Mat4x4& projection_matrix, const Vec3& camera_position) const;
+    void build_lod_segments(float tolerance, std::vector<uint32_t>& segments) const;
+    void update_enabled_segments_lod();
+#endif // ENABLE_OPENGL_ES
     void render_segments(const Mat4x4& view_matrix, const Mat4x4& projection_matrix, const Vec3& camera_position);
     void render_options(const Mat4x4& view_matrix, const Mat4x4& projection_matrix);
 #if VGCODE_ENABLE_COG_AND_TOOL_MARKERS
@@ -21,12 +21,10 @@
 #include "BRepBuilderAPI_Transform.hxx"
 #include "TopExp_Explorer.hxx"
 #include "BRep_Tool.hxx"
+#include "OSD_Parallel.hxx"
 #include "admesh/stl.h"
 #include "libslic3r/Point.hpp"
 
-const double STEP_TRANS_CHORD_ERROR = 0.005;
-const double STEP_TRANS_ANGLE_RES = 1;
-
 // const int LOAD_STEP_STAGE_READ_FILE          = 0;
 // const int LOAD_STEP_STAGE_GET_SOLID          = 1;
 // const int LOAD_STEP_STAGE_GET_MESH           = 2;
@@ -79,7 +77,57 @@ static void getNamedSolids(const TopLoc_Location& location, const Handle(XCAFDoc
     }
 }
 
-extern "C" OCCTWRAPPER_EXPORT bool load_step_internal(const char *path, OCCTResult* res /*BBS:, ImportStepProgressFn proFn*/)
+// Tessellate a single solid and convert its triangulation to facets. Returns false if the solid produced no triangles.
+static bool mesh_solid(const NamedSolid &namedSolid, double linear_deflection, double angular_deflection, OCCTVolume &volume)
+{
+    // The faces of the solid are meshed in parallel by OCCT, while the solids are meshed concurrently by the caller.
+    BRepMesh_IncrementalMesh mesh(namedSolid.solid, linear_deflection, false, angular_deflection, true);
+
+    std::vector<Vec3f>      vertices;
+    std::vector<stl_facet> &facets = volume.facets;
+    for (TopExp_Explorer anExpSF(namedSolid.solid, TopAbs_FACE); anExpSF.More(); anExpSF.Next()) {
+        const int aNodeOffset = int(vertices.size());
+        const TopoDS_Shape& aFace = anExpSF.Current();
+        TopLoc_Location aLoc;
+        Handle(Poly_Triangulation) aTriangulation = BRep_Tool::Triangulation(TopoDS::Face(aFace), aLoc);
+        if (aTriangulation.IsNull())
+            continue;
+
+        // First copy vertices (will create duplicates).
+        gp_Trsf aTrsf = aLoc.Transformation();
+        for (Standard_Integer aNodeIter = 1; aNodeIter <= aTriangulation->NbNodes(); ++aNodeIter) {
+            gp_Pnt aPnt = aTriangulation->Node(aNodeIter);
+            aPnt.Transform(aTrsf);
+            vertices.emplace_back(std::move(Vec3f(float(aPnt.X()), float(aPnt.Y()), float(aPnt.Z()))));
+        }
+
+        // Now copy the facets.
+        const TopAbs_Orientation anOrientation = anExpSF.Current().Orientation();
+        for (Standard_Integer aTriIter = 1; aTriIter <= aTriangulation->NbTriangles(); ++aTriIter) {
+            Poly_Triangle aTri = aTriangulation->Triangle(aTriIter);
+
+            Standard_Integer anId[3];
+            aTri.Get(anId[0], anId[1], anId[2]);
+            if (anOrientation == TopAbs_REVERSED) {
+                std::swap(anId[1], anId[2]);
+            }
+
+            stl_facet facet;
+            facet.vertex[0] = vertices[anId[0] + aNodeOffset - 1];
+            facet.vertex[1] = vertices[anId[1] + aNodeOffset - 1];
+            facet.vertex[2] = vertices[anId[2] + aNodeOffset - 1];
+            facet.normal    = (facet.vertex[1] - facet.vertex[0]).cross(facet.vertex[2] - facet.vertex[1]).normalized();
+            facet.extra[0]  = 0;
+            facet.extra[1]  = 0;
+            facets.emplace_back(std::move(facet));
+        }
+    }
+
+    volume.volume_name = namedSolid.name;
+    return ! vertices.empty();
+}
+
+extern "C" OCCTWRAPPER_EXPORT bool load_step_internal(const char *path, OCCTResult* res, double linear_deflection, double angular_deflection /*BBS:, ImportStepProgressFn proFn*/)
 {
 try {
     //bool cb_cancel = false;
@@ -128,55 +176,28 @@ try {
     std::string obj_name((last_slash == nullptr) ? path : last_slash + 1);
     res->object_name = obj_name;
 
-    for (const NamedSolid &namedSolid : namedSolids) {
-        BRepMesh_IncrementalMesh mesh(namedSolid.solid, STEP_TRANS_CHORD_ERROR, false, STEP_TRANS_ANGLE_RES, true);
-        res->volumes.emplace_back();
-
-        std::vector<Vec3f>      vertices;
-        std::vector<stl_facet> &facets = res->volumes.back().facets;
-        for (TopExp_Explorer anExpSF(namedSolid.solid, TopAbs_FACE); anExpSF.More(); anExpSF.Next()) {
-            const int aNodeOffset = int(vertices.size());
-            const TopoDS_Shape& aFace = anExpSF.Current();
-            TopLoc_Location aLoc;
-            Handle(Poly_Triangulation) aTriangulation = BRep_Tool::Triangulation(TopoDS::Face(aFace), aLoc);
-            if (aTriangulation.IsNull())
-                continue;
-
-            // First copy vertices (will create duplicates).
-            gp_Trsf aTrsf = aLoc.Transformation();
-            for (Standard_Integer aNodeIter = 1; aNodeIter <= aTriangulation->NbNodes(); ++aNodeIter) {
-                gp_Pnt aPnt = aTriangulation->Node(aNodeIter);
-                aPnt.Transform(aTrsf);
-                vertices.emplace_back(std::move(Vec3f(float(aPnt.X()), float(aPnt.Y()), float(aPnt.Z()))));
-            }
-
-            // Now copy the facets.
-            const TopAbs_Orientation anOrientation = anExpSF.Current().Orientation();
-            for (Standard_Integer aTriIter = 1; aTriIter <= aTriangulation->NbTriangles(); ++aTriIter) {
-                const int aTriangleOffet = int(facets.size());
-                Poly_Triangle aTri = aTriangulation->Triangle(aTriIter);
-
-                Standard_Integer anId[3];
-                aTri.Get(anId[0], anId[1], anId[2]);
-                if (anOrientation == TopAbs_REVERSED) {
-                    std::swap(anId[1], anId[2]);
-                }
-
-                stl_facet facet;
-                facet.vertex[0] = vertices[anId[0] + aNodeOffset - 1];
-                facet.vertex[1] = vertices[anId[1] + aNodeOffset - 1];
-                facet.vertex[2] = vertices[anId[2] + aNodeOffset - 1];
-                facet.normal    = (facet.vertex[1] - facet.vertex[0]).cross(facet.vertex[2] - facet.vertex[1]).normalized();
-                facet.extra[0]  = 0;
-                facet.extra[1]  = 0;
-                facets.emplace_back(std::move(facet));
-            }
+    // The solids do not share any topology, they were copied by BRepBuilderAPI_Transform, thus they may be meshed concurrently.
+    std::vector<OCCTVolume>  volumes(namedSolids.size());
+    std::vector<char>        volumes_valid(namedSolids.size(), false);
+    std::vector<std::string> errors(namedSolids.size());
+    OSD_Parallel::For(0, int(namedSolids.size()), [&](int i) {
+        try {
+            volumes_valid[i] = mesh_solid(namedSolids[i], linear_deflection, angular_deflection, volumes[i]);
+        } catch (const std::exception &ex) {
+            errors[i] = ex.what();
+        } catch (...) {
+            errors[i] = "An exception was thrown while meshing solid " + std::to_string(i + 1) + ".";
         }
-
-        res->volumes.back().volume_name = namedSolid.name;
-
-        if (vertices.empty())
-            res->volumes.pop_back();        
+    });
+    for (size_t i = 0; i < namedSolids.size(); ++ i) {
+        if (! errors[i].empty()) {
+            shapeTool.reset(nullptr);
+            application->Close(document);
+            res->error_str = errors[i];
+            return false;
+        }
+        if (volumes_valid[i])
+            res->volumes.emplace_back(std::move(volumes[i]));
     }
 
     shapeTool.reset(nullptr);
@@ -21,7 +21,9 @@ struct OCCTResult {
     std::vector<OCCTVolume> volumes;
 };
 
-using LoadStepFn = bool (*)(const char *path, OCCTResult* occt_result);
+// Solids are tessellated with the given linear deflection (maximum distance of the mesh from the surface, in mm)
+// and angular deflection (in radians).
+using LoadStepFn = bool (*)(const char *path, OCCTResult* occt_result, double linear_deflection, double angular_deflection);
 
 }; // namespace Slic3r
 
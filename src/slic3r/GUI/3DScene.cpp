@@ -34,11 +34,13 @@
 #include "libslic3r/ClipperUtils.hpp"
 #include "libslic3r/Tesselate.hpp"
 #include "libslic3r/PrintConfig.hpp"
+#include "libslic3r/QuadricEdgeCollapse.hpp"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <thread>
 
 #include <boost/log/trivial.hpp>
 
@@ -422,6 +424,75 @@ void GLVolume::render()
         glsafe(::glFrontFace(GL_CCW));
 }
 
+// Meshes with less triangles are rendered fast enough without the render proxies.
+static constexpr const size_t LOD_MIN_TRIANGLES_COUNT = 500000;
+// Fractions of the triangles of the full mesh kept by the render proxies, from the finest to the coarsest.
+static constexpr const std::array<float, 2> LOD_TRIANGLES_RATIOS = { 0.25f, 0.05f };
+// A render proxy is used as long as it has at least this many triangles per pixel of the screen area covered by the volume.
+static constexpr const double LOD_TRIANGLES_PER_PIXEL = 0.5;
+
+void GLVolume::generate_lods(std::shared_ptr<const TriangleMesh> mesh)
+{
+    m_lods.reset();
+    if (mesh == nullptr || mesh->its.indices.size() < LOD_MIN_TRIANGLES_COUNT)
+        return;
+
+    m_lods = std::make_shared<LODs>();
+    std::thread([mesh = std::move(mesh), lods_weak = std::weak_ptr<LODs>(m_lods)]() {
+        struct Canceled {};
+        auto throw_on_cancel = [&lods_weak]() { if (lods_weak.expired()) throw Canceled(); };
+        try {
+            // Each proxy is decimated from the finer one.
+            std::array<indexed_triangle_set, LOD_TRIANGLES_RATIOS.size()> proxies;
+            const indexed_triangle_set *source = &mesh->its;
+            for (size_t i = 0; i < proxies.size(); ++i) {
+                proxies[i] = *source;
+                its_quadric_edge_collapse_partitioned(proxies[i], uint32_t(LOD_TRIANGLES_RATIOS[i] * mesh->its.indices.size()), nullptr, throw_on_cancel);
+                source = &proxies[i];
+            }
+            if (std::shared_ptr<LODs> lods = lods_weak.lock()) {
+                // GLModel::init_from() only fills in the geometry, it is sent to gpu by the first render call from the UI thread.
+                for (size_t i = 0; i < proxies.size(); ++i)
+                    lods->models[i].init_from(proxies[i]);
+                lods->ready.store(true, std::memory_order_release);
+            }
+        } catch (const Canceled&) {
+        } catch (const std::exception &ex) {
+            BOOST_LOG_TRIVIAL(error) << "Generation of the render proxies failed: " << ex.what();
+        }
+    }).detach();
+}
+
+void GLVolume::render(double screen_size)
+{
+    GUI::GLModel *proxy = nullptr;
+    if (m_lods != nullptr && m_lods->ready.load(std::memory_order_acquire) && tverts_range == std::make_pair<size_t, size_t>(0, -1)) {
+        // The coarsest proxy detailed enough for the covered screen area.
+        const double min_triangles_count = LOD_TRIANGLES_PER_PIXEL * sqr(screen_size);
+        for (auto it = m_lods->models.rbegin(); it != m_lods->models.rend() && proxy == nullptr; ++it)
+            if (double(it->indices_count() / 3) >= min_triangles_count)
+                proxy = &(*it);
+    }
+    if (proxy == nullptr) {
+        render();
+        return;
+    }
+
+    if (!is_active || GUI::wxGetApp().get_current_shader() == nullptr)
+        return;
+
+    const bool is_left_handed = this->is_left_handed();
+    if (is_left_handed)
+        glsafe(::glFrontFace(GL_CW));
+    glsafe(::glCullFace(GL_BACK));
+
+    proxy->set_color(model.get_color());
+    proxy->render();
+
+    if (is_left_handed)
+        glsafe(::glFrontFace(GL_CCW));
+}
+
 bool GLVolume::is_sla_support() const { return this->composite_id.volume_id == -int(slaposSupportTree); }
 bool GLVolume::is_sla_pad() const { return this->composite_id.volume_id == -int(slaposPad); }
 
@@ -484,6 +555,7 @@ int GLVolumeCollection::load_object_volume(
     if (m_use_raycasters)
       v.mesh_raycaster = std::make_unique<GUI::MeshRaycaster>(mesh);
 #endif // ENABLE_SMOOTH_NORMALS
+    v.generate_lods(mesh);
     v.composite_id = GLVolume::CompositeID(obj_idx, volume_idx, instance_idx);
     if (model_volume->is_model_part()) {
         // GLVolume will reference a convex hull from model_volume!
@@ -743,10 +815,38 @@ GLVolumeWithIdAndZList volumes_to_render(const GLVolumePtrs& volumes, GLVolumeCo
     return list;
 }
 
+// Returns true if the box is completely outside of one of the six clipping planes of the view frustum.
+// The planes are extracted from the rows of the combined projection * view matrix (Gribb / Hartmann).
+static bool is_outside_frustum(const BoundingBoxf3& box, const Matrix4d& view_projection)
+{
+    if (!box.defined)
+        return false;
+
+    for (int i = 0; i < 3; ++i) {
+        for (double sign : { -1.0, 1.0 }) {
+            const Vec4d plane = view_projection.row(3).transpose() + sign * view_projection.row(i).transpose();
+            // Corner of the box furthest along the plane normal.
+            const Vec3d corner(plane.x() >= 0.0 ? box.max.x() : box.min.x(),
+                               plane.y() >= 0.0 ? box.max.y() : box.min.y(),
+                               plane.z() >= 0.0 ? box.max.z() : box.min.z());
+            if (plane.head<3>().dot(corner) + plane.w() < 0.0)
+                return true;
+        }
+    }
+    return false;
+}
+
 void GLVolumeCollection::render(GLVolumeCollection::ERenderType type, bool disable_cullface, const Transform3d& view_matrix, const Transform3d& projection_matrix,
     std::function<bool(const GLVolume&)> filter_func) const
 {
     GLVolumeWithIdAndZList to_render = volumes_to_render(volumes, type, view_matrix, filter_func);
+
+    // Skip the volumes not intersecting the view frustum, their draw calls would be clipped entirely.
+    const Matrix4d view_projection = (projection_matrix * view_matrix).matrix();
+    to_render.erase(std::remove_if(to_render.begin(), to_render.end(),
+        [&view_projection](const GLVolumeWithIdAndZ& volume) { return is_outside_frustum(volume.first->transformed_bounding_box(), view_projection); }),
+        to_render.end());
+
     if (to_render.empty())
         return;
 
@@ -793,6 +893,64 @@ void GLVolumeCollection::render(GLVolumeCollection::ERenderType type, bool disab
 
 
 
+    // All the volumes are rendered by a handful of shaders. With many instances on the bed (Fill Bed), switching the shader
+    // and setting up the uniforms shared by all volumes for each volume dominates the frame time. The shaders are thus
+    // switched only if the next volume needs a different one, and the uniforms shared by all volumes are set only once
+    // when a shader is activated.
+#if ENABLE_ENVIRONMENT_MAP
+    const unsigned int environment_texture_id  = GUI::wxGetApp().plater()->get_environment_texture_id();
+    const bool         use_environment_texture = environment_texture_id > 0 && GUI::wxGetApp().app_config->get_bool("use_environment_map");
+#endif // ENABLE_ENVIRONMENT_MAP
+    // Diameter of the bounding box of a volume on screen in pixels, used to select its render proxy.
+    const double viewport_height = double(GUI::wxGetApp().plater()->get_camera().get_viewport()[3]);
+    auto screen_size = [&view_projection, &projection_matrix, viewport_height](const BoundingBoxf3& box) {
+        const Vec3d  center = box.center();
+        const double w      = view_projection.row(3).dot(Vec4d(center.x(), center.y(), center.z(), 1.0));
+        // The camera is inside of the box, full detail is needed.
+        return w > EPSILON ? 0.5 * viewport_height * box.size().norm() * projection_matrix.matrix()(1, 1) / w : std::numeric_limits<double>::max();
+    };
+
+    GLShaderProgram* active_shader = nullptr;
+    auto use_shader = [&](GLShaderProgram* new_shader) {
+        if (active_shader == new_shader)
+            return;
+        if (active_shader != nullptr) {
+#if ENABLE_ENVIRONMENT_MAP
+            if (active_shader == curr_shader && use_environment_texture)
+                glsafe(::glBindTexture(GL_TEXTURE_2D, 0));
+#endif // ENABLE_ENVIRONMENT_MAP
+            active_shader->stop_using();
+        }
+        active_shader = new_shader;
+        if (active_shader == nullptr)
+            return;
+        active_shader->start_using();
+        if (active_shader == mmu_painted_shader) {
+            const std::array<float, 4> clp_data = { 0.0f, 0.0f, 1.0f, FLT_MAX };
+            const std::array<float, 2> z_range = { -FLT_MAX, FLT_MAX };
+            active_shader->set_uniform("clipping_plane", clp_data);
+            active_shader->set_uniform("z_range", z_range);
+            active_shader->set_uniform("projection_matrix", projection_matrix);
+        } else if (active_shader == curr_shader) {
+            active_shader->set_uniform("z_range", m_z_range);
+            active_shader->set_uniform("clipping_plane", m_clipping_plane);
+            active_shader->set_uniform("use_color_clip_plane", m_use_color_clip_plane);
+            active_shader->set_uniform("color_clip_plane", m_color_clip_plane);
+            active_shader->set_uniform("uniform_color_clip_plane_1", m_color_clip_plane_colors[0]);
+            active_shader->set_uniform("uniform_color_clip_plane_2", m_color_clip_plane_colors[1]);
+            active_shader->set_uniform("print_volume.type", static_cast<int>(m_print_volume.type));
+            active_shader->set_uniform("print_volume.xy_data", m_print_volume.data);
+            active_shader->set_uniform("print_volume.z_data", m_print_volume.zs);
+            active_shader->set_uniform("slope.normal_z", m_slope.normal_z);
+            active_shader->set_uniform("projection_matrix", projection_matrix);
+#if ENABLE_ENVIRONMENT_MAP
+            active_shader->set_uniform("use_environment_tex", use_environment_texture);
+            if (use_environment_texture)
+                glsafe(::glBindTexture(GL_TEXTURE_2D, environment_texture_id));
+#endif // ENABLE_ENVIRONMENT_MAP
+        }
+    };
+
     for (GLVolumeWithIdAndZ& volume : to_render) {
         if (!volume.first->is_active)
             continue;
@@ -809,34 +967,21 @@ void GLVolumeCollection::render(GLVolumeCollection::ERenderType type, bool disab
         volume.first->set_render_color(true);
 
         // render sinking contours of non-hovered volumes
-        if (sink_shader != nullptr) {
-            sink_shader->start_using();
-            if (m_show_sinking_contours) {
-                if (volume.first->is_sinking() && !volume.first->is_below_printbed() &&
-                    volume.first->hover == GLVolume::HS_None && !volume.first->force_sinking_contours) {
-                    volume.first->render_sinking_contours();
-                }
+        if (sink_shader != nullptr && m_show_sinking_contours) {
+            if (volume.first->is_sinking() && !volume.first->is_below_printbed() &&
+                volume.first->hover == GLVolume::HS_None && !volume.first->force_sinking_contours) {
+                use_shader(sink_shader);
+                volume.first->render_sinking_contours();
             }
-            sink_shader->stop_using();
         }
 
-        if (render_as_mmu_painted && shader != mmu_painted_shader)
-            shader = mmu_painted_shader;
-        else if (!render_as_mmu_painted && shader != curr_shader)
-            shader = curr_shader;
-
         if (render_as_mmu_painted) {
-            shader->start_using();
-            const std::array<float, 4> clp_data = { 0.0f, 0.0f, 1.0f, FLT_MAX };
-            const std::array<float, 2> z_range = { -FLT_MAX, FLT_MAX };
+            use_shader(mmu_painted_shader);
             const bool is_left_handed = volume.first->is_left_handed();
-            shader->set_uniform("volume_world_matrix", world_matrix);
-            shader->set_uniform("volume_mirrored", is_left_handed);
-            shader->set_uniform("clipping_plane", clp_data);
-            shader->set_uniform("z_range", z_range);
-            shader->set_uniform("view_model_matrix", view_matrix * world_matrix);
-            shader->set_uniform("projection_matrix", projection_matrix);
-            shader->set_uniform("view_normal_matrix", view_normal_matrix);
+            active_shader->set_uniform("volume_world_matrix", world_matrix);
+            active_shader->set_uniform("volume_mirrored", is_left_handed);
+            active_shader->set_uniform("view_model_matrix", view_matrix * world_matrix);
+            active_shader->set_uniform("view_normal_matrix", view_normal_matrix);
 
             if (is_left_handed)
                 glsafe(::glFrontFace(GL_CW));
@@ -867,50 +1012,24 @@ void GLVolumeCollection::render(GLVolumeCollection::ERenderType type, bool disab
 
             if (is_left_handed)
                 glsafe(::glFrontFace(GL_CCW));
-
-            shader->stop_using();
         }
         else {
-            shader->start_using();
-            shader->set_uniform("z_range", m_z_range);
-            shader->set_uniform("clipping_plane", m_clipping_plane);
-            shader->set_uniform("use_color_clip_plane", m_use_color_clip_plane);
-            shader->set_uniform("color_clip_plane", m_color_clip_plane);
-            shader->set_uniform("uniform_color_clip_plane_1", m_color_clip_plane_colors[0]);
-            shader->set_uniform("uniform_color_clip_plane_2", m_color_clip_plane_colors[1]);
-            shader->set_uniform("print_volume.type", static_cast<int>(m_print_volume.type));
-            shader->set_uniform("print_volume.xy_data", m_print_volume.data);
-            shader->set_uniform("print_volume.z_data", m_print_volume.zs);
-            shader->set_uniform("volume_world_matrix", world_matrix);
-            shader->set_uniform("slope.actived", m_slope.active && !volume.first->is_modifier && !volume.first->is_wipe_tower);
-            shader->set_uniform("slope.volume_world_normal_matrix", static_cast<Matrix3f>(world_matrix_inv_transp.cast<float>()));
-            shader->set_uniform("slope.normal_z", m_slope.normal_z);
-
-#if ENABLE_ENVIRONMENT_MAP
-            unsigned int environment_texture_id = GUI::wxGetApp().plater()->get_environment_texture_id();
-            bool use_environment_texture = environment_texture_id > 0 && GUI::wxGetApp().app_config->get_bool("use_environment_map");
-            shader->set_uniform("use_environment_tex", use_environment_texture);
-            if (use_environment_texture)
-                glsafe(::glBindTexture(GL_TEXTURE_2D, environment_texture_id));
-#endif // ENABLE_ENVIRONMENT_MAP
+            use_shader(curr_shader);
+            active_shader->set_uniform("volume_world_matrix", world_matrix);
+            active_shader->set_uniform("slope.actived", m_slope.active && !volume.first->is_modifier && !volume.first->is_wipe_tower);
+            active_shader->set_uniform("slope.volume_world_normal_matrix", static_cast<Matrix3f>(world_matrix_inv_transp.cast<float>()));
             glcheck();
 
             volume.first->model.set_color(volume.first->render_color);
-            shader->set_uniform("view_model_matrix", view_matrix * world_matrix);
-            shader->set_uniform("projection_matrix", projection_matrix);
-            shader->set_uniform("view_normal_matrix", view_normal_matrix);
-            volume.first->render();
-
-#if ENABLE_ENVIRONMENT_MAP
-            if (use_environment_texture)
-                glsafe(::glBindTexture(GL_TEXTURE_2D, 0));
-#endif // ENABLE_ENVIRONMENT_MAP
+            active_shader->set_uniform("view_model_matrix", view_matrix * world_matrix);
+            active_shader->set_uniform("view_normal_matrix", view_normal_matrix);
+            volume.first->render(screen_size(volume.first->transformed_bounding_box()));
 
             glsafe(::glBindBuffer(GL_ARRAY_BUFFER, 0));
             glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
-            shader->stop_using();
         }
     }
+    use_shader(nullptr);
 
 
     // Purge the painted triangles cache from everything that was not used for some time.
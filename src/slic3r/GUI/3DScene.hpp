@@ -28,6 +28,8 @@
 
 #include <functional>
 #include <optional>
+#include <atomic>
+#include <array>
 
 #ifndef NDEBUG
 #define HAS_GLSAFE
@@ -139,6 +141,18 @@ private:
 
     NonManifoldEdges m_non_manifold_edges;
 
+    // Decimated render proxies of a high poly mesh, generated by a background thread, see GLVolume::generate_lods().
+    // Only the rendering switches to the proxies, picking and painting keep working with the full mesh.
+    struct LODs
+    {
+        // Set by the background thread once the models are filled in.
+        std::atomic<bool> ready{ false };
+        // From the finest to the coarsest.
+        std::array<GUI::GLModel, 2> models;
+    };
+    // The background thread only holds a weak pointer, it cancels the generation once the volume is deleted.
+    std::shared_ptr<LODs> m_lods;
+
 public:
     // Color of the triangles / quads held by this volume.
     ColorRGBA color;
@@ -327,6 +341,11 @@ public:
 
     bool                is_sinking() const;
     bool                is_below_printbed() const;
+    // Starts the generation of the decimated render proxies of the mesh, if the mesh has enough triangles.
+    void                generate_lods(std::shared_ptr<const TriangleMesh> mesh);
+    // Renders one of the render proxies if it is detailed enough for the size of the volume on screen (in pixels),
+    // or the full model otherwise.
+    void                render(double screen_size);
     void                render_sinking_contours();
     void                render_non_manifold_edges();
 
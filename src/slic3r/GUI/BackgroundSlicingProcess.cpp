@@ -29,6 +29,7 @@
 #include "libslic3r/GCode/PostProcessor.hpp"
 #include "libslic3r/Format/SL1.hpp"
 #include "libslic3r/Thread.hpp"
+#include "libslic3r/Trace.hpp"
 #include "libslic3r/libslic3r.h"
 
 #include <cassert>
@@ -138,6 +139,18 @@ PrinterTechnology BackgroundSlicingProcess::current_printer_technology() const
 	return m_print->technology();
 }
 
+std::shared_ptr<const GCodeProcessorResult> BackgroundSlicingProcess::get_partial_gcode_result() const
+{
+	std::lock_guard<std::mutex> lock(m_partial_gcode_result_mutex);
+	return m_partial_gcode_result;
+}
+
+void BackgroundSlicingProcess::set_partial_gcode_result(std::shared_ptr<const GCodeProcessorResult> result)
+{
+	std::lock_guard<std::mutex> lock(m_partial_gcode_result_mutex);
+	m_partial_gcode_result = std::move(result);
+}
+
 std::string BackgroundSlicingProcess::output_filepath_for_project(const boost::filesystem::path &project_path)
 {
 	assert(m_print != nullptr);
@@ -152,12 +165,33 @@ void BackgroundSlicingProcess::process_fff()
 {
 	assert(m_print == m_fff_print);
 	m_print->process();
+	if (! m_fff_print->step_state_with_timestamp(PrintStep::psGCodeExport).enabled)
+		// The task was limited to the object steps (see Plater's speculative slicing), nothing to export nor to finalize.
+		return;
 	wxCommandEvent evt(m_event_slicing_completed_id);
 	// Post the Slicing Finished message for the G-code viewer to update.
 	// Passing the timestamp 
 	evt.SetInt((int)(m_fff_print->step_state_with_timestamp(PrintStep::psSlicingFinished).timestamp));
 	wxQueueEvent(GUI::wxGetApp().mainframe->m_plater, evt.Clone());
-	m_fff_print->export_gcode(m_temp_output_path, m_gcode_result, [this](const ThumbnailsParams& params) { return this->render_thumbnails(params); });
+	GCodeProcessor::PartialResultCallback partial_result_cb;
+	if (m_event_partial_gcode_result_id != 0)
+		partial_result_cb = [this](GCodeProcessorResult &&partial_result) {
+			// Let the G-code preview show the layers exported so far.
+			this->set_partial_gcode_result(std::make_shared<const GCodeProcessorResult>(std::move(partial_result)));
+			wxQueueEvent(GUI::wxGetApp().mainframe->m_plater, new wxCommandEvent(m_event_partial_gcode_result_id));
+		};
+	try {
+		m_fff_print->export_gcode(m_temp_output_path, m_gcode_result, [this](const ThumbnailsParams& params) { return this->render_thumbnails(params); },
+			std::move(partial_result_cb));
+	} catch (...) {
+		this->set_partial_gcode_result(nullptr);
+		throw;
+	}
+	// The final G-code preview data is available in m_gcode_result.
+	this->set_partial_gcode_result(nullptr);
+	// The G-code preview only reads the moves, keep them in the compact form.
+	if (m_gcode_result != nullptr)
+		m_gcode_result->compact_moves();
 	if (this->set_step_started(bspsGCodeFinalize)) {
 	    if (! m_export_path.empty()) {
 			wxQueueEvent(GUI::wxGetApp().mainframe->m_plater, new wxCommandEvent(m_event_export_began_id));
@@ -198,6 +232,8 @@ void BackgroundSlicingProcess::process_sla()
 			}
 			ThumbnailsList thumbnails = this->render_thumbnails(ThumbnailsParams{sizes, true, true, true, true });
 			m_sla_print->export_print(export_path, thumbnails);
+			if (Trace::enabled())
+				Trace::save(export_path + ".trace.json");
 
             m_print->set_status(100, GUI::format(_L("Masked SLA file exported to %1%"), export_path));
         } else if (! m_upload_job.empty()) {
@@ -246,6 +282,8 @@ void BackgroundSlicingProcess::thread_proc()
 		this->call_process(exception);
 #endif
 		m_print->finalize();
+		if (m_print->canceled())
+			m_print->report_cancel_latency();
 		lck.lock();
 		m_state = m_print->canceled() ? STATE_CANCELED : STATE_FINISHED;
 		if (m_print->cancel_status() != Print::CANCELED_INTERNAL) {
@@ -342,11 +380,13 @@ void BackgroundSlicingProcess::call_process(std::exception_ptr &ex) throw()
 {
 	try {
 		assert(m_print != nullptr);
-		switch (m_print->technology()) {
-		case ptFFF: this->process_fff(); break;
-		case ptSLA: this->process_sla(); break;
-		default: m_print->process(); break;
-		}
+		m_print->execute_in_arena([this]() {
+			switch (m_print->technology()) {
+			case ptFFF: this->process_fff(); break;
+			case ptSLA: this->process_sla(); break;
+			default: m_print->process(); break;
+			}
+		});
 	} catch (CanceledException& /* ex */) {
 		// Canceled, this is all right.
 		assert(m_print->canceled());
@@ -588,6 +628,7 @@ Print::ApplyStatus BackgroundSlicingProcess::apply(const Model &model, const Dyn
 		// In addition, this early memory deallocation reduces memory footprint.
 		if (m_gcode_result != nullptr)
 			m_gcode_result->reset();
+		this->set_partial_gcode_result(nullptr);
 	}
 	return invalidated;
 }
@@ -724,6 +765,8 @@ void BackgroundSlicingProcess::finalize_gcode()
 		break;
 	}
 
+	if (Trace::enabled())
+		Trace::save(export_path + ".trace.json");
 	m_print->set_status(100, GUI::format(_L("G-code file exported to %1%"), export_path));
 }
 
@@ -736,8 +779,20 @@ void BackgroundSlicingProcess::prepare_upload()
 
 	if (m_print == m_fff_print) {
 		m_print->set_status(95, _u8L("Running post-processing scripts"));
+		bool linked = false;
+#ifndef _WIN32
+		// Without post-processing scripts, the upload reads the temporary G-code through a hard link instead of
+		// copying it first. The temporary G-code is never modified in place, the next G-code is exported next to it
+		// and renamed over it. On Windows, a hard link of a file opened for the upload could not be replaced.
+		if (const auto *post_process = m_fff_print->full_print_config().option<ConfigOptionStrings>("post_process");
+			post_process != nullptr && post_process->values.empty()) {
+			boost::system::error_code ec;
+			boost::filesystem::create_hard_link(m_temp_output_path, source_path, ec);
+			linked = ! ec;
+		}
+#endif // _WIN32
 		std::string error_message;
-		if (copy_file(m_temp_output_path, source_path.string(), error_message) != SUCCESS)
+		if (! linked && copy_file(m_temp_output_path, source_path.string(), error_message) != SUCCESS)
 			throw Slic3r::RuntimeError("Copying of the temporary G-code to the output G-code failed");
         m_upload_job.upload_data.upload_path = m_fff_print->print_statistics().finalize_output_path(m_upload_job.upload_data.upload_path.string());
         // Make a copy of the source path, as run_post_process_scripts() is allowed to change it when making a copy of the source file
@@ -103,6 +103,13 @@ public:
 	// specified path or uploaded.
 	// The wxCommandEvent is sent to the UI thread asynchronously without waiting for the event to be processed.
 	void set_export_began_event(int event_id) { m_event_export_began_id = event_id; }
+	// The following wxCommandEvent will be sent to the UI thread / Plater window, when a new snapshot of the G-code preview
+	// data of the layers exported so far is available, see get_partial_gcode_result().
+	// The wxCommandEvent is sent to the UI thread asynchronously without waiting for the event to be processed.
+	void set_partial_gcode_result_event(int event_id) { m_event_partial_gcode_result_id = event_id; }
+	// Snapshot of the G-code preview data of the layers exported so far, while the G-code export is running.
+	// Null if no snapshot is available or if the G-code export finished. Thread safe.
+	std::shared_ptr<const GCodeProcessorResult> get_partial_gcode_result() const;
 
 	// Activate either m_fff_print or m_sla_print.
 	// Return true if changed.
@@ -281,6 +288,13 @@ private:
 	int 						m_event_finished_id  			= 0;
 	// wxWidgets command ID to be sent to the plater to inform that the G-code is being exported.
 	int                         m_event_export_began_id         = 0;
+	// wxWidgets command ID to be sent to the plater to inform that m_partial_gcode_result was updated.
+	int                         m_event_partial_gcode_result_id = 0;
+
+	// Replaced by the background thread during the G-code export, reset once the export finishes.
+	std::shared_ptr<const GCodeProcessorResult> m_partial_gcode_result;
+	mutable std::mutex          m_partial_gcode_result_mutex;
+	void                        set_partial_gcode_result(std::shared_ptr<const GCodeProcessorResult> result);
 
 };
 
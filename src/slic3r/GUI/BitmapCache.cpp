@@ -9,6 +9,7 @@
 #include "../Utils/MacDarkMode.hpp"
 #include "GUI.hpp"
 #include "GUI_Utils.hpp"
+#include "SvgRasterCache.hpp"
 
 #include <boost/filesystem.hpp>
 #include <boost/nowide/cstdio.hpp>
@@ -472,36 +473,51 @@ wxBitmap* BitmapCache::load_svg(const std::string &bitmap_name, unsigned target_
     if (!new_color.empty())
         replaces["#ED6B21"] = new_color;
 
-    NSVGimage *image =  nsvgParseFromFileWithReplace(Slic3r::var(bitmap_name + ".svg").c_str(), "px", 96.0f, replaces);
-    if (image == nullptr)
+    std::string svg_data;
+    nsvgGetDataFromFileWithReplace(Slic3r::var(bitmap_name + ".svg").c_str(), svg_data, replaces);
+    if (svg_data.empty())
         return nullptr;
 
     target_height != 0 ? target_height *= m_scale : target_width *= m_scale;
 
-    float svg_scale = target_height != 0 ? 
-                  (float)target_height / image->height  : target_width != 0 ?
-                  (float)target_width / image->width    : 1;
+    // The rasterized icon is looked up in the persistent cache first.
+    const std::string cache_key = SvgRasterCache::key(svg_data, "bitmap;" + std::to_string(target_width) + "x" + std::to_string(target_height));
+    SvgRasterCache::Image raster;
+    if (! SvgRasterCache::load(cache_key, raster)) {
+        // nsvgParse() modifies the parsed string, svg_data is not used anymore.
+        NSVGimage *image = nsvgParse(svg_data.data(), "px", 96.0f);
+        if (image == nullptr)
+            return nullptr;
+
+        float svg_scale = target_height != 0 ? 
+                      (float)target_height / image->height  : target_width != 0 ?
+                      (float)target_width / image->width    : 1;
+
+        int   width    = (int)(svg_scale * image->width + 0.5f);
+        int   height   = (int)(svg_scale * image->height + 0.5f);
+        int   n_pixels = width * height;
+        if (n_pixels <= 0) {
+            ::nsvgDelete(image);
+            return nullptr;
+        }
 
-    int   width    = (int)(svg_scale * image->width + 0.5f);
-    int   height   = (int)(svg_scale * image->height + 0.5f);
-    int   n_pixels = width * height;
-    if (n_pixels <= 0) {
-        ::nsvgDelete(image);
-        return nullptr;
-    }
+        NSVGrasterizer *rast = ::nsvgCreateRasterizer();
+        if (rast == nullptr) {
+            ::nsvgDelete(image);
+            return nullptr;
+        }
 
-    NSVGrasterizer *rast = ::nsvgCreateRasterizer();
-    if (rast == nullptr) {
+        raster.width  = unsigned(width);
+        raster.height = unsigned(height);
+        raster.rgba.assign(n_pixels * 4, 0);
+        ::nsvgRasterize(rast, image, 0, 0, svg_scale, raster.rgba.data(), width, height, width * 4);
+        ::nsvgDeleteRasterizer(rast);
         ::nsvgDelete(image);
-        return nullptr;
-    }
 
-    std::vector<unsigned char> data(n_pixels * 4, 0);
-    ::nsvgRasterize(rast, image, 0, 0, svg_scale, data.data(), width, height, width * 4);
-    ::nsvgDeleteRasterizer(rast);
-    ::nsvgDelete(image);
+        SvgRasterCache::save(cache_key, raster);
+    }
 
-    return this->insert_raw_rgba(bitmap_key, width, height, data.data(), grayscale);
+    return this->insert_raw_rgba(bitmap_key, raster.width, raster.height, raster.rgba.data(), grayscale);
 }
 
 //we make scaled solid bitmaps only for the cases, when its will be used with scaled SVG icon in one output bitmap
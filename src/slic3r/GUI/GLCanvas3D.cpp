@@ -161,6 +161,7 @@ void GLCanvas3D::LayersEditing::select_object(const Model &model, int object_id)
         m_layer_height_profile_modified = false;
         delete m_slicing_parameters;
         m_slicing_parameters   = nullptr;
+        m_slicing_adaptive.clear();
         m_layers_texture.valid = false;
         this->last_object_id   = object_id;
         m_model_object         = model_object_new;
@@ -570,7 +571,9 @@ void GLCanvas3D::LayersEditing::reset_layer_height_profile(GLCanvas3D& canvas)
 void GLCanvas3D::LayersEditing::adaptive_layer_height_profile(GLCanvas3D& canvas, float quality_factor)
 {
     this->update_slicing_parameters();
-    m_layer_height_profile = layer_height_profile_adaptive(*m_slicing_parameters, *m_model_object, quality_factor);
+    // Does nothing if the meshes of the object did not change since the last call.
+    m_slicing_adaptive.prepare(*m_model_object);
+    m_layer_height_profile = layer_height_profile_adaptive(*m_slicing_parameters, m_slicing_adaptive, quality_factor);
     const_cast<ModelObject*>(m_model_object)->layer_height_profile.set(m_layer_height_profile);
     m_layers_texture.valid = false;
     canvas.post_event(SimpleEvent(EVT_GLCANVAS_SCHEDULE_BACKGROUND_PROCESS));
@@ -1760,6 +1763,8 @@ void GLCanvas3D::render()
     Slic3r::ScopeGuard in_render_guard([this]() { m_in_render = false; });
     (void)in_render_guard;
 
+    const auto frame_start = std::chrono::high_resolution_clock::now();
+
     if (m_canvas == nullptr)
         return;
 
@@ -1884,6 +1889,15 @@ void GLCanvas3D::render()
         ImGuiPureWrap::text("FPS (SwapBuffers() calls per second):");
         ImGui::SameLine();
         ImGuiPureWrap::text(std::to_string(m_render_stats.get_fps_and_reset_if_needed()));
+        ImGuiPureWrap::text("Frame time (ms), average / max:");
+        ImGui::SameLine();
+        ImGuiPureWrap::text(format("%.2f / %.2f", m_render_stats.get_frame_time_ms(), m_render_stats.get_frame_time_ms_max()));
+        ImGuiPureWrap::text("Frames rendered:");
+        ImGui::SameLine();
+        ImGuiPureWrap::text(std::to_string(m_render_stats.get_frames_total()));
+        ImGuiPureWrap::text("Idle events without redraw:");
+        ImGui::SameLine();
+        ImGuiPureWrap::text(std::to_string(m_render_stats.get_idle_events_skipped()));
         ImGui::Separator();
         ImGuiPureWrap::text("Compressed textures:");
         ImGui::SameLine();
@@ -1961,7 +1975,7 @@ void GLCanvas3D::render()
     wxGetApp().imgui()->render();
 
     m_canvas->SwapBuffers();
-    m_render_stats.increment_fps_counter();
+    m_render_stats.frame_rendered(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - frame_start).count());
 }
 
 void GLCanvas3D::render_thumbnail(ThumbnailData& thumbnail_data, unsigned int w, unsigned int h, const ThumbnailsParams& thumbnail_params, Camera::EType camera_type)
@@ -2681,8 +2695,10 @@ void GLCanvas3D::on_idle(wxIdleEvent& evt)
     bool imgui_requires_extra_frame = wxGetApp().imgui()->requires_extra_frame();
     m_dirty |= imgui_requires_extra_frame;
 
-    if (!m_dirty)
+    if (!m_dirty) {
+        m_render_stats.idle_event_skipped();
         return;
+    }
 
     // this needs to be done here.
     // during the render launched by the refresh the value may be set again 
@@ -2692,7 +2708,9 @@ void GLCanvas3D::on_idle(wxIdleEvent& evt)
 
     if (m_extra_frame_requested || mouse3d_controller_applied || imgui_requires_extra_frame || wxGetApp().imgui()->requires_extra_frame()) {
         m_extra_frame_requested = false;
-        evt.RequestMore();
+        // Don't request more idle events right away, it would spin the idle loop and render as fast as the GPU allows.
+        // The extra frame is rendered by the idle event following the render timer, m_dirty is kept set.
+        schedule_extra_frame(ExtraFrameIntervalMs);
     }
     else
         m_dirty = false;
@@ -3347,11 +3365,14 @@ void GLCanvas3D::on_mouse(wxMouseEvent& evt)
     if (imgui->update_mouse_data(evt)) {
         m_mouse.position = evt.Leaving() ? Vec2d(-1.0, -1.0) : pos.cast<double>();
         m_tooltip.set_in_imgui(true);
-        render();
+        // The same input of ImGui produces the same frame, only render if the input changed.
+        if (imgui->mouse_input_changed()) {
+            render();
+            m_dirty = true;
+        }
 #ifdef SLIC3R_DEBUG_MOUSE_EVENTS
         printf((format_mouse_event_debug_message(evt) + " - Consumed by ImGUI\n").c_str());
 #endif /* SLIC3R_DEBUG_MOUSE_EVENTS */
-        m_dirty = true;
         // do not return if dragging or tooltip not empty to allow for tooltip update
         // also, do not return if the mouse is moving and also is inside MM gizmo to allow update seed fill selection
         if (!m_mouse.dragging && m_tooltip.is_empty() && (m_gizmos.get_current_type() != GLGizmosManager::MmuSegmentation || !evt.Moving()))
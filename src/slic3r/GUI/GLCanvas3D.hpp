@@ -28,6 +28,7 @@
 #include "ArrangeSettingsDialogImgui.hpp"
 
 #include "libslic3r/Slicing.hpp"
+#include "libslic3r/SlicingAdaptive.hpp"
 
 #include <float.h>
 
@@ -219,6 +220,8 @@ class GLCanvas3D
         SlicingParameters           *m_slicing_parameters{ nullptr };
         std::vector<double>         m_layer_height_profile;
         bool                        m_layer_height_profile_modified{ false };
+        // Faces of m_model_object sorted for the adaptive layer height profile, reused while only the quality changes.
+        SlicingAdaptive             m_slicing_adaptive;
         // Shrinkage compensation to apply when we need to use object_max_z with Z compensation.
         Vec3d                       m_shrinkage_compensation{ Vec3d::Ones() };
 
@@ -378,8 +381,25 @@ class GLCanvas3D
         std::chrono::time_point<std::chrono::high_resolution_clock> m_measuring_start;
         int m_fps_out = -1;
         int m_fps_running = 0;
+        // Frame timing, averaged over the same period as the FPS.
+        // While nothing changes in the scene, no frame shall be rendered.
+        double m_frame_time_ms_running = 0.;
+        double m_frame_time_ms_max_running = 0.;
+        double m_frame_time_ms_out = 0.;
+        double m_frame_time_ms_max_out = 0.;
+        size_t m_frames_total = 0;
+        size_t m_idle_events_skipped = 0;
     public:
         void increment_fps_counter() { ++m_fps_running; }
+        // Called once a frame was rendered, frame_time_ms is the duration of GLCanvas3D::render().
+        void frame_rendered(double frame_time_ms) {
+            increment_fps_counter();
+            ++m_frames_total;
+            m_frame_time_ms_running += frame_time_ms;
+            m_frame_time_ms_max_running = std::max(m_frame_time_ms_max_running, frame_time_ms);
+        }
+        // Called from the idle handler if no redraw was requested.
+        void idle_event_skipped() { ++m_idle_events_skipped; }
         int get_fps() { return m_fps_out; }
         int get_fps_and_reset_if_needed() {
             auto cur_time = std::chrono::high_resolution_clock::now();
@@ -387,11 +407,19 @@ class GLCanvas3D
             if (elapsed_ms > 1000  || m_fps_out == -1) {
                 m_measuring_start = cur_time;
                 m_fps_out = int (1000. * m_fps_running / elapsed_ms);
+                m_frame_time_ms_out = m_fps_running > 0 ? m_frame_time_ms_running / m_fps_running : 0.;
+                m_frame_time_ms_max_out = m_frame_time_ms_max_running;
                 m_fps_running = 0;
+                m_frame_time_ms_running = 0.;
+                m_frame_time_ms_max_running = 0.;
             }
             return m_fps_out;
         }
-
+        // Valid after get_fps_and_reset_if_needed() was called.
+        double get_frame_time_ms() const { return m_frame_time_ms_out; }
+        double get_frame_time_ms_max() const { return m_frame_time_ms_max_out; }
+        size_t get_frames_total() const { return m_frames_total; }
+        size_t get_idle_events_skipped() const { return m_idle_events_skipped; }
     };
 
     class Labels
@@ -506,6 +534,8 @@ private:
     // when true renders an extra frame by not resetting m_dirty to false
     // see request_extra_frame()
     bool m_extra_frame_requested;
+    // The extra frames are rendered at most at this interval, all the redraw requests in between are coalesced.
+    static constexpr int ExtraFrameIntervalMs = 16;
     bool m_event_handlers_bound{ false };
 
     GLVolumeCollection m_volumes;
@@ -939,6 +969,8 @@ public:
 
     void request_extra_frame() { m_extra_frame_requested = true; }
     
+    // Schedules a redraw in the given time. The redraw requests are coalesced, a single frame is rendered
+    // for all the requests made before the timer fires.
     void schedule_extra_frame(int miliseconds);
 
     float get_main_toolbar_height() { return m_main_toolbar.get_height(); }
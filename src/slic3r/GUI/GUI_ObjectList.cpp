@@ -32,6 +32,8 @@
 #include "NotificationManager.hpp"
 #include "MsgDialog.hpp"
 
+#include <optional>
+
 #include <boost/algorithm/string.hpp>
 #include <wx/progdlg.h>
 #include <wx/listbook.h>
@@ -3706,17 +3708,21 @@ void ObjectList::update_selections()
             }
         }
         else {
+        // Current selection of the list is only queried once, not for each object.
+        std::optional<wxDataViewItemArray> current_sels;
         for (const auto& object : objects_content) {
             if (object.second.size() == 1)          // object with 1 instance                
                 sels.Add(m_objects_model->GetItemById(object.first));
             else if (object.second.size() > 1)      // object with several instances                
             {
-                wxDataViewItemArray current_sels;
-                GetSelections(current_sels);
+                if (! current_sels) {
+                    current_sels.emplace();
+                    GetSelections(*current_sels);
+                }
                 const wxDataViewItem frst_inst_item = m_objects_model->GetItemByInstanceId(object.first, 0);
 
                 bool root_is_selected = false;
-                for (const auto& item:current_sels)
+                for (const auto& item : *current_sels)
                     if (item == m_objects_model->GetParent(frst_inst_item) || 
                         item == m_objects_model->GetTopParent(frst_inst_item)) {
                         root_is_selected = true;
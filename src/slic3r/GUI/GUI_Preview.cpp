@@ -302,6 +302,16 @@ void Preview::reload_print()
     load_print();
 }
 
+void Preview::reload_partial_gcode_preview()
+{
+    // Keep the layers range, so that the user may inspect the first layers while more layers are being loaded.
+    if (!IsShown() || m_gcode_result->has_moves())
+        return;
+
+    m_loaded = false;
+    load_print(true);
+}
+
 void Preview::msw_rescale()
 {
     m_layers_slider->SetEmUnit(wxGetApp().em_unit());
@@ -841,7 +851,7 @@ void Preview::update_sliders_from_canvas(wxKeyEvent& event)
 
 void Preview::update_moves_slider(std::optional<int> visible_range_min, std::optional<int> visible_range_max)
 {
-    if (m_gcode_result->moves.empty())
+    if (! m_gcode_result->has_moves())
         return;
 
     const libvgcode::Interval& range = m_canvas->get_gcode_view_enabled_range();
@@ -945,8 +955,11 @@ void Preview::load_print_as_fff(bool keep_z_range)
     }
 
     libvgcode::EViewType gcode_view_type = m_canvas->get_gcode_view_type();
-    const bool gcode_preview_data_valid = !m_gcode_result->moves.empty();
-    const bool is_pregcode_preview = !gcode_preview_data_valid && wxGetApp().is_editor();
+    const bool gcode_preview_data_valid = m_gcode_result->has_moves();
+    // While the G-code is being exported, show the layers exported so far.
+    const std::shared_ptr<const GCodeProcessorResult> partial_gcode_result = (!gcode_preview_data_valid && wxGetApp().is_editor()) ?
+        m_process->get_partial_gcode_result() : nullptr;
+    const bool is_pregcode_preview = !gcode_preview_data_valid && partial_gcode_result == nullptr && wxGetApp().is_editor();
 
     const std::vector<std::string> tool_colors = wxGetApp().plater()->get_extruder_color_strings_from_plater_config(m_gcode_result);
     const std::vector<CustomGCode::Item>& color_print_values = wxGetApp().is_editor() ?
@@ -969,6 +982,12 @@ void Preview::load_print_as_fff(bool keep_z_range)
             zs = m_canvas->get_gcode_layers_zs();
             m_loaded = true;
         }
+        else if (partial_gcode_result != nullptr) {
+            // Load the G-code preview of the layers exported so far, m_loaded is not set to let the final G-code preview replace it.
+            m_canvas->load_gcode_preview(*partial_gcode_result, tool_colors, color_print_colors);
+            gcode_view_type = m_canvas->get_gcode_view_type();
+            zs = m_canvas->get_gcode_layers_zs();
+        }
         else if (is_pregcode_preview) {
             // Load the initial preview based on slices, not the final G-code.
             m_canvas->load_preview(tool_colors, color_print_colors, color_print_values);
@@ -132,6 +132,8 @@ public:
     void load_gcode_shells();
     void load_print(bool keep_z_range = false);
     void reload_print();
+    // Reload the G-code preview of the layers exported so far, while the G-code export is running.
+    void reload_partial_gcode_preview();
 
     void msw_rescale();
 
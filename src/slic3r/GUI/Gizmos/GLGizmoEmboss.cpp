@@ -151,6 +151,9 @@ struct TextDataBase : public DataBase
     /// <returns>True on succes otherwise False(Per glyph shoud be disabled)</returns>
     bool create_text_lines(const Transform3d &tr, const ModelVolumePtrs &vols) override; 
 
+    // Glyphs of text are reused between jobs
+    Slic3r::Emboss::TriangulationCache *triangulation_cache() override { return m_font_file.triangulations.get(); }
+
 private:
     //  Keep pointer on Data of font (glyph shapes)
     FontFileWithCache m_font_file;
@@ -365,7 +368,7 @@ CreateVolumeParams GLGizmoEmboss::create_input(ModelVolumeType volume_type)
     const GLVolume *gl_volume = get_first_hovered_gl_volume(m_parent);
     Plater *plater = wxGetApp().plater();
     return CreateVolumeParams{std::move(base), m_parent, plater->get_camera(), plater->build_volume(),
-        plater->get_ui_job_worker(), volume_type, m_raycast_manager, gizmo, gl_volume, style.distance, style.angle};
+        plater->get_emboss_job_worker(), volume_type, m_raycast_manager, gizmo, gl_volume, style.distance, style.angle};
 }
 
 void GLGizmoEmboss::on_shortcut_key() {
@@ -3860,7 +3863,7 @@ void draw_font_preview(FaceName &face, const std::string& text, Facenames &faces
             face.is_created // copy
         };
         auto  job    = std::make_unique<CreateFontImageJob>(std::move(data));
-        auto &worker = wxGetApp().plater()->get_ui_job_worker();
+        auto &worker = wxGetApp().plater()->get_emboss_job_worker();
         queue_job(worker, std::move(job));
     } else {
         // cant start new thread at this moment so wait in queue
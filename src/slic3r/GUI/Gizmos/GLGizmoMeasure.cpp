@@ -542,8 +542,8 @@ void GLGizmoMeasure::on_set_state()
         restore_scene_raycasters_state();
         m_editing_distance = false;
         m_is_editing_distance_first_frame = true;
-        m_measuring.reset();
-        m_raycaster.reset();
+        // m_measuring and m_raycaster are kept, so that reopening the gizmo on the same unchanged volumes
+        // does not need to extract the planes again. They are replaced by update_if_needed() otherwise.
     }
     else {
         m_mode = EMode::FeatureSelection;
@@ -1101,7 +1101,7 @@ void GLGizmoMeasure::update_if_needed()
         const ModelInstance* inst = obj->instances[v->instance_idx()];
         const ModelVolume* vol = obj->volumes[volume_idx];
         const VolumeCacheItem item = {
-            obj, inst, vol,
+            obj, inst, vol, vol->get_mesh_shared_ptr(),
             Geometry::translation_transform(selection.get_first_volume()->get_sla_shift_z() * Vec3d::UnitZ()) * inst->get_matrix() * vol->get_matrix()
         };
         volumes_cache.emplace_back(item);
@@ -78,11 +78,13 @@ class GLGizmoMeasure : public GLGizmoBase
         const ModelObject* object{ nullptr };
         const ModelInstance* instance{ nullptr };
         const ModelVolume* volume{ nullptr };
+        // Keeps the mesh alive, so that a changed mesh is always detected.
+        std::shared_ptr<const TriangleMesh> mesh;
         Transform3d world_trafo;
 
         bool operator == (const VolumeCacheItem& other) const {
             return this->object == other.object && this->instance == other.instance && this->volume == other.volume &&
-                this->world_trafo.isApprox(other.world_trafo);
+                this->mesh == other.mesh && this->world_trafo.isApprox(other.world_trafo);
         }
     };
 
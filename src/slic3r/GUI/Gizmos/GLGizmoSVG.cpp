@@ -222,7 +222,7 @@ CreateVolumeParams GLGizmoSVG::create_input(ModelVolumeType volume_type, std::st
     auto gizmo = static_cast<unsigned char>(GLGizmosManager::Svg);
     Plater *plater = wxGetApp().plater();
     return CreateVolumeParams{std::move(base), m_parent, plater->get_camera(), plater->build_volume(),
-        plater->get_ui_job_worker(), volume_type, m_raycast_manager, gizmo, gl_volume};
+        plater->get_emboss_job_worker(), volume_type, m_raycast_manager, gizmo, gl_volume};
 }
 
 bool GLGizmoSVG::is_svg(const ModelVolume &volume) {
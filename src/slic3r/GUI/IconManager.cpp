@@ -11,6 +11,7 @@
 #include "libslic3r/Utils.hpp" // ScopeGuard   
 
 #include "3DScene.hpp" // glsafe
+#include "SvgRasterCache.hpp"
 #include "GL/glew.h"
 
 #define STB_RECT_PACK_IMPLEMENTATION
@@ -34,11 +35,12 @@ IconManager::~IconManager() {
 }
 
 namespace {
-NSVGimage *parse_file(const char * filepath) {
+// Returns an empty string on failure.
+std::string read_file(const char * filepath) {
     FILE *fp = boost::nowide::fopen(filepath, "rb");
     assert(fp != nullptr);
     if (fp == nullptr)
-        return nullptr;
+        return {};
 
     Slic3r::ScopeGuard sg([fp]() { fclose(fp); });
 
@@ -46,16 +48,15 @@ NSVGimage *parse_file(const char * filepath) {
     size_t size = ftell(fp);
     fseek(fp, 0, SEEK_SET);
 
-    // Note: +1 is for null termination
-    auto data_ptr = std::make_unique<char[]>(size+1);
-    data_ptr[size] = '\0'; // Must be null terminated.
+    // Note: std::string is null terminated.
+    std::string data(size, '\0');
 
-    size_t readed_size = fread(data_ptr.get(), 1, size, fp);
+    size_t readed_size = fread(data.data(), 1, size, fp);
     assert(readed_size == size);
     if (readed_size != size)
-        return nullptr;
+        return {};
 
-    return nsvgParse(data_ptr.get(), "px", 96.0f);
+    return data;
 }
 
 void subdata(unsigned char *data, size_t data_stride, const std::vector<unsigned char> &data2, size_t data2_row) {
@@ -162,33 +163,49 @@ IconManager::Icons IconManager::init(const InitTypes &input)
         if (!boost::algorithm::iends_with(i.filepath, ".svg"))
             continue;
 
-        NSVGimage *image = parse_file(i.filepath.c_str());
-        assert(image != nullptr);
-        if (image == nullptr)
+        std::string svg_data = read_file(i.filepath.c_str());
+        if (svg_data.empty())
             return {};
 
-        ScopeGuard sg_image([image]() { ::nsvgDelete(image); });
-
-        float svg_scale = i.size.y / image->height;
-        // scale should be same in both directions
-        assert(is_approx(svg_scale, i.size.y / image->width));
-                
         const stbrp_rect &rect = pack_rects[j];
-        int n_pixels = rect.w * rect.h;
-        std::vector<unsigned char> icon_data(n_pixels * channels, {0});
-        ::nsvgRasterize(rast, image, 0, 0, svg_scale, icon_data.data(), i.size.x, i.size.y, i.size.x * channels);
-        
-        // makes white or gray only data in icon
-        if (i.type == RasterType::white_only_data || 
-            i.type == RasterType::gray_only_data) {
-            unsigned char value = (i.type == RasterType::white_only_data) ? 255 : 127;
-            for (size_t k = 0; k < icon_data.size(); k += channels)
-                if (icon_data[k] != 0 || icon_data[k + 1] != 0 || icon_data[k + 2] != 0) {
-                    icon_data[k]     = value;
-                    icon_data[k + 1] = value;
-                    icon_data[k + 2] = value;
-                }
+        // The rasterized icon is looked up in the persistent cache first.
+        const std::string cache_key = SvgRasterCache::key(svg_data,
+            "icon;" + std::to_string(rect.w) + "x" + std::to_string(rect.h) + ";" + std::to_string(int(i.type)));
+        SvgRasterCache::Image raster;
+        if (! SvgRasterCache::load(cache_key, raster) || raster.width != unsigned(rect.w) || raster.height != unsigned(rect.h)) {
+            // nsvgParse() modifies the parsed string, svg_data is not used anymore.
+            NSVGimage *image = nsvgParse(svg_data.data(), "px", 96.0f);
+            assert(image != nullptr);
+            if (image == nullptr)
+                return {};
+
+            ScopeGuard sg_image([image]() { ::nsvgDelete(image); });
+
+            float svg_scale = i.size.y / image->height;
+            // scale should be same in both directions
+            assert(is_approx(svg_scale, i.size.y / image->width));
+
+            raster.width  = unsigned(rect.w);
+            raster.height = unsigned(rect.h);
+            raster.rgba.assign(size_t(rect.w) * size_t(rect.h) * channels, 0);
+            std::vector<unsigned char> &icon_data = raster.rgba;
+            ::nsvgRasterize(rast, image, 0, 0, svg_scale, icon_data.data(), i.size.x, i.size.y, i.size.x * channels);
+
+            // makes white or gray only data in icon
+            if (i.type == RasterType::white_only_data || 
+                i.type == RasterType::gray_only_data) {
+                unsigned char value = (i.type == RasterType::white_only_data) ? 255 : 127;
+                for (size_t k = 0; k < icon_data.size(); k += channels)
+                    if (icon_data[k] != 0 || icon_data[k + 1] != 0 || icon_data[k + 2] != 0) {
+                        icon_data[k]     = value;
+                        icon_data[k + 1] = value;
+                        icon_data[k + 2] = value;
+                    }
+            }
+
+            SvgRasterCache::save(cache_key, raster);
         }
+        const std::vector<unsigned char> &icon_data = raster.rgba;
 
         int start_offset = (rect.y*tex_size.x + rect.x) * channels;
         int data_stride = tex_size.x * channels;
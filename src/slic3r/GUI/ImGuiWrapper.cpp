@@ -296,7 +296,11 @@ bool ImGuiWrapper::update_mouse_data(wxMouseEvent& evt)
         io.MouseWheel = static_cast<float>(evt.GetWheelRotation()) / wheel_delta;
 
     unsigned buttons = (evt.LeftIsDown() ? 1 : 0) | (evt.RightIsDown() ? 2 : 0) | (evt.MiddleIsDown() ? 4 : 0);
+    // Duplicate mouse events (for example a mouse move event not moving the mouse) do not change the state of ImGui.
+    m_mouse_input_changed = buttons != m_mouse_buttons || io.MousePos.x != m_mouse_pos.x || io.MousePos.y != m_mouse_pos.y ||
+        evt.GetWheelRotation() != 0 || evt.ButtonDClick() || evt.Entering() || evt.Leaving();
     m_mouse_buttons = buttons;
+    m_mouse_pos = io.MousePos;
 
     if (ImGuiPureWrap::want_mouse())
         new_frame();
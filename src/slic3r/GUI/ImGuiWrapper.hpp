@@ -38,6 +38,8 @@ class ImGuiWrapper
     unsigned m_font_texture{ 0 };
     float m_style_scaling{ 1.0 };
     unsigned m_mouse_buttons{ 0 };
+    ImVec2 m_mouse_pos{ -FLT_MAX, -FLT_MAX };
+    bool m_mouse_input_changed{ true };
     bool m_disabled{ false };
     bool m_new_frame_open{ false };
     bool m_requires_extra_frame{ false };
@@ -125,6 +127,9 @@ public:
                      ImU32 color     = ImGui::GetColorU32(ImGuiPureWrap::COL_ORANGE_LIGHT),
                      float thickness = 3.f);
 
+    // Whether the mouse input passed by the last update_mouse_data() differs from the one passed before.
+    bool mouse_input_changed() const { return m_mouse_input_changed; }
+
     bool requires_extra_frame() const { return m_requires_extra_frame; }
     void set_requires_extra_frame() { m_requires_extra_frame = true; }
     void reset_requires_extra_frame() { m_requires_extra_frame = false; }
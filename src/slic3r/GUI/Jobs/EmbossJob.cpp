@@ -510,7 +510,7 @@ bool is_valid(ModelVolumeType volume_type);
 /// <summary>
 /// Start job for add new volume to object with given transformation
 /// </summary>
-/// <param name="worker">Define where to queue the job. e.g. wxGetApp().plater()->get_ui_job_worker()</param>
+/// <param name="worker">Define where to queue the job. e.g. wxGetApp().plater()->get_emboss_job_worker()</param>
 /// <param name="object">Define where to add</param>
 /// <param name="volume_tr">Wanted volume transformation, when not set will be calculated after creation to be near the object</param>
 /// <param name="data">Define what to emboss - shape</param>
@@ -673,7 +673,7 @@ bool start_update_volume(DataUpdate &&data, const ModelVolume &volume, const Sel
     }
 
 #ifndef EXECUTE_UPDATE_ON_MAIN_THREAD
-    auto &worker = wxGetApp().plater()->get_ui_job_worker();
+    auto &worker = wxGetApp().plater()->get_emboss_job_worker();
     return queue_job(worker, std::move(job));
 #else
     // Run Job on main thread (blocking) - ONLY DEBUG
@@ -883,7 +883,7 @@ template<typename Fnc> TriangleMesh create_mesh_per_glyph(DataBase &input, Fnc w
             assert(get_extents(letter_shape) == letter_bb);
             auto projectZ = std::make_unique<ProjectZ>(depth);
             ProjectTransform project(std::move(projectZ), tr);
-            indexed_triangle_set glyph_its = polygons2model(letter_shape, project);
+            indexed_triangle_set glyph_its = polygons2model(letter_shape, project, input.triangulation_cache());
             its_merge(result, std::move(glyph_its));
 
             if (((s_i_offset + i) % 15) && was_canceled())
@@ -942,7 +942,7 @@ TriangleMesh try_create_mesh(DataBase &input, const Fnc& was_canceled)
     Transform3d tr = Eigen::Translation<double, 3>(0., 0.,static_cast<double>(offset)) * Eigen::Scaling(scale);
     ProjectTransform project(std::move(projectZ), tr);
     if (was_canceled()) return {};
-    return TriangleMesh(polygons2model(shapes, project));
+    return TriangleMesh(polygons2model(shapes, project, input.triangulation_cache()));
 }
 
 template<typename Fnc>
@@ -73,6 +73,12 @@ public:
     /// <returns>True on succes otherwise False(Per glyph shoud be disabled)</returns>
     virtual bool create_text_lines(const Transform3d& tr, const ModelVolumePtrs &vols) { return false; }
 
+    /// <summary>
+    /// Cache of triangulated shapes, e.g. glyphs of text
+    /// </summary>
+    /// <returns>Cache to use in job thread, nullptr when shape is not worth to cache</returns>
+    virtual Slic3r::Emboss::TriangulationCache *triangulation_cache() { return nullptr; }
+
     // Define per letter projection on one text line
     // [optional] It is not used when empty
     Slic3r::Emboss::TextLines text_lines = {};
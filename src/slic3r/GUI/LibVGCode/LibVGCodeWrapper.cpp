@@ -8,6 +8,10 @@
 #include <iterator>
 #include <cassert>
 #include <cinttypes>
+#include <numeric>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
 #include "libslic3r/libslic3r.h"
 #include "LibVGCodeWrapper.hpp"
@@ -173,6 +177,90 @@ Slic3r::PrintEstimatedStatistics::ETimeMode convert(const ETimeMode& mode)
     }
 }
 
+static Slic3r::EMoveType move_type(const std::vector<Slic3r::GCodeProcessorResult::MoveVertex>& moves, size_t i) { return moves[i].type; }
+static Slic3r::EMoveType move_type(const Slic3r::GCodeProcessorResult::CompactMoves& moves, size_t i) { return moves.type(i); }
+static Slic3r::GCodeExtrusionRole move_extrusion_role(const std::vector<Slic3r::GCodeProcessorResult::MoveVertex>& moves, size_t i) { return moves[i].extrusion_role; }
+static Slic3r::GCodeExtrusionRole move_extrusion_role(const Slic3r::GCodeProcessorResult::CompactMoves& moves, size_t i) { return moves.extrusion_role(i); }
+
+// Moves is either std::vector<MoveVertex> or GCodeProcessorResult::CompactMoves, which returns the moves by value.
+// The moves are converted in parallel by chunks: The number of vertices of each chunk is counted first,
+// then the chunks are written into the vertices allocated at once at offsets given by the prefix sums of the counts.
+template<typename Moves>
+static void convert_moves(const Moves& moves, const Slic3r::GCodeProcessorResult& result, std::vector<PathVertex>& vertices)
+{
+    vertices.clear();
+    if (moves.size() < 2)
+        return;
+
+    // Whether a 'phantom' vertex is emitted before the vertex of the i-th move.
+    auto has_phantom_vertex = [&moves](size_t i) {
+        const EOptionType option_type = move_type_to_option(convert(move_type(moves, i)));
+        return (option_type == EOptionType::COUNT || option_type == EOptionType::Travels || option_type == EOptionType::Wipes) &&
+            (i == 1 || move_type(moves, i - 1) != move_type(moves, i) || move_extrusion_role(moves, i - 1) != move_extrusion_role(moves, i));
+    };
+
+    static constexpr const size_t chunk_size = 65536;
+    const size_t num_chunks = (moves.size() - 1 + chunk_size - 1) / chunk_size;
+    auto chunk_begin = [](size_t chunk) { return 1 + chunk * chunk_size; };
+    auto chunk_end   = [&moves](size_t chunk) { return std::min(moves.size(), 1 + (chunk + 1) * chunk_size); };
+
+    // 1) Count the vertices of the chunks.
+    std::vector<size_t> offsets(num_chunks + 1, 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_chunks, 1), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t chunk = range.begin(); chunk < range.end(); ++chunk) {
+            size_t count = 0;
+            for (size_t i = chunk_begin(chunk); i < chunk_end(chunk); ++i)
+                count += has_phantom_vertex(i) ? 2 : 1;
+            offsets[chunk + 1] = count;
+        }
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    vertices.resize(offsets.back());
+
+    // 2) Fill in the vertices of the chunks.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_chunks, 1), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t chunk = range.begin(); chunk < range.end(); ++chunk) {
+            auto it_vertex = vertices.begin() + offsets[chunk];
+            Slic3r::GCodeProcessorResult::MoveVertex prev = moves[chunk_begin(chunk) - 1];
+            for (size_t i = chunk_begin(chunk); i < chunk_end(chunk); ++i) {
+                const Slic3r::GCodeProcessorResult::MoveVertex curr = moves[i];
+                const EMoveType curr_type = convert(curr.type);
+                if (has_phantom_vertex(i)) {
+                    // to allow libvgcode to properly detect the start/end of a path we need to add a 'phantom' vertex
+                    // equal to the current one with the exception of the position, which should match the previous move position,
+                    // and the times, which are set to zero
+#if VGCODE_ENABLE_COG_AND_TOOL_MARKERS
+                    *it_vertex++ = { convert(prev.position), curr.height, curr.width, curr.feedrate, prev.actual_feedrate,
+                        curr.mm3_per_mm, curr.fan_speed, curr.temperature, 0.0f, convert(curr.extrusion_role), curr_type,
+                        static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
+                        static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), { 0.0f, 0.0f } };
+#else
+                    *it_vertex++ = { convert(prev.position), curr.height, curr.width, curr.feedrate, prev.actual_feedrate,
+                        curr.mm3_per_mm, curr.fan_speed, curr.temperature, convert(curr.extrusion_role), curr_type,
+                        static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
+                        static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), { 0.0f, 0.0f } };
+#endif // VGCODE_ENABLE_COG_AND_TOOL_MARKERS
+                }
+
+#if VGCODE_ENABLE_COG_AND_TOOL_MARKERS
+                *it_vertex++ = { convert(curr.position), curr.height, curr.width, curr.feedrate, curr.actual_feedrate,
+                    curr.mm3_per_mm, curr.fan_speed, curr.temperature,
+                    result.filament_densities[curr.extruder_id] * curr.mm3_per_mm * (curr.position - prev.position).norm(),
+                    convert(curr.extrusion_role), curr_type, static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
+                    static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), curr.time };
+#else
+                *it_vertex++ = { convert(curr.position), curr.height, curr.width, curr.feedrate, curr.actual_feedrate,
+                    curr.mm3_per_mm, curr.fan_speed, curr.temperature, convert(curr.extrusion_role), curr_type,
+                    static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
+                    static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), curr.time };
+#endif // VGCODE_ENABLE_COG_AND_TOOL_MARKERS
+                prev = curr;
+            }
+            assert(it_vertex == vertices.begin() + offsets[chunk + 1]);
+        }
+    });
+}
+
 GCodeInputData convert(const Slic3r::GCodeProcessorResult& result, const std::vector<std::string>& str_tool_colors,
     const std::vector<std::string>& str_color_print_colors, const Viewer& viewer)
 {
@@ -191,48 +279,10 @@ GCodeInputData convert(const Slic3r::GCodeProcessorResult& result, const std::ve
         ret.color_print_colors.emplace_back(convert(color));
     }
 
-    const std::vector<Slic3r::GCodeProcessorResult::MoveVertex>& moves = result.moves;
-    ret.vertices.reserve(2 * moves.size());
-    for (size_t i = 1; i < moves.size(); ++i) {
-        const Slic3r::GCodeProcessorResult::MoveVertex& curr = moves[i];
-        const Slic3r::GCodeProcessorResult::MoveVertex& prev = moves[i - 1];
-        const EMoveType curr_type = convert(curr.type);
-        const EOptionType option_type = move_type_to_option(curr_type);
-        if (option_type == EOptionType::COUNT || option_type == EOptionType::Travels || option_type == EOptionType::Wipes) {
-            if (ret.vertices.empty() || prev.type != curr.type || prev.extrusion_role != curr.extrusion_role) {
-                // to allow libvgcode to properly detect the start/end of a path we need to add a 'phantom' vertex
-                // equal to the current one with the exception of the position, which should match the previous move position,
-                // and the times, which are set to zero
-#if VGCODE_ENABLE_COG_AND_TOOL_MARKERS
-                const libvgcode::PathVertex vertex = { convert(prev.position), curr.height, curr.width, curr.feedrate, prev.actual_feedrate,
-                    curr.mm3_per_mm, curr.fan_speed, curr.temperature, 0.0f, convert(curr.extrusion_role), curr_type,
-                    static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
-                    static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), { 0.0f, 0.0f } };
-#else
-              const libvgcode::PathVertex vertex = { convert(prev.position), curr.height, curr.width, curr.feedrate, prev.actual_feedrate,
-                    curr.mm3_per_mm, curr.fan_speed, curr.temperature, convert(curr.extrusion_role), curr_type,
-                    static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
-                    static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), { 0.0f, 0.0f } };
-#endif // VGCODE_ENABLE_COG_AND_TOOL_MARKERS
-                ret.vertices.emplace_back(vertex);
-            }
-        }
-
-#if VGCODE_ENABLE_COG_AND_TOOL_MARKERS
-        const libvgcode::PathVertex vertex = { convert(curr.position), curr.height, curr.width, curr.feedrate, curr.actual_feedrate,
-            curr.mm3_per_mm, curr.fan_speed, curr.temperature,
-            result.filament_densities[curr.extruder_id] * curr.mm3_per_mm * (curr.position - prev.position).norm(),
-            convert(curr.extrusion_role), curr_type, static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
-            static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), curr.time };
-#else
-        const libvgcode::PathVertex vertex = { convert(curr.position), curr.height, curr.width, curr.feedrate, curr.actual_feedrate,
-            curr.mm3_per_mm, curr.fan_speed, curr.temperature, convert(curr.extrusion_role), curr_type,
-            static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
-            static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), curr.time };
-#endif // VGCODE_ENABLE_COG_AND_TOOL_MARKERS
-        ret.vertices.emplace_back(vertex);
-    }
-    ret.vertices.shrink_to_fit();
+    if (result.compacted_moves.empty())
+        convert_moves(result.moves, result, ret.vertices);
+    else
+        convert_moves(result.compacted_moves, result, ret.vertices);
 
     ret.spiral_vase_mode = result.spiral_vase_mode;
 
@@ -506,6 +506,7 @@ void MainFrame::shutdown()
 
     if (m_plater != nullptr) {
         m_plater->get_ui_job_worker().cancel_all();
+        m_plater->get_emboss_job_worker().cancel_all();
 
         // Unbinding of wxWidgets event handling in canvases needs to be done here because on MAC,
         // when closing the application using Command+Q, a mouse event is triggered after this lambda is completed,
@@ -61,6 +61,7 @@ void MeshClipper::set_mesh(const indexed_triangle_set& mesh)
     if (m_mesh.get() != &mesh) {
         m_mesh = &mesh;
         m_result.reset();
+        m_sections.clear();
     }
 }
 
@@ -69,6 +70,7 @@ void MeshClipper::set_mesh(AnyPtr<const indexed_triangle_set> &&ptr)
     if (m_mesh.get() != ptr.get()) {
         m_mesh = std::move(ptr);
         m_result.reset();
+        m_sections.clear();
     }
 }
 
@@ -77,6 +79,7 @@ void MeshClipper::set_negative_mesh(const indexed_triangle_set& mesh)
     if (m_negative_mesh.get() != &mesh) {
         m_negative_mesh = &mesh;
         m_result.reset();
+        m_sections.clear();
     }
 }
 
@@ -85,6 +88,7 @@ void MeshClipper::set_negative_mesh(AnyPtr<const indexed_triangle_set> &&ptr)
     if (m_negative_mesh.get() != ptr.get()) {
         m_negative_mesh = std::move(ptr);
         m_result.reset();
+        m_sections.clear();
     }
 }
 
@@ -218,13 +222,18 @@ std::vector<Vec3d> MeshClipper::point_per_contour() const
 }
 
 
-void MeshClipper::recalculate_triangles()
+const ExPolygons& MeshClipper::get_section(const Vec3d& up, float height_mesh)
 {
-    m_result = ClipResult();
-
-    auto plane_mesh = Eigen::Hyperplane<double, 3>(m_plane.get_normal(), -m_plane.distance(Vec3d::Zero())).transform(m_trafo.get_matrix().inverse());
-    const Vec3d up = plane_mesh.normal();
-    const float height_mesh = -plane_mesh.offset();
+    auto it = std::find_if(m_sections.begin(), m_sections.end(),
+        [&up, height_mesh](const Section& section) { return section.height_mesh == height_mesh && section.up.isApprox(up, EPSILON); });
+    if (it != m_sections.end()) {
+        if (it != m_sections.begin()) {
+            Section section = std::move(*it);
+            m_sections.erase(it);
+            m_sections.emplace_front(std::move(section));
+        }
+        return m_sections.front().expolys;
+    }
 
     // Now do the cutting
     MeshSlicingParams slicing_params;
@@ -244,6 +253,22 @@ void MeshClipper::recalculate_triangles()
         expolys = std::move(csg::slice_csgmesh_ex(range(m_csgmesh), {height_mesh}, MeshSlicingParamsEx{slicing_params}).front());
     }
 
+    m_sections.push_front({ up, height_mesh, std::move(expolys) });
+    if (m_sections.size() > MaxCachedSections)
+        m_sections.pop_back();
+    return m_sections.front().expolys;
+}
+
+void MeshClipper::recalculate_triangles()
+{
+    m_result = ClipResult();
+
+    auto plane_mesh = Eigen::Hyperplane<double, 3>(m_plane.get_normal(), -m_plane.distance(Vec3d::Zero())).transform(m_trafo.get_matrix().inverse());
+    const Vec3d up = plane_mesh.normal();
+    const float height_mesh = -plane_mesh.offset();
+
+    ExPolygons expolys = get_section(up, height_mesh);
+
 
     // Triangulate and rotate the cut into world coords:
     Eigen::Quaterniond q;
@@ -537,23 +562,27 @@ bool MeshRaycaster::closest_hit(const Vec2d& mouse_pos, const Transform3d& trafo
     Vec3d point;
     Vec3d direction;
     line_from_mouse_pos(mouse_pos, trafo, camera, point, direction);
+    direction.normalize();
 
-    const std::vector<AABBMesh::hit_result> hits = m_emesh.query_ray_hits(point, direction.normalized());
-
-    if (hits.empty())
+    // This is called for each raycaster on every mouse move. Querying the closest hit only lets the AABB tree
+    // traversal prune the boxes behind the current hit, all hits along the ray are only needed
+    // if the closest one is cut by the clipping plane.
+    AABBMesh::hit_result hit = m_emesh.query_ray_hit(point, direction);
+    if (!hit.is_hit())
         return false; // no intersection found
 
-    size_t hit_id = 0;
-    if (clipping_plane != nullptr) {
+    if (clipping_plane != nullptr && clipping_plane->is_point_clipped(trafo * hit.position())) {
+        const std::vector<AABBMesh::hit_result> hits = m_emesh.query_ray_hits(point, direction);
+        size_t hit_id = 0;
         while (hit_id < hits.size() && clipping_plane->is_point_clipped(trafo * hits[hit_id].position())) {
             ++hit_id;
         }
-    }
 
-    if (hit_id == hits.size())
-        return false; // all points are obscured or cut by the clipping plane.
+        if (hit_id == hits.size())
+            return false; // all points are obscured or cut by the clipping plane.
 
-    const AABBMesh::hit_result& hit = hits[hit_id];
+        hit = hits[hit_id];
+    }
 
     position = hit.position().cast<float>();
     normal = hit.normal().cast<float>();
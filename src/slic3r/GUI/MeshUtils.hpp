@@ -18,6 +18,7 @@
 #include <cfloat>
 #include <optional>
 #include <memory>
+#include <deque>
 
 namespace Slic3r {
 namespace GUI {
@@ -110,6 +111,7 @@ public:
                 csg::copy_csgrange_shallow(csgrange, std::back_inserter(m_csgmesh));
 
             m_result.reset();
+            m_sections.clear();
         }
     }
 
@@ -130,6 +132,9 @@ public:
 
 private:
     void recalculate_triangles();
+    // Cut of the meshes by the plane given in mesh coordinates, the negative mesh subtracted.
+    // Returned from the cache of the recent sections if possible.
+    const ExPolygons& get_section(const Vec3d& up, float height_mesh);
 
     Geometry::Transformation m_trafo;
     AnyPtr<const indexed_triangle_set> m_mesh;
@@ -152,6 +157,18 @@ private:
         Transform3d trafo; // this rotates the cut into world coords
     };
     std::optional<ClipResult> m_result;
+
+    // The recent sections, the most recent first. The section only depends on the meshes and the plane in mesh coordinates,
+    // thus it is reused when only the limiting plane, the behaviour or the transformation of the clipping plane together
+    // with the mesh change, or when the clipping plane returns to a recent position. Cleared when the meshes change.
+    struct Section {
+        Vec3d up;
+        float height_mesh;
+        ExPolygons expolys;
+    };
+    static constexpr const size_t MaxCachedSections = 8;
+    std::deque<Section> m_sections;
+
     bool m_fill_cut = true;
     double m_contour_width = 0.;
 };
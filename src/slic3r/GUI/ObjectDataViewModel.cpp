@@ -414,6 +414,7 @@ wxDataViewItem ObjectDataViewModel::AddObject(const wxString &name,
     UpdateBitmapForNode(root, warning_icon_name, has_lock);
 
     m_objects.push_back(root);
+    m_objects_idxs[root] = m_objects.size() - 1;
 	// notify control
 	wxDataViewItem child((void*)root);
 	wxDataViewItem parent((void*)NULL);
@@ -799,8 +800,7 @@ wxDataViewItem ObjectDataViewModel::Delete(const wxDataViewItem &item)
             ItemDeleted(parent, wxDataViewItem(last_child_node));
 
             wxCommandEvent event(wxCUSTOMEVT_LAST_VOLUME_IS_DELETED);
-            auto it = find(m_objects.begin(), m_objects.end(), node_parent);
-            event.SetInt(it == m_objects.end() ? -1 : it - m_objects.begin());
+            event.SetInt(GetObjectIdx(node_parent));
             wxPostEvent(m_ctrl, event);
 
             return parent;
@@ -808,9 +808,9 @@ wxDataViewItem ObjectDataViewModel::Delete(const wxDataViewItem &item)
 	}
 	else
 	{
-		auto it = find(m_objects.begin(), m_objects.end(), node);
-        size_t id = it - m_objects.begin();
-		if (it != m_objects.end())
+        const int obj_idx = GetObjectIdx(node);
+        size_t id = obj_idx < 0 ? m_objects.size() : size_t(obj_idx);
+		if (obj_idx >= 0)
 		{
             // Delete all sub-items
             int i = m_objects[id]->GetChildCount() - 1;
@@ -818,7 +818,9 @@ wxDataViewItem ObjectDataViewModel::Delete(const wxDataViewItem &item)
                 Delete(wxDataViewItem(m_objects[id]->GetNthChild(i)));
                 i = m_objects[id]->GetChildCount() - 1;
             }
-			m_objects.erase(it);
+			m_objects.erase(m_objects.begin() + id);
+            // Indices of the following objects are rebuilt lazily.
+            m_objects_idxs.erase(node);
         }
 		if (id > 0) { 
 			if(id == m_objects.size()) id--;
@@ -1072,12 +1074,25 @@ int ObjectDataViewModel::GetIdByItem(const wxDataViewItem& item) const
 	if(!item.IsOk())
         return -1;
 
-	ObjectDataViewModelNode *node = static_cast<ObjectDataViewModelNode*>(item.GetID());
-	auto it = find(m_objects.begin(), m_objects.end(), node);
-	if (it == m_objects.end())
-		return -1;
+	return GetObjectIdx(static_cast<ObjectDataViewModelNode*>(item.GetID()));
+}
 
-	return it - m_objects.begin();
+int ObjectDataViewModel::GetObjectIdx(const ObjectDataViewModelNode* node) const
+{
+    auto is_valid = [this, node](auto it) { return it != m_objects_idxs.end() && it->second < m_objects.size() && m_objects[it->second] == node; };
+    auto it = m_objects_idxs.find(node);
+    if (! is_valid(it)) {
+        // Only object nodes are indexed, don't rebuild the index for the other nodes.
+        if (node == nullptr || node->GetType() != itObject)
+            return -1;
+        m_objects_idxs.clear();
+        for (size_t i = 0; i < m_objects.size(); ++ i)
+            m_objects_idxs.emplace(m_objects[i], i);
+        it = m_objects_idxs.find(node);
+        if (! is_valid(it))
+            return -1;
+    }
+    return int(it->second);
 }
 
 int ObjectDataViewModel::GetIdByItemAndType(const wxDataViewItem& item, const ItemType type) const
@@ -1205,10 +1220,8 @@ void ObjectDataViewModel::GetItemInfo(const wxDataViewItem& item, ItemType& type
     while (parent_node->m_type != itObject)
         parent_node = parent_node->GetParent();
 
-    auto it = find(m_objects.begin(), m_objects.end(), parent_node);
-    if (it != m_objects.end())
-        obj_idx = it - m_objects.begin();
-    else
+    obj_idx = GetObjectIdx(parent_node);
+    if (obj_idx < 0)
         type = itUndef;
 }
 
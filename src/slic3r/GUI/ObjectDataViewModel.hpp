@@ -8,6 +8,7 @@
 #include <wx/dataview.h>
 #include <vector>
 #include <map>
+#include <unordered_map>
 
 #include "ExtraRenderers.hpp"
 
@@ -270,6 +271,9 @@ wxDECLARE_EVENT(wxCUSTOMEVT_LAST_VOLUME_IS_DELETED, wxCommandEvent);
 class ObjectDataViewModel :public wxDataViewModel
 {
     std::vector<ObjectDataViewModelNode*>       m_objects;
+    // Indices of the object nodes into m_objects, so that the index of an object is found without walking m_objects.
+    // An entry is only valid if m_objects holds its node at its index, the index is rebuilt lazily, see GetObjectIdx().
+    mutable std::unordered_map<const ObjectDataViewModelNode*, size_t> m_objects_idxs;
     std::vector<wxBitmapBundle*>                m_volume_bmps;
     std::vector<wxBitmapBundle *>               m_text_volume_bmps;
     std::vector<wxBitmapBundle *>               m_svg_volume_bmps;
@@ -420,6 +424,8 @@ private:
     wxDataViewItem  AddRoot(const wxDataViewItem& parent_item, const ItemType root_type);
     wxDataViewItem  AddInstanceRoot(const wxDataViewItem& parent_item);
     void            AddAllChildren(const wxDataViewItem& parent);
+    // Index of the object node in m_objects, -1 if the node is not an object node of this model.
+    int             GetObjectIdx(const ObjectDataViewModelNode* node) const;
 
     void            UpdateBitmapForNode(ObjectDataViewModelNode* node);
     void            UpdateBitmapForNode(ObjectDataViewModelNode* node, const std::string& warning_icon_name, bool has_lock);
@@ -27,6 +27,8 @@
 #include <string>
 #include <regex>
 #include <future>
+#include <atomic>
+#include <chrono>
 #include <boost/algorithm/string.hpp>
 #include <boost/nowide/cstdio.hpp>
 #include <boost/optional.hpp>
@@ -38,6 +40,9 @@
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include <wx/sizer.h>
 #include <wx/stattext.h>
 #include <wx/button.h>
@@ -161,6 +166,8 @@ wxDEFINE_EVENT(EVT_SLICING_COMPLETED,               wxCommandEvent);
 // BackgroundSlicingProcess finished either with success or error.
 wxDEFINE_EVENT(EVT_PROCESS_COMPLETED,               SlicingProcessCompletedEvent);
 wxDEFINE_EVENT(EVT_EXPORT_BEGAN,                    wxCommandEvent);
+// A snapshot of the G-code preview data of the layers exported so far is available, see BackgroundSlicingProcess::get_partial_gcode_result().
+wxDEFINE_EVENT(EVT_PARTIAL_GCODE_RESULT,            wxCommandEvent);
 
 // Plater::DropTarget
 
@@ -290,6 +297,7 @@ struct Plater::priv
     // UIThreadWorker can be used as a replacement for BoostThreadWorker if
     // no additional worker threads are desired (useful for debugging or profiling)
     PlaterWorker<BoostThreadWorker> m_worker;
+    PlaterWorker<BoostThreadWorker> m_emboss_worker;
     SLAImportDialog *               m_sla_import_dlg;
 
     bool                        delayed_scene_refresh;
@@ -459,6 +467,10 @@ struct Plater::priv
     void process_validation_warning(const std::vector<std::string>& warning) const;
 
     bool background_processing_enabled() const { return this->get_config_bool("background_processing"); }
+    // Pre-compute the object steps in the background while the background processing is disabled,
+    // so that "Slice now" only has to finish the print steps and to export the G-code.
+    bool speculative_slicing_enabled() const
+        { return this->printer_technology == ptFFF && ! background_processing_enabled() && this->get_config_bool("speculative_slicing"); }
     void update_print_volume_state();
     void schedule_background_process();
     // Update background processing thread from the current config and Model.
@@ -476,6 +488,9 @@ struct Plater::priv
         UPDATE_BACKGROUND_PROCESS_FORCE_RESTART = 8,
         // Restart for G-code (or SLA zip) export or upload.
         UPDATE_BACKGROUND_PROCESS_FORCE_EXPORT = 16,
+        // The Print was invalidated while the background processing is disabled, but the object steps
+        // may be calculated ahead of "Slice now" (see speculative_slicing_enabled()).
+        UPDATE_BACKGROUND_PROCESS_SPECULATIVE = 32,
     };
     // returns bit mask of UpdateBackgroundProcessReturnState
     unsigned int update_background_process(bool force_validation = false, bool postpone_error_messages = false);
@@ -501,6 +516,7 @@ struct Plater::priv
     void on_slicing_completed(wxCommandEvent&);
     void on_process_completed(SlicingProcessCompletedEvent&);
 	void on_export_began(wxCommandEvent&);
+    void on_partial_gcode_result(wxCommandEvent&);
     void on_layer_editing_toggled(bool enable);
 	void on_slicing_began();
 
@@ -597,6 +613,8 @@ private:
 	// vector of all warnings generated by last slicing
 	std::vector<std::pair<Slic3r::PrintStateBase::Warning, size_t>> current_warnings;
 	bool show_warning_dialog { false };
+	// Set while the background process calculates the object steps ahead of "Slice now".
+	bool speculative_task_running { false };
 	
 };
 
@@ -627,6 +645,7 @@ Plater::priv::priv(Plater *q, MainFrame *main_frame)
     , user_account(std::make_unique<UserAccount>(q, wxGetApp().app_config, wxGetApp().get_instance_hash_string()))
     , preset_archive_database(std::make_unique<PresetArchiveDatabase>(wxGetApp().app_config, q))
     , m_worker{q, std::make_unique<NotificationProgressIndicator>(notification_manager.get()), "ui_worker"}
+    , m_emboss_worker{q, nullptr, "emboss_worker"}
     , m_sla_import_dlg{new SLAImportDialog{q}}
     , delayed_scene_refresh(false)
     , view_toolbar(GLToolbar::Radio, "View")
@@ -640,6 +659,7 @@ Plater::priv::priv(Plater *q, MainFrame *main_frame)
     background_process.set_slicing_completed_event(EVT_SLICING_COMPLETED);
     background_process.set_finished_event(EVT_PROCESS_COMPLETED);
     background_process.set_export_began_event(EVT_EXPORT_BEGAN);
+    background_process.set_partial_gcode_result_event(EVT_PARTIAL_GCODE_RESULT);
     // Default printer technology for default config.
     background_process.select_technology(this->printer_technology);
     // Register progress callback from the Print class to the Plater.
@@ -753,6 +773,7 @@ Plater::priv::priv(Plater *q, MainFrame *main_frame)
         q->Bind(EVT_SLICING_COMPLETED, &priv::on_slicing_completed, this);
         q->Bind(EVT_PROCESS_COMPLETED, &priv::on_process_completed, this);
         q->Bind(EVT_EXPORT_BEGAN, &priv::on_export_began, this);
+        q->Bind(EVT_PARTIAL_GCODE_RESULT, &priv::on_partial_gcode_result, this);
         q->Bind(EVT_GLVIEWTOOLBAR_3D, [q](SimpleEvent&) { q->select_view_3D("3D"); });
         q->Bind(EVT_GLVIEWTOOLBAR_PREVIEW, [q](SimpleEvent&) { q->select_view_3D("Preview"); });
     }
@@ -1223,6 +1244,46 @@ std::vector<size_t> Plater::priv::load_files(const std::vector<fs::path>& input_
     const fs::path temp_path = wxStandardPaths::Get().GetTempDir().utf8_str().data();
 
     size_t input_files_size = input_files.size();
+
+    // The plain geometry files (STL, OBJ) are parsed concurrently by worker threads first, the loop below then processes
+    // the parsed models in the order of the input files. The other formats are loaded by the loop, as loading them
+    // interacts with the user and with the presets.
+    std::vector<std::optional<Model>>  preloaded_models(input_files_size);
+    std::vector<std::exception_ptr>    preload_errors(input_files_size);
+    {
+        std::vector<size_t> preload_idxs;
+        for (size_t i = 0; i < input_files_size; ++i) {
+            const std::string path = input_files[i].string();
+            if (boost::algorithm::iends_with(path, ".stl") || boost::algorithm::iends_with(path, ".obj"))
+                preload_idxs.emplace_back(i);
+        }
+        if (preload_idxs.size() > 1) {
+            std::atomic<size_t> preloaded_cnt{ 0 };
+            std::future<void> preloading = std::async(std::launch::async, [&]() {
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, preload_idxs.size(), 1), [&](const tbb::blocked_range<size_t>& range) {
+                    for (size_t j = range.begin(); j < range.end(); ++j) {
+                        const size_t i = preload_idxs[j];
+                        fs::path path = input_files[i];
+#ifdef _WIN32
+                        path.make_preferred();
+#endif // _WIN32
+                        try {
+                            preloaded_models[i].emplace(Slic3r::Model::read_from_file(path.string(), nullptr, nullptr, only_if(load_config, Model::LoadAttribute::CheckVersion)));
+                        } catch (...) {
+                            preload_errors[i] = std::current_exception();
+                        }
+                        ++ preloaded_cnt;
+                    }
+                });
+            });
+            while (preloading.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready)
+                if (progress_dlg)
+                    progress_dlg->Update(static_cast<int>(100.0f * static_cast<float>(preloaded_cnt) / static_cast<float>(preload_idxs.size())),
+                        _L("Loading files") + dots);
+            preloading.get();
+        }
+    }
+
     for (size_t i = 0; i < input_files_size; ++i) {
 #ifdef _WIN32
         auto path = input_files[i];
@@ -1343,7 +1404,13 @@ std::vector<size_t> Plater::priv::load_files(const std::vector<fs::path>& input_
                 }
             }
             else {
-                model = Slic3r::Model::read_from_file(path.string(), nullptr, nullptr, only_if(load_config, Model::LoadAttribute::CheckVersion));
+                if (preload_errors[i])
+                    std::rethrow_exception(preload_errors[i]);
+                if (preloaded_models[i]) {
+                    model = std::move(*preloaded_models[i]);
+                    preloaded_models[i].reset();
+                } else
+                    model = Slic3r::Model::read_from_file(path.string(), nullptr, nullptr, only_if(load_config, Model::LoadAttribute::CheckVersion));
                 for (auto obj : model.objects)
                     if (obj->name.empty())
                         obj->name = fs::path(obj->input_file).filename().string();
@@ -1855,6 +1922,7 @@ void Plater::priv::remove(size_t obj_idx)
         view3D->enable_layers_editing(false);
 
     m_worker.cancel_all();
+    m_emboss_worker.cancel_all();
     model.delete_object(obj_idx);
     update();
     // Delete object from Sidebar list. Do it after update, so that the GLScene selection is updated with the modified model.
@@ -1884,6 +1952,7 @@ bool Plater::priv::delete_object_from_model(size_t obj_idx)
         snapshot_label += ": " + wxString::FromUTF8(obj->name.c_str());
     Plater::TakeSnapshot snapshot(q, snapshot_label);
     m_worker.cancel_all();
+    m_emboss_worker.cancel_all();
 
     if (obj->is_cut())
         sidebar->obj_list()->invalidate_cut_info_for_object(obj_idx);
@@ -1910,6 +1979,7 @@ void Plater::priv::delete_all_objects_from_model()
     view3D->get_canvas3d()->reset_all_gizmos();
 
     m_worker.cancel_all();
+    m_emboss_worker.cancel_all();
 
     // Stop and reset the Print content.
     background_process.reset();
@@ -1942,6 +2012,7 @@ void Plater::priv::reset()
     view3D->get_canvas3d()->reset_sequential_print_clearance();
 
     m_worker.cancel_all();
+    m_emboss_worker.cancel_all();
 
     // Stop and reset the Print content.
     this->background_process.reset();
@@ -2154,8 +2225,12 @@ unsigned int Plater::priv::update_background_process(bool force_validation, bool
         if (err.empty()) {
 			notification_manager->set_all_slicing_errors_gray(true);
             notification_manager->close_notification_of_type(NotificationType::ValidateError);
-            if (invalidated != Print::APPLY_STATUS_UNCHANGED && background_processing_enabled())
-                return_state |= UPDATE_BACKGROUND_PROCESS_RESTART;
+            if (invalidated != Print::APPLY_STATUS_UNCHANGED) {
+                if (background_processing_enabled())
+                    return_state |= UPDATE_BACKGROUND_PROCESS_RESTART;
+                else if (speculative_slicing_enabled())
+                    return_state |= UPDATE_BACKGROUND_PROCESS_SPECULATIVE;
+            }
 
             // Pass a warning from validation and either show a notification,
             // or hide the old one.
@@ -2216,7 +2291,7 @@ unsigned int Plater::priv::update_background_process(bool force_validation, bool
 	} 
 
     if (invalidated != Print::APPLY_STATUS_UNCHANGED && was_running && ! this->background_process.running() &&
-        (return_state & UPDATE_BACKGROUND_PROCESS_RESTART) == 0) {
+        (return_state & (UPDATE_BACKGROUND_PROCESS_RESTART | UPDATE_BACKGROUND_PROCESS_SPECULATIVE)) == 0) {
         // The background processing was killed and it will not be restarted.
         // Post the "canceled" callback message, so that it will be processed after any possible pending status bar update messages.
         wxQueueEvent(GUI::wxGetApp().mainframe->m_plater, new SlicingProcessCompletedEvent(EVT_PROCESS_COMPLETED, 0, SlicingProcessCompletedEvent::Cancelled, std::exception_ptr{}));
@@ -2266,17 +2341,32 @@ bool Plater::priv::restart_background_process(unsigned int state)
         return false;
     }
 
-    if ( ! this->background_process.empty() &&
-         (state & priv::UPDATE_BACKGROUND_PROCESS_INVALID) == 0 &&
-         ( ((state & UPDATE_BACKGROUND_PROCESS_FORCE_RESTART) != 0 && ! this->background_process.finished()) ||
-           (state & UPDATE_BACKGROUND_PROCESS_FORCE_EXPORT) != 0 ||
-           (state & UPDATE_BACKGROUND_PROCESS_RESTART) != 0 ) ) {
+    if (this->background_process.empty() || (state & priv::UPDATE_BACKGROUND_PROCESS_INVALID) != 0)
+        return false;
+
+    if ( ((state & UPDATE_BACKGROUND_PROCESS_FORCE_RESTART) != 0 && ! this->background_process.finished()) ||
+         (state & UPDATE_BACKGROUND_PROCESS_FORCE_EXPORT) != 0 ||
+         (state & UPDATE_BACKGROUND_PROCESS_RESTART) != 0 ) {
+        // The caller has reset the task, thus a speculative task possibly still running now computes the whole print.
+        this->speculative_task_running = false;
         // The print is valid and it can be started.
         if (this->background_process.start()) {
 			if (!show_warning_dialog)
 				on_slicing_began();
             return true;
         }
+    } else if ((state & UPDATE_BACKGROUND_PROCESS_SPECULATIVE) != 0 && ! this->background_process.running()) {
+        // Calculate all the object steps, but neither the print steps nor the G-code export.
+        // The results are kept by the Print and reused once the user asks for slicing.
+        PrintBase::TaskParams task;
+        task.to_object_step = int(posCount) - 1;
+        this->background_process.set_task(task);
+        if (this->background_process.start()) {
+            this->speculative_task_running = true;
+            return true;
+        }
+        // Nothing was started, enable all the steps again.
+        this->background_process.set_task(PrintBase::TaskParams());
     }
     return false;
 }
@@ -2871,7 +2961,7 @@ void Plater::priv::set_current_panel(wxPanel* panel)
 
 void Plater::priv::on_slicing_update(SlicingStatusEvent &evt)
 {
-    if (evt.status.percent >= -1) {
+    if (evt.status.percent >= -1 && ! this->speculative_task_running) {
         if (!m_worker.is_idle()) {
             // Avoid a race condition
             return;
@@ -2983,6 +3073,12 @@ void Plater::priv::on_export_began(wxCommandEvent& evt)
 	if (show_warning_dialog)
 		warnings_dialog();  
 }
+void Plater::priv::on_partial_gcode_result(wxCommandEvent&)
+{
+    // The snapshot may be already outdated if the G-code export finished or the print was invalidated.
+    if (this->printer_technology == ptFFF && !view3D->is_dragging() && background_process.get_partial_gcode_result() != nullptr)
+        preview->reload_partial_gcode_preview();
+}
 void Plater::priv::on_slicing_began()
 {
 	clear_warnings();
@@ -3060,6 +3156,19 @@ void Plater::priv::on_process_completed(SlicingProcessCompletedEvent &evt)
     // At this point of time the thread should be either finished or canceled,
     // so the following call just confirms, that the produced data were consumed.
     this->background_process.stop();
+
+    if (this->speculative_task_running) {
+        // The object steps were calculated ahead of "Slice now". Keep quiet: errors and warnings
+        // will be reported once the user asks for slicing, as the failed steps are calculated again.
+        this->speculative_task_running = false;
+        if (view3D->is_dragging())
+            delayed_scene_refresh = true;
+        else
+            this->update_fff_scene();
+        show_action_buttons(true);
+        return;
+    }
+
     notification_manager->set_slicing_progress_export_possible();
 
     // Reset the "export G-code path" name, so that the automatic background processing will be enabled again.
@@ -4206,20 +4315,29 @@ void Plater::load_gcode(const wxString& filename)
 
     // process gcode
     GCodeProcessor processor;
-    try
-    {
-        p->notification_manager->push_download_progress_notification("Loading...", []() { return false; });
-        processor.process_file(filename.ToUTF8().data(), [this](float value) {
-            p->notification_manager->set_download_progress_percentage(value);
-            p->get_current_canvas3D()->render();
-        });
-    }
-    catch (const std::exception& ex)
-    {
-        show_error(this, ex.what());
-        return;
+    const std::string gcode_filename = into_u8(filename);
+    const bool use_preview_cache = wxGetApp().app_config->get_bool("gcode_preview_cache");
+    // Reuse the result of a previous processing of the same unchanged file, if available.
+    const bool loaded_from_cache = use_preview_cache && processor.load_result_cache(gcode_filename);
+    if (! loaded_from_cache) {
+        try
+        {
+            p->notification_manager->push_download_progress_notification("Loading...", []() { return false; });
+            processor.process_file(gcode_filename, [this](float value) {
+                p->notification_manager->set_download_progress_percentage(value);
+                p->get_current_canvas3D()->render();
+            });
+        }
+        catch (const std::exception& ex)
+        {
+            show_error(this, ex.what());
+            return;
+        }
     }
     p->gcode_result = std::move(processor.extract_result());
+    p->gcode_result.compact_moves();
+    if (use_preview_cache && ! loaded_from_cache)
+        GCodeProcessor::save_result_cache(p->gcode_result, gcode_filename);
 
     // show results
     try
@@ -5085,6 +5203,8 @@ Worker &Plater::get_ui_job_worker() { return p->m_worker; }
 
 const Worker &Plater::get_ui_job_worker() const { return p->m_worker; }
 
+Worker &Plater::get_emboss_job_worker() { return p->m_emboss_worker; }
+
 void Plater::update_ui_from_settings() { p->update_ui_from_settings(); }
 
 void Plater::select_view(const std::string& direction) { p->select_view(direction); }
@@ -5128,6 +5248,7 @@ void Plater::remove_selected()
 
     Plater::TakeSnapshot snapshot(this, _L("Delete Selected Objects"));
     get_ui_job_worker().cancel_all();
+    get_emboss_job_worker().cancel_all();
     p->view3D->delete_selected();
 }
 
@@ -5934,7 +6055,7 @@ void Plater::reslice()
     // Stop the running (and queued) UI jobs and only proceed if they actually
     // get stopped.
     unsigned timeout_ms = 10000;
-    if (!stop_queue(this->get_ui_job_worker(), timeout_ms)) {
+    if (!stop_queue(this->get_ui_job_worker(), timeout_ms) || !stop_queue(this->get_emboss_job_worker(), timeout_ms)) {
         BOOST_LOG_TRIVIAL(error) << "Could not stop UI job within "
                                  << timeout_ms << " milliseconds timeout!";
         return;
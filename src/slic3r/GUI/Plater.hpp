@@ -162,6 +162,11 @@ public:
     // pending jobs.
     Worker& get_ui_job_worker();
     const Worker & get_ui_job_worker() const;
+    // Get the worker handling the jobs of the emboss and SVG gizmos (text and SVG volumes, font previews).
+    // The jobs run next to the jobs of get_ui_job_worker(), so that e.g. a long running rotation optimization
+    // does not block the preview of an embossed text. The finalization of the jobs of both workers runs
+    // on the UI thread, one job at a time.
+    Worker& get_emboss_job_worker();
 
     void select_view(const std::string& direction);
     void select_view_3D(const std::string& name);
@@ -312,6 +312,13 @@ void PreferencesDialog::build()
 				"as they\'re loaded in order to save time when exporting G-code."),
 			app_config->get_bool("background_processing"));
 
+		append_bool_option(m_optgroup_general, "speculative_slicing", 
+			L("Speculative slicing"),
+			L("If this is enabled and the background processing is disabled, Slic3r will slice the objects "
+				"and generate their perimeters, infill and supports while idle. G-code is only exported "
+				"after \"Slice now\" is pressed, which then finishes faster."),
+			app_config->get_bool("speculative_slicing"));
+
 		append_bool_option(m_optgroup_general, "alert_when_supports_needed", 
 			L("Alert when supports needed"),
 			L("If this is enabled, Slic3r will raise alerts when it detects "
@@ -447,6 +454,12 @@ void PreferencesDialog::build()
 		L("If enabled, PrusaSlicer will be open at the position it was closed"),
 		app_config->get_bool("restore_win_position"));
 
+	append_bool_option(m_optgroup_general, "gcode_preview_cache",
+		L("Cache processed G-code previews"),
+		L("If enabled, the result of processing a G-code file loaded into the G-code viewer is saved next to it into a .preview_cache file, "
+		  "which makes loading the same unchanged file again faster."),
+		app_config->get_bool("gcode_preview_cache"));
+
     // Clear Undo / Redo stack on new project
 	append_bool_option(m_optgroup_general, "clear_undo_redo_stack_on_new_project",
 		L("Clear Undo / Redo stack on new project"),
@@ -210,7 +210,7 @@ void add_authorization_header(Http& http)
 
 }
 
-bool OnlineArchiveRepository::get_file_inner(const std::string& url, const fs::path& target_path) const
+bool OnlineArchiveRepository::get_file_inner(const std::string& url, const fs::path& target_path, bool only_if_modified) const
 {
 
 	bool res = false;
@@ -223,6 +223,12 @@ bool OnlineArchiveRepository::get_file_inner(const std::string& url, const fs::p
 
 	auto http = Http::get(url);
     add_authorization_header(http);
+	boost::system::error_code ec;
+	if (only_if_modified && fs::exists(target_path, ec)) {
+		// The target was downloaded from the same url before. Let the server respond with 304 if it did not change since.
+		if (const std::time_t last_write_time = fs::last_write_time(target_path, ec); !ec)
+			http.if_modified_since(last_write_time);
+	}
     http
 		.timeout_max(30)
 		.on_progress([](Http::Progress, bool& cancel) {
@@ -234,7 +240,12 @@ bool OnlineArchiveRepository::get_file_inner(const std::string& url, const fs::p
 				http_status,
 				body);
 		})
-		.on_complete([&](std::string body, unsigned /* http_status */) {
+		.on_complete([&](std::string body, unsigned http_status) {
+			if (http_status == 304) {
+				BOOST_LOG_TRIVIAL(info) << format("Not modified: `%1%`", url);
+				res = true;
+				return;
+			}
 			if (body.empty()) {
 				return;
 			}
@@ -251,7 +262,7 @@ bool OnlineArchiveRepository::get_file_inner(const std::string& url, const fs::p
 
 bool OnlineArchiveRepository::get_archive(const fs::path& target_path) const
 {
-	return get_file_inner(m_data.index_url.empty() ? m_data.url + "vendor_indices.zip" : m_data.index_url, target_path);
+	return get_file_inner(m_data.index_url.empty() ? m_data.url + "vendor_indices.zip" : m_data.index_url, target_path, true);
 }
 
 bool OnlineArchiveRepository::get_file(const std::string& source_subpath, const fs::path& target_path, const std::string& repository_id) const
@@ -111,7 +111,8 @@ public:
 	// Should be used only if no previous ini file exists.
 	bool get_ini_no_id(const std::string& source_subpath, const boost::filesystem::path& target_path) const override;
 private:
-	bool get_file_inner(const std::string& url, const boost::filesystem::path& target_path) const;
+	// If only_if_modified, an existing target_path is kept if the resource did not change since the target_path was written.
+	bool get_file_inner(const std::string& url, const boost::filesystem::path& target_path, bool only_if_modified = false) const;
 };
 
 class LocalArchiveRepository : public ArchiveRepository
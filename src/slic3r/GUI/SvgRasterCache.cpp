@@ -0,0 +1,125 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#include "SvgRasterCache.hpp"
+
+#include "libslic3r/Utils.hpp"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include <qoi.h>
+
+namespace Slic3r {
+namespace GUI {
+namespace SvgRasterCache {
+
+// Bump to invalidate the caches of the older versions, for example once the rasterization changes.
+static constexpr const char *CacheVersion = "1";
+
+static boost::filesystem::path cache_dir()
+{
+    return boost::filesystem::path(data_dir()) / "cache" / "icons";
+}
+
+static boost::filesystem::path cache_file(const std::string &key)
+{
+    return cache_dir() / (key + ".qoi");
+}
+
+// 64bit FNV-1a, stable across the platforms and the runs unlike std::hash.
+static uint64_t fnv1a(const std::string &data, uint64_t hash = 0xcbf29ce484222325ull)
+{
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+std::string key(const std::string &svg_data, const std::string &params)
+{
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%016" PRIx64 "-%016" PRIx64, fnv1a(svg_data), fnv1a(std::string(CacheVersion) + ";" + params));
+    return buf;
+}
+
+bool load(const std::string &key, Image &image)
+{
+    if (data_dir().empty())
+        return false;
+
+    std::string encoded;
+    {
+        boost::nowide::ifstream file(cache_file(key).string(), std::ios::binary);
+        if (! file.good())
+            return false;
+        encoded.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    qoi_desc desc;
+    void    *pixels = qoi_decode(encoded.data(), int(encoded.size()), &desc, 4);
+    if (pixels == nullptr) {
+        BOOST_LOG_TRIVIAL(warning) << "Failed to decode the cached icon " << cache_file(key).string();
+        return false;
+    }
+    image.width  = desc.width;
+    image.height = desc.height;
+    image.rgba.assign((const unsigned char*)pixels, (const unsigned char*)pixels + size_t(desc.width) * size_t(desc.height) * 4);
+    ::free(pixels);
+    return true;
+}
+
+void save(const std::string &key, const Image &image)
+{
+    if (data_dir().empty() || image.width == 0 || image.height == 0)
+        return;
+
+    qoi_desc desc;
+    desc.width      = image.width;
+    desc.height     = image.height;
+    desc.channels   = 4;
+    desc.colorspace = QOI_SRGB;
+    int   size      = 0;
+    void *encoded   = qoi_encode(image.rgba.data(), &desc, &size);
+    if (encoded == nullptr)
+        return;
+    ScopeGuard sg_encoded([encoded]() { ::free(encoded); });
+
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(cache_dir(), ec);
+    if (ec) {
+        BOOST_LOG_TRIVIAL(warning) << "Failed to create the icon cache directory " << cache_dir().string() << ": " << ec.message();
+        return;
+    }
+
+    // Written into a temporary file first, so that a concurrently running instance never reads a partially written icon.
+    const std::string path     = cache_file(key).string();
+    const std::string path_tmp = path + "." + boost::filesystem::unique_path().string();
+    {
+        boost::nowide::ofstream file(path_tmp, std::ios::binary | std::ios::trunc);
+        file.write((const char*)encoded, size);
+        if (! file.good()) {
+            BOOST_LOG_TRIVIAL(warning) << "Failed to write the cached icon " << path_tmp;
+            file.close();
+            boost::filesystem::remove(path_tmp, ec);
+            return;
+        }
+    }
+    if (std::error_code ec_rename = rename_file(path_tmp, path); ec_rename) {
+        BOOST_LOG_TRIVIAL(warning) << "Failed to rename the cached icon " << path_tmp << " to " << path << ": " << ec_rename.message();
+        boost::filesystem::remove(path_tmp, ec);
+    }
+}
+
+} // namespace SvgRasterCache
+} // namespace GUI
+} // namespace Slic3r
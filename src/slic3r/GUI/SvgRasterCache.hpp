@@ -0,0 +1,41 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef slic3r_SvgRasterCache_hpp_
+#define slic3r_SvgRasterCache_hpp_
+
+#include <string>
+#include <vector>
+
+namespace Slic3r {
+namespace GUI {
+
+// Persistent cache of the SVG icons rasterized by NanoSVG, so that the warm starts of the application
+// and the changes of the color scheme skip parsing and rasterizing of the icons.
+// The rasterized icons are stored as QOI images in the "cache/icons" subdirectory of the data directory.
+// An icon is identified by a hash of its SVG source (after the color replacements) and of the parameters
+// of its rasterization, thus a modified icon file or a different size or color scheme is a cache miss.
+namespace SvgRasterCache {
+
+struct Image
+{
+    unsigned                   width  { 0 };
+    unsigned                   height { 0 };
+    // width * height RGBA pixels.
+    std::vector<unsigned char> rgba;
+};
+
+// Key of an icon rasterized from svg_data with the rasterization parameters serialized into params.
+std::string key(const std::string &svg_data, const std::string &params);
+// Returns false if the icon is not cached or if the cache file could not be read.
+bool        load(const std::string &key, Image &image);
+// Failures to write into the cache are only logged.
+void        save(const std::string &key, const Image &image);
+
+} // namespace SvgRasterCache
+
+} // namespace GUI
+} // namespace Slic3r
+
+#endif // slic3r_SvgRasterCache_hpp_
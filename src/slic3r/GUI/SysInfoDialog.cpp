@@ -9,6 +9,7 @@
 #include "../Utils/UndoRedo.hpp"
 #include "Plater.hpp"
 
+#include <algorithm>
 #include <string>
 
 #include <boost/algorithm/string/replace.hpp>
@@ -22,6 +23,7 @@
 #include "wxExtensions.hpp"
 #include "libslic3r/BlacklistedLibraryCheck.hpp"
 #include "libslic3r/Color.hpp"
+#include "libslic3r/MemoryUsage.hpp"
 #include "format.hpp"
 
 #ifdef _WIN32
@@ -91,6 +93,20 @@ std::string get_mem_info(bool format_as_html)
     out << b_start << "RAM size reserved for the Undo / Redo stack: "  << b_end << Slic3r::format_memsize_MB(stack.get_memory_limit()) << line_end;
     out << b_start << "RAM size occupied by the Undo / Redo stack: "  << b_end << Slic3r::format_memsize_MB(stack.memsize()) << line_end << line_end;
 
+    if (MemoryAccounting::enabled()) {
+        // Last sample of each object, taken after its last finished step.
+        std::vector<MemoryUsageRecord> records = wxGetApp().plater()->fff_print().memory_usage_records();
+        for (auto it = records.begin(); it != records.end(); ++ it)
+            if (std::none_of(it + 1, records.end(), [it](const MemoryUsageRecord &r) { return r.object_id == it->object_id; })) {
+                const MemoryUsage &usage = it->usage;
+                out << b_start << "Slicing data of " << it->object_name << " after " << it->step_name << ": " << b_end << Slic3r::format_memsize_MB(usage.total()) <<
+                    " (slices " << Slic3r::format_memsize_MB(usage.slices) << ", fill surfaces " << Slic3r::format_memsize_MB(usage.fill_surfaces) <<
+                    ", intermediate " << Slic3r::format_memsize_MB(usage.intermediate) << ", perimeters " << Slic3r::format_memsize_MB(usage.perimeters) <<
+                    ", fills " << Slic3r::format_memsize_MB(usage.fills) << ", support " << Slic3r::format_memsize_MB(usage.support) << ")" << line_end;
+            }
+        out << line_end;
+    }
+
     return out.str();
 }
 
@@ -922,6 +922,12 @@ void Tab::update_visibility()
 {
     Freeze(); // There is needed Freeze/Thaw to avoid a flashing after Show/Layout
 
+    if (m_active_page && m_active_page->has_deferred_groups(m_mode) && m_page_sizer->GetItemCount() > 0) {
+        // Some option groups of the active page got visible, but their controls were not created yet.
+        // Activate the page again to keep the order of the groups.
+        clear_pages();
+        activate_selected_page([](){});
+    }
     for (auto page : m_pages)
         page->update_visibility(m_mode, page.get() == m_active_page);
     rebuild_page_tree();
@@ -2974,6 +2980,7 @@ void TabPrinter::build_sla()
 
     optgroup = page->new_optgroup(L("Output"));
     optgroup->append_single_option_line("sla_archive_format");
+    optgroup->append_single_option_line("sla_archive_compression_level");
     optgroup->append_single_option_line("sla_output_precision");
 
     build_print_host_upload_group(page.get());
@@ -5196,7 +5203,7 @@ void Page::update_visibility(ConfigOptionMode mode, bool update_contolls_visibil
 {
     bool ret_val = false;
     for (auto group : m_optgroups) {
-        ret_val = (update_contolls_visibility     ? 
+        ret_val = (update_contolls_visibility && group->sizer ? 
                    group->update_visibility(mode) :  // update visibility for all controlls in group
                    group->is_visible(mode)           // just detect visibility for the group
                    ) || ret_val;
@@ -5205,10 +5212,18 @@ void Page::update_visibility(ConfigOptionMode mode, bool update_contolls_visibil
     m_show = ret_val;
 }
 
+bool Page::has_deferred_groups(ConfigOptionMode mode) const
+{
+    return std::any_of(m_optgroups.begin(), m_optgroups.end(), 
+        [mode](const ConfigOptionsGroupShp &group) { return !group->sizer && group->is_visible(mode); });
+}
+
 void Page::activate(ConfigOptionMode mode, std::function<void()> throw_if_canceled)
 {
     for (auto group : m_optgroups) {
-        if (!group->activate(throw_if_canceled))
+        // Controls of the groups hidden in this mode are not created until the groups get visible,
+        // see Tab::update_visibility().
+        if (!group->is_visible(mode) || !group->activate(throw_if_canceled))
             continue;
         m_vsizer->Add(group->sizer, 0, wxEXPAND | (group->is_legend_line() ? (wxLEFT|wxTOP) : wxALL), 10);
         group->update_visibility(mode);
@@ -5857,6 +5872,7 @@ void TabSLAPrint::build()
     optgroup = page->new_optgroup(L("Slicing"));
     optgroup->append_single_option_line("slice_closing_radius");
     optgroup->append_single_option_line("slicing_mode");
+    optgroup->append_single_option_line("preview_booleans");
 
     page = add_options_page(L("Output options"), "output+page_white");
     optgroup = page->new_optgroup(L("Output file"));
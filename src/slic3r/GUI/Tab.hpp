@@ -141,6 +141,8 @@ public:
 	void		set_config(DynamicPrintConfig* config_in) { m_config = config_in; }
 	void		reload_config();
     void        update_visibility(ConfigOptionMode mode, bool update_contolls_visibility);
+    // Are there option groups visible in this mode, which controls were not created yet?
+    bool        has_deferred_groups(ConfigOptionMode mode) const;
     void        activate(ConfigOptionMode mode, std::function<void()> throw_if_canceled);
     void        clear();
     void        msw_rescale();
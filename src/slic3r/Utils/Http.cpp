@@ -13,6 +13,8 @@
 #include <sstream>
 #include <exception>
 #include <random>
+#include <mutex>
+#include <vector>
 #include <boost/filesystem/fstream.hpp> // IWYU pragma: keep
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem.hpp>
@@ -103,7 +105,47 @@ struct CurlGlobalInit
         }
     }
 
-	~CurlGlobalInit() { ::curl_global_cleanup(); }
+	~CurlGlobalInit()
+    {
+        for (::CURL *curl : idle_handles)
+            ::curl_easy_cleanup(curl);
+        ::curl_global_cleanup();
+    }
+
+    // Returns an idle CURL handle of a finished request if there is any, otherwise a new one.
+    ::CURL* acquire_handle()
+    {
+        {
+            std::lock_guard<std::mutex> lock(idle_handles_mutex);
+            if (! idle_handles.empty()) {
+                ::CURL *curl = idle_handles.back();
+                idle_handles.pop_back();
+                return curl;
+            }
+        }
+        return ::curl_easy_init();
+    }
+
+    // Resets the options of a handle of a finished request and keeps it for the following requests.
+    // curl_easy_reset() keeps the live connections, the DNS cache and the TLS session cache of the handle,
+    // so that a following request to the same host reuses the connection (HTTP keep-alive).
+    void release_handle(::CURL *curl)
+    {
+        ::curl_easy_reset(curl);
+        {
+            std::lock_guard<std::mutex> lock(idle_handles_mutex);
+            if (idle_handles.size() < MAX_IDLE_HANDLES) {
+                idle_handles.push_back(curl);
+                return;
+            }
+        }
+        ::curl_easy_cleanup(curl);
+    }
+
+private:
+    static constexpr const size_t MAX_IDLE_HANDLES = 8;
+    std::mutex          idle_handles_mutex;
+    std::vector<::CURL*> idle_handles;
 };
 
 std::unique_ptr<CurlGlobalInit> CurlGlobalInit::instance;
@@ -129,6 +171,8 @@ struct Http::priv
 	std::string error_buffer;    // Used for CURLOPT_ERRORBUFFER
 	size_t limit;
 	bool cancel;
+	// False if the handle keeps a state, which must not leak into other requests, see CurlGlobalInit::release_handle().
+	bool reusable;
     std::unique_ptr<fs::ifstream> putFile;
 
 	std::thread io_thread;
@@ -154,22 +198,23 @@ struct Http::priv
 	void set_put_body(const fs::path &path);
 	void set_range(const std::string& range);
 
+	static ::CURL* acquire_handle();
+
 	std::string curl_error(CURLcode curlcode);
 	std::string body_size_error();
     void http_perform(const HttpRetryOpt& retry_opts = HttpRetryOpt::no_retry());
 };
 
 Http::priv::priv(const std::string &url)
-	: curl(::curl_easy_init())
+	: curl(acquire_handle())
 	, form(nullptr)
 	, form_end(nullptr)
 	, headerlist(nullptr)
 	, error_buffer(CURL_ERROR_SIZE + 1, '\0')
 	, limit(0)
 	, cancel(false)
+	, reusable(true)
 {
-    Http::tls_global_init();
-
 	if (curl == nullptr) {
 		throw Slic3r::RuntimeError(std::string("Could not construct Curl object"));
 	}
@@ -184,11 +229,22 @@ Http::priv::priv(const std::string &url)
 
 Http::priv::~priv()
 {
-	::curl_easy_cleanup(curl);
+	if (curl != nullptr) {
+		if (reusable)
+			CurlGlobalInit::instance->release_handle(curl);
+		else
+			::curl_easy_cleanup(curl);
+	}
 	::curl_formfree(form);
 	::curl_slist_free_all(headerlist);
 }
 
+::CURL* Http::priv::acquire_handle()
+{
+    Http::tls_global_init();
+    return CurlGlobalInit::instance->acquire_handle();
+}
+
 bool Http::priv::ca_file_supported(::CURL *curl)
 {
 #if defined(_WIN32) || defined(__APPLE__)
@@ -643,10 +699,21 @@ Http& Http::on_ip_resolve(IPResolveFn fn)
 	return *this;
 }
 
+Http& Http::if_modified_since(std::time_t time)
+{
+	if (p) {
+		::curl_easy_setopt(p->curl, CURLOPT_TIMECONDITION, long(CURL_TIMECOND_IFMODSINCE));
+		::curl_easy_setopt(p->curl, CURLOPT_TIMEVALUE, long(time));
+	}
+	return *this;
+}
+
 Http& Http::cookie_file(const std::string& file_path)
 {
 	if (p) {
 		::curl_easy_setopt(p->curl, CURLOPT_COOKIEFILE, file_path.c_str());
+		// The cookies stay in the handle.
+		p->reusable = false;
 	}
 	return *this;
 }
@@ -655,6 +722,8 @@ Http& Http::cookie_jar(const std::string& file_path)
 {
 	if (p) {
 		::curl_easy_setopt(p->curl, CURLOPT_COOKIEJAR, file_path.c_str());
+		// The cookies are written into the jar by curl_easy_cleanup().
+		p->reusable = false;
 	}
 	return *this;
 }
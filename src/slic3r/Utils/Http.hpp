@@ -12,6 +12,7 @@
 #include <functional>
 #include <boost/filesystem/path.hpp>
 #include <chrono>
+#include <ctime>
 
 namespace Slic3r {
 
@@ -140,6 +141,10 @@ public:
 	// Called if curl_easy_getinfo resolved just used IP address.
 	Http& on_ip_resolve(IPResolveFn fn);
 
+	// Only download the body if the resource was modified after the given time (If-Modified-Since).
+	// If it was not, the request completes with HTTP 304 and an empty body.
+	Http& if_modified_since(std::time_t time);
+
 	Http& cookie_file(const std::string& file_path);
 	Http& cookie_jar(const std::string& file_path);
 	Http& set_referer(const std::string& referer);
@@ -6,6 +6,7 @@
 #include "PresetUpdater.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <thread>
 #include <unordered_map>
 #include <ostream>
@@ -56,6 +57,8 @@ namespace Slic3r {
 
 //static const char *INDEX_FILENAME = "index.idx";
 static const char *TMP_EXTENSION = ".download";
+// Upper bound of the resources (thumbnails, bed textures and models) downloaded at the same time.
+static const size_t MAX_CONCURRENT_DOWNLOADS = 4;
 
 namespace {
 void copy_file_fix(const fs::path &source, const fs::path &target)
@@ -200,6 +203,9 @@ struct PresetUpdater::priv
 	void get_missing_resource(const GUI::ArchiveRepository* archive, const std::string& vendor, const std::string& filename, const std::string& repository_id_from_ini) const;
 	// checks existence and downloads resource to vendor or copy from cache to vendor
 	void get_or_copy_missing_resource(const GUI::ArchiveRepository* archive, const std::string& vendor, const std::string& filename, const std::string& repository_id_from_ini) const;
+	// Calls get_missing_resource() or get_or_copy_missing_resource() for each of the unique resources of a vendor,
+	// with up to MAX_CONCURRENT_DOWNLOADS downloads in flight.
+	void get_missing_resources(const GUI::ArchiveRepository* archive, const std::string& vendor, std::vector<std::string> filenames, const std::string& repository_id_from_ini, bool copy_to_vendor) const;
 	void update_index_db();
 };
 
@@ -322,6 +328,35 @@ void PresetUpdater::priv::get_or_copy_missing_resource(const GUI::ArchiveReposit
 	copy_file_fix(file_in_cache, file_in_vendor);
 }
 
+void PresetUpdater::priv::get_missing_resources(const GUI::ArchiveRepository* archive, const std::string& vendor, std::vector<std::string> filenames, const std::string& repository_id_from_ini, bool copy_to_vendor) const
+{
+	// Printer models of a vendor often share their bed textures and models.
+	filenames.erase(std::remove(filenames.begin(), filenames.end(), std::string()), filenames.end());
+	std::sort(filenames.begin(), filenames.end());
+	filenames.erase(std::unique(filenames.begin(), filenames.end()), filenames.end());
+
+	std::atomic<size_t> next_filename = 0;
+	auto worker = [&]() {
+		for (size_t i = next_filename ++; i < filenames.size() && ! cancel; i = next_filename ++) {
+			try {
+				if (copy_to_vendor)
+					get_or_copy_missing_resource(archive, vendor, filenames[i], repository_id_from_ini);
+				else
+					get_missing_resource(archive, vendor, filenames[i], repository_id_from_ini);
+			} catch (const std::exception& e) {
+				BOOST_LOG_TRIVIAL(error) << "Failed to get " << filenames[i] << " for " << vendor << ": " << e.what();
+			}
+		}
+	};
+	// Most of the resources are only checked for existence, the downloads are I/O bound.
+	std::vector<std::thread> workers;
+	for (size_t i = 1; i < std::min(filenames.size(), MAX_CONCURRENT_DOWNLOADS); ++ i)
+		workers.emplace_back(worker);
+	worker();
+	for (std::thread &thread : workers)
+		thread.join();
+}
+
 // Download vendor indices. Also download new bundles if an index indicates there's a new one available.
 // Both are saved in cache.
 void PresetUpdater::priv::sync_config(const VendorMap& vendors, const GUI::ArchiveRepository* archive_repository)
@@ -330,8 +365,9 @@ void PresetUpdater::priv::sync_config(const VendorMap& vendors, const GUI::Archi
 
 	if (!enabled_config_update) { return; }
 
-	// Download profiles archive zip
-	fs::path archive_path(cache_path / "vendor_indices.zip");
+	// Download profiles archive zip.
+	// The archive is kept per repository, so that it is only downloaded again if it changed on the server.
+	fs::path archive_path(cache_path / ("vendor_indices_" + archive_repository->get_uuid() + ".zip"));
 	if (!archive_repository->get_archive(archive_path)) {
 		BOOST_LOG_TRIVIAL(error) << "Download of vedor profiles archive zip failed.";
 		return;
@@ -494,23 +530,12 @@ void PresetUpdater::priv::sync_config(const VendorMap& vendors, const GUI::Archi
 		}
 		// check the fresh bundle for missing resources
 		// for that, the ini file must be parsed (done above)
-		for (const auto& model : vp.models) {
-			for (const std::string& res : { model.bed_texture, model.bed_model, model.thumbnail/*id +"_thumbnail.png"*/} ) {
-				if (! res.empty()) {
-					try
-					{
-						get_missing_resource(archive_repository, vp.id, res, vendor.repo_id);
-					}
-					catch (const std::exception& e)
-					{
-						BOOST_LOG_TRIVIAL(error) << "Failed to get " << res << " for " << vp.id << " " << model.id << ": " << e.what();
-					}
-					
-				}
-				if (cancel)
-			    	return;
-			}
-		}
+		std::vector<std::string> resources;
+		for (const auto& model : vp.models)
+			resources.insert(resources.end(), { model.bed_texture, model.bed_model, model.thumbnail/*id +"_thumbnail.png"*/ });
+		get_missing_resources(archive_repository, vp.id, std::move(resources), vendor.repo_id, false);
+		if (cancel)
+			return;
 	}
 	// Now status of each vendor is already decided.
 	// Download missing for non-installed vendors.
@@ -573,20 +598,12 @@ void PresetUpdater::priv::sync_config(const VendorMap& vendors, const GUI::Archi
 				BOOST_LOG_TRIVIAL(error) << format("Corrupted profile file for vendor %1% at %2%, message: %3%", vendor.first, ini_path_in_archive, e.what());
 				continue;
 			}
-			for (const auto& model : vp.models) {
-				if (!model.thumbnail.empty()) {
-					try
-					{
-						get_missing_resource(archive_repository, vp.id, model.thumbnail, vp.repo_id);
-					}
-					catch (const std::exception& e)
-					{
-						BOOST_LOG_TRIVIAL(error) << "Failed to get " << model.thumbnail << " for " << vp.id << " " << model.id << ": " << e.what();
-					}
-				}
-				if (cancel)
-					return;
-			}
+			std::vector<std::string> thumbnails;
+			for (const auto& model : vp.models)
+				thumbnails.emplace_back(model.thumbnail);
+			get_missing_resources(archive_repository, vp.id, std::move(thumbnails), vp.repo_id, false);
+			if (cancel)
+				return;
 		} else if (vendor.second == VendorStatus::IN_CACHE) {
 			// find those where archive index recommends other version than index in cache and get it if not present
 			const auto idx_path_in_archive = cache_vendor_path / (vendor.first + ".idx");
@@ -690,20 +707,12 @@ void PresetUpdater::priv::sync_config(const VendorMap& vendors, const GUI::Archi
 				BOOST_LOG_TRIVIAL(error) << format("Corrupted profile file for vendor %1% at %2%, message: %3%", vendor.first, ini_path_in_archive, e.what());
 				continue;
 			}
-			for (const auto& model : vp.models) {
-				if (!model.thumbnail.empty()) {
-					try
-					{
-						get_missing_resource(archive_repository, vp.id, model.thumbnail, vp.repo_id);
-					}
-					catch (const std::exception& e)
-					{
-						BOOST_LOG_TRIVIAL(error) << "Failed to get " << model.thumbnail << " for " << vp.id << " " << model.id << ": " << e.what();
-					}
-				}
-				if (cancel)
-					return;
-			}
+			std::vector<std::string> thumbnails;
+			for (const auto& model : vp.models)
+				thumbnails.emplace_back(model.thumbnail);
+			get_missing_resources(archive_repository, vp.id, std::move(thumbnails), vp.repo_id, false);
+			if (cancel)
+				return;
 		} else if (vendor.second == VendorStatus::INSTALLED || vendor.second == VendorStatus::NEW_VERSION) {
 			// Installed vendors need to check that no resource is missing. Do this only for files in vendor folder (not in resorces)
 			// VendorStatus::NEW_VERSION might seem like a mistake here since files are downloaded when preparing update higher in this function. 
@@ -719,22 +728,12 @@ void PresetUpdater::priv::sync_config(const VendorMap& vendors, const GUI::Archi
 				BOOST_LOG_TRIVIAL(error) << format("Corrupted profile file for vendor %1% at %2%, message: %3%", vendor.first, path_in_vendor, e.what());
 				continue;
 			}
-			for (const auto& model : vp.models) {
-				for (const std::string& res : { model.bed_texture, model.bed_model, model.thumbnail }) {
-					if (!res.empty()) {
-						try
-						{
-							get_or_copy_missing_resource(archive_repository, vp.id, res, vp.repo_id);
-						}
-						catch (const std::exception& e)
-						{
-							BOOST_LOG_TRIVIAL(error) << "Failed to get " << res << " for " << vp.id << " " << model.id << ": " << e.what();
-						}
-					}
-					if (cancel)
-						return;
-				}
-			}
+			std::vector<std::string> resources;
+			for (const auto& model : vp.models)
+				resources.insert(resources.end(), { model.bed_texture, model.bed_model, model.thumbnail });
+			get_missing_resources(archive_repository, vp.id, std::move(resources), vp.repo_id, true);
+			if (cancel)
+				return;
 		}
 	}
 }
@@ -11,6 +11,7 @@
 #include <cereal/types/vector.hpp> // IWYU pragma: keep
 #include <cereal/archives/binary.hpp> // IWYU pragma: keep
 #include <boost/format.hpp>
+#include <boost/log/trivial.hpp>
 #include <cereal/cereal.hpp>
 #include <algorithm>
 #include <fstream>
@@ -20,6 +21,8 @@
 #include <type_traits>
 #include <cstring>
 
+#include <miniz.h>
+
 #define CEREAL_FUTURE_EXPERIMENTAL
 #include <cereal/archives/adapters.hpp>
 #include <libslic3r/ObjectID.hpp>
@@ -336,6 +339,10 @@ private:
 	std::string 				m_serialized;
 };
 
+// Snapshots of mutable objects at least this long are stored compressed. The painted facets, which cereal serializes
+// as a byte per bit, and the configs compress very well, while short snapshots are not worth the effort.
+static constexpr const size_t mutable_history_compress_threshold = 4096;
+
 struct MutableHistoryInterval
 {
 private:
@@ -344,26 +351,69 @@ private:
 		// Reference counter of this data chunk. We may have used shared_ptr, but the shared_ptr is thread safe
 		// with the associated cost of CPU cache invalidation on refcount change.
 		size_t		refcnt;
+		// Size of the serialized data.
 		size_t		size;
+		// Size of the data stored here, smaller than this->size if the data is compressed.
+		size_t		stored_size;
+		// The first 8 bytes of the serialized data, where the objects providing a timestamp serialize the timestamp.
+		uint64_t	prefix;
 		char 		data[1];
 
+		bool 		compressed() const { return this->stored_size != this->size; }
+
+		static Data* create(const std::string &input_data) {
+			std::vector<unsigned char> compressed;
+			if (input_data.size() >= mutable_history_compress_threshold) {
+				mz_ulong compressed_size = mz_compressBound(mz_ulong(input_data.size()));
+				compressed.assign(compressed_size, 0);
+				if (mz_compress2(compressed.data(), &compressed_size, (const unsigned char*)input_data.data(), mz_ulong(input_data.size()), MZ_BEST_SPEED) == MZ_OK &&
+					compressed_size < input_data.size())
+					compressed.resize(compressed_size);
+				else
+					compressed.clear();
+			}
+			const size_t stored_size = compressed.empty() ? input_data.size() : compressed.size();
+			Data *out = (Data*)new char[offsetof(Data, data) + stored_size];
+			out->refcnt      = 1;
+			out->size        = input_data.size();
+			out->stored_size = stored_size;
+			out->prefix      = 0;
+			memcpy(&out->prefix, input_data.data(), std::min(input_data.size(), sizeof(uint64_t)));
+			memcpy(out->data, compressed.empty() ? (const void*)input_data.data() : (const void*)compressed.data(), stored_size);
+			return out;
+		}
+
+		std::string	uncompressed() const {
+			if (! this->compressed())
+				return std::string(this->data, this->data + this->size);
+			std::string out(this->size, 0);
+			mz_ulong    out_size = mz_ulong(this->size);
+			if (mz_uncompress((unsigned char*)out.data(), &out_size, (const unsigned char*)this->data, mz_ulong(this->stored_size)) != MZ_OK || out_size != this->size)
+				throw Slic3r::RuntimeError("Undo / Redo stack: Failed to decompress a snapshot");
+			return out;
+		}
+
 		// The serialized data matches the data stored here.
-		bool 		matches(const std::string& rhs) { return this->size == rhs.size() && memcmp(this->data, rhs.data(), this->size) == 0; }
+		bool 		matches(const std::string& rhs) const {
+			return this->size == rhs.size() && this->prefix == Data::prefix_of(rhs) &&
+				(this->compressed() ? this->uncompressed() == rhs : memcmp(this->data, rhs.data(), this->size) == 0);
+		}
 
 		// The timestamp matches the timestamp serialized in the data stored here.
-		bool 		matches_timestamp(uint64_t timestamp) { assert(timestamp > 0);  assert(this->size > 8); return memcmp(this->data, &timestamp, 8) == 0; }
+		bool 		matches_timestamp(uint64_t timestamp) const { assert(timestamp > 0);  assert(this->size > 8); return this->prefix == timestamp; }
+
+		static uint64_t prefix_of(const std::string &data) {
+			uint64_t prefix = 0;
+			memcpy(&prefix, data.data(), std::min(data.size(), sizeof(uint64_t)));
+			return prefix;
+		}
 	};
 
 	Interval    m_interval;
 	Data	   *m_data;
 
 public:
-	MutableHistoryInterval(const Interval &interval, const std::string &input_data) : m_interval(interval), m_data(nullptr) {
-		m_data = (Data*)new char[offsetof(Data, data) + input_data.size()];
-		m_data->refcnt = 1;
-		m_data->size = input_data.size();
-		memcpy(m_data->data, input_data.data(), input_data.size());
-	}
+	MutableHistoryInterval(const Interval &interval, const std::string &input_data) : m_interval(interval), m_data(Data::create(input_data)) {}
 
 	MutableHistoryInterval(const Interval &interval, MutableHistoryInterval &other) : m_interval(interval), m_data(other.m_data) {
 		++ m_data->refcnt;
@@ -394,14 +444,16 @@ public:
 	const char* data() const { return m_data->data; }
 	size_t  	size() const { return m_data->size; }
 	size_t		refcnt() const { return m_data->refcnt; }
+	// The serialized data, decompressed if it was stored compressed.
+	std::string	serialized() const { return m_data->uncompressed(); }
 	bool		matches(const std::string& data) { return m_data->matches(data); }
 	bool		matches_timestamp(uint64_t timestamp) { return m_data->matches_timestamp(timestamp); }
 	size_t 		memsize() const {
 		return m_data->refcnt == 1 ?
-			// Count just the size of the snapshot data.
-			m_data->size :
+			// Count just the size of the snapshot data as stored, possibly compressed.
+			m_data->stored_size :
 			// Count the size of the snapshot data divided by the number of references, rounded up.
-			(m_data->size + m_data->refcnt - 1) / m_data->refcnt;
+			(m_data->stored_size + m_data->refcnt - 1) / m_data->refcnt;
 	}
 
 private:
@@ -485,7 +537,7 @@ public:
 			-- it;
 		}
 		assert(timestamp >= it->begin() && timestamp < it->end());
-		return std::string(it->data(), it->data() + it->size());
+		return it->serialized();
 	}
 
 	// Currently all mutable snapshots are mandatory.
@@ -586,7 +638,7 @@ public:
 	bool has_redo_snapshot() const;
     bool undo(Slic3r::Model &model, const Slic3r::GUI::Selection &selection, Slic3r::GUI::GLGizmosManager &gizmos, const SnapshotData &snapshot_data, size_t jump_to_time);
     bool redo(Slic3r::Model &model, Slic3r::GUI::GLGizmosManager &gizmos, size_t jump_to_time);
-	void release_least_recently_used();
+	size_t release_least_recently_used();
 
 	// Snapshot history (names with timestamps).
 	const std::vector<Snapshot>& 	snapshots() const { return m_snapshots; }
@@ -1112,10 +1164,11 @@ void StackImpl::collect_garbage()
 	}
 }
 
-void StackImpl::release_least_recently_used()
+size_t StackImpl::release_least_recently_used()
 {
 	assert(this->valid());
 	size_t current_memsize = this->memsize();
+	size_t num_released    = 0;
 #ifdef SLIC3R_UNDOREDO_DEBUG
 	bool released = false;
 #endif
@@ -1179,6 +1232,7 @@ void StackImpl::release_least_recently_used()
 			}
 			//FIXME update the "saved" snapshot time.
 			m_snapshots.erase(m_snapshots.begin());
+			++ num_released;
 		}
 		assert(current_memsize >= mem_released);
 		if (current_memsize >= mem_released)
@@ -1190,10 +1244,15 @@ void StackImpl::release_least_recently_used()
 #endif
 	}
 	assert(this->valid());
+	if (num_released > 0)
+		// The first snapshot (the project start) and the topmost snapshot (the current state) are not undo steps.
+		BOOST_LOG_TRIVIAL(info) << "Undo / Redo stack exceeded the memory limit of " << Slic3r::format_memsize_MB(m_memory_limit) << ": " <<
+			num_released << " oldest snapshots released, " << m_snapshots.size() - 2 << " steps remain, occupying " << Slic3r::format_memsize_MB(current_memsize);
 #ifdef SLIC3R_UNDOREDO_DEBUG
 	std::cout << "After release_least_recently_used" << std::endl;
  	this->print();
 #endif /* SLIC3R_UNDOREDO_DEBUG */
+	return num_released;
 }
 
 bool StackImpl::project_modified() const
@@ -1243,7 +1302,7 @@ bool Stack::empty() const { return pimpl->empty(); }
 void Stack::set_memory_limit(size_t memsize) { pimpl->set_memory_limit(memsize); }
 size_t Stack::get_memory_limit() const { return pimpl->get_memory_limit(); }
 size_t Stack::memsize() const { return pimpl->memsize(); }
-void Stack::release_least_recently_used() { pimpl->release_least_recently_used(); }
+size_t Stack::release_least_recently_used() { return pimpl->release_least_recently_used(); }
 void Stack::take_snapshot(const std::string& snapshot_name, const Slic3r::Model& model, const Slic3r::GUI::Selection& selection, const Slic3r::GUI::GLGizmosManager& gizmos, const SnapshotData &snapshot_data)
 	{ pimpl->take_snapshot(snapshot_name, model, selection, gizmos, snapshot_data); }
 void Stack::reduce_noisy_snapshots(const std::string& new_name) { pimpl->reduce_noisy_snapshots(new_name); }
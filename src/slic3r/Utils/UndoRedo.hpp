@@ -124,7 +124,8 @@ public:
 	size_t memsize() const;
 
 	// Release least recently used snapshots up to the memory limit set above.
-	void release_least_recently_used();
+	// Returns the number of snapshots released, the number of the remaining ones is logged.
+	size_t release_least_recently_used();
 
 	// Store the current application state onto the Undo / Redo stack, remove all snapshots after m_active_snapshot_time.
     void take_snapshot(const std::string& snapshot_name, const Slic3r::Model& model, const Slic3r::GUI::Selection& selection, const Slic3r::GUI::GLGizmosManager& gizmos, const SnapshotData &snapshot_data);
@@ -2,6 +2,7 @@
 #include "test_utils.hpp"
 
 #include <libslic3r/Execution/ExecutionSeq.hpp>
+#include <libslic3r/Execution/ExecutionTBB.hpp>
 
 #include <libslic3r/Arrange/Core/ArrangeBase.hpp>
 #include <libslic3r/Arrange/Core/ArrangeFirstFit.hpp>
@@ -463,6 +464,50 @@ TEST_CASE("NFP should be empty if item cannot fit into bed", "[arrange2]") {
     }
 }
 
+TEST_CASE("Cached NFP should equal the computed one", "[arrange2]") {
+    using namespace Slic3r;
+
+    arr2::RectangleBed bed{scaled(250.), scaled(210.)};
+
+    for (const ArrangeItem &part : prusa_parts_ex()) {
+        // Keep the test fast
+        if (part.shape().contours().size() > 60)
+            continue;
+
+        // Rotated and translated copies of the same part as fixed items
+        std::vector<ArrangeItem> fixed(4, part);
+        for (size_t i = 0; i < fixed.size(); ++i) {
+            arr2::set_rotation(fixed[i], (i % 2) * PI / 3.);
+            arr2::set_translation(fixed[i], bounding_box(bed).center() + Vec2crd{coord_t(i) * scaled(30.), scaled(-50.)});
+        }
+
+        ArrangeItem orbiter = part;
+        arr2::set_rotation(orbiter, PI / 3.);
+
+        auto ctx = arr2::default_context(fixed);
+        ExPolygons nfp = arr2::calculate_nfp(orbiter, ctx, bed);
+
+        arr2::NFPCache cache;
+        ExPolygons nfp_first = arr2::calculate_nfp(orbiter, ctx, bed, arr2::DefaultStopCondition{}, &cache);
+        REQUIRE(cache.hits() > 0);
+        size_t hits = cache.hits();
+
+        // All the NFPs are cached now, even if the orbiter moved
+        arr2::set_translation(orbiter, Vec2crd{scaled(5.), scaled(7.)});
+        ExPolygons nfp_cached = arr2::calculate_nfp(orbiter, ctx, bed, arr2::DefaultStopCondition{}, &cache);
+        REQUIRE(cache.hits() - hits == fixed.size());
+
+        auto same_area = [](const ExPolygons &a, const ExPolygons &b) {
+            constexpr double eps = scaled<double>(.1) * scaled<double>(.1);
+            return area(diff_ex(a, b)) == Approx(0.).margin(eps) &&
+                   area(diff_ex(b, a)) == Approx(0.).margin(eps);
+        };
+
+        REQUIRE(same_area(nfp, nfp_first));
+        REQUIRE(same_area(nfp, nfp_cached));
+    }
+}
+
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem.hpp>
 
@@ -1044,6 +1089,38 @@ TEMPLATE_TEST_CASE("RectangleOverfitPackingStrategy test", "[arrange2]",
     }
 }
 
+// Arranging copies of the same part, with and without the NFP cache.
+TEST_CASE("Arrange copies of a part benchmark", "[arrange2][.Benchmarks]")
+{
+    using namespace Slic3r;
+
+    namespace firstfit = arr2::firstfit;
+
+    auto bed = arr2::InfiniteBed{};
+
+    // A concave part made of a few convex parts
+    std::vector<ArrangeItem> parts = prusa_parts_ex();
+    ArrangeItem part = *std::min_element(parts.begin(), parts.end(), [](const ArrangeItem &a, const ArrangeItem &b) {
+        return a.shape().contours().size() < b.shape().contours().size();
+    });
+
+    for (size_t count : {50, 100, 200, 300}) {
+        std::vector<ArrangeItem> items(count, part);
+
+        for (bool use_cache : {false, true}) {
+            BENCHMARK(std::to_string(count) + " copies" + (use_cache ? ", cached NFPs" : "")) {
+                arr2::PackStrategyNFP strategy{arr2::GravityKernel{bed.center}, ex_tbb};
+                if (!use_cache)
+                    strategy.nfp_cache.reset();
+
+                arr2::arrange(firstfit::SelectionStrategy<>{}, strategy, range(items), bed);
+
+                return arr2::get_translation(items.back());
+            };
+        }
+    }
+}
+
 TEMPLATE_TEST_CASE("Test if allowed item rotations are considered", "[arrange2]",
                    Slic3r::arr2::ArrangeItem)
 {
@@ -680,6 +680,78 @@ TEMPLATE_TEST_CASE("Bed needs to be completely filled with 1cm cubes",
         }));
 }
 
+TEMPLATE_TEST_CASE("Bed filled with many copies should use the lattice",
+                   "[arrange2][integration][bedfilling]",
+                   Slic3r::arr2::ArrangeItem)
+{
+    using namespace Slic3r;
+    using ArrItem = TestType;
+
+    std::string basepath = TEST_DATA_DIR PATH_SEPARATOR;
+
+    DynamicPrintConfig cfg;
+    cfg.load_from_ini(basepath + "default_fff.ini",
+                      ForwardCompatibilitySubstitutionRule::Enable);
+    cfg.set_key_value("bed_shape",
+                      new ConfigOptionPoints(
+                          {{0., 0.}, {250., 0.}, {250., 210.}, {0, 210.}}));
+
+    Model m;
+
+    ModelObject* new_object = m.add_object();
+    new_object->name = "5mm_box";
+    new_object->add_instance();
+    TriangleMesh mesh = make_cube(5., 5., 5.);
+    ModelVolume* new_volume = new_object->add_volume(mesh);
+    new_volume->name = new_object->name;
+
+    arr2::ArrangeSettings settings;
+    settings.values().d_obj = 0.;
+    settings.values().d_bed = 0.;
+
+    arr2::FixedSelection sel({{true}});
+
+    arr2::Scene scene{arr2::SceneBuilder{}
+                                 .set_model(m)
+                                 .set_arrange_settings(settings)
+                                 .set_selection(&sel)
+                                 .set_bed(cfg)};
+
+    auto task = arr2::FillBedTask<ArrItem>::create(scene);
+
+    REQUIRE(task->selected.size() - task->selected_existing_count >=
+            task->lattice_fill_min_count);
+
+    auto result = task->process_native(arr2::DummyCtl{});
+    result->apply_on(scene.model());
+
+    REQUIRE(m.objects.size() == 1);
+    REQUIRE(m.objects.front()->instances.size() == 250 * 210 / 25);
+
+    std::vector<BoundingBox> bbs;
+    for (ModelInstance *mi : m.objects.front()->instances)
+        bbs.emplace_back(BoundingBox{scaled(to_2d(arr2::instance_bounding_box(*mi)))});
+
+    BoundingBox bedbb{Point::Zero(), Point{scaled(250.), scaled(210.)}};
+    bedbb.offset(SCALED_EPSILON);
+
+    // All the copies should be on the physical bed without overlapping
+    REQUIRE(std::all_of(bbs.begin(), bbs.end(), [&bedbb](const BoundingBox &bb) {
+        return bedbb.contains(bb);
+    }));
+
+    size_t overlapping = 0;
+    for (size_t i = 0; i < bbs.size(); ++i) {
+        BoundingBox bbi = bbs[i];
+        bbi.offset(-SCALED_EPSILON);
+        for (size_t j = i + 1; j < bbs.size(); ++j)
+            if (bbi.overlap(bbs[j]))
+                ++overlapping;
+    }
+
+    REQUIRE(overlapping == 0);
+}
+
 template<class It, class Fn>
 static void foreach_combo(const Slic3r::Range<It> &range, const Fn &fn)
 {
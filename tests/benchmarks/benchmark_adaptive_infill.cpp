@@ -0,0 +1,28 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/Fill/FillAdaptive.hpp"
+#include "libslic3r/Fill/FillBase.hpp"
+#include "libslic3r/Surface.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+
+using namespace Slic3r;
+
+TEST_CASE("Adaptive cubic infill octree benchmark", "[FillAdaptive][.Benchmarks]") {
+    // A finely tessellated sphere of a large diameter produces a deep octree with many cubes.
+    indexed_triangle_set mesh = its_make_sphere(100., PI / 360.);
+    its_transform(mesh, Matrix3d(FillAdaptive::transform_to_octree().toRotationMatrix()));
+    const double line_spacing = 0.5;
+
+    BENCHMARK("build_octree") { return FillAdaptive::build_octree(mesh, {}, line_spacing, false); };
+
+    FillAdaptive::OctreePtr       octree = FillAdaptive::build_octree(mesh, {}, line_spacing, false);
+    std::unique_ptr<Fill>         filler(Fill::new_from_type(ipAdaptiveCubic));
+    filler->adapt_fill_octree = octree.get();
+    filler->spacing           = line_spacing;
+    filler->z                 = 10.;
+    FillParams params;
+    params.density = 0.2f;
+    const Surface surface(stInternal, ExPolygon(Polygon::new_scale({ { -90., -90. }, { 90., -90. }, { 90., 90. }, { -90., 90. } })));
+
+    BENCHMARK("fill_surface") { return filler->fill_surface(&surface, params); };
+}
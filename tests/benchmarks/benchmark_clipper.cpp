@@ -0,0 +1,59 @@
+#include <catch2/catch.hpp>
+
+#include "data/prusaparts.hpp"
+
+#include "libslic3r/ClipperUtils.hpp"
+
+using namespace Slic3r;
+
+namespace {
+
+// Shrink and grow of each polygon of the prusaparts corpus the way ClipperUtils did it before the engines were pooled:
+// a new ClipperOffset and a new Clipper engine for every single operation.
+Polygons opening_fresh_engines(const Polygons &polygons, double delta)
+{
+    Polygons out;
+    for (const Polygon &polygon : polygons) {
+        ClipperLib::Paths shrunk;
+        {
+            ClipperLib::ClipperOffset co;
+            co.MiterLimit = 3.;
+            co.AddPath(polygon.points, ClipperLib::jtMiter, ClipperLib::etClosedPolygon);
+            co.Execute(shrunk, - delta);
+        }
+        ClipperLib::Paths grown;
+        for (const ClipperLib::Path &path : shrunk) {
+            ClipperLib::ClipperOffset co;
+            co.MiterLimit = 3.;
+            co.AddPath(path, ClipperLib::jtMiter, ClipperLib::etClosedPolygon);
+            ClipperLib::Paths out_this;
+            co.Execute(out_this, delta);
+            append(grown, std::move(out_this));
+        }
+        ClipperLib::Clipper clipper;
+        clipper.AddPaths(grown, ClipperLib::ptSubject, true);
+        ClipperLib::Paths united;
+        clipper.Execute(ClipperLib::ctUnion, united, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+        append(out, to_polygons(std::move(united)));
+    }
+    return out;
+}
+
+Polygons opening_pooled_engines(const Polygons &polygons, double delta)
+{
+    Polygons out;
+    for (const Polygon &polygon : polygons)
+        append(out, offset(offset(polygon, float(- delta), ClipperLib::jtMiter, 3.), float(delta), ClipperLib::jtMiter, 3.));
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("Clipper engine pool benchmark", "[ClipperUtils][.Benchmarks]") {
+    const Polygons polygons(PRUSA_PART_POLYGONS.begin(), PRUSA_PART_POLYGONS.end());
+    const double   delta    = scaled<double>(0.2);
+
+    BENCHMARK("opening, fresh engines") { return opening_fresh_engines(polygons, delta); };
+    BENCHMARK("opening, pooled engines") { return opening_pooled_engines(polygons, delta); };
+    BENCHMARK("union_ex of all parts") { return union_ex(polygons); };
+}
@@ -0,0 +1,163 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include <boost/filesystem.hpp>
+#include <boost/nowide/cstdio.hpp>
+
+#include "test_data.hpp"
+#include "data/prusaparts.hpp"
+
+#include "libslic3r/Format/OBJ.hpp"
+#include "libslic3r/GCode/GCodeProcessor.hpp"
+#include "libslic3r/SlicesToTriangleMesh.hpp"
+#include "libslic3r/Trace.hpp"
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+using namespace Slic3r;
+
+namespace {
+
+// Peak resident set size of this process in bytes, 0 if not available.
+size_t peak_rss()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return size_t(pmc.PeakWorkingSetSize);
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    // ru_maxrss is in bytes on macOS, in kilobytes elsewhere.
+    return size_t(usage.ru_maxrss);
+#else
+    return size_t(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+TriangleMesh load_fixture(const char *name)
+{
+    TriangleMesh mesh;
+    std::string  path = std::string(TEST_DATA_DIR) + "/" + name;
+    if (! load_obj(path.c_str(), &mesh))
+        throw Slic3r::RuntimeError(std::string("Failed to load ") + path);
+    return mesh;
+}
+
+// The prusaparts corpus only contains 2D outlines, extrude each of them to a 5mm high prism.
+std::vector<TriangleMesh> prusaparts_meshes()
+{
+    std::vector<TriangleMesh> out;
+    out.reserve(PRUSA_PART_POLYGONS.size());
+    for (Polygon polygon : PRUSA_PART_POLYGONS) {
+        polygon.make_counter_clockwise();
+        std::vector<ExPolygons> slices(25, ExPolygons{ ExPolygon(std::move(polygon)) });
+        out.emplace_back(slices_to_mesh(slices, 0., 0.2, 0.2));
+    }
+    return out;
+}
+
+// Full pipeline over the given meshes: slicing, all PrintObject steps, G-code export and G-code processing.
+// Wall time of the individual steps is collected by Trace, therefore tracing is enabled for the run.
+void run_pipeline(const std::string &label, std::vector<TriangleMesh> &&meshes, std::initializer_list<ConfigBase::SetDeserializeItem> config_items)
+{
+    DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+    config.set_deserialize_strict({ { "bed_shape", "0x0,500x0,500x500,0x500" } });
+    config.set_deserialize_strict(config_items);
+
+    const bool trace_enabled = Trace::enabled();
+    Trace::enable(true);
+
+    Print print;
+    Model model;
+    Test::init_print(std::move(meshes), print, model, config);
+
+    auto   start      = std::chrono::steady_clock::now();
+    print.process();
+    double process_ms = elapsed_ms(start);
+    std::map<std::string, uint64_t> steps = Trace::total_durations("step");
+
+    boost::filesystem::path temp = boost::filesystem::unique_path();
+    start = std::chrono::steady_clock::now();
+    print.export_gcode(temp.string(), nullptr, nullptr);
+    double export_ms = elapsed_ms(start);
+
+    GCodeProcessor processor;
+    start = std::chrono::steady_clock::now();
+    processor.process_file(temp.string());
+    double processor_ms = elapsed_ms(start);
+    boost::nowide::remove(temp.string().c_str());
+
+    Trace::enable(trace_enabled);
+
+    std::cout << std::fixed << std::setprecision(1) << "Pipeline benchmark: " << label << std::endl;
+    for (const auto &[name, duration] : steps)
+        std::cout << "    " << std::left << std::setw(40) << name << double(duration) / 1000. << " ms" << std::endl;
+    std::cout << "    " << std::left << std::setw(40) << "Print::process" << process_ms << " ms" << std::endl
+              << "    " << std::left << std::setw(40) << "Print::export_gcode" << export_ms << " ms" << std::endl
+              << "    " << std::left << std::setw(40) << "GCodeProcessor::process_file" << processor_ms << " ms" << std::endl
+              << "    " << std::left << std::setw(40) << "Peak RSS" << double(peak_rss()) / (1024. * 1024.) << " MB" << std::endl;
+
+    CHECK(print.finished());
+}
+
+std::vector<TriangleMesh> obj_fixtures()
+{
+    return {
+        load_fixture("extruder_idler.obj"),
+        load_fixture("frog_legs.obj"),
+        load_fixture("ipadstand.obj"),
+        load_fixture("A.obj"),
+        load_fixture("overhang.obj"),
+        load_fixture("bridge.obj")
+    };
+}
+
+} // namespace
+
+TEST_CASE("Pipeline benchmark classic perimeters", "[Pipeline][.Benchmarks]") {
+    const std::initializer_list<ConfigBase::SetDeserializeItem> config {
+        { "perimeter_generator", "classic" },
+        { "fill_density", "20%" },
+        { "fill_pattern", "gyroid" }
+    };
+    SECTION("prusaparts") { run_pipeline("prusaparts, classic", prusaparts_meshes(), config); }
+    SECTION("OBJ fixtures") { run_pipeline("OBJ fixtures, classic", obj_fixtures(), config); }
+}
+
+TEST_CASE("Pipeline benchmark Arachne perimeters", "[Pipeline][.Benchmarks]") {
+    const std::initializer_list<ConfigBase::SetDeserializeItem> config {
+        { "perimeter_generator", "arachne" },
+        { "fill_density", "20%" },
+        { "fill_pattern", "gyroid" }
+    };
+    SECTION("prusaparts") { run_pipeline("prusaparts, Arachne", prusaparts_meshes(), config); }
+    SECTION("OBJ fixtures") { run_pipeline("OBJ fixtures, Arachne", obj_fixtures(), config); }
+}
+
+TEST_CASE("Pipeline benchmark organic supports", "[Pipeline][.Benchmarks]") {
+    const std::initializer_list<ConfigBase::SetDeserializeItem> config {
+        { "perimeter_generator", "arachne" },
+        { "fill_density", "15%" },
+        { "support_material", true },
+        { "support_material_style", "organic" }
+    };
+    SECTION("OBJ fixtures") { run_pipeline("OBJ fixtures, organic supports", obj_fixtures(), config); }
+}
@@ -0,0 +1,48 @@
+#include <catch2/catch.hpp>
+
+#include <random>
+
+#include "libslic3r/ExtrusionEntity.hpp"
+#include "libslic3r/ShortestPath.hpp"
+
+using namespace Slic3r;
+
+// Short random segments scattered over a square, whose area grows with the number of segments,
+// resembling gap fill or thin infill lines of a large print bed.
+static Polylines random_segments(size_t num_segments)
+{
+    std::mt19937 rng(1234);
+    const double side = 2. * std::sqrt(double(num_segments));
+    std::uniform_real_distribution<double> position(0., side);
+    std::uniform_real_distribution<double> offset(-1., 1.);
+    Polylines out;
+    out.reserve(num_segments);
+    for (size_t i = 0; i < num_segments; ++ i) {
+        Vec2d p1(position(rng), position(rng));
+        Vec2d p2 = p1 + Vec2d(offset(rng), offset(rng));
+        out.emplace_back(Polyline(Point::new_scale(p1), Point::new_scale(p2)));
+    }
+    return out;
+}
+
+TEST_CASE("Chaining benchmark", "[ShortestPath][.Benchmarks]") {
+    for (size_t num_segments : { 10000, 100000, 1000000 }) {
+        const Polylines polylines  = random_segments(num_segments);
+        const Point     start_near = polylines.front().first_point();
+        const std::string suffix   = " " + std::to_string(num_segments);
+
+        // With a start point, chain_polylines() is not followed by the 2-opt improvement of quadratic complexity.
+        BENCHMARK("chain_polylines" + suffix) { return chain_polylines(polylines, &start_near); };
+
+        ExtrusionPaths paths;
+        paths.reserve(polylines.size());
+        for (const Polyline &polyline : polylines)
+            paths.emplace_back(polyline, ExtrusionAttributes{ ExtrusionRole::GapFill, ExtrusionFlow{ 0.05, 0.4f, 0.2f } });
+        std::vector<ExtrusionEntity*> entities;
+        entities.reserve(paths.size());
+        for (ExtrusionPath &path : paths)
+            entities.emplace_back(&path);
+
+        BENCHMARK("chain_extrusion_entities" + suffix) { return chain_extrusion_entities(entities, &start_near); };
+    }
+}
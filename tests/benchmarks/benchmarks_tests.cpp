@@ -0,0 +1,3 @@
+#include <catch_main.hpp>
+
+#include "libslic3r/libslic3r.h"
@@ -68,6 +68,50 @@ TEST_CASE_METHOD(Slic3r::Test::SeamsFixture, "Seam benchmarks", "[Seams][.Benchm
         });
     };
 
+    // Copies of the object in a grid, each copy producing its own shells.
+    const std::vector<Geometry::BoundedPolygons> projected_grid{[&]() {
+        const int grid_size{6};
+        Slic3r::BoundingBox bounding_box;
+        for (const Geometry::BoundedPolygons &layer : projected) {
+            for (const Geometry::BoundedPolygon &polygon : layer) {
+                bounding_box.merge(polygon.bounding_box);
+            }
+        }
+        const Slic3r::Point step{bounding_box.size() * 2};
+        std::vector<Geometry::BoundedPolygons> result;
+        for (const Geometry::BoundedPolygons &layer : projected) {
+            Geometry::BoundedPolygons &result_layer{result.emplace_back()};
+            for (int i{0}; i < grid_size * grid_size; ++i) {
+                const Slic3r::Point offset{(i % grid_size) * step.x(), (i / grid_size) * step.y()};
+                for (Geometry::BoundedPolygon polygon : layer) {
+                    polygon.polygon.translate(offset);
+                    polygon.bounding_box.translate(offset);
+                    result_layer.push_back(std::move(polygon));
+                }
+            }
+        }
+        return result;
+    }()};
+
+    BENCHMARK_ADVANCED("Generate aligned seam multiple shells benchy")(Catch::Benchmark::Chronometer meter) {
+        std::vector<Shells::Shells<>> inputs;
+        inputs.reserve(meter.runs());
+        std::generate_n(std::back_inserter(inputs), meter.runs(), [&]() {
+            Slic3r::Seams::Perimeters::LayerPerimeters perimeters{
+                Slic3r::Seams::Perimeters::create_perimeters(
+                    projected_grid, layer_infos, painting, params.perimeter
+                )};
+            return Shells::create_shells(
+                std::move(perimeters), params.max_distance
+            );
+        });
+        meter.measure([&](const int i) {
+            return Aligned::get_object_seams(
+                std::move(inputs[i]), visibility_calculator, params.aligned
+            );
+        });
+    };
+
     BENCHMARK_ADVANCED("Generate rear seam benchy")(Catch::Benchmark::Chronometer meter) {
         std::vector<Perimeters::LayerPerimeters> inputs;
         inputs.reserve(meter.runs());
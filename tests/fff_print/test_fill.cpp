@@ -547,6 +547,57 @@ SCENARIO("Infill density zero", "[Fill]")
     }
 }
 
+TEST_CASE("Fill: zig-zag of a small surface of a large object", "[Fill]") {
+    // Only the zig-zag lines crossing the surface are intersected, the rest of the object wide pattern is skipped.
+    std::unique_ptr<Slic3r::Fill> filler(Slic3r::Fill::new_from_type("zigzag"));
+    filler->bounding_box = BoundingBox(Point::new_scale(0, 0), Point::new_scale(1000, 1000));
+    filler->spacing      = 0.5;
+    FillParams fill_params;
+    fill_params.density     = 1.f;
+    fill_params.dont_adjust = true;
+    const ExPolygon square(Polygon::new_scale({ {500, 500}, {520, 500}, {520, 520}, {500, 520} }));
+    for (float angle : { 0.f, float(PI / 4.), float(PI / 2.) }) {
+        filler->angle = angle;
+        Surface   surface(stInternalSolid, square);
+        Polylines paths = filler->fill_surface(&surface, fill_params);
+        REQUIRE(! paths.empty());
+        // Paths stay inside the surface.
+        CHECK(diff_pl(paths, offset(square, float(SCALED_EPSILON * 10))).empty());
+        // The whole surface is covered, thus the total length is close to area / spacing.
+        double length = std::accumulate(paths.begin(), paths.end(), 0., [](double acc, const Polyline &pl) { return acc + pl.length(); });
+        CHECK(unscaled(length) > 0.9 * 20. * 20. / filler->spacing);
+    }
+}
+
+TEST_CASE("Fill: connect_infill of a surface with many holes", "[Fill]") {
+    // 50x50mm square with 12x12 holes, the infill lines are connected along the contour and along all the holes.
+    ExPolygon expoly(Polygon::new_scale({ {0, 0}, {50, 0}, {50, 50}, {0, 50} }));
+    for (int i = 0; i < 12; ++ i)
+        for (int j = 0; j < 12; ++ j) {
+            Polygon hole = make_circle_num_segments(scaled<double>(1.2), 64);
+            hole.translate(Point::new_scale(3. + 4. * i, 3. + 4. * j));
+            hole.reverse();
+            expoly.holes.emplace_back(std::move(hole));
+        }
+    for (const char *pattern : { "grid", "gyroid" }) {
+        std::unique_ptr<Slic3r::Fill> filler(Slic3r::Fill::new_from_type(pattern));
+        filler->bounding_box = get_extents(expoly);
+        filler->spacing      = 0.45;
+        filler->angle        = float(PI / 4.);
+        filler->z            = 1.;
+        FillParams fill_params;
+        fill_params.density  = 0.3f;
+        Surface    surface(stInternal, expoly);
+        Polylines  paths = filler->fill_surface(&surface, fill_params);
+        REQUIRE(! paths.empty());
+        // The anchors are taken along the boundary, thus the paths stay inside the surface.
+        CHECK(diff_pl(paths, offset(expoly, float(SCALED_EPSILON * 10))).empty());
+        BENCHMARK(std::string("fill_surface with connect_infill, ") + pattern) {
+            return filler->fill_surface(&surface, fill_params);
+        };
+    }
+}
+
 /*
 {
     # GH: #2697
@@ -7,6 +7,12 @@
 #include <memory>
 #include <regex>
 #include <fstream>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/nowide/cstdio.hpp>
+#include <boost/nowide/fstream.hpp>
 
 #include "libslic3r/GCode.hpp"
 #include "libslic3r/Geometry/ConvexHull.hpp"
@@ -329,3 +335,187 @@ TEST_CASE("M201 for acceleation reset", "[GCode]") {
     INFO("M204 is not generated for repetier firmware");
     CHECK(!has_m204);
 }
+
+TEST_CASE("Compacted G-code moves match the processed moves", "[GCode]") {
+    DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config_with({
+        { "layer_height", 0.15 },
+        { "first_layer_height", 0.2 },
+        { "z_offset", 0.05 }
+    });
+
+    Print print;
+    Model model;
+    Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+    print.set_status_silent();
+    print.process();
+
+    boost::filesystem::path temp = boost::filesystem::unique_path();
+    GCodeProcessorResult result;
+    print.export_gcode(temp.string(), &result, nullptr);
+    boost::nowide::remove(temp.string().c_str());
+
+    REQUIRE(! result.moves.empty());
+    const std::vector<GCodeProcessorResult::MoveVertex> moves = result.moves;
+    result.compact_moves();
+    CHECK(result.moves.empty());
+    CHECK(result.has_moves());
+    REQUIRE(result.compacted_moves.size() == moves.size());
+    CHECK(result.compacted_moves.memory_used() < moves.size() * sizeof(GCodeProcessorResult::MoveVertex));
+
+    for (size_t i = 0; i < moves.size(); ++ i) {
+        const GCodeProcessorResult::MoveVertex &move = moves[i];
+        const GCodeProcessorResult::MoveVertex  restored = result.compacted_moves[i];
+        INFO("Move " << i);
+        CHECK(restored.gcode_id == move.gcode_id);
+        CHECK(restored.type == move.type);
+        CHECK(restored.extrusion_role == move.extrusion_role);
+        CHECK(restored.extruder_id == move.extruder_id);
+        CHECK(restored.layer_id == move.layer_id);
+        CHECK(restored.position.x() == move.position.x());
+        CHECK(restored.position.y() == move.position.y());
+        CHECK(restored.position.z() == Approx(move.position.z()).margin(0.5 * GCodeProcessorResult::CompactMoves::ZUnit));
+        CHECK(restored.delta_extruder == move.delta_extruder);
+        CHECK(restored.width == Approx(move.width).margin(GCodeProcessorResult::CompactMoves::WidthHeightUnit));
+        CHECK(restored.height == Approx(move.height).margin(GCodeProcessorResult::CompactMoves::WidthHeightUnit));
+        CHECK(restored.feedrate == Approx(move.feedrate).margin(GCodeProcessorResult::CompactMoves::FeedrateUnit));
+    }
+}
+
+TEST_CASE("G-code preview cache restores the processed result", "[GCode]") {
+    DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config_with({
+        { "layer_height", 0.15 },
+        { "first_layer_height", 0.2 }
+    });
+
+    Print print;
+    Model model;
+    Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+    print.set_status_silent();
+    print.process();
+
+    const std::string gcode_filename = boost::filesystem::unique_path().string();
+    const std::string cache_filename = GCodeProcessor::result_cache_filename(gcode_filename);
+    GCodeProcessorResult result;
+    print.export_gcode(gcode_filename, &result, nullptr);
+    result.compact_moves();
+    REQUIRE(GCodeProcessor::save_result_cache(result, gcode_filename));
+
+    SECTION("Unchanged G-code is loaded from the cache") {
+        GCodeProcessor processor;
+        REQUIRE(processor.load_result_cache(gcode_filename));
+        const GCodeProcessorResult &cached = processor.get_result();
+        CHECK(cached.filename == gcode_filename);
+        CHECK(cached.lines_ends == result.lines_ends);
+        CHECK(cached.extruders_count == result.extruders_count);
+        CHECK(cached.print_statistics.volumes_per_extruder == result.print_statistics.volumes_per_extruder);
+        CHECK(cached.print_statistics.modes[0].time == result.print_statistics.modes[0].time);
+        REQUIRE(cached.compacted_moves.size() == result.compacted_moves.size());
+        for (size_t i = 0; i < result.compacted_moves.size(); ++ i) {
+            const GCodeProcessorResult::MoveVertex move        = result.compacted_moves[i];
+            const GCodeProcessorResult::MoveVertex cached_move = cached.compacted_moves[i];
+            INFO("Move " << i);
+            CHECK(cached_move.gcode_id == move.gcode_id);
+            CHECK(cached_move.type == move.type);
+            CHECK(cached_move.layer_id == move.layer_id);
+            CHECK(cached_move.position == move.position);
+            CHECK(cached_move.width == move.width);
+            CHECK(cached_move.time == move.time);
+        }
+    }
+
+    SECTION("Modified G-code is not loaded from the cache") {
+        {
+            boost::nowide::ofstream file(gcode_filename, std::ios::app | std::ios::binary);
+            file << "; modified\n";
+        }
+        GCodeProcessor processor;
+        CHECK(! processor.load_result_cache(gcode_filename));
+    }
+
+    boost::nowide::remove(gcode_filename.c_str());
+    boost::nowide::remove(cache_filename.c_str());
+}
+
+TEST_CASE("G-code post processed in place matches the rewritten G-code", "[GCode]") {
+    auto export_gcode = [](bool remaining_times, GCodeProcessorResult &result) {
+        DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config_with({
+            { "remaining_times", remaining_times },
+            { "gcode_flavor", "marlin2" }
+        });
+        Print print;
+        Model model;
+        Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+        print.set_status_silent();
+        print.process();
+        boost::filesystem::path temp = boost::filesystem::unique_path();
+        print.export_gcode(temp.string(), &result, nullptr);
+        boost::nowide::ifstream file(temp.string(), std::ios::binary);
+        std::string gcode((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+        boost::nowide::remove(temp.string().c_str());
+        return gcode;
+    };
+
+    // Without M73 lines, only the statistics at the end of the G-code are rewritten.
+    GCodeProcessorResult result_in_place;
+    const std::string    gcode_in_place = export_gcode(false, result_in_place);
+    GCodeProcessorResult result_rewritten;
+    const std::string    gcode_rewritten = export_gcode(true, result_rewritten);
+
+    auto remove_M73_lines = [](const std::string &gcode) {
+        std::string out;
+        std::istringstream lines(gcode);
+        for (std::string line; std::getline(lines, line);)
+            // Skip also the time stamp, which may differ.
+            if (! boost::starts_with(line, "M73 ") && line.find("remaining_times") == std::string::npos && ! boost::starts_with(line, "; generated by"))
+                out += line + "\n";
+        return out;
+    };
+    CHECK(gcode_in_place.find(GCodeProcessor::reserved_tag(GCodeProcessor::ETags::Estimated_Printing_Time_Placeholder)) == std::string::npos);
+    CHECK(gcode_in_place.find("; estimated printing time (normal mode) = ") != std::string::npos);
+    CHECK(remove_M73_lines(gcode_in_place) == remove_M73_lines(gcode_rewritten));
+
+    const std::vector<size_t> &lines_ends = result_in_place.lines_ends.front();
+    REQUIRE(! lines_ends.empty());
+    CHECK(lines_ends.back() == gcode_in_place.size());
+    CHECK(size_t(std::count(gcode_in_place.begin(), gcode_in_place.end(), '\n')) == lines_ends.size());
+    CHECK(std::is_sorted(lines_ends.begin(), lines_ends.end()));
+}
+
+TEST_CASE("Partial G-code preview data is published while exporting", "[GCode]") {
+    DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config_with({
+        { "layer_height", 0.2 },
+        { "first_layer_height", 0.2 }
+    });
+    Print print;
+    Model model;
+    Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+    print.set_status_silent();
+    print.process();
+
+    std::vector<GCodeProcessorResult> partial_results;
+    GCodeProcessorResult result;
+    boost::filesystem::path temp = boost::filesystem::unique_path();
+    print.export_gcode(temp.string(), &result, nullptr, [&partial_results](GCodeProcessorResult &&partial_result) {
+        partial_results.emplace_back(std::move(partial_result));
+    });
+    boost::nowide::remove(temp.string().c_str());
+
+    // 100 layers, published after 10, 20, 40 and 80 layers.
+    REQUIRE(partial_results.size() == 4);
+    unsigned int max_layer_id = 0;
+    for (const GCodeProcessorResult::MoveVertex &move : partial_results.front().moves)
+        max_layer_id = std::max(max_layer_id, move.layer_id);
+    CHECK(max_layer_id <= 10);
+    for (size_t i = 0; i < partial_results.size(); ++ i) {
+        const GCodeProcessorResult &partial_result = partial_results[i];
+        CHECK(partial_result.filename.empty());
+        CHECK(partial_result.lines_ends.empty());
+        CHECK(partial_result.id != result.id);
+        CHECK(partial_result.moves.size() < result.compacted_moves.size() + result.moves.size());
+        if (i > 0) {
+            CHECK(partial_result.id != partial_results[i - 1].id);
+            CHECK(partial_result.moves.size() > partial_results[i - 1].moves.size());
+        }
+    }
+}
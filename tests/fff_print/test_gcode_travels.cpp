@@ -179,6 +179,11 @@ TEST_CASE("Get first crossed line distance", "[GCode]") {
     CHECK(get_first_crossed_line_distance(tcb::span{travel}.subspan(4), distancer) == Approx(0.7));
     CHECK(get_first_crossed_line_distance(tcb::span{travel}.subspan(5), distancer) == Approx(1.6));
     CHECK(get_first_crossed_line_distance(tcb::span{travel}.subspan(6), distancer) == std::numeric_limits<double>::max());
+
+    // Intersections further than max_distance are not searched for.
+    const auto any_line = [](const GCode::ObjectOrExtrusionLinef &) { return true; };
+    CHECK(get_first_crossed_line_distance(travel, distancer, {}, any_line, true, 2.) == Approx(1));
+    CHECK(get_first_crossed_line_distance(travel, distancer, {}, any_line, true, 0.5) >= 0.5);
 }
 
 
@@ -195,6 +195,21 @@ SCENARIO("Find/Replace with regexp", "[GCodeFindReplace]") {
                 "G1 X13 Y32 Z1; infill\n"
                 "G1 X13 Y32 Z1; wipe\n");
         }
+        // Substitutions are applied in sequence, each one to the output of the previous one.
+        WHEN("Chained regular expression and plain substitutions") {
+            GCodeFindReplace find_replace({ "X13", "X14", "", "", "; (in|w)", "; wiped ${1}", "r", "", "X14 Y32", "X15 Y33", "", "", "wiped w", "wipe", "", "" });
+            REQUIRE(find_replace.process_layer(gcode) ==
+                "G1 Z0; home\n"
+                "G1 Z1; move up\n"
+                "G1 X0 Y1 Z1; perimeter\n"
+                // substituted
+                "G1 X15 Y33 Z1; wiped infill\n"
+                "G1 X15 Y33 Z1; wipeipe\n");
+        }
+        WHEN("None of multiple substitutions matches") {
+            GCodeFindReplace find_replace({ "move sideways", "move down", "", "", "X[0-9]+ Y99", "", "r", "", "PERIMETER", "", "w", "" });
+            REQUIRE(find_replace.process_layer(gcode) == gcode);
+        }
         // Multi-line replace, whole word, fails.
         WHEN("Replace \"move up\\nG1 X\" with \"move down\\nG0 X\", whole word") {
             GCodeFindReplace find_replace({ "move up\\nG1 X", "move down\\nG0 X", "rw", "" });
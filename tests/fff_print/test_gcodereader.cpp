@@ -0,0 +1,117 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/nowide/cstdio.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include "libslic3r/GCodeReader.hpp"
+
+using namespace Slic3r;
+
+namespace {
+
+struct ParsedLine
+{
+    std::string raw;
+    std::string cmd;
+    bool        has_x;
+    float       x;
+    float       e;
+};
+
+std::vector<ParsedLine> parse(const std::string &gcode, bool from_file, std::vector<size_t> *lines_ends = nullptr)
+{
+    std::vector<ParsedLine> out;
+    GCodeReader reader;
+    auto callback = [&out](GCodeReader &reader, const GCodeReader::GCodeLine &line) {
+        out.push_back({ line.raw(), std::string(line.cmd()), line.has_x(), line.x(), reader.e() });
+    };
+    if (from_file) {
+        boost::filesystem::path temp = boost::filesystem::unique_path();
+        {
+            boost::nowide::ofstream file(temp.string(), std::ios::binary);
+            file << gcode;
+        }
+        std::vector<std::vector<size_t>> ends;
+        REQUIRE(reader.parse_file(temp.string(), callback, ends));
+        boost::nowide::remove(temp.string().c_str());
+        if (lines_ends != nullptr)
+            *lines_ends = ends.front();
+    } else
+        reader.parse_buffer(gcode, callback);
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("GCodeReader parses a memory mapped file the same way as a buffer", "[GCodeReader]") {
+    const std::string gcode = "G1 X10 Y20 E1.5 ; first\r\nM104 S200\n\n;TYPE:Perimeter\nG1 X11.25 E2";
+
+    std::vector<size_t>     lines_ends;
+    std::vector<ParsedLine> from_file   = parse(gcode, true, &lines_ends);
+    std::vector<ParsedLine> from_buffer = parse(gcode, false);
+
+    REQUIRE(from_file.size() == 5);
+    REQUIRE(from_buffer.size() == from_file.size());
+    for (size_t i = 0; i < from_file.size(); ++ i) {
+        CHECK(from_file[i].raw == from_buffer[i].raw);
+        CHECK(from_file[i].cmd == from_buffer[i].cmd);
+        CHECK(from_file[i].has_x == from_buffer[i].has_x);
+        CHECK(from_file[i].x == from_buffer[i].x);
+    }
+    CHECK(from_file[0].raw == "G1 X10 Y20 E1.5 ; first");
+    CHECK(from_file[0].x == 10.f);
+    CHECK(from_file[1].cmd == "M104");
+    CHECK(from_file[2].raw.empty());
+    CHECK(from_file[3].raw == ";TYPE:Perimeter");
+    // The last line is not terminated by a newline.
+    CHECK(from_file[4].raw == "G1 X11.25 E2");
+    CHECK(from_file[4].x == 11.25f);
+    // Position of the reader is updated after the callback.
+    CHECK(from_file[4].e == 1.5f);
+    CHECK(lines_ends == std::vector<size_t>{ 25, 35, 36, 52 });
+}
+
+TEST_CASE("GCodeReader parses a large file in parallel the same way as a buffer", "[GCodeReader]") {
+    // Large enough to be split into multiple chunks tokenized in parallel.
+    std::string gcode;
+    for (int i = 0; gcode.size() < 4 * 1024 * 1024; ++ i) {
+        gcode += ";LAYER_CHANGE\n;Z:" + std::to_string(i) + "\r\n";
+        gcode += "G1 X" + std::to_string(i % 200) + " Y" + std::to_string(i % 100) + ".5 E" + std::to_string(i) + ".25 ; move\n";
+    }
+    gcode += "G1 X1 E0.5";
+
+    std::vector<size_t>     lines_ends;
+    std::vector<ParsedLine> from_file   = parse(gcode, true, &lines_ends);
+    std::vector<ParsedLine> from_buffer = parse(gcode, false);
+
+    REQUIRE(from_file.size() == from_buffer.size());
+    size_t num_mismatches = 0;
+    for (size_t i = 0; i < from_file.size(); ++ i)
+        if (from_file[i].raw != from_buffer[i].raw || from_file[i].cmd != from_buffer[i].cmd || from_file[i].has_x != from_buffer[i].has_x ||
+            from_file[i].x != from_buffer[i].x || from_file[i].e != from_buffer[i].e)
+            ++ num_mismatches;
+    CHECK(num_mismatches == 0);
+    CHECK(from_file.back().raw == "G1 X1 E0.5");
+    CHECK(lines_ends.size() == from_file.size() - 1);
+    CHECK(lines_ends.back() == gcode.size() - 10);
+}
+
+TEST_CASE("GCodeReader parses an empty file", "[GCodeReader]") {
+    CHECK(parse(std::string(), true).empty());
+}
+
+TEST_CASE("GCodeLine modified by set() keeps its own copy", "[GCodeReader]") {
+    GCodeReader reader;
+    std::string modified;
+    reader.parse_buffer("G1 X10 Y20\n", [&modified](GCodeReader &reader, const GCodeReader::GCodeLine &line) {
+        GCodeReader::GCodeLine copy(line);
+        copy.set(reader, X, 12.5f, 1);
+        modified = copy.raw();
+        CHECK(line.raw() == "G1 X10 Y20");
+    });
+    CHECK(modified == "G1 X12.5 Y20");
+}
@@ -32,3 +32,18 @@ SCENARIO("set_speed emits values with fixed-point output.", "[GCodeWriter]") {
         }
     }
 }
+
+SCENARIO("set_speed appends to an existing G-code buffer.", "[GCodeWriter]") {
+
+    GIVEN("GCodeWriter instance and a non-empty buffer") {
+        GCodeWriter writer;
+        std::string gcode = "G1 X1 Y1\n";
+        WHEN("set_speed is called twice to append speeds 1 and 203.200522") {
+            writer.set_speed(gcode, 1.0);
+            writer.set_speed(gcode, 203.200522);
+            THEN("Both lines are appended in order") {
+                REQUIRE_THAT(gcode, Catch::Equals("G1 X1 Y1\nG1 F1\nG1 F203.201\n"));
+            }
+        }
+    }
+}
@@ -63,3 +63,59 @@ SCENARIO("Model construction", "[Model]") {
         }
     }
 }
+
+SCENARIO("Model volume meshes are shared until modified", "[Model]") {
+    GIVEN("A model object with a volume and its copy") {
+        Slic3r::Model model;
+        Slic3r::ModelObject *model_object = model.add_object();
+        Slic3r::ModelVolume *volume = model_object->add_volume(Slic3r::make_cube(20, 20, 20));
+        Slic3r::ModelVolume *copy   = model_object->add_volume(*volume);
+        THEN("The copy shares the mesh and the convex hull") {
+            REQUIRE(copy->mesh_ptr() == volume->mesh_ptr());
+            REQUIRE(copy->get_convex_hull_shared_ptr() == volume->get_convex_hull_shared_ptr());
+        }
+        WHEN("The copy is scaled") {
+            const std::shared_ptr<const Slic3r::TriangleMesh> original_mesh = volume->mesh_ptr();
+            copy->scale_geometry_after_creation(2.f);
+            THEN("The copy gets its own scaled mesh") {
+                REQUIRE(copy->mesh_ptr() != volume->mesh_ptr());
+                REQUIRE(copy->mesh().bounding_box().size().x() == Approx(40.));
+                REQUIRE(copy->get_convex_hull().bounding_box().size().x() == Approx(40.));
+            }
+            THEN("The original mesh is left intact") {
+                REQUIRE(volume->mesh_ptr() == original_mesh);
+                REQUIRE(volume->mesh().bounding_box().size().x() == Approx(20.));
+                REQUIRE(volume->get_convex_hull().bounding_box().size().x() == Approx(20.));
+            }
+        }
+        WHEN("The original is transformed") {
+            volume->transform_this_mesh(Slic3r::Geometry::scale_transform(0.5), false);
+            THEN("The copy is left intact") {
+                REQUIRE(copy->mesh().bounding_box().size().x() == Approx(20.));
+                REQUIRE(volume->mesh().bounding_box().size().x() == Approx(10.));
+            }
+        }
+    }
+}
+
+SCENARIO("Model object 2D convex hull", "[Model]") {
+    GIVEN("A sphere above the print bed") {
+        Slic3r::Model model;
+        Slic3r::ModelObject *model_object = model.add_object();
+        model_object->add_volume(Slic3r::TriangleMesh(Slic3r::its_make_sphere(10., 2. * PI / 60.)));
+        model_object->add_instance();
+        const Transform3d trafo = Slic3r::Geometry::translation_transform(Vec3d(5., 5., 12.));
+        THEN("The hull projected from the convex hull matches the hull projected from the mesh") {
+            const Polygon from_mesh = its_convex_hull_2d_above(model_object->volumes.front()->mesh().its, trafo.cast<float>(), 0.f);
+            const Polygon hull      = model_object->convex_hull_2d(trafo);
+            REQUIRE(hull.area() == Approx(from_mesh.area()));
+        }
+        WHEN("The sphere is sunk half way below the print bed") {
+            const Transform3d sunk = Slic3r::Geometry::translation_transform(Vec3d(5., 5., 0.));
+            THEN("The hull is still calculated from the part above the print bed") {
+                const Polygon from_mesh = its_convex_hull_2d_above(model_object->volumes.front()->mesh().its, sunk.cast<float>(), 0.f);
+                REQUIRE(model_object->convex_hull_2d(sunk).area() == Approx(from_mesh.area()));
+            }
+        }
+    }
+}
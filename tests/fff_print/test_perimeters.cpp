@@ -54,7 +54,7 @@ SCENARIO("Perimeter nesting", "[Perimeters]")
             static_cast<const PrintObjectConfig&>(config),
             static_cast<const PrintConfig&>(config),
             false); // spiral_vase
-        Polygons lower_layer_polygons_cache;
+        PerimeterGenerator::LowerSlicesCache lower_layer_polygons_cache;
         for (const Surface &surface : slices)
         // FIXME Lukas H.: Disable this test for Arachne because it is failing and needs more investigation.
 //        if (config.perimeter_generator == PerimeterGeneratorType::Arachne)
@@ -628,3 +628,34 @@ SCENARIO("Seam alignment", "[Perimeters]")
         test(Slic3r::Test::TestMesh::small_dorito);
     }
 }
+
+TEST_CASE("Perimeters of identical layers are reused", "[Perimeters]")
+{
+    const std::string perimeter_generator = GENERATE("classic", "arachne");
+    Print print;
+    Test::init_and_process_print({ Test::TestMesh::cube_20x20x20 }, print, {
+        { "perimeter_generator", perimeter_generator },
+        { "perimeters",          3 }
+    });
+    PrintObject &object = *print.get_object(0);
+    REQUIRE(object.layer_count() > 10);
+
+    auto perimeter_polylines = [](const Layer &layer) {
+        Polylines out;
+        for (const LayerRegion *layerm : layer.regions())
+            layerm->perimeters().collect_polylines(out);
+        return out;
+    };
+    // Middle layers of a cube are identical, all of them copy the perimeters of the lowest one.
+    Layer          &layer    = *object.get_layer(int(object.layer_count() / 2));
+    const Polylines reused   = perimeter_polylines(layer);
+    REQUIRE(! reused.empty());
+    CHECK(reused == perimeter_polylines(*object.get_layer(2)));
+    REQUIRE(layer.lslices_ex.size() == 1);
+    REQUIRE(layer.lslices_ex.front().islands.size() == 1);
+    CHECK(! layer.lslices_ex.front().islands.front().perimeters.empty());
+
+    // Generating the perimeters of the layer again produces the same result.
+    layer.make_perimeters();
+    CHECK(perimeter_polylines(layer) == reused);
+}
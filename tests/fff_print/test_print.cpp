@@ -1,5 +1,8 @@
 #include <catch2/catch.hpp>
 
+#include <chrono>
+#include <thread>
+
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/Print.hpp"
 #include "libslic3r/Layer.hpp"
@@ -30,6 +33,120 @@ SCENARIO("PrintObject: Perimeter generation", "[PrintObject]") {
     }
 }
 
+SCENARIO("Print: identical objects share a PrintObject", "[Print]") {
+    GIVEN("Two 20mm cubes loaded as separate objects") {
+        Slic3r::Print print;
+        Slic3r::Model model;
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+        Slic3r::Test::init_print({ TestMesh::cube_20x20x20, TestMesh::cube_20x20x20 }, print, model, config);
+        REQUIRE(model.objects.size() == 2);
+        THEN("The cubes are sliced once as two instances of a single PrintObject") {
+            REQUIRE(print.objects().size() == 1);
+            REQUIRE(print.objects().front()->instances().size() == 2);
+            REQUIRE(print.get_print_object_by_model_object_id(model.objects[1]->id()) == print.objects().front());
+        }
+        WHEN("The config of one of the cubes is modified") {
+            model.objects[1]->config.set("perimeters", 5);
+            print.apply(model, config);
+            THEN("The cubes are sliced separately") {
+                REQUIRE(print.objects().size() == 2);
+                REQUIRE(print.objects()[0]->instances().size() == 1);
+                REQUIRE(print.objects()[1]->instances().size() == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("Print: canceled processing unwinds within the latency target", "[Print]") {
+    GIVEN("A 50mm sphere with Arachne perimeters and organic supports") {
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({ TestMesh::sphere_50mm }, print, model, {
+            { "perimeter_generator",    "arachne" },
+            { "perimeters",             5 },
+            { "layer_height",           0.1 },
+            { "fill_density",           "20%" },
+            { "support_material",       1 },
+            { "support_material_style", "organic" }
+        });
+        THEN("Processing canceled at various stages stops at a cancel point in time") {
+            // The steps finished before a cancellation stay valid, thus each run cancels a later stage of the processing.
+            for (int delay_ms : { 10, 50, 100, 200, 400 }) {
+                bool                      canceled = false;
+                std::chrono::microseconds latency { 0 };
+                std::thread worker([&print, &canceled, &latency]() {
+                    try {
+                        print.process();
+                    } catch (const CanceledException &) {
+                        canceled = true;
+                        latency  = print.cancel_latency();
+                    }
+                });
+                std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+                print.cancel();
+                worker.join();
+                print.finalize();
+                print.cleanup();
+                print.restart();
+                if (canceled)
+                    REQUIRE(latency.count() <= std::chrono::duration_cast<std::chrono::microseconds>(PrintBase::cancel_latency_target).count());
+            }
+        }
+    }
+}
+
+SCENARIO("Print: processing limited to the task arena of the print", "[Print]") {
+    GIVEN("20mm cube and a print limited to 2 threads") {
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({ TestMesh::cube_20x20x20 }, print, model, { { "fill_density", "20%" } });
+        print.set_max_concurrency(2);
+        THEN("The TBB algorithms launched by the print see the concurrency of its arena") {
+            int concurrency = 0;
+            print.execute_in_arena([&print, &concurrency]() {
+                concurrency = tbb::this_task_arena::max_concurrency();
+                print.process();
+            });
+            REQUIRE(concurrency == 2);
+            REQUIRE(print.finished());
+        }
+        THEN("Exceptions thrown inside the arena are passed to the caller") {
+            print.cancel();
+            REQUIRE_THROWS_AS(print.execute_in_arena([&print]() { print.process(); }), CanceledException);
+        }
+    }
+}
+
+SCENARIO("Print: sequential print clearance of moved instances", "[Print]") {
+    GIVEN("Two arranged instances of a 20mm cube printed sequentially") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config_with({
+            { "complete_objects",           true },
+            { "extruder_clearance_radius",  10 }
+        });
+        Print print;
+        Model model;
+        Slic3r::Test::init_print({ TestMesh::cube_20x20x20 }, print, model, config, false, 2);
+        THEN("the arranged instances do not collide") {
+            REQUIRE(Print::sequential_print_horizontal_clearance_valid(print));
+        }
+        WHEN("an instance is moved next to another one and back") {
+            ModelInstance *moved   = model.objects.front()->instances[1];
+            const Vec3d    offset  = moved->get_offset();
+            moved->set_offset(model.objects.front()->instances[0]->get_offset() + Vec3d(25., 0., 0.));
+            print.apply(model, config);
+            Polygons collisions;
+            const bool valid = Print::sequential_print_horizontal_clearance_valid(print, &collisions);
+            moved->set_offset(offset);
+            print.apply(model, config);
+            THEN("the collision is reported until the instance is moved back") {
+                REQUIRE(! valid);
+                REQUIRE(collisions.size() == 2);
+                REQUIRE(Print::sequential_print_horizontal_clearance_valid(print));
+            }
+        }
+    }
+}
+
 SCENARIO("Print: Skirt generation", "[Print]") {
     GIVEN("20mm cube and default config") {
         WHEN("Skirts is set to 2 loops")  {
@@ -1,8 +1,15 @@
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
+
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/Print.hpp"
 #include "libslic3r/Layer.hpp"
+#include "libslic3r/LayerSpill.hpp"
+#include "libslic3r/MemoryUsage.hpp"
+#include "libslic3r/SlicingAdaptive.hpp"
 
 #include "test_data.hpp"
 
@@ -87,3 +94,152 @@ SCENARIO("PrintObject: object layer heights", "[PrintObject]") {
 #endif
     }
 }
+
+SCENARIO("PrintObject: adaptive layer height profile", "[PrintObject]") {
+    GIVEN("50mm sphere") {
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({TestMesh::sphere_50mm}, print, model, {
+            { "layer_height",       0.2 },
+            { "min_layer_height",   0.07 },
+            { "max_layer_height",   0.25 }
+        });
+        const ModelObject       &model_object = *model.objects.front();
+        const SlicingParameters &params       = print.objects().front()->slicing_parameters();
+        WHEN("the faces are collected once for all the quality factors") {
+            SlicingAdaptive slicing_adaptive;
+            slicing_adaptive.prepare(model_object);
+            std::vector<double> profile_fine   = layer_height_profile_adaptive(params, slicing_adaptive, 0.f);
+            std::vector<double> profile_coarse = layer_height_profile_adaptive(params, slicing_adaptive, 1.f);
+            slicing_adaptive.prepare(model_object);
+            THEN("the profiles match the profiles collecting the faces for each quality") {
+                REQUIRE(profile_fine == layer_height_profile_adaptive(params, model_object, 0.f));
+                REQUIRE(profile_coarse == layer_height_profile_adaptive(params, model_object, 1.f));
+                REQUIRE(layer_height_profile_adaptive(params, slicing_adaptive, 0.5f) == layer_height_profile_adaptive(params, model_object, 0.5f));
+            }
+            THEN("the lower quality produces less layers") {
+                REQUIRE(profile_coarse.size() < profile_fine.size());
+            }
+        }
+    }
+}
+
+SCENARIO("PrintObject: spilling of the intermediate layer data", "[PrintObject][LayerSpill]") {
+    GIVEN("20mm cube with infill") {
+        Slic3r::Print print;
+        Slic3r::Test::init_and_process_print({TestMesh::cube_20x20x20}, print, { { "fill_density", "20%" } });
+        PrintObject &object = *print.get_object(0);
+        std::vector<ExPolygons> fill_expolygons;
+        for (const Layer *layer : object.layers())
+            fill_expolygons.emplace_back(layer->regions().front()->fill_expolygons());
+        REQUIRE(LayerSpill::spillable_memory(object) > 0);
+        REQUIRE(LayerSpill::layers_memory(object) > LayerSpill::spillable_memory(object));
+        WHEN("the layer data is spilled") {
+            const std::string path = LayerSpill::spill(object);
+            REQUIRE(! path.empty());
+            THEN("the intermediate data is released") {
+                CHECK(LayerSpill::spillable_memory(object) == 0);
+                for (const Layer *layer : object.layers())
+                    CHECK(layer->regions().front()->fill_expolygons().empty());
+            }
+            THEN("the G-code is still exported") {
+                CHECK(! Slic3r::Test::gcode(print).empty());
+            }
+            AND_WHEN("the layer data is restored") {
+                LayerSpill::restore(object, path);
+                THEN("it matches the original data") {
+                    for (size_t i = 0; i < object.layers().size(); ++ i)
+                        CHECK(object.layers()[i]->regions().front()->fill_expolygons() == fill_expolygons[i]);
+                }
+                THEN("the file is deleted") {
+                    CHECK(! boost::filesystem::exists(path));
+                }
+            }
+            LayerSpill::discard(path);
+        }
+    }
+}
+
+SCENARIO("PrintObject: memory accounting of the steps", "[PrintObject][MemoryUsage]") {
+    GIVEN("20mm cube with infill and memory accounting enabled") {
+        const bool enabled = MemoryAccounting::enabled();
+        MemoryAccounting::enable(true);
+        Slic3r::Print print;
+        Slic3r::Test::init_and_process_print({TestMesh::cube_20x20x20}, print, { { "fill_density", "20%" } });
+        MemoryAccounting::enable(enabled);
+        const std::vector<MemoryUsageRecord> records = print.memory_usage_records();
+        auto find = [&records](const char *step_name) {
+            auto it = std::find_if(records.begin(), records.end(), [step_name](const MemoryUsageRecord &r) { return r.step_name == step_name; });
+            REQUIRE(it != records.end());
+            return it->usage;
+        };
+        THEN("each step is sampled once") {
+            CHECK(records.size() == posCount);
+        }
+        THEN("the counters follow the steps") {
+            MemoryUsage sliced = find("posSlice");
+            CHECK(sliced.slices > 0);
+            CHECK(sliced.perimeters == 0);
+            CHECK(find("posPerimeters").perimeters > 0);
+            CHECK(find("posInfill").fills > 0);
+        }
+        THEN("the last sample matches the current memory usage") {
+            CHECK(find("posCalculateOverhangingPerimeters").total() == print.objects().front()->memory_usage().total());
+        }
+        THEN("the report is exported as JSON") {
+            const std::string json = MemoryAccounting::to_json(records);
+            CHECK(json.find("\"posPerimeters\"") != std::string::npos);
+            CHECK(json.find("\"fill_surfaces\"") != std::string::npos);
+        }
+        THEN("the allocations are counted per step if compiled with the allocation profiling") {
+            auto it = std::find_if(records.begin(), records.end(), [](const MemoryUsageRecord &r) { return r.step_name == "posSlice"; });
+            REQUIRE(it != records.end());
+            if (AllocationCounters::enabled()) {
+                CHECK(it->allocations.count > 0);
+                CHECK(it->allocations.bytes >= it->allocations.count);
+            } else
+                CHECK(it->allocations.count == 0);
+        }
+    }
+}
+
+SCENARIO("PrintObject: infill invalidated by a layer range modifier", "[PrintObject]") {
+    GIVEN("20mm cube with the fill angle modified by a layer range in its upper half") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config_with({ { "fill_density", "20%" }, { "layer_height", 0.2 } });
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+        auto set_range_fill_angle = [&model](double fill_angle) {
+            ModelConfig &range_config = model.objects.front()->layer_config_ranges[{ 10., 20. }];
+            range_config.set_key_value("layer_height", new ConfigOptionFloat(0.2));
+            range_config.set_key_value("fill_angle", new ConfigOptionFloat(fill_angle));
+        };
+        set_range_fill_angle(30.);
+        print.apply(model, config);
+        print.process();
+        const PrintObject &object = *print.objects().front();
+        auto first_fill = [&object](double z) {
+            auto it = std::find_if(object.layers().begin(), object.layers().end(), [z](const Layer *layer) { return layer->slice_z > z; });
+            REQUIRE(it != object.layers().end());
+            REQUIRE(! (*it)->regions().front()->fills().empty());
+            return (*it)->regions().front()->fills().entities.front();
+        };
+        const ExtrusionEntity *lower_fill = first_fill(5.);
+        const ExtrusionEntity *upper_fill = first_fill(15.);
+        WHEN("the fill angle of the layer range is changed") {
+            set_range_fill_angle(60.);
+            print.apply(model, config);
+            THEN("the infill is invalidated") {
+                CHECK(! object.is_step_done(posInfill));
+            }
+            AND_WHEN("the print is processed again") {
+                print.process();
+                THEN("only the infill of the layer range is regenerated") {
+                    CHECK(first_fill(5.) == lower_fill);
+                    CHECK(first_fill(15.) != upper_fill);
+                    CHECK(! Slic3r::Test::gcode(print).empty());
+                }
+            }
+        }
+    }
+}
@@ -129,6 +129,20 @@ TEST_CASE_METHOD(Test::SeamsFixture, "Generate aligned seam", "[Seams][SeamAlign
     }
 }
 
+TEST_CASE_METHOD(Test::SeamsFixture, "Visibility is valid for unchanged geometry", "[Seams][SeamAligned][Integration]") {
+    CHECK(visibility.is_valid_for(transformation, volumes, params.visibility));
+
+    Transform3d moved{transformation};
+    moved.translate(Vec3d{1.0, 0.0, 0.0});
+    CHECK(!visibility.is_valid_for(moved, volumes, params.visibility));
+
+    Slic3r::ModelInfo::Visibility::Params denser{params.visibility};
+    denser.raycasting_visibility_samples_count *= 2;
+    CHECK(!visibility.is_valid_for(transformation, volumes, denser));
+
+    CHECK(!visibility.is_valid_for(transformation, ModelVolumePtrs{}, params.visibility));
+}
+
 TEST_CASE_METHOD(Test::SeamsFixture, "Calculate visibility", "[Seams][SeamAligned][Integration]") {
     if constexpr (debug_files) {
         std::ofstream csv{"visibility.csv"};
@@ -237,6 +237,38 @@ SCENARIO("SupportMaterial: Checking bridge speed", "[SupportMaterial]")
 
 #endif
 
+SCENARIO("SupportMaterial: organic supports reuse the collision and avoidance areas", "[SupportMaterial]")
+{
+    GIVEN("an overhang with organic supports") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config_with({
+            { "support_material",                  1 },
+            { "support_material_style",            "organic" },
+            { "support_material_interface_layers", 2 }
+        });
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({ TestMesh::overhang }, print, model, config);
+        print.process();
+        REQUIRE(print.get_object(0)->tree_model_volumes_cache());
+        WHEN("the number of the support interface layers is changed") {
+            config.set_deserialize_strict({ { "support_material_interface_layers", 3 } });
+            print.apply(model, config);
+            print.process();
+            THEN("the supports match the supports generated from scratch") {
+                Slic3r::Print print_fresh;
+                Slic3r::Test::init_and_process_print({ TestMesh::overhang }, print_fresh, config);
+                auto support_islands = [](const Slic3r::Print &print) {
+                    std::vector<ExPolygons> out;
+                    for (const SupportLayer *layer : print.objects().front()->support_layers())
+                        out.emplace_back(layer->support_islands);
+                    return out;
+                };
+                CHECK(! support_islands(print).empty());
+                CHECK(support_islands(print) == support_islands(print_fresh));
+            }
+        }
+    }
+}
 
 /* 
 
@@ -5,6 +5,7 @@
 #include <libslic3r/TriangleMesh.hpp>
 #include <libslic3r/AABBTreeIndirect.hpp>
 #include <libslic3r/AABBTreeLines.hpp>
+#include <libslic3r/AABBTreeWide.hpp>
 
 using namespace Slic3r;
 
@@ -61,6 +62,141 @@ TEST_CASE("Building a tree over a box, ray caster and closest query", "[AABBIndi
     REQUIRE(closest_point.z() == Approx(1.));
 }
 
+TEST_CASE("Ray packets hit the same triangles as single rays", "[AABBIndirect]")
+{
+    indexed_triangle_set its = its_make_sphere(1., PI / 32.);
+    its_merge(its, its_make_cube(1., 1., 1.));
+
+    auto tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices);
+
+    constexpr size_t N = 8;
+    std::vector<Vec3d> origins, dirs;
+    for (size_t i = 0; i < 5 * N + 3; ++ i) {
+        double a = 2. * PI * double(i) / 43.;
+        origins.emplace_back(0.1 * std::cos(a), 0.1 * std::sin(3. * a), -5. + 0.01 * double(i));
+        // Some of the rays miss the meshes.
+        dirs.emplace_back(Vec3d(std::cos(a), std::sin(a), i % 3 ? 4. : 0.2).normalized());
+    }
+
+    std::vector<igl::Hit> hits(origins.size(), igl::Hit{ -1, -1, 0.f, 0.f, std::numeric_limits<float>::infinity() });
+    for (size_t i = 0; i < origins.size(); i += N) {
+        size_t   count = std::min(N, origins.size() - i);
+        uint32_t mask  = AABBTreeIndirect::intersect_ray_packet_first_hit<N>(
+            its.vertices, its.indices, tree, origins.data() + i, dirs.data() + i, count, hits.data() + i);
+
+        for (size_t j = 0; j < count; ++ j) {
+            igl::Hit hit;
+            bool     intersected = AABBTreeIndirect::intersect_ray_first_hit(
+                its.vertices, its.indices, tree, origins[i + j], dirs[i + j], hit);
+            REQUIRE(intersected == bool(mask & (uint32_t(1) << j)));
+            if (intersected) {
+                REQUIRE(hits[i + j].id == hit.id);
+                REQUIRE(hits[i + j].t == hit.t);
+            }
+        }
+    }
+}
+
+// Sphere, a cube and a small dense sphere, so that the triangles are not distributed evenly.
+static indexed_triangle_set wide_tree_test_mesh(double resolution)
+{
+    indexed_triangle_set its = its_make_sphere(1., resolution);
+    its_merge(its, its_make_cube(1., 1., 1.));
+    indexed_triangle_set small = its_make_sphere(0.1, resolution);
+    its_translate(small, Vec3f(1.5f, 0.f, 0.f));
+    its_merge(its, small);
+    return its;
+}
+
+static void wide_tree_test_rays(size_t count, std::vector<Vec3d> &origins, std::vector<Vec3d> &dirs)
+{
+    for (size_t i = 0; i < count; ++ i) {
+        double a = 2. * PI * double(i) / double(count);
+        origins.emplace_back(3. * std::cos(7. * a), 3. * std::sin(5. * a), 3. * std::cos(3. * a));
+        // Some of the rays miss the meshes, some of them are axis parallel.
+        Vec3d target(2. * std::sin(11. * a), 0.5 * std::cos(2. * a), 0.5 * std::sin(a));
+        dirs.emplace_back(i % 7 ? Vec3d((target - origins.back()).normalized()) : Vec3d(0., 0., i % 2 ? 1. : -1.));
+    }
+}
+
+TEST_CASE("Wide tree hits the same triangles as the balanced tree", "[AABBIndirect]")
+{
+    indexed_triangle_set its = wide_tree_test_mesh(PI / 32.);
+
+    auto tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices);
+    auto wide = AABBTreeIndirect::build_wide_tree_over_indexed_triangle_set(its.vertices, its.indices);
+    REQUIRE(! wide.empty());
+    REQUIRE(wide.nodes().size() < its.indices.size());
+
+    // Each triangle is referenced by a single leaf.
+    std::vector<size_t> indices = wide.indices();
+    std::sort(indices.begin(), indices.end());
+    for (size_t i = 0; i < indices.size(); ++ i)
+        REQUIRE(indices[i] == i);
+
+    std::vector<Vec3d> origins, dirs;
+    wide_tree_test_rays(1000, origins, dirs);
+    size_t num_hits = 0;
+    for (size_t i = 0; i < origins.size(); ++ i) {
+        igl::Hit hit, wide_hit;
+        bool intersected      = AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, tree, origins[i], dirs[i], hit);
+        bool wide_intersected = AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, wide, origins[i], dirs[i], wide_hit);
+        REQUIRE(intersected == wide_intersected);
+        if (intersected) {
+            REQUIRE(wide_hit.t == hit.t);
+            ++ num_hits;
+        }
+    }
+    REQUIRE(num_hits > 0);
+    REQUIRE(num_hits < origins.size());
+
+    SECTION("Single triangle") {
+        indexed_triangle_set triangle;
+        triangle.vertices = { Vec3f(0.f, 0.f, 0.f), Vec3f(1.f, 0.f, 0.f), Vec3f(0.f, 1.f, 0.f) };
+        triangle.indices  = { stl_triangle_vertex_indices(0, 1, 2) };
+        auto     wide_triangle = AABBTreeIndirect::build_wide_tree_over_indexed_triangle_set(triangle.vertices, triangle.indices);
+        igl::Hit hit;
+        REQUIRE(AABBTreeIndirect::intersect_ray_first_hit(triangle.vertices, triangle.indices, wide_triangle, Vec3d(0.2, 0.2, -1.), Vec3d(0., 0., 1.), hit));
+        REQUIRE(hit.id == 0);
+        REQUIRE(hit.t == Approx(1.));
+        REQUIRE(! AABBTreeIndirect::intersect_ray_first_hit(triangle.vertices, triangle.indices, wide_triangle, Vec3d(0.2, 0.2, -1.), Vec3d(0., 0., -1.), hit));
+    }
+}
+
+// Build time against query time of the balanced tree with median split and of the wide tree built with the surface area heuristic.
+TEST_CASE("Balanced tree vs wide tree benchmark", "[AABBIndirect][.Benchmarks]")
+{
+    indexed_triangle_set its = wide_tree_test_mesh(PI / 360.);
+    std::vector<Vec3d> origins, dirs;
+    wide_tree_test_rays(100000, origins, dirs);
+
+    auto tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices);
+    auto wide = AABBTreeIndirect::build_wide_tree_over_indexed_triangle_set(its.vertices, its.indices);
+
+    BENCHMARK("Build balanced tree") {
+        return AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices);
+    };
+    BENCHMARK("Build wide tree") {
+        return AABBTreeIndirect::build_wide_tree_over_indexed_triangle_set(its.vertices, its.indices);
+    };
+    BENCHMARK("Cast rays, balanced tree") {
+        size_t num_hits = 0;
+        for (size_t i = 0; i < origins.size(); ++ i) {
+            igl::Hit hit;
+            num_hits += AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, tree, origins[i], dirs[i], hit);
+        }
+        return num_hits;
+    };
+    BENCHMARK("Cast rays, wide tree") {
+        size_t num_hits = 0;
+        for (size_t i = 0; i < origins.size(); ++ i) {
+            igl::Hit hit;
+            num_hits += AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, wide, origins[i], dirs[i], hit);
+        }
+        return num_hits;
+    };
+}
+
 TEST_CASE("Creating a several 2d lines, testing closest point query", "[AABBIndirect]")
 {
     std::vector<Linef> lines { };
@@ -88,6 +224,27 @@ TEST_CASE("Creating a several 2d lines, testing closest point query", "[AABBIndi
     REQUIRE(hit_point_out.y() == Approx(0.5));
 }
 
+TEST_CASE("Distance from lines with the nearest line of the previous point as a hint", "[AABBIndirect]")
+{
+    std::vector<Linef> lines;
+    for (size_t i = 0; i < 100; ++ i) {
+        double a0 = 2. * PI * double(i) / 100.;
+        double a1 = 2. * PI * double(i + 1) / 100.;
+        lines.emplace_back(Vec2d(10. * std::cos(a0), 10. * std::sin(a0)), Vec2d(10. * std::cos(a1), 10. * std::sin(a1)));
+    }
+    AABBTreeLines::LinesDistancer<Linef> distancer(lines);
+
+    size_t hint = size_t(-1);
+    for (size_t i = 0; i < 200; ++ i) {
+        Vec2d point(-15. + 0.15 * double(i), 3. * std::sin(0.1 * double(i)));
+        auto [distance, line_idx, nearest_point]                = distancer.distance_from_lines_extra<true>(point);
+        auto [hint_distance, hint_line_idx, hint_nearest_point] = distancer.distance_from_lines_extra<true>(point, hint);
+        REQUIRE(hint_distance == distance);
+        REQUIRE(line_alg::distance_to(lines[hint_line_idx], point) == Approx(std::abs(distance)));
+        hint = hint_line_idx;
+    }
+}
+
 TEST_CASE("Creating a several 2d lines, testing all lines in radius query", "[AABBIndirect]")
 {
     std::vector<Linef> lines { };
@@ -847,3 +847,33 @@ TEST_CASE("Arachne - SPE-2298 - Missing twin edge - 2", "[ArachneMissingTwinEdge
 
     REQUIRE(!perimeters.empty());
 }
+
+// Storage of the Voronoi diagram is reused between invocations on the same thread.
+// Check that a diagram repaired in a previous invocation doesn't leak into the following one.
+TEST_CASE("Arachne - Reused Voronoi diagram storage", "[ArachneReusedVoronoiDiagram]") {
+    const Polygons simple = { Polygon{ Point(-10000000, -10000000), Point(10000000, -10000000), Point(10000000, 5000000), Point(-10000000, 10000000) } };
+    // Taken from the #8446 test case, its Voronoi diagram needs to be repaired.
+    const Polygons degenerated = { Polygon{
+        Point( 42240656,  9020315), Point(  4474248, 42960681), Point( -4474248, 42960681), Point( -4474248, 23193537),
+        Point( -6677407, 22661038), Point( -8830542, 21906307), Point( -9702935, 21539826), Point(-13110431, 19607811),
+        Point(-18105334, 15167780), Point(-20675743, 11422461), Point(-39475413, 17530840), Point(-42240653,  9020315) } };
+    const coord_t spacing     = 407079;
+    const coord_t inset_count = 3;
+
+    auto generate = [&](const Polygons &polygons) {
+        Arachne::WallToolPaths wall_tool_paths(polygons, spacing, spacing, inset_count, 0, 0.2, PrintObjectConfig::defaults(), PrintConfig::defaults());
+        return wall_tool_paths.generate();
+    };
+
+    const std::vector<Arachne::VariableWidthLines> first = generate(simple);
+    REQUIRE(!first.empty());
+    REQUIRE(!generate(degenerated).empty());
+    const std::vector<Arachne::VariableWidthLines> second = generate(simple);
+
+    REQUIRE(first.size() == second.size());
+    for (size_t perimeter_idx = 0; perimeter_idx < first.size(); ++perimeter_idx) {
+        REQUIRE(first[perimeter_idx].size() == second[perimeter_idx].size());
+        for (size_t line_idx = 0; line_idx < first[perimeter_idx].size(); ++line_idx)
+            REQUIRE(first[perimeter_idx][line_idx].junctions == second[perimeter_idx][line_idx].junctions);
+    }
+}
@@ -397,6 +397,32 @@ TEST_CASE("arc wedge test", "[ArcWelder]") {
         }
     }
 }
+TEST_CASE("arc fitting benchmark", "[ArcWelder][.Benchmarks]") {
+    using namespace Slic3r::Geometry;
+
+    // Spirals sampled with a little noise, similar to discretized arcs of perimeters and gyroid infill.
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> noise(- scaled<double>(0.001), scaled<double>(0.001));
+    std::vector<Points> polylines(200);
+    for (Points &pts : polylines) {
+        const double r0   = scaled<double>(std::uniform_real_distribution<double>(1., 20.)(rng));
+        const size_t npts = 500;
+        pts.reserve(npts);
+        for (size_t i = 0; i < npts; ++ i) {
+            const double angle = 4. * M_PI * double(i) / double(npts);
+            const double r     = r0 * (1. + 0.1 * angle);
+            pts.emplace_back(coord_t(r * cos(angle) + noise(rng)), coord_t(r * sin(angle) + noise(rng)));
+        }
+    }
+
+    const double tolerance = scaled<double>(0.01);
+    BENCHMARK("fit_path, 200 spirals of 500 points") {
+        size_t num_segments = 0;
+        for (const Points &pts : polylines)
+            num_segments += ArcWelder::fit_path(pts, tolerance, ArcWelder::default_scaled_resolution).size();
+        return num_segments;
+    };
+}
 
 #if 0
 // For quantization
@@ -1,5 +1,6 @@
 #include <catch2/catch.hpp>
 
+#include <algorithm>
 #include <numeric>
 #include <iostream>
 #include <boost/filesystem.hpp>
@@ -382,3 +383,42 @@ TEST_CASE("Traversing Clipper PolyTree", "[ClipperUtils]") {
         REQUIRE(count_polys(output) == reference.size());
     }
 }
+
+TEST_CASE("Batched Clipper operations match the single ones", "[ClipperUtils]") {
+    std::vector<ExPolygons> inputs;
+    for (int i = 0; i < 64; ++ i) {
+        const coord_t   x = scaled<coord_t>(30. * (i % 8));
+        const coord_t   y = scaled<coord_t>(30. * (i / 8));
+        const coord_t   size = scaled<coord_t>(10. + i % 5);
+        Polygon         contour{ { x, y }, { x + size, y }, { x + size, y + size }, { x, y + size } };
+        Polygon         hole{ { x + size / 4, y + size / 4 }, { x + size / 4, y + 3 * size / 4 }, { x + 3 * size / 4, y + 3 * size / 4 }, { x + 3 * size / 4, y + size / 4 } };
+        inputs.push_back({ ExPolygon(std::move(contour), std::move(hole)) });
+    }
+    const Polygons clip{ Polygon{ { 0, 0 }, { scaled<coord_t>(120.), 0 }, { 0, scaled<coord_t>(120.) } } };
+    const float    delta = scaled<float>(1.);
+
+    SECTION("offset_ex_batch") {
+        std::vector<ExPolygons> out = offset_ex_batch(inputs, delta);
+        REQUIRE(out.size() == inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++ i)
+            REQUIRE(out[i] == offset_ex(inputs[i], delta));
+    }
+    SECTION("diff_ex_batch with a common clip") {
+        std::vector<ExPolygons> out = diff_ex_batch(inputs, clip);
+        REQUIRE(out.size() == inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++ i)
+            REQUIRE(out[i] == diff_ex(inputs[i], clip));
+    }
+    SECTION("intersection_ex_batch pairwise") {
+        std::vector<ExPolygons> clips(inputs.size(), ExPolygons{ ExPolygon(clip.front()) });
+        std::vector<ExPolygons> out = intersection_ex_batch(inputs, clips);
+        REQUIRE(out.size() == inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++ i)
+            REQUIRE(out[i] == intersection_ex(inputs[i], clips[i]));
+    }
+    SECTION("clipper_batch visits each index once") {
+        std::vector<int> visited(1000, 0);
+        clipper_batch(visited.size(), [&visited](size_t i) { ++ visited[i]; });
+        REQUIRE(std::all_of(visited.begin(), visited.end(), [](int v) { return v == 1; }));
+    }
+}
@@ -482,3 +482,89 @@ SCENARIO("DynamicPrintConfig serialization", "[Config]") {
         }
     }
 }
+
+SCENARIO("DynamicPrintConfig copies share unmodified values", "[Config]") {
+    GIVEN("A copy of a config") {
+        DynamicPrintConfig config;
+        config.set_key_value("layer_height", new ConfigOptionFloat(0.3));
+        config.set_key_value("perimeters", new ConfigOptionInt(2));
+        const DynamicPrintConfig original = config;
+        const DynamicPrintConfig copy = original;
+        THEN("The values of the copy of a copy are shared.") {
+            REQUIRE(copy.option("layer_height") == original.option("layer_height"));
+            REQUIRE(copy == original);
+        }
+        WHEN("The value is modified through a pointer obtained from the config") {
+            DynamicPrintConfig modified = original;
+            ConfigOptionFloat *layer_height = modified.opt<ConfigOptionFloat>("layer_height");
+            DynamicPrintConfig modified_copy = modified;
+            layer_height->value = 0.2;
+            THEN("Neither the source nor the copies are modified.") {
+                REQUIRE(original.opt_float("layer_height") == Approx(0.3));
+                REQUIRE(modified_copy.option<ConfigOptionFloat>("layer_height")->value == Approx(0.3));
+                REQUIRE(modified.opt_float("layer_height") == Approx(0.2));
+            }
+        }
+        WHEN("Another config is added to the config") {
+            DynamicPrintConfig other;
+            other.set_key_value("layer_height", new ConfigOptionFloat(0.1));
+            other.set_key_value("fill_density", new ConfigOptionPercent(20));
+            ConfigOptionFloat *layer_height = config.opt<ConfigOptionFloat>("layer_height");
+            config += other;
+            THEN("The options are merged and existing values are updated in place.") {
+                REQUIRE(config.keys() == t_config_option_keys{ "fill_density", "layer_height", "perimeters" });
+                REQUIRE(layer_height->value == Approx(0.1));
+                REQUIRE(original.opt_float("layer_height") == Approx(0.3));
+            }
+        }
+    }
+}
+
+SCENARIO("DynamicPrintConfig shares values equal to another config", "[Config]") {
+    GIVEN("Two configs with some equal values") {
+        DynamicPrintConfig source;
+        source.set_key_value("layer_height", new ConfigOptionFloat(0.3));
+        source.set_key_value("perimeters", new ConfigOptionInt(2));
+        const DynamicPrintConfig first = source;
+        DynamicPrintConfig other;
+        other.set_key_value("layer_height", new ConfigOptionFloat(0.3));
+        other.set_key_value("perimeters", new ConfigOptionInt(3));
+        DynamicPrintConfig second = other;
+        WHEN("The second config shares its equal values with the first one") {
+            const size_t shared = second.share_equal_values(first);
+            THEN("Only the equal values are shared.") {
+                REQUIRE(shared == 1);
+                REQUIRE(second.option("layer_height") == first.option("layer_height"));
+                REQUIRE(second.option("perimeters") != first.option("perimeters"));
+                REQUIRE(second.opt_int("perimeters") == 3);
+            }
+            THEN("Modifying a shared value does not modify the other config.") {
+                second.opt<ConfigOptionFloat>("layer_height")->value = 0.2;
+                REQUIRE(first.opt_float("layer_height") == Approx(0.3));
+            }
+        }
+        WHEN("A value was handed out for modification") {
+            ConfigOptionFloat *layer_height = second.opt<ConfigOptionFloat>("layer_height");
+            THEN("The value is not shared.") {
+                REQUIRE(second.share_equal_values(first) == 0);
+                REQUIRE(second.option("layer_height") == layer_height);
+            }
+        }
+    }
+}
+
+TEST_CASE("Static config diff", "[Config]") {
+    PrintRegionConfig config;
+    PrintRegionConfig other = config;
+    REQUIRE(config.diff(other).empty());
+
+    other.perimeters.value = config.perimeters.value + 1;
+    other.fill_density.value = config.fill_density.value / 2.;
+    REQUIRE(config.diff(other) == t_config_option_keys{ "fill_density", "perimeters" });
+
+    DynamicPrintConfig dynamic;
+    dynamic.set_key_value("perimeters", new ConfigOptionInt(config.perimeters.value + 1));
+    dynamic.set_key_value("layer_height", new ConfigOptionFloat(0.1));
+    REQUIRE(config.diff(dynamic) == t_config_option_keys{ "perimeters" });
+    REQUIRE(config.diff(dynamic) == static_cast<const ConfigBase&>(config).diff(dynamic));
+}
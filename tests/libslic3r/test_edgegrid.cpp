@@ -0,0 +1,115 @@
+#include <catch2/catch.hpp>
+
+#include <random>
+
+#include <libslic3r/EdgeGrid.hpp>
+
+using namespace Slic3r;
+
+// Random circles, some of them overlapping, spread over an area much larger than the circles.
+static Polygons random_circles(size_t num_circles)
+{
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<coord_t> center(scaled<coord_t>(-100.), scaled<coord_t>(100.));
+    std::uniform_int_distribution<coord_t> radius(scaled<coord_t>(0.2), scaled<coord_t>(3.));
+    Polygons out;
+    for (size_t i = 0; i < num_circles; ++ i) {
+        const Point   c(center(rng), center(rng));
+        const coord_t r = radius(rng);
+        const size_t  n = 8 + i % 32;
+        Polygon       poly;
+        for (size_t j = 0; j < n; ++ j) {
+            const double a = 2. * M_PI * double(j) / double(n);
+            poly.points.emplace_back(c.x() + coord_t(r * cos(a)), c.y() + coord_t(r * sin(a)));
+        }
+        out.emplace_back(std::move(poly));
+    }
+    return out;
+}
+
+TEST_CASE("EdgeGrid sparse and dense storage produce the same results", "[EdgeGrid]")
+{
+    const Polygons polygons   = random_circles(500);
+    const coord_t  resolution = scaled<coord_t>(0.2);
+
+    EdgeGrid::Grid dense;
+    dense.set_cell_storage(EdgeGrid::Grid::CellStorage::Dense);
+    dense.create(polygons, resolution);
+    EdgeGrid::Grid sparse;
+    sparse.set_cell_storage(EdgeGrid::Grid::CellStorage::Sparse);
+    sparse.create(polygons, resolution);
+    EdgeGrid::Grid automatic;
+    automatic.create(polygons, resolution);
+
+    REQUIRE(! dense.sparse());
+    REQUIRE(sparse.sparse());
+    // The grid has about a million cells, most of them empty.
+    REQUIRE(automatic.sparse());
+    REQUIRE(dense.rows() == sparse.rows());
+    REQUIRE(dense.cols() == sparse.cols());
+
+    SECTION("Cells crossed by the contours") {
+        for (const Polygon &polygon : polygons)
+            for (size_t i = 0; i < polygon.size(); ++ i) {
+                const Point &a = polygon.points[i];
+                const Point &b = polygon.points[(i + 1) % polygon.size()];
+                auto visitor = [&dense, &sparse](coord_t row, coord_t col) {
+                    auto d = dense.cell_data_range(row, col);
+                    auto s = sparse.cell_data_range(row, col);
+                    REQUIRE(std::equal(d.first, d.second, s.first, s.second));
+                    return true;
+                };
+                dense.visit_cells_intersecting_line(a, b, visitor);
+            }
+        // An empty cell.
+        auto s = sparse.cell_data_range(0, 0);
+        REQUIRE(s.first == s.second);
+    }
+
+    SECTION("Closest point queries") {
+        std::mt19937 rng(1);
+        std::uniform_int_distribution<coord_t> coord(scaled<coord_t>(-105.), scaled<coord_t>(105.));
+        for (size_t i = 0; i < 2000; ++ i) {
+            const Point pt(coord(rng), coord(rng));
+            EdgeGrid::Grid::ClosestPointResult d = dense.closest_point_signed_distance(pt, scaled<coord_t>(1.));
+            EdgeGrid::Grid::ClosestPointResult s = sparse.closest_point_signed_distance(pt, scaled<coord_t>(1.));
+            REQUIRE(d.valid() == s.valid());
+            if (d.valid()) {
+                REQUIRE(d.contour_idx == s.contour_idx);
+                REQUIRE(d.start_point_idx == s.start_point_idx);
+                REQUIRE(d.distance == s.distance);
+            }
+        }
+    }
+
+    SECTION("Intersecting edges") {
+        std::vector<std::pair<EdgeGrid::Grid::ContourEdge, EdgeGrid::Grid::ContourEdge>> d = dense.intersecting_edges();
+        std::vector<std::pair<EdgeGrid::Grid::ContourEdge, EdgeGrid::Grid::ContourEdge>> s = sparse.intersecting_edges();
+        REQUIRE(! d.empty());
+        REQUIRE(d.size() == s.size());
+        // The edges reference the contours of their grids, compare the edge end points.
+        auto edge_points = [](const EdgeGrid::Grid::ContourEdge &edge) {
+            return std::make_pair(edge.first->segment_start(edge.second), edge.first->segment_end(edge.second));
+        };
+        for (size_t i = 0; i < d.size(); ++ i) {
+            REQUIRE(edge_points(d[i].first) == edge_points(s[i].first));
+            REQUIRE(edge_points(d[i].second) == edge_points(s[i].second));
+        }
+        REQUIRE(dense.has_intersecting_edges());
+        REQUIRE(sparse.has_intersecting_edges());
+    }
+}
+
+TEST_CASE("EdgeGrid of a small contour is dense", "[EdgeGrid]")
+{
+    const Polygon square { { 0, 0 }, { scaled<coord_t>(10.), 0 }, { scaled<coord_t>(10.), scaled<coord_t>(10.) }, { 0, scaled<coord_t>(10.) } };
+    EdgeGrid::Grid grid;
+    grid.create(Polygons{ square }, scaled<coord_t>(1.));
+    REQUIRE(! grid.sparse());
+    EdgeGrid::Grid::ClosestPointResult result = grid.closest_point_signed_distance(Point(scaled<coord_t>(5.), scaled<coord_t>(0.5)), scaled<coord_t>(2.));
+    REQUIRE(result.valid());
+    REQUIRE(result.contour_idx == 0);
+    REQUIRE(result.start_point_idx == 0);
+    REQUIRE(std::abs(result.distance) == Approx(scaled<double>(0.5)));
+    REQUIRE(! grid.has_intersecting_edges());
+}
@@ -607,4 +607,22 @@ SCENARIO("Elephant foot compensation", "[ElephantFoot]") {
             }
         }
 	}
+
+	GIVEN("Many islands") {
+		ExPolygons expolys;
+		for (const ExPolygon &expoly : { spirograph_gear_1mm(), thin_ring(), vase_with_fins(), contour_with_hole() })
+			for (int i = 0; i < 4; ++ i) {
+				expolys.emplace_back(expoly);
+				expolys.back().translate(Point(scaled<coord_t>(100. * i), 0));
+			}
+		WHEN("Compensated as a whole") {
+			const Flow  flow(0.419999987f, 0.2f, 0.4f);
+			ExPolygons  expolys_compensated = elephant_foot_compensation(expolys, flow, 0.25f);
+			THEN("each island is compensated as if it was compensated alone") {
+				REQUIRE(expolys_compensated.size() == expolys.size());
+				for (size_t i = 0; i < expolys.size(); ++ i)
+					REQUIRE(expolys_compensated[i] == elephant_foot_compensation(expolys[i], flow, 0.25f));
+			}
+		}
+	}
 }
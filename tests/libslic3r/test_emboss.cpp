@@ -158,6 +158,40 @@ TEST_CASE("Convert glyph % to model", "[Emboss]")
     CHECK(!its.indices.empty());    
 }
 
+TEST_CASE("Reuse triangulation of glyph", "[Emboss]")
+{
+    std::string font_path = get_font_filepath();
+    auto font = Emboss::create_font_file(font_path.c_str());
+    REQUIRE(font != nullptr);
+    std::optional<Emboss::Glyph> glyph = Emboss::letter2glyph(*font, 0, '%', 2.f);
+    REQUIRE(glyph.has_value());
+    REQUIRE(!glyph->shape.empty());
+
+    // same glyph twice on different positions
+    ExPolygons shapes = glyph->shape;
+    ExPolygons moved = glyph->shape;
+    BoundingBox bb = get_extents(shapes);
+    for (ExPolygon &expolygon : moved)
+        expolygon.translate(Point(2 * bb.size().x(), 0));
+    expolygons_append(shapes, moved);
+
+    Emboss::ProjectZ projection(1.f);
+    Emboss::TriangulationCache cache;
+    indexed_triangle_set its = Emboss::polygons2model(shapes, projection);
+    indexed_triangle_set its_cached = Emboss::polygons2model(shapes, projection, &cache);
+    // only the shapes of one glyph are stored
+    size_t cache_size = cache.size();
+    CHECK(cache_size <= glyph->shape.size());
+    CHECK(its_cached.vertices == its.vertices);
+    CHECK(its_cached.indices.size() == its.indices.size());
+    CHECK(its_volume(its_cached) == Approx(its_volume(its)));
+
+    // next use is served from cache
+    indexed_triangle_set its_cached2 = Emboss::polygons2model(moved, projection, &cache);
+    CHECK(cache.size() == cache_size);
+    CHECK(its_volume(its_cached2) == Approx(its_volume(its) / 2));
+}
+
 //#define VISUALIZE
 #ifdef VISUALIZE
 TEST_CASE("Visualize glyph from font", "[Emboss]")
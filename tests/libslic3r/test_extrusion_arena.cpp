@@ -0,0 +1,109 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/ExtrusionArena.hpp"
+#include "libslic3r/ExtrusionEntityCollection.hpp"
+
+using namespace Slic3r;
+
+namespace {
+
+ExtrusionEntityCollection make_layer()
+{
+    const ExtrusionAttributes perimeter{ ExtrusionRole::Perimeter, ExtrusionFlow{ 0.05, 0.45f, 0.2f } };
+    const ExtrusionAttributes overhang{ ExtrusionRole::OverhangPerimeter, ExtrusionFlow{ 0.04, 0.45f, 0.2f } };
+    const ExtrusionAttributes infill{ ExtrusionRole::InternalInfill, ExtrusionFlow{ 0.06, 0.5f, 0.2f } };
+
+    ExtrusionEntityCollection perimeters;
+    perimeters.no_sort = true;
+    perimeters.append(ExtrusionLoop(ExtrusionPaths{
+        ExtrusionPath(Polyline{ { 0, 0 }, { 1000, 0 }, { 1000, 1000 } }, perimeter),
+        ExtrusionPath(Polyline{ { 1000, 1000 }, { 0, 1000 }, { 0, 0 } }, overhang) }, elrContourInternalPerimeter));
+    ExtrusionEntityCollection fills;
+    fills.append(ExtrusionPath(Polyline{ { 100, 100 }, { 900, 100 } }, infill));
+    fills.append(ExtrusionPathOriented(Polyline{ { 100, 200 }, { 900, 200 } }, infill));
+    fills.append(ExtrusionMultiPath(ExtrusionPaths{
+        ExtrusionPath(Polyline{ { 100, 300 }, { 500, 300 } }, infill),
+        ExtrusionPath(Polyline{ { 500, 300 }, { 900, 300 }, { 900, 400 } }, infill) }));
+
+    ExtrusionEntityCollection layer;
+    layer.append(std::move(perimeters));
+    layer.append(std::move(fills));
+    return layer;
+}
+
+} // namespace
+
+TEST_CASE("ExtrusionArena round trip", "[ExtrusionArena]") {
+    const ExtrusionEntityCollection layer = make_layer();
+    ExtrusionArena arena;
+    const ExtrusionArena::NodeIdx root = arena.append(layer);
+
+    REQUIRE(arena.roots().size() == 1);
+    REQUIRE(arena.num_points() == 6 + 2 + 2 + 2 + 3);
+    REQUIRE(arena.items_count(root) == layer.items_count());
+    REQUIRE(arena.role(root) == layer.role());
+    REQUIRE(arena.min_mm3_per_mm(root) == Approx(layer.min_mm3_per_mm()));
+    REQUIRE(arena.total_volume(root) == Approx(layer.total_volume()));
+    REQUIRE(arena.first_point(root) == layer.first_point());
+    REQUIRE(arena.last_point(root) == layer.last_point());
+
+    Polylines polylines_arena, polylines_layer;
+    arena.collect_polylines(root, polylines_arena);
+    layer.collect_polylines(polylines_layer);
+    REQUIRE(polylines_arena == polylines_layer);
+
+    Points points_arena, points_layer;
+    arena.collect_points(root, points_arena);
+    layer.collect_points(points_layer);
+    REQUIRE(points_arena == points_layer);
+
+    SECTION("Converted back to the ExtrusionEntity tree") {
+        ExtrusionEntityCollection out = arena.to_collection();
+        REQUIRE(out.entities.size() == 1);
+        const auto &collection = *dynamic_cast<const ExtrusionEntityCollection*>(out.entities.front());
+        REQUIRE(collection.entities.size() == 2);
+        const auto &perimeters = *dynamic_cast<const ExtrusionEntityCollection*>(collection.entities[0]);
+        REQUIRE(perimeters.no_sort);
+        const auto *loop = dynamic_cast<const ExtrusionLoop*>(perimeters.entities.front());
+        REQUIRE(loop != nullptr);
+        REQUIRE(loop->loop_role() == elrContourInternalPerimeter);
+        REQUIRE(loop->paths.size() == 2);
+        REQUIRE(loop->paths.back().role() == ExtrusionRole::OverhangPerimeter);
+        const auto &fills = *dynamic_cast<const ExtrusionEntityCollection*>(collection.entities[1]);
+        REQUIRE(fills.entities[0]->can_reverse());
+        REQUIRE(! fills.entities[1]->can_reverse());
+        REQUIRE(dynamic_cast<const ExtrusionMultiPath*>(fills.entities[2]) != nullptr);
+        Polylines polylines_out;
+        out.collect_polylines(polylines_out);
+        REQUIRE(polylines_out == polylines_layer);
+    }
+
+    SECTION("Reversed like the ExtrusionEntity tree") {
+        ExtrusionEntityCollection reversed = layer;
+        reversed.reverse();
+        arena.reverse(root);
+        Polylines polylines_reversed;
+        polylines_arena.clear();
+        arena.collect_polylines(root, polylines_arena);
+        reversed.collect_polylines(polylines_reversed);
+        REQUIRE(polylines_arena == polylines_reversed);
+    }
+
+    SECTION("Appending an arena") {
+        ExtrusionArena other;
+        other.append(arena);
+        other.append(arena);
+        REQUIRE(other.roots().size() == 2);
+        Polylines polylines_other;
+        other.collect_polylines(other.roots().back(), polylines_other);
+        REQUIRE(polylines_other == polylines_layer);
+    }
+
+    SECTION("Clear keeps the buffers") {
+        const size_t memory = arena.memory_used();
+        arena.clear();
+        REQUIRE(arena.empty());
+        REQUIRE(arena.num_points() == 0);
+        REQUIRE(arena.memory_used() == memory);
+    }
+}
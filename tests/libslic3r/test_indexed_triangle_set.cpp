@@ -102,6 +102,62 @@ TEST_CASE("Split two watertight meshes", "[its_split][its]") {
     debug_write_obj(res, "parts_watertight");
 }
 
+TEST_CASE("Split mesh large enough to be labeled in parallel", "[its_split][its]") {
+    using namespace Slic3r;
+
+    // 6000 cubes of 12 faces each, above the threshold of the parallel union-find.
+    const indexed_triangle_set cube = its_make_cube(1., 1., 1.);
+    const int                  num_cubes = 6000;
+    indexed_triangle_set       cubes;
+    for (int i = 0; i < num_cubes; ++ i) {
+        indexed_triangle_set moved = cube;
+        its_transform(moved, identity3f().translate(Vec3f{2.f * float(i % 100), 2.f * float(i / 100), 0.f}));
+        its_merge(cubes, moved);
+    }
+
+    REQUIRE(its_number_of_patches(cubes) == size_t(num_cubes));
+    REQUIRE(its_is_splittable(cubes));
+    REQUIRE(! its_is_splittable(cube));
+
+    std::vector<indexed_triangle_set> res = its_split(cubes);
+
+    REQUIRE(res.size() == size_t(num_cubes));
+    // The parts are enumerated in the order of their first face.
+    REQUIRE(res.front().vertices.front() == cubes.vertices.front());
+    REQUIRE(res.back().vertices.front() == cubes.vertices[(num_cubes - 1) * cube.vertices.size()]);
+    for (const indexed_triangle_set &part : res) {
+        REQUIRE(part.indices.size() == cube.indices.size());
+        REQUIRE(part.vertices.size() == cube.vertices.size());
+    }
+}
+
+TEST_CASE("Merge vertices of a mesh large enough to be processed in parallel", "[its]") {
+    using namespace Slic3r;
+
+    // Sphere of ~160k faces with each face having its own vertices.
+    const indexed_triangle_set sphere = its_make_sphere(10., 2 * PI / 400.);
+    indexed_triangle_set       soup;
+    for (const stl_triangle_vertex_indices &face : sphere.indices) {
+        const int first = int(soup.vertices.size());
+        for (int i = 0; i < 3; ++ i)
+            soup.vertices.emplace_back(sphere.vertices[face(i)]);
+        soup.indices.emplace_back(first, first + 1, first + 2);
+    }
+    REQUIRE(soup.indices.size() > 100000);
+
+    REQUIRE(its_merge_vertices(soup) == int(soup.indices.size() * 3 - sphere.vertices.size()));
+    REQUIRE(soup.vertices.size() == sphere.vertices.size());
+    // Merged vertices are ordered by their first occurrence.
+    REQUIRE(soup.vertices.front() == sphere.vertices[sphere.indices.front()(0)]);
+    bool same_faces = true;
+    for (size_t i = 0; i < soup.indices.size(); ++ i)
+        for (int j = 0; j < 3; ++ j)
+            same_faces &= soup.vertices[soup.indices[i](j)] == sphere.vertices[sphere.indices[i](j)];
+    REQUIRE(same_faces);
+    REQUIRE(its_remove_degenerate_faces(soup) == 0);
+    REQUIRE(its_compactify_vertices(soup) == 0);
+}
+
 #include <libslic3r/QuadricEdgeCollapse.hpp>
 static float triangle_area(const Vec3f &v0, const Vec3f &v1, const Vec3f &v2)
 {
@@ -33,3 +33,37 @@ TEST_CASE("Test jump point search path finding", "[JumpPointSearch]")
     //     REQUIRE(out.empty());
     // }
 }
+
+TEST_CASE("Jump point search reuses its state between the queries", "[JumpPointSearch]")
+{
+    Lines obstacles{};
+    obstacles.push_back(Line(Point::new_scale(0, 0), Point::new_scale(50, 50)));
+    obstacles.push_back(Line(Point::new_scale(0, 100), Point::new_scale(50, 50)));
+    obstacles.push_back(Line(Point::new_scale(25, -25), Point::new_scale(25, 125)));
+    obstacles.push_back(Line(Point::new_scale(60, 40), Point::new_scale(60, 60)));
+
+    const std::vector<std::pair<Point, Point>> queries{
+        {Point::new_scale(50, 50), Point::new_scale(70, 50)},
+        {Point::new_scale(5, 50), Point::new_scale(100, 50)},
+        {Point::new_scale(70, 45), Point::new_scale(50, 52)},
+        {Point::new_scale(25, 25), Point::new_scale(125, 125)},
+        {Point::new_scale(50, 50), Point::new_scale(70, 50)},
+    };
+
+    JPSPathFinder reused;
+    reused.clear();
+    reused.add_obstacles(obstacles);
+    for (const auto &[from, to] : queries) {
+        JPSPathFinder fresh;
+        fresh.clear();
+        fresh.add_obstacles(obstacles);
+        const Polyline expected = fresh.find_path(from, to);
+        const Polyline path     = reused.find_path(from, to);
+        CHECK(path.points == expected.points);
+        CHECK(path.first_point() == from);
+        CHECK(path.last_point() == to);
+    }
+
+    // The obstacle at x = 60 is avoided.
+    CHECK(reused.find_path(queries.front().first, queries.front().second).size() > 2);
+}
@@ -2,6 +2,7 @@
 
 #include "libslic3r/KDTreeIndirect.hpp"
 #include "libslic3r/Execution/ExecutionSeq.hpp"
+#include "libslic3r/Execution/ExecutionTBB.hpp"
 #include "libslic3r/BoundingBox.hpp"
 #include "libslic3r/PointGrid.hpp"
 
@@ -85,6 +86,47 @@ TEST_CASE("Test kdtree query for a Box", "[KDTreeIndirect]")
     REQUIRE(call_count < pgrid.point_count());
 }
 
+TEST_CASE("Test kdtree batch queries", "[KDTreeIndirect]")
+{
+    // Large enough for the tree to be built in parallel.
+    auto vol = BoundingBox3Base<Vec3f>{{0.f, 0.f, 0.f}, {10.f, 10.f, 10.f}};
+    auto pgrid = point_grid(ex_seq, vol, Vec3f{0.25f, 0.25f, 0.25f});
+    REQUIRE(pgrid.point_count() > 10000);
+
+    auto coordfn = [&pgrid] (size_t i, size_t D) { return pgrid.get(i)(int(D)); };
+    KDTreeIndirect<3, float, decltype(coordfn)> tree{coordfn, pgrid.point_count()};
+
+    std::vector<Vec3f> queries;
+    for (size_t i = 0; i < 500; ++ i)
+        queries.emplace_back(0.0173f * float(i % 577), 5.f + 4.f * std::sin(float(i)), 0.02f * float(i));
+
+    std::vector<size_t>              closest = batch_find_closest_point(ex_tbb, tree, queries);
+    std::vector<std::array<size_t, 3>> closest3 = batch_find_closest_points<3>(ex_tbb, tree, queries);
+    std::vector<std::vector<size_t>> nearby  = batch_find_nearby_points(ex_tbb, tree, queries, 0.6f);
+    REQUIRE(closest.size() == queries.size());
+    REQUIRE(closest3.size() == queries.size());
+    REQUIRE(nearby.size() == queries.size());
+
+    for (size_t i = 0; i < queries.size(); ++ i) {
+        // Brute force search over all the points.
+        float  min_dist = std::numeric_limits<float>::max();
+        size_t num_nearby = 0;
+        for (size_t j = 0; j < pgrid.point_count(); ++ j) {
+            float dist = (pgrid.get(j) - queries[i]).squaredNorm();
+            min_dist = std::min(min_dist, dist);
+            num_nearby += dist < 0.6f * 0.6f;
+        }
+        REQUIRE((pgrid.get(closest[i]) - queries[i]).squaredNorm() == Approx(min_dist));
+        REQUIRE(closest3[i][0] == closest[i]);
+        REQUIRE(nearby[i].size() == num_nearby);
+
+        std::vector<size_t> single = find_nearby_points(tree, queries[i], 0.6f);
+        std::sort(single.begin(), single.end());
+        std::sort(nearby[i].begin(), nearby[i].end());
+        REQUIRE(single == nearby[i]);
+    }
+}
+
 //TEST_CASE("Test kdtree query for a Sphere", "[KDTreeIndirect]") {
 //    auto vol = BoundingBox3Base<Vec3f>{{0.f, 0.f, 0.f}, {10.f, 10.f, 10.f}};
 
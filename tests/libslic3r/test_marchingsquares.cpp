@@ -309,6 +309,18 @@ TEST_CASE("Circle with hole in the middle", "[MarchingSquares]") {
     test_expolys(create_raster({1000, 1000}), circle_with_hole(25.), W2x2, "circle_with_hole");   
 }
 
+TEST_CASE("Marching squares benchmark", "[MarchingSquares][.Benchmarks]") {
+    // Raster of a 12K panel with a grid of holed circles.
+    auto rst = create_raster({11520, 5120}, 218.88, 122.88);
+    for (int i = -4; i <= 4; ++i)
+        for (int j = -2; j <= 2; ++j)
+            for (const ExPolygon &expoly : circle_with_hole(10., {scaled(i * 22.), scaled(j * 22.)}))
+                rst.draw(expoly);
+
+    BENCHMARK("Full accuracy") { return sla::raster_to_polygons(rst, W2x2); };
+    BENCHMARK("Half accuracy") { return sla::raster_to_polygons(rst, W4x4); };
+}
+
 static void recreate_object_from_rasters(const std::string &objname, float lh) {
     TriangleMesh mesh = load_model(objname);
     
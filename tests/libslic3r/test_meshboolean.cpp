@@ -3,6 +3,7 @@
 
 #include <libslic3r/TriangleMesh.hpp>
 #include <libslic3r/MeshBoolean.hpp>
+#include <libslic3r/CSGMesh/PerformCSGMeshBooleans.hpp>
 
 using namespace Slic3r;
 
@@ -49,3 +50,48 @@ TEST_CASE("Add TriangleMeshes", "[MeshBoolean]")
     //its_write_obj(tm1.its, "test_add.obj");
     CHECK(tm1.its.indices.size() > init_size);
 }
+
+TEST_CASE("Cached CSG booleans recompute only the changed suffix", "[MeshBoolean]")
+{
+    indexed_triangle_set body = its_make_cube(10., 10., 10.);
+    indexed_triangle_set hole = its_make_cube(2., 2., 20.);
+
+    auto hole_trafo = [](double x) {
+        return Transform3f{Eigen::Translation3f(float(x), 4.f, -5.f)};
+    };
+
+    std::vector<csg::CSGPart> parts;
+    parts.emplace_back(&body, csg::CSGType::Union);
+    parts.emplace_back(&hole, csg::CSGType::Difference, hole_trafo(1.));
+    parts.emplace_back(&hole, csg::CSGType::Difference, hole_trafo(4.));
+    parts.emplace_back(&hole, csg::CSGType::Difference, hole_trafo(7.));
+
+    auto volume = [](const MeshBoolean::cgal::CGALMeshPtr &m) {
+        REQUIRE(m);
+        return its_volume(MeshBoolean::cgal::cgal_to_indexed_triangle_set(*m));
+    };
+
+    csg::CGALBooleanCache cache;
+    auto r = range(parts);
+    REQUIRE(csg::check_csgmesh_booleans(r, cache) == r.end());
+
+    double expected_volume = 1000. - 3 * 40.;
+    CHECK(volume(csg::perform_csgmesh_booleans(r, cache)) == Approx(expected_volume));
+    CHECK(cache.last_evaluated_parts() == parts.size());
+
+    // Unchanged input is served from the cache.
+    CHECK(volume(csg::perform_csgmesh_booleans(r, cache)) == Approx(expected_volume));
+    CHECK(cache.last_evaluated_parts() == 0);
+
+    // Moving the last hole outside of the body only recomputes the last part.
+    parts.back().trafo = hole_trafo(20.);
+    expected_volume += 40.;
+    CHECK(volume(csg::perform_csgmesh_booleans(r, cache)) == Approx(expected_volume));
+    CHECK(cache.last_evaluated_parts() == 1);
+
+    // The result matches the booleans evaluated without the cache.
+    parts[1].trafo = hole_trafo(1.5);
+    auto cached = csg::perform_csgmesh_booleans(r, cache);
+    CHECK(cache.last_evaluated_parts() == parts.size() - 1);
+    CHECK(volume(cached) == Approx(volume(csg::perform_csgmesh_booleans(r))));
+}
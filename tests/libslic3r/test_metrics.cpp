@@ -0,0 +1,35 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/Metrics.hpp"
+#include "libslic3r/Trace.hpp"
+
+using namespace Slic3r;
+
+TEST_CASE("Metrics collect the step spans and the jobs", "[Metrics]") {
+    const bool trace_enabled = Trace::enabled();
+    Trace::enable(false);
+    Metrics::clear();
+    Metrics::enable(true);
+    {
+        Trace::Scope step("step", "posSlice", "object");
+        Trace::Scope other("parallel", "make_perimeters");
+    }
+    {
+        Trace::Scope step("step", "posSlice", "another object");
+    }
+    Metrics::observe_job(Metrics::JobResult::Ok, 1500000, 1234);
+    Metrics::observe_job(Metrics::JobResult::Error, 10, 0);
+    Metrics::enable(false);
+    Trace::enable(trace_enabled);
+
+    const std::string text = Metrics::to_text();
+    CHECK(text.find("prusaslicer_step_duration_seconds_count{step=\"posSlice\"} 2\n") != std::string::npos);
+    CHECK(text.find("make_perimeters") == std::string::npos);
+    CHECK(text.find("prusaslicer_jobs_total{result=\"ok\"} 1\n") != std::string::npos);
+    CHECK(text.find("prusaslicer_jobs_total{result=\"error\"} 1\n") != std::string::npos);
+    CHECK(text.find("prusaslicer_job_duration_seconds_bucket{le=\"1\"} 1\n") != std::string::npos);
+    CHECK(text.find("prusaslicer_job_duration_seconds_bucket{le=\"2.5\"} 2\n") != std::string::npos);
+    CHECK(text.find("prusaslicer_job_duration_seconds_bucket{le=\"+Inf\"} 2\n") != std::string::npos);
+    CHECK(text.find("prusaslicer_output_bytes_total 1234\n") != std::string::npos);
+    Metrics::clear();
+}
@@ -1,6 +1,7 @@
 #include <catch2/catch.hpp>
 
 #include <queue>
+#include <random>
 
 #include "libslic3r/MutablePriorityQueue.hpp"
 
@@ -459,3 +460,157 @@ TEST_CASE("Mutable priority queue complex", "[MutableSkipHeapPriorityQueue]")
         }
     }
 }
+
+TEMPLATE_TEST_CASE("Mutable d-ary priority queue", "[MutablePriorityQueue]",
+                   (std::integral_constant<size_t, 2>), (std::integral_constant<size_t, 4>), (std::integral_constant<size_t, 8>))
+{
+    static constexpr const size_t arity = TestType::value;
+    struct MyValue {
+        size_t id;
+        int    val;
+    };
+    static constexpr const size_t count = 5000;
+    std::vector<size_t> idxs(count, 0);
+    auto q = make_dary_mutable_priority_queue<MyValue, arity, true>(
+        [&idxs](MyValue &v, size_t idx) { idxs[v.id] = idx; },
+        [](MyValue &l, MyValue &r) { return l.val < r.val; });
+    q.reserve(count);
+
+    std::mt19937 gen(arity);
+    std::uniform_int_distribution<int> dist(1, 1000);
+    std::vector<int> vals(count);
+    for (size_t id = 0; id < count; ++ id)
+        q.push({ id, vals[id] = dist(gen) });
+
+    // Change some values and remove some elements.
+    std::vector<bool> dels(count, false);
+    for (size_t id = 0; id < count; id += 7) {
+        REQUIRE(q[idxs[id]].id == id);
+        q[idxs[id]].val = vals[id] = dist(gen);
+        q.update(idxs[id]);
+    }
+    for (size_t id = 3; id < count; id += 11) {
+        q.remove(idxs[id]);
+        REQUIRE(idxs[id] == q.invalid_id());
+        dels[id] = true;
+    }
+    std::vector<int> expected;
+    for (size_t id = 0; id < count; ++ id)
+        if (! dels[id])
+            expected.emplace_back(vals[id]);
+    std::sort(expected.begin(), expected.end());
+
+    REQUIRE(q.size() == expected.size());
+    for (int val : expected) {
+        REQUIRE(idxs[q.top().id] == 0);
+        REQUIRE(q.top().val == val);
+        q.pop();
+    }
+    REQUIRE(q.empty());
+}
+
+TEST_CASE("Mutable bucket priority queue", "[MutableBucketPriorityQueue]")
+{
+    struct MyValue {
+        size_t id;
+        size_t val;
+    };
+    static constexpr const size_t count = 5000;
+    std::vector<size_t> idxs(count, 0);
+    auto q = make_bucket_mutable_priority_queue<MyValue, true>(
+        [&idxs](MyValue &v, size_t idx) { idxs[v.id] = idx; },
+        [](const MyValue &v) { return v.val; });
+
+    SECTION("a default constructed queue is empty") {
+        REQUIRE(q.empty());
+        REQUIRE(q.size() == 0);
+    }
+    SECTION("randomly inserted, updated and removed elements are popped sorted") {
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<size_t> dist(0, 200);
+        std::vector<size_t> vals(count);
+        for (size_t id = 0; id < count; ++ id)
+            q.push({ id, vals[id] = dist(gen) });
+        REQUIRE(q.size() == count);
+
+        std::vector<bool> dels(count, false);
+        for (size_t id = 0; id < count; id += 7) {
+            REQUIRE(q[idxs[id]].id == id);
+            q[idxs[id]].val = vals[id] = dist(gen);
+            q.update(idxs[id]);
+        }
+        for (size_t id = 3; id < count; id += 11) {
+            q.remove(idxs[id]);
+            REQUIRE(idxs[id] == q.invalid_id());
+            dels[id] = true;
+        }
+        std::vector<size_t> expected;
+        for (size_t id = 0; id < count; ++ id)
+            if (! dels[id])
+                expected.emplace_back(vals[id]);
+        std::sort(expected.begin(), expected.end());
+
+        REQUIRE(q.size() == expected.size());
+        for (size_t val : expected) {
+            REQUIRE(q[idxs[q.top().id]].id == q.top().id);
+            REQUIRE(q.top().val == val);
+            size_t id = q.top().id;
+            q.pop();
+            REQUIRE(idxs[id] == q.invalid_id());
+        }
+        REQUIRE(q.empty());
+    }
+    SECTION("a queue may be refilled with lower priorities after being emptied") {
+        q.push({ 0, 10 });
+        q.pop();
+        q.push({ 1, 5 });
+        q.push({ 2, 3 });
+        REQUIRE(q.top().val == 3);
+        q.pop();
+        REQUIRE(q.top().val == 5);
+    }
+}
+
+TEST_CASE("Mutable priority queue benchmark", "[MutablePriorityQueue][.Benchmarks]")
+{
+    struct MyValue {
+        size_t id;
+        float  val;
+    };
+    // Mixture of pushes, pops and updates similar to QuadricEdgeCollapse or to a greedy search.
+    static constexpr const size_t count = 1000000;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 4095);
+    std::vector<float> vals(count);
+    for (float &v : vals)
+        v = float(dist(gen));
+    std::vector<size_t> idxs(count);
+
+    auto run = [&vals, &idxs](auto &&q) {
+        q.reserve(count);
+        for (size_t id = 0; id < count; ++ id)
+            q.push({ id, vals[id] });
+        // Update every 3rd element to a larger value, then pop everything.
+        for (size_t id = 0; id < count; id += 3) {
+            size_t idx = idxs[id];
+            q[idx].val += 100.f;
+            q.update(idx);
+        }
+        double sum = 0;
+        while (! q.empty()) {
+            sum += q.top().val;
+            q.pop();
+        }
+        return sum;
+    };
+    auto setter = [&idxs](MyValue &v, size_t idx) { idxs[v.id] = idx; };
+    auto less   = [](MyValue &l, MyValue &r) { return l.val < r.val; };
+
+    BENCHMARK("binary heap") { return run(make_mutable_priority_queue<MyValue, false>(setter, less)); };
+    BENCHMARK("4-ary heap") { return run(make_dary_mutable_priority_queue<MyValue, 4, false>(setter, less)); };
+    BENCHMARK("8-ary heap") { return run(make_dary_mutable_priority_queue<MyValue, 8, false>(setter, less)); };
+    BENCHMARK("skip heap, block 32") { return run(make_miniheap_mutable_priority_queue<MyValue, 32, false>(setter, less)); };
+    BENCHMARK("bucket queue") {
+        return run(make_bucket_mutable_priority_queue<MyValue, false>(setter, [](const MyValue &v) { return size_t(v.val); }));
+    };
+}
@@ -44,6 +44,8 @@ SCENARIO("Placeholder parser scripting", "[PlaceholderParser]") {
     SECTION("multiple expressions with semicolons 2") { REQUIRE(parser.process("{temperature[foo];;temperature[foo];}") == "357357"); }
     SECTION("multiple expressions with semicolons 3") { REQUIRE(parser.process("{temperature[foo];;;temperature[foo];;}") == "357357"); }
 
+    SECTION("text without macros is returned unchanged") { REQUIRE(parser.process("G1 X1 } ;comment\n\tM117 done\n") == "G1 X1 } ;comment\n\tM117 done\n"); }
+
     SECTION("parsing string with escaped characters") { REQUIRE(parser.process("{\"hu\\nha\\\\\\\"ha\\\"\"}") == "hu\nha\\\"ha\""); }
 
     WHEN("An UTF-8 character is used inside the code block") {
@@ -56,3 +56,24 @@ TEST_CASE("PNG read", "[PNG]") {
         REQUIRE(sum == rstsum);
     }
 }
+
+TEST_CASE("PNG compression levels", "[PNG]") {
+    auto rst = create_raster({100, 100});
+    rst.draw(ExPolygon{ Polygon::new_scale({ {0.2, 0.2}, {0.8, 0.2}, {0.5, 0.8} }) });
+
+    std::vector<uint8_t> pixels;
+    for (int level : { 0, 1, 6, 10 }) {
+        auto enc_rst = rst.encode(sla::PNGRasterEncoder{ level });
+        REQUIRE(Slic3r::png::is_png({enc_rst.data(), enc_rst.size()}));
+
+        png::ImageGreyscale img;
+        REQUIRE(png::decode_png({enc_rst.data(), enc_rst.size()}, img));
+        REQUIRE(img.rows == rst.resolution().height_px);
+        REQUIRE(img.cols == rst.resolution().width_px);
+
+        if (pixels.empty())
+            pixels = img.buf;
+        else
+            REQUIRE(img.buf == pixels);
+    }
+}
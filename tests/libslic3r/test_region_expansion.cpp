@@ -282,3 +282,58 @@ SCENARIO("Region expansion basics", "[RegionExpansion]") {
         }
     }
 }
+
+// Grid of boundary squares, each touched by a single source square from the left.
+static std::pair<ExPolygons, ExPolygons> region_expansion_islands(int nx, int ny)
+{
+    static constexpr const coord_t mm = scaled<coord_t>(1.);
+    ExPolygons src, boundary;
+    for (int iy = 0; iy < ny; ++ iy)
+        for (int ix = 0; ix < nx; ++ ix) {
+            const coord_t x = ix * 15 * mm, y = iy * 15 * mm;
+            boundary.emplace_back(Polygon{ { x, y }, { x + 10 * mm, y }, { x + 10 * mm, y + 10 * mm }, { x, y + 10 * mm } });
+            src.emplace_back(Polygon{ { x - 2 * mm, y + 4 * mm }, { x, y + 4 * mm }, { x, y + 6 * mm }, { x - 2 * mm, y + 6 * mm } });
+        }
+    return { src, boundary };
+}
+
+SCENARIO("Region expansion of independent islands", "[RegionExpansion]") {
+    GIVEN("grid of sources touching boundaries") {
+        auto [src, boundary] = region_expansion_islands(8, 8);
+        auto params = Algorithm::RegionExpansionParameters::build(scaled<float>(2.), scaled<float>(0.2), 15);
+        WHEN("expanded with the wave front offsetted at once and polygon by polygon") {
+            params.batch_offsets = true;
+            std::vector<Algorithm::RegionExpansion> batched = Algorithm::propagate_waves(src, boundary, params);
+            params.batch_offsets = false;
+            std::vector<Algorithm::RegionExpansion> single = Algorithm::propagate_waves(src, boundary, params);
+            THEN("each source expands into its own boundary") {
+                REQUIRE(batched.size() == src.size());
+                for (size_t i = 0; i < batched.size(); ++ i) {
+                    REQUIRE(batched[i].src_id == i);
+                    REQUIRE(batched[i].boundary_id == i);
+                }
+            }
+            THEN("both strategies expand the same area") {
+                double area_batched = 0., area_single = 0.;
+                for (const Algorithm::RegionExpansion &r : batched)
+                    area_batched += r.polygon.area();
+                for (const Algorithm::RegionExpansion &r : single)
+                    area_single += r.polygon.area();
+                REQUIRE(area_batched == Approx(area_single).epsilon(0.01));
+            }
+        }
+    }
+}
+
+TEST_CASE("Region expansion benchmark", "[RegionExpansion][.Benchmarks]") {
+    auto [src, boundary] = region_expansion_islands(30, 30);
+    auto params = Algorithm::RegionExpansionParameters::build(scaled<float>(2.), scaled<float>(0.1), 20);
+    params.batch_offsets = false;
+    BENCHMARK("propagate_waves, 900 islands, offset polygon by polygon") {
+        return Algorithm::propagate_waves(src, boundary, params).size();
+    };
+    params.batch_offsets = true;
+    BENCHMARK("propagate_waves, 900 islands, batched offsets") {
+        return Algorithm::propagate_waves(src, boundary, params).size();
+    };
+}
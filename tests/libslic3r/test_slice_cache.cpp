@@ -0,0 +1,43 @@
+#include <catch2/catch.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include "libslic3r/SliceCache.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/TriangleMeshSlicer.hpp"
+
+using namespace Slic3r;
+
+TEST_CASE("Slice cache round trip", "[SliceCache]") {
+    const boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    SliceCache::set_directory(dir.string());
+    REQUIRE(SliceCache::enabled());
+
+    const indexed_triangle_set its = its_make_cube(20., 20., 20.);
+    const std::vector<float>   zs { 0.1f, 0.3f, 0.5f, 10.f, 25.f };
+    MeshSlicingParamsEx        params;
+    params.closing_radius = 0.049f;
+    params.resolution     = 0.0125;
+
+    const std::string key = SliceCache::key(its, zs, params);
+
+    SECTION("The key depends on the slicing parameters") {
+        MeshSlicingParamsEx params2 = params;
+        params2.extra_offset = 0.1f;
+        CHECK(SliceCache::key(its, zs, params2) != key);
+        CHECK(SliceCache::key(its, { 0.1f, 0.3f }, params) != key);
+        CHECK(SliceCache::key(its, zs, params) == key);
+    }
+
+    SECTION("Stored slices are loaded back") {
+        std::vector<ExPolygons> slices = slice_mesh_ex(its, zs, params);
+        std::vector<ExPolygons> loaded;
+        REQUIRE(! SliceCache::load(key, loaded));
+        SliceCache::store(key, slices);
+        REQUIRE(SliceCache::load(key, loaded));
+        CHECK(loaded == slices);
+    }
+
+    SliceCache::set_directory({});
+    boost::filesystem::remove_all(dir);
+}
@@ -1,6 +1,9 @@
 #include "libslic3r/Point.hpp"
 #include <catch2/catch.hpp>
+#include <libslic3r/Model.hpp>
+#include <libslic3r/Print.hpp>
 #include <libslic3r/SupportSpotsGenerator.hpp>
+#include <libslic3r/TriangleMesh.hpp>
 
 using namespace Slic3r;
 using namespace SupportSpotsGenerator;
@@ -181,3 +184,43 @@ TEST_CASE_METHOD(ObjectPartFixture, "Constructing ObjectPart with brim", "[Suppo
     CHECK(part.sticking_area == Approx((1 + 2*brim_width) * (width + 2*brim_width)));
 }
 
+
+// Print exposing the cancellation callback, so that the support spots search may be run outside of Print::process().
+class SupportSpotsPrint : public Print
+{
+public:
+    using Print::make_try_cancel;
+};
+
+// Run on two revisions to compare the performance of the support spots search.
+TEST_CASE("Support spots search benchmark", "[SupportSpotsGenerator][.Benchmarks]") {
+    // Sphere overhanging over its whole lower half and an upside down cone, which starts as a floating island.
+    TriangleMesh mesh = make_sphere(20., PI / 90.);
+    TriangleMesh cone = make_cone(10., 20., PI / 90.);
+    cone.mirror_z();
+    cone.translate(30.f, 0.f, 20.f);
+    mesh.merge(cone);
+
+    DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+    Model              model;
+    ModelObject       *object = model.add_object();
+    object->add_volume(mesh);
+    object->add_instance();
+    model.center_instances_around_point({100, 100});
+    object->ensure_on_bed();
+
+    SupportSpotsPrint print;
+    print.apply(model, config);
+    print.set_status_silent();
+    print.process();
+    REQUIRE(print.objects().size() == 1);
+
+    const PrintObject *print_object = print.objects().front();
+    const Params       params{print.config().filament_type.values, float(print.config().perimeter_acceleration.getFloat()),
+                        print_object->config().raft_layers.getInt(), print_object->config().brim_type.value,
+                        float(print_object->config().brim_width.getFloat())};
+
+    BENCHMARK("Support spots full search") {
+        return full_search(print_object, print.make_try_cancel(), params);
+    };
+}
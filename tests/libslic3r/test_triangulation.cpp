@@ -1,6 +1,7 @@
 #include <catch2/catch.hpp>
 
 #include <libslic3r/Triangulation.hpp>
+#include <libslic3r/Tesselate.hpp>
 #include <libslic3r/SVG.hpp> // only debug visualization
 
 using namespace Slic3r;
@@ -125,3 +126,29 @@ TEST_CASE("Triangulation 2 polygons with same point", "[triangulation]")
     //Private::store_trinagulation(shape2d, shape_triangles);
     CHECK(shape_triangles.size() == 4);
 }
+
+TEST_CASE("Parallel triangulation of ExPolygons", "[triangulation]")
+{
+    // Concave M shape triangulated by ear clipping, a square with a hole by glu-libtess.
+    ExPolygons shapes{
+        ExPolygon{Points{{0, 0}, {40, 0}, {40, 40}, {20, 20}, {0, 40}}},
+        ExPolygon{Points{{100, 0}, {140, 0}, {140, 40}, {100, 40}}, Points{{110, 10}, {110, 30}, {130, 30}, {130, 10}}},
+        // Collinear vertices are skipped.
+        ExPolygon{Points{{200, 0}, {220, 0}, {240, 0}, {240, 40}, {200, 40}}}
+    };
+    for (ExPolygon &shape : shapes)
+        shape.scale(scale_(1.));
+    for (bool flip : { NORMALS_UP, NORMALS_DOWN }) {
+        std::vector<Vec3d> triangles = triangulate_expolygons_3d_parallel(shapes, 1., flip);
+        REQUIRE(triangles.size() % 3 == 0);
+        double triangles_area = 0.;
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            double a = 0.5 * (triangles[i + 1] - triangles[i]).cross(triangles[i + 2] - triangles[i]).z();
+            // All triangles are oriented the same way.
+            CHECK((flip ? -a : a) > 0.);
+            CHECK(triangles[i].z() == 1.);
+            triangles_area += std::abs(a);
+        }
+        CHECK(triangles_area == Approx(area(shapes) * SCALING_FACTOR * SCALING_FACTOR));
+    }
+}
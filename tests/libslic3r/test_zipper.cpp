@@ -0,0 +1,66 @@
+#include <catch2/catch.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <cstring>
+#include <random>
+
+#include "libslic3r/Zipper.hpp"
+#include "libslic3r/miniz_extension.hpp"
+
+using namespace Slic3r;
+
+TEST_CASE("Zipper round trip with parallel compression", "[Zipper]") {
+    const boost::filesystem::path path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%.zip");
+
+    // Compressible and incompressible entries of various sizes.
+    std::mt19937 rng(0);
+    std::vector<std::string> entries(20);
+    for (size_t i = 0; i < entries.size(); ++ i) {
+        const size_t len = i == 0 ? 2 : (size_t(1) << (i % 12)) * 100;
+        for (size_t j = 0; j < len; ++ j)
+            entries[i] += char(i % 2 == 0 ? 'a' + rng() % 4 : rng() % 256);
+    }
+
+    const bool custom_backend      = GENERATE(false, true);
+    bool       custom_backend_used = false;
+    {
+        Zipper zipper(path.string(), Zipper::TIGHT_COMPRESSION);
+        if (custom_backend)
+            zipper.set_deflate_backend([&custom_backend_used](const void *data, size_t bytes, int level, std::string &out) {
+                custom_backend_used = true;
+                return deflate_raw(data, bytes, level, out);
+            });
+        for (size_t i = 0; i < entries.size(); ++ i) {
+            const std::string name = "entry" + std::to_string(i);
+            if (i % 3 == 0)
+                zipper.add_entry(name, entries[i].data(), entries[i].size(), Zipper::NO_COMPRESSION);
+            else if (i % 3 == 1)
+                zipper.add_entry(name, entries[i].data(), entries[i].size());
+            else {
+                zipper.add_entry(name);
+                zipper << entries[i];
+            }
+        }
+        zipper.finalize();
+    }
+    CHECK(custom_backend_used == custom_backend);
+
+    MZ_Archive archive;
+    REQUIRE(open_zip_reader(&archive.arch, path.string()));
+    REQUIRE(mz_zip_reader_get_num_files(&archive.arch) == entries.size());
+    for (size_t i = 0; i < entries.size(); ++ i) {
+        // Entries are written in the order they were added.
+        mz_zip_archive_file_stat stat;
+        REQUIRE(mz_zip_reader_file_stat(&archive.arch, mz_uint(i), &stat));
+        CHECK(std::string(stat.m_filename) == "entry" + std::to_string(i));
+        size_t size = 0;
+        void  *data = mz_zip_reader_extract_to_heap(&archive.arch, mz_uint(i), &size, 0);
+        REQUIRE(data != nullptr);
+        CHECK(size == entries[i].size());
+        CHECK(std::memcmp(data, entries[i].data(), size) == 0);
+        mz_free(data);
+    }
+    close_zip_reader(&archive.arch);
+    boost::filesystem::remove(path);
+}
@@ -0,0 +1,181 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/nowide/cstdio.hpp>
+#include <boost/nowide/cstdlib.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include "test_data.hpp"
+#include "data/prusaparts.hpp"
+
+#include "libslic3r/Format/OBJ.hpp"
+#include "libslic3r/GCode/GCodeProcessor.hpp"
+#include "libslic3r/SlicesToTriangleMesh.hpp"
+#include "libslic3r/Utils.hpp"
+
+using namespace Slic3r;
+
+namespace {
+
+// Each measurement is repeated and the fastest run is compared against the baseline to suppress the noise.
+constexpr int s_repetitions = 3;
+
+using Measurements = std::map<std::string, double>;
+
+double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+TriangleMesh load_fixture(const char *name)
+{
+    TriangleMesh mesh;
+    std::string  path = std::string(TEST_DATA_DIR) + "/" + name;
+    if (! load_obj(path.c_str(), &mesh))
+        throw Slic3r::RuntimeError(std::string("Failed to load ") + path);
+    return mesh;
+}
+
+// The fixed model corpus: the prusaparts outlines extruded to 5mm high prisms and the OBJ fixtures.
+std::vector<TriangleMesh> corpus()
+{
+    std::vector<TriangleMesh> out;
+    for (Polygon polygon : PRUSA_PART_POLYGONS) {
+        polygon.make_counter_clockwise();
+        std::vector<ExPolygons> slices(25, ExPolygons{ ExPolygon(std::move(polygon)) });
+        out.emplace_back(slices_to_mesh(slices, 0., 0.2, 0.2));
+    }
+    for (const char *name : { "extruder_idler.obj", "frog_legs.obj", "ipadstand.obj", "A.obj", "overhang.obj", "bridge.obj" })
+        out.emplace_back(load_fixture(name));
+    return out;
+}
+
+DynamicPrintConfig corpus_config(std::initializer_list<ConfigBase::SetDeserializeItem> config_items)
+{
+    DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+    config.set_deserialize_strict({ { "bed_shape", "0x0,500x0,500x500,0x500" } });
+    config.set_deserialize_strict(config_items);
+    return config;
+}
+
+// Slicing with all the PrintObject steps and the G-code export.
+Measurements measure_pipeline(std::initializer_list<ConfigBase::SetDeserializeItem> config_items)
+{
+    const DynamicPrintConfig config = corpus_config(config_items);
+    Measurements out { { "process_ms", 0. }, { "export_gcode_ms", 0. } };
+    for (int i = 0; i < s_repetitions; ++ i) {
+        Print print;
+        Model model;
+        Test::init_print(corpus(), print, model, config);
+        auto start = std::chrono::steady_clock::now();
+        print.process();
+        double process_ms = elapsed_ms(start);
+        boost::filesystem::path temp = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+        start = std::chrono::steady_clock::now();
+        print.export_gcode(temp.string(), nullptr, nullptr);
+        double export_ms = elapsed_ms(start);
+        boost::nowide::remove(temp.string().c_str());
+        REQUIRE(print.finished());
+        out["process_ms"]      = i == 0 ? process_ms : std::min(out["process_ms"], process_ms);
+        out["export_gcode_ms"] = i == 0 ? export_ms : std::min(out["export_gcode_ms"], export_ms);
+    }
+    out["peak_memory_mb"] = double(peak_memory_usage()) / (1024. * 1024.);
+    return out;
+}
+
+// Processing of the G-code exported from the corpus, the G-code is exported once.
+Measurements measure_gcode_processor()
+{
+    Print print;
+    Model model;
+    Test::init_print(corpus(), print, model, corpus_config({ { "fill_density", "20%" } }));
+    print.process();
+    boost::filesystem::path temp = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    print.export_gcode(temp.string(), nullptr, nullptr);
+    Measurements out { { "process_file_ms", 0. } };
+    for (int i = 0; i < s_repetitions; ++ i) {
+        GCodeProcessor processor;
+        auto start = std::chrono::steady_clock::now();
+        processor.process_file(temp.string());
+        double duration_ms = elapsed_ms(start);
+        out["process_file_ms"] = i == 0 ? duration_ms : std::min(out["process_file_ms"], duration_ms);
+    }
+    boost::nowide::remove(temp.string().c_str());
+    out["peak_memory_mb"] = double(peak_memory_usage()) / (1024. * 1024.);
+    return out;
+}
+
+std::string baseline_path()
+{
+    const char *env = boost::nowide::getenv("SLIC3R_PERF_BASELINE");
+    return env != nullptr && *env != 0 ? std::string(env) : std::string(PERF_BASELINE_FILE);
+}
+
+bool update_baseline()
+{
+    const char *env = boost::nowide::getenv("SLIC3R_PERF_UPDATE_BASELINE");
+    return env != nullptr && std::atoi(env) != 0;
+}
+
+// Compares the measurements against the baseline of the case, fails on the values exceeding
+// the baseline by more than the tolerance. Values missing in the baseline are reported only.
+// With SLIC3R_PERF_UPDATE_BASELINE set, the baseline of the case is replaced by the measurements instead.
+void check_baseline(const std::string &case_name, const Measurements &measurements)
+{
+    namespace pt = boost::property_tree;
+    const std::string path = baseline_path();
+    pt::ptree baseline;
+    {
+        boost::nowide::ifstream file(path);
+        REQUIRE(file.good());
+        pt::read_json(file, baseline);
+    }
+    if (update_baseline()) {
+        for (const auto &[key, value] : measurements)
+            baseline.put("cases." + case_name + "." + key, value);
+        boost::nowide::ofstream file(path);
+        pt::write_json(file, baseline);
+        REQUIRE(file.good());
+        WARN("Baseline of " << case_name << " updated in " << path);
+        return;
+    }
+    const double time_tolerance   = baseline.get<double>("tolerance.time", 0.25);
+    const double memory_tolerance = baseline.get<double>("tolerance.memory", 0.15);
+    for (const auto &[key, value] : measurements) {
+        boost::optional<double> reference = baseline.get_optional<double>("cases." + case_name + "." + key);
+        if (! reference) {
+            WARN(case_name << "." << key << " = " << value << ", not in the baseline " << path);
+            continue;
+        }
+        const double tolerance = boost::algorithm::ends_with(key, "_mb") ? memory_tolerance : time_tolerance;
+        INFO(case_name << "." << key << " = " << value << ", baseline " << *reference << ", tolerance " << tolerance * 100. << "%");
+        CHECK(value <= *reference * (1. + tolerance));
+    }
+}
+
+} // namespace
+
+TEST_CASE("Performance of the pipeline with classic perimeters", "[perf][perf_classic]") {
+    check_baseline("classic", measure_pipeline({ { "perimeter_generator", "classic" }, { "fill_density", "20%" }, { "fill_pattern", "gyroid" } }));
+}
+
+TEST_CASE("Performance of the pipeline with Arachne perimeters", "[perf][perf_arachne]") {
+    check_baseline("arachne", measure_pipeline({ { "perimeter_generator", "arachne" }, { "fill_density", "20%" }, { "fill_pattern", "gyroid" } }));
+}
+
+TEST_CASE("Performance of the pipeline with organic supports", "[perf][perf_organic]") {
+    check_baseline("organic", measure_pipeline({ { "perimeter_generator", "arachne" }, { "fill_density", "15%" },
+                                                 { "support_material", true }, { "support_material_style", "organic" } }));
+}
+
+TEST_CASE("Performance of the G-code processor", "[perf][perf_gcode_processor]") {
+    check_baseline("gcode_processor", measure_gcode_processor());
+}
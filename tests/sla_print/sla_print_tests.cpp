@@ -2,12 +2,16 @@
 #include <random>
 #include <numeric>
 #include <cstdint>
+#include <chrono>
+#include <iostream>
 
 #include "sla_test_utils.hpp"
 
 #include <libslic3r/TriangleMeshSlicer.hpp>
 #include <libslic3r/SLA/SupportTreeMesher.hpp>
+#include <libslic3r/SLA/SpatIndex.hpp>
 #include <libslic3r/BranchingTree/PointCloud.hpp>
+#include <libslic3r/CSGMesh/VoxelizeCSGMesh.hpp>
 
 namespace {
 
@@ -186,6 +190,150 @@ TEST_CASE("BranchingSupports::FloorSupportsDoNotPierceModel", "[SLASupportGenera
         test_support_model_collision(fname, supportcfg);
 }
 
+TEST_CASE("BranchingSupports::LeafClustersAreIndependent", "[SLASupportGeneration][Branching]") {
+    auto props = branchingtree::Properties{}.max_branch_length(5.);
+
+    std::vector<branchingtree::Node> leafs;
+    for (float x : {0.f, 4.f, 8.f, 100.f, 104.f})
+        for (float y : {0.f, 4.f})
+            leafs.emplace_back(Vec3f{x, y, 10.f});
+
+    std::vector<branchingtree::LeafCluster> clusters = branchingtree::cluster_leafs(leafs, props);
+
+    REQUIRE(clusters.size() == 2);
+
+    size_t leafcount = 0;
+    for (const branchingtree::LeafCluster &cluster : clusters) {
+        leafcount += cluster.leafs.size();
+        REQUIRE(std::is_sorted(cluster.leafs.begin(), cluster.leafs.end()));
+        for (size_t id : cluster.leafs)
+            REQUIRE(cluster.region.contains(to_2d(leafs[id].pos).cast<double>()));
+    }
+    REQUIRE(leafcount == leafs.size());
+    REQUIRE_FALSE(clusters.front().region.overlap(clusters.back().region));
+
+    // Leafs closer than the reach of the branches are never separated.
+    props.max_branch_length(50.);
+    REQUIRE(branchingtree::cluster_leafs(leafs, props).size() == 1);
+}
+
+TEST_CASE("Branching supports benchmark", "[SLASupportGeneration][Branching][.Benchmarks]") {
+    sla::SupportTreeConfig supportcfg;
+    supportcfg.object_elevation_mm = 10.;
+    supportcfg.tree_type = sla::SupportTreeType::Branching;
+
+    for (auto fname : SUPPORT_TEST_MODELS) {
+        auto start = std::chrono::steady_clock::now();
+        test_supports(fname, supportcfg);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Branching supports of " << fname << ": " << ms << " ms" << std::endl;
+    }
+}
+
+static std::vector<sla::PointIndexEl> random_point_elements(size_t count)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> dist(0., 100.);
+    std::vector<sla::PointIndexEl> out;
+    out.reserve(count);
+    for (size_t i = 0; i < count; ++ i)
+        out.emplace_back(sla::Vec3d(dist(rng), dist(rng), dist(rng)), unsigned(i));
+    return out;
+}
+
+template<class El> static std::vector<unsigned> sorted_ids(const std::vector<El> &elements)
+{
+    std::vector<unsigned> out;
+    for (const El &el : elements)
+        out.emplace_back(el.second);
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+TEST_CASE("Bulk loaded PointIndex answers the same as the incrementally built one", "[SLASupportGeneration][SpatIndex]") {
+    const std::vector<sla::PointIndexEl> elements = random_point_elements(5000);
+
+    sla::PointIndex incremental;
+    for (const sla::PointIndexEl &el : elements)
+        incremental.insert(el);
+    const sla::PointIndex packed(elements);
+    REQUIRE(packed.size() == elements.size());
+
+    std::vector<sla::Vec3d> queries;
+    for (size_t i = 0; i < elements.size(); i += 7)
+        queries.emplace_back(elements[i].first + sla::Vec3d(0.5, -0.5, 0.25));
+
+    const double radius = 5.;
+    std::vector<std::vector<sla::PointIndexEl>> nearest = packed.nearest(queries, 3);
+    std::vector<std::vector<sla::PointIndexEl>> within  = packed.within(queries, radius);
+    REQUIRE(nearest.size() == queries.size());
+    REQUIRE(within.size() == queries.size());
+    for (size_t i = 0; i < queries.size(); ++ i) {
+        CHECK(sorted_ids(nearest[i]) == sorted_ids(incremental.nearest(queries[i], 3)));
+        std::vector<sla::PointIndexEl> expected = incremental.query([&queries, i, radius](const sla::PointIndexEl &el) {
+            return (el.first - queries[i]).norm() <= radius;
+        });
+        CHECK(sorted_ids(within[i]) == sorted_ids(expected));
+    }
+}
+
+TEST_CASE("Bulk loaded BoxIndex answers the same as the incrementally built one", "[SLASupportGeneration][SpatIndex]") {
+    std::vector<sla::BoxIndexEl> elements;
+    for (const sla::PointIndexEl &el : random_point_elements(2000)) {
+        Point p = scaled<coord_t>(Vec2d(el.first.x(), el.first.y()));
+        elements.emplace_back(BoundingBox(p, p + Point(scaled<coord_t>(el.first.z() * 0.05), scaled<coord_t>(2.))), el.second);
+    }
+
+    sla::BoxIndex incremental;
+    for (const sla::BoxIndexEl &el : elements)
+        incremental.insert(el);
+    const sla::BoxIndex packed(elements);
+
+    std::vector<BoundingBox> queries;
+    for (size_t i = 0; i < elements.size(); i += 11)
+        queries.emplace_back(elements[i].first.inflated(scaled<coord_t>(3.)));
+
+    for (auto qt : { sla::BoxIndex::qtIntersects, sla::BoxIndex::qtWithin }) {
+        std::vector<std::vector<sla::BoxIndexEl>> result = packed.query(queries, qt);
+        REQUIRE(result.size() == queries.size());
+        for (size_t i = 0; i < queries.size(); ++ i)
+            CHECK(sorted_ids(result[i]) == sorted_ids(incremental.query(queries[i], qt)));
+    }
+}
+
+TEST_CASE("SpatIndex benchmark", "[SLASupportGeneration][SpatIndex][.Benchmarks]") {
+    const std::vector<sla::PointIndexEl> elements = random_point_elements(200000);
+    std::vector<sla::Vec3d> queries;
+    for (size_t i = 0; i < elements.size(); i += 4)
+        queries.emplace_back(elements[i].first);
+
+    auto start = std::chrono::steady_clock::now();
+    sla::PointIndex incremental;
+    for (const sla::PointIndexEl &el : elements)
+        incremental.insert(el);
+    double insert_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    sla::PointIndex packed(elements);
+    double pack_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    size_t count_single = 0;
+    for (const sla::Vec3d &q : queries)
+        count_single += incremental.nearest(q, 4).size();
+    double single_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    size_t count_batch = 0;
+    for (const std::vector<sla::PointIndexEl> &res : packed.nearest(queries, 4))
+        count_batch += res.size();
+    double batch_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    REQUIRE(count_single == count_batch);
+    std::cout << "PointIndex of " << elements.size() << " points: inserted one by one " << insert_ms << " ms, packed " << pack_ms
+              << " ms; " << queries.size() << " kNN queries one by one " << single_ms << " ms, batched " << batch_ms << " ms" << std::endl;
+}
+
 TEST_CASE("InitializedRasterShouldBeNONEmpty", "[SLARasterOutput]") {
     // Default Prusa SL1 display parameters
     sla::Resolution res{2560, 1440};
@@ -251,6 +399,78 @@ TEST_CASE("RasterizedPolygonAreaShouldMatch", "[SLARasterOutput]") {
     REQUIRE(raster_pxsum(raster0) == 0);
 }
 
+// Ellipse with an off-center hole around the origin.
+static void draw_ellipse_with_hole(sla::RasterBase &raster, size_t repeats = 1)
+{
+    const size_t num_points = 200;
+    ExPolygon    poly;
+    Polygon      hole;
+    for (size_t i = 0; i < num_points; ++ i) {
+        double a = 2. * PI * double(i) / double(num_points);
+        poly.contour.points.emplace_back(scaled(20. * std::cos(a)), scaled(15. * std::sin(a)));
+        hole.points.emplace_back(scaled(3. + 5. * std::cos(-a)), scaled(5. * std::sin(-a)));
+    }
+    poly.holes.emplace_back(std::move(hole));
+    for (size_t i = 0; i < repeats; ++ i)
+        raster.draw(poly);
+}
+
+static sla::RasterBase::Trafo display_center_trafo(sla::RasterBase::Orientation o, sla::RasterBase::TMirroring mirroring)
+{
+    sla::RasterBase::Trafo trafo{o, mirroring};
+    trafo.center_x = scaled(60.);
+    trafo.center_y = scaled(34.);
+    return trafo;
+}
+
+TEST_CASE("BinaryRasterShouldMatchThresholdedAA", "[SLARasterOutput]") {
+    sla::Resolution res{2560, 1440};
+    sla::PixelDim pixdim{120. / res.width_px, 68. / res.height_px};
+
+    for (sla::RasterBase::Orientation o : { sla::RasterBase::roLandscape, sla::RasterBase::roPortrait })
+        for (sla::RasterBase::TMirroring mirroring : { sla::RasterBase::NoMirror, sla::RasterBase::MirrorX, sla::RasterBase::MirrorY, sla::RasterBase::MirrorXY }) {
+            sla::RasterBase::Trafo trafo = display_center_trafo(o, mirroring);
+            sla::RasterGrayscaleAA     aa(res, pixdim, trafo, agg::gamma_threshold(.5));
+            sla::RasterGrayscaleBinary bin(res, pixdim, trafo);
+            draw_ellipse_with_hole(aa);
+            draw_ellipse_with_hole(bin);
+
+            size_t white = 0, different = 0;
+            for (size_t row = 0; row < res.height_px; ++ row)
+                for (size_t col = 0; col < res.width_px; ++ col) {
+                    uint8_t px = bin.read_pixel(col, row);
+                    REQUIRE((px == 0 || px == FullWhite));
+                    white += px == FullWhite;
+                    different += px != aa.read_pixel(col, row);
+                }
+
+            // Only the pixels with the edge running almost exactly through their center may differ.
+            REQUIRE(white > 0);
+            REQUIRE(different < white / 1000);
+        }
+}
+
+TEST_CASE("Raster benchmark", "[SLARasterOutput][.Benchmarks]") {
+    sla::Resolution res{2560 * 4, 1440 * 4};
+    sla::PixelDim pixdim{120. / res.width_px, 68. / res.height_px};
+    sla::RasterBase::Trafo trafo = display_center_trafo(sla::RasterBase::roLandscape, sla::RasterBase::NoMirror);
+    const size_t repeats = 50;
+
+    sla::RasterGrayscaleAA     aa(res, pixdim, trafo, agg::gamma_threshold(.5));
+    sla::RasterGrayscaleBinary bin(res, pixdim, trafo);
+
+    auto start = std::chrono::steady_clock::now();
+    draw_ellipse_with_hole(aa, repeats);
+    double aa_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    draw_ellipse_with_hole(bin, repeats);
+    double bin_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Rasterizing " << repeats << " polygons at " << res.width_px << "x" << res.height_px << ": AGG thresholded "
+              << aa_ms << " ms, scanline binary " << bin_ms << " ms" << std::endl;
+}
+
 
 TEST_CASE("halfcone test", "[halfcone]") {
     sla::DiffBridge br{Vec3d{1., 1., 1.}, Vec3d{10., 10., 10.}, 0.25, 0.5};
@@ -271,3 +491,30 @@ TEST_CASE("Test concurrency")
 
     REQUIRE(s == Approx(ref));
 }
+
+TEST_CASE("Voxel booleans approximate the difference of parts", "[SLAPrint][CSG]")
+{
+    indexed_triangle_set body = its_make_cube(20., 20., 20.);
+    indexed_triangle_set hole = its_make_cube(5., 5., 40.);
+
+    std::vector<csg::CSGPart> parts;
+    parts.emplace_back(&body, csg::CSGType::Union);
+    parts.emplace_back(&hole, csg::CSGType::Difference,
+                       Transform3f{Eigen::Translation3f(7.5f, 7.5f, -10.f)});
+
+    auto r = range(parts);
+    auto params = csg::VoxelizeParams{}.voxel_scale(4.f).exterior_bandwidth(1.f).interior_bandwidth(1.f);
+
+    SECTION("Voxel scale is limited by the voxel budget") {
+        CHECK(csg::adaptive_voxel_scale(r, params, 1e9) == Approx(params.voxel_scale()));
+        float coarse = csg::adaptive_voxel_scale(r, params, 1e4);
+        CHECK(coarse < params.voxel_scale());
+        CHECK(coarse > 0.f);
+    }
+
+    SECTION("Volume of the result matches the exact difference") {
+        indexed_triangle_set m = csg::voxel_csgmesh_booleans(r, params);
+        REQUIRE(!m.empty());
+        CHECK(its_volume(m) == Approx(20. * 20. * 20. - 5. * 5. * 20.).epsilon(0.05));
+    }
+}
@@ -149,4 +149,31 @@ TEST_CASE("Invalid value Thumbnails", "[Thumbnails]") {
         REQUIRE(errors.has(ThumbnailError::InvalidVal));
         REQUIRE(thumbnails.size() == 2);
     }
-}
\ No newline at end of file
+}
+TEST_CASE("Render and compress thumbnails", "[Thumbnails]") {
+    auto [thumbnails_list, errors] = make_and_check_thumbnail_list("160x120/PNG, 23x78/QOI, 160x120/JPG, 16x16/PNG");
+    REQUIRE(errors == enum_bitmask<ThumbnailError>());
+
+    size_t num_calls = 0;
+    ThumbnailsGeneratorCallback thumbnail_cb = [&num_calls](const ThumbnailsParams &params) {
+        ++ num_calls;
+        ThumbnailsList thumbnails;
+        for (const Vec2d &size : params.sizes)
+            // 16x16 fails to render.
+            if (size.x() != 16.) {
+                ThumbnailData &data = thumbnails.emplace_back();
+                data.set((unsigned int)size.x(), (unsigned int)size.y());
+                std::fill(data.pixels.begin(), data.pixels.end(), 128);
+            }
+        return thumbnails;
+    };
+
+    std::vector<CompressedThumbnail> compressed = render_and_compress_thumbnails(thumbnail_cb, thumbnails_list);
+    REQUIRE(num_calls == 1);
+    REQUIRE(compressed.size() == 3);
+    CHECK((compressed[0].format == GCodeThumbnailsFormat::PNG && compressed[0].width == 160 && compressed[0].height == 120));
+    CHECK((compressed[1].format == GCodeThumbnailsFormat::QOI && compressed[1].width == 23 && compressed[1].height == 78));
+    CHECK((compressed[2].format == GCodeThumbnailsFormat::JPG && compressed[2].width == 160 && compressed[2].height == 120));
+    for (const CompressedThumbnail &thumbnail : compressed)
+        CHECK(thumbnail.image->size > 0);
+}